@@ -62,6 +62,8 @@
 #define CONFDB_SERVICE_DEBUG_TIMESTAMPS "debug_timestamps"
 #define CONFDB_SERVICE_DEBUG_MICROSECONDS "debug_microseconds"
 #define CONFDB_SERVICE_DEBUG_BACKTRACE_ENABLED "debug_backtrace_enabled"
+#define CONFDB_SERVICE_DEBUG_ASYNC "debug_async"
+#define CONFDB_SERVICE_DEBUG_TRACE_LEVEL "debug_trace_level"
 #define CONFDB_SERVICE_RECON_RETRIES "reconnection_retries"
 #define CONFDB_SERVICE_FD_LIMIT "fd_limit"
 #define CONFDB_SERVICE_ALLOWED_UIDS "allowed_uids"
@@ -81,6 +83,7 @@
 #define CONFDB_MONITOR_DISABLE_NETLINK "disable_netlink"
 #define CONFDB_MONITOR_ENABLE_FILES_DOM "enable_files_domain"
 #define CONFDB_MONITOR_DOMAIN_RESOLUTION_ORDER "domain_resolution_order"
+#define CONFDB_MONITOR_DP_BINARY_IPC "dp_binary_ipc"
 
 /* Both monitor and domains */
 #define CONFDB_NAME_REGEX   "re_expression"
@@ -97,6 +100,7 @@
 #define CONFDB_RESPONDER_IDLE_TIMEOUT "responder_idle_timeout"
 #define CONFDB_RESPONDER_IDLE_DEFAULT_TIMEOUT 300
 #define CONFDB_RESPONDER_CACHE_FIRST "cache_first"
+#define CONFDB_RESPONDER_PARALLEL_DOMAIN_LOOKUP "parallel_domain_lookup"
 
 /* NSS */
 #define CONFDB_NSS_CONF_ENTRY "config/nss"
@@ -221,6 +225,8 @@
 #define CONFDB_DOMAIN_CACHE_CREDS_MIN_FF_LENGTH \
                                  "cache_credentials_minimal_first_factor_length"
 #define CONFDB_DEFAULT_CACHE_CREDS_MIN_FF_LENGTH 8
+#define CONFDB_DOMAIN_CACHE_CREDS_HASH_ROUNDS "cache_credentials_hash_rounds"
+#define CONFDB_DEFAULT_CACHE_CREDS_HASH_ROUNDS 5000
 #define CONFDB_DOMAIN_AUTO_UPG "auto_private_groups"
 #define CONFDB_DOMAIN_FQ "use_fully_qualified_names"
 #define CONFDB_DOMAIN_ENTRY_CACHE_TIMEOUT "entry_cache_timeout"
@@ -249,6 +255,7 @@
 #define CONFDB_DOMAIN_OFFLINE_TIMEOUT_RANDOM_OFFSET "offline_timeout_random_offset"
 #define CONFDB_DOMAIN_SUBDOMAIN_INHERIT "subdomain_inherit"
 #define CONFDB_DOMAIN_CACHED_AUTH_TIMEOUT "cached_auth_timeout"
+#define CONFDB_DOMAIN_ACCESS_DECISION_CACHE_TIMEOUT "access_decision_cache_timeout"
 #define CONFDB_DOMAIN_TYPE "domain_type"
 #define CONFDB_DOMAIN_TYPE_POSIX "posix"
 #define CONFDB_DOMAIN_TYPE_APP "application"
@@ -378,6 +385,7 @@ struct sss_domain_info {
 
     bool cache_credentials;
     uint32_t cache_credentials_min_ff_length;
+    uint32_t cache_credentials_hash_rounds;
     bool case_sensitive;
     bool case_preserve;
 
@@ -22,6 +22,8 @@ class SSSDOptions(object):
         'debug_timestamps': _('Include timestamps in debug logs'),
         'debug_microseconds': _('Include microseconds in timestamps in debug logs'),
         'debug_backtrace_enabled': _('Enable/disable debug backtrace'),
+        'debug_async': _('Write debug messages from a separate thread'),
+        'debug_trace_level': _('Debug levels written to the binary trace file'),
         'timeout': _('Watchdog timeout before restarting service'),
         'command': _('Command to start service'),
         'reconnection_retries': _('Number of times to attempt connection to Data Providers'),
@@ -29,6 +31,7 @@ class SSSDOptions(object):
         'client_idle_timeout': _('Idle time before automatic disconnection of a client'),
         'responder_idle_timeout': _('Idle time before automatic shutdown of the responder'),
         'cache_first': _('Always query all the caches before querying the Data Providers'),
+        'parallel_domain_lookup': _('Query all domains at once when looking up an unqualified name'),
         'offline_timeout': _('When SSSD switches to offline mode the amount of time before it tries to go back online '
                              'will increase based upon the time spent disconnected. This value is in seconds and '
                              'calculated by the following: offline_timeout + random_offset.'),
@@ -54,6 +57,7 @@ class SSSDOptions(object):
         'try_inotify': _('SSSD monitors the state of resolv.conf to identify when it needs to update its internal DNS '
                          'resolver. By default, we will attempt to use inotify for this, and will fall back to '
                          'polling resolv.conf every five seconds if inotify cannot be used.'),
+        'dp_binary_ipc': _('Send account requests to the Data Providers over a binary IPC instead of D-Bus'),
 
         # [nss]
         'enum_cache_timeout': _('Enumeration cache timeout length (seconds)'),
@@ -200,6 +204,12 @@ class SSSDOptions(object):
         'dns_resolver_op_timeout': _('How long should keep trying to resolve single DNS query (seconds)'),
         'dns_resolver_timeout': _('How long to wait for replies from DNS when resolving servers (seconds)'),
         'dns_discovery_domain': _('The domain part of service discovery DNS query'),
+        'failover_latency_selection': _('Prefer the server with the lowest observed latency'),
+        'failover_latency_tolerance': _('How much faster (percent) a server must be to be preferred'),
+        'failover_probe_interval': _('How often to probe failover servers in the background'),
+        'failover_probe_servers': _('Number of failover servers to probe in the background'),
+        'failover_probe_failures': _('Number of failed probes in a row after which a server is not used'),
+        'failover_hot_standby': _('Open a new connection to the next server as soon as the current one is abandoned'),
         'override_gid': _('Override GID value from the identity provider with this value'),
         'case_sensitive': _('Treat usernames as case sensitive'),
         'entry_cache_user_timeout': _('Entry cache timeout length (seconds)'),
@@ -223,6 +233,7 @@ class SSSDOptions(object):
         'subdomain_inherit': _('List of options that should be inherited into a subdomain'),
         'subdomain_homedir': _('Default subdomain homedir value'),
         'cached_auth_timeout': _('How long can cached credentials be used for cached authentication'),
+        'access_decision_cache_timeout': _('How long a successful access control decision is cached'),
         'auto_private_groups': _('Whether to automatically create private groups for users'),
         'pwd_expiration_warning': _('Display a warning N days before the password expires.'),
         'realmd_tags': _('Various tags stored by the realmd configuration service for this domain.'),
@@ -234,6 +245,7 @@ class SSSDOptions(object):
                                                            'should be saved this value determines the minimal length '
                                                            'the first authentication factor (long term password) must '
                                                            'have to be saved as SHA512 hash into the cache.'),
+        'cache_credentials_hash_rounds': _('Number of SHA512 rounds used to hash cached passwords'),
 
         # [provider/ipa]
         'ipa_domain': _('IPA domain'),
@@ -252,6 +264,8 @@ class SSSDOptions(object):
         'ipa_master_domain_search_base': _("Search base for object containing info about IPA domain"),
         'ipa_ranges_search_base': _("Search base for objects containing info about ID ranges"),
         'ipa_enable_dns_sites': _("Enable DNS sites - location based service discovery"),
+        'ipa_extdom_parallel_requests': _("Maximal number of concurrent requests sent to the extdom plugin of the "
+                                          "IPA server"),
         'ipa_views_search_base': _("Search base for view containers"),
         'ipa_view_class': _("Objectclass for view containers"),
         'ipa_view_name': _("Attribute with the name of the view"),
@@ -328,6 +342,7 @@ class SSSDOptions(object):
                                                       'database'),
         'ad_use_ldaps': _('Use LDAPS port for LDAP and Global Catalog requests'),
         'ad_allow_remote_domain_local_groups' : _('Do not filter domain local groups from other domains'),
+        'ad_pac_background_group_lookup' : _('Look up groups from the PAC which are not cached yet in the background'),
 
         # [provider/krb5]
         'krb5_kdcip': _('Kerberos server address'),
@@ -382,12 +382,15 @@ class SSSDConfigTestSSSDService(unittest.TestCase):
             'debug_timestamps',
             'debug_microseconds',
             'debug_backtrace_enabled',
+            'debug_async',
+            'debug_trace_level',
             'command',
             'reconnection_retries',
             'fd_limit',
             'client_idle_timeout',
             'responder_idle_timeout',
             'cache_first',
+            'parallel_domain_lookup',
             'description',
             'certificate_verification',
             'override_space',
@@ -396,6 +399,7 @@ class SSSDConfigTestSSSDService(unittest.TestCase):
             'domain_resolution_order',
             'try_inotify',
             'monitor_resolv_conf',
+            'dp_binary_ipc',
         ]
 
         self.assertTrue(type(options) == dict,
@@ -599,6 +603,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'enumerate',
             'cache_credentials',
             'cache_credentials_minimal_first_factor_length',
+            'cache_credentials_hash_rounds',
             'use_fully_qualified_names',
             'ignore_group_members',
             'filter_users',
@@ -619,6 +624,12 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'dns_resolver_op_timeout',
             'dns_resolver_timeout',
             'dns_discovery_domain',
+            'failover_latency_selection',
+            'failover_latency_tolerance',
+            'failover_probe_interval',
+            'failover_probe_servers',
+            'failover_probe_failures',
+            'failover_hot_standby',
             'dyndns_update',
             'dyndns_ttl',
             'dyndns_iface',
@@ -654,6 +665,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'full_name_format',
             're_expression',
             'cached_auth_timeout',
+            'access_decision_cache_timeout',
             'auto_private_groups',
             'pam_gssapi_services',
             'pam_gssapi_check_upn',
@@ -982,6 +994,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'enumerate',
             'cache_credentials',
             'cache_credentials_minimal_first_factor_length',
+            'cache_credentials_hash_rounds',
             'use_fully_qualified_names',
             'ignore_group_members',
             'filter_users',
@@ -1002,6 +1015,12 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'dns_resolver_op_timeout',
             'dns_resolver_timeout',
             'dns_discovery_domain',
+            'failover_latency_selection',
+            'failover_latency_tolerance',
+            'failover_probe_interval',
+            'failover_probe_servers',
+            'failover_probe_failures',
+            'failover_hot_standby',
             'dyndns_update',
             'dyndns_ttl',
             'dyndns_iface',
@@ -1037,6 +1056,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'full_name_format',
             're_expression',
             'cached_auth_timeout',
+            'access_decision_cache_timeout',
             'auto_private_groups',
             'pam_gssapi_services',
             'pam_gssapi_check_upn',
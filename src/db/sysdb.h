@@ -268,6 +268,10 @@
                            ORIGINALAD_PREFIX SYSDB_GIDNUM, \
                            NULL}
 
+#define SYSDB_ENUM_NAME_ATTRS {SYSDB_NAME, SYSDB_OBJECTCATEGORY, \
+                               SYSDB_OVERRIDE_DN, \
+                               NULL}
+
 #define SYSDB_NETGR_ATTRS {SYSDB_NAME, SYSDB_NETGROUP_TRIPLE, \
                            SYSDB_NETGROUP_MEMBER, \
                            SYSDB_DEFAULT_ATTRS, \
@@ -327,6 +331,7 @@
 
 struct confdb_ctx;
 struct sysdb_ctx;
+struct sss_hash_pool;
 
 struct sysdb_attrs {
     int num;
@@ -849,6 +854,23 @@ int sysdb_enumgrent_with_views(TALLOC_CTX *mem_ctx,
                                struct sss_domain_info *domain,
                                struct ldb_result **res);
 
+/* Enumerate only the names of all users or groups of the domain, the full
+ * entries are read by sysdb_enum_entry_with_views() when they are needed.
+ * This keeps the enumeration result of large domains small. */
+int sysdb_enumpwent_names_with_views(TALLOC_CTX *mem_ctx,
+                                     struct sss_domain_info *domain,
+                                     struct ldb_result **res);
+
+int sysdb_enumgrent_names_with_views(TALLOC_CTX *mem_ctx,
+                                     struct sss_domain_info *domain,
+                                     struct ldb_result **res);
+
+int sysdb_enum_entry_with_views(TALLOC_CTX *mem_ctx,
+                                struct sss_domain_info *domain,
+                                struct ldb_dn *dn,
+                                bool group,
+                                struct ldb_message **_msg);
+
 int sysdb_enumgrent_filter_with_views(TALLOC_CTX *mem_ctx,
                                       struct sss_domain_info *domain,
                                       const char *name_filter,
@@ -1195,6 +1217,20 @@ int sysdb_cache_password_ex(struct sss_domain_info *domain,
                             enum sss_authtok_type authtok_type,
                             size_t second_factor_size);
 
+/* Same as sysdb_cache_password_ex() but the password is hashed by a worker
+ * thread of @pool. If @pool is NULL the hash is computed synchronously. */
+struct tevent_req *
+sysdb_cache_password_ex_send(TALLOC_CTX *mem_ctx,
+                             struct tevent_context *ev,
+                             struct sss_hash_pool *pool,
+                             struct sss_domain_info *domain,
+                             const char *username,
+                             const char *password,
+                             enum sss_authtok_type authtok_type,
+                             size_t second_factor_len);
+
+errno_t sysdb_cache_password_ex_recv(struct tevent_req *req);
+
 errno_t check_failed_login_attempts(struct confdb_ctx *cdb,
                                     struct ldb_message *ldb_msg,
                                     uint32_t *failed_login_attempts,
@@ -1207,6 +1243,22 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
                      time_t *_expire_date,
                      time_t *_delayed_until);
 
+/* Same as sysdb_cache_auth() but the password is hashed by a worker thread
+ * of @pool. If @pool is NULL the hash is computed synchronously. The
+ * expiration and delay are returned even if the authentication failed. */
+struct tevent_req *sysdb_cache_auth_send(TALLOC_CTX *mem_ctx,
+                                         struct tevent_context *ev,
+                                         struct sss_hash_pool *pool,
+                                         struct sss_domain_info *domain,
+                                         const char *name,
+                                         const char *password,
+                                         struct confdb_ctx *cdb,
+                                         bool just_check);
+
+errno_t sysdb_cache_auth_recv(struct tevent_req *req,
+                              time_t *_expire_date,
+                              time_t *_delayed_until);
+
 int sysdb_store_custom(struct sss_domain_info *domain,
                        const char *object_name,
                        const char *subtree_name,
@@ -26,6 +26,7 @@
 #include "db/sysdb_iphosts.h"
 #include "db/sysdb_ipnetworks.h"
 #include "util/crypto/sss_crypto.h"
+#include "util/sss_hash_pool.h"
 #include "util/cert.h"
 #include <time.h>
 
@@ -3247,16 +3248,14 @@ int sysdb_remove_group_member(struct sss_domain_info *domain,
 
 /* =Password-Caching====================================================== */
 
-int sysdb_cache_password_ex(struct sss_domain_info *domain,
-                            const char *username,
-                            const char *password,
-                            enum sss_authtok_type authtok_type,
-                            size_t second_factor_len)
+static errno_t sysdb_cache_password_store(struct sss_domain_info *domain,
+                                          const char *username,
+                                          const char *hash,
+                                          enum sss_authtok_type authtok_type,
+                                          size_t second_factor_len)
 {
     TALLOC_CTX *tmp_ctx;
     struct sysdb_attrs *attrs;
-    char *hash = NULL;
-    char *salt;
     int ret;
 
     tmp_ctx = talloc_new(NULL);
@@ -3264,18 +3263,6 @@ int sysdb_cache_password_ex(struct sss_domain_info *domain,
         return ENOMEM;
     }
 
-    ret = s3crypt_gen_salt(tmp_ctx, &salt);
-    if (ret) {
-        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to generate random salt.\n");
-        goto fail;
-    }
-
-    ret = s3crypt_sha512(tmp_ctx, password, salt, &hash);
-    if (ret) {
-        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
-        goto fail;
-    }
-
     attrs = sysdb_new_attrs(tmp_ctx);
     if (!attrs) {
         ERROR_OUT(ret, ENOMEM, fail);
@@ -3317,6 +3304,43 @@ fail:
     return ret;
 }
 
+int sysdb_cache_password_ex(struct sss_domain_info *domain,
+                            const char *username,
+                            const char *password,
+                            enum sss_authtok_type authtok_type,
+                            size_t second_factor_len)
+{
+    TALLOC_CTX *tmp_ctx;
+    char *hash = NULL;
+    char *salt;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (!tmp_ctx) {
+        return ENOMEM;
+    }
+
+    ret = s3crypt_gen_setting(tmp_ctx, domain->cache_credentials_hash_rounds,
+                              &salt);
+    if (ret) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to generate random salt.\n");
+        goto done;
+    }
+
+    ret = s3crypt_sha512(tmp_ctx, password, salt, &hash);
+    if (ret) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
+        goto done;
+    }
+
+    ret = sysdb_cache_password_store(domain, username, hash,
+                                     authtok_type, second_factor_len);
+
+done:
+    talloc_zfree(tmp_ctx);
+    return ret;
+}
+
 int sysdb_cache_password(struct sss_domain_info *domain,
                          const char *username,
                          const char *password)
@@ -3325,6 +3349,109 @@ int sysdb_cache_password(struct sss_domain_info *domain,
                                    SSS_AUTHTOK_TYPE_PASSWORD, 0);
 }
 
+struct sysdb_cache_password_state {
+    struct sss_domain_info *domain;
+    const char *username;
+    enum sss_authtok_type authtok_type;
+    size_t second_factor_len;
+};
+
+static void sysdb_cache_password_done(struct tevent_req *subreq);
+
+struct tevent_req *
+sysdb_cache_password_ex_send(TALLOC_CTX *mem_ctx,
+                             struct tevent_context *ev,
+                             struct sss_hash_pool *pool,
+                             struct sss_domain_info *domain,
+                             const char *username,
+                             const char *password,
+                             enum sss_authtok_type authtok_type,
+                             size_t second_factor_len)
+{
+    struct sysdb_cache_password_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    char *salt;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct sysdb_cache_password_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->domain = domain;
+    state->authtok_type = authtok_type;
+    state->second_factor_len = second_factor_len;
+
+    state->username = talloc_strdup(state, username);
+    if (state->username == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = s3crypt_gen_setting(state, domain->cache_credentials_hash_rounds,
+                              &salt);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to generate random salt.\n");
+        goto done;
+    }
+
+    subreq = sss_hash_pool_sha512_send(state, ev, pool, password,
+                                       strlen(password), salt);
+    if (subreq == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    tevent_req_set_callback(subreq, sysdb_cache_password_done, req);
+
+    return req;
+
+done:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static void sysdb_cache_password_done(struct tevent_req *subreq)
+{
+    struct sysdb_cache_password_state *state;
+    struct tevent_req *req;
+    char *hash;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sysdb_cache_password_state);
+
+    ret = sss_hash_pool_sha512_recv(state, subreq, &hash);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = sysdb_cache_password_store(state->domain, state->username, hash,
+                                     state->authtok_type,
+                                     state->second_factor_len);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+errno_t sysdb_cache_password_ex_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
 static errno_t set_initgroups_expire_attribute(struct sss_domain_info *domain,
                                                const char *name)
 {
@@ -4622,87 +4749,57 @@ done:
     return ret;
 }
 
-static errno_t check_for_combined_2fa_password(struct sss_domain_info *domain,
-                                               struct ldb_message *ldb_msg,
-                                               const char *password,
-                                               const char *userhash)
-{
+/* Everything sysdb_cache_auth() needs to know about the user before the
+ * password is hashed, the hashing itself may happen asynchronously. */
+struct sysdb_cache_auth_data {
+    const char *userhash;
+    uint32_t failed_login_attempts;
+    /* length of the first factor if the cached password may have been
+     * entered together with the second factor, 0 otherwise */
+    size_t short_pw_len;
+    time_t expire_date;
+    time_t delayed_until;
+};
 
+static size_t combined_2fa_password_len(struct sss_domain_info *domain,
+                                        struct ldb_message *ldb_msg,
+                                        const char *password)
+{
     unsigned int cached_authtok_type;
     unsigned int cached_fa2_len;
-    char *short_pw;
-    char *comphash;
     size_t pw_len;
-    TALLOC_CTX *tmp_ctx;
-    int ret;
 
     cached_authtok_type = ldb_msg_find_attr_as_uint(ldb_msg,
                                                     SYSDB_CACHEDPWD_TYPE,
                                                     SSS_AUTHTOK_TYPE_EMPTY);
     if (cached_authtok_type != SSS_AUTHTOK_TYPE_2FA) {
         DEBUG(SSSDBG_TRACE_LIBS, "Wrong authtok type.\n");
-        return EINVAL;
+        return 0;
     }
 
     cached_fa2_len = ldb_msg_find_attr_as_uint(ldb_msg, SYSDB_CACHEDPWD_FA2_LEN,
                                                0);
     if (cached_fa2_len == 0) {
         DEBUG(SSSDBG_TRACE_LIBS, "Second factor size not available.\n");
-        return EINVAL;
+        return 0;
     }
 
     pw_len = strlen(password);
     if (pw_len < cached_fa2_len + domain->cache_credentials_min_ff_length) {
         DEBUG(SSSDBG_TRACE_LIBS, "Password too short.\n");
-        return EINVAL;
-    }
-
-    tmp_ctx = talloc_new(NULL);
-    if (tmp_ctx == NULL) {
-        DEBUG(SSSDBG_OP_FAILURE, "talloc_new failed.\n");
-        return ENOMEM;
-    }
-
-    short_pw = talloc_strndup(tmp_ctx, password, (pw_len - cached_fa2_len));
-    if (short_pw == NULL) {
-        DEBUG(SSSDBG_OP_FAILURE, "talloc_strndup failed.\n");
-        ret = ENOMEM;
-        goto done;
-    }
-    talloc_set_destructor((TALLOC_CTX *)short_pw,
-                          sss_erase_talloc_mem_securely);
-
-    ret = s3crypt_sha512(tmp_ctx, short_pw, userhash, &comphash);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
-        ret = ERR_INTERNAL;
-        goto done;
-    }
-
-    if (strcmp(userhash, comphash) != 0) {
-        DEBUG(SSSDBG_MINOR_FAILURE,
-              "Hash of shorten password does not match.\n");
-        ret = ERR_AUTH_FAILED;
-        goto done;
+        return 0;
     }
 
-    ret = EOK;
-
-done:
-    talloc_free(tmp_ctx);
-
-    return ret;
+    return pw_len - cached_fa2_len;
 }
 
-int sysdb_cache_auth(struct sss_domain_info *domain,
-                     const char *name,
-                     const char *password,
-                     struct confdb_ctx *cdb,
-                     bool just_check,
-                     time_t *_expire_date,
-                     time_t *_delayed_until)
+static errno_t sysdb_cache_auth_prepare(TALLOC_CTX *mem_ctx,
+                                        struct sss_domain_info *domain,
+                                        const char *name,
+                                        const char *password,
+                                        struct confdb_ctx *cdb,
+                                        struct sysdb_cache_auth_data *data)
 {
-    TALLOC_CTX *tmp_ctx;
     const char *attrs[] = { SYSDB_NAME, SYSDB_CACHEDPWD, SYSDB_DISABLED,
                             SYSDB_LAST_LOGIN, SYSDB_LAST_ONLINE_AUTH,
                             "lastCachedPasswordChange",
@@ -4711,16 +4808,13 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
                             SYSDB_CACHEDPWD_FA2_LEN, NULL };
     struct ldb_message *ldb_msg;
     const char *userhash;
-    char *comphash;
     uint64_t lastLogin = 0;
     int cred_expiration;
-    uint32_t failed_login_attempts = 0;
-    struct sysdb_attrs *update_attrs;
-    bool authentication_successful = false;
-    time_t expire_date = -1;
-    time_t delayed_until = -1;
     int ret;
 
+    data->expire_date = -1;
+    data->delayed_until = -1;
+
     if (name == NULL || *name == '\0') {
         DEBUG(SSSDBG_CRIT_FAILURE, "Missing user name.\n");
         return EINVAL;
@@ -4741,25 +4835,13 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
         return EINVAL;
     }
 
-    tmp_ctx = talloc_new(NULL);
-    if (!tmp_ctx) {
-        return ENOMEM;
-    }
-
-    ret = ldb_transaction_start(domain->sysdb->ldb);
-    if (ret) {
-        talloc_zfree(tmp_ctx);
-        ret = sysdb_error_to_errno(ret);
-        return ret;
-    }
-
-    ret = sysdb_search_user_by_name(tmp_ctx, domain, name, attrs, &ldb_msg);
+    ret = sysdb_search_user_by_name(mem_ctx, domain, name, attrs, &ldb_msg);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "sysdb_search_user_by_name failed [%d][%s].\n",
                   ret, strerror(ret));
         if (ret == ENOENT) ret = ERR_ACCOUNT_UNKNOWN;
-        goto done;
+        return ret;
     }
 
     /* Check offline_auth_cache_timeout */
@@ -4772,28 +4854,28 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Failed to read expiration time of offline credentials.\n");
-        goto done;
+        return ret;
     }
     DEBUG(SSSDBG_TRACE_ALL, "Offline credentials expiration is [%d] days.\n",
               cred_expiration);
 
     if (cred_expiration) {
-        expire_date = lastLogin + (cred_expiration * 86400);
-        if (expire_date < time(NULL)) {
+        data->expire_date = lastLogin + (cred_expiration * 86400);
+        if (data->expire_date < time(NULL)) {
             DEBUG(SSSDBG_CONF_SETTINGS, "Cached user entry is too old.\n");
-            expire_date = 0;
-            ret = ERR_CACHED_CREDS_EXPIRED;
-            goto done;
+            data->expire_date = 0;
+            return ERR_CACHED_CREDS_EXPIRED;
         }
     } else {
-        expire_date = 0;
+        data->expire_date = 0;
     }
 
-    ret = check_failed_login_attempts(cdb, ldb_msg, &failed_login_attempts,
-                                      &delayed_until);
+    ret = check_failed_login_attempts(cdb, ldb_msg,
+                                      &data->failed_login_attempts,
+                                      &data->delayed_until);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Failed to check login attempts\n");
-        goto done;
+        return ret;
     }
 
     /* TODO: verify user account (disabled, expired ...) */
@@ -4801,14 +4883,37 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
     userhash = ldb_msg_find_attr_as_string(ldb_msg, SYSDB_CACHEDPWD, NULL);
     if (userhash == NULL || *userhash == '\0') {
         DEBUG(SSSDBG_CONF_SETTINGS, "Cached credentials not available.\n");
-        ret = ERR_NO_CACHED_CREDS;
-        goto done;
+        return ERR_NO_CACHED_CREDS;
     }
 
-    ret = s3crypt_sha512(tmp_ctx, password, userhash, &comphash);
-    if (ret) {
-        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
-        ret = ERR_INTERNAL;
+    data->userhash = userhash;
+    data->short_pw_len = combined_2fa_password_len(domain, ldb_msg, password);
+
+    return EOK;
+}
+
+/* Records the result of the authentication, returns EOK if it was
+ * successful. */
+static errno_t sysdb_cache_auth_finish(struct sss_domain_info *domain,
+                                       const char *name,
+                                       struct confdb_ctx *cdb,
+                                       struct sysdb_cache_auth_data *data,
+                                       bool just_check,
+                                       bool authentication_successful)
+{
+    TALLOC_CTX *tmp_ctx;
+    const char *attrs[] = { SYSDB_FAILED_LOGIN_ATTEMPTS,
+                            SYSDB_LAST_FAILED_LOGIN, NULL };
+    struct ldb_message *ldb_msg;
+    struct sysdb_attrs *update_attrs;
+    bool in_transaction = false;
+    bool checked = false;
+    errno_t sret;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (!tmp_ctx) {
+        ret = ENOMEM;
         goto done;
     }
 
@@ -4819,15 +4924,38 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
         goto done;
     }
 
-    if (strcmp(userhash, comphash) == 0
-            || check_for_combined_2fa_password(domain, ldb_msg,
-                                               password, userhash) == EOK) {
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+    in_transaction = true;
+
+    /* Other attempts may have been recorded while the password was being
+     * hashed, so the lockout has to be checked again against the current
+     * entry, otherwise parallel attempts could get past the limit. */
+    ret = sysdb_search_user_by_name(tmp_ctx, domain, name, attrs, &ldb_msg);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "sysdb_search_user_by_name failed [%d][%s].\n",
+              ret, sss_strerror(ret));
+        if (ret == ENOENT) ret = ERR_ACCOUNT_UNKNOWN;
+        goto done;
+    }
+
+    ret = check_failed_login_attempts(cdb, ldb_msg,
+                                      &data->failed_login_attempts,
+                                      &data->delayed_until);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to check login attempts\n");
+        goto done;
+    }
+    checked = true;
+
+    if (authentication_successful) {
         /* TODO: probable good point for audit logging */
         DEBUG(SSSDBG_CONF_SETTINGS, "Hashes do match!\n");
-        authentication_successful = true;
 
         if (just_check) {
-            ret = EOK;
             goto done;
         }
 
@@ -4848,10 +4976,8 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
             ret = EOK;
             goto done;
         }
-
     } else {
         DEBUG(SSSDBG_CONF_SETTINGS, "Authentication failed.\n");
-        authentication_successful = false;
 
         ret = sysdb_attrs_add_time_t(update_attrs,
                                      SYSDB_LAST_FAILED_LOGIN,
@@ -4863,7 +4989,7 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
 
         ret = sysdb_attrs_add_uint32(update_attrs,
                                      SYSDB_FAILED_LOGIN_ATTEMPTS,
-                                     ++failed_login_attempts);
+                                     ++data->failed_login_attempts);
         if (ret != EOK) {
             DEBUG(SSSDBG_MINOR_FAILURE, "sysdb_attrs_add_uint32 failed.\n");
             goto done;
@@ -4875,35 +5001,273 @@ int sysdb_cache_auth(struct sss_domain_info *domain,
     if (ret) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Failed to update Login attempt information!\n");
+        goto done;
     }
 
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to commit transaction!\n");
+        goto done;
+    }
+    in_transaction = false;
+
 done:
-    if (_expire_date != NULL) {
-        *_expire_date = expire_date;
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Could not cancel transaction\n");
+        }
     }
-    if (_delayed_until != NULL) {
-        *_delayed_until = delayed_until;
+    talloc_free(tmp_ctx);
+
+    /* A locked out user is denied even with the right password. */
+    if (!checked) {
+        return ret;
+    }
+
+    if (authentication_successful) {
+        return EOK;
+    }
+
+    return ret == EOK ? ERR_AUTH_FAILED : ret;
+}
+
+int sysdb_cache_auth(struct sss_domain_info *domain,
+                     const char *name,
+                     const char *password,
+                     struct confdb_ctx *cdb,
+                     bool just_check,
+                     time_t *_expire_date,
+                     time_t *_delayed_until)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_cache_auth_data data = { 0 };
+    char *short_pw;
+    char *comphash;
+    bool authentication_successful;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (!tmp_ctx) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_cache_auth_prepare(tmp_ctx, domain, name, password, cdb,
+                                   &data);
+    if (ret != EOK) {
+        goto done;
     }
+
+    ret = s3crypt_sha512(tmp_ctx, password, data.userhash, &comphash);
     if (ret) {
-        ldb_transaction_cancel(domain->sysdb->ldb);
-    } else {
-        ret = ldb_transaction_commit(domain->sysdb->ldb);
-        ret = sysdb_error_to_errno(ret);
-        if (ret) {
-            DEBUG(SSSDBG_OP_FAILURE, "Failed to commit transaction!\n");
-        }
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
+        ret = ERR_INTERNAL;
+        goto done;
     }
-    if (authentication_successful) {
-        ret = EOK;
-    } else {
+
+    authentication_successful = strcmp(data.userhash, comphash) == 0;
+
+    if (!authentication_successful && data.short_pw_len > 0) {
+        short_pw = talloc_strndup(tmp_ctx, password, data.short_pw_len);
+        if (short_pw == NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "talloc_strndup failed.\n");
+            ret = ENOMEM;
+            goto done;
+        }
+        talloc_set_destructor((TALLOC_CTX *)short_pw,
+                              sss_erase_talloc_mem_securely);
+
+        ret = s3crypt_sha512(tmp_ctx, short_pw, data.userhash, &comphash);
+        talloc_free(short_pw);
         if (ret == EOK) {
-            ret = ERR_AUTH_FAILED;
+            authentication_successful = strcmp(data.userhash, comphash) == 0;
+            if (!authentication_successful) {
+                DEBUG(SSSDBG_MINOR_FAILURE,
+                      "Hash of shorten password does not match.\n");
+            }
+        } else {
+            DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
         }
     }
+
+    ret = sysdb_cache_auth_finish(domain, name, cdb, &data, just_check,
+                                  authentication_successful);
+
+done:
+    if (_expire_date != NULL) {
+        *_expire_date = data.expire_date;
+    }
+    if (_delayed_until != NULL) {
+        *_delayed_until = data.delayed_until;
+    }
     talloc_free(tmp_ctx);
     return ret;
 }
 
+struct sysdb_cache_auth_state {
+    struct tevent_context *ev;
+    struct sss_hash_pool *pool;
+    struct sss_domain_info *domain;
+    struct confdb_ctx *cdb;
+    const char *name;
+    char *password;
+    bool just_check;
+    bool short_pw_tried;
+    struct sysdb_cache_auth_data data;
+};
+
+static errno_t sysdb_cache_auth_hash(struct tevent_req *req, size_t len);
+static void sysdb_cache_auth_done(struct tevent_req *subreq);
+
+struct tevent_req *sysdb_cache_auth_send(TALLOC_CTX *mem_ctx,
+                                         struct tevent_context *ev,
+                                         struct sss_hash_pool *pool,
+                                         struct sss_domain_info *domain,
+                                         const char *name,
+                                         const char *password,
+                                         struct confdb_ctx *cdb,
+                                         bool just_check)
+{
+    struct sysdb_cache_auth_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct sysdb_cache_auth_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->pool = pool;
+    state->domain = domain;
+    state->cdb = cdb;
+    state->just_check = just_check;
+
+    ret = sysdb_cache_auth_prepare(state, domain, name, password, cdb,
+                                   &state->data);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    state->name = talloc_strdup(state, name);
+    if (state->name == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    state->password = talloc_strdup(state, password);
+    if (state->password == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    talloc_set_destructor((TALLOC_CTX *)state->password,
+                          sss_erase_talloc_mem_securely);
+
+    ret = sysdb_cache_auth_hash(req, strlen(state->password));
+    if (ret != EOK) {
+        goto done;
+    }
+
+    return req;
+
+done:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static errno_t sysdb_cache_auth_hash(struct tevent_req *req, size_t len)
+{
+    struct sysdb_cache_auth_state *state;
+    struct tevent_req *subreq;
+
+    state = tevent_req_data(req, struct sysdb_cache_auth_state);
+
+    subreq = sss_hash_pool_sha512_send(state, state->ev, state->pool,
+                                       state->password, len,
+                                       state->data.userhash);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sysdb_cache_auth_done, req);
+
+    return EOK;
+}
+
+static void sysdb_cache_auth_done(struct tevent_req *subreq)
+{
+    struct sysdb_cache_auth_state *state;
+    struct tevent_req *req;
+    char *comphash;
+    bool authentication_successful = false;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sysdb_cache_auth_state);
+
+    ret = sss_hash_pool_sha512_recv(state, subreq, &comphash);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
+        if (!state->short_pw_tried) {
+            tevent_req_error(req, ERR_INTERNAL);
+            return;
+        }
+    } else {
+        authentication_successful = strcmp(state->data.userhash,
+                                           comphash) == 0;
+        talloc_free(comphash);
+    }
+
+    if (!authentication_successful && state->short_pw_tried) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Hash of shorten password does not match.\n");
+    }
+
+    if (!authentication_successful && !state->short_pw_tried
+            && state->data.short_pw_len > 0) {
+        state->short_pw_tried = true;
+        ret = sysdb_cache_auth_hash(req, state->data.short_pw_len);
+        if (ret != EOK) {
+            tevent_req_error(req, ret);
+        }
+        return;
+    }
+
+    ret = sysdb_cache_auth_finish(state->domain, state->name, state->cdb,
+                                  &state->data, state->just_check,
+                                  authentication_successful);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+errno_t sysdb_cache_auth_recv(struct tevent_req *req,
+                              time_t *_expire_date,
+                              time_t *_delayed_until)
+{
+    struct sysdb_cache_auth_state *state;
+
+    state = tevent_req_data(req, struct sysdb_cache_auth_state);
+
+    if (_expire_date != NULL) {
+        *_expire_date = state->data.expire_date;
+    }
+    if (_delayed_until != NULL) {
+        *_delayed_until = state->data.delayed_until;
+    }
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
 static errno_t sysdb_update_members_ex(struct sss_domain_info *domain,
                                        const char *member,
                                        enum sysdb_member_type type,
@@ -826,14 +826,14 @@ done:
     return ret;
 }
 
-int sysdb_enumpwent_filter(TALLOC_CTX *mem_ctx,
-                           struct sss_domain_info *domain,
-                           const char *name_filter,
-                           const char *addtl_filter,
-                           struct ldb_result **_res)
+static int sysdb_enumpwent_attrs(TALLOC_CTX *mem_ctx,
+                                 struct sss_domain_info *domain,
+                                 const char **attrs,
+                                 const char *name_filter,
+                                 const char *addtl_filter,
+                                 struct ldb_result **_res)
 {
     TALLOC_CTX *tmp_ctx;
-    static const char *attrs[] = SYSDB_PW_ATTRS;
     char *filter = NULL;
     char *dn_filter = NULL;
     const char *ts_filter = NULL;
@@ -920,6 +920,18 @@ done:
     return ret;
 }
 
+int sysdb_enumpwent_filter(TALLOC_CTX *mem_ctx,
+                           struct sss_domain_info *domain,
+                           const char *name_filter,
+                           const char *addtl_filter,
+                           struct ldb_result **_res)
+{
+    static const char *attrs[] = SYSDB_PW_ATTRS;
+
+    return sysdb_enumpwent_attrs(mem_ctx, domain, attrs, name_filter,
+                                 addtl_filter, _res);
+}
+
 int sysdb_enumpwent(TALLOC_CTX *mem_ctx,
                     struct sss_domain_info *domain,
                     struct ldb_result **_res)
@@ -1418,14 +1430,14 @@ int sysdb_getgrgid(TALLOC_CTX *mem_ctx,
     return sysdb_getgrgid_attrs(mem_ctx, domain, gid, NULL, _res);
 }
 
-int sysdb_enumgrent_filter(TALLOC_CTX *mem_ctx,
-                           struct sss_domain_info *domain,
-                           const char *name_filter,
-                           const char *addtl_filter,
-                           struct ldb_result **_res)
+static int sysdb_enumgrent_attrs(TALLOC_CTX *mem_ctx,
+                                 struct sss_domain_info *domain,
+                                 const char **attrs,
+                                 const char *name_filter,
+                                 const char *addtl_filter,
+                                 struct ldb_result **_res)
 {
     TALLOC_CTX *tmp_ctx;
-    static const char *attrs[] = SYSDB_GRSRC_ATTRS;
     const char *filter = NULL;
     const char *ts_filter = NULL;
     const char *base_filter;
@@ -1529,6 +1541,18 @@ done:
     return ret;
 }
 
+int sysdb_enumgrent_filter(TALLOC_CTX *mem_ctx,
+                           struct sss_domain_info *domain,
+                           const char *name_filter,
+                           const char *addtl_filter,
+                           struct ldb_result **_res)
+{
+    static const char *attrs[] = SYSDB_GRSRC_ATTRS;
+
+    return sysdb_enumgrent_attrs(mem_ctx, domain, attrs, name_filter,
+                                 addtl_filter, _res);
+}
+
 int sysdb_enumgrent(TALLOC_CTX *mem_ctx,
                     struct sss_domain_info *domain,
                     struct ldb_result **_res)
@@ -1595,6 +1619,141 @@ int sysdb_enumgrent_with_views(TALLOC_CTX *mem_ctx,
     return sysdb_enumgrent_filter_with_views(mem_ctx, domain, NULL, NULL, _res);
 }
 
+static int sysdb_enum_names_add_overrides(struct sss_domain_info *domain,
+                                          struct ldb_result *res,
+                                          const char **attrs)
+{
+    size_t c;
+    int ret;
+
+    if (!DOM_HAS_VIEWS(domain)) {
+        return EOK;
+    }
+
+    for (c = 0; c < res->count; c++) {
+        ret = sysdb_add_overrides_to_object(domain, res->msgs[c], NULL,
+                                            attrs);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "sysdb_add_overrides_to_object failed.\n");
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
+int sysdb_enumpwent_names_with_views(TALLOC_CTX *mem_ctx,
+                                     struct sss_domain_info *domain,
+                                     struct ldb_result **_res)
+{
+    static const char *attrs[] = SYSDB_ENUM_NAME_ATTRS;
+    struct ldb_result *res;
+    int ret;
+
+    ret = sysdb_enumpwent_attrs(mem_ctx, domain, attrs, NULL, NULL, &res);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sysdb_enumpwent failed.\n");
+        return ret;
+    }
+
+    ret = sysdb_enum_names_add_overrides(domain, res, attrs);
+    if (ret != EOK) {
+        talloc_free(res);
+        return ret;
+    }
+
+    *_res = res;
+    return EOK;
+}
+
+int sysdb_enumgrent_names_with_views(TALLOC_CTX *mem_ctx,
+                                     struct sss_domain_info *domain,
+                                     struct ldb_result **_res)
+{
+    static const char *attrs[] = SYSDB_ENUM_NAME_ATTRS;
+    struct ldb_result *res;
+    int ret;
+
+    ret = sysdb_enumgrent_attrs(mem_ctx, domain, attrs, NULL, NULL, &res);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sysdb_enumgrent failed.\n");
+        return ret;
+    }
+
+    ret = sysdb_enum_names_add_overrides(domain, res, attrs);
+    if (ret != EOK) {
+        talloc_free(res);
+        return ret;
+    }
+
+    *_res = res;
+    return EOK;
+}
+
+int sysdb_enum_entry_with_views(TALLOC_CTX *mem_ctx,
+                                struct sss_domain_info *domain,
+                                struct ldb_dn *dn,
+                                bool group,
+                                struct ldb_message **_msg)
+{
+    TALLOC_CTX *tmp_ctx;
+    static const char *pw_attrs[] = SYSDB_PW_ATTRS;
+    static const char *gr_attrs[] = SYSDB_GRSRC_ATTRS;
+    struct ldb_message **msgs;
+    size_t count;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_search_entry(tmp_ctx, domain->sysdb, dn, LDB_SCOPE_BASE,
+                             NULL, group ? gr_attrs : pw_attrs,
+                             &count, &msgs);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (count != 1) {
+        ret = EIO;
+        goto done;
+    }
+
+    if (group) {
+        /* users of MPG domains are returned as groups */
+        ret = mpg_convert(msgs[0]);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    if (DOM_HAS_VIEWS(domain)) {
+        ret = sysdb_add_overrides_to_object(domain, msgs[0], NULL, NULL);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "sysdb_add_overrides_to_object failed.\n");
+            goto done;
+        }
+    }
+
+    if (group) {
+        ret = sysdb_add_group_member_overrides(domain, msgs[0],
+                                               DOM_HAS_VIEWS(domain));
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "sysdb_add_group_member_overrides failed.\n");
+            goto done;
+        }
+    }
+
+    *_msg = talloc_steal(mem_ctx, msgs[0]);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
 int sysdb_initgroups(TALLOC_CTX *mem_ctx,
                      struct sss_domain_info *domain,
                      const char *name,
@@ -147,6 +147,16 @@ done:
     return ret;
 }
 
+static void certmap_cache_reset_matches(struct sss_certmap_ctx *ctx)
+{
+    struct certmap_cache_entry *entry;
+
+    DLIST_FOR_EACH(entry, ctx->cache) {
+        entry->matched = false;
+        entry->rule = NULL;
+    }
+}
+
 int sss_certmap_add_rule(struct sss_certmap_ctx *ctx,
                          uint32_t priority, const char *match_rule,
                          const char *map_rule, const char **domains)
@@ -261,6 +271,9 @@ int sss_certmap_add_rule(struct sss_certmap_ctx *ctx,
 
     talloc_steal(ctx, rule);
 
+    /* The new rule might match certificates which are already cached */
+    certmap_cache_reset_matches(ctx);
+
     ret = EOK;
 
 done:
@@ -768,15 +781,111 @@ static int do_match(struct sss_certmap_ctx *ctx,
     return ENOENT;
 }
 
+/* Returns the cache entry for the certificate, decoding it if it is not
+ * cached yet. The entry must be handed back with certmap_cache_release(). */
+static int certmap_cache_get(struct sss_certmap_ctx *ctx,
+                             const uint8_t *der_cert, size_t der_size,
+                             struct certmap_cache_entry **_entry)
+{
+    struct certmap_cache_entry *entry;
+    struct certmap_cache_entry *last = NULL;
+    int ret;
+
+    if (ctx->cache_enabled) {
+        DLIST_FOR_EACH(entry, ctx->cache) {
+            if (entry->content->cert_der_size == der_size
+                    && memcmp(entry->content->cert_der, der_cert,
+                              der_size) == 0) {
+                DLIST_PROMOTE(ctx->cache, entry);
+                *_entry = entry;
+                return 0;
+            }
+            last = entry;
+        }
+    }
+
+    entry = talloc_zero(ctx, struct certmap_cache_entry);
+    if (entry == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_cert_get_content(entry, der_cert, der_size, &entry->content);
+    if (ret != 0) {
+        CM_DEBUG(ctx, "Failed to get certificate content [%d].", ret);
+        talloc_free(entry);
+        return ret;
+    }
+
+    if (!ctx->cache_enabled) {
+        *_entry = entry;
+        return 0;
+    }
+
+    if (ctx->cache_count >= CERTMAP_CACHE_SIZE && last != NULL) {
+        DLIST_REMOVE(ctx->cache, last);
+        talloc_free(last);
+        ctx->cache_count--;
+    }
+
+    DLIST_ADD(ctx->cache, entry);
+    ctx->cache_count++;
+
+    *_entry = entry;
+    return 0;
+}
+
+/* Entries are only kept if the cache is enabled. */
+static void certmap_cache_release(struct sss_certmap_ctx *ctx,
+                                  struct certmap_cache_entry *entry)
+{
+    if (!ctx->cache_enabled) {
+        talloc_free(entry);
+    }
+}
+
+/* Finds the matching rule with the highest priority. The priority list is
+ * sorted, so the first match wins. */
+static int certmap_find_rule(struct sss_certmap_ctx *ctx,
+                             struct certmap_cache_entry *entry,
+                             struct match_map_rule **_rule)
+{
+    struct match_map_rule *r;
+    struct priority_list *p;
+    int ret;
+
+    if (!entry->matched) {
+        entry->rule = NULL;
+
+        for (p = ctx->prio_list; p != NULL && entry->rule == NULL;
+                                                               p = p->next) {
+            for (r = p->rule_list; r != NULL; r = r->next) {
+                ret = do_match(ctx, r->parsed_match_rule, entry->content);
+                if (ret == 0) {
+                    entry->rule = r;
+                    break;
+                }
+            }
+        }
+
+        entry->matched = true;
+    }
+
+    if (entry->rule == NULL) {
+        return ENOENT;
+    }
+
+    *_rule = entry->rule;
+    return 0;
+}
+
 int sss_certmap_match_cert(struct sss_certmap_ctx *ctx,
                            const uint8_t *der_cert, size_t der_size)
 {
     int ret;
     struct match_map_rule *r;
-    struct priority_list *p;
-    struct sss_cert_content *cert_content = NULL;
+    struct certmap_cache_entry *entry;
 
-    ret = sss_cert_get_content(ctx, der_cert, der_size, &cert_content);
+    ret = certmap_cache_get(ctx, der_cert, der_size, &entry);
     if (ret != 0) {
         CM_DEBUG(ctx, "Failed to get certificate content.");
         return ret;
@@ -788,19 +897,10 @@ int sss_certmap_match_cert(struct sss_certmap_ctx *ctx,
         goto done;
     }
 
-    for (p = ctx->prio_list; p != NULL; p = p->next) {
-        for (r = p->rule_list; r != NULL; r = r->next) {
-            ret = do_match(ctx, r->parsed_match_rule, cert_content);
-            if (ret == 0) {
-                /* match */
-                goto done;
-            }
-        }
-    }
+    ret = certmap_find_rule(ctx, entry, &r);
 
-    ret = ENOENT;
 done:
-    talloc_free(cert_content);
+    certmap_cache_release(ctx, entry);
 
     return ret;
 }
@@ -812,8 +912,7 @@ static int expand_mapping_rule_ex(struct sss_certmap_ctx *ctx,
 {
     int ret;
     struct match_map_rule *r;
-    struct priority_list *p;
-    struct sss_cert_content *cert_content = NULL;
+    struct certmap_cache_entry *entry;
     char *filter = NULL;
     char **domains = NULL;
     size_t c;
@@ -822,7 +921,7 @@ static int expand_mapping_rule_ex(struct sss_certmap_ctx *ctx,
         return EINVAL;
     }
 
-    ret = sss_cert_get_content(ctx, der_cert, der_size, &cert_content);
+    ret = certmap_cache_get(ctx, der_cert, der_size, &entry);
     if (ret != 0) {
         CM_DEBUG(ctx, "Failed to get certificate content [%d].", ret);
         return ret;
@@ -831,53 +930,49 @@ static int expand_mapping_rule_ex(struct sss_certmap_ctx *ctx,
     if (ctx->prio_list == NULL) {
         if (ctx->default_mapping_rule == NULL) {
             CM_DEBUG(ctx, "No matching or mapping rules available.");
-            return EINVAL;
+            ret = EINVAL;
+            goto done;
         }
 
-        ret = get_filter(ctx, ctx->default_mapping_rule, cert_content, sanitize,
-                         &filter);
+        ret = get_filter(ctx, ctx->default_mapping_rule, entry->content,
+                         sanitize, &filter);
         goto done;
     }
 
-    for (p = ctx->prio_list; p != NULL; p = p->next) {
-        for (r = p->rule_list; r != NULL; r = r->next) {
-            ret = do_match(ctx, r->parsed_match_rule, cert_content);
-            if (ret == 0) {
-                /* match */
-                ret = get_filter(ctx, r->parsed_mapping_rule, cert_content,
-                                 sanitize, &filter);
-                if (ret != 0) {
-                    CM_DEBUG(ctx, "Failed to get filter");
-                    goto done;
-                }
+    ret = certmap_find_rule(ctx, entry, &r);
+    if (ret != 0) {
+        goto done;
+    }
 
-                if (r->domains != NULL) {
-                    for (c = 0; r->domains[c] != NULL; c++);
-                    domains = talloc_zero_array(ctx, char *, c + 1);
-                    if (domains == NULL) {
-                        ret = ENOMEM;
-                        goto done;
-                    }
-
-                    for (c = 0; r->domains[c] != NULL; c++) {
-                        domains[c] = talloc_strdup(domains, r->domains[c]);
-                        if (domains[c] == NULL) {
-                            ret = ENOMEM;
-                            goto done;
-                        }
-                    }
-                }
+    ret = get_filter(ctx, r->parsed_mapping_rule, entry->content, sanitize,
+                     &filter);
+    if (ret != 0) {
+        CM_DEBUG(ctx, "Failed to get filter");
+        goto done;
+    }
 
-                ret = 0;
+    if (r->domains != NULL) {
+        for (c = 0; r->domains[c] != NULL; c++);
+        domains = talloc_zero_array(ctx, char *, c + 1);
+        if (domains == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        for (c = 0; r->domains[c] != NULL; c++) {
+            domains[c] = talloc_strdup(domains, r->domains[c]);
+            if (domains[c] == NULL) {
+                ret = ENOMEM;
                 goto done;
             }
         }
     }
 
-    ret = ENOENT;
+    ret = 0;
 
 done:
-    talloc_free(cert_content);
+    certmap_cache_release(ctx, entry);
+
     if (ret == 0) {
         *_filter = filter;
         *_domains = domains;
@@ -935,6 +1030,17 @@ int sss_certmap_init(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+int sss_certmap_enable_cache(struct sss_certmap_ctx *ctx)
+{
+    if (ctx == NULL) {
+        return EINVAL;
+    }
+
+    ctx->cache_enabled = true;
+
+    return EOK;
+}
+
 void sss_certmap_free_ctx(struct sss_certmap_ctx *ctx)
 {
     talloc_free(ctx);
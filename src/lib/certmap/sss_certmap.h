@@ -70,6 +70,23 @@ int sss_certmap_init(TALLOC_CTX *mem_ctx,
                      sss_certmap_ext_debug *debug, void *debug_priv,
                      struct sss_certmap_ctx **ctx);
 
+/**
+ * @brief Keep recently used certificates in the certmap context
+ *
+ * After this call the context keeps the decoded content and the matching
+ * result of recently used certificates, so repeated lookups of the same
+ * certificate are faster. Lookups then modify the context, which must not
+ * be used by multiple threads at the same time.
+ *
+ * @param[in] ctx      certmap context previously initialized with
+ *                     @ref sss_certmap_init
+ *
+ * @return
+ *  - 0:      success
+ *  - EINVAL: ctx is NULL
+ */
+int sss_certmap_enable_cache(struct sss_certmap_ctx *ctx);
+
 /**
  * @brief Free certmap context
  *
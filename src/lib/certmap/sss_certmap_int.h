@@ -136,11 +136,28 @@ struct priority_list {
     struct priority_list *next;
 };
 
+/* Number of recently used certificates whose decoded content and matching
+ * result is kept in the certmap context */
+#define CERTMAP_CACHE_SIZE 16
+
+struct certmap_cache_entry {
+    /* content->cert_der is the lookup key */
+    struct sss_cert_content *content;
+    bool matched;
+    /* matching rule with the highest priority, NULL if no rule matches */
+    struct match_map_rule *rule;
+    struct certmap_cache_entry *prev;
+    struct certmap_cache_entry *next;
+};
+
 struct sss_certmap_ctx {
     struct priority_list *prio_list;
     sss_certmap_ext_debug *debug;
     void *debug_priv;
     struct ldap_mapping_rule *default_mapping_rule;
+    bool cache_enabled;
+    struct certmap_cache_entry *cache;
+    size_t cache_count;
 };
 
 struct san_list {
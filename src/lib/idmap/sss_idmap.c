@@ -321,6 +321,387 @@ static void sss_idmap_free_domain(struct sss_idmap_ctx *ctx,
     ctx->free_func(dom, ctx->alloc_pvt);
 }
 
+/* Lookup index
+ *
+ * Every conversion used to walk the whole domain list. With many trusted
+ * domains and automatically added secondary slices this gets slow, so the
+ * list is indexed lazily when a conversion needs it and the index is
+ * dropped whenever a domain is added.
+ *
+ * Domain SIDs always have the form S-1-5-21-x-y-z (see is_domain_sid()),
+ * so a SID belongs to a domain exactly if its first three sub-authorities
+ * are the domain SID. The SID index is a hash table keyed by this prefix
+ * holding all slices of a domain in list order. The ID ranges of the
+ * primary slices and of the not yet used secondary slices are kept in
+ * arrays sorted by the lower bound, together with the largest upper bound
+ * seen so far, which allows to stop the search for an ID early. */
+
+struct idmap_index_sid {
+    const char *sid;
+    size_t sid_len;
+
+    /* slices of the domain, in the order of the domain list */
+    struct idmap_domain_info **doms;
+    size_t num_doms;
+
+    struct idmap_index_sid *next;
+};
+
+struct idmap_index_range {
+    uint32_t min_id;
+    uint32_t max_id;
+    /* largest max_id of this and all preceding entries */
+    uint32_t max_end;
+    /* position in the domain list, the first match in the list wins */
+    size_t pos;
+
+    struct idmap_domain_info *dom;
+    struct idmap_range_params *range;
+};
+
+struct idmap_index {
+    struct idmap_index_sid **buckets;
+    size_t num_buckets;
+    struct idmap_index_sid *sids;
+    struct idmap_domain_info **sid_doms;
+
+    struct idmap_index_range *ranges;
+    size_t num_ranges;
+    struct idmap_index_range *sec_ranges;
+    size_t num_sec_ranges;
+};
+
+static void idmap_index_free(struct sss_idmap_ctx *ctx)
+{
+    struct idmap_index *index = ctx->index;
+
+    if (index == NULL) {
+        return;
+    }
+
+    ctx->free_func(index->buckets, ctx->alloc_pvt);
+    ctx->free_func(index->sids, ctx->alloc_pvt);
+    ctx->free_func(index->sid_doms, ctx->alloc_pvt);
+    ctx->free_func(index->ranges, ctx->alloc_pvt);
+    ctx->free_func(index->sec_ranges, ctx->alloc_pvt);
+    ctx->free_func(index, ctx->alloc_pvt);
+
+    ctx->index = NULL;
+}
+
+static void *idmap_index_alloc(struct sss_idmap_ctx *ctx, size_t nmemb,
+                               size_t size)
+{
+    void *ptr;
+
+    /* always allocate at least one element to be able to tell an empty
+     * array from an allocation failure */
+    if (nmemb == 0) {
+        nmemb = 1;
+    }
+
+    ptr = ctx->alloc_func(nmemb * size, ctx->alloc_pvt);
+    if (ptr != NULL) {
+        memset(ptr, 0, nmemb * size);
+    }
+
+    return ptr;
+}
+
+/* Returns the length of the domain part of the SID or 0 if the SID cannot
+ * belong to any domain. */
+static size_t sid_dom_prefix_len(const char *sid)
+{
+    const char *p;
+    size_t c;
+
+    if (strncmp(sid, DOM_SID_PREFIX, DOM_SID_PREFIX_LEN) != 0) {
+        return 0;
+    }
+
+    p = sid + DOM_SID_PREFIX_LEN;
+    for (c = 0; c < 3; c++) {
+        if (c > 0) {
+            if (*p != '-') {
+                return 0;
+            }
+            p++;
+        }
+
+        while (*p != '-' && *p != '\0') {
+            p++;
+        }
+    }
+
+    return p - sid;
+}
+
+static uint32_t idmap_index_hash(const char *sid, size_t len)
+{
+    return murmurhash3(sid, len, 0xdeadbeef);
+}
+
+struct idmap_index_sort_dom {
+    struct idmap_domain_info *dom;
+    size_t pos;
+};
+
+static int idmap_index_sort_dom_cmp(const void *a, const void *b)
+{
+    const struct idmap_index_sort_dom *da = a;
+    const struct idmap_index_sort_dom *db = b;
+    int ret;
+
+    ret = strcmp(da->dom->sid, db->dom->sid);
+    if (ret != 0) {
+        return ret;
+    }
+
+    return (da->pos > db->pos) - (da->pos < db->pos);
+}
+
+static int idmap_index_range_cmp(const void *a, const void *b)
+{
+    const struct idmap_index_range *ra = a;
+    const struct idmap_index_range *rb = b;
+
+    if (ra->min_id != rb->min_id) {
+        return ra->min_id < rb->min_id ? -1 : 1;
+    }
+
+    return (ra->pos > rb->pos) - (ra->pos < rb->pos);
+}
+
+static void idmap_index_sort_ranges(struct idmap_index_range *ranges,
+                                    size_t num)
+{
+    uint32_t max_end = 0;
+    size_t c;
+
+    qsort(ranges, num, sizeof(struct idmap_index_range),
+          idmap_index_range_cmp);
+
+    for (c = 0; c < num; c++) {
+        if (ranges[c].max_id > max_end) {
+            max_end = ranges[c].max_id;
+        }
+        ranges[c].max_end = max_end;
+    }
+}
+
+static enum idmap_error_code idmap_index_build(struct sss_idmap_ctx *ctx)
+{
+    struct idmap_index *index;
+    struct idmap_index_sort_dom *sorted = NULL;
+    struct idmap_index_sid *entry = NULL;
+    struct idmap_domain_info *dom;
+    struct idmap_range_params *it;
+    enum idmap_error_code err;
+    size_t num_doms = 0;
+    size_t num_sid_doms = 0;
+    size_t num_helpers = 0;
+    size_t pos;
+    size_t c;
+    uint32_t bucket;
+
+    for (dom = ctx->idmap_domain_info; dom != NULL; dom = dom->next) {
+        num_doms++;
+        if (dom->sid != NULL) {
+            num_sid_doms++;
+        }
+        if (dom->helpers_owner) {
+            for (it = dom->helpers; it != NULL; it = it->next) {
+                num_helpers++;
+            }
+        }
+    }
+
+    index = idmap_index_alloc(ctx, 1, sizeof(struct idmap_index));
+    if (index == NULL) {
+        return IDMAP_OUT_OF_MEMORY;
+    }
+    ctx->index = index;
+
+    index->num_buckets = 16;
+    while (index->num_buckets < num_sid_doms * 2) {
+        index->num_buckets *= 2;
+    }
+
+    index->buckets = idmap_index_alloc(ctx, index->num_buckets,
+                                       sizeof(struct idmap_index_sid *));
+    index->sids = idmap_index_alloc(ctx, num_sid_doms,
+                                    sizeof(struct idmap_index_sid));
+    index->sid_doms = idmap_index_alloc(ctx, num_sid_doms,
+                                        sizeof(struct idmap_domain_info *));
+    index->ranges = idmap_index_alloc(ctx, num_doms,
+                                      sizeof(struct idmap_index_range));
+    index->sec_ranges = idmap_index_alloc(ctx, num_helpers,
+                                          sizeof(struct idmap_index_range));
+    sorted = idmap_index_alloc(ctx, num_sid_doms,
+                               sizeof(struct idmap_index_sort_dom));
+    if (index->buckets == NULL || index->sids == NULL
+            || index->sid_doms == NULL || index->ranges == NULL
+            || index->sec_ranges == NULL || sorted == NULL) {
+        err = IDMAP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* SID index */
+    c = 0;
+    pos = 0;
+    for (dom = ctx->idmap_domain_info; dom != NULL; dom = dom->next) {
+        if (dom->sid != NULL) {
+            sorted[c].dom = dom;
+            sorted[c].pos = pos;
+            c++;
+        }
+        pos++;
+    }
+
+    qsort(sorted, num_sid_doms, sizeof(struct idmap_index_sort_dom),
+          idmap_index_sort_dom_cmp);
+
+    for (c = 0; c < num_sid_doms; c++) {
+        index->sid_doms[c] = sorted[c].dom;
+
+        if (entry != NULL && strcmp(entry->sid, sorted[c].dom->sid) == 0) {
+            entry->num_doms++;
+            continue;
+        }
+
+        entry = (entry == NULL) ? index->sids : entry + 1;
+        entry->sid = sorted[c].dom->sid;
+        entry->sid_len = strlen(entry->sid);
+        entry->doms = &index->sid_doms[c];
+        entry->num_doms = 1;
+
+        bucket = idmap_index_hash(entry->sid, entry->sid_len)
+                    & (index->num_buckets - 1);
+        entry->next = index->buckets[bucket];
+        index->buckets[bucket] = entry;
+    }
+
+    /* ID ranges */
+    pos = 0;
+    for (dom = ctx->idmap_domain_info; dom != NULL; dom = dom->next) {
+        index->ranges[index->num_ranges].min_id = dom->range_params.min_id;
+        index->ranges[index->num_ranges].max_id = dom->range_params.max_id;
+        index->ranges[index->num_ranges].pos = pos;
+        index->ranges[index->num_ranges].dom = dom;
+        index->ranges[index->num_ranges].range = &dom->range_params;
+        index->num_ranges++;
+
+        if (dom->helpers_owner) {
+            /* Checking helpers on owner is sufficient. */
+            for (it = dom->helpers; it != NULL; it = it->next) {
+                index->sec_ranges[index->num_sec_ranges].min_id = it->min_id;
+                index->sec_ranges[index->num_sec_ranges].max_id = it->max_id;
+                index->sec_ranges[index->num_sec_ranges].pos = pos;
+                index->sec_ranges[index->num_sec_ranges].dom = dom;
+                index->sec_ranges[index->num_sec_ranges].range = it;
+                index->num_sec_ranges++;
+                pos++;
+            }
+        }
+        pos++;
+    }
+
+    idmap_index_sort_ranges(index->ranges, index->num_ranges);
+    idmap_index_sort_ranges(index->sec_ranges, index->num_sec_ranges);
+
+    err = IDMAP_SUCCESS;
+
+done:
+    ctx->free_func(sorted, ctx->alloc_pvt);
+    if (err != IDMAP_SUCCESS) {
+        idmap_index_free(ctx);
+    }
+
+    return err;
+}
+
+static enum idmap_error_code idmap_index_get(struct sss_idmap_ctx *ctx,
+                                             struct idmap_index **_index)
+{
+    enum idmap_error_code err;
+
+    if (ctx->index == NULL) {
+        err = idmap_index_build(ctx);
+        if (err != IDMAP_SUCCESS) {
+            return err;
+        }
+    }
+
+    *_index = ctx->index;
+    return IDMAP_SUCCESS;
+}
+
+/* Returns all slices of the domain the SID belongs to or NULL. sid may be
+ * a domain SID as well. */
+static struct idmap_index_sid *idmap_index_find_sid(struct idmap_index *index,
+                                                    const char *sid)
+{
+    struct idmap_index_sid *entry;
+    size_t len;
+
+    len = sid_dom_prefix_len(sid);
+    if (len == 0) {
+        return NULL;
+    }
+
+    entry = index->buckets[idmap_index_hash(sid, len)
+                               & (index->num_buckets - 1)];
+    for (; entry != NULL; entry = entry->next) {
+        if (entry->sid_len == len && strncmp(entry->sid, sid, len) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* Returns the range containing id which comes first in the domain list or
+ * NULL. All ranges which may contain id are checked, not only the first
+ * candidate, so an ID in any of the ranges of a domain is found. */
+static struct idmap_index_range *
+idmap_index_find_id(struct idmap_index_range *ranges, size_t num, uint32_t id,
+                    uint32_t *_rid)
+{
+    struct idmap_index_range *found = NULL;
+    size_t lower = 0;
+    size_t upper = num;
+    size_t mid;
+    size_t c;
+    uint32_t rid;
+
+    if (id == 0) {
+        return NULL;
+    }
+
+    /* find the first range starting after id */
+    while (lower < upper) {
+        mid = lower + (upper - lower) / 2;
+        if (ranges[mid].min_id <= id) {
+            lower = mid + 1;
+        } else {
+            upper = mid;
+        }
+    }
+
+    for (c = lower; c > 0 && ranges[c - 1].max_end >= id; c--) {
+        if (found != NULL && ranges[c - 1].pos > found->pos) {
+            continue;
+        }
+
+        if (id_is_in_range(id, ranges[c - 1].range, &rid)) {
+            found = &ranges[c - 1];
+            *_rid = rid;
+        }
+    }
+
+    return found;
+}
+
 enum idmap_error_code sss_idmap_free(struct sss_idmap_ctx *ctx)
 {
     struct idmap_domain_info *dom;
@@ -335,6 +716,8 @@ enum idmap_error_code sss_idmap_free(struct sss_idmap_ctx *ctx)
         sss_idmap_free_domain(ctx, dom);
     }
 
+    idmap_index_free(ctx);
+
     ctx->free_func(ctx, ctx->alloc_pvt);
 
     return IDMAP_SUCCESS;
@@ -795,6 +1178,7 @@ enum idmap_error_code sss_idmap_add_domain_ex(struct sss_idmap_ctx *ctx,
 
     dom->next = ctx->idmap_domain_info;
     ctx->idmap_domain_info = dom;
+    idmap_index_free(ctx);
 
     return IDMAP_SUCCESS;
 
@@ -862,6 +1246,9 @@ sss_idmap_add_auto_domain_ex(struct sss_idmap_ctx *ctx,
     ctx->idmap_domain_info->cb = cb;
     ctx->idmap_domain_info->pvt = pvt;
 
+    /* The secondary slices must be indexed as well */
+    idmap_index_free(ctx);
+
     return err;
 }
 
@@ -899,25 +1286,6 @@ static bool parse_rid(const char *sid, size_t dom_prefix_len, long long *_rid)
     return true;
 }
 
-static bool is_sid_from_dom(const char *dom_sid, const char *sid,
-                            size_t *_dom_sid_len)
-{
-    size_t dom_sid_len;
-
-    if (dom_sid == NULL) {
-        return false;
-    }
-
-    dom_sid_len = strlen(dom_sid);
-    *_dom_sid_len = dom_sid_len;
-
-    if (strlen(sid) < dom_sid_len || sid[dom_sid_len] != '-') {
-        return false;
-    }
-
-    return strncmp(sid, dom_sid, dom_sid_len) == 0;
-}
-
 static bool comp_id(struct idmap_range_params *range_params, long long rid,
                     uint32_t *_id)
 {
@@ -1082,10 +1450,12 @@ enum idmap_error_code sss_idmap_sid_to_unix(struct sss_idmap_ctx *ctx,
                                             const char *sid,
                                             uint32_t *_id)
 {
-    struct idmap_domain_info *idmap_domain_info;
     struct idmap_domain_info *matched_dom = NULL;
-    size_t dom_len;
+    struct idmap_index *index;
+    struct idmap_index_sid *entry;
+    enum idmap_error_code err;
     long long rid;
+    size_t c;
 
     if (sid == NULL || _id == NULL) {
         return IDMAP_ERROR;
@@ -1093,33 +1463,37 @@ enum idmap_error_code sss_idmap_sid_to_unix(struct sss_idmap_ctx *ctx,
 
     CHECK_IDMAP_CTX(ctx, IDMAP_CONTEXT_INVALID);
 
-    idmap_domain_info = ctx->idmap_domain_info;
-
     if (sss_idmap_sid_is_builtin(sid)) {
         return IDMAP_BUILTIN_SID;
     }
 
+    err = idmap_index_get(ctx, &index);
+    if (err != IDMAP_SUCCESS) {
+        return err;
+    }
+
     /* Try primary slices */
-    while (idmap_domain_info != NULL) {
+    entry = idmap_index_find_sid(index, sid);
+    if (entry != NULL && sid[entry->sid_len] == '-') {
+        if (entry->doms[0]->external_mapping == true) {
+            return IDMAP_EXTERNAL;
+        }
 
-        if (is_sid_from_dom(idmap_domain_info->sid, sid, &dom_len)) {
+        if (parse_rid(sid, entry->sid_len, &rid) == false) {
+            return IDMAP_SID_INVALID;
+        }
 
-            if (idmap_domain_info->external_mapping == true) {
+        for (c = 0; c < entry->num_doms; c++) {
+            if (entry->doms[c]->external_mapping == true) {
                 return IDMAP_EXTERNAL;
             }
 
-            if (parse_rid(sid, dom_len, &rid) == false) {
-                return IDMAP_SID_INVALID;
-            }
-
-            if (comp_id(&idmap_domain_info->range_params, rid, _id)) {
+            if (comp_id(&entry->doms[c]->range_params, rid, _id)) {
                 return IDMAP_SUCCESS;
             }
 
-            matched_dom = idmap_domain_info;
+            matched_dom = entry->doms[c];
         }
-
-        idmap_domain_info = idmap_domain_info->next;
     }
 
     if (matched_dom != NULL && matched_dom->auto_add_ranges) {
@@ -1133,9 +1507,10 @@ enum idmap_error_code sss_idmap_check_sid_unix(struct sss_idmap_ctx *ctx,
                                                const char *sid,
                                                uint32_t id)
 {
-    struct idmap_domain_info *idmap_domain_info;
-    size_t dom_len;
-    bool no_range = false;
+    struct idmap_index *index;
+    struct idmap_index_sid *entry;
+    enum idmap_error_code err;
+    size_t c;
 
     if (sid == NULL) {
         return IDMAP_ERROR;
@@ -1147,31 +1522,28 @@ enum idmap_error_code sss_idmap_check_sid_unix(struct sss_idmap_ctx *ctx,
         return IDMAP_NO_DOMAIN;
     }
 
-    idmap_domain_info = ctx->idmap_domain_info;
-
     if (sss_idmap_sid_is_builtin(sid)) {
         return IDMAP_BUILTIN_SID;
     }
 
-    while (idmap_domain_info != NULL) {
-        if (idmap_domain_info->sid != NULL) {
-            dom_len = strlen(idmap_domain_info->sid);
-            if (strlen(sid) > dom_len && sid[dom_len] == '-'
-                    && strncmp(sid, idmap_domain_info->sid, dom_len) == 0) {
-
-                if (id >= idmap_domain_info->range_params.min_id
-                    && id <= idmap_domain_info->range_params.max_id) {
-                    return IDMAP_SUCCESS;
-                }
+    err = idmap_index_get(ctx, &index);
+    if (err != IDMAP_SUCCESS) {
+        return err;
+    }
 
-                no_range = true;
-            }
-        }
+    entry = idmap_index_find_sid(index, sid);
+    if (entry == NULL || sid[entry->sid_len] != '-') {
+        return IDMAP_SID_UNKNOWN;
+    }
 
-        idmap_domain_info = idmap_domain_info->next;
+    for (c = 0; c < entry->num_doms; c++) {
+        if (id >= entry->doms[c]->range_params.min_id
+                && id <= entry->doms[c]->range_params.max_id) {
+            return IDMAP_SUCCESS;
+        }
     }
 
-    return no_range ? IDMAP_NO_RANGE : IDMAP_SID_UNKNOWN;
+    return IDMAP_NO_RANGE;
 }
 
 static enum idmap_error_code generate_sid(struct sss_idmap_ctx *ctx,
@@ -1208,57 +1580,48 @@ enum idmap_error_code sss_idmap_unix_to_sid(struct sss_idmap_ctx *ctx,
                                             char **_sid)
 {
     struct idmap_domain_info *idmap_domain_info;
+    struct idmap_index *index;
+    struct idmap_index_range *found;
     uint32_t rid;
     enum idmap_error_code err;
 
     CHECK_IDMAP_CTX(ctx, IDMAP_CONTEXT_INVALID);
 
-    idmap_domain_info = ctx->idmap_domain_info;
-
-    while (idmap_domain_info != NULL) {
-        if (id_is_in_range(id, &idmap_domain_info->range_params, &rid)) {
+    err = idmap_index_get(ctx, &index);
+    if (err != IDMAP_SUCCESS) {
+        return err;
+    }
 
-            if (idmap_domain_info->external_mapping == true
-                    || idmap_domain_info->sid == NULL) {
-                return IDMAP_EXTERNAL;
-            }
+    found = idmap_index_find_id(index->ranges, index->num_ranges, id, &rid);
+    if (found != NULL) {
+        idmap_domain_info = found->dom;
 
-            return generate_sid(ctx, idmap_domain_info->sid, rid, _sid);
+        if (idmap_domain_info->external_mapping == true
+                || idmap_domain_info->sid == NULL) {
+            return IDMAP_EXTERNAL;
         }
 
-        idmap_domain_info = idmap_domain_info->next;
+        return generate_sid(ctx, idmap_domain_info->sid, rid, _sid);
     }
 
     /* Check secondary ranges. */
-    idmap_domain_info = ctx->idmap_domain_info;
-    while (idmap_domain_info != NULL) {
-
-        for (struct idmap_range_params *it = idmap_domain_info->helpers;
-             it != NULL;
-             it = it->next) {
-
-            if (idmap_domain_info->helpers_owner == false) {
-                /* Checking helpers on owner is sufficient. */
-                continue;
-            }
-
-            if (id_is_in_range(id, it, &rid)) {
-
-                if (idmap_domain_info->external_mapping == true
-                    || idmap_domain_info->sid == NULL) {
-                    return IDMAP_EXTERNAL;
-                }
-
-                err = spawn_dom(ctx, idmap_domain_info, it);
-                if (err != IDMAP_SUCCESS) {
-                    return err;
-                }
+    found = idmap_index_find_id(index->sec_ranges, index->num_sec_ranges, id,
+                                &rid);
+    if (found != NULL) {
+        idmap_domain_info = found->dom;
+
+        if (idmap_domain_info->external_mapping == true
+            || idmap_domain_info->sid == NULL) {
+            return IDMAP_EXTERNAL;
+        }
 
-                return generate_sid(ctx, idmap_domain_info->sid, rid, _sid);
-            }
+        /* spawn_dom() drops the index */
+        err = spawn_dom(ctx, idmap_domain_info, found->range);
+        if (err != IDMAP_SUCCESS) {
+            return err;
         }
 
-        idmap_domain_info = idmap_domain_info->next;
+        return generate_sid(ctx, idmap_domain_info->sid, rid, _sid);
     }
 
     return IDMAP_NO_DOMAIN;
@@ -1543,9 +1906,9 @@ sss_idmap_domain_has_algorithmic_mapping(struct sss_idmap_ctx *ctx,
                                          const char *dom_sid,
                                          bool *has_algorithmic_mapping)
 {
-    struct idmap_domain_info *idmap_domain_info;
-    size_t len;
-    size_t dom_sid_len;
+    struct idmap_index *index;
+    struct idmap_index_sid *entry;
+    enum idmap_error_code err;
 
     if (dom_sid == NULL) {
         return IDMAP_SID_INVALID;
@@ -1557,26 +1920,18 @@ sss_idmap_domain_has_algorithmic_mapping(struct sss_idmap_ctx *ctx,
         return IDMAP_NO_DOMAIN;
     }
 
-    idmap_domain_info = ctx->idmap_domain_info;
-
-    while (idmap_domain_info != NULL) {
-        if (idmap_domain_info->sid != NULL) {
-            len = strlen(idmap_domain_info->sid);
-            dom_sid_len = strlen(dom_sid);
-            if (((dom_sid_len > len && dom_sid[len] == '-')
-                        || dom_sid_len == len)
-                    && strncmp(dom_sid, idmap_domain_info->sid, len) == 0) {
-
-                *has_algorithmic_mapping = !idmap_domain_info->external_mapping;
-                return IDMAP_SUCCESS;
-
-            }
-        }
+    err = idmap_index_get(ctx, &index);
+    if (err != IDMAP_SUCCESS) {
+        return err;
+    }
 
-        idmap_domain_info = idmap_domain_info->next;
+    entry = idmap_index_find_sid(index, dom_sid);
+    if (entry == NULL) {
+        return IDMAP_SID_UNKNOWN;
     }
 
-    return IDMAP_SID_UNKNOWN;
+    *has_algorithmic_mapping = !entry->doms[0]->external_mapping;
+    return IDMAP_SUCCESS;
 }
 
 enum idmap_error_code
@@ -356,6 +356,599 @@ static errno_t hbac_evaluate_element(struct hbac_rule_element *rule_el,
     return EOK;
 }
 
+/* Compiled rule sets
+ *
+ * Every enabled rule gets a bit in a bitmap. For each of the four rule
+ * elements the rules with category ALL are stored in a bitmap and the
+ * case-folded member and group names are stored in hash tables that map
+ * each name to the list of rules that contain it. Evaluating a request
+ * then means collecting the candidate bits of each element from the
+ * tables, intersecting the four results and picking the lowest bit,
+ * which is the first rule hbac_evaluate() would have matched.
+ */
+
+#define HBAC_BITS_PER_WORD 32
+#define HBAC_BITS_WORDS(n) (((n) + HBAC_BITS_PER_WORD - 1) / HBAC_BITS_PER_WORD)
+
+#define HBAC_BIT_SET(bits, n) \
+    ((bits)[(n) / HBAC_BITS_PER_WORD] |= (uint32_t)1 << ((n) % HBAC_BITS_PER_WORD))
+#define HBAC_BIT_IS_SET(bits, n) \
+    ((bits)[(n) / HBAC_BITS_PER_WORD] & ((uint32_t)1 << ((n) % HBAC_BITS_PER_WORD)))
+
+struct hbac_index_entry {
+    struct hbac_index_entry *next;
+    uint8_t *key;
+
+    /* ascending indexes of the rules that contain the name */
+    size_t *rules;
+    size_t num_rules;
+    size_t alloc_rules;
+};
+
+struct hbac_index {
+    struct hbac_index_entry **buckets;
+    size_t mask;
+};
+
+struct hbac_compiled_element {
+    uint32_t *all;
+    struct hbac_index names;
+    struct hbac_index groups;
+};
+
+enum hbac_compiled_element_type {
+    HBAC_COMPILED_USERS,
+    HBAC_COMPILED_SERVICES,
+    HBAC_COMPILED_TARGETHOSTS,
+    HBAC_COMPILED_SRCHOSTS,
+
+    HBAC_COMPILED_SENTINEL
+};
+
+struct hbac_compiled_rules {
+    struct hbac_rule **rules;
+    size_t num_rules;
+    size_t words;
+
+    struct hbac_compiled_element elements[HBAC_COMPILED_SENTINEL];
+
+    /* enabled rules with missing elements, they always yield an error */
+    uint32_t *unparseable;
+
+    /* rules that could not be indexed and are evaluated the slow way */
+    uint32_t *uncompiled;
+};
+
+static struct hbac_rule_element *
+hbac_rule_get_element(struct hbac_rule *rule,
+                      enum hbac_compiled_element_type type)
+{
+    switch (type) {
+    case HBAC_COMPILED_USERS:
+        return rule->users;
+    case HBAC_COMPILED_SERVICES:
+        return rule->services;
+    case HBAC_COMPILED_TARGETHOSTS:
+        return rule->targethosts;
+    case HBAC_COMPILED_SRCHOSTS:
+        return rule->srchosts;
+    case HBAC_COMPILED_SENTINEL:
+        break;
+    }
+
+    return NULL;
+}
+
+static struct hbac_request_element *
+hbac_req_get_element(struct hbac_eval_req *req,
+                     enum hbac_compiled_element_type type)
+{
+    switch (type) {
+    case HBAC_COMPILED_USERS:
+        return req->user;
+    case HBAC_COMPILED_SERVICES:
+        return req->service;
+    case HBAC_COMPILED_TARGETHOSTS:
+        return req->targethost;
+    case HBAC_COMPILED_SRCHOSTS:
+        return req->srchost;
+    case HBAC_COMPILED_SENTINEL:
+        break;
+    }
+
+    return NULL;
+}
+
+/* FNV-1a */
+static size_t hbac_index_hash(const uint8_t *key)
+{
+    uint32_t hash = 2166136261U;
+
+    for (; *key != '\0'; key++) {
+        hash ^= *key;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static errno_t hbac_index_init(struct hbac_index *index, size_t num_keys)
+{
+    size_t size = 16;
+
+    while (size < num_keys * 2) {
+        size *= 2;
+    }
+
+    index->buckets = calloc(size, sizeof(struct hbac_index_entry *));
+    if (index->buckets == NULL) {
+        return ENOMEM;
+    }
+    index->mask = size - 1;
+
+    return EOK;
+}
+
+static void hbac_index_free(struct hbac_index *index)
+{
+    struct hbac_index_entry *entry;
+    struct hbac_index_entry *next;
+    size_t i;
+
+    if (index->buckets == NULL) {
+        return;
+    }
+
+    for (i = 0; i <= index->mask; i++) {
+        for (entry = index->buckets[i]; entry != NULL; entry = next) {
+            next = entry->next;
+            free(entry->key);
+            free(entry->rules);
+            free(entry);
+        }
+    }
+
+    free(index->buckets);
+    index->buckets = NULL;
+}
+
+static struct hbac_index_entry *hbac_index_lookup(struct hbac_index *index,
+                                                  const uint8_t *key)
+{
+    struct hbac_index_entry *entry;
+
+    entry = index->buckets[hbac_index_hash(key) & index->mask];
+    for (; entry != NULL; entry = entry->next) {
+        if (strcmp((const char *) entry->key, (const char *) key) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* Takes ownership of key */
+static errno_t hbac_index_add(struct hbac_index *index,
+                              uint8_t *key,
+                              size_t rule_idx)
+{
+    struct hbac_index_entry *entry;
+    size_t *rules;
+    size_t bucket;
+
+    entry = hbac_index_lookup(index, key);
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(struct hbac_index_entry));
+        if (entry == NULL) {
+            free(key);
+            return ENOMEM;
+        }
+
+        bucket = hbac_index_hash(key) & index->mask;
+        entry->key = key;
+        entry->next = index->buckets[bucket];
+        index->buckets[bucket] = entry;
+    } else {
+        free(key);
+    }
+
+    /* Rules are added in ascending order, so a name listed twice in the
+     * same rule is always the last one */
+    if (entry->num_rules > 0
+            && entry->rules[entry->num_rules - 1] == rule_idx) {
+        return EOK;
+    }
+
+    if (entry->num_rules == entry->alloc_rules) {
+        rules = realloc(entry->rules, (entry->alloc_rules + 4) * sizeof(size_t));
+        if (rules == NULL) {
+            return ENOMEM;
+        }
+        entry->rules = rules;
+        entry->alloc_rules += 4;
+    }
+
+    entry->rules[entry->num_rules] = rule_idx;
+    entry->num_rules++;
+
+    return EOK;
+}
+
+static size_t hbac_count_names(const char **names)
+{
+    size_t n = 0;
+
+    if (names != NULL) {
+        for (; names[n] != NULL; n++);
+    }
+
+    return n;
+}
+
+/* Returns ENOMATCH if any of the names cannot be converted to a key, the
+ * rule must then be evaluated with hbac_evaluate_rule() */
+static errno_t hbac_index_add_names(struct hbac_index *index,
+                                    const char **names,
+                                    size_t rule_idx)
+{
+    uint8_t *key;
+    errno_t ret;
+    size_t i;
+
+    if (names == NULL) {
+        return EOK;
+    }
+
+    for (i = 0; names[i] != NULL; i++) {
+        ret = sss_utf8_case_key((const uint8_t *) names[i], &key);
+        if (ret == ENOMEM) {
+            return ENOMEM;
+        } else if (ret != EOK) {
+            return ENOMATCH;
+        }
+
+        ret = hbac_index_add(index, key, rule_idx);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
+static errno_t hbac_compile_element(struct hbac_compiled_rules *compiled,
+                                    enum hbac_compiled_element_type type)
+{
+    struct hbac_compiled_element *cel;
+    struct hbac_rule_element *el;
+    size_t num_names = 0;
+    size_t num_groups = 0;
+    errno_t ret;
+    size_t i;
+
+    cel = &compiled->elements[type];
+
+    cel->all = calloc(compiled->words, sizeof(uint32_t));
+    if (cel->all == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < compiled->num_rules; i++) {
+        el = hbac_rule_get_element(compiled->rules[i], type);
+        if (el != NULL) {
+            num_names += hbac_count_names(el->names);
+            num_groups += hbac_count_names(el->groups);
+        }
+    }
+
+    ret = hbac_index_init(&cel->names, num_names);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = hbac_index_init(&cel->groups, num_groups);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    for (i = 0; i < compiled->num_rules; i++) {
+        if (!compiled->rules[i]->enabled
+                || HBAC_BIT_IS_SET(compiled->unparseable, i)
+                || HBAC_BIT_IS_SET(compiled->uncompiled, i)) {
+            continue;
+        }
+
+        el = hbac_rule_get_element(compiled->rules[i], type);
+        if (el->category & HBAC_CATEGORY_ALL) {
+            HBAC_BIT_SET(cel->all, i);
+            continue;
+        }
+
+        ret = hbac_index_add_names(&cel->names, el->names, i);
+        if (ret == EOK) {
+            ret = hbac_index_add_names(&cel->groups, el->groups, i);
+        }
+
+        if (ret == ENOMATCH) {
+            HBAC_DEBUG(HBAC_DBG_INFO,
+                       "Rule [%s] cannot be indexed, it will be evaluated "
+                       "separately\n", compiled->rules[i]->name);
+            HBAC_BIT_SET(compiled->uncompiled, i);
+        } else if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
+enum hbac_error_code hbac_rules_compile(struct hbac_rule **rules,
+                                        struct hbac_compiled_rules **_compiled)
+{
+    struct hbac_compiled_rules *compiled;
+    struct hbac_rule *rule;
+    enum hbac_compiled_element_type type;
+    errno_t ret;
+    size_t i;
+
+    if (rules == NULL || _compiled == NULL) {
+        return HBAC_ERROR_UNKNOWN;
+    }
+
+    compiled = calloc(1, sizeof(struct hbac_compiled_rules));
+    if (compiled == NULL) {
+        return HBAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    compiled->rules = rules;
+    compiled->num_rules = hbac_count_names((const char **) rules);
+    compiled->words = HBAC_BITS_WORDS(compiled->num_rules);
+    if (compiled->words == 0) {
+        compiled->words = 1;
+    }
+
+    compiled->unparseable = calloc(compiled->words, sizeof(uint32_t));
+    compiled->uncompiled = calloc(compiled->words, sizeof(uint32_t));
+    if (compiled->unparseable == NULL || compiled->uncompiled == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < compiled->num_rules; i++) {
+        rule = rules[i];
+        if (rule->enabled
+                && (rule->users == NULL || rule->services == NULL
+                    || rule->targethosts == NULL || rule->srchosts == NULL)) {
+            HBAC_BIT_SET(compiled->unparseable, i);
+        }
+    }
+
+    /* A rule that turns out not to be indexable in a later element may
+     * already be indexed in an earlier one. That is harmless, uncompiled
+     * rules are always evaluated with hbac_evaluate_rule() */
+    for (type = HBAC_COMPILED_USERS; type < HBAC_COMPILED_SENTINEL; type++) {
+        ret = hbac_compile_element(compiled, type);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        hbac_free_compiled_rules(compiled);
+        return HBAC_ERROR_OUT_OF_MEMORY;
+    }
+
+    *_compiled = compiled;
+    return HBAC_SUCCESS;
+}
+
+void hbac_free_compiled_rules(struct hbac_compiled_rules *compiled)
+{
+    enum hbac_compiled_element_type type;
+
+    if (compiled == NULL) return;
+
+    for (type = HBAC_COMPILED_USERS; type < HBAC_COMPILED_SENTINEL; type++) {
+        free(compiled->elements[type].all);
+        hbac_index_free(&compiled->elements[type].names);
+        hbac_index_free(&compiled->elements[type].groups);
+    }
+
+    free(compiled->unparseable);
+    free(compiled->uncompiled);
+    free(compiled);
+}
+
+static errno_t hbac_index_match(struct hbac_index *index,
+                                const char *name,
+                                uint32_t *bits)
+{
+    struct hbac_index_entry *entry;
+    uint8_t *key;
+    errno_t ret;
+    size_t i;
+
+    ret = sss_utf8_case_key((const uint8_t *) name, &key);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    entry = hbac_index_lookup(index, key);
+    free(key);
+    if (entry == NULL) {
+        return EOK;
+    }
+
+    for (i = 0; i < entry->num_rules; i++) {
+        HBAC_BIT_SET(bits, entry->rules[i]);
+    }
+
+    return EOK;
+}
+
+/* Sets the bits of all rules whose element matches req_el */
+static errno_t hbac_compiled_element_match(struct hbac_compiled_rules *compiled,
+                                           enum hbac_compiled_element_type type,
+                                           struct hbac_request_element *req_el,
+                                           uint32_t *bits)
+{
+    struct hbac_compiled_element *cel;
+    errno_t ret;
+    size_t i;
+
+    cel = &compiled->elements[type];
+
+    memcpy(bits, cel->all, compiled->words * sizeof(uint32_t));
+
+    if (req_el == NULL) {
+        return EOK;
+    }
+
+    if (req_el->name != NULL) {
+        ret = hbac_index_match(&cel->names, req_el->name, bits);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    if (req_el->groups != NULL) {
+        for (i = 0; req_el->groups[i] != NULL; i++) {
+            ret = hbac_index_match(&cel->groups, req_el->groups[i], bits);
+            if (ret != EOK) {
+                return ret;
+            }
+        }
+    }
+
+    return EOK;
+}
+
+enum hbac_eval_result
+hbac_evaluate_compiled(struct hbac_compiled_rules *compiled,
+                       struct hbac_eval_req *hbac_req,
+                       struct hbac_info **info)
+{
+    enum hbac_compiled_element_type type;
+    enum hbac_eval_result result = HBAC_EVAL_DENY;
+    enum hbac_eval_result_int intermediate_result;
+    enum hbac_error_code code;
+    struct hbac_rule *rule;
+    uint32_t *candidates;
+    uint32_t *bits;
+    errno_t ret;
+    size_t i;
+
+    HBAC_DEBUG(HBAC_DBG_INFO, "[< hbac_evaluate_compiled()\n");
+
+    candidates = malloc(2 * compiled->words * sizeof(uint32_t));
+    if (candidates == NULL) {
+        HBAC_DEBUG(HBAC_DBG_ERROR, "Out of memory.\n");
+        return HBAC_EVAL_OOM;
+    }
+    bits = candidates + compiled->words;
+    memset(candidates, 0xff, compiled->words * sizeof(uint32_t));
+
+    for (type = HBAC_COMPILED_USERS; type < HBAC_COMPILED_SENTINEL; type++) {
+        ret = hbac_compiled_element_match(compiled, type,
+                                          hbac_req_get_element(hbac_req, type),
+                                          bits);
+        if (ret != EOK) {
+            /* The request cannot be looked up in the index, let the
+             * regular evaluator deal with it */
+            HBAC_DEBUG(HBAC_DBG_INFO,
+                       "Request names cannot be indexed [%d], falling back "
+                       "to full evaluation\n", ret);
+            free(candidates);
+            return hbac_evaluate(compiled->rules, hbac_req, info);
+        }
+
+        for (i = 0; i < compiled->words; i++) {
+            candidates[i] &= bits[i];
+        }
+    }
+
+    for (i = 0; i < compiled->words; i++) {
+        candidates[i] |= compiled->unparseable[i] | compiled->uncompiled[i];
+    }
+
+    hbac_req_debug_print(hbac_req);
+
+    if (info) {
+        *info = malloc(sizeof(struct hbac_info));
+        if (!*info) {
+            HBAC_DEBUG(HBAC_DBG_ERROR, "Out of memory.\n");
+            free(candidates);
+            return HBAC_EVAL_OOM;
+        }
+        (*info)->code = HBAC_ERROR_UNKNOWN;
+        (*info)->rule_name = NULL;
+    }
+
+    for (i = 0; i < compiled->num_rules; i++) {
+        if (candidates[i / HBAC_BITS_PER_WORD] == 0) {
+            /* skip the rest of an empty word */
+            i += HBAC_BITS_PER_WORD - 1 - (i % HBAC_BITS_PER_WORD);
+            continue;
+        }
+
+        if (!HBAC_BIT_IS_SET(candidates, i)) {
+            continue;
+        }
+
+        rule = compiled->rules[i];
+        hbac_rule_debug_print(rule);
+
+        if (HBAC_BIT_IS_SET(compiled->unparseable, i)) {
+            HBAC_DEBUG(HBAC_DBG_INFO,
+                       "Rule [%s] cannot be parsed, some elements are empty\n",
+                       rule->name);
+            intermediate_result = HBAC_EVAL_MATCH_ERROR;
+            code = HBAC_ERROR_UNPARSEABLE_RULE;
+        } else if (HBAC_BIT_IS_SET(compiled->uncompiled, i)) {
+            intermediate_result = hbac_evaluate_rule(rule, hbac_req, &code);
+        } else {
+            intermediate_result = HBAC_EVAL_MATCHED;
+        }
+
+        if (intermediate_result == HBAC_EVAL_UNMATCHED) {
+            HBAC_DEBUG(HBAC_DBG_INFO, "The rule [%s] did not match.\n",
+                       rule->name);
+            continue;
+        } else if (intermediate_result == HBAC_EVAL_MATCHED) {
+            HBAC_DEBUG(HBAC_DBG_INFO, "ALLOWED by rule [%s].\n", rule->name);
+            result = HBAC_EVAL_ALLOW;
+            if (info) {
+                (*info)->code = HBAC_SUCCESS;
+                (*info)->rule_name = strdup(rule->name);
+                if (!(*info)->rule_name) {
+                    HBAC_DEBUG(HBAC_DBG_ERROR, "Out of memory.\n");
+                    result = HBAC_EVAL_ERROR;
+                    (*info)->code = HBAC_ERROR_OUT_OF_MEMORY;
+                }
+            }
+            break;
+        } else {
+            HBAC_DEBUG(HBAC_DBG_ERROR,
+                       "Error %d occurred during evaluating of rule [%s].\n",
+                       code, rule->name);
+            result = HBAC_EVAL_ERROR;
+            if (info) {
+                (*info)->code = code;
+                (*info)->rule_name = strdup(rule->name);
+            }
+            break;
+        }
+    }
+
+    free(candidates);
+
+    HBAC_DEBUG(HBAC_DBG_INFO, "hbac_evaluate_compiled() >]\n");
+    return result;
+}
+
 const char *hbac_result_string(enum hbac_eval_result result)
 {
     switch (result) {
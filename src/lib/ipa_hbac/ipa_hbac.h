@@ -289,6 +289,60 @@ enum hbac_eval_result hbac_evaluate(struct hbac_rule **rules,
                                     struct hbac_eval_req *hbac_req,
                                     struct hbac_info **info);
 
+/**
+ * Opaque set of HBAC rules prepared for repeated evaluation
+ */
+struct hbac_compiled_rules;
+
+/**
+ * @brief Prepare a set of HBAC rules for repeated evaluation
+ *
+ * The rule names, group names and categories are indexed so that
+ * #hbac_evaluate_compiled only has to look at the rules that can
+ * possibly match a request instead of comparing every name of every
+ * rule.
+ *
+ * @param[in] rules     A NULL-terminated list of rules
+ * @param[out] compiled The compiled rule set, must be freed with
+ *                      #hbac_free_compiled_rules
+ * @return
+ *  - #HBAC_SUCCESS:              The rules were compiled
+ *  - #HBAC_ERROR_OUT_OF_MEMORY:  Insufficient memory
+ *  - #HBAC_ERROR_UNKNOWN:        Invalid arguments
+ *
+ * @note The compiled rule set references the rules passed in. They must
+ * neither be modified nor freed until the compiled rule set is freed.
+ */
+enum hbac_error_code hbac_rules_compile(struct hbac_rule **rules,
+                                        struct hbac_compiled_rules **compiled);
+
+/**
+ * @brief Evaluate an authorization request against a compiled rule set
+ *
+ * The result is the same as calling #hbac_evaluate with the rules the
+ * set was compiled from.
+ *
+ * @param[in] compiled A rule set returned by #hbac_rules_compile
+ * @param[in] hbac_req A user authorization request
+ * @param[out] info    Extended information (including the name of the
+ *                     rule that allowed access (or caused a parse error)
+ * @return
+ *  - #HBAC_EVAL_ERROR: An error occurred
+ *  - #HBAC_EVAL_ALLOW: Access is granted
+ *  - #HBAC_EVAL_DENY:  Access is denied
+ *  - #HBAC_EVAL_OOM:   Insufficient memory to complete the evaluation
+ */
+enum hbac_eval_result
+hbac_evaluate_compiled(struct hbac_compiled_rules *compiled,
+                       struct hbac_eval_req *hbac_req,
+                       struct hbac_info **info);
+
+/**
+ * @brief Function to safely free #hbac_compiled_rules
+ * @param compiled Rule set returned by #hbac_rules_compile
+ */
+void hbac_free_compiled_rules(struct hbac_compiled_rules *compiled);
+
 /**
  * @brief Display result of hbac evaluation in human-readable form
  * @param[in] result Return value of #hbac_evaluate
@@ -416,6 +416,28 @@ sss_sifp_free_attrs(sss_sifp_ctx *ctx,
     *_attrs = NULL;
 }
 
+void
+sss_sifp_free_attrs_array(sss_sifp_ctx *ctx,
+                          sss_sifp_attr ****_attrs_array)
+{
+    sss_sifp_attr ***attrs_array = NULL;
+    unsigned int i;
+
+    if (_attrs_array == NULL || *_attrs_array == NULL) {
+        return;
+    }
+
+    attrs_array = *_attrs_array;
+
+    for (i = 0; attrs_array[i] != NULL; i++) {
+        sss_sifp_free_attrs(ctx, &attrs_array[i]);
+    }
+
+    _free(ctx, attrs_array);
+
+    *_attrs_array = NULL;
+}
+
 void
 sss_sifp_free_object(sss_sifp_ctx *ctx,
                      sss_sifp_object **_object)
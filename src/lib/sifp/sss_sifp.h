@@ -472,6 +472,16 @@ void
 sss_sifp_free_attrs(sss_sifp_ctx *ctx,
                     sss_sifp_attr ***_attrs);
 
+/**
+ * @brief Free NULL-terminated array of attribute lists and set it to NULL.
+ *
+ * @param[in] ctx sss_sifp context
+ * @param[in,out] _attrs_array Array of attribute lists
+ */
+void
+sss_sifp_free_attrs_array(sss_sifp_ctx *ctx,
+                          sss_sifp_attr ****_attrs_array);
+
 /**
  * @brief Free sss_sifp object and set it to NULL.
  *
@@ -557,6 +567,44 @@ sss_sifp_fetch_user_by_name(sss_sifp_ctx *ctx,
                             const char *name,
                             sss_sifp_object **_user);
 
+/**
+ * @brief Fetch selected attributes of several users by name in one call.
+ *
+ * The result contains one attribute list for each name, in the same order
+ * as @names. A user that does not exist has an empty attribute list.
+ *
+ * @param[in] ctx     sss_sifp context
+ * @param[in] names   NULL-terminated list of user names
+ * @param[in] attrs   NULL-terminated list of attributes to fetch
+ * @param[out] _users NULL-terminated array of attribute lists, free it
+ *                    with sss_sifp_free_attrs_array()
+ */
+sss_sifp_error
+sss_sifp_fetch_users_attrs_by_name(sss_sifp_ctx *ctx,
+                                   const char **names,
+                                   const char **attrs,
+                                   sss_sifp_attr ****_users);
+
+/**
+ * @brief Fetch selected attributes of several users by uid in one call.
+ *
+ * The result contains one attribute list for each uid, in the same order
+ * as @uids. A user that does not exist has an empty attribute list.
+ *
+ * @param[in] ctx      sss_sifp context
+ * @param[in] uids     Array of user IDs
+ * @param[in] num_uids Number of user IDs in @uids
+ * @param[in] attrs    NULL-terminated list of attributes to fetch
+ * @param[out] _users  NULL-terminated array of attribute lists, free it
+ *                     with sss_sifp_free_attrs_array()
+ */
+sss_sifp_error
+sss_sifp_fetch_users_attrs_by_uid(sss_sifp_ctx *ctx,
+                                  const uid_t *uids,
+                                  unsigned int num_uids,
+                                  const char **attrs,
+                                  sss_sifp_attr ****_users);
+
 /**
  * @}
  */
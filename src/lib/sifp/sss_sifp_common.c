@@ -27,6 +27,10 @@
 
 #define SSS_SIFP_ATTR_NAME "name"
 
+/* Looking up many users may need several round trips to the data provider,
+ * use a longer timeout than for a single object. */
+#define SSS_SIFP_BULK_TIMEOUT 60000
+
 static sss_sifp_error
 sss_sifp_fetch_object_by_attr(sss_sifp_ctx *ctx,
                               const char *path,
@@ -181,3 +185,122 @@ sss_sifp_fetch_user_by_name(sss_sifp_ctx *ctx,
                                          "org.freedesktop.sssd.infopipe.Users.User", "ByName",
                                          name, _user);
 }
+
+static sss_sifp_error
+sss_sifp_fetch_users_attrs(sss_sifp_ctx *ctx,
+                           const char *method,
+                           int key_type,
+                           const void *keys,
+                           int num_keys,
+                           const char **attrs,
+                           sss_sifp_attr ****_users)
+{
+    static const char *no_attrs[] = { NULL };
+    DBusMessage *msg = NULL;
+    DBusMessage *reply = NULL;
+    dbus_bool_t bret;
+    sss_sifp_error ret;
+    int num_attrs;
+
+    if (ctx == NULL || _users == NULL || (keys == NULL && num_keys > 0)) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    if (attrs == NULL) {
+        attrs = no_attrs;
+    }
+
+    for (num_attrs = 0; attrs[num_attrs] != NULL; num_attrs++);
+
+    msg = sss_sifp_create_message(IFP_PATH_USERS,
+                                  "org.freedesktop.sssd.infopipe.Users",
+                                  method);
+    if (msg == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    bret = dbus_message_append_args(msg,
+                                    DBUS_TYPE_ARRAY, key_type, &keys, num_keys,
+                                    DBUS_TYPE_ARRAY, DBUS_TYPE_STRING,
+                                    &attrs, num_attrs,
+                                    DBUS_TYPE_INVALID);
+    if (!bret) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    ret = sss_sifp_send_message_ex(ctx, msg, SSS_SIFP_BULK_TIMEOUT, &reply);
+    if (ret != SSS_SIFP_OK) {
+        goto done;
+    }
+
+    ret = sss_sifp_parse_attr_list_array(ctx, reply, _users);
+
+done:
+    if (msg != NULL) {
+        dbus_message_unref(msg);
+    }
+
+    if (reply != NULL) {
+        dbus_message_unref(reply);
+    }
+
+    return ret;
+}
+
+sss_sifp_error
+sss_sifp_fetch_users_attrs_by_name(sss_sifp_ctx *ctx,
+                                   const char **names,
+                                   const char **attrs,
+                                   sss_sifp_attr ****_users)
+{
+    int num_names;
+
+    if (names == NULL) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    for (num_names = 0; names[num_names] != NULL; num_names++);
+
+    return sss_sifp_fetch_users_attrs(ctx, "GetAttrsByNameList",
+                                      DBUS_TYPE_STRING, names, num_names,
+                                      attrs, _users);
+}
+
+sss_sifp_error
+sss_sifp_fetch_users_attrs_by_uid(sss_sifp_ctx *ctx,
+                                  const uid_t *uids,
+                                  unsigned int num_uids,
+                                  const char **attrs,
+                                  sss_sifp_attr ****_users)
+{
+    dbus_uint32_t *ids = NULL;
+    sss_sifp_error ret;
+    unsigned int i;
+
+    if (ctx == NULL || (uids == NULL && num_uids > 0)) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    if (num_uids > 0) {
+        ids = _alloc_zero(ctx, dbus_uint32_t, num_uids);
+        if (ids == NULL) {
+            return SSS_SIFP_OUT_OF_MEMORY;
+        }
+
+        for (i = 0; i < num_uids; i++) {
+            ids[i] = uids[i];
+        }
+    }
+
+    ret = sss_sifp_fetch_users_attrs(ctx, "GetAttrsByIDList",
+                                     DBUS_TYPE_UINT32, ids, num_uids,
+                                     attrs, _users);
+
+    if (ids != NULL) {
+        _free(ctx, ids);
+    }
+
+    return ret;
+}
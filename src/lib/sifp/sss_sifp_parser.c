@@ -563,15 +563,16 @@ done:
 }
 
 /**
- * DBusMessage format:
+ * DBusMessageIter format:
  * array of dict_entry(string:attr_name, variant:value)
+ *
+ * Iterator has to point to the array but not inside the array.
  */
-sss_sifp_error
-sss_sifp_parse_attr_list(sss_sifp_ctx *ctx,
-                         DBusMessage *msg,
+static sss_sifp_error
+sss_sifp_parse_attr_dict(sss_sifp_ctx *ctx,
+                         DBusMessageIter *iter,
                          sss_sifp_attr ***_attrs)
 {
-    DBusMessageIter iter;
     DBusMessageIter array_iter;
     DBusMessageIter dict_iter;
     sss_sifp_attr **attrs = NULL;
@@ -580,23 +581,21 @@ sss_sifp_parse_attr_list(sss_sifp_ctx *ctx,
     sss_sifp_error ret;
     unsigned int i;
 
-    dbus_message_iter_init(msg, &iter);
-
-    check_dbus_arg(&iter, DBUS_TYPE_ARRAY, ret, done);
+    check_dbus_arg(iter, DBUS_TYPE_ARRAY, ret, done);
 
-    if (dbus_message_iter_get_element_type(&iter) != DBUS_TYPE_DICT_ENTRY) {
+    if (dbus_message_iter_get_element_type(iter) != DBUS_TYPE_DICT_ENTRY) {
         ret = SSS_SIFP_INTERNAL_ERROR;
         goto done;
     }
 
-    num_values = sss_sifp_get_array_length(&iter);
+    num_values = sss_sifp_get_array_length(iter);
     attrs = _alloc_zero(ctx, sss_sifp_attr *, num_values + 1);
     if (attrs == NULL) {
         ret = SSS_SIFP_OUT_OF_MEMORY;
         goto done;
     }
 
-    dbus_message_iter_recurse(&iter, &array_iter);
+    dbus_message_iter_recurse(iter, &array_iter);
 
     for (i = 0; i < num_values; i++) {
         dbus_message_iter_recurse(&array_iter, &dict_iter);
@@ -632,6 +631,76 @@ done:
     return ret;
 }
 
+/**
+ * DBusMessage format:
+ * array of dict_entry(string:attr_name, variant:value)
+ */
+sss_sifp_error
+sss_sifp_parse_attr_list(sss_sifp_ctx *ctx,
+                         DBusMessage *msg,
+                         sss_sifp_attr ***_attrs)
+{
+    DBusMessageIter iter;
+
+    dbus_message_iter_init(msg, &iter);
+
+    return sss_sifp_parse_attr_dict(ctx, &iter, _attrs);
+}
+
+/**
+ * DBusMessage format:
+ * array of array of dict_entry(string:attr_name, variant:value)
+ */
+sss_sifp_error
+sss_sifp_parse_attr_list_array(sss_sifp_ctx *ctx,
+                               DBusMessage *msg,
+                               sss_sifp_attr ****_attrs_array)
+{
+    DBusMessageIter iter;
+    DBusMessageIter array_iter;
+    sss_sifp_attr ***attrs_array = NULL;
+    unsigned int num_values;
+    sss_sifp_error ret;
+    unsigned int i;
+
+    dbus_message_iter_init(msg, &iter);
+
+    check_dbus_arg(&iter, DBUS_TYPE_ARRAY, ret, done);
+
+    if (dbus_message_iter_get_element_type(&iter) != DBUS_TYPE_ARRAY) {
+        ret = SSS_SIFP_INTERNAL_ERROR;
+        goto done;
+    }
+
+    num_values = sss_sifp_get_array_length(&iter);
+    attrs_array = _alloc_zero(ctx, sss_sifp_attr **, num_values + 1);
+    if (attrs_array == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    dbus_message_iter_recurse(&iter, &array_iter);
+
+    for (i = 0; i < num_values; i++) {
+        ret = sss_sifp_parse_attr_dict(ctx, &array_iter, &attrs_array[i]);
+        if (ret != SSS_SIFP_OK) {
+            goto done;
+        }
+
+        dbus_message_iter_next(&array_iter);
+    }
+
+    *_attrs_array = attrs_array;
+    ret = SSS_SIFP_OK;
+
+done:
+    if (ret != SSS_SIFP_OK) {
+        sss_sifp_free_attrs_array(ctx, &attrs_array);
+    }
+
+    return ret;
+}
+
 sss_sifp_error
 sss_sifp_parse_object_path(sss_sifp_ctx *ctx,
                            DBusMessage *msg,
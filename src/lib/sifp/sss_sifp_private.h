@@ -99,6 +99,11 @@ sss_sifp_parse_attr_list(sss_sifp_ctx *ctx,
                          DBusMessage *msg,
                          sss_sifp_attr ***_attrs);
 
+sss_sifp_error
+sss_sifp_parse_attr_list_array(sss_sifp_ctx *ctx,
+                               DBusMessage *msg,
+                               sss_sifp_attr ****_attrs_array);
+
 sss_sifp_error
 sss_sifp_parse_object_path(sss_sifp_ctx *ctx,
                            DBusMessage *msg,
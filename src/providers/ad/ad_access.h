@@ -25,6 +25,8 @@
 
 #include "providers/data_provider.h"
 
+struct ad_gpo_host_cache;
+
 struct ad_access_ctx {
     struct dp_option *ad_options;
     struct sdap_access_ctx *sdap_access_ctx;
@@ -49,6 +51,11 @@ struct ad_access_ctx {
     } gpo_map_type;
     hash_table_t *gpo_map_options_table;
     enum gpo_map_type gpo_default_right;
+    /* GPO evaluation cache, see ad_gpo.c */
+    struct ad_gpo_host_cache *gpo_host_cache;
+    char *gpo_result_key;
+    time_t gpo_result_expire;
+    uint32_t gpo_result_serial;
 };
 
 struct tevent_req *
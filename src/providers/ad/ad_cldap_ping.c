@@ -740,3 +740,113 @@ errno_t ad_cldap_ping_recv(TALLOC_CTX *mem_ctx,
 
     return EOK;
 }
+
+struct ad_cldap_fo_probe_state {
+    struct be_ctx *be_ctx;
+    const char *service_name;
+    struct fo_server *server;
+    struct timeval op_start;
+};
+
+static void ad_cldap_fo_probe_done(struct tevent_req *subreq);
+
+struct tevent_req *ad_cldap_fo_probe_send(TALLOC_CTX *mem_ctx,
+                                          struct tevent_context *ev,
+                                          struct be_ctx *be_ctx,
+                                          const char *service_name,
+                                          struct fo_server *server,
+                                          void *pvt)
+{
+    struct ad_cldap_fo_probe_state *state;
+    struct fo_server_info *dc;
+    struct ad_id_ctx *ad_id_ctx;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    const char *ad_domain;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct ad_cldap_fo_probe_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    ad_id_ctx = talloc_get_type(pvt, struct ad_id_ctx);
+    if (ad_id_ctx == NULL || ad_id_ctx->sdap_id_ctx->opts == NULL) {
+        ret = EINVAL;
+        goto done;
+    }
+
+    state->be_ctx = be_ctx;
+    state->server = server;
+    state->service_name = talloc_strdup(state, service_name);
+    dc = talloc_zero(state, struct fo_server_info);
+    if (state->service_name == NULL || dc == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    dc->host = talloc_strdup(dc, fo_get_server_name(server));
+    if (dc->host == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* CLDAP is always served on the LDAP port, even for Global Catalog */
+    dc->port = LDAP_PORT;
+
+    ad_domain = dp_opt_get_string(ad_id_ctx->ad_options->basic, AD_DOMAIN);
+
+    state->op_start = tevent_timeval_current();
+    subreq = ad_cldap_ping_dc_send(state, ev, ad_id_ctx->sdap_id_ctx->opts,
+                                   be_ctx->be_res, default_host_dbs, dc,
+                                   ad_domain);
+    if (subreq == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    tevent_req_set_callback(subreq, ad_cldap_fo_probe_done, req);
+
+    return req;
+
+done:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static void ad_cldap_fo_probe_done(struct tevent_req *subreq)
+{
+    struct ad_cldap_fo_probe_state *state;
+    struct tevent_req *req;
+    const char *site;
+    const char *forest;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct ad_cldap_fo_probe_state);
+
+    ret = ad_cldap_ping_dc_recv(state, subreq, &site, &forest);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    /* CLDAP is connectionless so the whole round trip is the response */
+    be_fo_set_server_latency(state->be_ctx, state->service_name,
+                             state->server, FO_LATENCY_RESPONSE,
+                             state->op_start);
+
+    tevent_req_done(req);
+}
+
+errno_t ad_cldap_fo_probe_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
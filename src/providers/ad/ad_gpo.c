@@ -1012,9 +1012,10 @@ static errno_t ad_gpo_evaluate_dacl(struct security_acl *dacl,
  */
 static errno_t
 ad_gpo_filter_gpos_by_dacl(TALLOC_CTX *mem_ctx,
-                           const char *user,
+                           const char *user_sid,
                            const char *host_sid,
-                           struct sss_domain_info *domain,
+                           const char **group_sids,
+                           int group_size,
                            struct sss_idmap_ctx *idmap_ctx,
                            struct gp_gpo **candidate_gpos,
                            int num_candidate_gpos,
@@ -1027,9 +1028,6 @@ ad_gpo_filter_gpos_by_dacl(TALLOC_CTX *mem_ctx,
     struct gp_gpo *candidate_gpo = NULL;
     struct security_descriptor *sd = NULL;
     struct security_acl *dacl = NULL;
-    const char *user_sid = NULL;
-    const char **group_sids = NULL;
-    int group_size = 0;
     int gpo_dn_idx = 0;
     bool access_allowed = false;
     struct gp_gpo **dacl_filtered_gpos = NULL;
@@ -1040,15 +1038,6 @@ ad_gpo_filter_gpos_by_dacl(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
-    ret = ad_gpo_get_sids(tmp_ctx, user, domain, &user_sid,
-                          &group_sids, &group_size);
-    if (ret != EOK) {
-        ret = ERR_NO_SIDS;
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Unable to retrieve SIDs: [%d](%s)\n", ret, sss_strerror(ret));
-        goto done;
-    }
-
     dacl_filtered_gpos = talloc_array(tmp_ctx,
                                  struct gp_gpo *,
                                  num_candidate_gpos + 1);
@@ -1113,8 +1102,7 @@ ad_gpo_filter_gpos_by_dacl(TALLOC_CTX *mem_ctx,
         if (access_allowed) {
             DEBUG(SSSDBG_TRACE_FUNC,
                   "GPO applicable to target per security filtering\n");
-            dacl_filtered_gpos[gpo_dn_idx] = talloc_steal(dacl_filtered_gpos,
-                                                          candidate_gpo);
+            dacl_filtered_gpos[gpo_dn_idx] = candidate_gpo;
             gpo_dn_idx++;
         } else {
             DEBUG(SSSDBG_TRACE_FUNC,
@@ -1207,9 +1195,7 @@ ad_gpo_filter_gpos_by_cse_guid(TALLOC_CTX *mem_ctx,
         if (included) {
             DEBUG(SSSDBG_TRACE_ALL,
                   "GPO applicable to target per cse_guid filtering\n");
-            cse_filtered_gpos[gpo_dn_idx] = talloc_steal(cse_filtered_gpos,
-                                                         dacl_filtered_gpo);
-            dacl_filtered_gpos[i] = NULL;
+            cse_filtered_gpos[gpo_dn_idx] = dacl_filtered_gpo;
             gpo_dn_idx++;
         } else {
             DEBUG(SSSDBG_TRACE_ALL,
@@ -1754,6 +1740,396 @@ ad_gpo_perform_hbac_processing(TALLOC_CTX *mem_ctx,
     return ret;
 }
 
+/* == GPO evaluation cache ================================================= */
+
+/*
+ * The list of GPOs linked to the SOMs of the host, together with the
+ * attributes of these GPOs, does not depend on the user. It is kept for
+ * ad_gpo_cache_timeout seconds so that access checks within this interval
+ * do not have to repeat the LDAP lookups. Every request holds a talloc
+ * reference to the entry it works with, so an entry that is replaced while
+ * the request is running stays valid until the request finishes.
+ *
+ * The result of the DACL filtering only depends on which of the client's
+ * SIDs appear as trustees in the DACLs of the candidate GPOs. The results
+ * are therefore cached per set of matching SIDs, which is usually shared by
+ * many users.
+ */
+struct ad_gpo_host_cache {
+    time_t expire;
+    const char *host_sid;
+    struct gp_gpo **candidate_gpos;
+    int num_candidate_gpos;
+    /* SIDs of all ACE trustees of the candidate GPOs, NULL if unknown */
+    hash_table_t *trustees;
+    /* set of matching SIDs -> struct ad_gpo_dacl_result */
+    hash_table_t *dacl_results;
+};
+
+struct ad_gpo_dacl_result {
+    struct gp_gpo **dacl_filtered_gpos;
+    int num_dacl_filtered_gpos;
+};
+
+/*
+ * This function collects the SIDs of the trustees of all ACEs in the DACLs
+ * of the input candidate_gpos into the _trustees table.
+ */
+static errno_t
+ad_gpo_collect_trustees(TALLOC_CTX *mem_ctx,
+                        struct sss_idmap_ctx *idmap_ctx,
+                        struct gp_gpo **candidate_gpos,
+                        int num_candidate_gpos,
+                        hash_table_t **_trustees)
+{
+    hash_table_t *trustees = NULL;
+    struct security_acl *dacl;
+    enum idmap_error_code err;
+    char *sid_str;
+    hash_key_t key;
+    hash_value_t value;
+    uint32_t j;
+    int hret;
+    int i;
+    errno_t ret;
+
+    ret = sss_hash_create(mem_ctx, 0, &trustees);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    key.type = HASH_KEY_STRING;
+    value.type = HASH_VALUE_UNDEF;
+
+    for (i = 0; i < num_candidate_gpos; i++) {
+        if (candidate_gpos[i]->gpo_sd == NULL
+                || candidate_gpos[i]->gpo_sd->dacl == NULL) {
+            continue;
+        }
+
+        dacl = candidate_gpos[i]->gpo_sd->dacl;
+        for (j = 0; j < dacl->num_aces; j++) {
+            err = sss_idmap_smb_sid_to_sid(idmap_ctx, &dacl->aces[j].trustee,
+                                           &sid_str);
+            if (err != IDMAP_SUCCESS) {
+                DEBUG(SSSDBG_MINOR_FAILURE,
+                      "sss_idmap_smb_sid_to_sid failed for a trustee of "
+                      "GPO [%s].\n", candidate_gpos[i]->gpo_dn);
+                ret = EINVAL;
+                goto done;
+            }
+
+            key.str = sid_str;
+            hret = hash_enter(trustees, &key, &value);
+            sss_idmap_free_sid(idmap_ctx, sid_str);
+            if (hret != HASH_SUCCESS) {
+                DEBUG(SSSDBG_OP_FAILURE, "Unable to add trustee: [%s]\n",
+                      hash_error_string(hret));
+                ret = EIO;
+                goto done;
+            }
+        }
+    }
+
+    *_trustees = trustees;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(trustees);
+    }
+
+    return ret;
+}
+
+/*
+ * This function creates a cache entry for the candidate_gpos of the host.
+ * The candidate_gpos are stolen by the new entry.
+ */
+static errno_t
+ad_gpo_host_cache_new(TALLOC_CTX *mem_ctx,
+                      struct sss_idmap_ctx *idmap_ctx,
+                      const char *host_sid,
+                      struct gp_gpo **candidate_gpos,
+                      int num_candidate_gpos,
+                      int timeout,
+                      struct ad_gpo_host_cache **_cache)
+{
+    struct ad_gpo_host_cache *cache;
+    errno_t ret;
+
+    cache = talloc_zero(mem_ctx, struct ad_gpo_host_cache);
+    if (cache == NULL) {
+        return ENOMEM;
+    }
+
+    cache->expire = time(NULL) + timeout;
+    cache->candidate_gpos = talloc_steal(cache, candidate_gpos);
+    cache->num_candidate_gpos = num_candidate_gpos;
+
+    cache->host_sid = talloc_strdup(cache, host_sid);
+    if (cache->host_sid == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_hash_create(cache, 0, &cache->dacl_results);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = ad_gpo_collect_trustees(cache, idmap_ctx, candidate_gpos,
+                                  num_candidate_gpos, &cache->trustees);
+    if (ret == EINVAL) {
+        /* the DACL filtering can still be done, just not cached */
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "DACL filtering results will not be cached.\n");
+        cache->trustees = NULL;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    *_cache = cache;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(cache);
+    }
+
+    return ret;
+}
+
+static int
+ad_gpo_sid_cmp(const void *a, const void *b)
+{
+    return strcmp(*(const char * const *) a, *(const char * const *) b);
+}
+
+/*
+ * This function builds the key under which the result of the DACL filtering
+ * is cached: the client SIDs that appear in the input trustees table, sorted
+ * and separated by ','. Client SIDs that no ACE refers to can not influence
+ * the result and are left out. EINVAL is returned if any of the client SIDs
+ * is not a valid SID, since the DACL evaluation fails in that case.
+ */
+static errno_t
+ad_gpo_dacl_key(TALLOC_CTX *mem_ctx,
+                hash_table_t *trustees,
+                struct sss_idmap_ctx *idmap_ctx,
+                const char *user_sid,
+                const char *host_sid,
+                const char **group_sids,
+                int group_size,
+                char **_key)
+{
+    TALLOC_CTX *tmp_ctx;
+    const char **client_sids;
+    const char **matched;
+    struct dom_sid *dom_sid;
+    enum idmap_error_code err;
+    char *sid_str;
+    char *copy = NULL;
+    char *sid_set;
+    hash_key_t key;
+    bool found;
+    int num_client_sids;
+    int num_matched = 0;
+    int i;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    num_client_sids = group_size + 2;
+    client_sids = talloc_array(tmp_ctx, const char *, num_client_sids);
+    matched = talloc_array(tmp_ctx, const char *, num_client_sids);
+    if (client_sids == NULL || matched == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    client_sids[0] = user_sid;
+    client_sids[1] = host_sid;
+    for (i = 0; i < group_size; i++) {
+        client_sids[i + 2] = group_sids[i];
+    }
+
+    key.type = HASH_KEY_STRING;
+    for (i = 0; i < num_client_sids; i++) {
+        /* compare the SIDs in the same format as the trustees */
+        err = sss_idmap_sid_to_smb_sid(idmap_ctx, client_sids[i], &dom_sid);
+        if (err != IDMAP_SUCCESS) {
+            ret = EINVAL;
+            goto done;
+        }
+
+        err = sss_idmap_smb_sid_to_sid(idmap_ctx, dom_sid, &sid_str);
+        sss_idmap_free_smb_sid(idmap_ctx, dom_sid);
+        if (err != IDMAP_SUCCESS) {
+            ret = EINVAL;
+            goto done;
+        }
+
+        key.str = sid_str;
+        found = hash_has_key(trustees, &key);
+        if (found) {
+            copy = talloc_strdup(matched, sid_str);
+        }
+        sss_idmap_free_sid(idmap_ctx, sid_str);
+
+        if (found) {
+            if (copy == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+            matched[num_matched] = copy;
+            num_matched++;
+        }
+    }
+
+    qsort(matched, num_matched, sizeof(const char *), ad_gpo_sid_cmp);
+
+    sid_set = talloc_strdup(tmp_ctx, "");
+    for (i = 0; i < num_matched && sid_set != NULL; i++) {
+        if (i > 0 && strcmp(matched[i - 1], matched[i]) == 0) {
+            continue;
+        }
+
+        sid_set = talloc_asprintf_append(sid_set, "%s%s",
+                                         sid_set[0] == '\0' ? "" : ",",
+                                         matched[i]);
+    }
+    if (sid_set == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    *_key = talloc_steal(mem_ctx, sid_set);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/*
+ * This function returns the candidate GPOs of the cache entry that are
+ * applicable to the client, either from the cached DACL filtering results
+ * or by running ad_gpo_filter_gpos_by_dacl() and caching its result.
+ */
+static errno_t
+ad_gpo_host_cache_filter_by_dacl(TALLOC_CTX *mem_ctx,
+                                 struct ad_gpo_host_cache *cache,
+                                 struct sss_idmap_ctx *idmap_ctx,
+                                 const char *user_sid,
+                                 const char **group_sids,
+                                 int group_size,
+                                 struct gp_gpo ***_dacl_filtered_gpos,
+                                 int *_num_dacl_filtered_gpos)
+{
+    struct ad_gpo_dacl_result *result;
+    char *sid_set = NULL;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+    errno_t ret;
+
+    if (cache->trustees != NULL) {
+        ret = ad_gpo_dacl_key(mem_ctx, cache->trustees, idmap_ctx, user_sid,
+                              cache->host_sid, group_sids, group_size,
+                              &sid_set);
+        if (ret != EOK && ret != EINVAL) {
+            return ret;
+        }
+    }
+
+    if (sid_set == NULL) {
+        return ad_gpo_filter_gpos_by_dacl(mem_ctx, user_sid, cache->host_sid,
+                                          group_sids, group_size, idmap_ctx,
+                                          cache->candidate_gpos,
+                                          cache->num_candidate_gpos,
+                                          _dacl_filtered_gpos,
+                                          _num_dacl_filtered_gpos);
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = sid_set;
+
+    hret = hash_lookup(cache->dacl_results, &key, &value);
+    if (hret == HASH_SUCCESS) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "Using cached DACL filtering result for SIDs [%s]\n", sid_set);
+        result = talloc_get_type(value.ptr, struct ad_gpo_dacl_result);
+        *_dacl_filtered_gpos = result->dacl_filtered_gpos;
+        *_num_dacl_filtered_gpos = result->num_dacl_filtered_gpos;
+        ret = EOK;
+        goto done;
+    } else if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+        DEBUG(SSSDBG_OP_FAILURE, "Error checking hash table: [%s]\n",
+              hash_error_string(hret));
+        ret = EIO;
+        goto done;
+    }
+
+    result = talloc_zero(cache, struct ad_gpo_dacl_result);
+    if (result == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = ad_gpo_filter_gpos_by_dacl(result, user_sid, cache->host_sid,
+                                     group_sids, group_size, idmap_ctx,
+                                     cache->candidate_gpos,
+                                     cache->num_candidate_gpos,
+                                     &result->dacl_filtered_gpos,
+                                     &result->num_dacl_filtered_gpos);
+    if (ret != EOK) {
+        talloc_free(result);
+        goto done;
+    }
+
+    value.type = HASH_VALUE_PTR;
+    value.ptr = result;
+    hret = hash_enter(cache->dacl_results, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        /* not fatal, the result is just not reused */
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to cache DACL filtering "
+              "result: [%s]\n", hash_error_string(hret));
+    }
+
+    *_dacl_filtered_gpos = result->dacl_filtered_gpos;
+    *_num_dacl_filtered_gpos = result->num_dacl_filtered_gpos;
+    ret = EOK;
+
+done:
+    talloc_free(sid_set);
+    return ret;
+}
+
+/*
+ * This function returns the key of the GPO Result object built from the
+ * input list of GPOs: their GUIDs in the order of application.
+ */
+static char *
+ad_gpo_result_key(TALLOC_CTX *mem_ctx,
+                  struct gp_gpo **gpos,
+                  int num_gpos)
+{
+    char *key;
+    int i;
+
+    key = talloc_strdup(mem_ctx, "");
+    for (i = 0; i < num_gpos && key != NULL; i++) {
+        key = talloc_asprintf_append(key, "%s%s", i == 0 ? "" : ",",
+                                     gpos[i]->gpo_guid);
+    }
+
+    return key;
+}
+
 /* == ad_gpo_access_send/recv implementation ================================*/
 
 struct ad_gpo_access_state {
@@ -1775,18 +2151,22 @@ struct ad_gpo_access_state {
     const char *ad_hostname;
     const char *host_sid;
     const char *target_dn;
+    struct ad_gpo_host_cache *host_cache;
     struct gp_gpo **dacl_filtered_gpos;
     int num_dacl_filtered_gpos;
     struct gp_gpo **cse_filtered_gpos;
     int num_cse_filtered_gpos;
     int cse_gpo_index;
     const char *ad_domain;
+    char *gpo_result_key;
+    uint32_t gpo_result_serial;
 };
 
 static void ad_gpo_connect_done(struct tevent_req *subreq);
 static void ad_gpo_target_dn_retrieval_done(struct tevent_req *subreq);
 static void ad_gpo_process_som_done(struct tevent_req *subreq);
 static void ad_gpo_process_gpo_done(struct tevent_req *subreq);
+static errno_t ad_gpo_evaluate_gpos(struct tevent_req *req);
 
 static errno_t ad_gpo_cse_step(struct tevent_req *req);
 static void ad_gpo_cse_done(struct tevent_req *subreq);
@@ -1896,6 +2276,24 @@ ad_gpo_access_send(TALLOC_CTX *mem_ctx,
     state->opts = ctx->sdap_access_ctx->id_ctx->opts;
     state->timeout = dp_opt_get_int(state->opts->basic, SDAP_SEARCH_TIMEOUT);
     state->conn = ad_get_dom_ldap_conn(ctx->ad_id_ctx, state->host_domain);
+
+    if (ctx->gpo_host_cache != NULL
+            && ctx->gpo_host_cache->expire >= time(NULL)) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Using cached list of GPOs of this host\n");
+        state->host_cache = talloc_reference(state, ctx->gpo_host_cache);
+        if (state->host_cache == NULL) {
+            ret = ENOMEM;
+            goto immediately;
+        }
+        state->host_sid = state->host_cache->host_sid;
+
+        ret = ad_gpo_evaluate_gpos(req);
+        if (ret == EAGAIN) {
+            return req;
+        }
+        goto immediately;
+    }
+
     state->sdap_op = sdap_id_op_create(state, state->conn->conn_cache);
     if (state->sdap_op == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "sdap_id_op_create failed.\n");
@@ -1903,7 +2301,6 @@ ad_gpo_access_send(TALLOC_CTX *mem_ctx,
         goto immediately;
     }
 
-
     subreq = sdap_id_op_connect_send(state->sdap_op, state, &ret);
     if (subreq == NULL) {
         DEBUG(SSSDBG_OP_FAILURE,
@@ -2414,31 +2811,57 @@ ad_gpo_process_som_done(struct tevent_req *subreq)
 }
 
 /*
- * This function retrieves a list of candidate_gpos and potentially reduces it
- * to a list of dacl_filtered_gpos, based on each GPO's DACL.
- *
- * This function then takes the list of dacl_filtered_gpos and potentially
- * reduces it to a list of cse_filtered_gpos, based on whether each GPO's list
- * of cse_guids includes the "SecuritySettings" CSE GUID (used for HBAC).
- *
- * Ultimately, this function then sends each cse_filtered_gpo to the gpo_child,
- * which retrieves the GPT.INI and policy files (as needed). Once all files
- * have been downloaded, the ad_gpo_cse_done function performs HBAC processing.
+ * This function deletes the GPO Result object from the sysdb cache, so that
+ * any previous policy settings are cleared, and invalidates the key of the
+ * GPO Result object that was built by the last evaluation.
+ */
+static errno_t
+ad_gpo_reset_gpo_result(struct ad_gpo_access_state *state)
+{
+    struct ad_access_ctx *access_ctx = state->access_ctx;
+    errno_t ret;
+
+    talloc_zfree(access_ctx->gpo_result_key);
+    access_ctx->gpo_result_serial++;
+    state->gpo_result_serial = access_ctx->gpo_result_serial;
+
+    ret = sysdb_gpo_delete_gpo_result_object(state, state->host_domain);
+    if (ret != EOK) {
+        switch (ret) {
+        case ENOENT:
+            DEBUG(SSSDBG_TRACE_FUNC, "No GPO Result available in cache\n");
+            break;
+        default:
+            DEBUG(SSSDBG_FATAL_FAILURE,
+                  "Could not delete GPO Result from cache: [%s]\n",
+                  sss_strerror(ret));
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
+/*
+ * This function retrieves a list of candidate_gpos and stores it in the
+ * GPO evaluation cache of the host, before ad_gpo_evaluate_gpos() evaluates
+ * it for the user.
  */
 static void
 ad_gpo_process_gpo_done(struct tevent_req *subreq)
 {
     struct tevent_req *req;
     struct ad_gpo_access_state *state;
+    struct ad_access_ctx *access_ctx;
+    struct ad_gpo_host_cache *cache;
     int ret;
     int dp_error;
     struct gp_gpo **candidate_gpos = NULL;
     int num_candidate_gpos = 0;
-    int i = 0;
-    const char **cse_filtered_gpo_guids;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
     state = tevent_req_data(req, struct ad_gpo_access_state);
+    access_ctx = state->access_ctx;
     ret = ad_gpo_process_gpo_recv(subreq, state, &candidate_gpos,
                                   &num_candidate_gpos);
 
@@ -2458,18 +2881,9 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
          * Delete the result object list, since there are no
          * GPOs to include in it.
          */
-        ret = sysdb_gpo_delete_gpo_result_object(state, state->host_domain);
+        ret = ad_gpo_reset_gpo_result(state);
         if (ret != EOK) {
-            switch (ret) {
-            case ENOENT:
-                DEBUG(SSSDBG_TRACE_FUNC, "No GPO Result available in cache\n");
-                break;
-            default:
-                DEBUG(SSSDBG_FATAL_FAILURE,
-                      "Could not delete GPO Result from cache: [%s]\n",
-                      sss_strerror(ret));
-                goto done;
-            }
+            goto done;
         }
 
         if (state->gpo_implicit_deny == true) {
@@ -2481,20 +2895,95 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
             ret = EOK;
         }
 
-        goto done;
+        goto done;
+    }
+
+    ret = ad_gpo_host_cache_new(access_ctx, state->opts->idmap_ctx->map,
+                                state->host_sid, candidate_gpos,
+                                num_candidate_gpos, state->gpo_timeout_option,
+                                &cache);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Unable to create GPO cache entry: [%d](%s)\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    if (state->gpo_timeout_option > 0) {
+        state->host_cache = talloc_reference(state, cache);
+        if (state->host_cache == NULL) {
+            talloc_free(cache);
+            ret = ENOMEM;
+            goto done;
+        }
+
+        /* requests still using the old entry keep it alive */
+        if (access_ctx->gpo_host_cache != NULL) {
+            talloc_unlink(access_ctx, access_ctx->gpo_host_cache);
+        }
+        access_ctx->gpo_host_cache = cache;
+    } else {
+        state->host_cache = talloc_steal(state, cache);
+    }
+
+    ret = ad_gpo_evaluate_gpos(req);
+
+ done:
+
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+/*
+ * This function potentially reduces the candidate_gpos of the host to a list
+ * of dacl_filtered_gpos, based on each GPO's DACL.
+ *
+ * This function then takes the list of dacl_filtered_gpos and potentially
+ * reduces it to a list of cse_filtered_gpos, based on whether each GPO's list
+ * of cse_guids includes the "SecuritySettings" CSE GUID (used for HBAC).
+ *
+ * Ultimately, this function then sends each cse_filtered_gpo to the gpo_child,
+ * which retrieves the GPT.INI and policy files (as needed). Once all files
+ * have been downloaded, the ad_gpo_cse_done function performs HBAC processing.
+ * If the GPO Result object was built from the same cse_filtered_gpos less
+ * than ad_gpo_cache_timeout seconds ago, HBAC processing is done right away.
+ */
+static errno_t
+ad_gpo_evaluate_gpos(struct tevent_req *req)
+{
+    struct ad_gpo_access_state *state;
+    struct ad_access_ctx *access_ctx;
+    const char *user_sid = NULL;
+    const char **group_sids = NULL;
+    int group_size = 0;
+    int i = 0;
+    int ret;
+
+    state = tevent_req_data(req, struct ad_gpo_access_state);
+    access_ctx = state->access_ctx;
+
+    ret = ad_gpo_get_sids(state, state->user, state->user_domain, &user_sid,
+                          &group_sids, &group_size);
+    if (ret != EOK) {
+        ret = ERR_NO_SIDS;
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Unable to retrieve SIDs: [%d](%s)\n", ret, sss_strerror(ret));
+        return ret;
     }
 
-    ret = ad_gpo_filter_gpos_by_dacl(state, state->user, state->host_sid,
-                                     state->user_domain,
-                                     state->opts->idmap_ctx->map,
-                                     candidate_gpos, num_candidate_gpos,
-                                     &state->dacl_filtered_gpos,
-                                     &state->num_dacl_filtered_gpos);
+    ret = ad_gpo_host_cache_filter_by_dacl(state, state->host_cache,
+                                           state->opts->idmap_ctx->map,
+                                           user_sid, group_sids, group_size,
+                                           &state->dacl_filtered_gpos,
+                                           &state->num_dacl_filtered_gpos);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "Unable to filter GPO list by DACL: [%d](%s)\n",
               ret, sss_strerror(ret));
-        goto done;
+        return ret;
     }
 
     if (state->dacl_filtered_gpos[0] == NULL) {
@@ -2506,30 +2995,19 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
          * Delete the result object list, since there are no
          * GPOs to include in it.
          */
-        ret = sysdb_gpo_delete_gpo_result_object(state, state->host_domain);
+        ret = ad_gpo_reset_gpo_result(state);
         if (ret != EOK) {
-            switch (ret) {
-            case ENOENT:
-                DEBUG(SSSDBG_TRACE_FUNC, "No GPO Result available in cache\n");
-                break;
-            default:
-                DEBUG(SSSDBG_FATAL_FAILURE,
-                      "Could not delete GPO Result from cache: [%s]\n",
-                      sss_strerror(ret));
-                goto done;
-            }
+            return ret;
         }
 
         if (state->gpo_implicit_deny == true) {
             DEBUG(SSSDBG_TRACE_FUNC,
                   "No applicable GPOs have been found and ad_gpo_implicit_deny"
                   " is set to 'true'. The user will be denied access.\n");
-            ret = ERR_ACCESS_DENIED;
-        } else {
-            ret = EOK;
+            return ERR_ACCESS_DENIED;
         }
 
-        goto done;
+        return EOK;
     }
 
     for (i = 0; i < state->num_dacl_filtered_gpos; i++) {
@@ -2548,7 +3026,7 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
         DEBUG(SSSDBG_OP_FAILURE,
               "Unable to filter GPO list by CSE_GUID: [%d](%s)\n",
                ret, sss_strerror(ret));
-        goto done;
+        return ret;
     }
 
     if (state->cse_filtered_gpos[0] == NULL) {
@@ -2560,65 +3038,59 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
             DEBUG(SSSDBG_TRACE_FUNC,
                   "No applicable GPOs have been found and ad_gpo_implicit_deny"
                   " is set to 'true'. The user will be denied access.\n");
-            ret = ERR_ACCESS_DENIED;
-        } else {
-            ret = EOK;
+            return ERR_ACCESS_DENIED;
         }
 
-        goto done;
-    }
-
-    /* we create and populate an array of applicable gpo-guids */
-    cse_filtered_gpo_guids =
-        talloc_array(state, const char *, state->num_cse_filtered_gpos);
-    if (cse_filtered_gpo_guids == NULL) {
-        ret = ENOMEM;
-        goto done;
+        return EOK;
     }
 
     for (i = 0; i < state->num_cse_filtered_gpos; i++) {
         DEBUG(SSSDBG_TRACE_FUNC, "cse_filtered_gpos[%d]->gpo_guid is %s\n", i,
                                   state->cse_filtered_gpos[i]->gpo_guid);
-        cse_filtered_gpo_guids[i] = talloc_steal(cse_filtered_gpo_guids,
-                                                 state->cse_filtered_gpos[i]->gpo_guid);
-        if (cse_filtered_gpo_guids[i] == NULL) {
-            ret = ENOMEM;
-            goto done;
-        }
     }
 
     DEBUG(SSSDBG_TRACE_FUNC, "num_cse_filtered_gpos: %d\n",
           state->num_cse_filtered_gpos);
 
+    state->gpo_result_key = ad_gpo_result_key(state, state->cse_filtered_gpos,
+                                              state->num_cse_filtered_gpos);
+    if (state->gpo_result_key == NULL) {
+        return ENOMEM;
+    }
+
+    if (access_ctx->gpo_result_key != NULL
+            && access_ctx->gpo_result_expire >= time(NULL)
+            && strcmp(access_ctx->gpo_result_key, state->gpo_result_key) == 0) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "GPO Result for these GPOs is still valid, using it\n");
+
+        ret = ad_gpo_perform_hbac_processing(state,
+                                             state->gpo_mode,
+                                             state->gpo_map_type,
+                                             state->user,
+                                             state->gpo_implicit_deny,
+                                             state->user_domain,
+                                             state->host_domain);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "HBAC processing failed: [%d](%s}\n",
+                  ret, sss_strerror(ret));
+        }
+
+        return ret;
+    }
+
     /*
      * before we start processing each gpo, we delete the GPO Result object
      * from the sysdb cache so that any previous policy settings are cleared;
      * subsequent functions will add the GPO Result object (and populate it
      * with resultant policy settings) for this policy application
      */
-    ret = sysdb_gpo_delete_gpo_result_object(state, state->host_domain);
+    ret = ad_gpo_reset_gpo_result(state);
     if (ret != EOK) {
-        switch (ret) {
-        case ENOENT:
-            DEBUG(SSSDBG_TRACE_FUNC, "No GPO Result available in cache\n");
-            break;
-        default:
-            DEBUG(SSSDBG_FATAL_FAILURE,
-                  "Could not delete GPO Result from cache: [%s]\n",
-                  sss_strerror(ret));
-            goto done;
-        }
+        return ret;
     }
 
-    ret = ad_gpo_cse_step(req);
-
- done:
-
-    if (ret == EOK) {
-        tevent_req_done(req);
-    } else if (ret != EAGAIN) {
-        tevent_req_error(req, ret);
-    }
+    return ad_gpo_cse_step(req);
 }
 
 static errno_t
@@ -2654,13 +3126,16 @@ ad_gpo_cse_step(struct tevent_req *req)
     DEBUG(SSSDBG_TRACE_FUNC, "smb_path: %s\n", cse_filtered_gpo->smb_path);
     DEBUG(SSSDBG_TRACE_FUNC, "gpo_guid: %s\n", cse_filtered_gpo->gpo_guid);
 
-    cse_filtered_gpo->policy_filename =
-        talloc_asprintf(state,
-                        GPO_CACHE_PATH"%s%s",
-                        cse_filtered_gpo->smb_path,
-                        GP_EXT_GUID_SECURITY_SUFFIX);
+    /* the gp_gpo may be shared with other requests via the GPO cache */
     if (cse_filtered_gpo->policy_filename == NULL) {
-        return ENOMEM;
+        cse_filtered_gpo->policy_filename =
+            talloc_asprintf(cse_filtered_gpo,
+                            GPO_CACHE_PATH"%s%s",
+                            cse_filtered_gpo->smb_path,
+                            GP_EXT_GUID_SECURITY_SUFFIX);
+        if (cse_filtered_gpo->policy_filename == NULL) {
+            return ENOMEM;
+        }
     }
 
     /* retrieve gpo cache entry; set cached_gpt_version to -1 if unavailable */
@@ -2776,6 +3251,17 @@ ad_gpo_cse_done(struct tevent_req *subreq)
 
     if (ret == EOK) {
         /* ret is EOK only after all GPO policy files have been downloaded */
+        if (state->gpo_timeout_option > 0
+                && state->gpo_result_serial
+                    == state->access_ctx->gpo_result_serial) {
+            /* no other request has reset the GPO Result in the meantime */
+            talloc_free(state->access_ctx->gpo_result_key);
+            state->access_ctx->gpo_result_key =
+                talloc_steal(state->access_ctx, state->gpo_result_key);
+            state->access_ctx->gpo_result_expire =
+                time(NULL) + state->gpo_timeout_option;
+        }
+
         ret = ad_gpo_perform_hbac_processing(state,
                                              state->gpo_mode,
                                              state->gpo_map_type,
@@ -3107,7 +3593,8 @@ struct ad_gpo_process_som_state {
     char *site_name;
     char *site_dn;
     struct gp_som **som_list;
-    int som_index;
+    struct sysdb_attrs **som_results;
+    int num_pending;
     int num_soms;
 };
 
@@ -3156,7 +3643,7 @@ ad_gpo_process_som_send(TALLOC_CTX *mem_ctx,
     state->opts = opts;
     state->ad_options = ad_options;
     state->timeout = timeout;
-    state->som_index = 0;
+    state->num_pending = 0;
     state->allow_enforced_only = 0;
 
     ret = ad_gpo_populate_som_list(state, ldb_ctx, target_dn,
@@ -3370,102 +3857,99 @@ ad_gpo_site_dn_retrieval_done(struct tevent_req *subreq)
     }
 
 }
+struct ad_gpo_som_attrs_ctx {
+    struct tevent_req *req;
+    int som_index;
+};
+
+/*
+ * The attributes of all SOMs are requested at once. The replies are
+ * processed in SOM order once all of them have arrived, since the gpOptions
+ * of a SOM affect the processing of the gPLinks of the SOMs that follow it.
+ */
 static errno_t
 ad_gpo_get_som_attrs_step(struct tevent_req *req)
 {
     const char *attrs[] = {AD_AT_GPLINK, AD_AT_GPOPTIONS, NULL};
     struct tevent_req *subreq;
     struct ad_gpo_process_som_state *state;
+    struct ad_gpo_som_attrs_ctx *cb_ctx;
+    int i;
 
     state = tevent_req_data(req, struct ad_gpo_process_som_state);
 
-    struct gp_som *gp_som = state->som_list[state->som_index];
+    state->som_results = talloc_zero_array(state, struct sysdb_attrs *,
+                                           state->num_soms);
+    if (state->som_results == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < state->num_soms; i++) {
+        cb_ctx = talloc_zero(state, struct ad_gpo_som_attrs_ctx);
+        if (cb_ctx == NULL) {
+            return ENOMEM;
+        }
+        cb_ctx->req = req;
+        cb_ctx->som_index = i;
 
-    /* gp_som is NULL only after all SOMs have been processed */
-    if (gp_som == NULL) return EOK;
+        subreq = sdap_get_generic_send(state, state->ev, state->opts,
+                                       sdap_id_op_handle(state->sdap_op),
+                                       state->som_list[i]->som_dn,
+                                       LDAP_SCOPE_BASE,
+                                       "(objectclass=*)", attrs, NULL, 0,
+                                       state->timeout,
+                                       false);
 
-    const char *som_dn = gp_som->som_dn;
-    subreq = sdap_get_generic_send(state, state->ev,  state->opts,
-                                   sdap_id_op_handle(state->sdap_op),
-                                   som_dn, LDAP_SCOPE_BASE,
-                                   "(objectclass=*)", attrs, NULL, 0,
-                                   state->timeout,
-                                   false);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "sdap_get_generic_send failed.\n");
+            return ENOMEM;
+        }
 
-    if (subreq == NULL) {
-        DEBUG(SSSDBG_OP_FAILURE, "sdap_get_generic_send failed.\n");
-        return ENOMEM;
+        tevent_req_set_callback(subreq, ad_gpo_get_som_attrs_done, cb_ctx);
+        state->num_pending++;
     }
 
-    tevent_req_set_callback(subreq, ad_gpo_get_som_attrs_done, req);
-    return EAGAIN;
+    return state->num_pending > 0 ? EAGAIN : EOK;
 }
 
-static void
-ad_gpo_get_som_attrs_done(struct tevent_req *subreq)
+static errno_t
+ad_gpo_som_process_attrs(struct ad_gpo_process_som_state *state,
+                         struct gp_som *gp_som,
+                         struct sysdb_attrs *result)
 {
-    struct tevent_req *req;
-    struct ad_gpo_process_som_state *state;
     int ret;
-    int dp_error;
-    size_t num_results;
-    struct sysdb_attrs **results;
     struct ldb_message_element *el = NULL;
     uint8_t *raw_gplink_value;
     uint8_t *raw_gpoptions_value;
     uint32_t allow_enforced_only = 0;
-    struct gp_som *gp_som;
-
-    req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct ad_gpo_process_som_state);
-    ret = sdap_get_generic_recv(subreq, state,
-                                &num_results, &results);
-    talloc_zfree(subreq);
-
-    if (ret != EOK) {
-        ret = sdap_id_op_done(state->sdap_op, ret, &dp_error);
 
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Unable to get SOM attributes: [%d](%s)\n",
-              ret, sss_strerror(ret));
-        ret = ENOENT;
-        goto done;
-    }
-    if ((num_results < 1) || (results == NULL)) {
+    if (result == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "no attrs found for SOM; try next SOM.\n");
-        state->som_index++;
-        ret = ad_gpo_get_som_attrs_step(req);
-        goto done;
-    } else if (num_results > 1) {
-        DEBUG(SSSDBG_OP_FAILURE, "Received multiple replies\n");
-        ret = ERR_INTERNAL;
-        goto done;
+        return EOK;
     }
 
     /* Get the gplink value, if available */
-    ret = sysdb_attrs_get_el(results[0], AD_AT_GPLINK, &el);
+    ret = sysdb_attrs_get_el(result, AD_AT_GPLINK, &el);
 
     if (ret != EOK && ret != ENOENT) {
         DEBUG(SSSDBG_OP_FAILURE,
               "sysdb_attrs_get_el() failed: [%d](%s)\n",
               ret, sss_strerror(ret));
-        goto done;
+        return ret;
     }
 
     if ((ret == ENOENT) || (el->num_values == 0)) {
         DEBUG(SSSDBG_OP_FAILURE, "no attrs found for SOM; try next SOM\n");
-        state->som_index++;
-        ret = ad_gpo_get_som_attrs_step(req);
-        goto done;
+        return EOK;
     }
 
     raw_gplink_value = el[0].values[0].data;
 
-    ret = sysdb_attrs_get_el(results[0], AD_AT_GPOPTIONS, &el);
+    ret = sysdb_attrs_get_el(result, AD_AT_GPOPTIONS, &el);
 
     if (ret != EOK && ret != ENOENT) {
         DEBUG(SSSDBG_OP_FAILURE, "sysdb_attrs_get_el() failed\n");
-        goto done;
+        return ret;
     }
 
     if ((ret == ENOENT) || (el->num_values == 0)) {
@@ -3479,11 +3963,10 @@ ad_gpo_get_som_attrs_done(struct tevent_req *subreq)
             ret = errno;
             DEBUG(SSSDBG_OP_FAILURE,
                   "strtouint32 failed: [%d](%s)\n", ret, sss_strerror(ret));
-            goto done;
+            return ret;
         }
     }
 
-    gp_som = state->som_list[state->som_index];
     ret = ad_gpo_populate_gplink_list(gp_som,
                                       gp_som->som_dn,
                                       (char *)raw_gplink_value,
@@ -3493,18 +3976,74 @@ ad_gpo_get_som_attrs_done(struct tevent_req *subreq)
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "ad_gpo_populate_gplink_list() failed\n");
-        goto done;
+        return ret;
     }
 
     if (allow_enforced_only) {
         state->allow_enforced_only = 1;
     }
 
-    state->som_index++;
-    ret = ad_gpo_get_som_attrs_step(req);
+    return EOK;
+}
+
+static void
+ad_gpo_get_som_attrs_done(struct tevent_req *subreq)
+{
+    struct ad_gpo_som_attrs_ctx *cb_ctx;
+    struct tevent_req *req;
+    struct ad_gpo_process_som_state *state;
+    int ret;
+    int dp_error;
+    int i;
+    size_t num_results;
+    struct sysdb_attrs **results;
+
+    cb_ctx = tevent_req_callback_data(subreq, struct ad_gpo_som_attrs_ctx);
+    req = cb_ctx->req;
+    state = tevent_req_data(req, struct ad_gpo_process_som_state);
+    ret = sdap_get_generic_recv(subreq, state,
+                                &num_results, &results);
+    talloc_zfree(subreq);
+    state->num_pending--;
+
+    if (ret != EOK) {
+        ret = sdap_id_op_done(state->sdap_op, ret, &dp_error);
+
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Unable to get SOM attributes: [%d](%s)\n",
+              ret, sss_strerror(ret));
+        ret = ENOENT;
+        goto done;
+    }
+    if ((num_results < 1) || (results == NULL)) {
+        state->som_results[cb_ctx->som_index] = NULL;
+    } else if (num_results > 1) {
+        DEBUG(SSSDBG_OP_FAILURE, "Received multiple replies\n");
+        ret = ERR_INTERNAL;
+        goto done;
+    } else {
+        state->som_results[cb_ctx->som_index] = results[0];
+    }
+
+    if (state->num_pending > 0) {
+        ret = EAGAIN;
+        goto done;
+    }
+
+    for (i = 0; i < state->num_soms; i++) {
+        ret = ad_gpo_som_process_attrs(state, state->som_list[i],
+                                       state->som_results[i]);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
 
  done:
 
+    talloc_free(cb_ctx);
+
     if (ret == EOK) {
         tevent_req_done(req);
     } else if (ret != EAGAIN) {
@@ -3993,6 +4532,11 @@ struct ad_gpo_process_gpo_state {
     int timeout;
     struct gp_gpo **candidate_gpos;
     int num_candidate_gpos;
+    int num_pending;
+};
+
+struct ad_gpo_gpo_attrs_ctx {
+    struct tevent_req *req;
     int gpo_index;
 };
 
@@ -4037,7 +4581,7 @@ ad_gpo_process_gpo_send(TALLOC_CTX *mem_ctx,
     state->host_domain = host_domain;
     state->access_ctx = access_ctx;
     state->timeout = timeout;
-    state->gpo_index = 0;
+    state->num_pending = 0;
     state->candidate_gpos = NULL;
     state->num_candidate_gpos = 0;
 
@@ -4074,37 +4618,80 @@ immediately:
     return req;
 }
 
+/*
+ * The attributes of all candidate GPOs are requested at once, each reply is
+ * stored in its own gp_gpo object so the order of the replies does not
+ * matter.
+ */
 static errno_t
 ad_gpo_get_gpo_attrs_step(struct tevent_req *req)
 {
     const char *attrs[] = AD_GPO_ATTRS;
     struct tevent_req *subreq;
     struct ad_gpo_process_gpo_state *state;
+    struct ad_gpo_gpo_attrs_ctx *cb_ctx;
+    int i;
 
     state = tevent_req_data(req, struct ad_gpo_process_gpo_state);
 
-    struct gp_gpo *gp_gpo = state->candidate_gpos[state->gpo_index];
+    for (i = 0; i < state->num_candidate_gpos; i++) {
+        cb_ctx = talloc_zero(state, struct ad_gpo_gpo_attrs_ctx);
+        if (cb_ctx == NULL) {
+            return ENOMEM;
+        }
+        cb_ctx->req = req;
+        cb_ctx->gpo_index = i;
+
+        subreq = sdap_sd_search_send(state, state->ev,
+                                     state->opts,
+                                     sdap_id_op_handle(state->sdap_op),
+                                     state->candidate_gpos[i]->gpo_dn,
+                                     SECINFO_DACL, attrs, state->timeout);
+
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "sdap_sd_search_send failed.\n");
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, ad_gpo_get_gpo_attrs_done, cb_ctx);
+        state->num_pending++;
+    }
 
-    /* gp_gpo is NULL only after all GPOs have been processed */
-    if (gp_gpo == NULL) return EOK;
+    return state->num_pending > 0 ? EAGAIN : EOK;
+}
 
-    const char *gpo_dn = gp_gpo->gpo_dn;
+/*
+ * This function finishes the lookup of the attributes of a single GPO and
+ * completes the request once the attributes of all GPOs are known.
+ */
+static void
+ad_gpo_get_gpo_attrs_finish(struct ad_gpo_gpo_attrs_ctx *cb_ctx, errno_t ret)
+{
+    struct tevent_req *req = cb_ctx->req;
+    struct ad_gpo_process_gpo_state *state =
+            tevent_req_data(req, struct ad_gpo_process_gpo_state);
 
-    subreq = sdap_sd_search_send(state, state->ev,
-                                 state->opts, sdap_id_op_handle(state->sdap_op),
-                                 gpo_dn, SECINFO_DACL, attrs, state->timeout);
+    talloc_free(cb_ctx);
+    state->num_pending--;
 
-    if (subreq == NULL) {
-        DEBUG(SSSDBG_OP_FAILURE, "sdap_sd_search_send failed.\n");
-        return ENOMEM;
+    if (!tevent_req_is_in_progress(req)) {
+        /* another lookup has already failed */
+        return;
     }
 
-    tevent_req_set_callback(subreq, ad_gpo_get_gpo_attrs_done, req);
-    return EAGAIN;
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    if (state->num_pending == 0) {
+        tevent_req_done(req);
+    }
 }
 
 static errno_t
-ad_gpo_sd_process_attrs(struct tevent_req *req,
+ad_gpo_sd_process_attrs(struct ad_gpo_process_gpo_state *state,
+                        int gpo_index,
                         char *smb_host,
                         struct sysdb_attrs *result);
 void
@@ -4127,7 +4714,7 @@ ad_gpo_get_sd_referral_recv(struct tevent_req *req,
 static void
 ad_gpo_get_gpo_attrs_done(struct tevent_req *subreq)
 {
-    struct tevent_req *req;
+    struct ad_gpo_gpo_attrs_ctx *cb_ctx;
     struct ad_gpo_process_gpo_state *state;
     int ret;
     int dp_error;
@@ -4135,8 +4722,8 @@ ad_gpo_get_gpo_attrs_done(struct tevent_req *subreq)
     struct sysdb_attrs **results;
     char **refs;
 
-    req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct ad_gpo_process_gpo_state);
+    cb_ctx = tevent_req_callback_data(subreq, struct ad_gpo_gpo_attrs_ctx);
+    state = tevent_req_data(cb_ctx->req, struct ad_gpo_process_gpo_state);
 
     ret = sdap_sd_search_recv(subreq, state,
                               &num_results, &results,
@@ -4171,12 +4758,12 @@ ad_gpo_get_gpo_attrs_done(struct tevent_req *subreq)
                 goto done;
             }
 
-            tevent_req_set_callback(subreq, ad_gpo_get_sd_referral_done, req);
-            ret = EAGAIN;
-            goto done;
+            tevent_req_set_callback(subreq, ad_gpo_get_sd_referral_done,
+                                    cb_ctx);
+            return;
 
         } else {
-            const char *gpo_dn = state->candidate_gpos[state->gpo_index]->gpo_dn;
+            const char *gpo_dn = state->candidate_gpos[cb_ctx->gpo_index]->gpo_dn;
 
             DEBUG(SSSDBG_OP_FAILURE,
                   "No attrs found for GPO [%s].\n", gpo_dn);
@@ -4189,15 +4776,12 @@ ad_gpo_get_gpo_attrs_done(struct tevent_req *subreq)
         goto done;
     }
 
-    ret = ad_gpo_sd_process_attrs(req, state->server_hostname, results[0]);
+    ret = ad_gpo_sd_process_attrs(state, cb_ctx->gpo_index,
+                                  state->server_hostname, results[0]);
 
 done:
 
-   if (ret == EOK) {
-       tevent_req_done(req);
-   } else if (ret != EAGAIN) {
-       tevent_req_error(req, ret);
-   }
+    ad_gpo_get_gpo_attrs_finish(cb_ctx, ret);
 }
 
 void
@@ -4208,10 +4792,10 @@ ad_gpo_get_sd_referral_done(struct tevent_req *subreq)
     struct sysdb_attrs *reply;
     char *smb_host;
 
-    struct tevent_req *req =
-            tevent_req_callback_data(subreq, struct tevent_req);
+    struct ad_gpo_gpo_attrs_ctx *cb_ctx =
+            tevent_req_callback_data(subreq, struct ad_gpo_gpo_attrs_ctx);
     struct ad_gpo_process_gpo_state *state =
-            tevent_req_data(req, struct ad_gpo_process_gpo_state);
+            tevent_req_data(cb_ctx->req, struct ad_gpo_process_gpo_state);
 
     ret = ad_gpo_get_sd_referral_recv(subreq, state, &smb_host, &reply);
     talloc_zfree(subreq);
@@ -4227,15 +4811,11 @@ ad_gpo_get_sd_referral_done(struct tevent_req *subreq)
     }
 
     /* Lookup succeeded. Process it */
-    ret = ad_gpo_sd_process_attrs(req, smb_host, reply);
+    ret = ad_gpo_sd_process_attrs(state, cb_ctx->gpo_index, smb_host, reply);
 
 done:
 
-   if (ret == EOK) {
-       tevent_req_done(req);
-   } else if (ret != EAGAIN) {
-       tevent_req_error(req, ret);
-   }
+    ad_gpo_get_gpo_attrs_finish(cb_ctx, ret);
 }
 
 static bool machine_ext_names_is_blank(char *attr_value)
@@ -4258,7 +4838,7 @@ static bool machine_ext_names_is_blank(char *attr_value)
 
 static errno_t
 ad_gpo_missing_or_unreadable_attr(struct ad_gpo_process_gpo_state *state,
-                                  struct tevent_req *req)
+                                  int gpo_index)
 {
     bool ignore_unreadable = dp_opt_get_bool(state->ad_options,
                                              AD_GPO_IGNORE_UNREADABLE);
@@ -4270,9 +4850,8 @@ ad_gpo_missing_or_unreadable_attr(struct ad_gpo_process_gpo_state *state,
               "Group Policy Container with DN [%s] has unreadable or missing "
               "attributes -> skipping this GPO "
               "(ad_gpo_ignore_unreadable = True)\n",
-              state->candidate_gpos[state->gpo_index]->gpo_dn);
-        state->gpo_index++;
-        return ad_gpo_get_gpo_attrs_step(req);
+              state->candidate_gpos[gpo_index]->gpo_dn);
+        return EOK;
     } else {
         /* Inform in logs and syslog that this GPO can
          * not be processed due to unreadable or missing
@@ -4288,7 +4867,7 @@ ad_gpo_missing_or_unreadable_attr(struct ad_gpo_process_gpo_state *state,
               "not change permissions on this object, you can use option "
               "ad_gpo_ignore_unreadable = True which will skip this GPO. "
               "See ad_gpo_ignore_unreadable in 'man sssd-ad' for details.\n",
-              state->candidate_gpos[state->gpo_index]->gpo_dn);
+              state->candidate_gpos[gpo_index]->gpo_dn);
         sss_log(SSS_LOG_ERR,
                 "Group Policy Container with DN [%s] is unreadable or has "
                 "unreadable or missing attributes. In order to fix this "
@@ -4299,17 +4878,17 @@ ad_gpo_missing_or_unreadable_attr(struct ad_gpo_process_gpo_state *state,
                 "not change permissions on this object, you can use option "
                 "ad_gpo_ignore_unreadable = True which will skip this GPO. "
                 "See ad_gpo_ignore_unreadable in 'man sssd-ad' for details.\n",
-                state->candidate_gpos[state->gpo_index]->gpo_dn);
+                state->candidate_gpos[gpo_index]->gpo_dn);
         return EFAULT;
     }
 }
 
 static errno_t
-ad_gpo_sd_process_attrs(struct tevent_req *req,
+ad_gpo_sd_process_attrs(struct ad_gpo_process_gpo_state *state,
+                        int gpo_index,
                         char *smb_host,
                         struct sysdb_attrs *result)
 {
-    struct ad_gpo_process_gpo_state *state;
     struct gp_gpo *gp_gpo;
     int ret;
     struct ldb_message_element *el = NULL;
@@ -4318,13 +4897,12 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
     char *file_sys_path = NULL;
     uint8_t *raw_machine_ext_names = NULL;
 
-    state = tevent_req_data(req, struct ad_gpo_process_gpo_state);
-    gp_gpo = state->candidate_gpos[state->gpo_index];
+    gp_gpo = state->candidate_gpos[gpo_index];
 
     /* retrieve AD_AT_CN */
     ret = sysdb_attrs_get_string(result, AD_AT_CN, &gpo_guid);
     if (ret == ENOENT) {
-        ret = ad_gpo_missing_or_unreadable_attr(state, req);
+        ret = ad_gpo_missing_or_unreadable_attr(state, gpo_index);
         goto done;
     } else if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
@@ -4348,7 +4926,7 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
                                  &raw_file_sys_path);
 
     if (ret == ENOENT) {
-        ret = ad_gpo_missing_or_unreadable_attr(state, req);
+        ret = ad_gpo_missing_or_unreadable_attr(state, gpo_index);
         goto done;
     } else if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
@@ -4382,8 +4960,7 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
          * https://msdn.microsoft.com/en-us/library/cc232538.aspx */
         DEBUG(SSSDBG_TRACE_ALL, "GPO with GUID %s is missing attribute "
               AD_AT_FUNC_VERSION " and will be skipped.\n", gp_gpo->gpo_guid);
-        state->gpo_index++;
-        ret = ad_gpo_get_gpo_attrs_step(req);
+        ret = EOK;
         goto done;
     } else if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
@@ -4399,7 +4976,7 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
     ret = sysdb_attrs_get_int32_t(result, AD_AT_FLAGS,
                                   &gp_gpo->gpo_flags);
     if (ret == ENOENT) {
-        ret = ad_gpo_missing_or_unreadable_attr(state, req);
+        ret = ad_gpo_missing_or_unreadable_attr(state, gpo_index);
         goto done;
     } else if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
@@ -4419,7 +4996,7 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
     if ((ret == ENOENT) || (el->num_values == 0)) {
         DEBUG(SSSDBG_OP_FAILURE,
               "nt_sec_desc attribute not found or has no value\n");
-        ret = ad_gpo_missing_or_unreadable_attr(state, req);
+        ret = ad_gpo_missing_or_unreadable_attr(state, gpo_index);
         goto done;
     }
 
@@ -4445,7 +5022,6 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
          */
         DEBUG(SSSDBG_TRACE_ALL,
               "machine_ext_names attribute not found or has no value\n");
-        state->gpo_index++;
     } else {
         raw_machine_ext_names = el[0].values[0].data;
 
@@ -4458,11 +5034,9 @@ ad_gpo_sd_process_attrs(struct tevent_req *req,
                   "ad_gpo_parse_machine_ext_names() failed\n");
             goto done;
         }
-
-        state->gpo_index++;
     }
 
-    ret = ad_gpo_get_gpo_attrs_step(req);
+    ret = EOK;
 
  done:
 
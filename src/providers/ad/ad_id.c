@@ -185,6 +185,7 @@ ad_handle_acct_info_step(struct tevent_req *req)
     struct ad_handle_acct_info_state *state = tevent_req_data(req,
                                             struct ad_handle_acct_info_state);
     bool noexist_delete = false;
+    bool background_lookup;
     struct ldb_message *msg;
     int ret;
 
@@ -205,11 +206,14 @@ ad_handle_acct_info_step(struct tevent_req *req)
         if (ret == EOK) {
             /* evaluate PAC */
             state->using_pac = true;
+            background_lookup = dp_opt_get_bool(state->ad_options->basic,
+                                                AD_PAC_BACKGROUND_GROUP_LOOKUP);
             subreq = ad_handle_pac_initgr_send(state, state->ctx->be,
                                                state->ar, state->ctx,
                                                state->sdom,
                                                state->conn[state->cindex],
                                                noexist_delete,
+                                               background_lookup,
                                                msg);
             if (subreq == NULL) {
                 DEBUG(SSSDBG_OP_FAILURE, "ad_handle_pac_initgr_send failed.\n");
@@ -407,6 +407,19 @@ static errno_t ad_init_misc(struct be_ctx *be_ctx,
         return ret;
     }
 
+    /* The Global Catalog may contain servers of other domains of the forest
+     * which would not answer a CLDAP ping for this domain, so keep probing
+     * them with the generic LDAP probe. */
+    ret = be_fo_set_probe_plugin(be_ctx, ad_id_ctx->ldap_ctx->service->name,
+                                 ad_cldap_fo_probe_send,
+                                 ad_cldap_fo_probe_recv,
+                                 ad_id_ctx, BE_FO_PROBE_PRIORITY_SPECIFIC,
+                                 "AD CLDAP");
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to set failover probe "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+    }
+
     ret = ad_refresh_init(be_ctx, ad_id_ctx);
     if (ret != EOK && ret != EEXIST) {
         DEBUG(SSSDBG_MINOR_FAILURE, "Periodical refresh "
@@ -517,6 +517,160 @@ done:
     return ret;
 }
 
+/* Update the group memberships of a user once the missing group SIDs of the
+ * PAC were looked up. The groups which were already cached before the lookup
+ * are passed in @cached_groups. */
+static errno_t ad_pac_update_resolved_groups(TALLOC_CTX *mem_ctx,
+                                             struct sss_domain_info *user_dom,
+                                             const char *username,
+                                             size_t num_missing_sids,
+                                             char **missing_sids,
+                                             size_t num_cached_groups,
+                                             char **cached_groups)
+{
+    TALLOC_CTX *tmp_ctx;
+    char **resolved_groups;
+    size_t num_resolved_groups;
+    char **groups;
+    size_t i;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sdap_ad_tokengroups_get_posix_members(tmp_ctx, user_dom,
+                                                num_missing_sids,
+                                                missing_sids,
+                                                NULL, NULL,
+                                                &num_resolved_groups,
+                                                &resolved_groups);
+    if (ret != EOK){
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "sdap_ad_tokengroups_get_posix_members failed [%d]: %s\n",
+              ret, strerror(ret));
+        goto done;
+    }
+
+    /* the strings stay owned by their arrays, only the pointers are
+     * collected */
+    groups = talloc_zero_array(tmp_ctx, char *,
+                               num_cached_groups + num_resolved_groups + 1);
+    if (groups == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < num_cached_groups; i++) {
+        groups[i] = cached_groups[i];
+    }
+
+    for (i = 0; i < num_resolved_groups; i++) {
+        groups[num_cached_groups + i] = resolved_groups[i];
+    }
+
+    /* update membership of existing groups */
+    ret = sdap_ad_tokengroups_update_members(username,
+                                             user_dom->sysdb,
+                                             user_dom,
+                                             groups);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Membership update failed [%d]: %s\n",
+                                     ret, strerror(ret));
+        goto done;
+    }
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* With ad_pac_background_group_lookup the initgroups request is finished
+ * as soon as the memberships of the already cached groups are saved and the
+ * missing groups are looked up afterwards. The context is allocated on the
+ * backend context so that it outlives the initgroups request. */
+struct ad_pac_bg_lookup_ctx {
+    struct sss_domain_info *user_dom;
+    char *username;
+    size_t num_missing_sids;
+    char **missing_sids;
+    size_t num_cached_groups;
+    char **cached_groups;
+};
+
+static void ad_pac_bg_lookup_done(struct tevent_req *subreq);
+
+static errno_t ad_pac_bg_lookup_start(struct be_ctx *be_ctx,
+                                      struct sdap_id_ctx *id_ctx,
+                                      struct sdap_id_conn_ctx *conn,
+                                      struct sss_domain_info *user_dom,
+                                      char *username,
+                                      size_t num_missing_sids,
+                                      char **missing_sids,
+                                      size_t num_cached_groups,
+                                      char **cached_groups)
+{
+    struct ad_pac_bg_lookup_ctx *bg_ctx;
+    struct tevent_req *subreq;
+
+    bg_ctx = talloc_zero(be_ctx, struct ad_pac_bg_lookup_ctx);
+    if (bg_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    bg_ctx->user_dom = user_dom;
+    bg_ctx->username = talloc_steal(bg_ctx, username);
+    bg_ctx->num_missing_sids = num_missing_sids;
+    bg_ctx->missing_sids = talloc_steal(bg_ctx, missing_sids);
+    bg_ctx->num_cached_groups = num_cached_groups;
+    bg_ctx->cached_groups = talloc_steal(bg_ctx, cached_groups);
+
+    subreq = sdap_ad_resolve_sids_send(bg_ctx, be_ctx->ev, id_ctx, conn,
+                                       id_ctx->opts, user_dom,
+                                       bg_ctx->missing_sids);
+    if (subreq == NULL) {
+        talloc_free(bg_ctx);
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, ad_pac_bg_lookup_done, bg_ctx);
+
+    return EOK;
+}
+
+static void ad_pac_bg_lookup_done(struct tevent_req *subreq)
+{
+    struct ad_pac_bg_lookup_ctx *bg_ctx;
+    errno_t ret;
+
+    bg_ctx = tevent_req_callback_data(subreq, struct ad_pac_bg_lookup_ctx);
+
+    ret = sdap_ad_resolve_sids_recv(subreq);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to resolve missing SIDs of user "
+              "[%s] [%d]: %s\n", bg_ctx->username, ret, strerror(ret));
+        goto done;
+    }
+
+    ret = ad_pac_update_resolved_groups(bg_ctx, bg_ctx->user_dom,
+                                        bg_ctx->username,
+                                        bg_ctx->num_missing_sids,
+                                        bg_ctx->missing_sids,
+                                        bg_ctx->num_cached_groups,
+                                        bg_ctx->cached_groups);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Background lookup of the groups of [%s] "
+                             "finished.\n", bg_ctx->username);
+
+done:
+    talloc_free(bg_ctx);
+}
+
 struct ad_handle_pac_initgr_state {
     struct dp_id_data *ar;
     const char *err;
@@ -541,6 +695,7 @@ struct tevent_req *ad_handle_pac_initgr_send(TALLOC_CTX *mem_ctx,
                                              struct sdap_domain *sdom,
                                              struct sdap_id_conn_ctx *conn,
                                              bool noexist_delete,
+                                             bool background_lookup,
                                              struct ldb_message *msg)
 {
     int ret;
@@ -632,6 +787,39 @@ struct tevent_req *ad_handle_pac_initgr_send(TALLOC_CTX *mem_ctx,
             goto done;
         }
 
+        if (background_lookup && state->num_missing_sids > 0) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Looking up %zu missing groups of [%s] "
+                  "in the background.\n", state->num_missing_sids,
+                  state->username);
+
+            ret = sdap_ad_tokengroups_update_members(state->username,
+                                                     sdom->dom->sysdb,
+                                                     sdom->dom,
+                                                     state->cached_groups);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_MINOR_FAILURE,
+                      "Membership update failed [%d]: %s\n",
+                      ret, strerror(ret));
+                goto done;
+            }
+
+            ret = ad_pac_bg_lookup_start(be_ctx, id_ctx, conn, sdom->dom,
+                                         state->username,
+                                         state->num_missing_sids,
+                                         state->missing_sids,
+                                         state->num_cached_groups,
+                                         state->cached_groups);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_MINOR_FAILURE,
+                      "Unable to start background lookup [%d]: %s\n",
+                      ret, sss_strerror(ret));
+            }
+
+            /* the user can log in with the groups known so far */
+            ret = EOK;
+            goto done;
+        }
+
         /* download missing SIDs */
         subreq = sdap_ad_resolve_sids_send(state, be_ctx->ev, id_ctx,
                                            conn,
@@ -666,8 +854,6 @@ static void ad_handle_pac_initgr_lookup_sids_done(struct tevent_req *subreq)
     struct ad_handle_pac_initgr_state *state;
     struct tevent_req *req = NULL;
     errno_t ret;
-    char **cached_groups;
-    size_t num_cached_groups;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
     state = tevent_req_data(req, struct ad_handle_pac_initgr_state);
@@ -680,37 +866,13 @@ static void ad_handle_pac_initgr_lookup_sids_done(struct tevent_req *subreq)
         goto done;
     }
 
-    ret = sdap_ad_tokengroups_get_posix_members(state, state->user_dom,
-                                                state->num_missing_sids,
-                                                state->missing_sids,
-                                                NULL, NULL,
-                                                &num_cached_groups,
-                                                &cached_groups);
-    if (ret != EOK){
-        DEBUG(SSSDBG_MINOR_FAILURE,
-              "sdap_ad_tokengroups_get_posix_members failed [%d]: %s\n",
-              ret, strerror(ret));
-        goto done;
-    }
-
-    state->cached_groups = concatenate_string_array(state,
-                                                    state->cached_groups,
-                                                    state->num_cached_groups,
-                                                    cached_groups,
-                                                    num_cached_groups);
-    if (state->cached_groups == NULL) {
-        ret = ENOMEM;
-        goto done;
-    }
-
-    /* update membership of existing groups */
-    ret = sdap_ad_tokengroups_update_members(state->username,
-                                             state->user_dom->sysdb,
-                                             state->user_dom,
-                                             state->cached_groups);
+    ret = ad_pac_update_resolved_groups(state, state->user_dom,
+                                        state->username,
+                                        state->num_missing_sids,
+                                        state->missing_sids,
+                                        state->num_cached_groups,
+                                        state->cached_groups);
     if (ret != EOK) {
-        DEBUG(SSSDBG_MINOR_FAILURE, "Membership update failed [%d]: %s\n",
-                                     ret, strerror(ret));
         goto done;
     }
 
@@ -73,6 +73,7 @@ struct tevent_req *ad_handle_pac_initgr_send(TALLOC_CTX *mem_ctx,
                                              struct sdap_domain *sdom,
                                              struct sdap_id_conn_ctx *conn,
                                              bool noexist_delete,
+                                             bool background_lookup,
                                              struct ldb_message *msg);
 
 errno_t ad_handle_pac_initgr_recv(struct tevent_req *req,
@@ -75,4 +75,15 @@ errno_t ad_cldap_ping_recv(TALLOC_CTX *mem_ctx,
                            const char **_site,
                            const char **_forest);
 
+/* Failover probe plugin, sends a CLDAP ping to the domain controller.
+ * 'pvt' is the struct ad_id_ctx of the probed service. */
+struct tevent_req *ad_cldap_fo_probe_send(TALLOC_CTX *mem_ctx,
+                                          struct tevent_context *ev,
+                                          struct be_ctx *be_ctx,
+                                          const char *service_name,
+                                          struct fo_server *server,
+                                          void *pvt);
+
+errno_t ad_cldap_fo_probe_recv(struct tevent_req *req);
+
 #endif /* __AD_SRV_H__ */
@@ -39,6 +39,25 @@ struct be_ctx;
 
 typedef void (*be_callback_t)(void *);
 
+/* Background health probe of a single failover server. The request
+ * should finish with EOK if the server is able to serve requests. */
+typedef struct tevent_req *
+(*be_fo_probe_send_t)(TALLOC_CTX *mem_ctx,
+                      struct tevent_context *ev,
+                      struct be_ctx *be_ctx,
+                      const char *service_name,
+                      struct fo_server *server,
+                      void *pvt);
+
+typedef errno_t
+(*be_fo_probe_recv_t)(struct tevent_req *req);
+
+/* A probe can only be replaced by a probe of the same or higher priority. */
+enum be_fo_probe_priority {
+    BE_FO_PROBE_PRIORITY_GENERIC,
+    BE_FO_PROBE_PRIORITY_SPECIFIC
+};
+
 struct be_resolv_ctx {
     struct resolv_ctx *resolv;
     struct dp_option *opts;
@@ -60,6 +79,11 @@ struct be_svc_data {
 
     struct be_svc_callback *callbacks;
     struct fo_server *first_resolved;
+
+    be_fo_probe_send_t probe_send_fn;
+    be_fo_probe_recv_t probe_recv_fn;
+    void *probe_pvt;
+    enum be_fo_probe_priority probe_priority;
 };
 
 struct be_failover_ctx {
@@ -68,6 +92,9 @@ struct be_failover_ctx {
 
     struct be_svc_data *svcs;
     struct tevent_timer *primary_server_handler;
+
+    /* connect to the next server as soon as the current one is abandoned */
+    bool hot_standby;
 };
 
 struct be_cb;
@@ -117,6 +144,10 @@ struct be_ctx {
      * DP_ERR_OK or DP_ERR_OFFLINE. The only usage of this var, so far, is
      * to log the DP status without spamming the syslog/journal. */
     int last_dp_state;
+
+    /* Worker threads hashing cached passwords, NULL if the credentials are
+     * not cached or the threads could not be started. */
+    struct sss_hash_pool *hash_pool;
 };
 
 bool be_is_offline(struct be_ctx *ctx);
@@ -175,6 +206,29 @@ void be_fo_set_srv_lookup_plugin(struct be_ctx *ctx,
 errno_t be_fo_set_dns_srv_lookup_plugin(struct be_ctx *be_ctx,
                                         const char *hostname);
 
+/*
+ * Set the function used to probe servers of the service in the background.
+ * A previously set probe is replaced only if it has the same or lower
+ * priority, so a more specific provider overrides the generic one regardless
+ * of the order in which they are registered. Returns EEXIST if a probe of
+ * higher priority is already set.
+ */
+errno_t be_fo_set_probe_plugin(struct be_ctx *ctx,
+                               const char *service_name,
+                               be_fo_probe_send_t send_fn,
+                               be_fo_probe_recv_t recv_fn,
+                               void *pvt,
+                               enum be_fo_probe_priority priority,
+                               const char *plugin_name);
+
+/* Remove the probe of the service if it was set with the same 'pvt'. */
+void be_fo_unset_probe_plugin(struct be_ctx *ctx,
+                              const char *service_name,
+                              void *pvt);
+
+/* from be_fo_probe.c */
+errno_t be_fo_probe_init(struct be_ctx *be_ctx);
+
 int be_fo_add_srv_server(struct be_ctx *ctx,
                          const char *service_name,
                          const char *query_service,
@@ -206,6 +260,16 @@ void _be_fo_set_port_status(struct be_ctx *ctx,
                             const char *file,
                             const char *function);
 
+/*
+ * Record the time elapsed since 'start' as latency of the given type
+ * for 'server'.
+ */
+void be_fo_set_server_latency(struct be_ctx *ctx,
+                              const char *service_name,
+                              struct fo_server *server,
+                              enum fo_latency_type type,
+                              struct timeval start);
+
 /*
  * Instruct fail-over to try next server on the next connect attempt.
  * Should be used after connection to service was unexpectedly dropped
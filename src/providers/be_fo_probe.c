@@ -0,0 +1,228 @@
+/*
+    SSSD
+
+    Background health probing of failover servers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <tevent.h>
+#include <talloc.h>
+
+#include "providers/backend.h"
+#include "providers/be_ptask.h"
+#include "util/util.h"
+
+struct be_fo_probe_state {
+    struct tevent_context *ev;
+    struct be_ctx *be_ctx;
+
+    size_t running;
+    bool reconnect;
+};
+
+struct be_fo_probe_server_state {
+    struct tevent_req *req;
+    struct be_svc_data *svc;
+    struct fo_server *server;
+};
+
+static errno_t be_fo_probe_service(struct tevent_req *req,
+                                   struct be_svc_data *svc,
+                                   size_t max);
+static void be_fo_probe_server_done(struct tevent_req *subreq);
+
+static struct tevent_req *
+be_fo_probe_send(TALLOC_CTX *mem_ctx,
+                 struct tevent_context *ev,
+                 struct be_ctx *be_ctx,
+                 struct be_ptask *be_ptask,
+                 void *pvt)
+{
+    struct be_fo_probe_state *state;
+    struct tevent_req *req;
+    struct be_svc_data *svc;
+    int max;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct be_fo_probe_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->be_ctx = be_ctx;
+
+    max = dp_opt_get_int(be_ctx->be_res->opts, DP_RES_OPT_FO_PROBE_SERVERS);
+    if (max <= 0) {
+        ret = EOK;
+        goto immediately;
+    }
+
+    DLIST_FOR_EACH(svc, be_ctx->be_fo->svcs) {
+        if (svc->probe_send_fn == NULL) {
+            continue;
+        }
+
+        ret = be_fo_probe_service(req, svc, max);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to probe servers of service "
+                  "%s [%d]: %s\n", svc->name, ret, sss_strerror(ret));
+            continue;
+        }
+    }
+
+    if (state->running == 0) {
+        ret = EOK;
+        goto immediately;
+    }
+
+    return req;
+
+immediately:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else {
+        tevent_req_error(req, ret);
+    }
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static errno_t be_fo_probe_service(struct tevent_req *req,
+                                   struct be_svc_data *svc,
+                                   size_t max)
+{
+    struct be_fo_probe_state *state;
+    struct be_fo_probe_server_state *probe;
+    struct fo_server **servers;
+    struct tevent_req *subreq;
+    errno_t ret;
+    size_t i;
+
+    state = tevent_req_data(req, struct be_fo_probe_state);
+
+    ret = fo_svc_probe_candidates(state, svc->fo_service, max, &servers);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    for (i = 0; servers[i] != NULL; i++) {
+        probe = talloc_zero(servers, struct be_fo_probe_server_state);
+        if (probe == NULL) {
+            return ENOMEM;
+        }
+
+        probe->req = req;
+        probe->svc = svc;
+        probe->server = servers[i];
+
+        DEBUG(SSSDBG_TRACE_FUNC, "Probing server %s of service %s\n",
+              fo_get_server_str_name(servers[i]), svc->name);
+
+        subreq = svc->probe_send_fn(probe, state->ev, state->be_ctx,
+                                    svc->name, servers[i], svc->probe_pvt);
+        if (subreq == NULL) {
+            talloc_free(probe);
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, be_fo_probe_server_done, probe);
+        state->running++;
+    }
+
+    return EOK;
+}
+
+static void be_fo_probe_server_done(struct tevent_req *subreq)
+{
+    struct be_fo_probe_server_state *probe;
+    struct be_fo_probe_state *state;
+    struct tevent_req *req;
+    bool was_active;
+    bool demoted;
+    errno_t ret;
+
+    probe = tevent_req_callback_data(subreq, struct be_fo_probe_server_state);
+    req = probe->req;
+    state = tevent_req_data(req, struct be_fo_probe_state);
+
+    ret = probe->svc->probe_recv_fn(subreq);
+    talloc_zfree(subreq);
+
+    if (fo_svc_has_server(probe->svc->fo_service, probe->server)) {
+        was_active = fo_get_active_server(probe->svc->fo_service)
+                         == probe->server;
+
+        demoted = fo_set_server_probe_result(probe->server, ret == EOK);
+        if (demoted && was_active) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "Active server %s of service %s "
+                  "did not respond to the probe [%d]: %s\n",
+                  fo_get_server_str_name(probe->server), probe->svc->name,
+                  ret, sss_strerror(ret));
+            state->reconnect = true;
+        }
+    }
+
+    talloc_free(probe);
+
+    state->running--;
+    if (state->running > 0) {
+        return;
+    }
+
+    if (state->reconnect && !be_is_offline(state->be_ctx)) {
+        /* Abandon connections to the failed server now instead of letting
+         * the next request time out on them. */
+        be_run_reconnect_cb(state->be_ctx);
+    }
+
+    tevent_req_done(req);
+}
+
+static errno_t be_fo_probe_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
+errno_t be_fo_probe_init(struct be_ctx *be_ctx)
+{
+    time_t interval;
+    errno_t ret;
+
+    interval = dp_opt_get_int(be_ctx->be_res->opts,
+                              DP_RES_OPT_FO_PROBE_INTERVAL);
+    if (interval <= 0) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Background failover probing is disabled\n");
+        return EOK;
+    }
+
+    ret = be_ptask_create(be_ctx, be_ctx, interval, interval, interval,
+                          interval / 10, interval, 0,
+                          be_fo_probe_send, be_fo_probe_recv,
+                          NULL, "Failover probe",
+                          BE_PTASK_OFFLINE_SKIP | BE_PTASK_SCHEDULE_FROM_NOW,
+                          NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to initialize failover probe "
+              "periodic task [%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
+    return EOK;
+}
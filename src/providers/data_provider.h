@@ -268,6 +268,12 @@ enum dp_res_opts {
     DP_RES_OPT_RESOLVER_OP_TIMEOUT,
     DP_RES_OPT_RESOLVER_SERVER_TIMEOUT,
     DP_RES_OPT_DNS_DOMAIN,
+    DP_RES_OPT_FO_LATENCY_SELECTION,
+    DP_RES_OPT_FO_LATENCY_TOLERANCE,
+    DP_RES_OPT_FO_PROBE_INTERVAL,
+    DP_RES_OPT_FO_PROBE_SERVERS,
+    DP_RES_OPT_FO_PROBE_FAILURES,
+    DP_RES_OPT_FO_HOT_STANDBY,
 
     DP_RES_OPTS /* attrs counter */
 };
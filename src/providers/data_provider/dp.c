@@ -56,7 +56,8 @@ dp_init_interface(struct data_provider *provider)
         SBUS_METHODS(
             SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ListServices, dp_failover_list_services, provider->be_ctx),
             SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ListServers, dp_failover_list_servers, provider->be_ctx),
-            SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ActiveServer, dp_failover_active_server, provider->be_ctx)
+            SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ActiveServer, dp_failover_active_server, provider->be_ctx),
+            SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ServerLatency, dp_failover_server_latency, provider->be_ctx)
         ),
         SBUS_SIGNALS(SBUS_NO_SIGNALS),
         SBUS_PROPERTIES(SBUS_NO_PROPERTIES)
@@ -122,6 +123,9 @@ static int dp_destructor(struct data_provider *provider)
 
     provider->terminating = true;
 
+    /* Drop the binary IPC clients together with their requests. */
+    talloc_zfree(provider->ipc_server);
+
     dp_terminate_active_requests(provider);
 
     for (client = 0; client != DP_CLIENT_SENTINEL; client++) {
@@ -246,6 +250,13 @@ static void dp_init_done(struct tevent_req *subreq)
         goto done;
     }
 
+    ret = dp_access_cache_init(state->provider);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to initialize access cache "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        goto done;
+    }
+
     ret = dp_init_interface(state->provider);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to initialize DP interface "
@@ -253,6 +264,13 @@ static void dp_init_done(struct tevent_req *subreq)
         goto done;
     }
 
+    ret = dp_ipc_init(state->provider);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to initialize binary IPC "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        goto done;
+    }
+
 done:
     if (ret != EOK) {
         talloc_zfree(state->be_ctx->provider);
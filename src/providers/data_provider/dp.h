@@ -197,6 +197,17 @@ void dp_sbus_reset_groups_memcache(struct data_provider *provider);
 void dp_sbus_reset_initgr_memcache(struct data_provider *provider);
 void dp_sbus_invalidate_group_memcache(struct data_provider *provider,
                                        gid_t gid);
+void dp_sbus_invalidate_user_memcache(struct data_provider *provider,
+                                      uid_t uid);
+
+/*
+ * Drop all access control decisions cached by the data provider.
+ *
+ * Access providers must call this whenever the rules they evaluate change,
+ * e.g. after new HBAC rules were downloaded, so that the next account
+ * management request is evaluated against the new rules.
+ */
+void dp_access_cache_invalidate(struct data_provider *provider);
 
 /*
  * A dummy handler for DPM_ACCT_DOMAIN_HANDLER.
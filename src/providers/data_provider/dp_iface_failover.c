@@ -326,3 +326,38 @@ dp_failover_list_servers(TALLOC_CTX *mem_ctx,
 
     return EOK;
 }
+
+errno_t
+dp_failover_server_latency(TALLOC_CTX *mem_ctx,
+                           struct sbus_request *sbus_req,
+                           struct be_ctx *be_ctx,
+                           const char *service_name,
+                           const char ***_servers,
+                           uint32_t **_latency)
+{
+    struct be_svc_data *svc;
+    bool found = false;
+    errno_t ret;
+
+    DLIST_FOR_EACH(svc, be_ctx->be_fo->svcs) {
+        if (strcmp(svc->name, service_name) == 0) {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to get server latency\n");
+        return ENOENT;
+    }
+
+    ret = fo_svc_server_latency_list(sbus_req, svc->fo_service,
+                                     _servers, _latency);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to get server latency [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    return EOK;
+}
@@ -0,0 +1,383 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <talloc.h>
+#include <tevent.h>
+
+#include "config.h"
+#include "providers/data_provider/dp_private.h"
+#include "providers/data_provider/dp_iface.h"
+#include "providers/backend.h"
+#include "sss_iface/sss_iface_async.h"
+#include "sss_iface/sss_iface_ipc.h"
+#include "util/util.h"
+
+/* Binary IPC server, serves the account requests of the responders
+ * without going through sbus. See sss_iface_ipc.h for the protocol. */
+
+struct dp_ipc_server {
+    struct data_provider *provider;
+    char *path;
+    int fd;
+    struct tevent_fd *fde;
+};
+
+struct dp_ipc_client {
+    struct dp_ipc_server *server;
+    struct sss_ipc_conn *conn;
+};
+
+struct dp_ipc_call {
+    struct dp_ipc_client *client;
+    uint32_t serial;
+};
+
+static void dp_ipc_reply_error(struct dp_ipc_call *call, errno_t error)
+{
+    uint8_t *frame;
+    errno_t ret;
+
+    ret = sss_ipc_error_reply_encode(call, call->serial, error, &frame);
+    if (ret == EOK) {
+        ret = sss_ipc_conn_send(call->client->conn, frame);
+    }
+
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to send error reply [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    talloc_free(call);
+}
+
+static void dp_ipc_get_account_info_done(struct tevent_req *subreq)
+{
+    struct sss_ipc_account_reply reply;
+    struct dp_ipc_call *call;
+    uint8_t *frame;
+    errno_t ret;
+
+    call = tevent_req_callback_data(subreq, struct dp_ipc_call);
+
+    ret = dp_get_account_info_recv(call, subreq, &reply.dp_error,
+                                   &reply.error, &reply.error_message);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        dp_ipc_reply_error(call, ret);
+        return;
+    }
+
+    ret = sss_ipc_account_reply_encode(call, call->serial, &reply, &frame);
+    if (ret != EOK) {
+        dp_ipc_reply_error(call, ret);
+        return;
+    }
+
+    ret = sss_ipc_conn_send(call->client->conn, frame);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to send reply [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    talloc_free(call);
+}
+
+static void dp_ipc_client_message(struct sss_ipc_conn *conn,
+                                  uint32_t type,
+                                  uint32_t serial,
+                                  uint8_t *frame,
+                                  uint8_t *body,
+                                  size_t body_len,
+                                  void *pvt)
+{
+    struct sss_ipc_account_req msg;
+    struct data_provider *provider;
+    struct dp_ipc_client *client;
+    struct dp_ipc_call *call;
+    struct tevent_req *subreq;
+    errno_t ret;
+
+    client = talloc_get_type(pvt, struct dp_ipc_client);
+    provider = client->server->provider;
+
+    call = talloc_zero(client, struct dp_ipc_call);
+    if (call == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Out of memory!\n");
+        talloc_free(frame);
+        talloc_free(client);
+        return;
+    }
+
+    call->client = client;
+    call->serial = serial;
+
+    /* The decoded strings point into the frame. */
+    talloc_steal(call, frame);
+
+    if (type != SSS_IPC_GET_ACCOUNT_INFO) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unsupported message type %"PRIu32"\n",
+              type);
+        dp_ipc_reply_error(call, EOPNOTSUPP);
+        return;
+    }
+
+    ret = sss_ipc_account_req_decode(body, body_len, &msg);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Malformed account request\n");
+        dp_ipc_reply_error(call, ret);
+        return;
+    }
+
+    /* sbus delivers NULL strings as empty strings, keep it that way */
+    subreq = dp_get_account_info_send(call, provider->ev, NULL, provider,
+                                      msg.dp_flags, msg.entry_type,
+                                      msg.filter == NULL ? "" : msg.filter,
+                                      msg.domain == NULL ? "" : msg.domain,
+                                      msg.extra == NULL ? "" : msg.extra);
+    if (subreq == NULL) {
+        dp_ipc_reply_error(call, ENOMEM);
+        return;
+    }
+
+    tevent_req_set_callback(subreq, dp_ipc_get_account_info_done, call);
+}
+
+static void dp_ipc_client_close(struct sss_ipc_conn *conn, void *pvt)
+{
+    struct dp_ipc_client *client;
+
+    client = talloc_get_type(pvt, struct dp_ipc_client);
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Binary IPC client disconnected\n");
+
+    /* Pending requests are children of the client. */
+    talloc_free(client);
+}
+
+static bool dp_ipc_client_allowed(struct dp_ipc_server *server, int fd)
+{
+    struct ucred ucred;
+    socklen_t len;
+    int ret;
+
+    len = sizeof(ucred);
+    ret = getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &ucred, &len);
+    if (ret != 0) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "getsockopt failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return false;
+    }
+
+    /* Same rule as for the sbus server: root or our own user. */
+    if (ucred.uid != 0 && ucred.uid != server->provider->uid) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Client with uid %"SPRIuid" is not "
+              "allowed to connect\n", ucred.uid);
+        return false;
+    }
+
+    return true;
+}
+
+static void dp_ipc_server_accept(struct tevent_context *ev,
+                                 struct tevent_fd *fde,
+                                 uint16_t flags,
+                                 void *pvt)
+{
+    struct dp_ipc_server *server;
+    struct dp_ipc_client *client;
+    int fd;
+    int ret;
+
+    server = talloc_get_type(pvt, struct dp_ipc_server);
+
+    fd = accept(server->fd, NULL, NULL);
+    if (fd == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_OP_FAILURE, "accept failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return;
+    }
+
+    if (!dp_ipc_client_allowed(server, fd)) {
+        close(fd);
+        return;
+    }
+
+    client = talloc_zero(server, struct dp_ipc_client);
+    if (client == NULL) {
+        close(fd);
+        return;
+    }
+
+    client->server = server;
+    client->conn = sss_ipc_conn_create(client, ev, fd,
+                                       dp_ipc_client_message,
+                                       dp_ipc_client_close, client);
+    if (client->conn == NULL) {
+        talloc_free(client);
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Binary IPC client connected\n");
+}
+
+static int dp_ipc_server_destructor(struct dp_ipc_server *server)
+{
+    talloc_zfree(server->fde);
+
+    if (server->fd != -1) {
+        close(server->fd);
+        unlink(server->path);
+    }
+
+    return 0;
+}
+
+static errno_t dp_ipc_server_listen(struct dp_ipc_server *server)
+{
+    struct sockaddr_un addr;
+    mode_t orig_umask;
+    errno_t ret;
+
+    if (strlen(server->path) >= sizeof(addr.sun_path)) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Socket path is too long [%s]\n",
+              server->path);
+        return EINVAL;
+    }
+
+    server->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (server->fd == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "socket failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    ret = sss_fd_nonblocking(server->fd);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, server->path, sizeof(addr.sun_path) - 1);
+
+    /* A stale socket from a previous run. */
+    if (unlink(server->path) != 0 && errno != ENOENT) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to remove [%s] [%d]: %s\n",
+              server->path, ret, sss_strerror(ret));
+        return ret;
+    }
+
+    orig_umask = umask(0177);
+    ret = bind(server->fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(orig_umask);
+    if (ret != 0) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to bind [%s] [%d]: %s\n",
+              server->path, ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (server->provider->uid != geteuid()
+            || server->provider->gid != getegid()) {
+        ret = chown(server->path, server->provider->uid,
+                    server->provider->gid);
+        if (ret != 0) {
+            ret = errno;
+            DEBUG(SSSDBG_CRIT_FAILURE, "chown failed for [%s] [%d]: %s\n",
+                  server->path, ret, sss_strerror(ret));
+            return ret;
+        }
+    }
+
+    ret = listen(server->fd, 128);
+    if (ret != 0) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to listen [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t dp_ipc_init(struct data_provider *provider)
+{
+    struct dp_ipc_server *server;
+    bool enabled;
+    errno_t ret;
+
+    ret = confdb_get_bool(provider->be_ctx->cdb, CONFDB_MONITOR_CONF_ENTRY,
+                          CONFDB_MONITOR_DP_BINARY_IPC, false, &enabled);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to read %s [%d]: %s\n",
+              CONFDB_MONITOR_DP_BINARY_IPC, ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (!enabled) {
+        return EOK;
+    }
+
+    server = talloc_zero(provider, struct dp_ipc_server);
+    if (server == NULL) {
+        return ENOMEM;
+    }
+
+    server->provider = provider;
+    server->fd = -1;
+    talloc_set_destructor(server, dp_ipc_server_destructor);
+
+    server->path = sss_iface_domain_ipc_path(server, provider->be_ctx->domain);
+    if (server->path == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = dp_ipc_server_listen(server);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    server->fde = tevent_add_fd(provider->ev, server, server->fd,
+                                TEVENT_FD_READ, dp_ipc_server_accept, server);
+    if (server->fde == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    DEBUG(SSSDBG_CONF_SETTINGS, "Binary IPC listening on [%s]\n",
+          server->path);
+
+    provider->ipc_server = server;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(server);
+    }
+
+    return ret;
+}
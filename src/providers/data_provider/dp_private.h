@@ -73,6 +73,8 @@ struct dp_method {
     uint32_t output_size;
 };
 
+struct dp_ipc_server;
+
 struct data_provider {
     uid_t uid;
     gid_t gid;
@@ -80,6 +82,7 @@ struct data_provider {
     struct tevent_context *ev;
     struct sbus_server *sbus_server;
     struct sbus_connection *sbus_conn;
+    struct dp_ipc_server *ipc_server;
     struct dp_client *clients[DP_CLIENT_SENTINEL];
     bool terminating;
 
@@ -94,6 +97,16 @@ struct data_provider {
 
     struct dp_module **modules;
     struct dp_target **targets;
+
+    struct {
+        /* Lifetime of a cached decision, the cache is disabled if 0. */
+        uint32_t timeout;
+
+        /* Bumped each time the access rules change. */
+        uint32_t generation;
+
+        hash_table_t *table;
+    } access_cache;
 };
 
 errno_t dp_find_method(struct data_provider *provider,
@@ -101,6 +114,8 @@ errno_t dp_find_method(struct data_provider *provider,
                        enum dp_methods method,
                        struct dp_method **_execute);
 
+const char *dp_method_to_string(enum dp_methods method);
+
 struct dp_module *dp_load_module(TALLOC_CTX *mem_ctx,
                                  struct be_ctx *be_ctx,
                                  struct data_provider *provider,
@@ -132,4 +147,12 @@ struct data_provider *dp_client_provider(struct dp_client *dp_cli);
 struct be_ctx *dp_client_be(struct dp_client *dp_cli);
 struct sbus_connection *dp_client_conn(struct dp_client *dp_cli);
 
+/* Cache of successful access control decisions. */
+
+errno_t dp_access_cache_init(struct data_provider *provider);
+
+/* Binary IPC server, only started when dp_binary_ipc is enabled. */
+
+errno_t dp_ipc_init(struct data_provider *provider);
+
 #endif /* _DP_PRIVATE_H_ */
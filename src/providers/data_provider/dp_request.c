@@ -27,6 +27,7 @@
 #include "util/dlinklist.h"
 #include "util/util.h"
 #include "util/probes.h"
+#include "util/sss_metrics.h"
 
 struct dp_req {
     struct data_provider *provider;
@@ -39,6 +40,7 @@ struct dp_req {
     struct dp_method *execute;
     const char *name;
     uint32_t num;
+    uint64_t start;
 
     struct tevent_req *req;
     struct tevent_req *handler_req;
@@ -157,6 +159,7 @@ dp_req_new(TALLOC_CTX *mem_ctx,
     dp_req->method = method;
     dp_req->request_data = request_data;
     dp_req->req = req;
+    dp_req->start = sss_metrics_now();
 
     ret = dp_attach_req(dp_req, provider, name, dp_flags);
     if (ret != EOK) {
@@ -362,6 +365,11 @@ static void dp_req_done(struct tevent_req *subreq)
     PROBE(DP_REQ_DONE, state->dp_req->name, state->dp_req->target,
           state->dp_req->method, ret, sss_strerror(ret));
 
+    sss_metrics_observe(SSS_METRICS_DP_REQ_DURATION,
+                        dp_target_to_string(state->dp_req->target),
+                        dp_method_to_string(state->dp_req->method),
+                        state->dp_req->start);
+
     DP_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->dp_req->name,
                  "Request handler finished [%d]: %s", ret, sss_strerror(ret));
 
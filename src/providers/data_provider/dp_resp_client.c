@@ -273,3 +273,30 @@ void dp_sbus_invalidate_group_memcache(struct data_provider *provider,
 
     return;
 }
+
+void dp_sbus_invalidate_user_memcache(struct data_provider *provider,
+                                      uid_t uid)
+{
+    struct tevent_req *subreq;
+
+    if (provider == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "No provider pointer\n");
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC,
+          "Ordering NSS responder to invalidate the user %"PRIu32" \n",
+          uid);
+
+    subreq = sbus_call_nss_memcache_InvalidateUserById_send(provider,
+                 provider->sbus_conn, SSS_BUS_NSS, SSS_BUS_PATH,
+                 (uint32_t)uid);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+        return;
+    }
+
+    tevent_req_set_callback(subreq, sbus_unwanted_reply, NULL);
+
+    return;
+}
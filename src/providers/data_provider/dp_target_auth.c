@@ -24,6 +24,7 @@
 #include <security/pam_modules.h>
 
 #include "sbus/sbus_request.h"
+#include "confdb/confdb.h"
 #include "providers/data_provider/dp_private.h"
 #include "providers/data_provider/dp_iface.h"
 #include "providers/backend.h"
@@ -127,14 +128,265 @@ static bool should_invoke_selinux(struct data_provider *provider,
     return false;
 }
 
+struct dp_access_cache_entry {
+    struct data_provider *provider;
+    char *key;
+    uint32_t generation;
+};
+
+errno_t dp_access_cache_init(struct data_provider *provider)
+{
+    struct be_ctx *be_ctx = provider->be_ctx;
+    int timeout;
+    errno_t ret;
+
+    ret = confdb_get_int(be_ctx->cdb, be_ctx->conf_path,
+                         CONFDB_DOMAIN_ACCESS_DECISION_CACHE_TIMEOUT,
+                         0, &timeout);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to read %s [%d]: %s\n",
+              CONFDB_DOMAIN_ACCESS_DECISION_CACHE_TIMEOUT,
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (timeout <= 0) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Access decision cache is disabled.\n");
+        provider->access_cache.timeout = 0;
+        return EOK;
+    }
+
+    ret = sss_hash_create(provider, 0, &provider->access_cache.table);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create access cache "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
+    provider->access_cache.timeout = timeout;
+
+    DEBUG(SSSDBG_CONF_SETTINGS, "Access decisions are cached for %d "
+          "seconds.\n", timeout);
+
+    return EOK;
+}
+
+void dp_access_cache_invalidate(struct data_provider *provider)
+{
+    if (provider == NULL || provider->access_cache.table == NULL) {
+        return;
+    }
+
+    /* Entries of older generations are ignored and removed on lookup or
+     * when they expire. */
+    provider->access_cache.generation++;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Access decision cache invalidated.\n");
+}
+
+/* The decision of all access providers only depends on the user, the
+ * service and the remote host, the local host is always the same. */
+static char *dp_access_cache_key(TALLOC_CTX *mem_ctx,
+                                 struct pam_data *pd)
+{
+    const char *service;
+
+    if (pd->domain == NULL || pd->user == NULL) {
+        return NULL;
+    }
+
+    service = pd->service != NULL ? pd->service : "";
+
+    return talloc_asprintf(mem_ctx, "%zu:%s:%zu:%s:%zu:%s:%s",
+                           strlen(pd->domain), pd->domain,
+                           strlen(pd->user), pd->user,
+                           strlen(service), service,
+                           pd->rhost != NULL ? pd->rhost : "");
+}
+
+static void dp_access_cache_remove(struct data_provider *provider,
+                                   const char *key)
+{
+    struct dp_access_cache_entry *entry;
+    hash_key_t hkey;
+    hash_value_t val;
+    int hret;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+
+    hret = hash_lookup(provider->access_cache.table, &hkey, &val);
+    if (hret != HASH_SUCCESS) {
+        return;
+    }
+
+    entry = talloc_get_type(val.ptr, struct dp_access_cache_entry);
+
+    hret = hash_delete(provider->access_cache.table, &hkey);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Could not remove [%s] from access cache: [%s]\n",
+              key, hash_error_string(hret));
+    }
+
+    talloc_free(entry);
+}
+
+static void dp_access_cache_expire(struct tevent_context *ev,
+                                   struct tevent_timer *te,
+                                   struct timeval tv,
+                                   void *pvt)
+{
+    struct dp_access_cache_entry *entry;
+
+    entry = talloc_get_type(pvt, struct dp_access_cache_entry);
+
+    dp_access_cache_remove(entry->provider, entry->key);
+}
+
+static bool dp_access_cache_lookup(struct data_provider *provider,
+                                   struct pam_data *pd)
+{
+    struct dp_access_cache_entry *entry;
+    hash_key_t hkey;
+    hash_value_t val;
+    bool found = false;
+    char *key;
+    int hret;
+
+    if (provider->access_cache.table == NULL || pd->cmd != SSS_PAM_ACCT_MGMT) {
+        return false;
+    }
+
+    key = dp_access_cache_key(NULL, pd);
+    if (key == NULL) {
+        return false;
+    }
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = key;
+
+    hret = hash_lookup(provider->access_cache.table, &hkey, &val);
+    if (hret != HASH_SUCCESS) {
+        goto done;
+    }
+
+    entry = talloc_get_type(val.ptr, struct dp_access_cache_entry);
+    if (entry->generation != provider->access_cache.generation) {
+        DEBUG(SSSDBG_TRACE_INTERNAL, "Access rules changed since [%s] was "
+              "cached.\n", key);
+        dp_access_cache_remove(provider, key);
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Access for [%s] found in access cache.\n", key);
+    found = true;
+
+done:
+    talloc_free(key);
+    return found;
+}
+
+static void dp_access_cache_store(struct data_provider *provider,
+                                  struct pam_data *pd,
+                                  uint32_t generation)
+{
+    struct dp_access_cache_entry *entry;
+    struct tevent_timer *te;
+    struct timeval tv;
+    hash_key_t hkey;
+    hash_value_t val;
+    int hret;
+
+    if (provider->access_cache.table == NULL || pd->cmd != SSS_PAM_ACCT_MGMT) {
+        return;
+    }
+
+    /* Only plain grants are cached. A denial must be re-evaluated as soon
+     * as the account is fixed and messages for the user (e.g. an upcoming
+     * password expiration) must not be lost. */
+    if (pd->pam_status != PAM_SUCCESS || pd->resp_list != NULL) {
+        return;
+    }
+
+    entry = talloc_zero(provider->access_cache.table,
+                        struct dp_access_cache_entry);
+    if (entry == NULL) {
+        return;
+    }
+
+    entry->provider = provider;
+    entry->generation = generation;
+
+    entry->key = dp_access_cache_key(entry, pd);
+    if (entry->key == NULL) {
+        goto fail;
+    }
+
+    /* a newer decision replaces the old one */
+    dp_access_cache_remove(provider, entry->key);
+
+    tv = tevent_timeval_current_ofs(provider->access_cache.timeout, 0);
+    te = tevent_add_timer(provider->ev, entry, tv,
+                          dp_access_cache_expire, entry);
+    if (te == NULL) {
+        goto fail;
+    }
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = entry->key;
+    val.type = HASH_VALUE_PTR;
+    val.ptr = entry;
+
+    hret = hash_enter(provider->access_cache.table, &hkey, &val);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Could not add [%s] to access cache: [%s]\n",
+              entry->key, hash_error_string(hret));
+        goto fail;
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "[%s] added to access cache.\n", entry->key);
+
+    return;
+
+fail:
+    talloc_free(entry);
+}
+
 struct dp_pam_handler_state {
     struct data_provider *provider;
     struct pam_data *pd;
+    uint32_t access_generation;
 };
 
 static void dp_pam_handler_auth_done(struct tevent_req *subreq);
 static void dp_pam_handler_done(struct tevent_req *subreq);
 
+static errno_t dp_pam_handler_selinux(struct tevent_req *req)
+{
+    struct dp_pam_handler_state *state;
+    struct tevent_req *subreq;
+
+    state = tevent_req_data(req, struct dp_pam_handler_state);
+
+    if (!should_invoke_selinux(state->provider, state->pd)) {
+        return EOK;
+    }
+
+    subreq = dp_req_send(state, state->provider, state->pd->domain,
+                         "PAM SELinux", DPT_SELINUX, DPM_SELINUX_HANDLER,
+                         0, state->pd, NULL);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, dp_pam_handler_done, req);
+
+    return EAGAIN;
+}
+
 struct tevent_req *
 dp_pam_handler_send(TALLOC_CTX *mem_ctx,
                     struct tevent_context *ev,
@@ -167,6 +419,7 @@ dp_pam_handler_send(TALLOC_CTX *mem_ctx,
 
     state->provider = provider;
     state->pd = pd;
+    state->access_generation = provider->access_cache.generation;
 
     DEBUG(SSSDBG_CONF_SETTINGS, "Got request with the following data\n");
     DEBUG_PAM_DATA(SSSDBG_CONF_SETTINGS, pd);
@@ -177,6 +430,14 @@ dp_pam_handler_send(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    if (target == DPT_ACCESS && dp_access_cache_lookup(provider, pd)) {
+        /* Only the access check is cached, the SELinux context is
+         * still updated on every login. */
+        pd->pam_status = PAM_SUCCESS;
+        ret = dp_pam_handler_selinux(req);
+        goto done;
+    }
+
     subreq = dp_req_send(state, provider, pd->domain, req_name, target,
                          method, 0, pd, NULL);
     if (subreq == NULL) {
@@ -217,21 +478,17 @@ static void dp_pam_handler_auth_done(struct tevent_req *subreq)
         return;
     }
 
-    if (!should_invoke_selinux(state->provider, state->pd)) {
-        tevent_req_done(req);
-        return;
-    }
+    /* Store the decision before the SELinux handler adds its own
+     * responses, it is not part of the cached access check. */
+    dp_access_cache_store(state->provider, state->pd,
+                          state->access_generation);
 
-    subreq = dp_req_send(state, state->provider, state->pd->domain,
-                         "PAM SELinux", DPT_SELINUX, DPM_SELINUX_HANDLER,
-                         0, state->pd, NULL);
-    if (subreq == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
-        tevent_req_error(req, ENOMEM);
-        return;
+    ret = dp_pam_handler_selinux(req);
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
     }
-
-    tevent_req_set_callback(subreq, dp_pam_handler_done, req);
 }
 
 static void dp_pam_handler_done(struct tevent_req *subreq)
@@ -45,6 +45,7 @@
 #include "providers/be_refresh.h"
 #include "providers/be_ptask.h"
 #include "util/child_common.h"
+#include "util/sss_hash_pool.h"
 #include "resolv/async_resolv.h"
 #include "sss_iface/sss_iface_async.h"
 
@@ -534,6 +535,12 @@ errno_t be_process_init(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    ret = be_fo_probe_init(be_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Unable to initialize failover probe\n");
+        goto done;
+    }
+
     ret = sssd_domain_init(be_ctx, cdb, be_domain, DB_PATH, &be_ctx->domain);
     if (ret != EOK) {
         DEBUG(SSSDBG_FATAL_FAILURE, "Unable to initialize domain\n");
@@ -586,6 +593,16 @@ errno_t be_process_init(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    if (be_ctx->domain->cache_credentials) {
+        ret = sss_hash_pool_init(be_ctx, be_ctx->ev, 0, &be_ctx->hash_pool);
+        if (ret != EOK) {
+            /* not fatal, the hashes are computed in the main loop then */
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Unable to start password hashing threads [%d]: %s\n",
+                  ret, sss_strerror(ret));
+        }
+    }
+
     be_ctx->sbus_name = sss_iface_domain_bus(be_ctx, be_ctx->domain);
     if (be_ctx->sbus_name == NULL) {
         DEBUG(SSSDBG_FATAL_FAILURE, "Could not get sbus backend name.\n");
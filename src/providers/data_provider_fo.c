@@ -44,15 +44,40 @@ int be_fo_is_srv_identifier(const char *server)
 static int be_fo_get_options(struct be_ctx *ctx,
                              struct fo_options *opts)
 {
+    int tolerance;
+    int probe_failures;
+
     opts->service_resolv_timeout = dp_opt_get_int(ctx->be_res->opts,
                                                   DP_RES_OPT_RESOLVER_TIMEOUT);
     opts->retry_timeout = 30;
     opts->srv_retry_neg_timeout = 15;
     opts->family_order = ctx->be_res->family_order;
+    opts->latency_selection = dp_opt_get_bool(ctx->be_res->opts,
+                                              DP_RES_OPT_FO_LATENCY_SELECTION);
+    tolerance = dp_opt_get_int(ctx->be_res->opts,
+                               DP_RES_OPT_FO_LATENCY_TOLERANCE);
+    if (tolerance < 0) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Negative value of "
+              "failover_latency_tolerance is not allowed, using 0 instead\n");
+        tolerance = 0;
+    }
+    opts->latency_tolerance = tolerance;
+    probe_failures = dp_opt_get_int(ctx->be_res->opts,
+                                    DP_RES_OPT_FO_PROBE_FAILURES);
+    if (probe_failures < 1) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "failover_probe_failures must be at "
+              "least 1, using 1 instead\n");
+        probe_failures = 1;
+    }
+    opts->probe_failures = probe_failures;
 
     return EOK;
 }
 
+static void be_fo_latency_probe(const char *service_name,
+                                struct fo_server *server,
+                                void *pvt);
+
 int be_init_failover(struct be_ctx *ctx)
 {
     int ret;
@@ -88,6 +113,11 @@ int be_init_failover(struct be_ctx *ctx)
         return ENOMEM;
     }
 
+    fo_set_latency_probe_plugin(ctx->be_fo->fo_ctx, be_fo_latency_probe, ctx);
+
+    ctx->be_fo->hot_standby = dp_opt_get_bool(ctx->be_res->opts,
+                                              DP_RES_OPT_FO_HOT_STANDBY);
+
     return EOK;
 }
 
@@ -127,6 +157,72 @@ static struct be_svc_data *be_fo_find_svc_data(struct be_ctx *ctx,
     return 0;
 }
 
+struct be_fo_latency_probe_state {
+    struct be_svc_data *svc;
+    struct fo_server *server;
+};
+
+static void be_fo_latency_probe_done(struct tevent_req *subreq);
+
+/* The probe plugins record the latency of the server themselves. */
+static void be_fo_latency_probe(const char *service_name,
+                                struct fo_server *server,
+                                void *pvt)
+{
+    struct be_ctx *ctx = talloc_get_type(pvt, struct be_ctx);
+    struct be_fo_latency_probe_state *state;
+    struct be_svc_data *svc;
+    struct tevent_req *subreq;
+
+    svc = be_fo_find_svc_data(ctx, service_name);
+    if (svc == NULL || svc->probe_send_fn == NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Service %s has no probe plugin, latency "
+              "of server %s will be measured on the next connection\n",
+              service_name, fo_get_server_str_name(server));
+        return;
+    }
+
+    state = talloc_zero(ctx, struct be_fo_latency_probe_state);
+    if (state == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "talloc_zero() failed\n");
+        return;
+    }
+
+    state->svc = svc;
+    state->server = server;
+    fo_ref_server(state, server);
+
+    subreq = svc->probe_send_fn(state, ctx->ev, ctx, svc->name, server,
+                                svc->probe_pvt);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to probe server %s of service %s\n",
+              fo_get_server_str_name(server), svc->name);
+        talloc_free(state);
+        return;
+    }
+
+    tevent_req_set_callback(subreq, be_fo_latency_probe_done, state);
+}
+
+static void be_fo_latency_probe_done(struct tevent_req *subreq)
+{
+    struct be_fo_latency_probe_state *state;
+    errno_t ret;
+
+    state = tevent_req_callback_data(subreq, struct be_fo_latency_probe_state);
+
+    ret = state->svc->probe_recv_fn(subreq);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to measure latency of server %s "
+              "of service %s [%d]: %s\n",
+              fo_get_server_str_name(state->server), state->svc->name,
+              ret, sss_strerror(ret));
+    }
+
+    talloc_free(state);
+}
+
 int be_fo_add_service(struct be_ctx *ctx, const char *service_name,
                       datacmp_fn user_data_cmp)
 {
@@ -265,6 +361,61 @@ errno_t be_fo_set_dns_srv_lookup_plugin(struct be_ctx *be_ctx,
     return EOK;
 }
 
+errno_t be_fo_set_probe_plugin(struct be_ctx *ctx,
+                               const char *service_name,
+                               be_fo_probe_send_t send_fn,
+                               be_fo_probe_recv_t recv_fn,
+                               void *pvt,
+                               enum be_fo_probe_priority priority,
+                               const char *plugin_name)
+{
+    struct be_svc_data *svc;
+
+    svc = be_fo_find_svc_data(ctx, service_name);
+    if (svc == NULL) {
+        return ENOENT;
+    }
+
+    if (svc->probe_send_fn != NULL) {
+        if (svc->probe_priority > priority) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Service %s already has a more "
+                  "specific probe plugin, not using %s\n",
+                  service_name, plugin_name);
+            return EEXIST;
+        }
+
+        DEBUG(SSSDBG_TRACE_FUNC, "Replacing probe plugin of service %s\n",
+              service_name);
+    }
+
+    svc->probe_send_fn = send_fn;
+    svc->probe_recv_fn = recv_fn;
+    svc->probe_pvt = pvt;
+    svc->probe_priority = priority;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Probe plugin of service %s is now %s\n",
+          service_name, plugin_name);
+
+    return EOK;
+}
+
+void be_fo_unset_probe_plugin(struct be_ctx *ctx,
+                              const char *service_name,
+                              void *pvt)
+{
+    struct be_svc_data *svc;
+
+    svc = be_fo_find_svc_data(ctx, service_name);
+    if (svc == NULL || svc->probe_pvt != pvt) {
+        return;
+    }
+
+    svc->probe_send_fn = NULL;
+    svc->probe_recv_fn = NULL;
+    svc->probe_pvt = NULL;
+    svc->probe_priority = BE_FO_PROBE_PRIORITY_GENERIC;
+}
+
 int be_fo_add_srv_server(struct be_ctx *ctx,
                          const char *service_name,
                          const char *query_service,
@@ -830,6 +981,37 @@ void _be_fo_set_port_status(struct be_ctx *ctx,
     }
 }
 
+void be_fo_set_server_latency(struct be_ctx *ctx,
+                              const char *service_name,
+                              struct fo_server *server,
+                              enum fo_latency_type type,
+                              struct timeval start)
+{
+    struct be_svc_data *be_svc;
+    struct timeval elapsed;
+    struct timeval now;
+    uint64_t usec;
+
+    be_svc = be_fo_find_svc_data(ctx, service_name);
+    if (be_svc == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "No service associated with name %s\n", service_name);
+        return;
+    }
+
+    if (!fo_svc_has_server(be_svc->fo_service, server)) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "The server %p is not valid anymore, cannot set its latency\n",
+               server);
+        return;
+    }
+
+    now = tevent_timeval_current();
+    elapsed = tevent_timeval_until(&start, &now);
+    usec = (uint64_t) elapsed.tv_sec * 1000000 + elapsed.tv_usec;
+    fo_set_server_latency(server, type, usec > UINT32_MAX ? UINT32_MAX : usec);
+}
+
 /* Resolver back end interface */
 static struct dp_option dp_res_default_opts[] = {
     { "lookup_family_order", DP_OPT_STRING, { "ipv4_first" }, NULL_STRING },
@@ -837,6 +1019,12 @@ static struct dp_option dp_res_default_opts[] = {
     { "dns_resolver_op_timeout", DP_OPT_NUMBER, { .number = 3 }, NULL_NUMBER },
     { "dns_resolver_server_timeout", DP_OPT_NUMBER, { .number = 1000 }, NULL_NUMBER },
     { "dns_discovery_domain", DP_OPT_STRING, NULL_STRING, NULL_STRING },
+    { "failover_latency_selection", DP_OPT_BOOL, BOOL_FALSE, BOOL_FALSE },
+    { "failover_latency_tolerance", DP_OPT_NUMBER, { .number = 20 }, NULL_NUMBER },
+    { "failover_probe_interval", DP_OPT_NUMBER, { .number = 0 }, NULL_NUMBER },
+    { "failover_probe_servers", DP_OPT_NUMBER, { .number = 2 }, NULL_NUMBER },
+    { "failover_probe_failures", DP_OPT_NUMBER, { .number = 2 }, NULL_NUMBER },
+    { "failover_hot_standby", DP_OPT_BOOL, BOOL_FALSE, BOOL_FALSE },
     DP_OPTION_TERMINATOR
 };
 
@@ -43,6 +43,9 @@
 #define DEFAULT_SERVER_STATUS SERVER_NAME_NOT_RESOLVED
 #define DEFAULT_SRV_STATUS SRV_NEUTRAL
 
+/* Weight of a new latency sample is 1/2^FO_LATENCY_EWMA_SHIFT */
+#define FO_LATENCY_EWMA_SHIFT 2
+
 enum srv_lookup_status {
     SRV_NEUTRAL,        /* We didn't try this SRV lookup yet */
     SRV_RESOLVED,       /* This SRV lookup is resolved       */
@@ -59,6 +62,9 @@ struct fo_ctx {
     fo_srv_lookup_plugin_send_t srv_send_fn;
     fo_srv_lookup_plugin_recv_t srv_recv_fn;
     void *srv_pvt;
+
+    fo_latency_probe_fn latency_probe_fn;
+    void *latency_probe_pvt;
 };
 
 struct fo_service {
@@ -78,6 +84,11 @@ struct fo_service {
     datacmp_fn user_data_cmp;
 };
 
+struct fo_latency {
+    uint32_t connect;
+    uint32_t response;
+};
+
 struct fo_server {
     REFCOUNT_COMMON;
 
@@ -85,6 +96,8 @@ struct fo_server {
     struct fo_server *next;
 
     bool primary;
+    /* SRV priority, always 0 for servers that are not from SRV lookup */
+    unsigned short priority;
     void *user_data;
     int port;
     enum port_status port_status;
@@ -92,6 +105,11 @@ struct fo_server {
     struct fo_service *service;
     struct timeval last_status_change;
     struct server_common *common;
+    struct fo_latency latency;
+    /* consecutive failed background probes */
+    unsigned int probe_failures;
+    /* when the latency of the server was last requested to be probed */
+    struct timeval latency_probe_time;
 
     TALLOC_CTX *fo_internal_owner;
 };
@@ -159,6 +177,9 @@ fo_context_init(TALLOC_CTX *mem_ctx, struct fo_options *opts)
     ctx->opts->retry_timeout = opts->retry_timeout;
     ctx->opts->family_order  = opts->family_order;
     ctx->opts->service_resolv_timeout = opts->service_resolv_timeout;
+    ctx->opts->latency_selection = opts->latency_selection;
+    ctx->opts->latency_tolerance = opts->latency_tolerance;
+    ctx->opts->probe_failures = opts->probe_failures;
 
     DEBUG(SSSDBG_TRACE_FUNC,
           "Created new fail over context, retry timeout is %ld\n",
@@ -570,6 +591,11 @@ fo_server_alloc(struct fo_service *service, int port,
     server->srv_data = NULL;
     server->last_status_change.tv_sec = 0;
     server->last_status_change.tv_usec = 0;
+    server->latency.connect = 0;
+    server->latency.response = 0;
+    server->latency_probe_time.tv_sec = 0;
+    server->latency_probe_time.tv_usec = 0;
+    server->priority = 0;
 
     server->port = port;
     server->user_data = user_data;
@@ -817,6 +843,7 @@ static errno_t fo_add_server_list(struct fo_service *service,
         }
 
         server->srv_data = srv_data;
+        server->priority = servers[i].priority;
 
         ret = fo_add_server_to_list(&srv_list, service->server_list,
                                     server, service->name);
@@ -869,6 +896,114 @@ void fo_ref_server(TALLOC_CTX *ref_ctx,
     }
 }
 
+static bool
+fo_server_same_class(struct fo_server *s1, struct fo_server *s2)
+{
+    return s1->primary == s2->primary && s1->priority == s2->priority;
+}
+
+/* Return true if latency of 'fast' is lower than latency of 'slow' by more
+ * than the configured tolerance. Servers without any recorded latency are
+ * never considered faster or slower. */
+static bool
+fo_server_is_faster(struct fo_server *fast, struct fo_server *slow)
+{
+    uint64_t fast_latency;
+    uint64_t slow_latency;
+
+    fast_latency = fo_get_server_latency(fast);
+    slow_latency = fo_get_server_latency(slow);
+    if (fast_latency == 0 || slow_latency == 0) {
+        return false;
+    }
+
+    fast_latency *= 100 + fast->service->ctx->opts->latency_tolerance;
+    slow_latency *= 100;
+
+    return fast_latency < slow_latency;
+}
+
+/*
+ * Servers without recorded latency are never considered faster, so they
+ * would never be preferred unless somebody connects to them. Ask for their
+ * latency to be measured, at most once per retry timeout.
+ */
+static void
+fo_probe_unmeasured_peers(struct fo_server *server)
+{
+    struct fo_ctx *ctx = server->service->ctx;
+    struct fo_server *peer;
+    struct timeval tv;
+
+    if (ctx->latency_probe_fn == NULL) {
+        return;
+    }
+
+    gettimeofday(&tv, NULL);
+
+    DLIST_FOR_EACH(peer, server->service->server_list) {
+        if (peer == server || !fo_server_same_class(peer, server)
+                || fo_get_server_latency(peer) != 0
+                || fo_get_server_name(peer) == NULL
+                || !service_works(peer)) {
+            continue;
+        }
+
+        if (peer->latency_probe_time.tv_sec != 0
+                && tv.tv_sec - peer->latency_probe_time.tv_sec
+                       <= ctx->opts->retry_timeout) {
+            continue;
+        }
+
+        DEBUG(SSSDBG_TRACE_FUNC, "Latency of server '%s' of service '%s' "
+              "is not known yet, probing it\n",
+              SERVER_NAME(peer), server->service->name);
+
+        peer->latency_probe_time = tv;
+        ctx->latency_probe_fn(server->service->name, peer,
+                              ctx->latency_probe_pvt);
+    }
+}
+
+/*
+ * Return the fastest working server from the same priority class as
+ * 'server'. If 'server' does not have any latency recorded yet, it is
+ * returned so its latency gets measured. Peers without recorded latency
+ * are probed so they can be preferred next time.
+ */
+static struct fo_server *
+get_fastest_peer(struct fo_server *server)
+{
+    struct fo_server *fastest = server;
+    struct fo_server *peer;
+
+    fo_probe_unmeasured_peers(server);
+
+    if (fo_get_server_latency(server) == 0) {
+        return server;
+    }
+
+    DLIST_FOR_EACH(peer, server->service->server_list) {
+        if (peer == fastest || !fo_server_same_class(peer, server)) {
+            continue;
+        }
+
+        if (fo_server_is_faster(peer, fastest) && service_works(peer)) {
+            fastest = peer;
+        }
+    }
+
+    if (fastest != server) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Preferring server '%s' [%"PRIu32" us] "
+              "over server '%s' [%"PRIu32" us] for service '%s'\n",
+              SERVER_NAME(fastest), fo_get_server_latency(fastest),
+              SERVER_NAME(server), fo_get_server_latency(server),
+              server->service->name);
+    }
+
+    return fastest;
+}
+
 static int
 get_first_server_entity(struct fo_service *service, struct fo_server **_server)
 {
@@ -934,6 +1069,11 @@ get_first_server_entity(struct fo_service *service, struct fo_server **_server)
     return ENOENT;
 
 done:
+    if (service->ctx->opts->latency_selection
+            && server != service->active_server) {
+        server = get_fastest_peer(server);
+    }
+
     service->last_tried_server = server;
     *_server = server;
     return EOK;
@@ -1552,6 +1692,136 @@ fo_set_port_status(struct fo_server *server, enum port_status status)
     }
 }
 
+bool
+fo_set_server_probe_result(struct fo_server *server, bool reachable)
+{
+    struct fo_service *service = server->service;
+    unsigned int threshold;
+
+    if (reachable) {
+        server->probe_failures = 0;
+
+        if (server->port_status != PORT_NOT_WORKING
+                && (server->common == NULL
+                    || server->common->server_status != SERVER_NOT_WORKING)) {
+            return false;
+        }
+
+        DEBUG(SSSDBG_TRACE_FUNC, "Probe of port %d of server '%s' succeeded, "
+              "server can be used again\n", server->port, SERVER_NAME(server));
+        if (server->common != NULL
+                && server->common->server_status == SERVER_NOT_WORKING) {
+            fo_set_server_status(server, SERVER_NAME_NOT_RESOLVED);
+        }
+        fo_set_port_status(server, PORT_NEUTRAL);
+        return false;
+    }
+
+    if (server->port_status == PORT_NOT_WORKING) {
+        /* Already demoted, just keep it from being retried too early. */
+        fo_set_port_status(server, PORT_NOT_WORKING);
+        return false;
+    }
+
+    threshold = service->ctx->opts->probe_failures;
+    if (threshold == 0) {
+        threshold = 1;
+    }
+
+    server->probe_failures++;
+    if (server->probe_failures < threshold) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Probe of port %d of server '%s' failed "
+              "(%u of %u)\n", server->port, SERVER_NAME(server),
+              server->probe_failures, threshold);
+        return false;
+    }
+
+    DEBUG(SSSDBG_MINOR_FAILURE, "Probe of port %d of server '%s' failed "
+          "%u times in a row\n", server->port, SERVER_NAME(server),
+          server->probe_failures);
+    server->probe_failures = 0;
+    if (service->active_server == server) {
+        service->active_server = NULL;
+    }
+    fo_set_port_status(server, PORT_NOT_WORKING);
+    return true;
+}
+
+static uint32_t
+fo_latency_ewma(uint32_t average, uint32_t sample)
+{
+    int64_t diff;
+
+    if (average == 0) {
+        return sample == 0 ? 1 : sample;
+    }
+
+    diff = (int64_t) sample - (int64_t) average;
+    return average + (diff / (1 << FO_LATENCY_EWMA_SHIFT));
+}
+
+void
+fo_set_server_latency(struct fo_server *server,
+                      enum fo_latency_type type,
+                      uint32_t usec)
+{
+    struct fo_service *service = server->service;
+    struct fo_server *peer;
+
+    switch (type) {
+    case FO_LATENCY_CONNECT:
+        server->latency.connect = fo_latency_ewma(server->latency.connect,
+                                                  usec);
+        break;
+    case FO_LATENCY_RESPONSE:
+        server->latency.response = fo_latency_ewma(server->latency.response,
+                                                   usec);
+        break;
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Latency of port %d of server '%s' is now "
+          "%"PRIu32" us [connect] and %"PRIu32" us [response]\n",
+          server->port, SERVER_NAME(server),
+          server->latency.connect, server->latency.response);
+
+    if (!service->ctx->opts->latency_selection
+            || service->active_server != server) {
+        return;
+    }
+
+    fo_probe_unmeasured_peers(server);
+
+    /* Demote the active server if a working peer is considerably faster. */
+    DLIST_FOR_EACH(peer, service->server_list) {
+        if (peer == server || !fo_server_same_class(peer, server)) {
+            continue;
+        }
+
+        if (fo_server_is_faster(peer, server) && service_works(peer)) {
+            DEBUG(SSSDBG_CONF_SETTINGS, "Server '%s' became slower than "
+                  "server '%s', it will not be preferred anymore\n",
+                  SERVER_NAME(server), SERVER_NAME(peer));
+            service->active_server = NULL;
+            return;
+        }
+    }
+}
+
+uint32_t
+fo_get_server_latency(struct fo_server *server)
+{
+    uint64_t sum;
+
+    /* The sum of two averages may not fit, wrapping around would make the
+     * slowest server look like the fastest one. */
+    sum = (uint64_t) server->latency.connect + server->latency.response;
+    if (sum > UINT32_MAX) {
+        return UINT32_MAX;
+    }
+
+    return sum;
+}
+
 struct fo_server *fo_get_active_server(struct fo_service *service)
 {
     return service->active_server;
@@ -1757,6 +2027,141 @@ const char **fo_svc_server_list(TALLOC_CTX *mem_ctx,
     return list;
 }
 
+errno_t fo_svc_server_latency_list(TALLOC_CTX *mem_ctx,
+                                   struct fo_service *service,
+                                   const char ***_servers,
+                                   uint32_t **_latency)
+{
+    TALLOC_CTX *tmp_ctx;
+    const char **servers;
+    uint32_t *latency;
+    const char *name;
+    struct fo_server *srv;
+    size_t count;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    count = 0;
+    DLIST_FOR_EACH(srv, service->server_list) {
+        if (fo_get_server_name(srv) != NULL) {
+            count++;
+        }
+    }
+
+    servers = talloc_zero_array(tmp_ctx, const char *, count + 1);
+    latency = talloc_zero_array(tmp_ctx, uint32_t, count);
+    if (servers == NULL || latency == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    count = 0;
+    DLIST_FOR_EACH(srv, service->server_list) {
+        name = fo_get_server_name(srv);
+        if (name == NULL) {
+            /* _srv_ */
+            continue;
+        }
+
+        servers[count] = talloc_strdup(servers, name);
+        if (servers[count] == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        latency[count] = fo_get_server_latency(srv);
+        count++;
+    }
+
+    *_servers = talloc_steal(mem_ctx, servers);
+    *_latency = talloc_steal(mem_ctx, latency);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static bool
+fo_server_is_probe_candidate(struct fo_server *server,
+                             struct fo_server **servers,
+                             size_t count)
+{
+    size_t i;
+
+    /* SRV lookup placeholders do not have a name */
+    if (fo_get_server_name(server) == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (servers[i] == server) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+errno_t fo_svc_probe_candidates(TALLOC_CTX *mem_ctx,
+                                struct fo_service *service,
+                                size_t max,
+                                struct fo_server ***_servers)
+{
+    struct fo_server **servers;
+    struct fo_server *srv;
+    size_t count;
+    int primary;
+
+    servers = talloc_zero_array(mem_ctx, struct fo_server *, max + 1);
+    if (servers == NULL) {
+        return ENOMEM;
+    }
+
+    count = 0;
+    if (max > 0 && service->active_server != NULL
+            && fo_server_is_probe_candidate(service->active_server,
+                                            servers, count)) {
+        servers[count++] = service->active_server;
+    }
+
+    /* primary servers first, backup servers afterwards */
+    for (primary = 1; primary >= 0; primary--) {
+        DLIST_FOR_EACH(srv, service->server_list) {
+            if (count >= max) {
+                break;
+            }
+
+            if (srv->primary != (bool) primary
+                    || !fo_server_is_probe_candidate(srv, servers, count)) {
+                continue;
+            }
+
+            servers[count++] = srv;
+        }
+    }
+
+    for (count = 0; servers[count] != NULL; count++) {
+        fo_ref_server(servers, servers[count]);
+    }
+
+    *_servers = servers;
+    return EOK;
+}
+
+void fo_set_latency_probe_plugin(struct fo_ctx *ctx,
+                                 fo_latency_probe_fn probe_fn,
+                                 void *pvt)
+{
+    ctx->latency_probe_fn = probe_fn;
+    ctx->latency_probe_pvt = pvt;
+}
+
 bool fo_set_srv_lookup_plugin(struct fo_ctx *ctx,
                               fo_srv_lookup_plugin_send_t send_fn,
                               fo_srv_lookup_plugin_recv_t recv_fn,
@@ -53,6 +53,11 @@ enum server_status {
     SERVER_NOT_WORKING        /* We tried and failed to connect to the server. */
 };
 
+enum fo_latency_type {
+    FO_LATENCY_CONNECT,  /* Time it took to establish a connection. */
+    FO_LATENCY_RESPONSE  /* Time it took the server to answer a request. */
+};
+
 struct fo_ctx;
 struct fo_service;
 struct fo_server;
@@ -76,12 +81,23 @@ struct fo_server;
  *
  * The family_order member specifies the order of address families to
  * try when looking up the service.
+ *
+ * If the 'latency_selection' member is true, the server with the lowest
+ * observed latency is preferred among working servers of the same priority
+ * class (primary/backup and SRV priority).
+ *
+ * The 'latency_tolerance' member specifies by how many percent a server
+ * must be faster than the current candidate to be preferred over it. The
+ * active server is demoted once it becomes slower than this.
  */
 struct fo_options {
     time_t srv_retry_neg_timeout;
     time_t retry_timeout;
     int service_resolv_timeout;
     enum restrict_family family_order;
+    bool latency_selection;
+    unsigned int latency_tolerance;
+    unsigned int probe_failures;
 };
 
 /*
@@ -179,6 +195,35 @@ void fo_set_server_status(struct fo_server *server,
 void fo_set_port_status(struct fo_server *server,
                         enum port_status status);
 
+/*
+ * Set the result of a background health probe of 'server'. A reachable
+ * server which was marked as not working is reset to neutral so it can be
+ * selected again without waiting for the retry timeout. A server which
+ * failed 'probe_failures' probes in a row (at least one) is marked as not
+ * working and if it was the active server of its service, the next
+ * fo_resolve_service_send() call picks another one.
+ *
+ * Returns true if the server was marked as not working by this call.
+ */
+bool fo_set_server_probe_result(struct fo_server *server, bool reachable);
+
+/*
+ * Record latency of 'server' in microseconds. The samples are folded into an
+ * exponentially weighted moving average per latency type. If latency based
+ * selection is enabled and the active server becomes slower than its peers,
+ * it is demoted so that the next fo_resolve_service_send() call picks
+ * a faster server.
+ */
+void fo_set_server_latency(struct fo_server *server,
+                           enum fo_latency_type type,
+                           uint32_t usec);
+
+/*
+ * Return the combined average latency of 'server' in microseconds
+ * or 0 if no latency was recorded yet. The result is capped at UINT32_MAX.
+ */
+uint32_t fo_get_server_latency(struct fo_server *server);
+
 /*
  * Instruct fail-over to try next server on the next connect attempt.
  * Should be used after connection to service was unexpectedly dropped
@@ -216,6 +261,29 @@ const char **fo_svc_server_list(TALLOC_CTX *mem_ctx,
                                 struct fo_service *service,
                                 size_t *_count);
 
+/*
+ * Return names of all servers of the service together with their combined
+ * average latency in microseconds (0 if not measured yet). The list of
+ * servers is NULL terminated, the latency list is a talloc array with
+ * the same number of elements as there are servers.
+ */
+errno_t fo_svc_server_latency_list(TALLOC_CTX *mem_ctx,
+                                   struct fo_service *service,
+                                   const char ***_servers,
+                                   uint32_t **_latency);
+
+/*
+ * Return a NULL terminated list of at most 'max' servers of the service that
+ * should be health probed: the active server first, followed by the servers
+ * that would be tried next (primary servers before backup servers). SRV
+ * lookup placeholders are skipped. Each server is referenced by the returned
+ * list so it stays valid even if the server list changes meanwhile.
+ */
+errno_t fo_svc_probe_candidates(TALLOC_CTX *mem_ctx,
+                                struct fo_service *service,
+                                size_t max,
+                                struct fo_server ***_servers);
+
 /*
  * Folowing functions allow to iterate trough list of servers.
  */
@@ -225,6 +293,24 @@ struct fo_server *fo_server_next(struct fo_server *server);
 
 size_t fo_server_count(struct fo_server *server);
 
+/*
+ * Called when latency based selection needs the latency of 'server', which
+ * was not measured yet. The function should probe the server and record
+ * its latency with fo_set_server_latency(). 'server' may be removed from
+ * the service meanwhile, reference it with fo_ref_server() if needed.
+ */
+typedef void (*fo_latency_probe_fn)(const char *service_name,
+                                    struct fo_server *server,
+                                    void *pvt);
+
+/*
+ * Set the function used to probe latency of servers. pvt is not stolen,
+ * it must be valid as long as ctx.
+ */
+void fo_set_latency_probe_plugin(struct fo_ctx *ctx,
+                                 fo_latency_probe_fn probe_fn,
+                                 void *pvt);
+
 /*
  * pvt will be talloc_stealed to ctx
  */
@@ -70,6 +70,12 @@ errno_t files_init_certmap(TALLOC_CTX *mem_ctx, struct files_id_ctx *id_ctx)
         goto done;
     }
 
+    ret = sss_certmap_enable_cache(id_ctx->sss_certmap_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sss_certmap_enable_cache failed.\n");
+        goto done;
+    }
+
     for (c = 0; certmap_list[c] != NULL; c++) {
         DEBUG(SSSDBG_TRACE_ALL, "Trying to add rule [%s][%d][%s][%s].\n",
                                 certmap_list[c]->name,
@@ -26,6 +26,7 @@
 #include "db/sysdb.h"
 #include "util/inotify.h"
 #include "util/util.h"
+#include "shared/murmurhash3.h"
 #include "providers/data_provider/dp_iface.h"
 
 /* When changing this constant, make sure to also adjust the files integration
@@ -40,6 +41,9 @@
 #define SF_UPDATE_GROUP     1<<1
 #define SF_UPDATE_BOTH      (SF_UPDATE_PASSWD | SF_UPDATE_GROUP)
 
+/* With more changed entries the memory cache is reset completely */
+#define SF_MAX_INVALIDATE   128
+
 struct files_ctx {
     struct files_ops_ctx *ops;
 };
@@ -279,6 +283,13 @@ done:
     return ret;
 }
 
+static bool skip_file_user(struct passwd *pw)
+{
+    return strcmp(pw->pw_name, "root") == 0
+            || pw->pw_uid == 0
+            || pw->pw_gid == 0;
+}
+
 static errno_t save_file_user(struct files_id_ctx *id_ctx,
                               struct passwd *pw)
 {
@@ -289,9 +300,7 @@ static errno_t save_file_user(struct files_id_ctx *id_ctx,
     const char *gecos;
     struct sysdb_attrs *attrs = NULL;
 
-    if (strcmp(pw->pw_name, "root") == 0
-            || pw->pw_uid == 0
-            || pw->pw_gid == 0) {
+    if (skip_file_user(pw)) {
         DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", pw->pw_name);
         return EOK;
     }
@@ -448,49 +457,6 @@ done:
     return ret;
 }
 
-static errno_t sf_enum_groups(struct files_id_ctx *id_ctx,
-                              const char *group_file);
-
-errno_t sf_enum_users(struct files_id_ctx *id_ctx,
-                      const char *passwd_file)
-{
-    errno_t ret;
-    TALLOC_CTX *tmp_ctx = NULL;
-    struct passwd **users = NULL;
-
-    tmp_ctx = talloc_new(NULL);
-    if (tmp_ctx == NULL) {
-        return ENOMEM;
-    }
-
-    ret = enum_files_users(tmp_ctx, passwd_file, &users);
-    if (ret != EOK) {
-        goto done;
-    }
-
-    for (size_t i = 0; users[i]; i++) {
-        ret = save_file_user(id_ctx, users[i]);
-        if (ret != EOK) {
-            DEBUG(SSSDBG_MINOR_FAILURE,
-                  "Cannot save user %s: [%d]: %s\n",
-                  users[i]->pw_name, ret, sss_strerror(ret));
-            continue;
-        }
-    }
-
-    ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_USER);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_MINOR_FAILURE,
-              "Failed to refresh override attributes, "
-              "override values might not be available.\n");
-    }
-
-    ret = EOK;
-done:
-    talloc_free(tmp_ctx);
-    return ret;
-}
-
 static const char **get_cached_user_names(TALLOC_CTX *mem_ctx,
                                           struct sss_domain_info *dom)
 {
@@ -558,6 +524,12 @@ done:
     return ret;
 }
 
+static bool skip_file_group(struct group *grp)
+{
+    return strcmp(grp->gr_name, "root") == 0
+            || grp->gr_gid == 0;
+}
+
 static errno_t save_file_group(struct files_id_ctx *id_ctx,
                                struct group *grp,
                                const char **cached_users)
@@ -570,8 +542,7 @@ static errno_t save_file_group(struct files_id_ctx *id_ctx,
     const char **fq_gr_mem;
     unsigned mi = 0;
 
-    if (strcmp(grp->gr_name, "root") == 0
-            || grp->gr_gid == 0) {
+    if (skip_file_group(grp)) {
         DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", grp->gr_name);
         return EOK;
     }
@@ -664,58 +635,793 @@ done:
     return ret;
 }
 
-static errno_t sf_enum_groups(struct files_id_ctx *id_ctx,
-                              const char *group_file)
+/* Reloads only re-import the entries which changed since the previous
+ * reload. The content hash of every entry stored in the cache by the
+ * previous reload is kept in files_id_ctx, if the hashes are missing the
+ * cache is rebuilt from scratch. */
+struct sf_entry {
+    uint64_t hash;
+    uint32_t id;
+    bool stored;
+};
+
+/* What a reload changed in the cache */
+struct sf_changes {
+    /* names of the users which were added, modified or removed */
+    hash_table_t *users;
+    bool users_rebuilt;
+
+    /* old and new IDs of the changed entries */
+    uint32_t *uids;
+    size_t num_uids;
+    uint32_t *gids;
+    size_t num_gids;
+
+    /* too many changes to invalidate the entries one by one */
+    bool all_users;
+    bool all_groups;
+};
+
+static struct sf_changes *sf_changes_new(TALLOC_CTX *mem_ctx)
 {
+    struct sf_changes *changes;
     errno_t ret;
-    TALLOC_CTX *tmp_ctx = NULL;
-    struct group **groups = NULL;
+
+    changes = talloc_zero(mem_ctx, struct sf_changes);
+    if (changes == NULL) {
+        return NULL;
+    }
+
+    ret = sss_hash_create(changes, 0, &changes->users);
+    if (ret != EOK) {
+        talloc_free(changes);
+        return NULL;
+    }
+
+    return changes;
+}
+
+static errno_t sf_changes_add_id(struct sf_changes *changes,
+                                 uint32_t **_ids,
+                                 size_t *_num_ids,
+                                 bool *_all,
+                                 uint32_t id)
+{
+    uint32_t *ids;
+
+    if (*_all) {
+        return EOK;
+    }
+
+    if (*_num_ids >= SF_MAX_INVALIDATE) {
+        *_all = true;
+        return EOK;
+    }
+
+    ids = talloc_realloc(changes, *_ids, uint32_t, *_num_ids + 1);
+    if (ids == NULL) {
+        return ENOMEM;
+    }
+
+    ids[*_num_ids] = id;
+    *_ids = ids;
+    (*_num_ids)++;
+
+    return EOK;
+}
+
+static errno_t sf_changes_add_user(struct sf_changes *changes,
+                                   const char *name,
+                                   uid_t uid)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+    value.type = HASH_VALUE_UNDEF;
+
+    hret = hash_enter(changes->users, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        return ENOMEM;
+    }
+
+    return sf_changes_add_id(changes, &changes->uids, &changes->num_uids,
+                             &changes->all_users, uid);
+}
+
+static bool sf_changes_has_user(struct sf_changes *changes,
+                                const char *name)
+{
+    hash_key_t key;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+
+    return hash_has_key(changes->users, &key);
+}
+
+static uint64_t sf_hash_string(const char *str)
+{
+    size_t len = strlen(str);
+
+    return ((uint64_t) murmurhash3(str, len, 0xdeadbeef) << 32)
+           | murmurhash3(str, len, 0xfeedface);
+}
+
+static errno_t sf_user_hash(struct passwd *pw, uint64_t *_hash)
+{
+    char *str;
+
+    str = talloc_asprintf(NULL, "%s:%s:%"SPRIuid":%"SPRIgid":%s:%s:%s",
+                          pw->pw_name,
+                          pw->pw_passwd != NULL ? pw->pw_passwd : "",
+                          pw->pw_uid, pw->pw_gid,
+                          pw->pw_gecos != NULL ? pw->pw_gecos : "",
+                          pw->pw_dir != NULL ? pw->pw_dir : "",
+                          pw->pw_shell != NULL ? pw->pw_shell : "");
+    if (str == NULL) {
+        return ENOMEM;
+    }
+
+    *_hash = sf_hash_string(str);
+    talloc_free(str);
+
+    return EOK;
+}
+
+static errno_t sf_group_hash(struct group *grp, uint64_t *_hash)
+{
+    char *str;
+    size_t i;
+
+    str = talloc_asprintf(NULL, "%s:%s:%"SPRIgid":",
+                          grp->gr_name,
+                          grp->gr_passwd != NULL ? grp->gr_passwd : "",
+                          grp->gr_gid);
+
+    for (i = 0; grp->gr_mem != NULL && grp->gr_mem[i] != NULL; i++) {
+        if (str == NULL) {
+            break;
+        }
+        str = talloc_asprintf_append(str, "%s,", grp->gr_mem[i]);
+    }
+
+    if (str == NULL) {
+        return ENOMEM;
+    }
+
+    *_hash = sf_hash_string(str);
+    talloc_free(str);
+
+    return EOK;
+}
+
+static struct sf_entry *sf_entry_get(hash_table_t *table, const char *name)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    if (table == NULL) {
+        return NULL;
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+
+    hret = hash_lookup(table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        return NULL;
+    }
+
+    return talloc_get_type(value.ptr, struct sf_entry);
+}
+
+static errno_t sf_entry_set(hash_table_t *table,
+                            const char *name,
+                            uint64_t hash,
+                            uint32_t id)
+{
+    struct sf_entry *entry;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    /* A later entry with the same name overwrites the previous one */
+    entry = sf_entry_get(table, name);
+    if (entry != NULL) {
+        entry->hash = hash;
+        entry->id = id;
+        return EOK;
+    }
+
+    entry = talloc_zero(table, struct sf_entry);
+    if (entry == NULL) {
+        return ENOMEM;
+    }
+
+    entry->hash = hash;
+    entry->id = id;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+    value.type = HASH_VALUE_PTR;
+    value.ptr = entry;
+
+    hret = hash_enter(table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        talloc_free(entry);
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+static void sf_entry_del(hash_table_t *table, const char *name)
+{
+    struct sf_entry *entry;
+    hash_key_t key;
+
+    entry = sf_entry_get(table, name);
+    if (entry == NULL) {
+        return;
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+
+    hash_delete(table, &key);
+    talloc_free(entry);
+}
+
+static errno_t sf_delete_entry(struct files_id_ctx *id_ctx,
+                               enum sysdb_member_type type,
+                               const char *name)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_dn *dn;
+    char *fqname;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    fqname = sss_create_internal_fqname(tmp_ctx, name, id_ctx->domain->name);
+    if (fqname == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (type == SYSDB_MEMBER_USER) {
+        dn = sysdb_user_dn(tmp_ctx, id_ctx->domain, fqname);
+    } else {
+        dn = sysdb_group_dn(tmp_ctx, id_ctx->domain, fqname);
+    }
+    if (dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* Unlike sysdb_delete_user() and sysdb_delete_group() this keeps the
+     * local overrides, the same way delete_all_users() and
+     * delete_all_groups() do. */
+    ret = sysdb_delete_entry(id_ctx->domain->sysdb, dn, true);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to delete %s [%d]: %s\n",
+              fqname, ret, sss_strerror(ret));
+        goto done;
+    }
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* Deletes the entries which were stored by the previous reload but are
+ * not in the files anymore. */
+static errno_t sf_delete_missing(struct files_id_ctx *id_ctx,
+                                 enum sysdb_member_type type,
+                                 hash_table_t *old_hashes,
+                                 hash_table_t *new_hashes,
+                                 struct sf_changes *changes)
+{
+    struct sf_entry *entry;
+    hash_key_t *keys = NULL;
+    unsigned long count;
+    unsigned long i;
+    errno_t ret;
+    int hret;
+
+    hret = hash_keys(old_hashes, &count, &keys);
+    if (hret != HASH_SUCCESS) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (sf_entry_get(new_hashes, keys[i].str) != NULL) {
+            continue;
+        }
+
+        entry = sf_entry_get(old_hashes, keys[i].str);
+
+        DEBUG(SSSDBG_TRACE_LIBS, "%s %s was removed\n",
+              type == SYSDB_MEMBER_USER ? "User" : "Group", keys[i].str);
+
+        ret = sf_delete_entry(id_ctx, type, keys[i].str);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        if (type == SYSDB_MEMBER_USER) {
+            ret = sf_changes_add_user(changes, keys[i].str, entry->id);
+        } else {
+            ret = sf_changes_add_id(changes, &changes->gids,
+                                    &changes->num_gids, &changes->all_groups,
+                                    entry->id);
+        }
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(keys);
+    return ret;
+}
+
+static errno_t sf_read_users(TALLOC_CTX *mem_ctx,
+                             struct files_id_ctx *id_ctx,
+                             struct passwd ***_users,
+                             size_t *_num_users)
+{
+    struct passwd **file_users;
+    struct passwd **users;
+    size_t num_users = 0;
+    size_t c;
+    errno_t ret;
+
+    users = talloc_zero_array(mem_ctx, struct passwd *, 1);
+    if (users == NULL) {
+        return ENOMEM;
+    }
+
+    for (size_t i = 0; id_ctx->passwd_files[i] != NULL; i++) {
+        ret = enum_files_users(users, id_ctx->passwd_files[i], &file_users);
+        if (ret == ENOENT) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "The file %s does not exist (yet), skipping\n",
+                  id_ctx->passwd_files[i]);
+            continue;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "Cannot enumerate users from %s, aborting\n",
+                  id_ctx->passwd_files[i]);
+            goto done;
+        }
+
+        for (c = 0; file_users[c] != NULL; c++);
+
+        users = talloc_realloc(mem_ctx, users, struct passwd *,
+                               num_users + c + 1);
+        if (users == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        memcpy(&users[num_users], file_users, c * sizeof(struct passwd *));
+        num_users += c;
+        users[num_users] = NULL;
+    }
+
+    *_users = users;
+    *_num_users = num_users;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(users);
+    }
+
+    return ret;
+}
+
+static errno_t sf_update_users(TALLOC_CTX *mem_ctx,
+                               struct files_id_ctx *id_ctx,
+                               struct sf_changes *changes,
+                               hash_table_t **_hashes)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct passwd **users;
+    uint64_t *user_hashes;
+    hash_table_t *hashes;
+    struct sf_entry *entry;
+    struct sf_entry *old;
+    size_t num_users;
+    size_t stored = 0;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sf_read_users(tmp_ctx, id_ctx, &users, &num_users);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    user_hashes = talloc_zero_array(tmp_ctx, uint64_t, num_users);
+    if (user_hashes == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_hash_create(tmp_ctx, num_users, &hashes);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    for (size_t i = 0; users[i] != NULL; i++) {
+        if (skip_file_user(users[i])) {
+            continue;
+        }
+
+        ret = sf_user_hash(users[i], &user_hashes[i]);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = sf_entry_set(hashes, users[i]->pw_name, user_hashes[i],
+                           users[i]->pw_uid);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    if (id_ctx->user_hashes == NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Rebuilding all users\n");
+        ret = delete_all_users(id_ctx->domain);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        changes->users_rebuilt = true;
+        changes->all_users = true;
+    } else {
+        ret = sf_delete_missing(id_ctx, SYSDB_MEMBER_USER, id_ctx->user_hashes,
+                                hashes, changes);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    for (size_t i = 0; users[i] != NULL; i++) {
+        if (skip_file_user(users[i])) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", users[i]->pw_name);
+            continue;
+        }
+
+        /* Only store the entry which wins for this name */
+        entry = sf_entry_get(hashes, users[i]->pw_name);
+        if (entry == NULL || entry->stored || entry->hash != user_hashes[i]) {
+            continue;
+        }
+        entry->stored = true;
+
+        old = sf_entry_get(id_ctx->user_hashes, users[i]->pw_name);
+        if (old != NULL && old->hash == entry->hash) {
+            continue;
+        }
+
+        if (old != NULL) {
+            /* Re-add modified users to get rid of all stale attributes */
+            DEBUG(SSSDBG_TRACE_LIBS, "User %s was modified\n",
+                  users[i]->pw_name);
+
+            ret = sf_delete_entry(id_ctx, SYSDB_MEMBER_USER,
+                                  users[i]->pw_name);
+            if (ret != EOK) {
+                goto done;
+            }
+
+            ret = sf_changes_add_user(changes, users[i]->pw_name, old->id);
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+
+        ret = save_file_user(id_ctx, users[i]);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Cannot save user %s: [%d]: %s\n",
+                  users[i]->pw_name, ret, sss_strerror(ret));
+            /* Try again with the next reload */
+            sf_entry_del(hashes, users[i]->pw_name);
+            continue;
+        }
+        stored++;
+
+        if (!changes->users_rebuilt) {
+            ret = sf_changes_add_user(changes, users[i]->pw_name,
+                                      users[i]->pw_uid);
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Stored %zu of %zu users\n", stored, num_users);
+
+    if (stored > 0) {
+        ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_USER);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Failed to refresh override attributes, "
+                  "override values might not be available.\n");
+        }
+    }
+
+    *_hashes = talloc_steal(mem_ctx, hashes);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t sf_read_groups(TALLOC_CTX *mem_ctx,
+                              struct files_id_ctx *id_ctx,
+                              struct group ***_groups,
+                              size_t *_num_groups)
+{
+    struct group **file_groups;
+    struct group **groups;
+    size_t num_groups = 0;
+    size_t c;
+    errno_t ret;
+
+    groups = talloc_zero_array(mem_ctx, struct group *, 1);
+    if (groups == NULL) {
+        return ENOMEM;
+    }
+
+    for (size_t i = 0; id_ctx->group_files[i] != NULL; i++) {
+        ret = enum_files_groups(groups, id_ctx->group_files[i], &file_groups);
+        if (ret == ENOENT) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "The file %s does not exist (yet), skipping\n",
+                  id_ctx->group_files[i]);
+            continue;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "Cannot enumerate groups from %s, aborting\n",
+                  id_ctx->group_files[i]);
+            goto done;
+        }
+
+        for (c = 0; file_groups[c] != NULL; c++);
+
+        groups = talloc_realloc(mem_ctx, groups, struct group *,
+                                num_groups + c + 1);
+        if (groups == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        memcpy(&groups[num_groups], file_groups, c * sizeof(struct group *));
+        num_groups += c;
+        groups[num_groups] = NULL;
+    }
+
+    *_groups = groups;
+    *_num_groups = num_groups;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(groups);
+    }
+
+    return ret;
+}
+
+/* Memberships are stored as links to the cached users, so a group must be
+ * stored again if any of its members was added, modified or removed. */
+static bool sf_group_has_changed_member(struct group *grp,
+                                        struct sf_changes *changes)
+{
+    if (grp->gr_mem == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; grp->gr_mem[i] != NULL; i++) {
+        if (sf_changes_has_user(changes, grp->gr_mem[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static errno_t sf_update_groups(TALLOC_CTX *mem_ctx,
+                                struct files_id_ctx *id_ctx,
+                                struct sf_changes *changes,
+                                hash_table_t **_hashes)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct group **groups;
+    uint64_t *group_hashes;
+    hash_table_t *hashes;
+    hash_table_t *old_hashes;
     const char **cached_users = NULL;
+    struct sf_entry *entry;
+    struct sf_entry *old;
+    size_t num_groups;
+    size_t stored = 0;
+    errno_t ret;
 
     tmp_ctx = talloc_new(NULL);
     if (tmp_ctx == NULL) {
         return ENOMEM;
     }
 
-    ret = enum_files_groups(tmp_ctx, group_file, &groups);
+    ret = sf_read_groups(tmp_ctx, id_ctx, &groups, &num_groups);
     if (ret != EOK) {
         goto done;
     }
 
-    cached_users = get_cached_user_names(tmp_ctx, id_ctx->domain);
-    if (cached_users == NULL) {
+    group_hashes = talloc_zero_array(tmp_ctx, uint64_t, num_groups);
+    if (group_hashes == NULL) {
+        ret = ENOMEM;
         goto done;
     }
 
-    for (size_t i = 0; groups[i]; i++) {
+    ret = sss_hash_create(tmp_ctx, num_groups, &hashes);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    for (size_t i = 0; groups[i] != NULL; i++) {
+        if (skip_file_group(groups[i])) {
+            continue;
+        }
+
+        ret = sf_group_hash(groups[i], &group_hashes[i]);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = sf_entry_set(hashes, groups[i]->gr_name, group_hashes[i],
+                           groups[i]->gr_gid);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    /* Deleting all users removed all memberships as well */
+    old_hashes = changes->users_rebuilt ? NULL : id_ctx->group_hashes;
+    if (old_hashes == NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Rebuilding all groups\n");
+        ret = delete_all_groups(id_ctx->domain);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        changes->all_groups = true;
+    } else {
+        ret = sf_delete_missing(id_ctx, SYSDB_MEMBER_GROUP, old_hashes,
+                                hashes, changes);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    for (size_t i = 0; groups[i] != NULL; i++) {
+        if (skip_file_group(groups[i])) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", groups[i]->gr_name);
+            continue;
+        }
+
+        /* Only store the entry which wins for this name */
+        entry = sf_entry_get(hashes, groups[i]->gr_name);
+        if (entry == NULL || entry->stored
+                || entry->hash != group_hashes[i]) {
+            continue;
+        }
+        entry->stored = true;
+
+        old = sf_entry_get(old_hashes, groups[i]->gr_name);
+        if (old != NULL && old->hash == entry->hash
+                && !sf_group_has_changed_member(groups[i], changes)) {
+            continue;
+        }
+
+        if (old != NULL) {
+            /* Re-add the group to get rid of stale members */
+            DEBUG(SSSDBG_TRACE_LIBS, "Group %s was modified\n",
+                  groups[i]->gr_name);
+
+            ret = sf_delete_entry(id_ctx, SYSDB_MEMBER_GROUP,
+                                  groups[i]->gr_name);
+            if (ret != EOK) {
+                goto done;
+            }
+
+            ret = sf_changes_add_id(changes, &changes->gids,
+                                    &changes->num_gids, &changes->all_groups,
+                                    old->id);
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+
+        if (cached_users == NULL) {
+            cached_users = get_cached_user_names(tmp_ctx, id_ctx->domain);
+            if (cached_users == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+        }
+
         ret = save_file_group(id_ctx, groups[i], cached_users);
         if (ret != EOK) {
             DEBUG(SSSDBG_MINOR_FAILURE,
                   "Cannot save group %s\n", groups[i]->gr_name);
+            /* Try again with the next reload */
+            sf_entry_del(hashes, groups[i]->gr_name);
             continue;
         }
+        stored++;
+
+        ret = sf_changes_add_id(changes, &changes->gids, &changes->num_gids,
+                                &changes->all_groups, groups[i]->gr_gid);
+        if (ret != EOK) {
+            goto done;
+        }
     }
 
-    ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_GROUP);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_MINOR_FAILURE,
-              "Failed to refresh override attributes, "
-              "override values might not be available.\n");
+    DEBUG(SSSDBG_TRACE_FUNC, "Stored %zu of %zu groups\n",
+          stored, num_groups);
+
+    if (stored > 0) {
+        ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_GROUP);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Failed to refresh override attributes, "
+                  "override values might not be available.\n");
+        }
     }
 
+    *_hashes = talloc_steal(mem_ctx, hashes);
     ret = EOK;
+
 done:
     talloc_free(tmp_ctx);
     return ret;
 }
 
 static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
-                             uint8_t flags)
+                             uint8_t flags,
+                             struct sf_changes *changes)
 {
+    TALLOC_CTX *tmp_ctx;
+    hash_table_t *user_hashes = NULL;
+    hash_table_t *group_hashes = NULL;
     errno_t ret;
     errno_t tret;
     bool in_transaction = false;
 
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
     ret = sysdb_transaction_start(id_ctx->domain->sysdb);
     if (ret != EOK) {
         goto done;
@@ -723,49 +1429,17 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
     in_transaction = true;
 
     if (flags & SF_UPDATE_PASSWD) {
-        ret = delete_all_users(id_ctx->domain);
+        ret = sf_update_users(tmp_ctx, id_ctx, changes, &user_hashes);
         if (ret != EOK) {
             goto done;
         }
-
-        /* All users were deleted, therefore we need to enumerate each file again */
-        for (size_t i = 0; id_ctx->passwd_files[i] != NULL; i++) {
-            ret = sf_enum_users(id_ctx, id_ctx->passwd_files[i]);
-            if (ret == ENOENT) {
-                DEBUG(SSSDBG_MINOR_FAILURE,
-                      "The file %s does not exist (yet), skipping\n",
-                      id_ctx->passwd_files[i]);
-                continue;
-            } else if (ret != EOK) {
-                DEBUG(SSSDBG_OP_FAILURE,
-                      "Cannot enumerate users from %s, aborting\n",
-                      id_ctx->passwd_files[i]);
-                goto done;
-            }
-        }
     }
 
     if (flags & SF_UPDATE_GROUP) {
-        ret = delete_all_groups(id_ctx->domain);
+        ret = sf_update_groups(tmp_ctx, id_ctx, changes, &group_hashes);
         if (ret != EOK) {
             goto done;
         }
-
-        /* All groups were deleted, therefore we need to enumerate each file again */
-        for (size_t i = 0; id_ctx->group_files[i] != NULL; i++) {
-            ret = sf_enum_groups(id_ctx, id_ctx->group_files[i]);
-            if (ret == ENOENT) {
-                DEBUG(SSSDBG_MINOR_FAILURE,
-                      "The file %s does not exist (yet), skipping\n",
-                      id_ctx->group_files[i]);
-                continue;
-            } else if (ret != EOK) {
-                DEBUG(SSSDBG_OP_FAILURE,
-                      "Cannot enumerate groups from %s, aborting\n",
-                      id_ctx->group_files[i]);
-                goto done;
-            }
-        }
     }
 
     ret = dp_add_sr_attribute(id_ctx->be);
@@ -780,6 +1454,20 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
     }
     in_transaction = false;
 
+    /* The cache matches the files now */
+    if (user_hashes != NULL) {
+        talloc_free(id_ctx->user_hashes);
+        id_ctx->user_hashes = talloc_steal(id_ctx, user_hashes);
+    }
+
+    if (group_hashes != NULL) {
+        talloc_free(id_ctx->group_hashes);
+        id_ctx->group_hashes = talloc_steal(id_ctx, group_hashes);
+    } else if (flags & SF_UPDATE_PASSWD) {
+        /* The memberships were not updated */
+        talloc_zfree(id_ctx->group_hashes);
+    }
+
     ret = EOK;
 done:
     if (in_transaction) {
@@ -790,9 +1478,43 @@ done:
         }
     }
 
+    if (ret != EOK) {
+        /* Do not rely on the content of the cache with the next reload */
+        talloc_zfree(id_ctx->user_hashes);
+        talloc_zfree(id_ctx->group_hashes);
+    }
+
+    talloc_free(tmp_ctx);
     return ret;
 }
 
+static void sf_invalidate_memcache(struct files_id_ctx *id_ctx,
+                                   struct sf_changes *changes)
+{
+    struct data_provider *provider = id_ctx->be->provider;
+
+    if (changes->all_users) {
+        dp_sbus_reset_users_memcache(provider);
+    } else {
+        for (size_t i = 0; i < changes->num_uids; i++) {
+            dp_sbus_invalidate_user_memcache(provider, changes->uids[i]);
+        }
+    }
+
+    if (changes->all_groups) {
+        dp_sbus_reset_groups_memcache(provider);
+    } else {
+        for (size_t i = 0; i < changes->num_gids; i++) {
+            dp_sbus_invalidate_group_memcache(provider, changes->gids[i]);
+        }
+    }
+
+    if (changes->all_users || changes->all_groups
+            || changes->num_uids > 0 || changes->num_gids > 0) {
+        dp_sbus_reset_initgr_memcache(provider);
+    }
+}
+
 static void sf_cb_done(struct files_id_ctx *id_ctx)
 {
     /* Only activate a domain when both callbacks are done */
@@ -806,6 +1528,7 @@ static void sf_cb_done(struct files_id_ctx *id_ctx)
 static int sf_passwd_cb(const char *filename, uint32_t flags, void *pvt)
 {
     struct files_id_ctx *id_ctx;
+    struct sf_changes *changes;
     errno_t ret;
 
     id_ctx = talloc_get_type(pvt, struct files_id_ctx);
@@ -819,14 +1542,18 @@ static int sf_passwd_cb(const char *filename, uint32_t flags, void *pvt)
     dp_sbus_domain_inconsistent(id_ctx->be->provider, id_ctx->domain);
 
     dp_sbus_reset_users_ncache(id_ctx->be->provider, id_ctx->domain);
-    dp_sbus_reset_users_memcache(id_ctx->be->provider);
-    dp_sbus_reset_initgr_memcache(id_ctx->be->provider);
+
+    changes = sf_changes_new(id_ctx);
+    if (changes == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
 
     /* Using SF_UDPATE_BOTH here the case when someone edits /etc/group, adds a group member and
      * only then edits passwd and adds the user. The reverse is not needed,
      * because member/memberof links are established when groups are saved.
      */
-    ret = sf_enum_files(id_ctx, SF_UPDATE_BOTH);
+    ret = sf_enum_files(id_ctx, SF_UPDATE_BOTH, changes);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "Could not update files: [%d]: %s\n",
@@ -836,6 +1563,15 @@ static int sf_passwd_cb(const char *filename, uint32_t flags, void *pvt)
 
     ret = EOK;
 done:
+    if (ret != EOK || changes == NULL) {
+        dp_sbus_reset_users_memcache(id_ctx->be->provider);
+        dp_sbus_reset_groups_memcache(id_ctx->be->provider);
+        dp_sbus_reset_initgr_memcache(id_ctx->be->provider);
+    } else {
+        sf_invalidate_memcache(id_ctx, changes);
+    }
+    talloc_free(changes);
+
     id_ctx->updating_passwd = false;
     sf_cb_done(id_ctx);
     files_account_info_finished(id_ctx, BE_REQ_USER, ret);
@@ -845,6 +1581,7 @@ done:
 static int sf_group_cb(const char *filename, uint32_t flags, void *pvt)
 {
     struct files_id_ctx *id_ctx;
+    struct sf_changes *changes;
     errno_t ret;
 
     id_ctx = talloc_get_type(pvt, struct files_id_ctx);
@@ -858,10 +1595,14 @@ static int sf_group_cb(const char *filename, uint32_t flags, void *pvt)
     dp_sbus_domain_inconsistent(id_ctx->be->provider, id_ctx->domain);
 
     dp_sbus_reset_groups_ncache(id_ctx->be->provider, id_ctx->domain);
-    dp_sbus_reset_groups_memcache(id_ctx->be->provider);
-    dp_sbus_reset_initgr_memcache(id_ctx->be->provider);
 
-    ret = sf_enum_files(id_ctx, SF_UPDATE_GROUP);
+    changes = sf_changes_new(id_ctx);
+    if (changes == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sf_enum_files(id_ctx, SF_UPDATE_GROUP, changes);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "Could not update files: [%d]: %s\n",
@@ -871,6 +1612,14 @@ static int sf_group_cb(const char *filename, uint32_t flags, void *pvt)
 
     ret = EOK;
 done:
+    if (ret != EOK || changes == NULL) {
+        dp_sbus_reset_groups_memcache(id_ctx->be->provider);
+        dp_sbus_reset_initgr_memcache(id_ctx->be->provider);
+    } else {
+        sf_invalidate_memcache(id_ctx, changes);
+    }
+    talloc_free(changes);
+
     id_ctx->updating_groups = false;
     sf_cb_done(id_ctx);
     files_account_info_finished(id_ctx, BE_REQ_GROUP, ret);
@@ -882,16 +1631,25 @@ static void startup_enum_files(struct tevent_context *ev,
                                void *pvt)
 {
     struct files_id_ctx *id_ctx = talloc_get_type(pvt, struct files_id_ctx);
+    struct sf_changes *changes;
     errno_t ret;
 
     talloc_zfree(imm);
 
-    ret = sf_enum_files(id_ctx, SF_UPDATE_BOTH);
+    changes = sf_changes_new(id_ctx);
+    if (changes == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Out of memory!\n");
+        return;
+    }
+
+    ret = sf_enum_files(id_ctx, SF_UPDATE_BOTH, changes);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "Could not update files after startup: [%d]: %s\n",
               ret, sss_strerror(ret));
     }
+
+    talloc_free(changes);
 }
 
 static struct snotify_ctx *sf_setup_watch(TALLOC_CTX *mem_ctx,
@@ -31,6 +31,7 @@
 #include <nss.h>
 #include <pwd.h>
 #include <grp.h>
+#include <dhash.h>
 
 #include "providers/data_provider/dp.h"
 
@@ -46,6 +47,10 @@ struct files_id_ctx {
     bool updating_passwd;
     bool updating_groups;
 
+    /* content hashes of the entries stored by the last reload */
+    hash_table_t *user_hashes;
+    hash_table_t *group_hashes;
+
     struct tevent_req *users_req;
     struct tevent_req *groups_req;
     struct tevent_req *initgroups_req;
@@ -401,6 +401,28 @@ done:
     tevent_req_done(req);
 }
 
+/* Cached access decisions are only dropped if the refresh brought
+ * something new, otherwise every refresh would empty the cache. */
+static void ipa_fetch_hbac_update_fingerprint(struct ipa_fetch_hbac_state *state,
+                                              bool found)
+{
+    uint32_t fingerprint = 0;
+
+    if (found) {
+        fingerprint = ipa_common_rules_fingerprint(state->hosts,
+                                                   state->services,
+                                                   state->rules);
+    }
+
+    if (fingerprint == state->access_ctx->rules_fingerprint) {
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "HBAC rules changed.\n");
+    state->access_ctx->rules_fingerprint = fingerprint;
+    dp_access_cache_invalidate(state->be_ctx->provider);
+}
+
 static void ipa_fetch_hbac_rules_done(struct tevent_req *subreq)
 {
     struct ipa_fetch_hbac_state *state = NULL;
@@ -449,6 +471,8 @@ static void ipa_fetch_hbac_rules_done(struct tevent_req *subreq)
             goto done;
         }
 
+        ipa_fetch_hbac_update_fingerprint(state, false);
+
         ret = ENOENT;
         goto done;
     }
@@ -462,6 +486,8 @@ static void ipa_fetch_hbac_rules_done(struct tevent_req *subreq)
         goto done;
     }
 
+    ipa_fetch_hbac_update_fingerprint(state, true);
+
     ret = EOK;
 
 done:
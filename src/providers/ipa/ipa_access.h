@@ -36,6 +36,7 @@ struct ipa_access_ctx {
     struct sdap_id_ctx *sdap_ctx;
     struct dp_option *ipa_options;
     time_t last_update;
+    uint32_t rules_fingerprint;
     struct sdap_access_ctx *sdap_access_ctx;
 
     struct sdap_attr_map *host_map;
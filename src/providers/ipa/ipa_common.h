@@ -67,6 +67,7 @@ enum ipa_basic_opt {
     IPA_DESKPROFILE_SEARCH_BASE,
     IPA_DESKPROFILE_REFRESH,
     IPA_DESKPROFILE_REQUEST_INTERVAL,
+    IPA_EXTDOM_PARALLEL_REQUESTS,
 
     IPA_OPTS_BASIC /* opts counter */
 };
@@ -20,6 +20,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "shared/murmurhash3.h"
 #include "providers/ipa/ipa_rules_common.h"
 
 static errno_t
@@ -453,3 +454,61 @@ done:
     talloc_free(dn);
     return ret;
 }
+
+/* Order independent fingerprint of the downloaded entries. The servers do
+ * not guarantee any ordering of the entries or of the values, but a value
+ * moving from one entry to another must change the result. */
+static uint32_t ipa_common_entries_fingerprint(struct sysdb_attrs **entries,
+                                               size_t count,
+                                               uint32_t seed)
+{
+    struct ldb_message_element *el;
+    uint32_t fingerprint = 0;
+    uint32_t entry_hash;
+    uint32_t name_hash;
+    unsigned int k;
+    size_t i;
+    int j;
+
+    for (i = 0; i < count; i++) {
+        entry_hash = 0;
+        for (j = 0; j < entries[i]->num; j++) {
+            el = &entries[i]->a[j];
+            name_hash = murmurhash3(el->name, strlen(el->name), seed);
+            for (k = 0; k < el->num_values; k++) {
+                entry_hash += murmurhash3((const char *) el->values[k].data,
+                                          el->values[k].length, name_hash);
+            }
+        }
+
+        fingerprint += murmurhash3((const char *) &entry_hash,
+                                   sizeof(entry_hash), seed);
+    }
+
+    return fingerprint;
+}
+
+uint32_t
+ipa_common_rules_fingerprint(struct ipa_common_entries *hosts,
+                             struct ipa_common_entries *services,
+                             struct ipa_common_entries *rules)
+{
+    struct ipa_common_entries *lists[3];
+    uint32_t fingerprint = 0;
+    size_t i;
+
+    lists[0] = hosts;
+    lists[1] = services;
+    lists[2] = rules;
+
+    for (i = 0; i < 3; i++) {
+        fingerprint += ipa_common_entries_fingerprint(lists[i]->entries,
+                                                      lists[i]->entry_count,
+                                                      2 * i);
+        fingerprint += ipa_common_entries_fingerprint(lists[i]->groups,
+                                                      lists[i]->group_count,
+                                                      2 * i + 1);
+    }
+
+    return fingerprint;
+}
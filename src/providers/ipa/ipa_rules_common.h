@@ -86,4 +86,11 @@ ipa_common_get_hostgroupname(TALLOC_CTX *mem_ctx,
                              const char *host_dn,
                              char **_hostgroupname);
 
+/* Order independent fingerprint of the downloaded hosts, services and
+ * rules, used to find out whether a refresh changed anything. */
+uint32_t
+ipa_common_rules_fingerprint(struct ipa_common_entries *hosts,
+                             struct ipa_common_entries *services,
+                             struct ipa_common_entries *rules);
+
 #endif /* IPA_RULES_COMMON_H_ */
@@ -1185,29 +1185,31 @@ static const char *ipa_s2n_reqinp2str(TALLOC_CTX *mem_ctx,
     return str;
 }
 
+/* Looking up the members of a large group means one extdom request per
+ * missing member. The extended operation only carries a single object, so
+ * instead of waiting for each reply before sending the next request up to
+ * ipa_extdom_parallel_requests of them are kept in flight on the same LDAP
+ * connection and every reply is written to the cache as soon as it
+ * arrives. */
 struct ipa_s2n_get_list_state {
     struct tevent_context *ev;
     struct ipa_id_ctx *ipa_ctx;
     struct sss_domain_info *dom;
     struct sdap_handle *sh;
     enum extdom_protocol protocol;
-    struct req_input req_input;
+    enum req_input_type list_type;
     char **list;
     size_t list_idx;
+    size_t num_in_flight;
+    size_t max_in_flight;
     int exop_timeout;
     int entry_type;
     enum request_types request_type;
-    struct resp_attrs *attrs;
-    struct sss_domain_info *obj_domain;
-    struct sysdb_attrs *override_attrs;
     struct sysdb_attrs *mapped_attrs;
 };
 
 static errno_t ipa_s2n_get_list_step(struct tevent_req *req);
-static void ipa_s2n_get_list_get_override_done(struct tevent_req *subreq);
-static void ipa_s2n_get_list_next(struct tevent_req *subreq);
-static void ipa_s2n_get_list_ipa_next(struct tevent_req *subreq);
-static errno_t ipa_s2n_get_list_save_step(struct tevent_req *req);
+static void ipa_s2n_get_list_entry_done(struct tevent_req *subreq);
 
 static struct tevent_req *ipa_s2n_get_list_send(TALLOC_CTX *mem_ctx,
                                                 struct tevent_context *ev,
@@ -1222,6 +1224,7 @@ static struct tevent_req *ipa_s2n_get_list_send(TALLOC_CTX *mem_ctx,
                                                 struct sysdb_attrs *mapped_attrs)
 {
     int ret;
+    int max_in_flight;
     struct ipa_s2n_get_list_state *state;
     struct tevent_req *req;
 
@@ -1238,20 +1241,25 @@ static struct tevent_req *ipa_s2n_get_list_send(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    max_in_flight = dp_opt_get_int(ipa_ctx->ipa_options->basic,
+                                   IPA_EXTDOM_PARALLEL_REQUESTS);
+    if (max_in_flight <= 0) {
+        max_in_flight = 1;
+    }
+
     state->ev = ev;
     state->ipa_ctx = ipa_ctx;
     state->dom = dom;
     state->sh = sh;
     state->protocol = extdom_preferred_protocol(sh);
+    state->list_type = list_type;
     state->list = list;
     state->list_idx = 0;
-    state->req_input.type = list_type;
-    state->req_input.inp.name = NULL;
+    state->num_in_flight = 0;
+    state->max_in_flight = max_in_flight;
     state->exop_timeout = exop_timeout;
     state->entry_type = entry_type;
     state->request_type = request_type;
-    state->attrs = NULL;
-    state->override_attrs = NULL;
     state->mapped_attrs = mapped_attrs;
 
     ret = ipa_s2n_get_list_step(req);
@@ -1260,20 +1268,47 @@ static struct tevent_req *ipa_s2n_get_list_send(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    if (state->num_in_flight == 0) {
+        /* empty list */
+        ret = EOK;
+        goto done;
+    }
+
+    return req;
+
 done:
     if (ret != EOK) {
         tevent_req_error(req, ret);
-        tevent_req_post(req, ev);
+    } else {
+        tevent_req_done(req);
     }
+    tevent_req_post(req, ev);
 
     return req;
 }
 
-static errno_t ipa_s2n_get_list_step(struct tevent_req *req)
+struct ipa_s2n_get_list_entry_state {
+    struct ipa_s2n_get_list_state *list_state;
+    const char *entry;
+    struct req_input req_input;
+    struct resp_attrs *attrs;
+    struct sss_domain_info *obj_domain;
+    struct sysdb_attrs *override_attrs;
+};
+
+static void ipa_s2n_get_list_entry_next(struct tevent_req *subreq);
+static void ipa_s2n_get_list_entry_ipa_done(struct tevent_req *subreq);
+static void ipa_s2n_get_list_entry_override_done(struct tevent_req *subreq);
+static errno_t ipa_s2n_get_list_entry_save(struct tevent_req *req);
+
+static struct tevent_req *
+ipa_s2n_get_list_entry_send(TALLOC_CTX *mem_ctx,
+                            struct ipa_s2n_get_list_state *list_state,
+                            const char *entry)
 {
     int ret;
-    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
-                                               struct ipa_s2n_get_list_state);
+    struct ipa_s2n_get_list_entry_state *state;
+    struct tevent_req *req;
     struct berval *bv_req;
     struct tevent_req *subreq;
     struct sss_domain_info *parent_domain;
@@ -1283,17 +1318,29 @@ static errno_t ipa_s2n_get_list_step(struct tevent_req *req)
     char *endptr;
     struct dp_id_data *ar;
 
-    parent_domain = get_domains_head(state->dom);
+    req = tevent_req_create(mem_ctx, &state,
+                            struct ipa_s2n_get_list_entry_state);
+    if (req == NULL) {
+        return NULL;
+    }
+
+    state->list_state = list_state;
+    state->entry = entry;
+    state->req_input.type = list_state->list_type;
+    state->req_input.inp.name = NULL;
+    state->attrs = NULL;
+    state->override_attrs = NULL;
+
+    parent_domain = get_domains_head(list_state->dom);
     switch (state->req_input.type) {
     case REQ_INP_NAME:
 
-        ret = sss_parse_name(state, state->dom->names, state->list[state->list_idx],
+        ret = sss_parse_name(state, list_state->dom->names, entry,
                              &domain_name, &short_name);
         if (ret != EOK) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to parse name '%s' [%d]: %s\n",
-                                        state->list[state->list_idx],
-                                        ret, sss_strerror(ret));
-            return ret;
+                                        entry, ret, sss_strerror(ret));
+            goto done;
         }
 
         if (domain_name) {
@@ -1301,7 +1348,8 @@ static errno_t ipa_s2n_get_list_step(struct tevent_req *req)
                                                     domain_name, true);
             if (state->obj_domain == NULL) {
                 DEBUG(SSSDBG_OP_FAILURE, "find_domain_by_name failed.\n");
-                return ENOMEM;
+                ret = ENOMEM;
+                goto done;
             }
         } else {
             state->obj_domain = parent_domain;
@@ -1310,104 +1358,116 @@ static errno_t ipa_s2n_get_list_step(struct tevent_req *req)
         state->req_input.inp.name = short_name;
 
         if (strcmp(state->obj_domain->name,
-            state->ipa_ctx->sdap_id_ctx->be->domain->name) == 0) {
+            list_state->ipa_ctx->sdap_id_ctx->be->domain->name) == 0) {
             DEBUG(SSSDBG_TRACE_INTERNAL,
-                  "Looking up IPA object [%s] from LDAP.\n",
-                  state->list[state->list_idx]);
-            ret = get_dp_id_data_for_user_name(state,
-                                               state->list[state->list_idx],
+                  "Looking up IPA object [%s] from LDAP.\n", entry);
+            ret = get_dp_id_data_for_user_name(state, entry,
                                                state->obj_domain->name,
                                                &ar);
             if (ret != EOK) {
                 DEBUG(SSSDBG_OP_FAILURE,
                       "Failed to create lookup date for IPA object [%s].\n",
-                      state->list[state->list_idx]);
-                return ret;
+                      entry);
+                goto done;
             }
-            ar->entry_type = state->entry_type;
+            ar->entry_type = list_state->entry_type;
 
-            subreq = ipa_id_get_account_info_send(state, state->ev,
-                                                  state->ipa_ctx, ar);
+            subreq = ipa_id_get_account_info_send(state, list_state->ev,
+                                                  list_state->ipa_ctx, ar);
             if (subreq == NULL) {
                 DEBUG(SSSDBG_OP_FAILURE,
                       "ipa_id_get_account_info_send failed.\n");
-                return ENOMEM;
+                ret = ENOMEM;
+                goto done;
             }
-            tevent_req_set_callback(subreq, ipa_s2n_get_list_ipa_next, req);
+            tevent_req_set_callback(subreq, ipa_s2n_get_list_entry_ipa_done,
+                                    req);
 
-            return EOK;
+            return req;
         }
 
         break;
     case REQ_INP_ID:
         errno = 0;
-        id = strtouint32(state->list[state->list_idx], &endptr, 10);
-        if (errno != 0 || *endptr != '\0'
-                || (state->list[state->list_idx] == endptr)) {
+        id = strtouint32(entry, &endptr, 10);
+        if (errno != 0 || *endptr != '\0' || (entry == endptr)) {
             DEBUG(SSSDBG_OP_FAILURE, "strtouint32 failed.\n");
-            return EINVAL;
+            ret = EINVAL;
+            goto done;
         }
         state->req_input.inp.id = id;
-        state->obj_domain = state->dom;
+        state->obj_domain = list_state->dom;
 
         break;
     case REQ_INP_SECID:
-        state->req_input.inp.secid = state->list[state->list_idx];
+        state->req_input.inp.secid = entry;
         state->obj_domain = find_domain_by_sid(parent_domain,
                                                state->req_input.inp.secid);
         if (state->obj_domain == NULL) {
             DEBUG(SSSDBG_OP_FAILURE,
                   "find_domain_by_sid failed for SID [%s].\n",
                   state->req_input.inp.secid);
-            return EINVAL;
+            ret = EINVAL;
+            goto done;
         }
 
         break;
     default:
         DEBUG(SSSDBG_OP_FAILURE, "Unexpected input type [%d].\n",
                                  state->req_input.type);
-        return EINVAL;
+        ret = EINVAL;
+        goto done;
     }
 
-    ret = s2n_encode_request(state, state->obj_domain->name, state->entry_type,
-                             state->request_type, &state->req_input,
-                             state->protocol, &bv_req);
+    ret = s2n_encode_request(state, state->obj_domain->name,
+                             list_state->entry_type, list_state->request_type,
+                             &state->req_input, list_state->protocol, &bv_req);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "s2n_encode_request failed.\n");
-        return ret;
+        goto done;
     }
 
-    if (state->request_type == REQ_FULL_WITH_MEMBERS && state->protocol == EXTDOM_V0) {
+    if (list_state->request_type == REQ_FULL_WITH_MEMBERS
+            && list_state->protocol == EXTDOM_V0) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_exop failed, protocol > V0 needed for this request.\n");
-        return EINVAL;
+        ret = EINVAL;
+        goto done;
     }
 
     if (state->req_input.type == REQ_INP_NAME
             && state->req_input.inp.name != NULL) {
         DEBUG(SSSDBG_TRACE_FUNC,
               "Sending request_type: [%s] for object [%s].\n",
-              ipa_s2n_reqtype2str(state->request_type),
-              state->list[state->list_idx]);
+              ipa_s2n_reqtype2str(list_state->request_type), entry);
     }
 
-    subreq = ipa_s2n_exop_send(state, state->ev, state->sh, state->protocol,
-                               state->exop_timeout, bv_req);
+    subreq = ipa_s2n_exop_send(state, list_state->ev, list_state->sh,
+                               list_state->protocol, list_state->exop_timeout,
+                               bv_req);
     if (subreq == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_exop_send failed.\n");
-        return ENOMEM;
+        ret = ENOMEM;
+        goto done;
     }
-    tevent_req_set_callback(subreq, ipa_s2n_get_list_next, req);
+    tevent_req_set_callback(subreq, ipa_s2n_get_list_entry_next, req);
 
-    return EOK;
+    return req;
+
+done:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, list_state->ev);
+
+    return req;
 }
 
-static void ipa_s2n_get_list_next(struct tevent_req *subreq)
+static void ipa_s2n_get_list_entry_next(struct tevent_req *subreq)
 {
     int ret;
     struct tevent_req *req = tevent_req_callback_data(subreq,
                                                       struct tevent_req);
-    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
-                                               struct ipa_s2n_get_list_state);
+    struct ipa_s2n_get_list_entry_state *state = tevent_req_data(req,
+                                        struct ipa_s2n_get_list_entry_state);
+    struct ipa_s2n_get_list_state *list_state = state->list_state;
     char *retoid = NULL;
     struct berval *retdata = NULL;
     const char *sid_str;
@@ -1420,8 +1480,7 @@ static void ipa_s2n_get_list_next(struct tevent_req *subreq)
         goto fail;
     }
 
-    talloc_zfree(state->attrs);
-    ret = s2n_response_to_attrs(state, state->dom, retoid, retdata,
+    ret = s2n_response_to_attrs(state, list_state->dom, retoid, retdata,
                                 &state->attrs);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "s2n_response_to_attrs failed.\n");
@@ -1431,15 +1490,14 @@ static void ipa_s2n_get_list_next(struct tevent_req *subreq)
     DEBUG(SSSDBG_TRACE_FUNC, "Received [%s] attributes from IPA server.\n",
                              state->attrs->a.name);
 
-    if (is_default_view(state->ipa_ctx->view_name)) {
-        ret = ipa_s2n_get_list_save_step(req);
-        if (ret == EOK) {
-            tevent_req_done(req);
-        } else if (ret != EAGAIN) {
-            DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_save_step failed.\n");
+    if (is_default_view(list_state->ipa_ctx->view_name)) {
+        ret = ipa_s2n_get_list_entry_save(req);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_entry_save failed.\n");
             goto fail;
         }
 
+        tevent_req_done(req);
         return;
     }
 
@@ -1459,19 +1517,19 @@ static void ipa_s2n_get_list_next(struct tevent_req *subreq)
         goto fail;
     }
 
-    subreq = ipa_get_ad_override_send(state, state->ev,
-                           state->ipa_ctx->sdap_id_ctx,
-                           state->ipa_ctx->ipa_options,
-                           dp_opt_get_string(state->ipa_ctx->ipa_options->basic,
-                                             IPA_KRB5_REALM),
-                           state->ipa_ctx->view_name,
-                           ar);
+    subreq = ipa_get_ad_override_send(state, list_state->ev,
+                        list_state->ipa_ctx->sdap_id_ctx,
+                        list_state->ipa_ctx->ipa_options,
+                        dp_opt_get_string(list_state->ipa_ctx->ipa_options->basic,
+                                          IPA_KRB5_REALM),
+                        list_state->ipa_ctx->view_name,
+                        ar);
     if (subreq == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_get_ad_override_send failed.\n");
         ret = ENOMEM;
         goto fail;
     }
-    tevent_req_set_callback(subreq, ipa_s2n_get_list_get_override_done, req);
+    tevent_req_set_callback(subreq, ipa_s2n_get_list_entry_override_done, req);
 
     return;
 
@@ -1480,49 +1538,32 @@ fail:
     return;
 }
 
-static void ipa_s2n_get_list_ipa_next(struct tevent_req *subreq)
+static void ipa_s2n_get_list_entry_ipa_done(struct tevent_req *subreq)
 {
     int ret;
     int dp_error;
     struct tevent_req *req = tevent_req_callback_data(subreq,
                                                       struct tevent_req);
-    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
-                                               struct ipa_s2n_get_list_state);
 
     ret = ipa_id_get_account_info_recv(subreq, &dp_error);
     talloc_zfree(subreq);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_id_get_account_info failed: %d %d\n", ret,
                                  dp_error);
-        goto done;
-    }
-
-    state->list_idx++;
-    if (state->list[state->list_idx] == NULL) {
-        tevent_req_done(req);
+        tevent_req_error(req, ret);
         return;
     }
 
-    ret = ipa_s2n_get_list_step(req);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_step failed.\n");
-        goto done;
-    }
-
-    return;
-
-done:
-    tevent_req_error(req,ret);
-    return;
+    tevent_req_done(req);
 }
 
-static void ipa_s2n_get_list_get_override_done(struct tevent_req *subreq)
+static void ipa_s2n_get_list_entry_override_done(struct tevent_req *subreq)
 {
     int ret;
     struct tevent_req *req = tevent_req_callback_data(subreq,
                                                       struct tevent_req);
-    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
-                                               struct ipa_s2n_get_list_state);
+    struct ipa_s2n_get_list_entry_state *state = tevent_req_data(req,
+                                        struct ipa_s2n_get_list_entry_state);
 
     ret = ipa_get_ad_override_recv(subreq, NULL, state, &state->override_attrs);
     talloc_zfree(subreq);
@@ -1531,14 +1572,13 @@ static void ipa_s2n_get_list_get_override_done(struct tevent_req *subreq)
         goto fail;
     }
 
-    ret = ipa_s2n_get_list_save_step(req);
-    if (ret == EOK) {
-        tevent_req_done(req);
-    } else if (ret != EAGAIN) {
-        DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_save_step failed.\n");
+    ret = ipa_s2n_get_list_entry_save(req);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_entry_save failed.\n");
         goto fail;
     }
 
+    tevent_req_done(req);
     return;
 
 fail:
@@ -1546,33 +1586,88 @@ fail:
     return;
 }
 
-static errno_t ipa_s2n_get_list_save_step(struct tevent_req *req)
+static errno_t ipa_s2n_get_list_entry_save(struct tevent_req *req)
 {
     int ret;
-    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
-                                               struct ipa_s2n_get_list_state);
+    struct ipa_s2n_get_list_entry_state *state = tevent_req_data(req,
+                                        struct ipa_s2n_get_list_entry_state);
+    struct ipa_s2n_get_list_state *list_state = state->list_state;
 
-    ret = ipa_s2n_save_objects(state->dom, &state->req_input, state->attrs,
-                               NULL, state->ipa_ctx->view_name,
-                               state->override_attrs, state->mapped_attrs,
+    ret = ipa_s2n_save_objects(list_state->dom, &state->req_input, state->attrs,
+                               NULL, list_state->ipa_ctx->view_name,
+                               state->override_attrs, list_state->mapped_attrs,
                                false);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_save_objects failed.\n");
         return ret;
     }
 
-    state->list_idx++;
-    if (state->list[state->list_idx] == NULL) {
-        return EOK;
+    return EOK;
+}
+
+static int ipa_s2n_get_list_entry_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
+/* Fill the window with requests for the next entries of the list. */
+static errno_t ipa_s2n_get_list_step(struct tevent_req *req)
+{
+    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
+                                               struct ipa_s2n_get_list_state);
+    struct tevent_req *subreq;
+
+    while (state->num_in_flight < state->max_in_flight
+                && state->list[state->list_idx] != NULL) {
+        subreq = ipa_s2n_get_list_entry_send(state, state,
+                                             state->list[state->list_idx]);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_entry_send failed.\n");
+            return ENOMEM;
+        }
+        tevent_req_set_callback(subreq, ipa_s2n_get_list_entry_done, req);
+
+        state->list_idx++;
+        state->num_in_flight++;
+    }
+
+    return EOK;
+}
+
+static void ipa_s2n_get_list_entry_done(struct tevent_req *subreq)
+{
+    int ret;
+    struct tevent_req *req = tevent_req_callback_data(subreq,
+                                                      struct tevent_req);
+    struct ipa_s2n_get_list_state *state = tevent_req_data(req,
+                                               struct ipa_s2n_get_list_state);
+
+    ret = ipa_s2n_get_list_entry_recv(subreq);
+    talloc_zfree(subreq);
+    state->num_in_flight--;
+    if (ret != EOK) {
+        /* the remaining requests are freed together with the state */
+        DEBUG(SSSDBG_OP_FAILURE, "Lookup of list entry failed.\n");
+        goto done;
     }
 
     ret = ipa_s2n_get_list_step(req);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "ipa_s2n_get_list_step failed.\n");
-        return ret;
+        goto done;
     }
 
-    return EAGAIN;
+    if (state->num_in_flight == 0) {
+        tevent_req_done(req);
+    }
+
+    return;
+
+done:
+    tevent_req_error(req,ret);
+    return;
 }
 
 static int ipa_s2n_get_list_recv(struct tevent_req *req)
@@ -245,48 +245,6 @@ done:
 }
 
 
-static void krb5_auth_cache_creds(struct krb5_ctx *krb5_ctx,
-                                  struct sss_domain_info *domain,
-                                  struct confdb_ctx *cdb,
-                                  struct pam_data *pd, uid_t uid,
-                                  int *pam_status, int *dp_err)
-{
-    const char *password = NULL;
-    errno_t ret;
-
-    ret = sss_authtok_get_password(pd->authtok, &password, NULL);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_FATAL_FAILURE,
-              "Failed to get password [%d] %s. Delayed authentication is only "
-              "available for password authentication (single factor).\n",
-              ret, strerror(ret));
-        *pam_status = PAM_SYSTEM_ERR;
-        *dp_err = DP_ERR_OK;
-        return;
-    }
-
-    ret = sysdb_cache_auth(domain, pd->user,
-                           password, cdb, true, NULL, NULL);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Offline authentication failed\n");
-        *pam_status = cached_login_pam_status(ret);
-        *dp_err = DP_ERR_OK;
-        return;
-    }
-
-    ret = add_user_to_delayed_online_authentication(krb5_ctx, domain, pd, uid);
-    if (ret == ENOTSUP) {
-        /* This error is not fatal */
-        DEBUG(SSSDBG_MINOR_FAILURE, "Delayed authentication not supported\n");
-    } else if (ret != EOK) {
-        /* This error is not fatal */
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "add_user_to_delayed_online_authentication failed.\n");
-    }
-    *pam_status = PAM_AUTHINFO_UNAVAIL;
-    *dp_err = DP_ERR_OFFLINE;
-}
-
 static errno_t krb5_auth_prepare_ccache_name(struct krb5child_req *kr,
                                              struct ldb_message *user_msg,
                                              struct be_ctx *be_ctx)
@@ -332,82 +290,6 @@ static errno_t krb5_auth_prepare_ccache_name(struct krb5child_req *kr,
     return EOK;
 }
 
-static void krb5_auth_store_creds(struct sss_domain_info *domain,
-                                  struct pam_data *pd)
-{
-    const char *password = NULL;
-    const char *fa2;
-    size_t password_len;
-    size_t fa2_len = 0;
-    int ret = EOK;
-
-    switch(pd->cmd) {
-        case SSS_CMD_RENEW:
-            /* The authtok is set to the credential cache
-             * during renewal. We don't want to save this
-             * as the cached password.
-             */
-            break;
-        case SSS_PAM_PREAUTH:
-            /* There are no credentials available during pre-authentication,
-             * nothing to do. */
-            break;
-        case SSS_PAM_AUTHENTICATE:
-        case SSS_PAM_CHAUTHTOK_PRELIM:
-            if (sss_authtok_get_type(pd->authtok) == SSS_AUTHTOK_TYPE_2FA) {
-                ret = sss_authtok_get_2fa(pd->authtok, &password, &password_len,
-                                          &fa2, &fa2_len);
-                if (ret == EOK && password_len <
-                                      domain->cache_credentials_min_ff_length) {
-                    DEBUG(SSSDBG_FATAL_FAILURE,
-                          "First factor is too short to be cache, "
-                          "minimum length is [%u].\n",
-                          domain->cache_credentials_min_ff_length);
-                    ret = EINVAL;
-                }
-            } else if (sss_authtok_get_type(pd->authtok) ==
-                                                    SSS_AUTHTOK_TYPE_PASSWORD) {
-                ret = sss_authtok_get_password(pd->authtok, &password, NULL);
-            } else {
-                DEBUG(SSSDBG_MINOR_FAILURE, "Cannot cache authtok type [%d].\n",
-                      sss_authtok_get_type(pd->authtok));
-                ret = EINVAL;
-            }
-            break;
-        case SSS_PAM_CHAUTHTOK:
-            ret = sss_authtok_get_password(pd->newauthtok, &password, NULL);
-            break;
-        default:
-            DEBUG(SSSDBG_FATAL_FAILURE,
-                  "unsupported PAM command [%d].\n", pd->cmd);
-    }
-
-    if (ret != EOK) {
-        DEBUG(SSSDBG_FATAL_FAILURE,
-              "Failed to get password [%d] %s\n", ret, strerror(ret));
-        /* password caching failures are not fatal errors */
-        return;
-    }
-
-    if (password == NULL) {
-        if (pd->cmd != SSS_CMD_RENEW && pd->cmd != SSS_PAM_PREAUTH) {
-            DEBUG(SSSDBG_FATAL_FAILURE,
-                  "password not available, offline auth may not work.\n");
-            /* password caching failures are not fatal errors */
-        }
-        return;
-    }
-
-    ret = sysdb_cache_password_ex(domain, pd->user, password,
-                                  sss_authtok_get_type(pd->authtok), fa2_len);
-    if (ret) {
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Failed to cache password, offline auth may not work."
-                  " (%d)[%s]!?\n", ret, strerror(ret));
-        /* password caching failures are not fatal errors */
-    }
-}
-
 static bool is_otp_enabled(struct ldb_message *user_msg)
 {
     struct ldb_message_element *el;
@@ -808,6 +690,180 @@ done:
     }
 }
 
+static void krb5_auth_cache_creds_done(struct tevent_req *subreq);
+
+/* Checks the password against the cached one while offline. Returns EAGAIN
+ * if the request continues in krb5_auth_cache_creds_done(). */
+static errno_t krb5_auth_cache_creds(struct tevent_req *req)
+{
+    struct krb5_auth_state *state = tevent_req_data(req, struct krb5_auth_state);
+    struct tevent_req *subreq;
+    const char *password = NULL;
+    errno_t ret;
+
+    ret = sss_authtok_get_password(state->pd->authtok, &password, NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Failed to get password [%d] %s. Delayed authentication is only "
+              "available for password authentication (single factor).\n",
+              ret, strerror(ret));
+        state->pam_status = PAM_SYSTEM_ERR;
+        state->dp_err = DP_ERR_OK;
+        return EOK;
+    }
+
+    subreq = sysdb_cache_auth_send(state, state->ev, state->be_ctx->hash_pool,
+                                   state->domain, state->pd->user, password,
+                                   state->be_ctx->cdb, true);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, krb5_auth_cache_creds_done, req);
+
+    return EAGAIN;
+}
+
+static void krb5_auth_cache_creds_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req = tevent_req_callback_data(subreq, struct tevent_req);
+    struct krb5_auth_state *state = tevent_req_data(req, struct krb5_auth_state);
+    errno_t ret;
+
+    ret = sysdb_cache_auth_recv(subreq, NULL, NULL);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Offline authentication failed\n");
+        state->pam_status = cached_login_pam_status(ret);
+        state->dp_err = DP_ERR_OK;
+        tevent_req_done(req);
+        return;
+    }
+
+    ret = add_user_to_delayed_online_authentication(state->kr->krb5_ctx,
+                                                    state->domain, state->pd,
+                                                    state->kr->uid);
+    if (ret == ENOTSUP) {
+        /* This error is not fatal */
+        DEBUG(SSSDBG_MINOR_FAILURE, "Delayed authentication not supported\n");
+    } else if (ret != EOK) {
+        /* This error is not fatal */
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "add_user_to_delayed_online_authentication failed.\n");
+    }
+    state->pam_status = PAM_AUTHINFO_UNAVAIL;
+    state->dp_err = DP_ERR_OFFLINE;
+    tevent_req_done(req);
+}
+
+static void krb5_auth_store_creds_done(struct tevent_req *subreq);
+
+/* Saves the password for offline authentication. Returns EAGAIN if the
+ * request continues in krb5_auth_store_creds_done(), failures are not
+ * fatal. */
+static errno_t krb5_auth_store_creds(struct tevent_req *req)
+{
+    struct krb5_auth_state *state = tevent_req_data(req, struct krb5_auth_state);
+    struct sss_domain_info *domain = state->domain;
+    struct pam_data *pd = state->pd;
+    struct tevent_req *subreq;
+    const char *password = NULL;
+    const char *fa2;
+    size_t password_len;
+    size_t fa2_len = 0;
+    int ret = EOK;
+
+    switch(pd->cmd) {
+        case SSS_CMD_RENEW:
+            /* The authtok is set to the credential cache
+             * during renewal. We don't want to save this
+             * as the cached password.
+             */
+            break;
+        case SSS_PAM_PREAUTH:
+            /* There are no credentials available during pre-authentication,
+             * nothing to do. */
+            break;
+        case SSS_PAM_AUTHENTICATE:
+        case SSS_PAM_CHAUTHTOK_PRELIM:
+            if (sss_authtok_get_type(pd->authtok) == SSS_AUTHTOK_TYPE_2FA) {
+                ret = sss_authtok_get_2fa(pd->authtok, &password, &password_len,
+                                          &fa2, &fa2_len);
+                if (ret == EOK && password_len <
+                                      domain->cache_credentials_min_ff_length) {
+                    DEBUG(SSSDBG_FATAL_FAILURE,
+                          "First factor is too short to be cache, "
+                          "minimum length is [%u].\n",
+                          domain->cache_credentials_min_ff_length);
+                    ret = EINVAL;
+                }
+            } else if (sss_authtok_get_type(pd->authtok) ==
+                                                    SSS_AUTHTOK_TYPE_PASSWORD) {
+                ret = sss_authtok_get_password(pd->authtok, &password, NULL);
+            } else {
+                DEBUG(SSSDBG_MINOR_FAILURE, "Cannot cache authtok type [%d].\n",
+                      sss_authtok_get_type(pd->authtok));
+                ret = EINVAL;
+            }
+            break;
+        case SSS_PAM_CHAUTHTOK:
+            ret = sss_authtok_get_password(pd->newauthtok, &password, NULL);
+            break;
+        default:
+            DEBUG(SSSDBG_FATAL_FAILURE,
+                  "unsupported PAM command [%d].\n", pd->cmd);
+    }
+
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Failed to get password [%d] %s\n", ret, strerror(ret));
+        /* password caching failures are not fatal errors */
+        return EOK;
+    }
+
+    if (password == NULL) {
+        if (pd->cmd != SSS_CMD_RENEW && pd->cmd != SSS_PAM_PREAUTH) {
+            DEBUG(SSSDBG_FATAL_FAILURE,
+                  "password not available, offline auth may not work.\n");
+            /* password caching failures are not fatal errors */
+        }
+        return EOK;
+    }
+
+    subreq = sysdb_cache_password_ex_send(state, state->ev,
+                                          state->be_ctx->hash_pool,
+                                          domain, pd->user, password,
+                                          sss_authtok_get_type(pd->authtok),
+                                          fa2_len);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Failed to cache password, offline auth may not work.\n");
+        /* password caching failures are not fatal errors */
+        return EOK;
+    }
+
+    tevent_req_set_callback(subreq, krb5_auth_store_creds_done, req);
+
+    return EAGAIN;
+}
+
+static void krb5_auth_store_creds_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req = tevent_req_callback_data(subreq, struct tevent_req);
+    errno_t ret;
+
+    ret = sysdb_cache_password_ex_recv(subreq);
+    talloc_zfree(subreq);
+    if (ret) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Failed to cache password, offline auth may not work."
+                  " (%d)[%s]!?\n", ret, strerror(ret));
+        /* password caching failures are not fatal errors */
+    }
+
+    tevent_req_done(req);
+}
+
 static void krb5_auth_done(struct tevent_req *subreq)
 {
     struct tevent_req *req = tevent_req_callback_data(subreq, struct tevent_req);
@@ -824,6 +880,7 @@ static void krb5_auth_done(struct tevent_req *subreq)
     time_t renew_interval_time = 0;
     bool use_enterprise_principal;
     bool canonicalize;
+    bool store_creds;
 
     ret = handle_child_recv(subreq, pd, &buf, &len);
     talloc_zfree(subreq);
@@ -1142,27 +1199,25 @@ static void krb5_auth_done(struct tevent_req *subreq)
                             KRB5_STORE_PASSWORD_IF_OFFLINE)
                 && sss_authtok_get_type(pd->authtok)
                             == SSS_AUTHTOK_TYPE_PASSWORD) {
-            krb5_auth_cache_creds(state->kr->krb5_ctx,
-                                  state->domain,
-                                  state->be_ctx->cdb,
-                                  state->pd, state->kr->uid,
-                                  &state->pam_status, &state->dp_err);
+            ret = krb5_auth_cache_creds(req);
+            if (ret == EAGAIN) {
+                /* continues in krb5_auth_cache_creds_done() */
+                return;
+            }
         } else {
             DEBUG(SSSDBG_CONF_SETTINGS,
                   "Backend is marked offline, retry later!\n");
             state->pam_status = PAM_AUTHINFO_UNAVAIL;
             state->dp_err = DP_ERR_OFFLINE;
+            ret = EOK;
         }
-        ret = EOK;
         goto done;
     }
 
-    if (state->be_ctx->domain->cache_credentials == TRUE
-            && (!res->otp
-                || (res->otp && sss_authtok_get_type(pd->authtok) ==
-                                                       SSS_AUTHTOK_TYPE_2FA))) {
-        krb5_auth_store_creds(state->domain, pd);
-    }
+    store_creds = state->be_ctx->domain->cache_credentials == TRUE
+                    && (!res->otp
+                        || (res->otp && sss_authtok_get_type(pd->authtok) ==
+                                                       SSS_AUTHTOK_TYPE_2FA));
 
     /* The SSS_OTP message will prevent pam_sss from putting the entered
      * password on the PAM stack for other modules to use. This is not needed
@@ -1185,6 +1240,15 @@ static void krb5_auth_done(struct tevent_req *subreq)
 
     state->pam_status = PAM_SUCCESS;
     state->dp_err = DP_ERR_OK;
+
+    if (store_creds) {
+        ret = krb5_auth_store_creds(req);
+        if (ret == EAGAIN) {
+            /* continues in krb5_auth_store_creds_done() */
+            return;
+        }
+    }
+
     ret = EOK;
 
 done:
@@ -937,6 +937,7 @@ struct sdap_pam_auth_handler_state {
 };
 
 static void sdap_pam_auth_handler_done(struct tevent_req *subreq);
+static void sdap_pam_auth_handler_cache_done(struct tevent_req *subreq);
 
 struct tevent_req *
 sdap_pam_auth_handler_send(TALLOC_CTX *mem_ctx,
@@ -1067,18 +1068,22 @@ static void sdap_pam_auth_handler_done(struct tevent_req *subreq)
     if (ret == EOK && state->be_ctx->domain->cache_credentials) {
         ret = sss_authtok_get_password(state->pd->authtok, &password, NULL);
         if (ret == EOK) {
-            ret = sysdb_cache_password(state->be_ctx->domain, state->pd->user,
-                                       password);
+            subreq = sysdb_cache_password_ex_send(state, state->be_ctx->ev,
+                                                  state->be_ctx->hash_pool,
+                                                  state->be_ctx->domain,
+                                                  state->pd->user, password,
+                                                  SSS_AUTHTOK_TYPE_PASSWORD,
+                                                  0);
+            if (subreq != NULL) {
+                tevent_req_set_callback(subreq,
+                                        sdap_pam_auth_handler_cache_done, req);
+                return;
+            }
         }
 
         /* password caching failures are not fatal errors */
-        if (ret != EOK) {
-            DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password for %s\n",
-                  state->pd->user);
-        } else {
-            DEBUG(SSSDBG_CONF_SETTINGS, "Password successfully cached for %s\n",
-                  state->pd->user);
-        }
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password for %s\n",
+              state->pd->user);
     }
 
 done:
@@ -1086,6 +1091,31 @@ done:
     tevent_req_done(req);
 }
 
+static void sdap_pam_auth_handler_cache_done(struct tevent_req *subreq)
+{
+    struct sdap_pam_auth_handler_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_pam_auth_handler_state);
+
+    ret = sysdb_cache_password_ex_recv(subreq);
+    talloc_free(subreq);
+
+    /* password caching failures are not fatal errors */
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password for %s\n",
+              state->pd->user);
+    } else {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Password successfully cached for %s\n",
+              state->pd->user);
+    }
+
+    /* TODO For backward compatibility we always return EOK to DP now. */
+    tevent_req_done(req);
+}
+
 errno_t
 sdap_pam_auth_handler_recv(TALLOC_CTX *mem_ctx,
                            struct tevent_req *req,
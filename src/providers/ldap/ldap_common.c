@@ -814,6 +814,12 @@ sdap_attrs_get_sid_str(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+static int sdap_id_conn_ctx_destructor(struct sdap_id_conn_ctx *conn)
+{
+    be_fo_unset_probe_plugin(conn->id_ctx->be, conn->service->name, conn);
+    return 0;
+}
+
 struct sdap_id_conn_ctx *
 sdap_id_ctx_conn_add(struct sdap_id_ctx *id_ctx,
                      struct sdap_service *sdap_service)
@@ -836,6 +842,17 @@ sdap_id_ctx_conn_add(struct sdap_id_ctx *id_ctx,
     }
     DLIST_ADD_END(id_ctx->conn, conn, struct sdap_id_conn_ctx *);
 
+    ret = be_fo_set_probe_plugin(id_ctx->be, sdap_service->name,
+                                 sdap_fo_probe_send, sdap_fo_probe_recv,
+                                 conn, BE_FO_PROBE_PRIORITY_GENERIC,
+                                 "LDAP rootDSE");
+    if (ret != EOK) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Unable to set failover probe of service "
+              "%s [%d]: %s\n", sdap_service->name, ret, sss_strerror(ret));
+    } else {
+        talloc_set_destructor(conn, sdap_id_conn_ctx_destructor);
+    }
+
     return conn;
 }
 
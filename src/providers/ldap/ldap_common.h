@@ -416,6 +416,16 @@ sdap_set_sasl_options(struct sdap_options *id_opts,
                       char *default_realm,
                       const char *keytab_path);
 
+/* Failover probe plugin, connects to the server anonymously and reads its
+ * rootDSE. 'pvt' is the struct sdap_id_conn_ctx of the probed service. */
+struct tevent_req *sdap_fo_probe_send(TALLOC_CTX *mem_ctx,
+                                      struct tevent_context *ev,
+                                      struct be_ctx *be_ctx,
+                                      const char *service_name,
+                                      struct fo_server *server,
+                                      void *pvt);
+errno_t sdap_fo_probe_recv(struct tevent_req *req);
+
 struct sdap_id_conn_ctx *
 sdap_id_ctx_conn_add(struct sdap_id_ctx *id_ctx,
                      struct sdap_service *sdap_service);
@@ -45,6 +45,11 @@ struct sdap_op {
 
     int msgid;
     bool done;
+    uint64_t start;
+    /* time the request was sent and whether the server answered already,
+     * used to record latency of the server */
+    struct timeval sent;
+    bool answered;
 
     sdap_op_callback_t *callback;
     void *data;
@@ -89,6 +94,12 @@ struct sdap_handle {
 
     struct sdap_op *ops;
 
+    /* fail over server the handle is connected to, if set the response
+     * time of each operation is recorded as latency of the server */
+    struct be_ctx *be;
+    const char *fo_service_name;
+    struct fo_server *fo_server;
+
     /* during release we need to lock access to the handler
      * from the destructor to avoid recursion */
     bool destructor_lock;
@@ -24,6 +24,7 @@
 #include "util/util.h"
 #include "util/strtonum.h"
 #include "util/probes.h"
+#include "util/sss_metrics.h"
 #include "providers/ldap/sdap_async_private.h"
 
 #define REPLY_REALLOC_INCREMENT 10
@@ -240,6 +241,54 @@ static const char *sdap_ldap_result_str(int msgtype)
     return "Unknown result type!";
 }
 
+/* operation label of the LDAP duration metric */
+static const char *sdap_ldap_op_str(int msgtype)
+{
+    switch (msgtype) {
+    case LDAP_RES_BIND:
+        return "bind";
+    case LDAP_RES_SEARCH_RESULT:
+        return "search";
+    case LDAP_RES_MODIFY:
+        return "modify";
+    case LDAP_RES_ADD:
+        return "add";
+    case LDAP_RES_DELETE:
+        return "delete";
+    case LDAP_RES_MODDN:
+        return "rename";
+    case LDAP_RES_COMPARE:
+        return "compare";
+    case LDAP_RES_EXTENDED:
+    case LDAP_RES_INTERMEDIATE:
+        return "extended";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
+
+/* Record the time until the first reply of an operation, or until it
+ * timed out, as response latency of the server. Later replies of a search
+ * only show how many entries there are. */
+static void sdap_op_record_latency(struct sdap_op *op)
+{
+    struct sdap_handle *sh = op->sh;
+
+    if (op->answered) {
+        return;
+    }
+    op->answered = true;
+
+    if (sh->fo_server == NULL) {
+        return;
+    }
+
+    be_fo_set_server_latency(sh->be, sh->fo_service_name, sh->fo_server,
+                             FO_LATENCY_RESPONSE, op->sent);
+}
+
 /* process a message calling the right operation callback.
  * msg is completely taken care of (including freeing it)
  * NOTE: this function may even end up freeing the sdap_handle
@@ -286,6 +335,8 @@ static void sdap_process_message(struct tevent_context *ev,
     DEBUG(SSSDBG_TRACE_ALL,
           "Message type: [%s]\n", sdap_ldap_result_str(msgtype));
 
+    sdap_op_record_latency(op);
+
     switch (msgtype) {
     case LDAP_RES_SEARCH_ENTRY:
     case LDAP_RES_SEARCH_REFERENCE:
@@ -303,6 +354,8 @@ static void sdap_process_message(struct tevent_context *ev,
     case LDAP_RES_INTERMEDIATE:
         /* no more results expected with this msgid */
         op->done = true;
+        sss_metrics_observe(SSS_METRICS_LDAP_OP_DURATION,
+                            sdap_ldap_op_str(msgtype), NULL, op->start);
         break;
 
     default:
@@ -420,6 +473,8 @@ static void sdap_op_timeout(struct tevent_req *req)
 
     /* signal the caller that we have a timeout */
     DEBUG(SSSDBG_TRACE_LIBS, "Issuing timeout [ldap_opt_timeout] for message id %d\n", op->msgid);
+    sss_metrics_inc(SSS_METRICS_LDAP_OP_TIMEOUTS, NULL, NULL);
+    sdap_op_record_latency(op);
     op->callback(op, NULL, ETIMEDOUT, op->data);
 }
 
@@ -438,6 +493,8 @@ int sdap_op_add(TALLOC_CTX *memctx, struct tevent_context *ev,
     op->callback = callback;
     op->data = data;
     op->ev = ev;
+    op->start = sss_metrics_now();
+    op->sent = tevent_timeval_current();
 
     DEBUG(SSSDBG_TRACE_INTERNAL,
           "New operation %d timeout %d\n", op->msgid, timeout);
@@ -631,6 +631,173 @@ errno_t sdap_connect_host_recv(TALLOC_CTX *mem_ctx,
 }
 
 
+/* ==Failover-Probe======================================================= */
+
+struct sdap_fo_probe_state {
+    struct tevent_context *ev;
+    struct be_ctx *be_ctx;
+    struct sdap_options *opts;
+    const char *service_name;
+    struct fo_server *server;
+    struct sdap_handle *sh;
+    struct timeval op_start;
+};
+
+static void sdap_fo_probe_connect_done(struct tevent_req *subreq);
+static void sdap_fo_probe_rootdse_done(struct tevent_req *subreq);
+
+static const char *sdap_fo_probe_protocol(TALLOC_CTX *mem_ctx,
+                                          struct fo_server *server)
+{
+    const char *user_data;
+    const char *sep;
+
+    user_data = (const char *)fo_get_server_user_data(server);
+    if (user_data == NULL) {
+        return SSS_LDAP_SRV_NAME;
+    }
+
+    if (fo_is_srv_lookup(server)) {
+        /* user data is the name of the DNS service */
+        return user_data;
+    }
+
+    /* user data is the URI of the server */
+    sep = strstr(user_data, "://");
+    if (sep == NULL) {
+        return SSS_LDAP_SRV_NAME;
+    }
+
+    return talloc_strndup(mem_ctx, user_data, sep - user_data);
+}
+
+struct tevent_req *sdap_fo_probe_send(TALLOC_CTX *mem_ctx,
+                                      struct tevent_context *ev,
+                                      struct be_ctx *be_ctx,
+                                      const char *service_name,
+                                      struct fo_server *server,
+                                      void *pvt)
+{
+    struct sdap_id_conn_ctx *conn;
+    struct sdap_fo_probe_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    const char *protocol;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct sdap_fo_probe_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    conn = talloc_get_type(pvt, struct sdap_id_conn_ctx);
+    if (conn == NULL || conn->id_ctx->opts == NULL) {
+        ret = EINVAL;
+        goto immediately;
+    }
+
+    state->ev = ev;
+    state->be_ctx = be_ctx;
+    state->opts = conn->id_ctx->opts;
+    state->server = server;
+    state->service_name = talloc_strdup(state, service_name);
+    if (state->service_name == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    protocol = sdap_fo_probe_protocol(state, server);
+    if (protocol == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    state->op_start = tevent_timeval_current();
+    subreq = sdap_connect_host_send(state, ev, state->opts,
+                                    be_ctx->be_res->resolv,
+                                    be_ctx->be_res->family_order,
+                                    default_host_dbs, protocol,
+                                    fo_get_server_name(server),
+                                    fo_get_server_port(server), false);
+    if (subreq == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    tevent_req_set_callback(subreq, sdap_fo_probe_connect_done, req);
+
+    return req;
+
+immediately:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static void sdap_fo_probe_connect_done(struct tevent_req *subreq)
+{
+    struct sdap_fo_probe_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_fo_probe_state);
+
+    ret = sdap_connect_host_recv(state, subreq, &state->sh);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    be_fo_set_server_latency(state->be_ctx, state->service_name,
+                             state->server, FO_LATENCY_CONNECT,
+                             state->op_start);
+
+    state->op_start = tevent_timeval_current();
+    subreq = sdap_get_rootdse_send(state, state->ev, state->opts, state->sh);
+    if (subreq == NULL) {
+        tevent_req_error(req, ENOMEM);
+        return;
+    }
+
+    tevent_req_set_callback(subreq, sdap_fo_probe_rootdse_done, req);
+}
+
+static void sdap_fo_probe_rootdse_done(struct tevent_req *subreq)
+{
+    struct sdap_fo_probe_state *state;
+    struct sysdb_attrs *rootdse;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_fo_probe_state);
+
+    ret = sdap_get_rootdse_recv(subreq, state, &rootdse);
+    talloc_zfree(subreq);
+    talloc_zfree(state->sh);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    be_fo_set_server_latency(state->be_ctx, state->service_name,
+                             state->server, FO_LATENCY_RESPONSE,
+                             state->op_start);
+
+    tevent_req_done(req);
+}
+
+errno_t sdap_fo_probe_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
 /* ==Simple-Bind========================================================== */
 
 struct simple_bind_state {
@@ -1444,6 +1611,9 @@ struct sdap_cli_connect_state {
     struct sdap_handle *sh;
 
     struct fo_server *srv;
+    /* Start of the last connect or rootDSE request, used to measure
+     * latency of the server */
+    struct timeval op_start;
 
     struct sdap_server_opts *srv_opts;
 
@@ -1581,6 +1751,7 @@ static void sdap_cli_resolve_done(struct tevent_req *subreq)
         return;
     }
 
+    state->op_start = tevent_timeval_current();
     subreq = sdap_connect_send(state, state->ev, state->opts,
                                state->service->uri,
                                state->service->sockaddr,
@@ -1636,6 +1807,9 @@ static void sdap_cli_connect_done(struct tevent_req *subreq)
     }
     state->retry_attempts = 0;
 
+    be_fo_set_server_latency(state->be, state->service->name, state->srv,
+                             FO_LATENCY_CONNECT, state->op_start);
+
     if (state->use_rootdse) {
         /* fetch the rootDSE this time */
         sdap_cli_rootdse_step(req);
@@ -1669,6 +1843,7 @@ static void sdap_cli_rootdse_step(struct tevent_req *req)
     struct tevent_req *subreq;
     int ret;
 
+    state->op_start = tevent_timeval_current();
     subreq = sdap_get_rootdse_send(state, state->ev, state->opts, state->sh);
     if (!subreq) {
         tevent_req_error(req, ENOMEM);
@@ -1717,6 +1892,9 @@ static void sdap_cli_rootdse_done(struct tevent_req *subreq)
          * work properly.
          */
         state->rootdse = NULL;
+    } else {
+        be_fo_set_server_latency(state->be, state->service->name, state->srv,
+                                 FO_LATENCY_RESPONSE, state->op_start);
     }
 
 
@@ -2147,6 +2325,14 @@ int sdap_cli_connect_recv(struct tevent_req *req,
         if (!*gsh) {
             return ENOMEM;
         }
+
+        if (state->srv) {
+            /* From now on every operation is a latency sample. */
+            (*gsh)->be = state->be;
+            (*gsh)->fo_service_name = state->service->name;
+            (*gsh)->fo_server = state->srv;
+            fo_ref_server(*gsh, state->srv);
+        }
     } else {
         talloc_zfree(state->sh);
     }
@@ -251,18 +251,254 @@ done:
     return ret;
 }
 
+/* Unknown SIDs are looked up with OR filters of up to
+ * SDAP_AD_RESOLVE_SIDS_BATCH_SIZE SIDs of the same domain and up to
+ * SDAP_AD_RESOLVE_SIDS_MAX_BATCHES of these searches run at the same time.
+ * All groups found by one search are saved in a single sysdb transaction. */
+#define SDAP_AD_RESOLVE_SIDS_BATCH_SIZE 50
+#define SDAP_AD_RESOLVE_SIDS_MAX_BATCHES 4
+
+struct sdap_ad_resolve_sids_batch_state {
+    struct tevent_context *ev;
+    struct sdap_id_ctx *id_ctx;
+    struct sdap_domain *sdom;
+    struct sdap_id_op *op;
+    const char **attrs;
+    char *filter;
+    int dp_error;
+};
+
+static errno_t sdap_ad_resolve_sids_batch_retry(struct tevent_req *req);
+static void sdap_ad_resolve_sids_batch_connect_done(struct tevent_req *subreq);
+static void sdap_ad_resolve_sids_batch_done(struct tevent_req *subreq);
+
+static struct tevent_req *
+sdap_ad_resolve_sids_batch_send(TALLOC_CTX *mem_ctx,
+                                struct tevent_context *ev,
+                                struct sdap_id_ctx *id_ctx,
+                                struct sdap_id_conn_ctx *conn,
+                                struct sdap_domain *sdom,
+                                const char **sids,
+                                size_t num_sids)
+{
+    struct sdap_ad_resolve_sids_batch_state *state = NULL;
+    struct sdap_attr_map *group_map = id_ctx->opts->group_map;
+    struct tevent_req *req = NULL;
+    const char *member_filter[2];
+    char *sid_filter;
+    char *clean_sid;
+    char *oc_list;
+    size_t i;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct sdap_ad_resolve_sids_batch_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->id_ctx = id_ctx;
+    state->sdom = sdom;
+    state->dp_error = DP_ERR_FATAL;
+
+    state->op = sdap_id_op_create(state, conn->conn_cache);
+    if (state->op == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "sdap_id_op_create failed\n");
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    sid_filter = talloc_strdup(state, "");
+    if (sid_filter == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    for (i = 0; i < num_sids; i++) {
+        ret = sss_filter_sanitize(state, sids[i], &clean_sid);
+        if (ret != EOK) {
+            goto immediately;
+        }
+
+        sid_filter = talloc_asprintf_append_buffer(sid_filter, "(%s=%s)",
+                                   group_map[SDAP_AT_GROUP_OBJECTSID].name,
+                                   clean_sid);
+        talloc_free(clean_sid);
+        if (sid_filter == NULL) {
+            ret = ENOMEM;
+            goto immediately;
+        }
+    }
+
+    oc_list = sdap_make_oc_list(state, group_map);
+    if (oc_list == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to create objectClass list.\n");
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    state->filter = talloc_asprintf(state, "(&(|%s)(%s)(%s=*))",
+                                    sid_filter, oc_list,
+                                    group_map[SDAP_AT_GROUP_NAME].name);
+    if (state->filter == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    member_filter[0] = group_map[SDAP_AT_GROUP_MEMBER].name;
+    member_filter[1] = NULL;
+
+    ret = build_attrs_from_map(state, group_map, SDAP_OPTS_GROUP,
+                               member_filter, &state->attrs, NULL);
+    if (ret != EOK) {
+        goto immediately;
+    }
+
+    ret = sdap_ad_resolve_sids_batch_retry(req);
+    if (ret != EOK) {
+        goto immediately;
+    }
+
+    return req;
+
+immediately:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static errno_t sdap_ad_resolve_sids_batch_retry(struct tevent_req *req)
+{
+    struct sdap_ad_resolve_sids_batch_state *state = NULL;
+    struct tevent_req *subreq = NULL;
+    errno_t ret = EOK;
+
+    state = tevent_req_data(req, struct sdap_ad_resolve_sids_batch_state);
+
+    subreq = sdap_id_op_connect_send(state->op, state, &ret);
+    if (subreq == NULL) {
+        return ret;
+    }
+
+    tevent_req_set_callback(subreq, sdap_ad_resolve_sids_batch_connect_done,
+                            req);
+
+    return EOK;
+}
+
+static void sdap_ad_resolve_sids_batch_connect_done(struct tevent_req *subreq)
+{
+    struct sdap_ad_resolve_sids_batch_state *state = NULL;
+    struct tevent_req *req = NULL;
+    int dp_error = DP_ERR_FATAL;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_ad_resolve_sids_batch_state);
+
+    ret = sdap_id_op_connect_recv(subreq, &dp_error);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        state->dp_error = dp_error;
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    subreq = sdap_get_groups_send(state, state->ev, state->sdom,
+                                  state->id_ctx->opts,
+                                  sdap_id_op_handle(state->op),
+                                  state->attrs, state->filter,
+                                  dp_opt_get_int(state->id_ctx->opts->basic,
+                                                 SDAP_SEARCH_TIMEOUT),
+                                  SDAP_LOOKUP_WILDCARD, true);
+    if (subreq == NULL) {
+        tevent_req_error(req, ENOMEM);
+        return;
+    }
+
+    tevent_req_set_callback(subreq, sdap_ad_resolve_sids_batch_done, req);
+}
+
+static void sdap_ad_resolve_sids_batch_done(struct tevent_req *subreq)
+{
+    struct sdap_ad_resolve_sids_batch_state *state = NULL;
+    struct tevent_req *req = NULL;
+    int dp_error = DP_ERR_FATAL;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_ad_resolve_sids_batch_state);
+
+    ret = sdap_get_groups_recv(subreq, NULL, NULL);
+    talloc_zfree(subreq);
+    ret = sdap_id_op_done(state->op, ret, &dp_error);
+    if (dp_error == DP_ERR_OK && ret != EOK) {
+        /* retry */
+        ret = sdap_ad_resolve_sids_batch_retry(req);
+        if (ret != EOK) {
+            tevent_req_error(req, ret);
+        }
+
+        return;
+    }
+
+    state->dp_error = dp_error;
+
+    if (ret == ENOENT) {
+        /* None of the groups was found, we will ignore the error. This may
+         * happen for example if the groups are built-in, but a custom search
+         * base is provided. */
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to resolve any SID of the batch "
+                                    "- will continue.\n");
+        ret = EOK;
+    }
+
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static errno_t sdap_ad_resolve_sids_batch_recv(struct tevent_req *req,
+                                               int *_dp_error)
+{
+    struct sdap_ad_resolve_sids_batch_state *state = NULL;
+
+    state = tevent_req_data(req, struct sdap_ad_resolve_sids_batch_state);
+
+    *_dp_error = state->dp_error;
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
+struct sdap_ad_sid_batch {
+    struct sdap_domain *sdom;
+    const char **sids;
+    size_t num_sids;
+};
+
 struct sdap_ad_resolve_sids_state {
     struct tevent_context *ev;
     struct sdap_id_ctx *id_ctx;
     struct sdap_id_conn_ctx *conn;
     struct sdap_options *opts;
     struct sss_domain_info *domain;
-    char **sids;
 
-    const char *current_sid;
-    int index;
+    struct sdap_ad_sid_batch *batches;
+    size_t num_batches;
+    size_t batch_idx;
+    size_t num_in_flight;
 };
 
+static errno_t sdap_ad_resolve_sids_split(struct sdap_ad_resolve_sids_state *state,
+                                          char **sids);
 static errno_t sdap_ad_resolve_sids_step(struct tevent_req *req);
 static void sdap_ad_resolve_sids_done(struct tevent_req *subreq);
 
@@ -291,14 +527,19 @@ sdap_ad_resolve_sids_send(TALLOC_CTX *mem_ctx,
     state->conn = conn;
     state->opts = opts;
     state->domain = get_domains_head(domain);
-    state->sids = sids;
-    state->index = 0;
+    state->batch_idx = 0;
+    state->num_in_flight = 0;
 
-    if (state->sids == NULL || state->sids[0] == NULL) {
+    if (sids == NULL || sids[0] == NULL) {
         ret = EOK;
         goto immediately;
     }
 
+    ret = sdap_ad_resolve_sids_split(state, sids);
+    if (ret != EOK) {
+        goto immediately;
+    }
+
     ret = sdap_ad_resolve_sids_step(req);
     if (ret != EAGAIN) {
         goto immediately;
@@ -317,47 +558,106 @@ immediately:
     return req;
 }
 
-static errno_t sdap_ad_resolve_sids_step(struct tevent_req *req)
+/* Group the SIDs by domain into batches of bounded size. */
+static errno_t sdap_ad_resolve_sids_split(struct sdap_ad_resolve_sids_state *state,
+                                          char **sids)
 {
-    struct sdap_ad_resolve_sids_state *state = NULL;
-    struct tevent_req *subreq = NULL;
+    struct sdap_ad_sid_batch *batch;
     struct sdap_domain *sdap_domain = NULL;
     struct sss_domain_info *domain = NULL;
+    size_t batch_size;
+    size_t num_sids;
+    size_t i;
+    size_t j;
+    int limit;
 
-    state = tevent_req_data(req, struct sdap_ad_resolve_sids_state);
+    batch_size = SDAP_AD_RESOLVE_SIDS_BATCH_SIZE;
+    limit = dp_opt_get_int(state->opts->basic, SDAP_WILDCARD_LIMIT);
+    if (limit > 0 && (size_t) limit < batch_size) {
+        batch_size = limit;
+    }
 
-    do {
-        state->current_sid = state->sids[state->index];
-        if (state->current_sid == NULL) {
-            return EOK;
-        }
-        state->index++;
+    for (num_sids = 0; sids[num_sids] != NULL; num_sids++);
 
-        domain = sss_get_domain_by_sid_ldap_fallback(state->domain,
-                                                     state->current_sid);
+    /* there can't be more batches than SIDs */
+    state->batches = talloc_zero_array(state, struct sdap_ad_sid_batch,
+                                       num_sids);
+    if (state->batches == NULL) {
+        return ENOMEM;
+    }
+    state->num_batches = 0;
 
+    for (i = 0; i < num_sids; i++) {
+        domain = sss_get_domain_by_sid_ldap_fallback(state->domain, sids[i]);
         if (domain == NULL) {
             DEBUG(SSSDBG_MINOR_FAILURE, "SID %s does not belong to any known "
-                                         "domain\n", state->current_sid);
+                                         "domain\n", sids[i]);
+            continue;
         }
-    } while (domain == NULL);
 
-    sdap_domain = sdap_domain_get(state->opts, domain);
-    if (sdap_domain == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "SDAP domain does not exist?\n");
-        return ERR_INTERNAL;
-    }
+        sdap_domain = sdap_domain_get(state->opts, domain);
+        if (sdap_domain == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "SDAP domain does not exist?\n");
+            return ERR_INTERNAL;
+        }
 
-    subreq = groups_get_send(state, state->ev, state->id_ctx, sdap_domain,
-                             state->conn, state->current_sid,
-                             BE_FILTER_SECID, false, true);
-    if (subreq == NULL) {
-        return ENOMEM;
+        batch = NULL;
+        for (j = 0; j < state->num_batches; j++) {
+            if (state->batches[j].sdom == sdap_domain
+                    && state->batches[j].num_sids < batch_size) {
+                batch = &state->batches[j];
+                break;
+            }
+        }
+
+        if (batch == NULL) {
+            batch = &state->batches[state->num_batches];
+            batch->sdom = sdap_domain;
+            batch->sids = talloc_zero_array(state->batches, const char *,
+                                            batch_size + 1);
+            if (batch->sids == NULL) {
+                return ENOMEM;
+            }
+            state->num_batches++;
+        }
+
+        batch->sids[batch->num_sids] = sids[i];
+        batch->num_sids++;
     }
 
-    tevent_req_set_callback(subreq, sdap_ad_resolve_sids_done, req);
+    DEBUG(SSSDBG_TRACE_FUNC, "Resolving %zu SIDs in %zu batches.\n",
+                             num_sids, state->num_batches);
+
+    return EOK;
+}
+
+static errno_t sdap_ad_resolve_sids_step(struct tevent_req *req)
+{
+    struct sdap_ad_resolve_sids_state *state = NULL;
+    struct sdap_ad_sid_batch *batch;
+    struct tevent_req *subreq = NULL;
+
+    state = tevent_req_data(req, struct sdap_ad_resolve_sids_state);
+
+    while (state->num_in_flight < SDAP_AD_RESOLVE_SIDS_MAX_BATCHES
+                && state->batch_idx < state->num_batches) {
+        batch = &state->batches[state->batch_idx];
+
+        subreq = sdap_ad_resolve_sids_batch_send(state, state->ev,
+                                                 state->id_ctx, state->conn,
+                                                 batch->sdom, batch->sids,
+                                                 batch->num_sids);
+        if (subreq == NULL) {
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, sdap_ad_resolve_sids_done, req);
 
-    return EAGAIN;
+        state->batch_idx++;
+        state->num_in_flight++;
+    }
+
+    return state->num_in_flight == 0 ? EOK : EAGAIN;
 }
 
 static void sdap_ad_resolve_sids_done(struct tevent_req *subreq)
@@ -365,32 +665,26 @@ static void sdap_ad_resolve_sids_done(struct tevent_req *subreq)
     struct sdap_ad_resolve_sids_state *state = NULL;
     struct tevent_req *req = NULL;
     int dp_error;
-    int sdap_error;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
     state = tevent_req_data(req, struct sdap_ad_resolve_sids_state);
 
-    ret = groups_get_recv(subreq, &dp_error, &sdap_error);
+    ret = sdap_ad_resolve_sids_batch_recv(subreq, &dp_error);
     talloc_zfree(subreq);
-
-    if (ret == EOK && sdap_error == ENOENT && dp_error == DP_ERR_OK) {
-        /* Group was not found, we will ignore the error and continue with
-         * next group. This may happen for example if the group is built-in,
-         * but a custom search base is provided. */
-        DEBUG(SSSDBG_MINOR_FAILURE,
-              "Unable to resolve SID %s - will try next sid.\n",
-              state->current_sid);
-    } else if (ret != EOK || sdap_error != EOK || dp_error != DP_ERR_OK) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to resolve SID %s [dp_error: %d, "
-              "sdap_error: %d, ret: %d]: %s\n", state->current_sid, dp_error,
-              sdap_error, ret, strerror(ret));
+    state->num_in_flight--;
+    if (ret != EOK || dp_error != DP_ERR_OK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to resolve SIDs [dp_error: %d, "
+              "ret: %d]: %s\n", dp_error, ret, strerror(ret));
+        if (ret == EOK) {
+            ret = EIO;
+        }
         goto done;
     }
 
     ret = sdap_ad_resolve_sids_step(req);
     if (ret == EAGAIN) {
-        /* continue with next SID */
+        /* more batches are in progress */
         return;
     }
 
@@ -79,6 +79,12 @@ errno_t sdap_setup_certmap(struct sdap_certmap_ctx *sdap_certmap_ctx,
         goto done;
     }
 
+    ret = sss_certmap_enable_cache(sss_certmap_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sss_certmap_enable_cache failed.\n");
+        goto done;
+    }
+
     for (c = 0; certmap_list[c] != NULL; c++) {
         DEBUG(SSSDBG_TRACE_ALL, "Trying to add rule [%s][%d][%s][%s].\n",
                                 certmap_list[c]->name,
@@ -95,6 +95,9 @@ static void sdap_id_op_hook_conn_data(struct sdap_id_op *op, struct sdap_id_conn
 static int sdap_id_op_destroy(void *pvt);
 static bool sdap_id_op_can_reconnect(struct sdap_id_op *op);
 
+static int sdap_id_conn_cache_connect(struct sdap_id_conn_cache *conn_cache,
+                                      struct sdap_id_conn_data **_conn_data);
+
 static void sdap_id_op_connect_req_complete(struct sdap_id_op *op, int dp_error, int ret);
 static int sdap_id_op_connect_state_destroy(void *pvt);
 static int sdap_id_op_connect_step(struct tevent_req *req);
@@ -158,11 +161,33 @@ static void sdap_id_conn_cache_fo_reconnect_cb(void *pvt)
 {
     struct sdap_id_conn_cache *conn_cache = talloc_get_type(pvt, struct sdap_id_conn_cache);
     struct sdap_id_conn_data *cached_connection = conn_cache->cached_connection;
+    struct be_ctx *be = conn_cache->id_conn->id_ctx->be;
+    struct sdap_id_conn_data *conn_data;
+    int ret;
 
     /* Release any cached connection on going offline */
     if (cached_connection != NULL) {
         cached_connection->disconnecting = true;
     }
+
+    /* Only connections that were actually used are re-established, there is
+     * nothing to gain for a connection that is still being set up. */
+    if (be->be_fo == NULL || !be->be_fo->hot_standby || be_is_offline(be)
+            || cached_connection == NULL
+            || cached_connection->connect_req != NULL) {
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Opening hot standby connection\n");
+
+    conn_cache->cached_connection = NULL;
+    ret = sdap_id_conn_cache_connect(conn_cache, &conn_data);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to open hot standby connection "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+    }
+
+    sdap_id_release_conn_data(cached_connection);
 }
 
 /* Release sdap_id_conn_data and destroy it if no longer needed */
@@ -460,6 +485,45 @@ done:
     return req;
 }
 
+/* Start a new connection and make it the cached connection */
+static int sdap_id_conn_cache_connect(struct sdap_id_conn_cache *conn_cache,
+                                      struct sdap_id_conn_data **_conn_data)
+{
+    struct sdap_id_conn_ctx *id_conn = conn_cache->id_conn;
+    struct sdap_id_conn_data *conn_data;
+    struct tevent_req *subreq;
+
+    DEBUG(SSSDBG_TRACE_ALL, "beginning to connect\n");
+
+    conn_data = talloc_zero(conn_cache, struct sdap_id_conn_data);
+    if (!conn_data) {
+        return ENOMEM;
+    }
+
+    talloc_set_destructor(conn_data, sdap_id_conn_data_destroy);
+
+    conn_data->conn_cache = conn_cache;
+    subreq = sdap_cli_connect_send(conn_data, id_conn->id_ctx->be->ev,
+                                   id_conn->id_ctx->opts,
+                                   id_conn->id_ctx->be,
+                                   id_conn->service, false,
+                                   CON_TLS_DFL, false);
+
+    if (!subreq) {
+        talloc_free(conn_data);
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sdap_id_op_connect_done, conn_data);
+    conn_data->connect_req = subreq;
+
+    DLIST_ADD(conn_cache->connections, conn_data);
+    conn_cache->cached_connection = conn_data;
+
+    *_conn_data = conn_data;
+    return EOK;
+}
+
 /* Begin a connection retry to LDAP server */
 static int sdap_id_op_connect_step(struct tevent_req *req)
 {
@@ -470,7 +534,6 @@ static int sdap_id_op_connect_step(struct tevent_req *req)
 
     int ret = EOK;
     struct sdap_id_conn_data *conn_data;
-    struct tevent_req *subreq = NULL;
 
     /* Try to reuse context cached connection */
     conn_data = conn_cache->cached_connection;
@@ -492,45 +555,14 @@ static int sdap_id_op_connect_step(struct tevent_req *req)
         sdap_id_release_conn_data(conn_data);
     }
 
-    DEBUG(SSSDBG_TRACE_ALL, "beginning to connect\n");
-
-    conn_data = talloc_zero(conn_cache, struct sdap_id_conn_data);
-    if (!conn_data) {
-        ret = ENOMEM;
-        goto done;
-    }
-
-    talloc_set_destructor(conn_data, sdap_id_conn_data_destroy);
-
-    conn_data->conn_cache = conn_cache;
-    subreq = sdap_cli_connect_send(conn_data, state->ev,
-                                   state->id_conn->id_ctx->opts,
-                                   state->id_conn->id_ctx->be,
-                                   state->id_conn->service, false,
-                                   CON_TLS_DFL, false);
-
-    if (!subreq) {
-        ret = ENOMEM;
+    ret = sdap_id_conn_cache_connect(conn_cache, &conn_data);
+    if (ret != EOK) {
         goto done;
     }
 
-    tevent_req_set_callback(subreq, sdap_id_op_connect_done, conn_data);
-    conn_data->connect_req = subreq;
-
-    DLIST_ADD(conn_cache->connections, conn_data);
-    conn_cache->cached_connection = conn_data;
-
     sdap_id_op_hook_conn_data(op, conn_data);
 
 done:
-    if (ret != EOK && conn_data) {
-        sdap_id_release_conn_data(conn_data);
-    }
-
-    if (ret != EOK) {
-        talloc_zfree(subreq);
-    }
-
     return ret;
 }
 
@@ -705,6 +705,7 @@ struct proxy_pam_handler_state {
 };
 
 static void proxy_pam_handler_done(struct tevent_req *subreq);
+static void proxy_pam_handler_cache_done(struct tevent_req *subreq);
 
 struct tevent_req *
 proxy_pam_handler_send(TALLOC_CTX *mem_ctx,
@@ -815,14 +816,19 @@ static void proxy_pam_handler_done(struct tevent_req *subreq)
             goto done;
         }
 
-        ret = sysdb_cache_password(state->be_ctx->domain, state->pd->user, password);
-
-        /* password caching failures are not fatal errors */
-        /* so we just log it any return */
-        if (ret != EOK) {
-            DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password (%d)[%s]!?\n",
-                  ret, sss_strerror(ret));
+        subreq = sysdb_cache_password_ex_send(state, state->be_ctx->ev,
+                                              state->be_ctx->hash_pool,
+                                              state->be_ctx->domain,
+                                              state->pd->user, password,
+                                              SSS_AUTHTOK_TYPE_PASSWORD, 0);
+        if (subreq == NULL) {
+            /* password caching failures are not fatal errors */
+            DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password\n");
+            goto done;
         }
+
+        tevent_req_set_callback(subreq, proxy_pam_handler_cache_done, req);
+        return;
     }
 
 done:
@@ -830,6 +836,27 @@ done:
     tevent_req_done(req);
 }
 
+static void proxy_pam_handler_cache_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+
+    ret = sysdb_cache_password_ex_recv(subreq);
+    talloc_zfree(subreq);
+
+    /* password caching failures are not fatal errors */
+    /* so we just log it any return */
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to cache password (%d)[%s]!?\n",
+              ret, sss_strerror(ret));
+    }
+
+    /* TODO For backward compatibility we always return EOK to DP now. */
+    tevent_req_done(req);
+}
+
 errno_t
 proxy_pam_handler_recv(TALLOC_CTX *mem_ctx,
                       struct tevent_req *req,
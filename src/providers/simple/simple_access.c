@@ -35,6 +35,10 @@
 
 #define TIMEOUT_OF_REFRESH_FILTER_LISTS 5
 
+#define SIMPLE_RESOLVE_GROUPS_FIRST_DELAY 10
+#define SIMPLE_RESOLVE_GROUPS_PERIOD 300
+#define SIMPLE_RESOLVE_GROUPS_TIMEOUT 60
+
 static errno_t simple_access_parse_names(TALLOC_CTX *mem_ctx,
                                          struct be_ctx *be_ctx,
                                          char **list,
@@ -174,6 +178,12 @@ int simple_access_obtain_filter_lists(struct simple_ctx *ctx)
                "Access will be granted for all users.\n");
     }
 
+    ret = simple_access_compile_lists(ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to compile access lists [%d]: %s\n",
+                                    ret, sss_strerror(ret));
+        return ret;
+    }
 
     return EOK;
 
@@ -185,6 +195,152 @@ failed:
     return ret;
 }
 
+/* Configured groups which are missing in the cache cannot be matched by their
+ * IDs, so the groups of every user would have to be resolved by name during
+ * the access check. Look them up in the background and compile the lists
+ * again once they are known. */
+struct simple_resolve_groups_state {
+    struct simple_ctx *ctx;
+    size_t num_in_flight;
+};
+
+static void simple_resolve_groups_done(struct tevent_req *subreq);
+
+static struct tevent_req *
+simple_resolve_groups_send(TALLOC_CTX *mem_ctx,
+                           struct tevent_context *ev,
+                           struct be_ctx *be_ctx,
+                           struct be_ptask *be_ptask,
+                           void *pvt)
+{
+    struct simple_resolve_groups_state *state;
+    struct sss_domain_info *domain;
+    struct simple_ctx *ctx;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    struct dp_id_data *ar;
+    errno_t ret;
+    int i;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct simple_resolve_groups_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    ctx = talloc_get_type(pvt, struct simple_ctx);
+    state->ctx = ctx;
+
+    if (ctx->last_refresh_of_filter_lists == 0) {
+        /* No access check was done yet. */
+        ret = simple_access_obtain_filter_lists(ctx);
+        if (ret != EOK) {
+            goto done;
+        }
+        ctx->last_refresh_of_filter_lists = time(NULL);
+    }
+
+    for (i = 0; ctx->unresolved_groups != NULL
+                    && ctx->unresolved_groups[i] != NULL; i++) {
+        domain = find_domain_by_object_name(ctx->domain,
+                                            ctx->unresolved_groups[i]);
+        if (domain == NULL) {
+            continue;
+        }
+
+        ar = talloc_zero(state, struct dp_id_data);
+        if (ar == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ar->entry_type = BE_REQ_GROUP;
+        ar->filter_type = BE_FILTER_NAME;
+        ar->filter_value = talloc_strdup(ar, ctx->unresolved_groups[i]);
+        ar->domain = talloc_strdup(ar, domain->name);
+        if (ar->filter_value == NULL || ar->domain == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        subreq = dp_req_send(state, be_ctx->provider, ar->domain,
+                             "Simple Resolve Group Name", DPT_ID,
+                             DPM_ACCOUNT_HANDLER, 0, ar, NULL);
+        if (subreq == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+        tevent_req_set_callback(subreq, simple_resolve_groups_done, req);
+
+        state->num_in_flight++;
+    }
+
+    if (state->num_in_flight == 0) {
+        ret = EOK;
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Resolving %zu configured groups\n",
+          state->num_in_flight);
+
+    return req;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else {
+        tevent_req_error(req, ret);
+    }
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+static void simple_resolve_groups_done(struct tevent_req *subreq)
+{
+    struct simple_resolve_groups_state *state;
+    struct dp_reply_std *reply;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct simple_resolve_groups_state);
+
+    ret = dp_req_recv_ptr(state, subreq, struct dp_reply_std, &reply);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to resolve group [%d]: %s\n",
+              ret, sss_strerror(ret));
+    } else if (reply->dp_error != DP_ERR_OK) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Cannot refresh data from DP: %u,%u: %s\n",
+              reply->dp_error, reply->error, reply->message);
+    }
+
+    state->num_in_flight--;
+    if (state->num_in_flight > 0) {
+        return;
+    }
+
+    /* Index the groups which were found by their IDs. */
+    ret = simple_access_obtain_filter_lists(state->ctx);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+    state->ctx->last_refresh_of_filter_lists = time(NULL);
+
+    tevent_req_done(req);
+}
+
+static errno_t simple_resolve_groups_recv(struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
 struct simple_access_handler_state {
     struct pam_data *pd;
 };
@@ -338,6 +494,20 @@ errno_t sssm_simple_access_init(TALLOC_CTX *mem_ctx,
     ctx->be_ctx = be_ctx;
     ctx->last_refresh_of_filter_lists = 0;
 
+    ret = be_ptask_create(ctx, be_ctx, SIMPLE_RESOLVE_GROUPS_PERIOD,
+                          SIMPLE_RESOLVE_GROUPS_FIRST_DELAY, 0, 0,
+                          SIMPLE_RESOLVE_GROUPS_TIMEOUT, 0,
+                          simple_resolve_groups_send,
+                          simple_resolve_groups_recv,
+                          ctx, "Simple Resolve Groups",
+                          BE_PTASK_OFFLINE_SKIP | BE_PTASK_SCHEDULE_FROM_LAST,
+                          NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to setup ptask "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        /* Ignore, groups will be resolved during the access check. */
+    }
+
     dp_set_method(dp_methods, DPM_ACCESS_HANDLER,
                   simple_access_handler_send, simple_access_handler_recv, ctx,
                   struct simple_ctx, struct pam_data, struct pam_data *);
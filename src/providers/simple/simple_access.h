@@ -24,6 +24,8 @@
 
 #include "util/util.h"
 
+struct simple_access_set;
+
 struct simple_ctx {
     struct sss_domain_info *domain;
     struct be_ctx *be_ctx;
@@ -33,9 +35,24 @@ struct simple_ctx {
     char **allow_groups;
     char **deny_groups;
 
+    /* The lists above compiled by simple_access_compile_lists() */
+    struct simple_access_set *allow_users_set;
+    struct simple_access_set *deny_users_set;
+    struct simple_access_set *allow_groups_set;
+    struct simple_access_set *deny_groups_set;
+
+    /* Configured groups which were not found in the cache */
+    char **unresolved_groups;
+
     time_t last_refresh_of_filter_lists;
 };
 
+/* Turns the allow and deny lists into hash sets of names. Groups found in
+ * the cache are also indexed by their GID and SID, so that groups of the
+ * user which only carry a SID as name can be matched without resolving
+ * them first. */
+errno_t simple_access_compile_lists(struct simple_ctx *ctx);
+
 struct tevent_req *simple_access_check_send(TALLOC_CTX *mem_ctx,
                                             struct tevent_context *ev,
                                             struct simple_ctx *ctx,
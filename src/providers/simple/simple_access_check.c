@@ -43,45 +43,374 @@ is_posix(const struct ldb_message *group)
     return false;
 }
 
+struct simple_access_set {
+    /* Names from case sensitive domains */
+    hash_table_t *names;
+    /* Lower-cased names from case insensitive domains */
+    hash_table_t *names_ci;
+    /* "gid:<domain>:<gid>" and "sid:<sid>" of the groups found in cache */
+    hash_table_t *ids;
+    /* Number of groups which are not in the cache yet */
+    size_t num_unresolved;
+};
+
+static errno_t simple_set_add(hash_table_t *table, const char *key)
+{
+    hash_key_t hkey;
+    hash_value_t hvalue;
+    int hret;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+    hvalue.type = HASH_VALUE_UNDEF;
+
+    hret = hash_enter(table, &hkey, &hvalue);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to add [%s] to set [%d]: %s\n",
+              key, hret, hash_error_string(hret));
+        return EIO;
+    }
+
+    return EOK;
+}
+
+static bool simple_set_has(hash_table_t *table, const char *key)
+{
+    hash_key_t hkey;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+
+    return hash_has_key(table, &hkey);
+}
+
+static char *simple_gid_key(TALLOC_CTX *mem_ctx,
+                            struct sss_domain_info *domain,
+                            gid_t gid)
+{
+    return talloc_asprintf(mem_ctx, "gid:%s:%"SPRIgid, domain->name, gid);
+}
+
+static char *simple_sid_key(TALLOC_CTX *mem_ctx, const char *sid)
+{
+    return talloc_asprintf(mem_ctx, "sid:%s", sid);
+}
+
+static errno_t simple_access_set_create(TALLOC_CTX *mem_ctx,
+                                        struct simple_access_set **_set)
+{
+    struct simple_access_set *set;
+    errno_t ret;
+
+    set = talloc_zero(mem_ctx, struct simple_access_set);
+    if (set == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(set, 0, &set->names);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_hash_create(set, 0, &set->names_ci);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_hash_create(set, 0, &set->ids);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_set = set;
+
+done:
+    if (ret != EOK) {
+        talloc_free(set);
+    }
+
+    return ret;
+}
+
+static errno_t simple_access_set_add_name(struct simple_access_set *set,
+                                          struct sss_domain_info *domain,
+                                          const char *name)
+{
+    char *cased;
+    errno_t ret;
+
+    if (domain->case_sensitive) {
+        return simple_set_add(set->names, name);
+    }
+
+    cased = sss_get_cased_name(NULL, name, false);
+    if (cased == NULL) {
+        return ENOMEM;
+    }
+
+    ret = simple_set_add(set->names_ci, cased);
+    talloc_free(cased);
+
+    return ret;
+}
+
+static errno_t simple_access_set_add_group(TALLOC_CTX *mem_ctx,
+                                           struct simple_access_set *set,
+                                           struct sss_domain_info *domain,
+                                           const char *name,
+                                           char ***_unresolved)
+{
+    const char *attrs[] = { SYSDB_GIDNUM, SYSDB_SID_STR, NULL };
+    struct ldb_message *group;
+    TALLOC_CTX *tmp_ctx;
+    const char *sid;
+    char *cased;
+    char *key;
+    gid_t gid;
+    errno_t ret;
+
+    ret = simple_access_set_add_name(set, domain, name);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    cased = sss_get_cased_name(tmp_ctx, name, domain->case_sensitive);
+    if (cased == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_search_group_by_name(tmp_ctx, domain, cased, attrs, &group);
+    if (ret == ENOENT) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Group [%s] is not cached yet\n", name);
+        set->num_unresolved++;
+        ret = add_string_to_list(mem_ctx, name, _unresolved);
+        goto done;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Could not look up group [%s]: [%d][%s]\n",
+              name, ret, sss_strerror(ret));
+        goto done;
+    }
+
+    gid = ldb_msg_find_attr_as_uint64(group, SYSDB_GIDNUM, 0);
+    if (gid != 0) {
+        key = simple_gid_key(tmp_ctx, domain, gid);
+        if (key == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = simple_set_add(set->ids, key);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    sid = ldb_msg_find_attr_as_string(group, SYSDB_SID_STR, NULL);
+    if (sid != NULL) {
+        key = simple_sid_key(tmp_ctx, sid);
+        if (key == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = simple_set_add(set->ids, key);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t simple_access_set_match_name(struct simple_access_set *set,
+                                            const char *name,
+                                            bool *_matched)
+{
+    char *cased;
+
+    if (set == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Access lists were not compiled\n");
+        return EINVAL;
+    }
+
+    if (simple_set_has(set->names, name)) {
+        *_matched = true;
+        return EOK;
+    }
+
+    if (hash_count(set->names_ci) == 0) {
+        *_matched = false;
+        return EOK;
+    }
+
+    cased = sss_get_cased_name(NULL, name, false);
+    if (cased == NULL) {
+        return ENOMEM;
+    }
+
+    *_matched = simple_set_has(set->names_ci, cased);
+    talloc_free(cased);
+
+    return EOK;
+}
+
+static bool simple_access_set_match_ids(struct simple_access_set *set,
+                                        const char *gid_key,
+                                        const char *sid_key)
+{
+    if (set == NULL) {
+        return false;
+    }
+
+    if (simple_set_has(set->ids, gid_key)) {
+        return true;
+    }
+
+    return sid_key != NULL && simple_set_has(set->ids, sid_key);
+}
+
+errno_t simple_access_compile_lists(struct simple_ctx *ctx)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_domain_info *domain;
+    struct simple_access_set *sets[4] = { NULL, NULL, NULL, NULL };
+    char **unresolved = NULL;
+    errno_t ret;
+    int i;
+    int j;
+    struct {
+        char **list;
+        bool groups;
+        bool deny;
+        const char *non_exist_msg;
+    } lists[] = {{ ctx->allow_users, false, false, NON_EXIST_USR_ALLOW },
+                 { ctx->deny_users, false, true, NON_EXIST_USR_DENY },
+                 { ctx->allow_groups, true, false, NON_EXIST_GRP_ALLOW },
+                 { ctx->deny_groups, true, true, NON_EXIST_GRP_DENY }};
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < 4; i++) {
+        if (lists[i].list == NULL) {
+            continue;
+        }
+
+        ret = simple_access_set_create(tmp_ctx, &sets[i]);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        for (j = 0; lists[i].list[j] != NULL; j++) {
+            domain = find_domain_by_object_name(ctx->domain,
+                                                lists[i].list[j]);
+            if (domain == NULL) {
+                DEBUG(SSSDBG_CRIT_FAILURE, lists[i].non_exist_msg,
+                      lists[i].list[j]);
+                sss_log(SSS_LOG_CRIT, lists[i].non_exist_msg,
+                        lists[i].list[j]);
+
+                /* An unusable deny rule must not grant access. */
+                if (lists[i].deny) {
+                    ret = EINVAL;
+                    goto done;
+                }
+                continue;
+            }
+
+            if (lists[i].groups) {
+                ret = simple_access_set_add_group(tmp_ctx, sets[i], domain,
+                                                  lists[i].list[j],
+                                                  &unresolved);
+            } else {
+                ret = simple_access_set_add_name(sets[i], domain,
+                                                 lists[i].list[j]);
+            }
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+    }
+
+    talloc_free(ctx->allow_users_set);
+    ctx->allow_users_set = talloc_steal(ctx, sets[0]);
+
+    talloc_free(ctx->deny_users_set);
+    ctx->deny_users_set = talloc_steal(ctx, sets[1]);
+
+    talloc_free(ctx->allow_groups_set);
+    ctx->allow_groups_set = talloc_steal(ctx, sets[2]);
+
+    talloc_free(ctx->deny_groups_set);
+    ctx->deny_groups_set = talloc_steal(ctx, sets[3]);
+
+    talloc_free(ctx->unresolved_groups);
+    ctx->unresolved_groups = talloc_steal(ctx, unresolved);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* If all configured groups are known by their IDs, a group of the user
+ * which was not matched by its IDs cannot match by its name either. */
+static bool simple_groups_fully_resolved(struct simple_ctx *ctx)
+{
+    if (ctx->allow_groups_set != NULL
+            && ctx->allow_groups_set->num_unresolved != 0) {
+        return false;
+    }
+
+    if (ctx->deny_groups_set != NULL
+            && ctx->deny_groups_set->num_unresolved != 0) {
+        return false;
+    }
+
+    return true;
+}
+
 /* Returns EOK if the result is definitive, EAGAIN if only partial result
  */
 static errno_t
 simple_check_users(struct simple_ctx *ctx, const char *username,
                    bool *access_granted)
 {
-    struct sss_domain_info *domain = NULL;
-    int i;
+    bool matched;
+    errno_t ret;
 
     /* First, check whether the user is in the allowed users list */
     if (ctx->allow_users != NULL) {
-        for(i = 0; ctx->allow_users[i] != NULL; i++) {
-            DEBUG(SSSDBG_TRACE_ALL,
-                  "Checking against allow list username [%s].\n",
-                  ctx->allow_users[i]);
-            domain = find_domain_by_object_name(ctx->domain,
-                                                ctx->allow_users[i]);
-            if (domain == NULL) {
-                DEBUG(SSSDBG_CRIT_FAILURE, NON_EXIST_USR_ALLOW,
-                      ctx->allow_users[i]);
-                sss_log(SSS_LOG_CRIT, NON_EXIST_USR_ALLOW,
-                        ctx->allow_users[i]);
-                continue;
-            }
+        ret = simple_access_set_match_name(ctx->allow_users_set, username,
+                                           &matched);
+        if (ret != EOK) {
+            return ret;
+        }
 
-            if (sss_string_equal(domain->case_sensitive, username,
-                                 ctx->allow_users[i])) {
-                DEBUG(SSSDBG_TRACE_LIBS,
-                      "User [%s] found in allow list, access granted.\n",
-                      username);
-
-                /* Do not return immediately on explicit allow
-                 * We need to make sure none of the user's groups
-                 * are denied. But there's no need to check username
-                 * matches any more.
-                 */
-                *access_granted = true;
-                break;
-            }
+        if (matched) {
+            DEBUG(SSSDBG_TRACE_LIBS,
+                  "User [%s] found in allow list, access granted.\n",
+                  username);
+
+            /* Do not return immediately on explicit allow
+             * We need to make sure none of the user's groups
+             * are denied. But there's no need to check username
+             * matches any more.
+             */
+            *access_granted = true;
         }
     } else if (!ctx->allow_groups) {
         /* If neither allow rule is in place, we'll assume allowed
@@ -94,122 +423,97 @@ simple_check_users(struct simple_ctx *ctx, const char *username,
 
     /* Next check whether this user has been specifically denied */
     if (ctx->deny_users != NULL) {
-        for(i = 0; ctx->deny_users[i] != NULL; i++) {
-            DEBUG(SSSDBG_TRACE_ALL,
-                  "Checking against deny list username [%s].\n",
-                  ctx->deny_users[i]);
-            domain = find_domain_by_object_name(ctx->domain,
-                                                ctx->deny_users[i]);
-            if (domain == NULL) {
-                DEBUG(SSSDBG_CRIT_FAILURE, NON_EXIST_USR_DENY,
-                      ctx->deny_users[i]);
-                sss_log(SSS_LOG_CRIT, NON_EXIST_USR_DENY,
-                        ctx->deny_users[i]);
-                return EINVAL;
-            }
+        ret = simple_access_set_match_name(ctx->deny_users_set, username,
+                                           &matched);
+        if (ret != EOK) {
+            return ret;
+        }
 
-            if (sss_string_equal(domain->case_sensitive, username,
-                                 ctx->deny_users[i])) {
-                DEBUG(SSSDBG_TRACE_LIBS,
-                      "User [%s] found in deny list, access denied.\n",
-                        ctx->deny_users[i]);
+        if (matched) {
+            DEBUG(SSSDBG_TRACE_LIBS,
+                  "User [%s] found in deny list, access denied.\n",
+                  username);
 
-                /* Return immediately on explicit denial */
-                *access_granted = false;
-                return EOK;
-            }
+            /* Return immediately on explicit denial */
+            *access_granted = false;
+            return EOK;
         }
     }
 
     return EAGAIN;
 }
 
+static errno_t
+simple_check_group_list(struct simple_access_set *set,
+                        const char **group_names,
+                        bool id_matched,
+                        const char *list_name,
+                        bool *_matched)
+{
+    bool matched = false;
+    errno_t ret;
+    int j;
+
+    if (id_matched) {
+        DEBUG(SSSDBG_TRACE_LIBS,
+              "Group ID found in %s list.\n", list_name);
+        *_matched = true;
+        return EOK;
+    }
+
+    for (j = 0; group_names[j] != NULL; j++) {
+        ret = simple_access_set_match_name(set, group_names[j], &matched);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        if (matched) {
+            DEBUG(SSSDBG_TRACE_LIBS,
+                  "Group [%s] found in %s list.\n", group_names[j], list_name);
+            break;
+        }
+    }
+
+    *_matched = matched;
+    return EOK;
+}
+
 static errno_t
 simple_check_groups(struct simple_ctx *ctx, const char **group_names,
+                    bool allow_id_matched, bool deny_id_matched,
                     bool *access_granted)
 {
-    struct sss_domain_info *domain = NULL;
     bool matched;
-    int i, j;
+    errno_t ret;
 
     /* Now process allow and deny group rules
      * If access was already granted above, we'll skip
      * this redundant rule check
      */
     if (ctx->allow_groups && !*access_granted) {
-        matched = false;
-        for (i = 0; ctx->allow_groups[i]; i++) {
-            DEBUG(SSSDBG_TRACE_ALL,
-                  "Checking against allow list group name [%s].\n",
-                  ctx->allow_groups[i]);
-            domain = find_domain_by_object_name(ctx->domain,
-                                                ctx->allow_groups[i]);
-            if (domain == NULL) {
-                DEBUG(SSSDBG_CRIT_FAILURE, NON_EXIST_GRP_ALLOW,
-                      ctx->allow_groups[i]);
-                sss_log(SSS_LOG_CRIT, NON_EXIST_GRP_ALLOW,
-                        ctx->allow_groups[i]);
-
-                continue;
-            }
-
-            for(j = 0; group_names[j]; j++) {
-                if (sss_string_equal(domain->case_sensitive,
-                                     group_names[j], ctx->allow_groups[i])) {
-                    matched = true;
-                    break;
-                }
-            }
+        ret = simple_check_group_list(ctx->allow_groups_set, group_names,
+                                      allow_id_matched, "allow", &matched);
+        if (ret != EOK) {
+            return ret;
+        }
 
-            /* If any group has matched, we can skip out on the
-             * processing early
-             */
-            if (matched) {
-                DEBUG(SSSDBG_TRACE_LIBS,
-                      "Group [%s] found in allow list, access granted.\n",
-                      group_names[j]);
-                *access_granted = true;
-                break;
-            }
+        if (matched) {
+            DEBUG(SSSDBG_TRACE_LIBS, "Access granted.\n");
+            *access_granted = true;
         }
     }
 
     /* Finally, process the deny group rules */
     if (ctx->deny_groups) {
-        matched = false;
-        for (i = 0; ctx->deny_groups[i]; i++) {
-            DEBUG(SSSDBG_TRACE_ALL,
-                  "Checking against deny list group name [%s].\n",
-                  ctx->deny_groups[i]);
-            domain = find_domain_by_object_name(ctx->domain,
-                                                ctx->deny_groups[i]);
-            if (domain == NULL) {
-                DEBUG(SSSDBG_CRIT_FAILURE, NON_EXIST_GRP_DENY,
-                      ctx->deny_groups[i]);
-                sss_log(SSS_LOG_CRIT, NON_EXIST_GRP_DENY,
-                        ctx->deny_groups[i]);
-
-                return EINVAL;
-            }
-
-            for(j = 0; group_names[j]; j++) {
-                if (sss_string_equal(domain->case_sensitive,
-                                     group_names[j], ctx->deny_groups[i])) {
-                    matched = true;
-                    break;
-                }
-            }
+        ret = simple_check_group_list(ctx->deny_groups_set, group_names,
+                                      deny_id_matched, "deny", &matched);
+        if (ret != EOK) {
+            return ret;
+        }
 
-            /* If any group has matched, we can skip out on the
-             * processing early
-             */
-            if (matched) {
-                DEBUG(SSSDBG_TRACE_LIBS,
-                      "Group [%s] found in deny list, access denied.\n",
-                      group_names[j]);
-                *access_granted = false;
-                break;
-            }
+        if (matched) {
+            DEBUG(SSSDBG_TRACE_LIBS, "Access denied.\n");
+            *access_granted = false;
         }
     }
 
@@ -406,6 +710,9 @@ struct simple_check_groups_state {
     const char **group_names;
     size_t num_names;
 
+    bool allow_id_matched;
+    bool deny_id_matched;
+
     bool failed_to_resolve_groups;
 };
 
@@ -583,6 +890,43 @@ static void simple_check_get_groups_next(struct tevent_req *subreq)
     tevent_req_done(req);
 }
 
+static errno_t
+simple_check_match_ids(struct simple_check_groups_state *state,
+                       struct sss_domain_info *domain,
+                       gid_t gid,
+                       const char *group_sid)
+{
+    char *gid_key;
+    char *sid_key = NULL;
+
+    gid_key = simple_gid_key(state, domain, gid);
+    if (gid_key == NULL) {
+        return ENOMEM;
+    }
+
+    if (group_sid != NULL) {
+        sid_key = simple_sid_key(state, group_sid);
+        if (sid_key == NULL) {
+            talloc_free(gid_key);
+            return ENOMEM;
+        }
+    }
+
+    if (simple_access_set_match_ids(state->ctx->allow_groups_set,
+                                    gid_key, sid_key)) {
+        state->allow_id_matched = true;
+    }
+
+    if (simple_access_set_match_ids(state->ctx->deny_groups_set,
+                                    gid_key, sid_key)) {
+        state->deny_id_matched = true;
+    }
+
+    talloc_free(gid_key);
+    talloc_free(sid_key);
+    return EOK;
+}
+
 static errno_t
 simple_check_process_group(struct simple_check_groups_state *state,
                            struct ldb_message *group)
@@ -592,6 +936,7 @@ simple_check_process_group(struct simple_check_groups_state *state,
     struct sss_domain_info *domain;
     gid_t gid;
     bool posix;
+    errno_t ret;
 
     posix = is_posix(group);
     name = ldb_msg_find_attr_as_string(group, SYSDB_NAME, NULL);
@@ -648,7 +993,19 @@ simple_check_process_group(struct simple_check_groups_state *state,
         }
     }
 
-    /* It is a non-POSIX group with a GID. Needs resolving */
+    /* It is a non-POSIX group with a GID. Try to match it by its IDs
+     * first, the name needs resolving only if that is not conclusive. */
+    ret = simple_check_match_ids(state, domain, gid, group_sid);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    if (simple_groups_fully_resolved(state->ctx)) {
+        DEBUG(SSSDBG_TRACE_INTERNAL,
+              "GID %"SPRIgid" does not need resolving\n", gid);
+        return EOK;
+    }
+
     state->lookup_groups[state->num_groups].domain = domain;
     state->lookup_groups[state->num_groups].gid = gid;
     DEBUG(SSSDBG_TRACE_INTERNAL, "Adding GID %"SPRIgid"\n", gid);
@@ -689,7 +1046,9 @@ simple_check_get_groups_primary(struct simple_check_groups_state *state,
 static errno_t
 simple_check_get_groups_recv(struct tevent_req *req,
                              TALLOC_CTX *mem_ctx,
-                             const char ***_group_names)
+                             const char ***_group_names,
+                             bool *_allow_id_matched,
+                             bool *_deny_id_matched)
 {
     struct simple_check_groups_state *state;
 
@@ -698,6 +1057,8 @@ simple_check_get_groups_recv(struct tevent_req *req,
     TEVENT_REQ_RETURN_ON_ERROR(req);
 
     *_group_names = talloc_steal(mem_ctx, state->group_names);
+    *_allow_id_matched = state->allow_id_matched;
+    *_deny_id_matched = state->deny_id_matched;
     if (state->failed_to_resolve_groups) {
         return ERR_SIMPLE_GROUPS_MISSING;
     }
@@ -710,6 +1071,8 @@ struct simple_access_check_state {
     const char *username;
 
     const char **group_names;
+    bool allow_id_matched;
+    bool deny_id_matched;
 };
 
 static void simple_access_check_done(struct tevent_req *subreq);
@@ -789,7 +1152,9 @@ static void simple_access_check_done(struct tevent_req *subreq)
     errno_t ret;
 
     /* We know the names now. Run the check. */
-    ret = simple_check_get_groups_recv(subreq, state, &state->group_names);
+    ret = simple_check_get_groups_recv(subreq, state, &state->group_names,
+                                       &state->allow_id_matched,
+                                       &state->deny_id_matched);
 
     talloc_zfree(subreq);
     if (ret == ENOENT) {
@@ -817,6 +1182,8 @@ static void simple_access_check_done(struct tevent_req *subreq)
     }
 
     ret = simple_check_groups(state->ctx, state->group_names,
+                              state->allow_id_matched,
+                              state->deny_id_matched,
                               &state->access_granted);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE, "Could not check group access [%d]: %s\n",
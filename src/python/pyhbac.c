@@ -1136,6 +1136,177 @@ fail:
     return NULL;
 }
 
+/* ==================== HBAC Rule Set ========================*/
+static void
+free_hbac_rule_list(struct hbac_rule **rules)
+{
+    int i;
+
+    if (!rules) return;
+
+    for(i=0; rules[i]; i++) {
+        free_hbac_rule(rules[i]);
+    }
+    PyMem_Free(rules);
+}
+
+static struct hbac_rule **
+hbac_rule_list_to_native(PyObject *py_rules_list)
+{
+    PyObject *py_rule = NULL;
+    Py_ssize_t num_rules;
+    struct hbac_rule **rules = NULL;
+    long i;
+
+    if (!PySequence_Check(py_rules_list)) {
+        PyErr_Format(PyExc_TypeError,
+                     "The parameter rules must be a sequence\n");
+        goto fail;
+    }
+
+    num_rules = PySequence_Size(py_rules_list);
+    rules = PyMem_New(struct hbac_rule *, num_rules+1);
+    if (!rules) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+
+    for (i=0; i < num_rules; i++) {
+        rules[i] = NULL;
+
+        py_rule = PySequence_GetItem(py_rules_list, i);
+        if (py_rule == NULL) {
+            goto fail;
+        }
+
+        if (!PyObject_IsInstance(py_rule,
+                                 (PyObject *) &pyhbac_hbacrule_type)) {
+            PyErr_Format(PyExc_TypeError,
+                         "A rule must be of type HbacRule\n");
+            Py_DECREF(py_rule);
+            goto fail;
+        }
+
+        rules[i] = HbacRule_to_native((HbacRuleObject *) py_rule);
+        Py_DECREF(py_rule);
+        if (!rules[i]) {
+            /* Make sure there is at least a generic exception */
+            if (!PyErr_Occurred()) {
+                PyErr_Format(PyExc_IOError,
+                             "Could not convert HbacRule to native type\n");
+            }
+            goto fail;
+        }
+    }
+    rules[num_rules] = NULL;
+
+    return rules;
+
+fail:
+    free_hbac_rule_list(rules);
+    return NULL;
+}
+
+typedef struct {
+    PyObject_HEAD
+
+    struct hbac_rule **rules;
+    struct hbac_compiled_rules *compiled;
+} HbacRuleSet;
+
+static PyObject *
+HbacRuleSet_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    HbacRuleSet *self;
+
+    self = (HbacRuleSet *) type->tp_alloc(type, 0);
+    if (self == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    self->rules = NULL;
+    self->compiled = NULL;
+
+    return (PyObject *) self;
+}
+
+static void
+HbacRuleSet_clear_native(HbacRuleSet *self)
+{
+    hbac_free_compiled_rules(self->compiled);
+    self->compiled = NULL;
+    free_hbac_rule_list(self->rules);
+    self->rules = NULL;
+}
+
+static void
+HbacRuleSet_dealloc(HbacRuleSet *self)
+{
+    HbacRuleSet_clear_native(self);
+    Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static int
+HbacRuleSet_init(HbacRuleSet *self, PyObject *args, PyObject *kwargs)
+{
+    const char * const kwlist[] = { "rules", NULL };
+    PyObject *py_rules_list = NULL;
+    struct hbac_rule **rules;
+    struct hbac_compiled_rules *compiled = NULL;
+    enum hbac_error_code code;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs,
+                                     sss_py_const_p(char, "O"),
+                                     discard_const_p(char *, kwlist),
+                                     &py_rules_list)) {
+        return -1;
+    }
+
+    rules = hbac_rule_list_to_native(py_rules_list);
+    if (rules == NULL) {
+        return -1;
+    }
+
+    code = hbac_rules_compile(rules, &compiled);
+    if (code != HBAC_SUCCESS) {
+        free_hbac_rule_list(rules);
+        if (code == HBAC_ERROR_OUT_OF_MEMORY) {
+            PyErr_NoMemory();
+        } else {
+            PyErr_Format(PyExc_IOError, "Could not compile HBAC rules: %s\n",
+                         hbac_error_string(code));
+        }
+        return -1;
+    }
+
+    HbacRuleSet_clear_native(self);
+    self->rules = rules;
+    self->compiled = compiled;
+
+    return 0;
+}
+
+PyDoc_STRVAR(HbacRuleSet__doc__,
+"IPA HBAC Rule Set\n\n"
+"HbacRuleSet(rules) -> a set of HBAC rules prepared for evaluation\n"
+"rules is a sequence of HbacRule objects. The rules are copied and\n"
+"indexed when the set is created, so a rule set can be evaluated\n"
+"repeatedly with HbacRequest.evaluate() without converting the rules\n"
+"again. Later changes to the HbacRule objects are not reflected in\n"
+"the set.\n");
+
+static PyTypeObject pyhbac_hbacruleset_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = sss_py_const_p(char, "pyhbac.HbacRuleSet"),
+    .tp_basicsize = sizeof(HbacRuleSet),
+    .tp_new = HbacRuleSet_new,
+    .tp_dealloc = (destructor) HbacRuleSet_dealloc,
+    .tp_init = (initproc) HbacRuleSet_init,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_doc   = HbacRuleSet__doc__
+};
+
 /* ==================== HBAC Request Element ========================*/
 typedef struct {
     PyObject_HEAD
@@ -1521,7 +1692,9 @@ HbacRequest_init(HbacRequest *self, PyObject *args, PyObject *kwargs)
 PyDoc_STRVAR(py_hbac_evaluate__doc__,
 "evaluate(rules) -> int\n\n"
 "Evaluate a set of HBAC rules.\n"
-"rules is a sequence of HbacRule objects. The returned value describes\n"
+"rules is a sequence of HbacRule objects or an HbacRuleSet. When the\n"
+"same rules are evaluated repeatedly, an HbacRuleSet avoids converting\n"
+"them on every call. The returned value describes\n"
 "the result of evaluation and will have one of HBAC_EVAL_* values.\n"
 "Use hbac_result_string() to get textual representation of the result\n"
 "On error, HbacError exception is raised.\n"
@@ -1532,19 +1705,6 @@ PyDoc_STRVAR(py_hbac_evaluate__doc__,
 static struct hbac_eval_req *
 HbacRequest_to_native(HbacRequest *pyreq);
 
-static void
-free_hbac_rule_list(struct hbac_rule **rules)
-{
-    int i;
-
-    if (!rules) return;
-
-    for(i=0; rules[i]; i++) {
-        free_hbac_rule(rules[i]);
-    }
-    PyMem_Free(rules);
-}
-
 static void
 free_hbac_eval_req(struct hbac_eval_req *req);
 
@@ -1552,53 +1712,31 @@ static PyObject *
 py_hbac_evaluate(HbacRequest *self, PyObject *args)
 {
     PyObject *py_rules_list = NULL;
-    PyObject *py_rule = NULL;
-    Py_ssize_t num_rules;
     struct hbac_rule **rules = NULL;
+    struct hbac_compiled_rules *compiled = NULL;
     struct hbac_eval_req *hbac_req = NULL;
     enum hbac_eval_result eres;
     struct hbac_info *info = NULL;
     PyObject *ret = NULL;
-    long i;
 
     if (!PyArg_ParseTuple(args, sss_py_const_p(char, "O"), &py_rules_list)) {
         goto fail;
     }
 
-    if (!PySequence_Check(py_rules_list)) {
-        PyErr_Format(PyExc_TypeError,
-                     "The parameter rules must be a sequence\n");
-        goto fail;
-    }
-
-    num_rules = PySequence_Size(py_rules_list);
-    rules = PyMem_New(struct hbac_rule *, num_rules+1);
-    if (!rules) {
-        PyErr_NoMemory();
-        goto fail;
-    }
-
-    for (i=0; i < num_rules; i++) {
-        py_rule = PySequence_GetItem(py_rules_list, i);
-
-        if (!PyObject_IsInstance(py_rule,
-                                 (PyObject *) &pyhbac_hbacrule_type)) {
+    if (PyObject_IsInstance(py_rules_list,
+                            (PyObject *) &pyhbac_hbacruleset_type)) {
+        compiled = ((HbacRuleSet *) py_rules_list)->compiled;
+        if (compiled == NULL) {
             PyErr_Format(PyExc_TypeError,
-                         "A rule must be of type HbacRule\n");
+                         "The HbacRuleSet was not initialized\n");
             goto fail;
         }
-
-        rules[i] = HbacRule_to_native((HbacRuleObject *) py_rule);
-        if (!rules[i]) {
-            /* Make sure there is at least a generic exception */
-            if (!PyErr_Occurred()) {
-                PyErr_Format(PyExc_IOError,
-                             "Could not convert HbacRule to native type\n");
-            }
+    } else {
+        rules = hbac_rule_list_to_native(py_rules_list);
+        if (rules == NULL) {
             goto fail;
         }
     }
-    rules[num_rules] = NULL;
 
     hbac_req = HbacRequest_to_native(self);
     if (!hbac_req) {
@@ -1612,7 +1750,11 @@ py_hbac_evaluate(HbacRequest *self, PyObject *args)
     Py_XDECREF(self->rule_name);
     self->rule_name = NULL;
 
-    eres = hbac_evaluate(rules, hbac_req, &info);
+    if (compiled != NULL) {
+        eres = hbac_evaluate_compiled(compiled, hbac_req, &info);
+    } else {
+        eres = hbac_evaluate(rules, hbac_req, &info);
+    }
     switch (eres) {
     case HBAC_EVAL_ALLOW:
         self->rule_name = PyUnicode_FromString(info->rule_name);
@@ -2020,6 +2162,7 @@ initpyhbac(void)
     }
 
     TYPE_READY(m, pyhbac_hbacrule_type, "HbacRule");
+    TYPE_READY(m, pyhbac_hbacruleset_type, "HbacRuleSet");
     TYPE_READY(m, pyhbac_hbacrule_element_type, "HbacRuleElement");
     TYPE_READY(m, pyhbac_hbacrequest_element_type, "HbacRequestElement");
     TYPE_READY(m, pyhbac_hbacrequest_type, "HbacRequest");
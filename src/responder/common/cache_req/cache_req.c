@@ -24,6 +24,8 @@
 #include <errno.h>
 
 #include "util/util.h"
+#include "util/sss_metrics.h"
+#include "util/probes.h"
 #include "responder/common/responder.h"
 #include "responder/common/cache_req/cache_req_private.h"
 #include "responder/common/cache_req/cache_req_plugin.h"
@@ -693,9 +695,68 @@ struct cache_req_search_domains_state {
     bool dp_success;
     bool first_iteration;
     enum cache_req_behavior cache_behavior;
+
+    /* parallel search, in the domain resolution order */
+    struct cache_req_parallel_search **parallel;
+    size_t num_parallel;
+};
+
+enum cache_req_parallel_status {
+    CACHE_REQ_PARALLEL_PENDING,
+    CACHE_REQ_PARALLEL_FOUND,
+    CACHE_REQ_PARALLEL_NOT_FOUND,
+    CACHE_REQ_PARALLEL_ERROR,
+    CACHE_REQ_PARALLEL_CANCELLED
+};
+
+/* Search in one domain during the parallel search. */
+struct cache_req_parallel_search {
+    struct tevent_req *req;
+    struct tevent_req *subreq;
+    struct cache_req *cr;
+    struct sss_domain_info *domain;
+
+    enum cache_req_parallel_status status;
+    struct ldb_result *result;
+    errno_t error;
 };
 
+static bool
+cache_req_search_domains_skip(struct cache_req_search_domains_state *state,
+                              struct cache_req_domain *cr_domain)
+{
+    struct cache_req *cr = state->cr;
+
+    /* As the cr_domain list is a flatten version of the domains
+     * list, we have to ensure to only go through the subdomains in
+     * case it's specified in the plugin to do so.
+     */
+    if (cr->plugin->get_next_domain_flags == 0
+            && IS_SUBDOMAIN(cr_domain->domain)) {
+        return true;
+    }
+
+    /* Check if this domain is valid for this request. */
+    if (!cache_req_validate_domain(cr, cr_domain->domain)) {
+        return true;
+    }
+
+    /* If not specified otherwise, we skip domains that require fully
+     * qualified names on domain less search. We do not descend into
+     * subdomains here since those are implicitly qualified.
+     */
+    if (state->check_next && !cr->plugin->allow_missing_fqn
+            && cr_domain->fqnames) {
+        return true;
+    }
+
+    return false;
+}
+
 static errno_t cache_req_search_domains_next(struct tevent_req *req);
+static bool
+cache_req_search_domains_use_parallel(struct cache_req_search_domains_state *state);
+static errno_t cache_req_search_domains_parallel(struct tevent_req *req);
 static errno_t cache_req_handle_result(struct tevent_req *req,
                                        struct ldb_result *result);
 
@@ -743,7 +804,11 @@ cache_req_search_domains_send(TALLOC_CTX *mem_ctx,
         cache_req_domain_set_locate_flag(cr_domain, cr);
     }
 
-    ret = cache_req_search_domains_next(req);
+    if (cache_req_search_domains_use_parallel(state)) {
+        ret = cache_req_search_domains_parallel(req);
+    } else {
+        ret = cache_req_search_domains_next(req);
+    }
     if (ret == EAGAIN) {
         return req;
     }
@@ -764,17 +829,11 @@ static errno_t cache_req_search_domains_next(struct tevent_req *req)
     struct tevent_req *subreq;
     struct cache_req *cr;
     struct sss_domain_info *domain;
-    uint32_t next_domain_flag;
-    bool is_domain_valid;
-    bool allow_no_fqn;
     errno_t ret;
 
     state = tevent_req_data(req, struct cache_req_search_domains_state);
     cr = state->cr;
 
-    next_domain_flag = cr->plugin->get_next_domain_flags;
-    allow_no_fqn = cr->plugin->allow_missing_fqn;
-
     while (state->cr_domain != NULL) {
         domain = state->cr_domain->domain;
 
@@ -782,27 +841,7 @@ static errno_t cache_req_search_domains_next(struct tevent_req *req)
             break;
         }
 
-        /* As the cr_domain list is a flatten version of the domains
-         * list, we have to ensure to only go through the subdomains in
-         * case it's specified in the plugin to do so.
-         */
-        if (next_domain_flag == 0 && IS_SUBDOMAIN(domain)) {
-            state->cr_domain = state->cr_domain->next;
-            continue;
-        }
-
-        /* Check if this domain is valid for this request. */
-        is_domain_valid = cache_req_validate_domain(cr, domain);
-        if (!is_domain_valid) {
-            state->cr_domain = state->cr_domain->next;
-            continue;
-        }
-
-        /* If not specified otherwise, we skip domains that require fully
-         * qualified names on domain less search. We do not descend into
-         * subdomains here since those are implicitly qualified.
-         */
-        if (state->check_next && !allow_no_fqn && state->cr_domain->fqnames) {
+        if (cache_req_search_domains_skip(state, state->cr_domain)) {
             state->cr_domain = state->cr_domain->next;
             continue;
         }
@@ -1023,6 +1062,278 @@ done:
     return;
 }
 
+static bool
+cache_req_search_domains_use_parallel(struct cache_req_search_domains_state *state)
+{
+    struct cache_req *cr = state->cr;
+
+    if (!cr->rctx->parallel_domain_lookup || !state->check_next) {
+        return false;
+    }
+
+    /* Plug-ins that return objects from all domains want every answer and
+     * plug-ins that can locate the domain of the object use the locator. */
+    if (cr->plugin->search_all_domains
+            || cr->plugin->dp_get_domain_send_fn != NULL) {
+        return false;
+    }
+
+    /* There is nothing to gain if the data provider is not contacted. */
+    switch (cr->cache_behavior) {
+    case CACHE_REQ_BYPASS_PROVIDER:
+        return false;
+    case CACHE_REQ_CACHE_FIRST:
+        return !state->first_iteration;
+    default:
+        return true;
+    }
+}
+
+static struct cache_req *
+cache_req_clone(TALLOC_CTX *mem_ctx, struct cache_req *cr)
+{
+    struct cache_req *clone;
+
+    clone = talloc_zero(mem_ctx, struct cache_req);
+    if (clone == NULL) {
+        return NULL;
+    }
+
+    clone->data = talloc_zero(clone, struct cache_req_data);
+    if (clone->data == NULL) {
+        talloc_free(clone);
+        return NULL;
+    }
+
+    *clone->data = *cr->data;
+    if (cr->data->svc.name == &cr->data->name) {
+        clone->data->svc.name = &clone->data->name;
+    }
+
+    /* These are set per domain in cache_req_set_domain() and freed when
+     * replaced, they must not point to the values of the original. */
+    clone->data->name.lookup = NULL;
+    clone->data->svc.protocol.lookup = NULL;
+
+    clone->plugin = cr->plugin;
+    clone->rctx = cr->rctx;
+    clone->ncache = cr->ncache;
+    clone->midpoint = cr->midpoint;
+    clone->cache_behavior = cr->cache_behavior;
+    clone->req_dom_type = cr->req_dom_type;
+    clone->reqid = cr->reqid;
+    clone->reqname = cr->reqname;
+    clone->req_start = cr->req_start;
+
+    return clone;
+}
+
+static void cache_req_search_domains_parallel_done(struct tevent_req *subreq);
+
+/* Search all domains at once. The result of a domain is used only when all
+ * domains before it in the resolution order did not find anything, so the
+ * outcome is the same as with cache_req_search_domains_next(). */
+static errno_t cache_req_search_domains_parallel(struct tevent_req *req)
+{
+    struct cache_req_search_domains_state *state;
+    struct cache_req_parallel_search *search;
+    struct cache_req_domain *cr_domain;
+    enum tevent_req_state req_state;
+    uint64_t req_error;
+    size_t count;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct cache_req_search_domains_state);
+
+    count = 0;
+    for (cr_domain = state->cr_domain;
+         cr_domain != NULL && cr_domain->domain != NULL;
+         cr_domain = cr_domain->next) {
+        if (!cache_req_search_domains_skip(state, cr_domain)) {
+            count++;
+        }
+    }
+
+    if (count < 2) {
+        return cache_req_search_domains_next(req);
+    }
+
+    CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->cr,
+                    "Searching %zu domains in parallel\n", count);
+
+    state->parallel = talloc_zero_array(state,
+                                        struct cache_req_parallel_search *,
+                                        count);
+    if (state->parallel == NULL) {
+        return ENOMEM;
+    }
+
+    for (cr_domain = state->cr_domain;
+         cr_domain != NULL && cr_domain->domain != NULL;
+         cr_domain = cr_domain->next) {
+        if (cache_req_search_domains_skip(state, cr_domain)) {
+            continue;
+        }
+
+        search = talloc_zero(state->parallel, struct cache_req_parallel_search);
+        if (search == NULL) {
+            return ENOMEM;
+        }
+
+        search->req = req;
+        search->domain = cr_domain->domain;
+        search->status = CACHE_REQ_PARALLEL_PENDING;
+        state->parallel[state->num_parallel] = search;
+        state->num_parallel++;
+
+        search->cr = cache_req_clone(search, state->cr);
+        if (search->cr == NULL) {
+            return ENOMEM;
+        }
+
+        ret = cache_req_set_domain(search->cr, search->domain);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        search->subreq = cache_req_search_send(search, state->ev, search->cr,
+                                               state->first_iteration, false);
+        if (search->subreq == NULL) {
+            return ENOMEM;
+        }
+        tevent_req_set_callback(search->subreq,
+                                cache_req_search_domains_parallel_done,
+                                search);
+
+        /* The object was found in the cache, domains after this one can
+         * not win so there is no need to ask them. */
+        if (!tevent_req_is_in_progress(search->subreq)
+                && !tevent_req_is_error(search->subreq, &req_state,
+                                        &req_error)) {
+            break;
+        }
+    }
+
+    return EAGAIN;
+}
+
+static errno_t
+cache_req_search_domains_parallel_check(struct tevent_req *req)
+{
+    struct cache_req_search_domains_state *state;
+    struct cache_req_parallel_search *winner = NULL;
+    struct cache_req_parallel_search *search;
+    errno_t ret = ENOENT;
+    size_t i;
+
+    state = tevent_req_data(req, struct cache_req_search_domains_state);
+
+    for (i = 0; i < state->num_parallel; i++) {
+        search = state->parallel[i];
+
+        if (search->status == CACHE_REQ_PARALLEL_PENDING) {
+            /* A domain with higher priority has not answered yet. */
+            return EAGAIN;
+        }
+
+        if (search->status == CACHE_REQ_PARALLEL_FOUND) {
+            winner = search;
+            ret = EOK;
+            break;
+        }
+
+        if (search->status == CACHE_REQ_PARALLEL_ERROR) {
+            ret = search->error;
+            break;
+        }
+    }
+
+    /* The answer is known, cancel the searches that are still running. */
+    for (i++; i < state->num_parallel; i++) {
+        search = state->parallel[i];
+        if (search->status == CACHE_REQ_PARALLEL_PENDING) {
+            talloc_zfree(search->subreq);
+            search->status = CACHE_REQ_PARALLEL_CANCELLED;
+        }
+    }
+
+    if (winner != NULL) {
+        CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->cr,
+                        "Using result from domain [%s]\n",
+                        winner->domain->name);
+
+        ret = cache_req_set_domain(state->cr, winner->domain);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        state->selected_domain = winner->domain;
+
+        /* Only the first result is wanted, see
+         * cache_req_search_domains_use_parallel(). */
+        ret = cache_req_handle_result(req, winner->result);
+        return ret == EAGAIN ? EOK : ret;
+    }
+
+    if (ret == ENOENT && state->dp_success) {
+        cache_req_global_ncache_add(state->cr);
+    }
+
+    return ret;
+}
+
+static void cache_req_search_domains_parallel_done(struct tevent_req *subreq)
+{
+    struct cache_req_search_domains_state *state;
+    struct cache_req_parallel_search *search;
+    struct tevent_req *req;
+    bool dp_success;
+    errno_t ret;
+
+    search = tevent_req_callback_data(subreq, struct cache_req_parallel_search);
+    req = search->req;
+    state = tevent_req_data(req, struct cache_req_search_domains_state);
+
+    ret = cache_req_search_recv(search, subreq, &search->result, &dp_success);
+    talloc_zfree(subreq);
+    search->subreq = NULL;
+
+    /* Remember if any DP request fails. */
+    state->dp_success = !dp_success ? false : state->dp_success;
+
+    switch (ret) {
+    case EOK:
+        search->status = CACHE_REQ_PARALLEL_FOUND;
+        break;
+    case ERR_ID_OUTSIDE_RANGE:
+    case ENOENT:
+        search->status = CACHE_REQ_PARALLEL_NOT_FOUND;
+        break;
+    default:
+        search->status = CACHE_REQ_PARALLEL_ERROR;
+        search->error = ret;
+        break;
+    }
+
+    ret = cache_req_search_domains_parallel_check(req);
+    switch (ret) {
+    case EOK:
+        tevent_req_done(req);
+        break;
+    case EAGAIN:
+        break;
+    default:
+        if (ret == ENOENT && state->cr->data->propogate_offline_status
+                && !state->dp_success) {
+            /* Not found and data provider request failed so we were
+             * unable to fetch the data. */
+            ret = ERR_OFFLINE;
+        }
+        tevent_req_error(req, ret);
+        break;
+    }
+}
+
 static errno_t
 cache_req_search_domains_recv(TALLOC_CTX *mem_ctx,
                               struct tevent_req *req,
@@ -1056,6 +1367,9 @@ struct cache_req_state {
     struct cache_req_result **results;
     size_t num_results;
     bool first_iteration;
+
+    /* for the duration metric */
+    uint64_t start;
 };
 
 static errno_t cache_req_process_input(TALLOC_CTX *mem_ctx,
@@ -1085,6 +1399,40 @@ static void cache_req_process_result(struct tevent_req *subreq);
 
 static void cache_req_done(struct tevent_req *subreq);
 
+static void cache_req_cleanup(struct tevent_req *req,
+                              enum tevent_req_state req_state)
+{
+    struct cache_req_state *state;
+    enum tevent_req_state tstate;
+    const char *result;
+    uint64_t err;
+
+    /* The request was either already accounted for when it finished or it
+     * was freed by the caller before it finished. */
+    if (req_state == TEVENT_REQ_RECEIVED) {
+        return;
+    }
+
+    state = tevent_req_data(req, struct cache_req_state);
+    if (state->cr == NULL || state->cr->plugin == NULL) {
+        return;
+    }
+
+    if (!tevent_req_is_error(req, &tstate, &err)) {
+        result = "success";
+        err = EOK;
+    } else if (tstate == TEVENT_REQ_USER_ERROR && err == ENOENT) {
+        result = "not_found";
+    } else {
+        result = "error";
+    }
+
+    PROBE(CACHE_REQ_DONE, state->cr->reqid, state->cr->reqname, (int)err);
+
+    sss_metrics_observe(SSS_METRICS_CACHE_REQ_DURATION,
+                        state->cr->plugin->name, result, state->start);
+}
+
 struct tevent_req *cache_req_send(TALLOC_CTX *mem_ctx,
                                   struct tevent_context *ev,
                                   struct resp_ctx *rctx,
@@ -1107,6 +1455,9 @@ struct tevent_req *cache_req_send(TALLOC_CTX *mem_ctx,
     }
 
     state->ev = ev;
+    state->start = sss_metrics_now();
+    tevent_req_set_cleanup_fn(req, cache_req_cleanup);
+
     state->cr = cr = cache_req_create(state, rctx, data,
                                       ncache, midpoint, req_dom_type);
     if (state->cr == NULL) {
@@ -1116,6 +1467,7 @@ struct tevent_req *cache_req_send(TALLOC_CTX *mem_ctx,
     state->first_iteration = true;
 
     CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, cr, "New request '%s'\n", cr->reqname);
+    PROBE(CACHE_REQ_SEND, cr->reqid, cr->reqname, PROBE_SAFE_STR(domain));
 
     ret = cache_req_is_well_known_object(state, cr, &result);
     if (ret == EOK) {
@@ -23,6 +23,7 @@
 #include <tevent.h>
 
 #include "util/util.h"
+#include "util/sss_metrics.h"
 #include "responder/common/cache_req/cache_req_private.h"
 #include "responder/common/cache_req/cache_req_plugin.h"
 #include "db/sysdb.h"
@@ -324,7 +325,11 @@ cache_req_search_send(TALLOC_CTX *mem_ctx,
     state->cr = cr;
 
     ret = cache_req_search_ncache(cr);
-    if (ret != EOK) {
+    if (ret == ENOENT) {
+        sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS, cr->plugin->name,
+                        "negcache");
+        goto done;
+    } else if (ret != EOK) {
         goto done;
     }
 
@@ -368,6 +373,8 @@ cache_req_search_send(TALLOC_CTX *mem_ctx,
         if (status == CACHE_OBJECT_VALID) {
             CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, cr,
                             "Returning [%s] from cache\n", cr->debugobj);
+            sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS, cr->plugin->name,
+                            "cache");
             ret = EOK;
             goto done;
         }
@@ -429,6 +436,8 @@ static errno_t cache_req_search_dp(struct tevent_req *req,
         CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->cr,
                         "Performing midpoint cache update of [%s]\n",
                         state->cr->debugobj);
+        sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS,
+                        state->cr->plugin->name, "midpoint");
 
         subreq = state->cr->plugin->dp_send_fn(state->rctx, state->cr,
                                                state->cr->data,
@@ -449,6 +458,8 @@ static errno_t cache_req_search_dp(struct tevent_req *req,
         CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->cr,
                         "Looking up [%s] in data provider\n",
                         state->cr->debugobj);
+        sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS,
+                        state->cr->plugin->name, "provider");
 
         subreq = state->cr->plugin->dp_send_fn(state->cr, state->cr,
                                                state->cr->data,
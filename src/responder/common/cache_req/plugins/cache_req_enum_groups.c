@@ -41,7 +41,7 @@ cache_req_enum_groups_lookup(TALLOC_CTX *mem_ctx,
                              struct sss_domain_info *domain,
                              struct ldb_result **_result)
 {
-    return sysdb_enumgrent_with_views(mem_ctx, domain, _result);
+    return sysdb_enumgrent_names_with_views(mem_ctx, domain, _result);
 }
 
 static struct tevent_req *
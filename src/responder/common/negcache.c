@@ -23,6 +23,7 @@
 #include <time.h>
 #include "tdb.h"
 #include "util/util.h"
+#include "util/probes.h"
 #include "util/nss_dl_load.h"
 #include "confdb/confdb.h"
 #include "responder/common/negcache_files.h"
@@ -171,6 +172,8 @@ done:
         ret = ENOENT;
     }
 
+    PROBE(NCACHE_CHECK, str, ret);
+
     free(data.dptr);
     return ret;
 }
@@ -97,6 +97,10 @@ struct be_conn {
     char *bus_name;
     char *sbus_address;
     struct sbus_connection *conn;
+
+    /* binary IPC connection, see sss_iface_ipc.h */
+    struct sss_dp_ipc *ipc;
+    time_t ipc_retry;
 };
 
 struct resp_ctx {
@@ -155,7 +159,9 @@ struct resp_ctx {
     bool socket_activated;
     bool dbus_activated;
     bool cache_first;
+    bool parallel_domain_lookup;
     bool enumeration_warn_logged;
+    bool dp_binary_ipc;
 };
 
 struct cli_creds;
@@ -296,6 +302,26 @@ sss_dp_get_account_recv(TALLOC_CTX *mem_ctx,
                         uint32_t *_error,
                         const char **_error_message);
 
+/* Binary IPC to the backend, used for account requests when the
+ * dp_binary_ipc option is enabled. */
+bool sss_dp_ipc_available(struct be_conn *be_conn);
+
+struct tevent_req *
+sss_dp_ipc_get_account_send(TALLOC_CTX *mem_ctx,
+                            struct be_conn *be_conn,
+                            uint32_t dp_flags,
+                            uint32_t entry_type,
+                            const char *filter,
+                            const char *domain,
+                            const char *extra);
+
+errno_t
+sss_dp_ipc_get_account_recv(TALLOC_CTX *mem_ctx,
+                            struct tevent_req *req,
+                            uint16_t *_dp_error,
+                            uint32_t *_error,
+                            const char **_error_message);
+
 struct tevent_req *
 sss_dp_resolver_get_send(TALLOC_CTX *mem_ctx,
                          struct resp_ctx *rctx,
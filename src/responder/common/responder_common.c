@@ -41,6 +41,7 @@
 #include "responder/common/responder_packet.h"
 #include "providers/data_provider.h"
 #include "util/util_creds.h"
+#include "util/probes.h"
 #include "sss_iface/sss_iface_async.h"
 
 #ifdef HAVE_SYSTEMD
@@ -288,6 +289,10 @@ static void client_send(struct cli_ctx *cctx)
     }
 
     /* ok all sent */
+    PROBE(CLIENT_REQUEST_SEND, cctx->cfd,
+          sss_packet_get_cmd(pctx->creq->out),
+          sss_packet_get_status(pctx->creq->out));
+
     TEVENT_FD_NOT_WRITEABLE(cctx->cfde);
     TEVENT_FD_READABLE(cctx->cfde);
     talloc_zfree(pctx->creq);
@@ -337,6 +342,8 @@ static void client_recv(struct cli_ctx *cctx)
     case EOK:
         /* do not read anymore */
         TEVENT_FD_NOT_READABLE(cctx->cfde);
+        PROBE(CLIENT_REQUEST_RECV, cctx->cfd,
+              sss_packet_get_cmd(pctx->creq->in));
         /* execute command */
         ret = client_cmd_execute(cctx, cctx->rctx->sss_cmds);
         if (ret != EOK) {
@@ -803,6 +810,10 @@ sss_dp_on_reconnect(struct sbus_connection *conn,
 
     DEBUG(SSSDBG_TRACE_FUNC, "Reconnected to the Data Provider.\n");
 
+    /* Do not wait for the retry interval to use the binary IPC of the
+     * restarted backend. */
+    be_conn->ipc_retry = 0;
+
     /* Identify ourselves to the DP */
     req = sbus_call_dp_client_Register_send(be_conn, be_conn->conn,
                                             be_conn->bus_name,
@@ -1332,6 +1343,16 @@ int sss_process_init(TALLOC_CTX *mem_ctx,
               ret, sss_strerror(ret));
     }
 
+    ret = confdb_get_bool(rctx->cdb, rctx->confdb_service_path,
+                          CONFDB_RESPONDER_PARALLEL_DOMAIN_LOOKUP,
+                          false, &rctx->parallel_domain_lookup);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot get \"%s\", domains will be searched one by one "
+              "[%d]: %s.\n", CONFDB_RESPONDER_PARALLEL_DOMAIN_LOOKUP,
+              ret, sss_strerror(ret));
+    }
+
     ret = confdb_get_int(rctx->cdb, rctx->confdb_service_path,
                          CONFDB_RESPONDER_GET_DOMAINS_TIMEOUT,
                          GET_DOMAINS_DEFAULT_TIMEOUT, &rctx->domains_timeout);
@@ -1387,6 +1408,15 @@ int sss_process_init(TALLOC_CTX *mem_ctx,
         rctx->override_space = tmp[0];
     }
 
+    ret = confdb_get_bool(rctx->cdb, CONFDB_MONITOR_CONF_ENTRY,
+                          CONFDB_MONITOR_DP_BINARY_IPC, false,
+                          &rctx->dp_binary_ipc);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cannot get the \"%s\" option [%d]: %s\n",
+              CONFDB_MONITOR_DP_BINARY_IPC, ret, sss_strerror(ret));
+        goto fail;
+    }
+
     ret = confdb_get_string(rctx->cdb, rctx,
                             CONFDB_MONITOR_CONF_ENTRY,
                             CONFDB_MONITOR_DOMAIN_RESOLUTION_ORDER, NULL,
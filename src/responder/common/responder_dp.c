@@ -166,6 +166,7 @@ struct sss_dp_get_account_state {
 };
 
 static void sss_dp_get_account_done(struct tevent_req *subreq);
+static void sss_dp_get_account_ipc_done(struct tevent_req *subreq);
 
 struct tevent_req *
 sss_dp_get_account_send(TALLOC_CTX *mem_ctx,
@@ -262,6 +263,21 @@ sss_dp_get_account_send(TALLOC_CTX *mem_ctx,
           dom->name, entry_type, be_req2str(entry_type),
           filter, extra == NULL ? "-" : extra);
 
+    if (sss_dp_ipc_available(be_conn)) {
+        subreq = sss_dp_ipc_get_account_send(state, be_conn, dp_flags,
+                                             entry_type, filter, dom->name,
+                                             extra);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, sss_dp_get_account_ipc_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
     subreq = sbus_call_dp_dp_getAccountInfo_send(state, be_conn->conn,
                  be_conn->bus_name, SSS_BUS_PATH, dp_flags,
                  entry_type, filter, dom->name, extra);
@@ -309,6 +325,27 @@ static void sss_dp_get_account_done(struct tevent_req *subreq)
     return;
 }
 
+static void sss_dp_get_account_ipc_done(struct tevent_req *subreq)
+{
+    struct sss_dp_get_account_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sss_dp_get_account_state);
+
+    ret = sss_dp_ipc_get_account_recv(state, subreq, &state->dp_error,
+                                      &state->error, &state->error_message);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
 errno_t
 sss_dp_get_account_recv(TALLOC_CTX *mem_ctx,
                         struct tevent_req *req,
@@ -0,0 +1,555 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <talloc.h>
+#include <tevent.h>
+
+#include "util/util.h"
+#include "util/dlinklist.h"
+#include "util/sss_ptr_hash.h"
+#include "responder/common/responder.h"
+#include "sss_iface/sss_iface_async.h"
+#include "sss_iface/sss_iface_ipc.h"
+
+/* Do not try to connect more often when the backend does not listen. */
+#define SSS_DP_IPC_RETRY_INTERVAL 30
+
+/* Same as the default sbus method call timeout. */
+#define SSS_DP_IPC_TIMEOUT 120
+
+struct sss_dp_ipc_call;
+
+struct sss_dp_ipc {
+    struct be_conn *be_conn;
+    struct sss_ipc_conn *conn;
+    uint32_t serial;
+
+    /* calls waiting for a reply, oldest first */
+    struct sss_dp_ipc_call *pending;
+
+    /* the same calls by their key, identical requests are attached to the
+     * call already in progress instead of being sent again */
+    hash_table_t *calls;
+};
+
+static void sss_dp_ipc_message(struct sss_ipc_conn *conn,
+                               uint32_t type,
+                               uint32_t serial,
+                               uint8_t *frame,
+                               uint8_t *body,
+                               size_t body_len,
+                               void *pvt);
+
+static void sss_dp_ipc_close(struct sss_ipc_conn *conn, void *pvt);
+
+static errno_t sss_dp_ipc_connect(struct be_conn *be_conn)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sockaddr_un addr;
+    struct sss_dp_ipc *ipc;
+    uid_t check_uid;
+    gid_t check_gid;
+    char *path;
+    int fd = -1;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    path = sss_iface_domain_ipc_path(tmp_ctx, be_conn->domain);
+    if (path == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        ret = EINVAL;
+        goto done;
+    }
+
+    /* Same ownership rules as for the sbus socket. */
+    check_uid = geteuid();
+    check_gid = getegid();
+    if (check_uid == 0) check_uid = -1;
+    if (check_gid == 0) check_gid = -1;
+
+    ret = check_file(path, check_uid, check_gid,
+                     S_IFSOCK|S_IRUSR|S_IWUSR, 0, NULL, true);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        ret = errno;
+        goto done;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    ret = connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+    if (ret != 0) {
+        ret = errno;
+        goto done;
+    }
+
+    ipc = talloc_zero(be_conn, struct sss_dp_ipc);
+    if (ipc == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ipc->be_conn = be_conn;
+    ipc->calls = sss_ptr_hash_create(ipc, NULL, NULL);
+    if (ipc->calls == NULL) {
+        talloc_free(ipc);
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ipc->conn = sss_ipc_conn_create(ipc, be_conn->rctx->ev, fd,
+                                    sss_dp_ipc_message, sss_dp_ipc_close,
+                                    ipc);
+    /* the connection owns the fd now */
+    fd = -1;
+    if (ipc->conn == NULL) {
+        talloc_free(ipc);
+        ret = ENOMEM;
+        goto done;
+    }
+
+    be_conn->ipc = ipc;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Connected to binary IPC of [%s]\n",
+          be_conn->domain->name);
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to connect to [%s], "
+              "falling back to sbus [%d]: %s\n",
+              path == NULL ? "-" : path, ret, sss_strerror(ret));
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+bool sss_dp_ipc_available(struct be_conn *be_conn)
+{
+    time_t now;
+    errno_t ret;
+
+    if (!be_conn->rctx->dp_binary_ipc) {
+        return false;
+    }
+
+    if (be_conn->ipc != NULL) {
+        return true;
+    }
+
+    now = time(NULL);
+    if (now < be_conn->ipc_retry) {
+        return false;
+    }
+
+    ret = sss_dp_ipc_connect(be_conn);
+    if (ret != EOK) {
+        be_conn->ipc_retry = now + SSS_DP_IPC_RETRY_INTERVAL;
+        return false;
+    }
+
+    return true;
+}
+
+/* One request sent to the backend. */
+struct sss_dp_ipc_call {
+    struct sss_dp_ipc_call *prev;
+    struct sss_dp_ipc_call *next;
+
+    struct sss_dp_ipc *ipc;
+    uint32_t serial;
+    char *key;
+    bool finished;
+
+    /* requests waiting for the reply to this call */
+    struct sss_dp_ipc_get_account_state *waiters;
+};
+
+struct sss_dp_ipc_get_account_state {
+    struct sss_dp_ipc_get_account_state *prev;
+    struct sss_dp_ipc_get_account_state *next;
+
+    struct tevent_req *req;
+    struct sss_dp_ipc_call *call;
+
+    uint16_t dp_error;
+    uint32_t error;
+    const char *error_message;
+};
+
+static int sss_dp_ipc_call_destructor(struct sss_dp_ipc_call *call)
+{
+    struct sss_dp_ipc_get_account_state *state;
+
+    if (call->ipc != NULL) {
+        DLIST_REMOVE(call->ipc->pending, call);
+        call->ipc = NULL;
+    }
+
+    while ((state = call->waiters) != NULL) {
+        DLIST_REMOVE(call->waiters, state);
+        state->call = NULL;
+    }
+
+    return 0;
+}
+
+static int
+sss_dp_ipc_get_account_destructor(struct sss_dp_ipc_get_account_state *state)
+{
+    struct sss_dp_ipc_call *call = state->call;
+
+    if (call == NULL) {
+        return 0;
+    }
+
+    DLIST_REMOVE(call->waiters, state);
+    state->call = NULL;
+
+    /* Nobody is interested in the reply anymore, a late reply will not
+     * find the call. */
+    if (call->waiters == NULL && !call->finished) {
+        talloc_free(call);
+    }
+
+    return 0;
+}
+
+/* Finish all requests attached to @call with @error or @reply. */
+static void sss_dp_ipc_call_finish(struct sss_dp_ipc_call *call,
+                                   errno_t error,
+                                   struct sss_ipc_account_reply *reply)
+{
+    struct sss_dp_ipc_get_account_state *state;
+    errno_t ret;
+
+    /* Requests sent from the callbacks must not be attached to this call. */
+    call->finished = true;
+    sss_ptr_hash_delete(call->ipc->calls, call->key, false);
+    DLIST_REMOVE(call->ipc->pending, call);
+    call->ipc = NULL;
+
+    /* The callbacks may free other waiting requests. */
+    while ((state = call->waiters) != NULL) {
+        DLIST_REMOVE(call->waiters, state);
+        state->call = NULL;
+
+        ret = error;
+        if (ret == EOK) {
+            state->dp_error = reply->dp_error;
+            state->error = reply->error;
+            state->error_message = talloc_strdup(state,
+                                                 reply->error_message == NULL
+                                                     ? ""
+                                                     : reply->error_message);
+            if (state->error_message == NULL) {
+                ret = ENOMEM;
+            }
+        }
+
+        if (ret != EOK) {
+            tevent_req_error(state->req, ret);
+        } else {
+            tevent_req_done(state->req);
+        }
+    }
+
+    talloc_free(call);
+}
+
+static void sss_dp_ipc_call_timeout(struct tevent_context *ev,
+                                    struct tevent_timer *te,
+                                    struct timeval tv,
+                                    void *pvt)
+{
+    struct sss_dp_ipc_call *call;
+
+    call = talloc_get_type(pvt, struct sss_dp_ipc_call);
+
+    DEBUG(SSSDBG_MINOR_FAILURE, "Binary IPC request timed out\n");
+
+    sss_dp_ipc_call_finish(call, ETIMEDOUT, NULL);
+}
+
+#define KEY_LEN(str) ((str) == NULL ? (ssize_t)-1 : (ssize_t)strlen(str))
+#define KEY_STR(str) ((str) == NULL ? "" : (str))
+
+static char *sss_dp_ipc_call_key(TALLOC_CTX *mem_ctx,
+                                 const struct sss_ipc_account_req *msg)
+{
+    /* Lengths are included so that the strings can not be confused,
+     * -1 stands for NULL. */
+    return talloc_asprintf(mem_ctx,
+                           "%"PRIu32":%"PRIu32":%zd:%s:%zd:%s:%zd:%s",
+                           msg->dp_flags, msg->entry_type,
+                           KEY_LEN(msg->filter), KEY_STR(msg->filter),
+                           KEY_LEN(msg->domain), KEY_STR(msg->domain),
+                           KEY_LEN(msg->extra), KEY_STR(msg->extra));
+}
+
+#undef KEY_LEN
+#undef KEY_STR
+
+static errno_t sss_dp_ipc_call_send(struct sss_dp_ipc *ipc,
+                                    const struct sss_ipc_account_req *msg,
+                                    const char *key,
+                                    struct sss_dp_ipc_call **_call)
+{
+    struct sss_dp_ipc_call *call;
+    struct tevent_timer *te;
+    uint8_t *frame;
+    errno_t ret;
+
+    call = talloc_zero(ipc, struct sss_dp_ipc_call);
+    if (call == NULL) {
+        return ENOMEM;
+    }
+
+    call->serial = ++ipc->serial;
+    call->key = talloc_strdup(call, key);
+    if (call->key == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_ipc_account_req_encode(call, call->serial, msg, &frame);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    te = tevent_add_timer(ipc->be_conn->rctx->ev, call,
+                          tevent_timeval_current_ofs(SSS_DP_IPC_TIMEOUT, 0),
+                          sss_dp_ipc_call_timeout, call);
+    if (te == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_ptr_hash_add(ipc->calls, key, call, struct sss_dp_ipc_call);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_ipc_conn_send(ipc->conn, frame);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    call->ipc = ipc;
+    DLIST_ADD_END(ipc->pending, call, struct sss_dp_ipc_call *);
+    talloc_set_destructor(call, sss_dp_ipc_call_destructor);
+
+    *_call = call;
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(call);
+    }
+
+    return ret;
+}
+
+struct tevent_req *
+sss_dp_ipc_get_account_send(TALLOC_CTX *mem_ctx,
+                            struct be_conn *be_conn,
+                            uint32_t dp_flags,
+                            uint32_t entry_type,
+                            const char *filter,
+                            const char *domain,
+                            const char *extra)
+{
+    struct sss_dp_ipc_get_account_state *state;
+    struct sss_ipc_account_req msg;
+    struct sss_dp_ipc_call *call;
+    struct tevent_context *ev;
+    struct tevent_req *req;
+    struct sss_dp_ipc *ipc;
+    char *key = NULL;
+    errno_t ret;
+
+    ev = be_conn->rctx->ev;
+    ipc = be_conn->ipc;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct sss_dp_ipc_get_account_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->req = req;
+
+    if (ipc == NULL) {
+        ret = ENOTCONN;
+        goto done;
+    }
+
+    msg.dp_flags = dp_flags;
+    msg.entry_type = entry_type;
+    msg.filter = filter;
+    msg.domain = domain;
+    msg.extra = extra;
+
+    key = sss_dp_ipc_call_key(state, &msg);
+    if (key == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    call = sss_ptr_hash_lookup(ipc->calls, key, struct sss_dp_ipc_call);
+    if (call != NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Identical request [%s] is already in "
+              "progress, waiting for its reply\n", key);
+    } else {
+        ret = sss_dp_ipc_call_send(ipc, &msg, key, &call);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    state->call = call;
+    DLIST_ADD_END(call->waiters, state,
+                  struct sss_dp_ipc_get_account_state *);
+    talloc_set_destructor(state, sss_dp_ipc_get_account_destructor);
+
+    ret = EAGAIN;
+
+done:
+    talloc_free(key);
+
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+errno_t
+sss_dp_ipc_get_account_recv(TALLOC_CTX *mem_ctx,
+                            struct tevent_req *req,
+                            uint16_t *_dp_error,
+                            uint32_t *_error,
+                            const char **_error_message)
+{
+    struct sss_dp_ipc_get_account_state *state;
+    state = tevent_req_data(req, struct sss_dp_ipc_get_account_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_dp_error = state->dp_error;
+    *_error = state->error;
+    *_error_message = talloc_steal(mem_ctx, state->error_message);
+
+    return EOK;
+}
+
+static void sss_dp_ipc_message(struct sss_ipc_conn *conn,
+                               uint32_t type,
+                               uint32_t serial,
+                               uint8_t *frame,
+                               uint8_t *body,
+                               size_t body_len,
+                               void *pvt)
+{
+    struct sss_ipc_account_reply reply = { 0 };
+    struct sss_dp_ipc_call *call;
+    struct sss_dp_ipc *ipc;
+    errno_t error;
+    errno_t ret;
+
+    ipc = talloc_get_type(pvt, struct sss_dp_ipc);
+
+    /* Replies usually come in order, so this is short. */
+    for (call = ipc->pending; call != NULL; call = call->next) {
+        if (call->serial == serial) {
+            break;
+        }
+    }
+
+    if (call == NULL) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Reply to unknown request %"PRIu32", "
+              "it was probably cancelled\n", serial);
+        talloc_free(frame);
+        return;
+    }
+
+    switch (type) {
+    case SSS_IPC_GET_ACCOUNT_INFO_REPLY:
+        ret = sss_ipc_account_reply_decode(body, body_len, &reply);
+        break;
+    case SSS_IPC_ERROR_REPLY:
+        ret = sss_ipc_error_reply_decode(body, body_len, &error);
+        if (ret == EOK) {
+            ret = error;
+        }
+        break;
+    default:
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unexpected message type %"PRIu32"\n",
+              type);
+        ret = EBADMSG;
+        break;
+    }
+
+    /* the decoded reply points into the frame */
+    sss_dp_ipc_call_finish(call, ret, &reply);
+    talloc_free(frame);
+}
+
+static void sss_dp_ipc_close(struct sss_ipc_conn *conn, void *pvt)
+{
+    struct sss_dp_ipc *ipc;
+
+    ipc = talloc_get_type(pvt, struct sss_dp_ipc);
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Binary IPC connection to [%s] closed\n",
+          ipc->be_conn->domain->name);
+
+    ipc->be_conn->ipc = NULL;
+
+    while (ipc->pending != NULL) {
+        sss_dp_ipc_call_finish(ipc->pending, EIO, NULL);
+    }
+
+    talloc_free(ipc);
+}
@@ -30,6 +30,21 @@
 
 #define SSSSRV_PACKET_MEM_SIZE 512
 
+/* Packet buffers are taken from a per-process pool with a few size classes
+ * so that the buffers of finished requests can be reused by the next ones.
+ * Each class is four times the size of the previous one, buffers larger
+ * than the biggest class are allocated and freed directly. */
+#define SSSSRV_PACKET_POOL_CLASSES 6
+#define SSSSRV_PACKET_POOL_MAX_FREE 4
+
+struct sss_packet_pool {
+    TALLOC_CTX *ctx;
+    uint8_t *free[SSSSRV_PACKET_POOL_CLASSES][SSSSRV_PACKET_POOL_MAX_FREE];
+    size_t num_free[SSSSRV_PACKET_POOL_CLASSES];
+};
+
+static struct sss_packet_pool sss_packet_pool;
+
 struct sss_packet {
     size_t memsize;
 
@@ -59,6 +74,105 @@ static void sss_packet_set_cmd(struct sss_packet *packet,
                                enum sss_cli_command cmd);
 static uint32_t sss_packet_get_len(struct sss_packet *packet);
 
+static size_t sss_packet_class_size(int class)
+{
+    return (size_t)SSSSRV_PACKET_MEM_SIZE << (2 * class);
+}
+
+/* Returns the smallest size class that can hold @size bytes or -1 if the
+ * buffer is too large to be pooled. */
+static int sss_packet_size_class(size_t size)
+{
+    int class;
+
+    for (class = 0; class < SSSSRV_PACKET_POOL_CLASSES; class++) {
+        if (size <= sss_packet_class_size(class)) {
+            return class;
+        }
+    }
+
+    return -1;
+}
+
+static uint8_t *sss_packet_buffer_get(struct sss_packet *packet,
+                                      size_t size,
+                                      size_t *_memsize)
+{
+    struct sss_packet_pool *pool = &sss_packet_pool;
+    uint8_t *buffer;
+    int class;
+
+    class = sss_packet_size_class(size);
+    if (class == -1) {
+        /* Round up so that a growing packet is not reallocated too often. */
+        size = (size / SSSSRV_PACKET_MEM_SIZE + 1) * SSSSRV_PACKET_MEM_SIZE;
+        buffer = talloc_size(packet, size);
+        if (buffer != NULL) {
+            *_memsize = size;
+        }
+        return buffer;
+    }
+
+    size = sss_packet_class_size(class);
+    if (pool->num_free[class] > 0) {
+        pool->num_free[class]--;
+        buffer = pool->free[class][pool->num_free[class]];
+        talloc_steal(packet, buffer);
+    } else {
+        buffer = talloc_size(packet, size);
+        if (buffer == NULL) {
+            return NULL;
+        }
+    }
+
+    *_memsize = size;
+    return buffer;
+}
+
+/* @used is the number of bytes that may contain client data, they are
+ * erased before the buffer is handed to another request. */
+static void sss_packet_buffer_put(uint8_t *buffer, size_t memsize,
+                                  size_t used)
+{
+    struct sss_packet_pool *pool = &sss_packet_pool;
+    int class;
+
+    class = sss_packet_size_class(memsize);
+    if (class == -1 || memsize != sss_packet_class_size(class)
+            || pool->num_free[class] == SSSSRV_PACKET_POOL_MAX_FREE) {
+        talloc_free(buffer);
+        return;
+    }
+
+    if (pool->ctx == NULL) {
+        pool->ctx = talloc_named_const(NULL, 0, "sss_packet_pool");
+        if (pool->ctx == NULL) {
+            talloc_free(buffer);
+            return;
+        }
+    }
+
+    sss_erase_mem_securely(buffer, MIN(used, memsize));
+
+    pool->free[class][pool->num_free[class]] = talloc_steal(pool->ctx, buffer);
+    pool->num_free[class]++;
+}
+
+static int sss_packet_destructor(struct sss_packet *packet)
+{
+    size_t used;
+
+    if (packet->buffer == NULL) {
+        return 0;
+    }
+
+    used = MAX(packet->iop, sss_packet_get_len(packet));
+    sss_packet_buffer_put(packet->buffer, packet->memsize, used);
+    packet->buffer = NULL;
+
+    return 0;
+}
+
 /*
  * Allocate a new packet structure
  *
@@ -74,14 +188,8 @@ int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
     packet = talloc(mem_ctx, struct sss_packet);
     if (!packet) return ENOMEM;
 
-    if (size) {
-        int n = (size + SSS_NSS_HEADER_SIZE) / SSSSRV_PACKET_MEM_SIZE;
-        packet->memsize = (n + 1) * SSSSRV_PACKET_MEM_SIZE;
-    } else {
-        packet->memsize = SSSSRV_PACKET_MEM_SIZE;
-    }
-
-    packet->buffer = talloc_size(packet, packet->memsize);
+    packet->buffer = sss_packet_buffer_get(packet, size + SSS_NSS_HEADER_SIZE,
+                                           &packet->memsize);
     if (!packet->buffer) {
         talloc_free(packet);
         return ENOMEM;
@@ -93,53 +201,74 @@ int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
 
     packet->iop = 0;
 
+    talloc_set_destructor(packet, sss_packet_destructor);
+
     *rpacket = packet;
 
     return EOK;
 }
 
-/* grows a packet size only in SSSSRV_PACKET_MEM_SIZE chunks */
-int sss_packet_grow(struct sss_packet *packet, size_t size)
+/* Make sure there is room for @size more bytes after the current end of the
+ * packet. The buffer grows at least twice its size to keep the number of
+ * copies low when a reply is built piece by piece. */
+static int sss_packet_ensure(struct sss_packet *packet, size_t size)
 {
-    size_t totlen, len;
+    size_t packet_len;
+    size_t used;
+    size_t len;
+    size_t memsize;
     uint8_t *newmem;
-    uint32_t packet_len;
-
-    if (size == 0) {
-        return EOK;
-    }
 
-    totlen = packet->memsize;
     packet_len = sss_packet_get_len(packet);
 
     len = packet_len + size;
 
     /* make sure we do not overflow */
-    if (totlen < len) {
-        int n = len / SSSSRV_PACKET_MEM_SIZE + 1;
-        totlen += n * SSSSRV_PACKET_MEM_SIZE;
-        if (totlen < len) {
-            return EINVAL;
-        }
+    if (len < packet_len || len > UINT32_MAX) {
+        return EINVAL;
     }
 
-    if (totlen > packet->memsize) {
-        newmem = talloc_realloc_size(packet, packet->buffer, totlen);
-        if (!newmem) {
-            return ENOMEM;
-        }
+    if (len <= packet->memsize) {
+        return EOK;
+    }
 
-        packet->memsize = totlen;
+    newmem = sss_packet_buffer_get(packet, MAX(len, 2 * packet->memsize),
+                                   &memsize);
+    if (!newmem) {
+        return ENOMEM;
+    }
 
-        /* re-set pointers if realloc had to move memory */
-        if (newmem != packet->buffer) {
-            packet->buffer = newmem;
-        }
+    /* The length may have been reset while the data were received, keep
+     * everything that was read so far. */
+    used = MAX(packet_len, packet->iop);
+    memcpy(newmem, packet->buffer, MIN(used, packet->memsize));
+
+    sss_packet_buffer_put(packet->buffer, packet->memsize, used);
+    packet->buffer = newmem;
+    packet->memsize = memsize;
+
+    return EOK;
+}
+
+int sss_packet_reserve(struct sss_packet *packet, size_t size)
+{
+    return sss_packet_ensure(packet, size);
+}
+
+int sss_packet_grow(struct sss_packet *packet, size_t size)
+{
+    int ret;
+
+    if (size == 0) {
+        return EOK;
     }
 
-    packet_len += size;
-    sss_packet_set_len(packet, packet_len);
+    ret = sss_packet_ensure(packet, size);
+    if (ret != EOK) {
+        return ret;
+    }
 
+    sss_packet_set_len(packet, sss_packet_get_len(packet) + size);
 
     return 0;
 }
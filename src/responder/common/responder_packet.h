@@ -34,6 +34,9 @@ int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
                    enum sss_cli_command cmd,
                    struct sss_packet **rpacket);
 int sss_packet_grow(struct sss_packet *packet, size_t size);
+/* Make room for @size more bytes without changing the packet length, use
+ * before filling a reply whose size is known or can be estimated. */
+int sss_packet_reserve(struct sss_packet *packet, size_t size);
 int sss_packet_shrink(struct sss_packet *packet, size_t size);
 int sss_packet_set_size(struct sss_packet *packet, size_t size);
 int sss_packet_recv(struct sss_packet *packet, int fd);
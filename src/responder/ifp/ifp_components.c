@@ -27,8 +27,10 @@
 #include "config.h"
 #include "confdb/confdb.h"
 #include "util/util.h"
+#include "util/sss_metrics.h"
 #include "responder/common/responder.h"
 #include "responder/ifp/ifp_components.h"
+#include "sss_iface/sss_iface_async.h"
 
 #define PATH_MONITOR    IFP_PATH_COMPONENTS "/monitor"
 #define PATH_RESPONDERS IFP_PATH_COMPONENTS "/Responders"
@@ -394,6 +396,189 @@ ifp_find_backend_by_name(TALLOC_CTX *mem_ctx,
     return ENOENT;
 }
 
+struct ifp_get_metrics_state {
+    const char **dumps;
+    size_t num_dumps;
+    size_t num_pending;
+    const char *metrics;
+};
+
+static errno_t ifp_get_metrics_call(struct tevent_req *req,
+                                    struct sbus_connection *conn,
+                                    const char *bus_name);
+static void ifp_get_metrics_done(struct tevent_req *subreq);
+
+static errno_t ifp_get_metrics_format(struct ifp_get_metrics_state *state)
+{
+    state->metrics = sss_metrics_format(state, state->dumps);
+    if (state->metrics == NULL) {
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+struct tevent_req *
+ifp_get_metrics_send(TALLOC_CTX *mem_ctx,
+                     struct tevent_context *ev,
+                     struct sbus_request *sbus_req,
+                     struct ifp_ctx *ctx)
+{
+    const char * const *svc = get_known_services();
+    struct ifp_get_metrics_state *state;
+    struct sss_domain_info *dom;
+    struct tevent_req *req;
+    const char *bus_name;
+    size_t num;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct ifp_get_metrics_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    /* InfoPipe itself, the other responders and all backends */
+    for (num = 0; svc[num] != NULL; num++);
+    for (dom = ctx->rctx->domains; dom != NULL; dom = get_next_domain(dom, 0)) {
+        num++;
+    }
+
+    state->dumps = talloc_zero_array(state, const char *, num + 1);
+    if (state->dumps == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    state->dumps[0] = sss_metrics_dump(state->dumps);
+    if (state->dumps[0] == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    state->num_dumps = 1;
+
+    for (; *svc != NULL; svc++) {
+        if (strcmp(*svc, "ifp") == 0) {
+            continue;
+        }
+
+        bus_name = talloc_asprintf(state, "sssd.%s", *svc);
+        if (bus_name == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = ifp_get_metrics_call(req, ctx->rctx->mon_conn, bus_name);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    for (dom = ctx->rctx->domains; dom != NULL; dom = get_next_domain(dom, 0)) {
+        bus_name = sss_iface_domain_bus(state, dom);
+        if (bus_name == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = ifp_get_metrics_call(req, ctx->rctx->mon_conn, bus_name);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    if (state->num_pending > 0) {
+        ret = EAGAIN;
+        goto done;
+    }
+
+    /* Nobody else to ask, reply with the metrics of InfoPipe alone. */
+    ret = ifp_get_metrics_format(state);
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+        tevent_req_post(req, ev);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static errno_t ifp_get_metrics_call(struct tevent_req *req,
+                                    struct sbus_connection *conn,
+                                    const char *bus_name)
+{
+    struct ifp_get_metrics_state *state;
+    struct tevent_req *subreq;
+
+    state = tevent_req_data(req, struct ifp_get_metrics_state);
+
+    subreq = sbus_call_metrics_Dump_send(state, conn, bus_name, SSS_BUS_PATH);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, ifp_get_metrics_done, req);
+    state->num_pending++;
+
+    return EOK;
+}
+
+static void ifp_get_metrics_done(struct tevent_req *subreq)
+{
+    struct ifp_get_metrics_state *state;
+    struct tevent_req *req;
+    const char *dump;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct ifp_get_metrics_state);
+
+    ret = sbus_call_metrics_Dump_recv(state->dumps, subreq, &dump);
+    talloc_zfree(subreq);
+    if (ret == EOK) {
+        state->dumps[state->num_dumps] = dump;
+        state->num_dumps++;
+    } else {
+        /* Services that are not running do not contribute any metrics. */
+        DEBUG(SSSDBG_TRACE_FUNC, "Unable to get metrics [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    state->num_pending--;
+    if (state->num_pending > 0) {
+        return;
+    }
+
+    ret = ifp_get_metrics_format(state);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+errno_t
+ifp_get_metrics_recv(TALLOC_CTX *mem_ctx,
+                     struct tevent_req *req,
+                     const char **_metrics)
+{
+    struct ifp_get_metrics_state *state;
+
+    state = tevent_req_data(req, struct ifp_get_metrics_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_metrics = talloc_steal(mem_ctx, state->metrics);
+
+    return EOK;
+}
+
 errno_t
 ifp_component_get_name(TALLOC_CTX *mem_ctx,
                        struct sbus_request *sbus_req,
@@ -63,6 +63,17 @@ ifp_find_backend_by_name(TALLOC_CTX *mem_ctx,
                          const char *name,
                          const char **_path);
 
+struct tevent_req *
+ifp_get_metrics_send(TALLOC_CTX *mem_ctx,
+                     struct tevent_context *ev,
+                     struct sbus_request *sbus_req,
+                     struct ifp_ctx *ctx);
+
+errno_t
+ifp_get_metrics_recv(TALLOC_CTX *mem_ctx,
+                     struct tevent_req *req,
+                     const char **_metrics);
+
 /* org.freedesktop.sssd.infopipe.Components */
 
 errno_t
@@ -521,6 +521,53 @@ ifp_groups_list_by_domain_and_name_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct tevent_req *
+ifp_groups_list_by_name_paged_send(TALLOC_CTX *mem_ctx,
+                                   struct tevent_context *ev,
+                                   struct sbus_request *sbus_req,
+                                   struct ifp_ctx *ctx,
+                                   const char *filter,
+                                   const char *cursor,
+                                   uint32_t page_size)
+{
+    return ifp_list_paged_send(mem_ctx, ev, ctx, CACHE_REQ_GROUP_BY_FILTER,
+                               ifp_groups_build_path_from_msg, NULL,
+                               filter, cursor, page_size);
+}
+
+errno_t
+ifp_groups_list_by_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                   struct tevent_req *req,
+                                   const char ***_paths,
+                                   const char **_next_cursor)
+{
+    return ifp_list_paged_recv(mem_ctx, req, _paths, _next_cursor);
+}
+
+struct tevent_req *
+ifp_groups_list_by_domain_and_name_paged_send(TALLOC_CTX *mem_ctx,
+                                              struct tevent_context *ev,
+                                              struct sbus_request *sbus_req,
+                                              struct ifp_ctx *ctx,
+                                              const char *domain,
+                                              const char *filter,
+                                              const char *cursor,
+                                              uint32_t page_size)
+{
+    return ifp_list_paged_send(mem_ctx, ev, ctx, CACHE_REQ_GROUP_BY_FILTER,
+                               ifp_groups_build_path_from_msg, domain,
+                               filter, cursor, page_size);
+}
+
+errno_t
+ifp_groups_list_by_domain_and_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                              struct tevent_req *req,
+                                              const char ***_paths,
+                                              const char **_next_cursor)
+{
+    return ifp_list_paged_recv(mem_ctx, req, _paths, _next_cursor);
+}
+
 static errno_t
 ifp_groups_get_from_cache(TALLOC_CTX *mem_ctx,
                           struct sss_domain_info *domain,
@@ -56,6 +56,45 @@ errno_t _sbus_ifp_invoker_write_ao
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_read_aos
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aos *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_ao(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_s(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_aos
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aos *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_ao(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_s(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_as
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -85,6 +124,84 @@ errno_t _sbus_ifp_invoker_write_as
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_read_asas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_asas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_as(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_as(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_read_auas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_auas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_au(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_auas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_auas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_au(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_as(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_b
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -172,6 +289,19 @@ errno_t _sbus_ifp_invoker_write_o
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_o
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_o *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_OBJECT_PATH) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_s
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -201,6 +331,19 @@ errno_t _sbus_ifp_invoker_write_s
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_s *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_sas
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -279,6 +422,115 @@ errno_t _sbus_ifp_invoker_write_ss
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_read_sssu
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_s(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_s(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_s(mem_ctx, iter, &args->arg2);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_u(iter, &args->arg3);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_sssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_s(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_s(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_s(iter, args->arg2);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_u(iter, args->arg3);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_borrow_sssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg3);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_ssu
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -328,6 +580,31 @@ errno_t _sbus_ifp_invoker_write_ssu
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_ssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ssu *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_su
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -367,6 +644,25 @@ errno_t _sbus_ifp_invoker_write_su
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_su
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_su *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_u
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -396,3 +692,16 @@ errno_t _sbus_ifp_invoker_write_u
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_u *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
@@ -43,6 +43,22 @@ _sbus_ifp_invoker_write_ao
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_ao *args);
 
+struct _sbus_ifp_invoker_args_aos {
+    const char ** arg0;
+    const char * arg1;
+};
+
+errno_t
+_sbus_ifp_invoker_read_aos
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aos *args);
+
+errno_t
+_sbus_ifp_invoker_write_aos
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aos *args);
+
 struct _sbus_ifp_invoker_args_as {
     const char ** arg0;
 };
@@ -58,6 +74,38 @@ _sbus_ifp_invoker_write_as
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_as *args);
 
+struct _sbus_ifp_invoker_args_asas {
+    const char ** arg0;
+    const char ** arg1;
+};
+
+errno_t
+_sbus_ifp_invoker_read_asas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asas *args);
+
+errno_t
+_sbus_ifp_invoker_write_asas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asas *args);
+
+struct _sbus_ifp_invoker_args_auas {
+    uint32_t * arg0;
+    const char ** arg1;
+};
+
+errno_t
+_sbus_ifp_invoker_read_auas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_auas *args);
+
+errno_t
+_sbus_ifp_invoker_write_auas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_auas *args);
+
 struct _sbus_ifp_invoker_args_b {
     bool arg0;
 };
@@ -103,6 +151,13 @@ _sbus_ifp_invoker_write_o
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_o *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_o
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_o *args);
+
 struct _sbus_ifp_invoker_args_s {
     const char * arg0;
 };
@@ -118,6 +173,13 @@ _sbus_ifp_invoker_write_s
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_s *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_s *args);
+
 struct _sbus_ifp_invoker_args_sas {
     const char * arg0;
     const char ** arg1;
@@ -150,6 +212,38 @@ _sbus_ifp_invoker_write_ss
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_ss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ss *args);
+
+struct _sbus_ifp_invoker_args_sssu {
+    const char * arg0;
+    const char * arg1;
+    const char * arg2;
+    uint32_t arg3;
+};
+
+errno_t
+_sbus_ifp_invoker_read_sssu
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args);
+
+errno_t
+_sbus_ifp_invoker_write_sssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args);
+
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_sssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_sssu *args);
+
 struct _sbus_ifp_invoker_args_ssu {
     const char * arg0;
     const char * arg1;
@@ -167,6 +261,13 @@ _sbus_ifp_invoker_write_ssu
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_ssu *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_ssu
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ssu *args);
+
 struct _sbus_ifp_invoker_args_su {
     const char * arg0;
     uint32_t arg1;
@@ -183,6 +284,13 @@ _sbus_ifp_invoker_write_su
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_su *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_su
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_su *args);
+
 struct _sbus_ifp_invoker_args_u {
     uint32_t arg0;
 };
@@ -198,4 +306,11 @@ _sbus_ifp_invoker_write_u
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_u *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_ifp_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_u *args);
+
 #endif /* _SBUS_IFP_ARGUMENTS_H_ */
@@ -63,6 +63,14 @@ sbus_call_ifp_FindResponderByName
      const char * arg_name,
      const char ** _arg_responder);
 
+errno_t
+sbus_call_ifp_GetMetrics
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** _arg_metrics);
+
 errno_t
 sbus_call_ifp_GetUserAttr
     (TALLOC_CTX *mem_ctx,
@@ -222,6 +230,19 @@ sbus_call_ifp_groups_ListByDomainAndName
      uint32_t arg_limit,
      const char *** _arg_result);
 
+errno_t
+sbus_call_ifp_groups_ListByDomainAndNamePaged
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_domain_name,
+     const char * arg_name_filter,
+     const char * arg_cursor,
+     uint32_t arg_page_size,
+     const char *** _arg_result,
+     const char ** _arg_next_cursor);
+
 errno_t
 sbus_call_ifp_groups_ListByName
     (TALLOC_CTX *mem_ctx,
@@ -232,6 +253,18 @@ sbus_call_ifp_groups_ListByName
      uint32_t arg_limit,
      const char *** _arg_result);
 
+errno_t
+sbus_call_ifp_groups_ListByNamePaged
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_name_filter,
+     const char * arg_cursor,
+     uint32_t arg_page_size,
+     const char *** _arg_result,
+     const char ** _arg_next_cursor);
+
 errno_t
 sbus_call_ifp_group_UpdateMemberList
     (struct sbus_sync_connection *conn,
@@ -275,6 +308,26 @@ sbus_call_ifp_users_FindByNameAndCertificate
      const char * arg_pem_cert,
      const char ** _arg_result);
 
+errno_t
+sbus_call_ifp_users_GetAttrsByIDList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t * arg_ids,
+     const char ** arg_attrs,
+     DBusMessage **_reply);
+
+errno_t
+sbus_call_ifp_users_GetAttrsByNameList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_names,
+     const char ** arg_attrs,
+     DBusMessage **_reply);
+
 errno_t
 sbus_call_ifp_users_ListByCertificate
     (TALLOC_CTX *mem_ctx,
@@ -296,6 +349,19 @@ sbus_call_ifp_users_ListByDomainAndName
      uint32_t arg_limit,
      const char *** _arg_result);
 
+errno_t
+sbus_call_ifp_users_ListByDomainAndNamePaged
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_domain_name,
+     const char * arg_name_filter,
+     const char * arg_cursor,
+     uint32_t arg_page_size,
+     const char *** _arg_result,
+     const char ** _arg_next_cursor);
+
 errno_t
 sbus_call_ifp_users_ListByName
     (TALLOC_CTX *mem_ctx,
@@ -306,6 +372,18 @@ sbus_call_ifp_users_ListByName
      uint32_t arg_limit,
      const char *** _arg_result);
 
+errno_t
+sbus_call_ifp_users_ListByNamePaged
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_name_filter,
+     const char * arg_cursor,
+     uint32_t arg_page_size,
+     const char *** _arg_result,
+     const char ** _arg_next_cursor);
+
 errno_t
 sbus_call_ifp_user_UpdateGroupsList
     (struct sbus_sync_connection *conn,
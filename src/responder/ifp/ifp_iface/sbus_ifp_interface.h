@@ -119,6 +119,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.GetMetrics */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_GetMetrics(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **); \
+    sbus_method_sync("GetMetrics", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_GetMetrics, \
+        NULL, \
+        _sbus_ifp_invoke_in__out_s_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_GetMetrics(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data)); \
+    SBUS_CHECK_RECV((handler_recv), const char **); \
+    sbus_method_async("GetMetrics", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_GetMetrics, \
+        NULL, \
+        _sbus_ifp_invoke_in__out_s_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.GetUserAttr */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_GetUserAttr(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char **, DBusMessageIter *); \
@@ -1238,6 +1260,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Groups.ListByDomainAndNamePaged */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndNamePaged(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char *, const char *, uint32_t, const char ***, const char **); \
+    sbus_method_sync("ListByDomainAndNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_sssu_out_aos_send, \
+        _sbus_ifp_key_sssu_0_1_2_3, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndNamePaged(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *, const char *, const char *, uint32_t); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, const char **); \
+    sbus_method_async("ListByDomainAndNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_sssu_out_aos_send, \
+        _sbus_ifp_key_sssu_0_1_2_3, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Groups.ListByName */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_ListByName(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, uint32_t, const char ***); \
@@ -1260,6 +1304,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Groups.ListByNamePaged */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_ListByNamePaged(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char *, uint32_t, const char ***, const char **); \
+    sbus_method_sync("ListByNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_ssu_out_aos_send, \
+        _sbus_ifp_key_ssu_0_1_2, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Groups_ListByNamePaged(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *, const char *, uint32_t); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, const char **); \
+    sbus_method_async("ListByNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_ssu_out_aos_send, \
+        _sbus_ifp_key_ssu_0_1_2, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Interface: org.freedesktop.sssd.infopipe.Groups.Group */
 #define SBUS_IFACE_org_freedesktop_sssd_infopipe_Groups_Group(methods, signals, properties) ({ \
     sbus_interface("org.freedesktop.sssd.infopipe.Groups.Group", NULL, \
@@ -1557,6 +1623,50 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Users.GetAttrsByIDList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_GetAttrsByIDList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), uint32_t *, const char **, DBusMessageIter *); \
+    sbus_method_sync("GetAttrsByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_auas_out_raw_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_GetAttrsByIDList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), uint32_t *, const char **, DBusMessageIter *); \
+    SBUS_CHECK_RECV((handler_recv)); \
+    sbus_method_async("GetAttrsByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_auas_out_raw_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
+/* Method: org.freedesktop.sssd.infopipe.Users.GetAttrsByNameList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_GetAttrsByNameList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **, const char **, DBusMessageIter *); \
+    sbus_method_sync("GetAttrsByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_asas_out_raw_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_GetAttrsByNameList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char **, const char **, DBusMessageIter *); \
+    SBUS_CHECK_RECV((handler_recv)); \
+    sbus_method_async("GetAttrsByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_asas_out_raw_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Users.ListByCertificate */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_ListByCertificate(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, uint32_t, const char ***); \
@@ -1601,6 +1711,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Users.ListByDomainAndNamePaged */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_ListByDomainAndNamePaged(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char *, const char *, uint32_t, const char ***, const char **); \
+    sbus_method_sync("ListByDomainAndNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByDomainAndNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_sssu_out_aos_send, \
+        _sbus_ifp_key_sssu_0_1_2_3, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_ListByDomainAndNamePaged(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *, const char *, const char *, uint32_t); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, const char **); \
+    sbus_method_async("ListByDomainAndNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByDomainAndNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_sssu_out_aos_send, \
+        _sbus_ifp_key_sssu_0_1_2_3, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Users.ListByName */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_ListByName(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, uint32_t, const char ***); \
@@ -1623,6 +1755,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Users.ListByNamePaged */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_ListByNamePaged(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char *, uint32_t, const char ***, const char **); \
+    sbus_method_sync("ListByNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_ssu_out_aos_send, \
+        _sbus_ifp_key_ssu_0_1_2, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_ListByNamePaged(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *, const char *, uint32_t); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, const char **); \
+    sbus_method_async("ListByNamePaged", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByNamePaged, \
+        NULL, \
+        _sbus_ifp_invoke_in_ssu_out_aos_send, \
+        _sbus_ifp_key_ssu_0_1_2, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Interface: org.freedesktop.sssd.infopipe.Users.User */
 #define SBUS_IFACE_org_freedesktop_sssd_infopipe_Users_User(methods, signals, properties) ({ \
     sbus_interface("org.freedesktop.sssd.infopipe.Users.User", NULL, \
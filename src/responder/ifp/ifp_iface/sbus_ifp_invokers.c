@@ -1382,8 +1382,338 @@ static void _sbus_ifp_invoke_in__out_u_done(struct tevent_req *subreq)
     return;
 }
 
+struct _sbus_ifp_invoke_in_asas_out_raw_state {
+    struct _sbus_ifp_invoker_args_asas in;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char **, const char **, DBusMessageIter *);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char **, const char **, DBusMessageIter *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_ifp_invoke_in_asas_out_raw_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_ifp_invoke_in_asas_out_raw_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_ifp_invoke_in_asas_out_raw_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_ifp_invoke_in_asas_out_raw_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_asas_out_raw_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    ret = _sbus_ifp_invoker_read_asas(state, read_iterator, &state->in);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_asas_out_raw_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_ifp_invoke_in_asas_out_raw_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_ifp_invoke_in_asas_out_raw_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_asas_out_raw_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_asas_out_raw_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_ifp_invoke_in_asas_out_raw_done(struct tevent_req *subreq)
+{
+    struct _sbus_ifp_invoke_in_asas_out_raw_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_asas_out_raw_state);
+
+    ret = state->handler.recv(state, subreq);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
+struct _sbus_ifp_invoke_in_auas_out_raw_state {
+    struct _sbus_ifp_invoker_args_auas in;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, uint32_t *, const char **, DBusMessageIter *);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, uint32_t *, const char **, DBusMessageIter *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_ifp_invoke_in_auas_out_raw_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_ifp_invoke_in_auas_out_raw_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_ifp_invoke_in_auas_out_raw_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_ifp_invoke_in_auas_out_raw_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_auas_out_raw_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    ret = _sbus_ifp_invoker_read_auas(state, read_iterator, &state->in);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_auas_out_raw_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_ifp_invoke_in_auas_out_raw_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_ifp_invoke_in_auas_out_raw_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_auas_out_raw_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_auas_out_raw_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_ifp_invoke_in_auas_out_raw_done(struct tevent_req *subreq)
+{
+    struct _sbus_ifp_invoke_in_auas_out_raw_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_auas_out_raw_state);
+
+    ret = state->handler.recv(state, subreq);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
 struct _sbus_ifp_invoke_in_s_out_ao_state {
-    struct _sbus_ifp_invoker_args_s *in;
+    struct _sbus_ifp_invoker_args_s in;
     struct _sbus_ifp_invoker_args_ao out;
     struct {
         enum sbus_handler_type type;
@@ -1399,18 +1729,368 @@ struct _sbus_ifp_invoke_in_s_out_ao_state {
 };
 
 static void
-_sbus_ifp_invoke_in_s_out_ao_step
+_sbus_ifp_invoke_in_s_out_ao_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_ifp_invoke_in_s_out_ao_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_ifp_invoke_in_s_out_ao_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_ao_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_s(read_iterator, &state->in);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_ao_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_ifp_invoke_in_s_out_ao_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_ao_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_ao_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_ifp_invoke_in_s_out_ao_done(struct tevent_req *subreq)
+{
+    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_ao_state);
+
+    ret = state->handler.recv(state, subreq, &state->out.arg0);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
+struct _sbus_ifp_invoke_in_s_out_as_state {
+    struct _sbus_ifp_invoker_args_s in;
+    struct _sbus_ifp_invoker_args_as out;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char ***);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_ifp_invoke_in_s_out_as_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_s_out_ao_done
+_sbus_ifp_invoke_in_s_out_as_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_ifp_invoke_in_s_out_as_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_as_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_s(read_iterator, &state->in);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_as_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_ifp_invoke_in_s_out_as_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_as_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = _sbus_ifp_invoker_write_as(state->write_iterator, &state->out);
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_as_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_ifp_invoke_in_s_out_as_done(struct tevent_req *subreq)
+{
+    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_as_state);
+
+    ret = state->handler.recv(state, subreq, &state->out.arg0);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = _sbus_ifp_invoker_write_as(state->write_iterator, &state->out);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
+struct _sbus_ifp_invoke_in_s_out_o_state {
+    struct _sbus_ifp_invoker_args_s in;
+    struct _sbus_ifp_invoker_args_o out;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_ifp_invoke_in_s_out_o_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_ifp_invoke_in_s_out_o_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_s_out_ao_send
+_sbus_ifp_invoke_in_s_out_o_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -1420,12 +2100,12 @@ _sbus_ifp_invoke_in_s_out_ao_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_s_out_o_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_ao_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_o_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -1441,25 +2121,19 @@ _sbus_ifp_invoke_in_s_out_ao_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_ao_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_o_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1479,19 +2153,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_s_out_ao_step
+static void _sbus_ifp_invoke_in_s_out_o_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_s_out_o_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_ao_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_o_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -1501,12 +2175,12 @@ static void _sbus_ifp_invoke_in_s_out_ao_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+        ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -1515,14 +2189,14 @@ static void _sbus_ifp_invoke_in_s_out_ao_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_ao_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_o_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -1537,14 +2211,14 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_s_out_ao_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_s_out_o_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_s_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_s_out_o_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_ao_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_o_state);
 
     ret = state->handler.recv(state, subreq, &state->out.arg0);
     talloc_zfree(subreq);
@@ -1553,7 +2227,7 @@ static void _sbus_ifp_invoke_in_s_out_ao_done(struct tevent_req *subreq)
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+    ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
@@ -1563,15 +2237,15 @@ static void _sbus_ifp_invoke_in_s_out_ao_done(struct tevent_req *subreq)
     return;
 }
 
-struct _sbus_ifp_invoke_in_s_out_as_state {
-    struct _sbus_ifp_invoker_args_s *in;
-    struct _sbus_ifp_invoker_args_as out;
+struct _sbus_ifp_invoke_in_s_out_s_state {
+    struct _sbus_ifp_invoker_args_s in;
+    struct _sbus_ifp_invoker_args_s out;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char ***);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **);
         struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
-        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
     } handler;
 
     struct sbus_request *sbus_req;
@@ -1580,18 +2254,18 @@ struct _sbus_ifp_invoke_in_s_out_as_state {
 };
 
 static void
-_sbus_ifp_invoke_in_s_out_as_step
+_sbus_ifp_invoke_in_s_out_s_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_s_out_as_done
+_sbus_ifp_invoke_in_s_out_s_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_s_out_as_send
+_sbus_ifp_invoke_in_s_out_s_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -1601,12 +2275,12 @@ _sbus_ifp_invoke_in_s_out_as_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct _sbus_ifp_invoke_in_s_out_s_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_as_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_s_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -1622,25 +2296,19 @@ _sbus_ifp_invoke_in_s_out_as_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_as_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_s_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1660,19 +2328,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_s_out_as_step
+static void _sbus_ifp_invoke_in_s_out_s_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct _sbus_ifp_invoke_in_s_out_s_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_as_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_s_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -1682,12 +2350,12 @@ static void _sbus_ifp_invoke_in_s_out_as_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_as(state->write_iterator, &state->out);
+        ret = _sbus_ifp_invoker_write_s(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -1696,14 +2364,14 @@ static void _sbus_ifp_invoke_in_s_out_as_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_as_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_s_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -1718,14 +2386,14 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_s_out_as_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_s_out_s_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_s_out_as_state *state;
+    struct _sbus_ifp_invoke_in_s_out_s_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_as_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_s_state);
 
     ret = state->handler.recv(state, subreq, &state->out.arg0);
     talloc_zfree(subreq);
@@ -1734,7 +2402,7 @@ static void _sbus_ifp_invoke_in_s_out_as_done(struct tevent_req *subreq)
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_as(state->write_iterator, &state->out);
+    ret = _sbus_ifp_invoker_write_s(state->write_iterator, &state->out);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
@@ -1744,15 +2412,14 @@ static void _sbus_ifp_invoke_in_s_out_as_done(struct tevent_req *subreq)
     return;
 }
 
-struct _sbus_ifp_invoke_in_s_out_o_state {
-    struct _sbus_ifp_invoker_args_s *in;
-    struct _sbus_ifp_invoker_args_o out;
+struct _sbus_ifp_invoke_in_sas_out_raw_state {
+    struct _sbus_ifp_invoker_args_sas in;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **);
-        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
-        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **, DBusMessageIter *);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char **, DBusMessageIter *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *);
     } handler;
 
     struct sbus_request *sbus_req;
@@ -1761,18 +2428,18 @@ struct _sbus_ifp_invoke_in_s_out_o_state {
 };
 
 static void
-_sbus_ifp_invoke_in_s_out_o_step
+_sbus_ifp_invoke_in_sas_out_raw_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_s_out_o_done
+_sbus_ifp_invoke_in_sas_out_raw_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_s_out_o_send
+_sbus_ifp_invoke_in_sas_out_raw_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -1782,12 +2449,12 @@ _sbus_ifp_invoke_in_s_out_o_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_s_out_o_state *state;
+    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_o_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_sas_out_raw_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -1803,25 +2470,17 @@ _sbus_ifp_invoke_in_s_out_o_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_s(state, read_iterator, state->in);
+    ret = _sbus_ifp_invoker_read_sas(state, read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_o_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_sas_out_raw_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1841,19 +2500,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_s_out_o_step
+static void _sbus_ifp_invoke_in_sas_out_raw_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_s_out_o_state *state;
+    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_o_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sas_out_raw_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -1863,12 +2522,11 @@ static void _sbus_ifp_invoke_in_s_out_o_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -1877,14 +2535,14 @@ static void _sbus_ifp_invoke_in_s_out_o_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_o_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_sas_out_raw_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -1899,40 +2557,34 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_s_out_o_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_sas_out_raw_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_s_out_o_state *state;
+    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_o_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sas_out_raw_state);
 
-    ret = state->handler.recv(state, subreq, &state->out.arg0);
+    ret = state->handler.recv(state, subreq);
     talloc_zfree(subreq);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
-    if (ret != EOK) {
-        tevent_req_error(req, ret);
-        return;
-    }
-
     tevent_req_done(req);
     return;
 }
 
-struct _sbus_ifp_invoke_in_s_out_s_state {
-    struct _sbus_ifp_invoker_args_s *in;
-    struct _sbus_ifp_invoker_args_s out;
+struct _sbus_ifp_invoke_in_ss_out_o_state {
+    struct _sbus_ifp_invoker_args_ss in;
+    struct _sbus_ifp_invoker_args_o out;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **);
-        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, const char **);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char *);
         errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
     } handler;
 
@@ -1942,18 +2594,18 @@ struct _sbus_ifp_invoke_in_s_out_s_state {
 };
 
 static void
-_sbus_ifp_invoke_in_s_out_s_step
+_sbus_ifp_invoke_in_ss_out_o_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_s_out_s_done
+_sbus_ifp_invoke_in_ss_out_o_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_s_out_s_send
+_sbus_ifp_invoke_in_ss_out_o_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -1963,12 +2615,12 @@ _sbus_ifp_invoke_in_s_out_s_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_s_out_s_state *state;
+    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_s_out_s_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_ss_out_o_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -1984,25 +2636,19 @@ _sbus_ifp_invoke_in_s_out_s_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_ss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_s_out_s_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_ss_out_o_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2022,19 +2668,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_s_out_s_step
+static void _sbus_ifp_invoke_in_ss_out_o_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_s_out_s_state *state;
+    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_s_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ss_out_o_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -2044,12 +2690,12 @@ static void _sbus_ifp_invoke_in_s_out_s_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_s(state->write_iterator, &state->out);
+        ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -2058,14 +2704,14 @@ static void _sbus_ifp_invoke_in_s_out_s_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_s_out_s_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_ss_out_o_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -2080,14 +2726,14 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_s_out_s_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_ss_out_o_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_s_out_s_state *state;
+    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_s_out_s_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ss_out_o_state);
 
     ret = state->handler.recv(state, subreq, &state->out.arg0);
     talloc_zfree(subreq);
@@ -2096,7 +2742,7 @@ static void _sbus_ifp_invoke_in_s_out_s_done(struct tevent_req *subreq)
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_s(state->write_iterator, &state->out);
+    ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
@@ -2106,14 +2752,15 @@ static void _sbus_ifp_invoke_in_s_out_s_done(struct tevent_req *subreq)
     return;
 }
 
-struct _sbus_ifp_invoke_in_sas_out_raw_state {
-    struct _sbus_ifp_invoker_args_sas *in;
+struct _sbus_ifp_invoke_in_sssu_out_aos_state {
+    struct _sbus_ifp_invoker_args_sssu in;
+    struct _sbus_ifp_invoker_args_aos out;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char **, DBusMessageIter *);
-        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char **, DBusMessageIter *);
-        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, const char *, uint32_t, const char ***, const char **);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char *, const char *, uint32_t);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***, const char **);
     } handler;
 
     struct sbus_request *sbus_req;
@@ -2122,18 +2769,18 @@ struct _sbus_ifp_invoke_in_sas_out_raw_state {
 };
 
 static void
-_sbus_ifp_invoke_in_sas_out_raw_step
+_sbus_ifp_invoke_in_sssu_out_aos_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_sas_out_raw_done
+_sbus_ifp_invoke_in_sssu_out_aos_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_sas_out_raw_send
+_sbus_ifp_invoke_in_sssu_out_aos_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -2143,12 +2790,12 @@ _sbus_ifp_invoke_in_sas_out_raw_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
+    struct _sbus_ifp_invoke_in_sssu_out_aos_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_sas_out_raw_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_sssu_out_aos_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -2164,25 +2811,19 @@ _sbus_ifp_invoke_in_sas_out_raw_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_sas);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_sas(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_sssu(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_sas_out_raw_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_sssu_out_aos_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2202,19 +2843,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_sas_out_raw_step
+static void _sbus_ifp_invoke_in_sssu_out_aos_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
+    struct _sbus_ifp_invoke_in_sssu_out_aos_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sas_out_raw_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sssu_out_aos_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -2224,11 +2865,12 @@ static void _sbus_ifp_invoke_in_sas_out_raw_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->write_iterator);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3, &state->out.arg0, &state->out.arg1);
         if (ret != EOK) {
             goto done;
         }
 
+        ret = _sbus_ifp_invoker_write_aos(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -2237,14 +2879,14 @@ static void _sbus_ifp_invoke_in_sas_out_raw_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->write_iterator);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_sas_out_raw_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_sssu_out_aos_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -2259,35 +2901,41 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_sas_out_raw_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_sssu_out_aos_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_sas_out_raw_state *state;
+    struct _sbus_ifp_invoke_in_sssu_out_aos_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sas_out_raw_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_sssu_out_aos_state);
 
-    ret = state->handler.recv(state, subreq);
+    ret = state->handler.recv(state, subreq, &state->out.arg0, &state->out.arg1);
     talloc_zfree(subreq);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
     }
 
+    ret = _sbus_ifp_invoker_write_aos(state->write_iterator, &state->out);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
     tevent_req_done(req);
     return;
 }
 
-struct _sbus_ifp_invoke_in_ss_out_o_state {
-    struct _sbus_ifp_invoker_args_ss *in;
-    struct _sbus_ifp_invoker_args_o out;
+struct _sbus_ifp_invoke_in_ssu_out_ao_state {
+    struct _sbus_ifp_invoker_args_ssu in;
+    struct _sbus_ifp_invoker_args_ao out;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, const char **);
-        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char *);
-        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, uint32_t, const char ***);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char *, uint32_t);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***);
     } handler;
 
     struct sbus_request *sbus_req;
@@ -2296,18 +2944,18 @@ struct _sbus_ifp_invoke_in_ss_out_o_state {
 };
 
 static void
-_sbus_ifp_invoke_in_ss_out_o_step
+_sbus_ifp_invoke_in_ssu_out_ao_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_ss_out_o_done
+_sbus_ifp_invoke_in_ssu_out_ao_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_ss_out_o_send
+_sbus_ifp_invoke_in_ssu_out_ao_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -2317,12 +2965,12 @@ _sbus_ifp_invoke_in_ss_out_o_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_ss_out_o_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -2338,25 +2986,19 @@ _sbus_ifp_invoke_in_ss_out_o_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_ss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_ss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_ssu(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_ss_out_o_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_ssu_out_ao_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2376,19 +3018,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_ss_out_o_step
+static void _sbus_ifp_invoke_in_ssu_out_ao_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ss_out_o_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -2398,12 +3040,12 @@ static void _sbus_ifp_invoke_in_ss_out_o_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
+        ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -2412,14 +3054,14 @@ static void _sbus_ifp_invoke_in_ss_out_o_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_ss_out_o_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_ssu_out_ao_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -2434,14 +3076,14 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_ss_out_o_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_ssu_out_ao_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_ss_out_o_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ss_out_o_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
 
     ret = state->handler.recv(state, subreq, &state->out.arg0);
     talloc_zfree(subreq);
@@ -2450,7 +3092,7 @@ static void _sbus_ifp_invoke_in_ss_out_o_done(struct tevent_req *subreq)
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_o(state->write_iterator, &state->out);
+    ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
@@ -2460,15 +3102,15 @@ static void _sbus_ifp_invoke_in_ss_out_o_done(struct tevent_req *subreq)
     return;
 }
 
-struct _sbus_ifp_invoke_in_ssu_out_ao_state {
-    struct _sbus_ifp_invoker_args_ssu *in;
-    struct _sbus_ifp_invoker_args_ao out;
+struct _sbus_ifp_invoke_in_ssu_out_aos_state {
+    struct _sbus_ifp_invoker_args_ssu in;
+    struct _sbus_ifp_invoker_args_aos out;
     struct {
         enum sbus_handler_type type;
         void *data;
-        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, uint32_t, const char ***);
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char *, uint32_t, const char ***, const char **);
         struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *, const char *, uint32_t);
-        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***, const char **);
     } handler;
 
     struct sbus_request *sbus_req;
@@ -2477,18 +3119,18 @@ struct _sbus_ifp_invoke_in_ssu_out_ao_state {
 };
 
 static void
-_sbus_ifp_invoke_in_ssu_out_ao_step
+_sbus_ifp_invoke_in_ssu_out_aos_step
     (struct tevent_context *ev,
      struct tevent_timer *te,
      struct timeval tv,
      void *private_data);
 
 static void
-_sbus_ifp_invoke_in_ssu_out_ao_done
+_sbus_ifp_invoke_in_ssu_out_aos_done
    (struct tevent_req *subreq);
 
 struct tevent_req *
-_sbus_ifp_invoke_in_ssu_out_ao_send
+_sbus_ifp_invoke_in_ssu_out_aos_send
    (TALLOC_CTX *mem_ctx,
     struct tevent_context *ev,
     struct sbus_request *sbus_req,
@@ -2498,12 +3140,12 @@ _sbus_ifp_invoke_in_ssu_out_ao_send
     DBusMessageIter *write_iterator,
     const char **_key)
 {
-    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_aos_state *state;
     struct tevent_req *req;
     const char *key;
     errno_t ret;
 
-    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_ifp_invoke_in_ssu_out_aos_state);
     if (req == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return NULL;
@@ -2519,25 +3161,19 @@ _sbus_ifp_invoke_in_ssu_out_ao_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_ssu);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_ssu(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_ssu(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_ssu_out_ao_step, req);
+    ret = sbus_invoker_schedule(state, ev, _sbus_ifp_invoke_in_ssu_out_aos_step, req);
     if (ret != EOK) {
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2557,19 +3193,19 @@ done:
     return req;
 }
 
-static void _sbus_ifp_invoke_in_ssu_out_ao_step
+static void _sbus_ifp_invoke_in_ssu_out_aos_step
    (struct tevent_context *ev,
     struct tevent_timer *te,
     struct timeval tv,
     void *private_data)
 {
-    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_aos_state *state;
     struct tevent_req *subreq;
     struct tevent_req *req;
     errno_t ret;
 
     req = talloc_get_type(private_data, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_aos_state);
 
     switch (state->handler.type) {
     case SBUS_HANDLER_SYNC:
@@ -2579,12 +3215,12 @@ static void _sbus_ifp_invoke_in_ssu_out_ao_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, &state->out.arg0, &state->out.arg1);
         if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+        ret = _sbus_ifp_invoker_write_aos(state->write_iterator, &state->out);
         goto done;
     case SBUS_HANDLER_ASYNC:
         if (state->handler.send == NULL || state->handler.recv == NULL) {
@@ -2593,14 +3229,14 @@ static void _sbus_ifp_invoke_in_ssu_out_ao_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
             goto done;
         }
 
-        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_ssu_out_ao_done, req);
+        tevent_req_set_callback(subreq, _sbus_ifp_invoke_in_ssu_out_aos_done, req);
         ret = EAGAIN;
         goto done;
     }
@@ -2615,23 +3251,23 @@ done:
     }
 }
 
-static void _sbus_ifp_invoke_in_ssu_out_ao_done(struct tevent_req *subreq)
+static void _sbus_ifp_invoke_in_ssu_out_aos_done(struct tevent_req *subreq)
 {
-    struct _sbus_ifp_invoke_in_ssu_out_ao_state *state;
+    struct _sbus_ifp_invoke_in_ssu_out_aos_state *state;
     struct tevent_req *req;
     errno_t ret;
 
     req = tevent_req_callback_data(subreq, struct tevent_req);
-    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_ao_state);
+    state = tevent_req_data(req, struct _sbus_ifp_invoke_in_ssu_out_aos_state);
 
-    ret = state->handler.recv(state, subreq, &state->out.arg0);
+    ret = state->handler.recv(state, subreq, &state->out.arg0, &state->out.arg1);
     talloc_zfree(subreq);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
     }
 
-    ret = _sbus_ifp_invoker_write_ao(state->write_iterator, &state->out);
+    ret = _sbus_ifp_invoker_write_aos(state->write_iterator, &state->out);
     if (ret != EOK) {
         tevent_req_error(req, ret);
         return;
@@ -2642,7 +3278,7 @@ static void _sbus_ifp_invoke_in_ssu_out_ao_done(struct tevent_req *subreq)
 }
 
 struct _sbus_ifp_invoke_in_su_out_ao_state {
-    struct _sbus_ifp_invoker_args_su *in;
+    struct _sbus_ifp_invoker_args_su in;
     struct _sbus_ifp_invoker_args_ao out;
     struct {
         enum sbus_handler_type type;
@@ -2700,15 +3336,9 @@ _sbus_ifp_invoke_in_su_out_ao_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_su);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_su(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_su(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2718,7 +3348,7 @@ _sbus_ifp_invoke_in_su_out_ao_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2760,7 +3390,7 @@ static void _sbus_ifp_invoke_in_su_out_ao_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -2774,7 +3404,7 @@ static void _sbus_ifp_invoke_in_su_out_ao_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2823,7 +3453,7 @@ static void _sbus_ifp_invoke_in_su_out_ao_done(struct tevent_req *subreq)
 }
 
 struct _sbus_ifp_invoke_in_u_out_o_state {
-    struct _sbus_ifp_invoker_args_u *in;
+    struct _sbus_ifp_invoker_args_u in;
     struct _sbus_ifp_invoker_args_o out;
     struct {
         enum sbus_handler_type type;
@@ -2881,15 +3511,9 @@ _sbus_ifp_invoke_in_u_out_o_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_ifp_invoker_args_u);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_ifp_invoker_read_u(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_ifp_invoker_borrow_u(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2899,7 +3523,7 @@ _sbus_ifp_invoke_in_u_out_o_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2941,7 +3565,7 @@ static void _sbus_ifp_invoke_in_u_out_o_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -2955,7 +3579,7 @@ static void _sbus_ifp_invoke_in_u_out_o_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
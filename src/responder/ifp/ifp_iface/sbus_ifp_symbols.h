@@ -34,6 +34,9 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_FindMonitor;
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_FindResponderByName;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_GetMetrics;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_GetUserAttr;
 
@@ -91,9 +94,15 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByName;
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndName;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndNamePaged;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByName;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByNamePaged;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_Group_UpdateMemberList;
 
@@ -109,15 +118,27 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByName;
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByNameAndCertificate;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByIDList;
+
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrsByNameList;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByCertificate;
 
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByDomainAndName;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByDomainAndNamePaged;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByName;
 
+extern const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByNamePaged;
+
 extern const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_User_UpdateGroupsList;
 
@@ -33,6 +33,7 @@
 #include "confdb/confdb.h"
 #include "responder/common/responder.h"
 #include "responder/common/negcache.h"
+#include "responder/common/cache_req/cache_req.h"
 #include "responder/ifp/ifp_iface/ifp_iface_async.h"
 
 struct ifp_ctx {
@@ -87,6 +88,15 @@ ifp_user_get_groups_recv(TALLOC_CTX *mem_ctx,
 
 /* == Utility functions == */
 
+/* Write attributes of a user found by sysdb_get_user_attr_with_views() as
+ * a{sv}. An empty dictionary is written if @res is NULL or empty. */
+errno_t
+ifp_get_user_attr_write_reply(DBusMessageIter *iter,
+                              const char **attrs,
+                              struct resp_ctx *rctx,
+                              struct sss_domain_info *domain,
+                              struct ldb_result *res);
+
 errno_t ifp_add_value_to_dict(DBusMessageIter *iter_dict,
                               const char *key,
                               const char *value);
@@ -132,4 +142,31 @@ errno_t ifp_ldb_el_output_name(struct resp_ctx *rctx,
 char *ifp_format_name_attr(TALLOC_CTX *mem_ctx, struct ifp_ctx *ifp_ctx,
                            const char *in_name, struct sss_domain_info *dom);
 
+/* Used for paged list calls */
+typedef char *
+(*ifp_list_build_path_fn)(TALLOC_CTX *mem_ctx,
+                          struct sss_domain_info *domain,
+                          struct ldb_message *msg);
+
+/* List one page of objects matching @filter, ordered by domain and by name.
+ * Pass an empty @cursor to get the first page and the returned cursor to get
+ * the next one. An empty cursor is returned with the last page. If @domain
+ * is NULL all domains are listed. */
+struct tevent_req *
+ifp_list_paged_send(TALLOC_CTX *mem_ctx,
+                    struct tevent_context *ev,
+                    struct ifp_ctx *ctx,
+                    enum cache_req_type type,
+                    ifp_list_build_path_fn build_path,
+                    const char *domain,
+                    const char *filter,
+                    const char *cursor,
+                    uint32_t page_size);
+
+errno_t
+ifp_list_paged_recv(TALLOC_CTX *mem_ctx,
+                    struct tevent_req *req,
+                    const char ***_paths,
+                    const char **_next_cursor);
+
 #endif /* _IFPSRV_PRIVATE_H_ */
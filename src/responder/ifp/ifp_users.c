@@ -1029,6 +1029,455 @@ ifp_users_list_by_domain_and_name_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct tevent_req *
+ifp_users_list_by_name_paged_send(TALLOC_CTX *mem_ctx,
+                                  struct tevent_context *ev,
+                                  struct sbus_request *sbus_req,
+                                  struct ifp_ctx *ctx,
+                                  const char *filter,
+                                  const char *cursor,
+                                  uint32_t page_size)
+{
+    return ifp_list_paged_send(mem_ctx, ev, ctx, CACHE_REQ_USER_BY_FILTER,
+                               ifp_users_build_path_from_msg, NULL,
+                               filter, cursor, page_size);
+}
+
+errno_t
+ifp_users_list_by_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  const char ***_paths,
+                                  const char **_next_cursor)
+{
+    return ifp_list_paged_recv(mem_ctx, req, _paths, _next_cursor);
+}
+
+struct tevent_req *
+ifp_users_list_by_domain_and_name_paged_send(TALLOC_CTX *mem_ctx,
+                                             struct tevent_context *ev,
+                                             struct sbus_request *sbus_req,
+                                             struct ifp_ctx *ctx,
+                                             const char *domain,
+                                             const char *filter,
+                                             const char *cursor,
+                                             uint32_t page_size)
+{
+    return ifp_list_paged_send(mem_ctx, ev, ctx, CACHE_REQ_USER_BY_FILTER,
+                               ifp_users_build_path_from_msg, domain,
+                               filter, cursor, page_size);
+}
+
+errno_t
+ifp_users_list_by_domain_and_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                             struct tevent_req *req,
+                                             const char ***_paths,
+                                             const char **_next_cursor)
+{
+    return ifp_list_paged_recv(mem_ctx, req, _paths, _next_cursor);
+}
+
+/* Number of lookups of a single bulk request that are processed at the same
+ * time. The remaining ones are started as the previous ones finish so a long
+ * list does not flood the data provider. */
+#define IFP_USERS_BULK_PARALLEL 32
+
+struct ifp_users_get_attrs_item {
+    struct tevent_req *req;
+    struct cache_req_data *data;
+
+    struct sss_domain_info *domain;
+    struct ldb_result *res;
+};
+
+struct ifp_users_get_attrs_state {
+    struct tevent_context *ev;
+    struct ifp_ctx *ctx;
+    enum cache_req_type type;
+    const char **names;
+    uint32_t *ids;
+    const char **attrs;
+    DBusMessageIter *write_iter;
+
+    struct ifp_users_get_attrs_item *items;
+    size_t num_items;
+    size_t next;
+    size_t active;
+};
+
+static errno_t ifp_users_get_attrs_step(struct tevent_req *req);
+static void ifp_users_get_attrs_done(struct tevent_req *subreq);
+static errno_t
+ifp_users_get_attrs_write_reply(struct ifp_users_get_attrs_state *state);
+
+static const char **
+ifp_users_filter_attrs(TALLOC_CTX *mem_ctx,
+                       struct ifp_ctx *ctx,
+                       const char **attrs)
+{
+    const char **allowed;
+    size_t count;
+    size_t i;
+
+    for (count = 0; attrs != NULL && attrs[count] != NULL; count++) {
+        /* Just count the attributes. */
+    }
+
+    allowed = talloc_zero_array(mem_ctx, const char *, count + 1);
+    if (allowed == NULL) {
+        return NULL;
+    }
+
+    count = 0;
+    for (i = 0; attrs != NULL && attrs[i] != NULL; i++) {
+        if (!ifp_is_user_attr_allowed(ctx, attrs[i])) {
+            DEBUG(SSSDBG_TRACE_ALL, "Attribute %s is not allowed\n", attrs[i]);
+            continue;
+        }
+
+        allowed[count] = attrs[i];
+        count++;
+    }
+
+    return allowed;
+}
+
+static struct tevent_req *
+ifp_users_get_attrs_send(TALLOC_CTX *mem_ctx,
+                         struct tevent_context *ev,
+                         struct sbus_request *sbus_req,
+                         struct ifp_ctx *ctx,
+                         enum cache_req_type type,
+                         const char **names,
+                         uint32_t *ids,
+                         const char **attrs,
+                         DBusMessageIter *write_iter)
+{
+    struct ifp_users_get_attrs_state *state;
+    struct tevent_req *req;
+    size_t i;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct ifp_users_get_attrs_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->ctx = ctx;
+    state->type = type;
+    state->names = names;
+    state->ids = ids;
+    state->write_iter = write_iter;
+
+    state->attrs = ifp_users_filter_attrs(state, ctx, attrs);
+    if (state->attrs == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    switch (type) {
+    case CACHE_REQ_USER_BY_NAME:
+        for (i = 0; names != NULL && names[i] != NULL; i++) {
+            /* Just count the names. */
+        }
+        state->num_items = i;
+        break;
+    case CACHE_REQ_USER_BY_ID:
+        state->num_items = ids == NULL ? 0 : talloc_array_length(ids);
+        break;
+    default:
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unsupported search type [%d]!\n", type);
+        ret = ERR_INTERNAL;
+        goto done;
+    }
+
+    DEBUG(SSSDBG_FUNC_DATA,
+          "Looking up attributes of %zu users on behalf of %"PRIi64"\n",
+          state->num_items, sbus_req->sender->uid);
+
+    state->items = talloc_zero_array(state, struct ifp_users_get_attrs_item,
+                                     state->num_items);
+    if (state->items == NULL && state->num_items > 0) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < state->num_items; i++) {
+        state->items[i].req = req;
+    }
+
+    if (state->num_items == 0) {
+        ret = ifp_users_get_attrs_write_reply(state);
+        goto done;
+    }
+
+    ret = ifp_users_get_attrs_step(req);
+    if (ret == EOK) {
+        ret = EAGAIN;
+    }
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+        tevent_req_post(req, ev);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static errno_t ifp_users_get_attrs_step(struct tevent_req *req)
+{
+    struct ifp_users_get_attrs_state *state;
+    struct ifp_users_get_attrs_item *item;
+    struct tevent_req *subreq;
+
+    state = tevent_req_data(req, struct ifp_users_get_attrs_state);
+
+    while (state->active < IFP_USERS_BULK_PARALLEL
+            && state->next < state->num_items) {
+        item = &state->items[state->next];
+
+        /* Users found by name are read together with the requested
+         * attributes, users found by ID need a second lookup. */
+        if (state->type == CACHE_REQ_USER_BY_NAME) {
+            item->data = cache_req_data_name_attrs(state, state->type,
+                                                   state->names[state->next],
+                                                   state->attrs);
+        } else {
+            item->data = cache_req_data_id(state, state->type,
+                                           state->ids[state->next]);
+        }
+        if (item->data == NULL) {
+            return ENOMEM;
+        }
+
+        /* IFP serves both POSIX and application domains. Requests that need
+         * to differentiate between the two must be qualified
+         */
+        subreq = cache_req_send(state, state->ev, state->ctx->rctx,
+                                state->ctx->rctx->ncache, 0,
+                                CACHE_REQ_ANY_DOM, NULL, item->data);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, ifp_users_get_attrs_done, item);
+
+        state->next++;
+        state->active++;
+    }
+
+    return EOK;
+}
+
+static errno_t
+ifp_users_get_attrs_item_done(struct ifp_users_get_attrs_state *state,
+                              struct ifp_users_get_attrs_item *item,
+                              struct cache_req_result *result)
+{
+    const char *fqdn;
+    errno_t ret;
+
+    item->domain = result->domain;
+
+    if (state->type == CACHE_REQ_USER_BY_NAME) {
+        item->res = talloc_steal(state->items, result->ldb_result);
+        return EOK;
+    }
+
+    fqdn = ldb_msg_find_attr_as_string(result->ldb_result->msgs[0],
+                                       SYSDB_NAME, NULL);
+    if (fqdn == NULL) {
+        return ERR_INTERNAL;
+    }
+
+    ret = sysdb_get_user_attr_with_views(state->items, item->domain, fqdn,
+                                         state->attrs, &item->res);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sysdb_get_user_attr_with_views() "
+              "failed [%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (item->res->count != 1) {
+        talloc_zfree(item->res);
+        return ENOENT;
+    }
+
+    return EOK;
+}
+
+static void ifp_users_get_attrs_done(struct tevent_req *subreq)
+{
+    struct ifp_users_get_attrs_state *state;
+    struct ifp_users_get_attrs_item *item;
+    struct cache_req_result *result;
+    struct tevent_req *req;
+    errno_t ret;
+
+    item = tevent_req_callback_data(subreq, struct ifp_users_get_attrs_item);
+    req = item->req;
+    state = tevent_req_data(req, struct ifp_users_get_attrs_state);
+
+    ret = cache_req_single_domain_recv(state, subreq, &result);
+    talloc_zfree(subreq);
+    talloc_zfree(item->data);
+    state->active--;
+
+    if (ret == EOK) {
+        ret = ifp_users_get_attrs_item_done(state, item, result);
+        talloc_zfree(result);
+    }
+
+    switch (ret) {
+    case EOK:
+        break;
+    case ENOENT:
+    case ERR_ID_OUTSIDE_RANGE:
+    case ERR_DOMAIN_NOT_FOUND:
+    case ERR_INVALID_FQN:
+        /* A missing user or an unusable name does not fail the whole
+         * request, it is represented by an empty dictionary in the
+         * reply. */
+        DEBUG(SSSDBG_TRACE_FUNC, "Unable to find user [%d]: %s\n",
+              ret, sss_strerror(ret));
+        item->domain = NULL;
+        item->res = NULL;
+        break;
+    default:
+        /* Any other error would be indistinguishable from a missing user
+         * in the reply, fail the whole request instead. */
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to look up user [%d]: %s\n",
+              ret, sss_strerror(ret));
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    if (state->next < state->num_items) {
+        ret = ifp_users_get_attrs_step(req);
+        if (ret != EOK) {
+            tevent_req_error(req, ret);
+        }
+        return;
+    }
+
+    if (state->active > 0) {
+        return;
+    }
+
+    ret = ifp_users_get_attrs_write_reply(state);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to construct reply [%d]: %s\n",
+              ret, sss_strerror(ret));
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static errno_t
+ifp_users_get_attrs_write_reply(struct ifp_users_get_attrs_state *state)
+{
+    DBusMessageIter iter_array;
+    dbus_bool_t dbret;
+    errno_t ret;
+    size_t i;
+
+    dbret = dbus_message_iter_open_container(state->write_iter,
+                                      DBUS_TYPE_ARRAY,
+                                      DBUS_TYPE_ARRAY_AS_STRING
+                                      DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                      DBUS_TYPE_STRING_AS_STRING
+                                      DBUS_TYPE_VARIANT_AS_STRING
+                                      DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                      &iter_array);
+    if (!dbret) {
+        return EIO;
+    }
+
+    /* One dictionary per requested user, in the order of the request. */
+    for (i = 0; i < state->num_items; i++) {
+        ret = ifp_get_user_attr_write_reply(&iter_array, state->attrs,
+                                            state->ctx->rctx,
+                                            state->items[i].domain,
+                                            state->items[i].res);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    dbret = dbus_message_iter_close_container(state->write_iter, &iter_array);
+    if (!dbret) {
+        ret = EIO;
+        goto done;
+    }
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        dbus_message_iter_abandon_container(state->write_iter, &iter_array);
+    }
+
+    return ret;
+}
+
+static errno_t
+ifp_users_get_attrs_recv(TALLOC_CTX *mem_ctx, struct tevent_req *req)
+{
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    return EOK;
+}
+
+struct tevent_req *
+ifp_users_get_attrs_by_name_list_send(TALLOC_CTX *mem_ctx,
+                                      struct tevent_context *ev,
+                                      struct sbus_request *sbus_req,
+                                      struct ifp_ctx *ctx,
+                                      const char **names,
+                                      const char **attrs,
+                                      DBusMessageIter *write_iter)
+{
+    return ifp_users_get_attrs_send(mem_ctx, ev, sbus_req, ctx,
+                                    CACHE_REQ_USER_BY_NAME, names, NULL,
+                                    attrs, write_iter);
+}
+
+errno_t
+ifp_users_get_attrs_by_name_list_recv(TALLOC_CTX *mem_ctx,
+                                      struct tevent_req *req)
+{
+    return ifp_users_get_attrs_recv(mem_ctx, req);
+}
+
+struct tevent_req *
+ifp_users_get_attrs_by_id_list_send(TALLOC_CTX *mem_ctx,
+                                    struct tevent_context *ev,
+                                    struct sbus_request *sbus_req,
+                                    struct ifp_ctx *ctx,
+                                    uint32_t *ids,
+                                    const char **attrs,
+                                    DBusMessageIter *write_iter)
+{
+    return ifp_users_get_attrs_send(mem_ctx, ev, sbus_req, ctx,
+                                    CACHE_REQ_USER_BY_ID, NULL, ids,
+                                    attrs, write_iter);
+}
+
+errno_t
+ifp_users_get_attrs_by_id_list_recv(TALLOC_CTX *mem_ctx,
+                                    struct tevent_req *req)
+{
+    return ifp_users_get_attrs_recv(mem_ctx, req);
+}
+
 static errno_t
 ifp_users_get_from_cache(TALLOC_CTX *mem_ctx,
                          struct sss_domain_info *domain,
@@ -120,6 +120,63 @@ ifp_users_list_by_domain_and_name_recv(TALLOC_CTX *mem_ctx,
                                        struct tevent_req *req,
                                        const char ***_paths);
 
+struct tevent_req *
+ifp_users_list_by_name_paged_send(TALLOC_CTX *mem_ctx,
+                                  struct tevent_context *ev,
+                                  struct sbus_request *sbus_req,
+                                  struct ifp_ctx *ctx,
+                                  const char *filter,
+                                  const char *cursor,
+                                  uint32_t page_size);
+
+errno_t
+ifp_users_list_by_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  const char ***_paths,
+                                  const char **_next_cursor);
+
+struct tevent_req *
+ifp_users_list_by_domain_and_name_paged_send(TALLOC_CTX *mem_ctx,
+                                             struct tevent_context *ev,
+                                             struct sbus_request *sbus_req,
+                                             struct ifp_ctx *ctx,
+                                             const char *domain,
+                                             const char *filter,
+                                             const char *cursor,
+                                             uint32_t page_size);
+
+errno_t
+ifp_users_list_by_domain_and_name_paged_recv(TALLOC_CTX *mem_ctx,
+                                             struct tevent_req *req,
+                                             const char ***_paths,
+                                             const char **_next_cursor);
+
+struct tevent_req *
+ifp_users_get_attrs_by_name_list_send(TALLOC_CTX *mem_ctx,
+                                      struct tevent_context *ev,
+                                      struct sbus_request *sbus_req,
+                                      struct ifp_ctx *ctx,
+                                      const char **names,
+                                      const char **attrs,
+                                      DBusMessageIter *write_iter);
+
+errno_t
+ifp_users_get_attrs_by_name_list_recv(TALLOC_CTX *mem_ctx,
+                                      struct tevent_req *req);
+
+struct tevent_req *
+ifp_users_get_attrs_by_id_list_send(TALLOC_CTX *mem_ctx,
+                                    struct tevent_context *ev,
+                                    struct sbus_request *sbus_req,
+                                    struct ifp_ctx *ctx,
+                                    uint32_t *ids,
+                                    const char **attrs,
+                                    DBusMessageIter *write_iter);
+
+errno_t
+ifp_users_get_attrs_by_id_list_recv(TALLOC_CTX *mem_ctx,
+                                    struct tevent_req *req);
+
 /* org.freedesktop.sssd.infopipe.Users.User */
 
 struct tevent_req *
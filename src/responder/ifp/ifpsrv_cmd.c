@@ -182,7 +182,7 @@ ifp_user_get_attr_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
-static errno_t
+errno_t
 ifp_get_user_attr_write_reply(DBusMessageIter *iter,
                               const char **attrs,
                               struct resp_ctx *rctx,
@@ -205,7 +205,7 @@ ifp_get_user_attr_write_reply(DBusMessageIter *iter,
         return EIO;
     }
 
-    if (res->count > 0) {
+    if (res != NULL && res->count > 0) {
         ret = ifp_ldb_el_output_name(rctx, res->msgs[0], SYSDB_NAME, domain);
         if (ret != EOK) {
             DEBUG(SSSDBG_CRIT_FAILURE,
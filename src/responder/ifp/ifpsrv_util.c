@@ -24,6 +24,8 @@
 #include <sys/param.h>
 
 #include "db/sysdb.h"
+#include "util/strtonum.h"
+#include "responder/common/cache_req/cache_req.h"
 #include "responder/ifp/ifp_private.h"
 
 #define IFP_USER_DEFAULT_ATTRS {SYSDB_NAME, SYSDB_UIDNUM,   \
@@ -451,3 +453,418 @@ done:
     talloc_free(tmp_ctx);
     return ret_name;
 }
+
+/* Paged listing. The first page of each domain refreshes the matching
+ * entries with a cache_req lookup, the following pages are read from the
+ * cache only. Entries of a domain are ordered by their internal name.
+ *
+ * The cursor is "<refresh time>:<internal name of the last entry>". The name
+ * identifies the domain and the position in it, the time tells which cached
+ * entries were returned by the refresh, so no state is kept between pages. */
+struct ifp_list_paged_state {
+    struct ifp_ctx *ctx;
+    enum cache_req_type type;
+    ifp_list_build_path_fn build_path;
+    bool single_domain;
+    const char *filter;
+    const char *cursor;
+    time_t refresh_time;
+
+    struct sss_domain_info *dom;
+    struct ifp_list_ctx *list_ctx;
+    const char *next_cursor;
+};
+
+static errno_t ifp_list_paged_step(struct tevent_req *req);
+static void ifp_list_paged_done(struct tevent_req *subreq);
+
+static errno_t
+ifp_list_paged_parse_cursor(struct ifp_list_paged_state *state,
+                            const char *domain)
+{
+    struct sss_domain_info *dom;
+    char *domname = NULL;
+    char *endptr;
+    errno_t ret;
+
+    if (domain != NULL) {
+        dom = find_domain_by_name(state->ctx->rctx->domains, domain, true);
+        if (dom == NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unknown domain %s\n", domain);
+            return ERR_DOMAIN_NOT_FOUND;
+        }
+    } else {
+        dom = state->ctx->rctx->domains;
+    }
+
+    if (state->cursor == NULL || state->cursor[0] == '\0') {
+        state->cursor = NULL;
+        state->dom = dom;
+        return EOK;
+    }
+
+    errno = 0;
+    state->refresh_time = strtouint32(state->cursor, &endptr, 10);
+    if (errno != 0 || endptr == state->cursor || *endptr != ':') {
+        DEBUG(SSSDBG_OP_FAILURE, "Invalid cursor %s\n", state->cursor);
+        return EINVAL;
+    }
+    state->cursor = endptr + 1;
+
+    ret = sss_parse_internal_fqname(state, state->cursor, NULL, &domname);
+    if (ret != EOK || domname == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Invalid cursor %s\n", state->cursor);
+        return EINVAL;
+    }
+
+    state->dom = find_domain_by_name(state->ctx->rctx->domains, domname, true);
+    talloc_free(domname);
+    if (state->dom == NULL
+            || (state->single_domain && state->dom != dom)) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cursor %s does not belong to the listed "
+              "domains\n", state->cursor);
+        return EINVAL;
+    }
+
+    return EOK;
+}
+
+struct tevent_req *
+ifp_list_paged_send(TALLOC_CTX *mem_ctx,
+                    struct tevent_context *ev,
+                    struct ifp_ctx *ctx,
+                    enum cache_req_type type,
+                    ifp_list_build_path_fn build_path,
+                    const char *domain,
+                    const char *filter,
+                    const char *cursor,
+                    uint32_t page_size)
+{
+    struct ifp_list_paged_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct ifp_list_paged_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->ctx = ctx;
+    state->type = type;
+    state->build_path = build_path;
+    state->single_domain = domain != NULL;
+    state->filter = filter;
+    state->cursor = cursor;
+
+    state->list_ctx = ifp_list_ctx_new(state, ctx, filter, page_size);
+    if (state->list_ctx == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = ifp_list_paged_parse_cursor(state, domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = ifp_list_paged_step(req);
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+        tevent_req_post(req, ev);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static int ifp_list_paged_cmp(const void *a, const void *b)
+{
+    struct ldb_message *msg_a = *(struct ldb_message * const *)a;
+    struct ldb_message *msg_b = *(struct ldb_message * const *)b;
+
+    return strcmp(ldb_msg_find_attr_as_string(msg_a, SYSDB_NAME, ""),
+                  ldb_msg_find_attr_as_string(msg_b, SYSDB_NAME, ""));
+}
+
+/* Sets _full if the page was filled before the end of the result. */
+static errno_t
+ifp_list_paged_copy(struct ifp_list_paged_state *state,
+                    struct sss_domain_info *domain,
+                    struct ldb_result *result,
+                    bool *_full)
+{
+    struct ifp_list_ctx *list_ctx = state->list_ctx;
+    const char *name;
+    size_t capacity;
+    size_t count;
+    size_t i;
+
+    *_full = false;
+
+    /* Drop entries that were already returned on previous pages, so that
+     * only the rest of the domain is sorted. */
+    count = 0;
+    for (i = 0; i < result->count; i++) {
+        name = ldb_msg_find_attr_as_string(result->msgs[i], SYSDB_NAME, "");
+        if (state->cursor == NULL || strcmp(name, state->cursor) > 0) {
+            result->msgs[count] = result->msgs[i];
+            count++;
+        }
+    }
+    result->count = count;
+
+    qsort(result->msgs, result->count, sizeof(struct ldb_message *),
+          ifp_list_paged_cmp);
+
+    if (list_ctx->limit != 0) {
+        capacity = list_ctx->limit - list_ctx->path_count;
+        if (count >= capacity) {
+            count = capacity;
+            *_full = true;
+        }
+    }
+
+    if (count == 0) {
+        return EOK;
+    }
+
+    list_ctx->paths_max = list_ctx->path_count + count;
+    list_ctx->paths = talloc_realloc(list_ctx, list_ctx->paths, const char *,
+                                     list_ctx->paths_max + 1);
+    if (list_ctx->paths == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "talloc_realloc() failed\n");
+        return ENOMEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        list_ctx->paths[list_ctx->path_count] = \
+                        state->build_path(list_ctx->paths, domain,
+                                          result->msgs[i]);
+        if (list_ctx->paths[list_ctx->path_count] == NULL) {
+            return ENOMEM;
+        }
+        list_ctx->path_count++;
+    }
+    list_ctx->paths[list_ctx->path_count] = NULL;
+
+    if (*_full) {
+        name = ldb_msg_find_attr_as_string(result->msgs[count - 1],
+                                           SYSDB_NAME, NULL);
+        if (name == NULL) {
+            return ERR_INTERNAL;
+        }
+
+        state->next_cursor = talloc_asprintf(state, "%lld:%s",
+                                             (long long)state->refresh_time,
+                                             name);
+        if (state->next_cursor == NULL) {
+            return ENOMEM;
+        }
+    }
+
+    return EOK;
+}
+
+/* Reads the entries that were refreshed together with the cursor from the
+ * cache, the same way the cache_req filter plugins do. */
+static errno_t
+ifp_list_paged_read_cache(struct ifp_list_paged_state *state,
+                          bool *_full)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_result *result;
+    const char *name;
+    char *recent_filter;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    name = sss_get_cased_name(tmp_ctx, state->filter,
+                              state->dom->case_sensitive);
+    if (name == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    name = sss_reverse_replace_space(tmp_ctx, name,
+                                     state->ctx->rctx->override_space);
+    if (name == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    recent_filter = talloc_asprintf(tmp_ctx, "(%s>=%lld)", SYSDB_LAST_UPDATE,
+                                    (long long)state->refresh_time);
+    if (recent_filter == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    switch (state->type) {
+    case CACHE_REQ_USER_BY_FILTER:
+        ret = sysdb_enumpwent_filter_with_views(tmp_ctx, state->dom, name,
+                                                recent_filter, &result);
+        break;
+    case CACHE_REQ_GROUP_BY_FILTER:
+        ret = sysdb_enumgrent_filter_with_views(tmp_ctx, state->dom, name,
+                                                recent_filter, &result);
+        break;
+    default:
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unsupported search type [%d]!\n",
+              state->type);
+        ret = ERR_INTERNAL;
+        goto done;
+    }
+    if (ret == ENOENT) {
+        *_full = false;
+        ret = EOK;
+        goto done;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to read cached objects [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    ret = ifp_list_paged_copy(state, state->dom, result, _full);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static void ifp_list_paged_next_domain(struct ifp_list_paged_state *state)
+{
+    /* The following domains are listed from their beginning. */
+    state->cursor = NULL;
+    if (state->single_domain) {
+        state->dom = NULL;
+    } else {
+        state->dom = get_next_domain(state->dom, SSS_GND_DESCEND);
+    }
+}
+
+static errno_t ifp_list_paged_step(struct tevent_req *req)
+{
+    struct ifp_list_paged_state *state;
+    struct cache_req_data *data;
+    struct tevent_req *subreq;
+    bool full;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct ifp_list_paged_state);
+
+    /* Continue in the domain of the cursor without contacting the data
+     * provider, the entries were refreshed by the first page. */
+    while (state->dom != NULL && state->cursor != NULL) {
+        ret = ifp_list_paged_read_cache(state, &full);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        if (full) {
+            return EOK;
+        }
+
+        ifp_list_paged_next_domain(state);
+    }
+
+    if (state->dom == NULL) {
+        return EOK;
+    }
+
+    data = cache_req_data_name(state, state->type, state->filter);
+    if (data == NULL) {
+        return ENOMEM;
+    }
+
+    /* cache_req returns only entries updated since the request started. */
+    state->refresh_time = time(NULL);
+
+    subreq = cache_req_send(state, state->ctx->rctx->ev, state->ctx->rctx,
+                            state->ctx->rctx->ncache, 0, CACHE_REQ_ANY_DOM,
+                            state->dom->name, data);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+        return ENOMEM;
+    }
+
+    talloc_steal(subreq, data);
+    tevent_req_set_callback(subreq, ifp_list_paged_done, req);
+
+    return EAGAIN;
+}
+
+static void ifp_list_paged_done(struct tevent_req *subreq)
+{
+    struct ifp_list_paged_state *state;
+    struct cache_req_result *result;
+    struct tevent_req *req;
+    bool full = false;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct ifp_list_paged_state);
+
+    ret = cache_req_single_domain_recv(state, subreq, &result);
+    talloc_zfree(subreq);
+    if (ret == EOK) {
+        ret = ifp_list_paged_copy(state, result->domain, result->ldb_result,
+                                  &full);
+        talloc_zfree(result);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Failed to copy domain result\n");
+            tevent_req_error(req, ret);
+            return;
+        }
+    } else if (ret != ENOENT) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to list objects [%d]: %s\n",
+              ret, sss_strerror(ret));
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    if (full) {
+        tevent_req_done(req);
+        return;
+    }
+
+    ifp_list_paged_next_domain(state);
+
+    ret = ifp_list_paged_step(req);
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+errno_t
+ifp_list_paged_recv(TALLOC_CTX *mem_ctx,
+                    struct tevent_req *req,
+                    const char ***_paths,
+                    const char **_next_cursor)
+{
+    struct ifp_list_paged_state *state;
+    state = tevent_req_data(req, struct ifp_list_paged_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_paths = talloc_steal(mem_ctx, state->list_ctx->paths);
+
+    /* An empty cursor tells the caller that this was the last page. */
+    if (state->next_cursor == NULL) {
+        *_next_cursor = "";
+    } else {
+        *_next_cursor = talloc_steal(mem_ctx, state->next_cursor);
+    }
+
+    return EOK;
+}
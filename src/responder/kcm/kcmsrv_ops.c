@@ -28,6 +28,7 @@
 #include "util/sss_krb5.h"
 #include "util/sss_ptr_hash.h"
 #include "util/util_creds.h"
+#include "util/probes.h"
 #include "responder/kcm/kcmsrv_pvt.h"
 #include "responder/kcm/kcmsrv_ops.h"
 #include "responder/kcm/kcmsrv_ccache.h"
@@ -111,6 +112,7 @@ struct tevent_req *kcm_cmd_send(TALLOC_CTX *mem_ctx,
     }
 
     DEBUG(SSSDBG_TRACE_FUNC, "KCM operation %s\n", op->name);
+    PROBE(KCM_CMD_SEND, op->name);
     DEBUG(SSSDBG_TRACE_LIBS, "%zu bytes on KCM input\n", input->length);
 
     state->reply = sss_iobuf_init_empty(state,
@@ -218,6 +220,7 @@ static void kcm_cmd_done(struct tevent_req *subreq)
         DEBUG(SSSDBG_OP_FAILURE,
               "op receive function failed [%d]: %s\n",
               ret, sss_strerror(ret));
+        PROBE(KCM_CMD_DONE, kcm_opt_name(state->op), ret, state->op_ret);
         tevent_req_error(req, ret);
         return;
     }
@@ -225,6 +228,7 @@ static void kcm_cmd_done(struct tevent_req *subreq)
     DEBUG(SSSDBG_TRACE_FUNC,
           "KCM operation %s returned [%d]: %s\n",
           kcm_opt_name(state->op), state->op_ret, sss_strerror(state->op_ret));
+    PROBE(KCM_CMD_DONE, kcm_opt_name(state->op), ret, state->op_ret);
 
     kerr = sss2krb5_error(state->op_ret);
 
@@ -754,23 +754,35 @@ static void nss_getent_done(struct tevent_req *subreq)
         goto done;
     }
 
-    result = nss_getent_get_result(cmd_ctx->enum_ctx, cmd_ctx->enum_index);
-    if (result == NULL) {
-        /* No more records to return. */
-        ret = ENOENT;
-        goto done;
-    }
+    do {
+        result = nss_getent_get_result(cmd_ctx->enum_ctx,
+                                       cmd_ctx->enum_index);
+        if (result == NULL) {
+            /* No more records to return. */
+            ret = ENOENT;
+            goto done;
+        }
 
-    /* Create copy of the result with limited number of records. */
-    limited = cache_req_copy_limited_result(cmd_ctx, result,
-                                            cmd_ctx->enum_index->result,
-                                            cmd_ctx->enum_limit);
-    if (limited == NULL) {
-        ret = ERR_INTERNAL;
-        goto done;
-    }
+        /* Create copy of the result with limited number of records. */
+        limited = cache_req_copy_limited_result(cmd_ctx, result,
+                                                cmd_ctx->enum_index->result,
+                                                cmd_ctx->enum_limit);
+        if (limited == NULL) {
+            ret = ERR_INTERNAL;
+            goto done;
+        }
 
-    cmd_ctx->enum_index->result += result->count;
+        cmd_ctx->enum_index->result += limited->count;
+
+        /* Only this chunk of the enumeration is read in full. The records
+         * may have been removed in the meantime, continue with the next
+         * chunk if none of them is left. */
+        result = nss_getent_fetch_entries(cmd_ctx, cmd_ctx->type, limited);
+        if (result == NULL) {
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+    } while (result->count == 0);
 
     /* Reply with limited result. */
     nss_protocol_reply(cmd_ctx->cli_ctx, cmd_ctx->nss_ctx, cmd_ctx,
@@ -364,3 +364,104 @@ errno_t nss_setnetgrent_recv(struct tevent_req *req)
 {
     return nss_setent_internal_recv(req);
 }
+
+/* User and group enumerations contain only the names of the objects, read
+ * the full entries of the records that are about to be returned. */
+struct cache_req_result *
+nss_getent_fetch_entries(TALLOC_CTX *mem_ctx,
+                         enum cache_req_type type,
+                         struct cache_req_result *names)
+{
+    struct cache_req_result *out;
+    struct ldb_result *ldb_result;
+    struct ldb_message_element *el;
+    struct ldb_message *msg;
+    char *value;
+    bool group;
+    unsigned int i;
+    errno_t ret;
+    int lret;
+
+    switch (type) {
+    case CACHE_REQ_ENUM_USERS:
+        group = false;
+        break;
+    case CACHE_REQ_ENUM_GROUPS:
+        group = true;
+        break;
+    default:
+        return names;
+    }
+
+    out = talloc_zero(mem_ctx, struct cache_req_result);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    ldb_result = talloc_zero(out, struct ldb_result);
+    if (ldb_result == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ldb_result->msgs = talloc_zero_array(ldb_result, struct ldb_message *,
+                                         names->count + 1);
+    if (ldb_result->msgs == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < names->count; i++) {
+        ret = sysdb_enum_entry_with_views(ldb_result->msgs, names->domain,
+                                          names->msgs[i]->dn, group, &msg);
+        if (ret == ENOENT) {
+            DEBUG(SSSDBG_TRACE_FUNC, "[%s] was removed during enumeration\n",
+                  ldb_dn_get_linearized(names->msgs[i]->dn));
+            continue;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to read [%s] [%d]: %s\n",
+                  ldb_dn_get_linearized(names->msgs[i]->dn),
+                  ret, sss_strerror(ret));
+            goto done;
+        }
+
+        /* Session recording is decided by cache_req on the enumeration
+         * result, keep its decision. */
+        el = ldb_msg_find_element(names->msgs[i], SYSDB_SESSION_RECORDING);
+        if (el != NULL && el->num_values == 1) {
+            ldb_msg_remove_attr(msg, SYSDB_SESSION_RECORDING);
+            value = talloc_strndup(msg, (const char *)el->values[0].data,
+                                   el->values[0].length);
+            if (value == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+
+            lret = ldb_msg_add_steal_string(msg, SYSDB_SESSION_RECORDING,
+                                            value);
+            if (lret != LDB_SUCCESS) {
+                ret = sysdb_error_to_errno(lret);
+                goto done;
+            }
+        }
+
+        ldb_result->msgs[ldb_result->count] = msg;
+        ldb_result->count++;
+    }
+
+    out->domain = names->domain;
+    out->ldb_result = ldb_result;
+    out->lookup_name = names->lookup_name;
+    out->count = ldb_result->count;
+    out->msgs = ldb_result->msgs;
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(out);
+        return NULL;
+    }
+
+    return out;
+}
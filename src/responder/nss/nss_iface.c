@@ -213,6 +213,21 @@ nss_memorycache_invalidate_group_by_id(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+static errno_t
+nss_memorycache_invalidate_user_by_id(TALLOC_CTX *mem_ctx,
+                                      struct sbus_request *sbus_req,
+                                      struct nss_ctx *nctx,
+                                      uint32_t uid)
+{
+
+    DEBUG(SSSDBG_TRACE_LIBS,
+          "Invalidating user %u from memory cache\n", uid);
+
+    sss_mmap_cache_pw_invalidate_uid(nctx->pwd_mc_ctx, uid);
+
+    return EOK;
+}
+
 errno_t
 nss_register_backend_iface(struct sbus_connection *conn,
                            struct nss_ctx *nss_ctx)
@@ -226,7 +241,8 @@ nss_register_backend_iface(struct sbus_connection *conn,
             SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateAllUsers, nss_memorycache_invalidate_users, nss_ctx),
             SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateAllGroups, nss_memorycache_invalidate_groups, nss_ctx),
             SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateAllInitgroups, nss_memorycache_invalidate_initgroups, nss_ctx),
-            SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateGroupById, nss_memorycache_invalidate_group_by_id, nss_ctx)
+            SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateGroupById, nss_memorycache_invalidate_group_by_id, nss_ctx),
+            SBUS_SYNC(METHOD, sssd_nss_MemoryCache, InvalidateUserById, nss_memorycache_invalidate_user_by_id, nss_ctx)
         ),
         SBUS_SIGNALS(SBUS_NO_SIGNALS),
         SBUS_PROPERTIES(SBUS_NO_PROPERTIES)
@@ -132,6 +132,11 @@ nss_setent_send(TALLOC_CTX *mem_ctx,
 errno_t
 nss_setent_recv(struct tevent_req *req);
 
+struct cache_req_result *
+nss_getent_fetch_entries(TALLOC_CTX *mem_ctx,
+                         enum cache_req_type type,
+                         struct cache_req_result *names);
+
 struct tevent_req *
 nss_setnetgrent_send(TALLOC_CTX *mem_ctx,
                      struct tevent_context *ev,
@@ -128,6 +128,7 @@ nss_protocol_fill_members(struct sss_packet *packet,
     struct sized_string *name;
     const char *member_name;
     uint32_t num_members = 0;
+    size_t reserve;
     size_t body_len;
     uint8_t *body;
     errno_t ret;
@@ -159,6 +160,26 @@ nss_protocol_fill_members(struct sss_packet *packet,
         goto done;
     }
 
+    /* The output names are usually as long as the internal ones, reserve
+     * the space for all of them at once instead of growing the packet with
+     * every member. */
+    reserve = 0;
+    for (i = 0; i < sizeof(members) / sizeof(members[0]); i++) {
+        el = members[i];
+        if (el == NULL) {
+            continue;
+        }
+
+        for (j = 0; j < el->num_values; j++) {
+            reserve += el->values[j].length + 1;
+        }
+    }
+
+    ret = sss_packet_reserve(packet, reserve);
+    if (ret != EOK) {
+        goto done;
+    }
+
     sss_packet_get_body(packet, &body, &body_len);
 
     for (i = 0; i < sizeof(members) / sizeof(members[0]); i++) {
@@ -20,6 +20,8 @@
 */
 
 #include "util/util.h"
+#include "util/sss_metrics.h"
+#include "util/probes.h"
 #include "util/crypto/sss_crypto.h"
 #include "confdb/confdb.h"
 #include <sys/mman.h>
@@ -477,6 +479,11 @@ static errno_t sss_mc_find_free_slots(struct sss_mc_ctx *mcc,
             /* next loop skip the whole record */
             i += MC_SIZE_TO_SLOTS(rec->len) - 1;
 
+            if (rec->b1 != MC_INVALID_VAL) {
+                sss_metrics_inc(SSS_METRICS_MEMCACHE_UPDATES, mcc->name,
+                                "evict");
+            }
+
             /* finally invalidate record completely */
             sss_mc_invalidate_rec(mcc, rec);
         }
@@ -690,6 +697,8 @@ static inline void sss_mmap_chain_in_rec(struct sss_mc_ctx *mcc,
     sss_mc_add_rec_to_chain(mcc, rec, rec->hash1);
     /* then uid/gid */
     sss_mc_add_rec_to_chain(mcc, rec, rec->hash2);
+
+    sss_metrics_inc(SSS_METRICS_MEMCACHE_UPDATES, mcc->name, "store");
 }
 
 /***************************************************************************
@@ -713,6 +722,7 @@ static errno_t sss_mmap_cache_invalidate(struct sss_mc_ctx *mcc,
     }
 
     sss_mc_invalidate_rec(mcc, rec);
+    sss_metrics_inc(SSS_METRICS_MEMCACHE_UPDATES, mcc->name, "invalidate");
 
     return EOK;
 }
@@ -789,6 +799,8 @@ errno_t sss_mmap_cache_pw_store(struct sss_mc_ctx **_mcc,
 
     MC_LOWER_BARRIER(rec);
 
+    PROBE(MMAP_CACHE_STORE, mcc->name, name->str, rec_len);
+
     /* finally chain the rec in the hash table */
     sss_mmap_chain_in_rec(mcc, rec);
 
@@ -853,6 +865,7 @@ errno_t sss_mmap_cache_pw_invalidate_uid(struct sss_mc_ctx *mcc, uid_t uid)
     }
 
     sss_mc_invalidate_rec(mcc, rec);
+    sss_metrics_inc(SSS_METRICS_MEMCACHE_UPDATES, mcc->name, "invalidate");
 
     ret = EOK;
 
@@ -927,6 +940,8 @@ int sss_mmap_cache_gr_store(struct sss_mc_ctx **_mcc,
 
     MC_LOWER_BARRIER(rec);
 
+    PROBE(MMAP_CACHE_STORE, mcc->name, name->str, rec_len);
+
     /* finally chain the rec in the hash table */
     sss_mmap_chain_in_rec(mcc, rec);
 
@@ -991,6 +1006,7 @@ errno_t sss_mmap_cache_gr_invalidate_gid(struct sss_mc_ctx *mcc, gid_t gid)
     }
 
     sss_mc_invalidate_rec(mcc, rec);
+    sss_metrics_inc(SSS_METRICS_MEMCACHE_UPDATES, mcc->name, "invalidate");
 
     ret = EOK;
 
@@ -1060,6 +1076,8 @@ errno_t sss_mmap_cache_initgr_store(struct sss_mc_ctx **_mcc,
 
     MC_LOWER_BARRIER(rec);
 
+    PROBE(MMAP_CACHE_STORE, mcc->name, name->str, rec_len);
+
     /* finally chain the rec in the hash table */
     sss_mmap_chain_in_rec(mcc, rec);
 
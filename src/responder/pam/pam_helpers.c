@@ -21,6 +21,7 @@
 */
 
 
+#include "db/sysdb.h"
 #include "src/responder/pam/pam_helpers.h"
 
 struct pam_initgr_table_ctx {
@@ -160,3 +161,218 @@ errno_t pam_initgr_check_timeout(hash_table_t *id_table,
     return EOK;
 }
 
+
+struct pam_session_ctx_entry {
+    hash_table_t *session_table;
+    char *key;
+    struct sss_domain_info *domain;
+    struct ldb_message *user_obj;
+};
+
+static void pam_session_ctx_expire(struct tevent_context *ev,
+                                   struct tevent_timer *te,
+                                   struct timeval tv,
+                                   void *pvt);
+
+errno_t pam_session_ctx_set(struct tevent_context *ev,
+                            hash_table_t *session_table,
+                            const char *key,
+                            struct sss_domain_info *domain,
+                            struct ldb_message *user_obj,
+                            long timeout)
+{
+    struct pam_session_ctx_entry *entry;
+    struct tevent_timer *te;
+    struct timeval tv;
+    hash_key_t hkey;
+    hash_value_t val;
+    int hret;
+    errno_t ret;
+
+    /* a newer result replaces the old one */
+    pam_session_ctx_remove(session_table, key);
+
+    entry = talloc_zero(session_table, struct pam_session_ctx_entry);
+    if (entry == NULL) {
+        return ENOMEM;
+    }
+
+    entry->session_table = session_table;
+    entry->domain = domain;
+
+    entry->key = talloc_strdup(entry, key);
+    if (entry->key == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    entry->user_obj = ldb_msg_copy(entry, user_obj);
+    if (entry->user_obj == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* Create a timer event to remove the entry from the cache */
+    tv = tevent_timeval_current_ofs(timeout, 0);
+    te = tevent_add_timer(ev, entry, tv, pam_session_ctx_expire, entry);
+    if (te == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = entry->key;
+    val.type = HASH_VALUE_PTR;
+    val.ptr = entry;
+
+    hret = hash_enter(session_table, &hkey, &val);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Could not update PAM session cache for [%s]: [%s]\n",
+               key, hash_error_string(hret));
+        ret = EIO;
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "[%s] added to PAM session cache\n", key);
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(entry);
+    }
+    return ret;
+}
+
+static void pam_session_ctx_expire(struct tevent_context *ev,
+                                   struct tevent_timer *te,
+                                   struct timeval tv,
+                                   void *pvt)
+{
+    struct pam_session_ctx_entry *entry =
+            talloc_get_type(pvt, struct pam_session_ctx_entry);
+
+    pam_session_ctx_remove(entry->session_table, entry->key);
+}
+
+/* The cached object is only valid as long as the user was neither removed
+ * from the cache nor updated there, e.g. disabled by a refresh. */
+static errno_t pam_session_ctx_check_user(struct pam_session_ctx_entry *entry)
+{
+    const char *attrs[] = { SYSDB_LAST_UPDATE, SYSDB_CACHE_EXPIRE, NULL };
+    struct ldb_message *msg;
+    const char *name;
+    errno_t ret;
+
+    name = ldb_msg_find_attr_as_string(entry->user_obj, SYSDB_NAME, NULL);
+    if (name == NULL) {
+        return ENOENT;
+    }
+
+    ret = sysdb_search_user_by_name(NULL, entry->domain, name, attrs, &msg);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    if (ldb_msg_find_attr_as_uint64(msg, SYSDB_LAST_UPDATE, 0)
+            != ldb_msg_find_attr_as_uint64(entry->user_obj,
+                                           SYSDB_LAST_UPDATE, 0)
+        || ldb_msg_find_attr_as_uint64(msg, SYSDB_CACHE_EXPIRE, 0)
+            != ldb_msg_find_attr_as_uint64(entry->user_obj,
+                                           SYSDB_CACHE_EXPIRE, 0)) {
+        ret = ENOENT;
+    } else {
+        ret = EOK;
+    }
+
+    talloc_free(msg);
+    return ret;
+}
+
+errno_t pam_session_ctx_get(TALLOC_CTX *mem_ctx,
+                            hash_table_t *session_table,
+                            const char *key,
+                            struct sss_domain_info **_domain,
+                            struct ldb_message **_user_obj)
+{
+    struct pam_session_ctx_entry *entry;
+    struct ldb_message *user_obj;
+    hash_key_t hkey;
+    hash_value_t val;
+    errno_t ret;
+    int hret;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+
+    hret = hash_lookup(session_table, &hkey, &val);
+    if (hret == HASH_ERROR_KEY_NOT_FOUND) {
+        DEBUG(SSSDBG_TRACE_ALL, "[%s] not found in PAM session cache.\n", key);
+        return ENOENT;
+    } else if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_TRACE_ALL, "Error searching [%s] in PAM session cache.\n",
+                                key);
+        return EIO;
+    }
+
+    entry = talloc_get_type(val.ptr, struct pam_session_ctx_entry);
+
+    if (sss_domain_get_state(entry->domain) == DOM_DISABLED) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Domain of [%s] was disabled.\n", key);
+        pam_session_ctx_remove(session_table, key);
+        return ENOENT;
+    }
+
+    ret = pam_session_ctx_check_user(entry);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_TRACE_FUNC, "User of [%s] was removed or updated in the "
+              "cache [%d]: %s\n", key, ret, sss_strerror(ret));
+        pam_session_ctx_remove(session_table, key);
+        return ENOENT;
+    }
+
+    /* the entry might expire while the caller still needs the object */
+    user_obj = ldb_msg_copy(mem_ctx, entry->user_obj);
+    if (user_obj == NULL) {
+        return ENOMEM;
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "[%s] found in PAM session cache.\n", key);
+
+    *_domain = entry->domain;
+    *_user_obj = user_obj;
+
+    return EOK;
+}
+
+void pam_session_ctx_remove(hash_table_t *session_table,
+                            const char *key)
+{
+    struct pam_session_ctx_entry *entry;
+    hash_key_t hkey;
+    hash_value_t val;
+    int hret;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+
+    hret = hash_lookup(session_table, &hkey, &val);
+    if (hret != HASH_SUCCESS) {
+        return;
+    }
+
+    entry = talloc_get_type(val.ptr, struct pam_session_ctx_entry);
+
+    hret = hash_delete(session_table, &hkey);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Could not clear [%s] from PAM session cache: [%s]\n",
+               key, hash_error_string(hret));
+    } else {
+        DEBUG(SSSDBG_TRACE_INTERNAL,
+              "[%s] removed from PAM session cache\n", key);
+    }
+
+    talloc_free(entry);
+}
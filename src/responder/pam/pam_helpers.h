@@ -39,4 +39,30 @@ errno_t pam_initgr_cache_set(struct tevent_context *ev,
 errno_t pam_initgr_check_timeout(hash_table_t *id_table,
                                  char *name);
 
+/* The PAM session context cache keeps the user object and the domain found
+ * by the first step of a PAM conversation (preauth, auth, acct_mgmt,
+ * open_session, ...) for @timeout seconds, so that the following steps of
+ * the same client do not have to look the user up again. The key is built
+ * by the caller and must identify the PAM client, e.g. by PID and service.
+ */
+errno_t pam_session_ctx_set(struct tevent_context *ev,
+                            hash_table_t *session_table,
+                            const char *key,
+                            struct sss_domain_info *domain,
+                            struct ldb_message *user_obj,
+                            long timeout);
+
+/* Returns EOK and a copy of the cached user object allocated on @mem_ctx
+ * Returns ENOENT if there is no valid entry for @key, the entry is dropped
+ * if the user was removed or updated in the cache since it was stored
+ */
+errno_t pam_session_ctx_get(TALLOC_CTX *mem_ctx,
+                            hash_table_t *session_table,
+                            const char *key,
+                            struct sss_domain_info **_domain,
+                            struct ldb_message **_user_obj);
+
+void pam_session_ctx_remove(hash_table_t *session_table,
+                            const char *key);
+
 #endif /* PAM_HELPERS_H_ */
@@ -41,6 +41,7 @@
 #include "providers/data_provider.h"
 #include "responder/pam/pamsrv.h"
 #include "responder/common/negcache.h"
+#include "util/sss_hash_pool.h"
 #include "sss_iface/sss_iface_async.h"
 
 #define DEFAULT_PAM_FD_LIMIT 8192
@@ -173,6 +174,7 @@ static int pam_process_init(TALLOC_CTX *mem_ctx,
 {
     struct resp_ctx *rctx;
     struct sss_cmd_table *pam_cmds;
+    struct sss_domain_info *dom;
     struct pam_ctx *pctx;
     int ret;
     int id_timeout;
@@ -245,6 +247,15 @@ static int pam_process_init(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    /* Create table for the user data of running PAM conversations */
+    ret = sss_hash_create(pctx, 0, &pctx->session_table);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Could not create PAM session hash table: [%s]\n",
+              strerror(ret));
+        goto done;
+    }
+
     /* Set up file descriptor limits */
     ret = confdb_get_int(pctx->rctx->cdb,
                          CONFDB_PAM_CONF_ENTRY,
@@ -391,6 +402,22 @@ static int pam_process_init(TALLOC_CTX *mem_ctx,
         }
     }
 
+    for (dom = rctx->domains; dom != NULL; dom = get_next_domain(dom, 0)) {
+        if (dom->cache_credentials) {
+            break;
+        }
+    }
+
+    if (dom != NULL) {
+        ret = sss_hash_pool_init(pctx, rctx->ev, 0, &pctx->hash_pool);
+        if (ret != EOK) {
+            /* not fatal, cached authentication hashes in the main loop */
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Unable to start password hashing threads [%d]: %s\n",
+                  ret, sss_strerror(ret));
+        }
+    }
+
     /* The responder is initialized. Now tell it to the monitor. */
     ret = sss_monitor_service_init(rctx, rctx->ev, SSS_BUS_PAM,
                                    SSS_PAM_SBUS_SERVICE_NAME,
@@ -43,6 +43,8 @@ struct pam_ctx {
     struct resp_ctx *rctx;
     time_t id_timeout;
     hash_table_t *id_table;
+    /* user data of running PAM conversations, see pam_session_ctx_set() */
+    hash_table_t *session_table;
     size_t trusted_uids_count;
     uid_t *trusted_uids;
 
@@ -68,6 +70,9 @@ struct pam_ctx {
     /* List of authentication indicators associated with a PAM service */
     char **gssapi_indicators_map;
     bool gssapi_check_upn;
+
+    /* Worker threads hashing passwords for cached authentication */
+    struct sss_hash_pool *hash_pool;
 };
 
 struct pam_auth_req {
@@ -84,8 +89,13 @@ struct pam_auth_req {
     bool use_cached_auth;
     /* whether cached authentication was tried and failed */
     bool cached_auth_failed;
+    /* whether the running cached authentication is tried before the
+     * backend is contacted */
+    bool cached_auth_first;
 
     struct ldb_message *user_obj;
+    /* key of the PAM session context cache entry, NULL if not cachable */
+    char *session_key;
     struct cert_auth_info *cert_list;
     struct cert_auth_info *current_cert;
     bool cert_auth_local;
@@ -24,6 +24,7 @@
 #include "util/util.h"
 #include "util/auth_utils.h"
 #include "util/find_uid.h"
+#include "util/probes.h"
 #include "db/sysdb.h"
 #include "confdb/confdb.h"
 #include "responder/common/responder_packet.h"
@@ -728,6 +729,7 @@ static errno_t get_password_for_cache_auth(struct sss_auth_token *authtok,
 static int pam_forwarder(struct cli_ctx *cctx, int pam_cmd);
 static void pam_handle_cached_login(struct pam_auth_req *preq, int ret,
                                     time_t expire_date, time_t delayed_until, bool cached_auth);
+static void pam_cached_auth_done(struct tevent_req *subreq);
 
 /*
  * Add a request to add a variable to the PAM user environment, containing the
@@ -826,8 +828,7 @@ static void pam_reply(struct pam_auth_req *preq)
     struct pam_data *pd;
     struct pam_ctx *pctx;
     uint32_t user_info_type;
-    time_t exp_date = -1;
-    time_t delay_until = -1;
+    struct tevent_req *subreq;
     char* pam_account_expired_message;
     char* pam_account_locked_message;
     int pam_verbosity;
@@ -850,6 +851,8 @@ static void pam_reply(struct pam_auth_req *preq)
           "pam_reply initially called with result [%d]: %s. "
           "this result might be changed during processing\n",
           pd->pam_status, pam_strerror(NULL, pd->pam_status));
+    PROBE(PAM_REPLY, pd->cmd, PROBE_SAFE_STR(pd->domain),
+          PROBE_SAFE_STR(pd->user), pd->pam_status);
 
     if (pd->cmd == SSS_PAM_AUTHENTICATE
             && !preq->cert_auth_local
@@ -881,10 +884,9 @@ static void pam_reply(struct pam_auth_req *preq)
                 (preq->domain->cache_credentials == true) &&
                 (pd->offline_auth == false)) {
                 const char *password = NULL;
-                bool use_cached_auth;
 
                 /* backup value of preq->use_cached_auth*/
-                use_cached_auth = preq->use_cached_auth;
+                preq->cached_auth_first = preq->use_cached_auth;
                 /* set to false to avoid entering this branch when pam_reply()
                  * is recursively called from pam_handle_cached_login() */
                 preq->use_cached_auth = false;
@@ -906,13 +908,18 @@ static void pam_reply(struct pam_auth_req *preq)
                     goto done;
                 }
 
-                ret = sysdb_cache_auth(preq->domain,
-                                       pd->user, password,
-                                       pctx->rctx->cdb, false,
-                                       &exp_date, &delay_until);
+                subreq = sysdb_cache_auth_send(preq, cctx->ev,
+                                               pctx->hash_pool,
+                                               preq->domain, pd->user,
+                                               password, pctx->rctx->cdb,
+                                               false);
+                if (subreq == NULL) {
+                    DEBUG(SSSDBG_CRIT_FAILURE,
+                          "sysdb_cache_auth_send failed.\n");
+                    goto done;
+                }
 
-                pam_handle_cached_login(preq, ret, exp_date, delay_until,
-                                        use_cached_auth);
+                tevent_req_set_callback(subreq, pam_cached_auth_done, preq);
                 return;
             }
             break;
@@ -1114,6 +1121,13 @@ static void pam_reply(struct pam_auth_req *preq)
     }
 
 done:
+    /* the conversation is over or the user is gone */
+    if (preq->session_key != NULL
+            && (pd->cmd == SSS_PAM_CLOSE_SESSION
+                || pd->pam_status == PAM_USER_UNKNOWN)) {
+        pam_session_ctx_remove(pctx->session_table, preq->session_key);
+    }
+
     DEBUG(SSSDBG_FUNC_DATA, "Returning [%d]: %s to the client\n",
           pd->pam_status, pam_strerror(NULL, pd->pam_status));
     sss_cmd_done(cctx, preq);
@@ -1193,6 +1207,22 @@ static void pam_handle_cached_login(struct pam_auth_req *preq, int ret,
     return;
 }
 
+static void pam_cached_auth_done(struct tevent_req *subreq)
+{
+    struct pam_auth_req *preq;
+    time_t exp_date = -1;
+    time_t delay_until = -1;
+    errno_t ret;
+
+    preq = tevent_req_callback_data(subreq, struct pam_auth_req);
+
+    ret = sysdb_cache_auth_recv(subreq, &exp_date, &delay_until);
+    talloc_zfree(subreq);
+
+    pam_handle_cached_login(preq, ret, exp_date, delay_until,
+                            preq->cached_auth_first);
+}
+
 static void pam_forwarder_cb(struct tevent_req *req);
 static void pam_forwarder_cert_cb(struct tevent_req *req);
 static int pam_check_user_search(struct pam_auth_req *preq);
@@ -1466,6 +1496,8 @@ static int pam_forwarder(struct cli_ctx *cctx, int pam_cmd)
     pd->cmd = pam_cmd;
     pd->priv = cctx->priv;
 
+    PROBE(PAM_FORWARDER, pam_cmd);
+
     ret = pam_forwarder_parse_data(cctx, pd);
     if (ret == EAGAIN) {
         req = sss_dp_get_domains_send(cctx->rctx, cctx->rctx, true, pd->domain);
@@ -1902,12 +1934,76 @@ static void pam_check_user_search_lookup(struct tevent_req *req);
 static void pam_check_user_search_done(struct pam_auth_req *preq, int ret,
                                        struct cache_req_result *result);
 
+/* The steps of one PAM conversation are sent by the same client process for
+ * the same service, so the PID, the service and everything that influences
+ * the user lookup is part of the key. */
+static char *pam_session_ctx_key(TALLOC_CTX *mem_ctx,
+                                 struct pam_auth_req *preq)
+{
+    struct pam_data *pd = preq->pd;
+    const char *service;
+    char *domains;
+    size_t c;
+
+    if (pd->cli_pid == 0 || pd->logon_name == NULL) {
+        return NULL;
+    }
+
+    service = pd->service != NULL ? pd->service : "";
+
+    domains = talloc_strdup(mem_ctx, "");
+    if (domains == NULL) {
+        return NULL;
+    }
+
+    for (c = 0; pd->requested_domains != NULL
+                    && pd->requested_domains[c] != NULL; c++) {
+        domains = talloc_asprintf_append(domains, "%s,",
+                                         pd->requested_domains[c]);
+        if (domains == NULL) {
+            return NULL;
+        }
+    }
+
+    return talloc_asprintf(mem_ctx, "%"PRIu32":%"SPRIuid":%d:%zu:%s:%s:%s",
+                           pd->cli_pid, client_euid(preq->cctx->creds),
+                           preq->req_dom_type, strlen(service), service,
+                           domains, pd->logon_name);
+}
+
 /* lookup the user uid from the cache first,
  * then we'll refresh initgroups if needed */
 static int pam_check_user_search(struct pam_auth_req *preq)
 {
     struct tevent_req *dpreq;
     struct cache_req_data *data;
+    struct pam_ctx *pctx;
+    struct sss_domain_info *domain;
+    struct ldb_message *user_obj;
+    errno_t ret;
+
+    pctx = talloc_get_type(preq->cctx->rctx->pvt_ctx, struct pam_ctx);
+
+    /* reuse the user found by an earlier step of the same conversation */
+    talloc_zfree(preq->session_key);
+    preq->session_key = pam_session_ctx_key(preq, preq);
+    if (preq->session_key != NULL) {
+        ret = pam_session_ctx_get(preq, pctx->session_table,
+                                  preq->session_key, &domain, &user_obj);
+        if (ret == EOK) {
+            preq->user_obj = user_obj;
+            pd_set_primary_name(preq->user_obj, preq->pd);
+            preq->domain = domain;
+
+            pam_dom_forwarder(preq);
+
+            /* The request is handled now and preq might already be freed,
+             * so the caller must not touch it anymore. */
+            return EAGAIN;
+        } else if (ret != ENOENT) {
+            DEBUG(SSSDBG_OP_FAILURE, "Could not look up PAM session cache\n");
+        }
+    }
 
     data = cache_req_data_name(preq,
                                CACHE_REQ_INITGROUPS,
@@ -2089,6 +2185,20 @@ static void pam_check_user_search_done(struct pam_auth_req *preq, int ret,
                   "Proceeding with PAM actions\n");
         }
 
+        if (preq->session_key != NULL) {
+            ret = pam_session_ctx_set(pctx->rctx->ev,
+                                      pctx->session_table,
+                                      preq->session_key,
+                                      preq->domain,
+                                      preq->user_obj,
+                                      pctx->id_timeout);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_OP_FAILURE,
+                      "Could not save PAM session data."
+                      "Proceeding with PAM actions\n");
+            }
+        }
+
         pam_dom_forwarder(preq);
     }
 
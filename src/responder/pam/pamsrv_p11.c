@@ -154,6 +154,12 @@ errno_t p11_refresh_certmap_ctx(struct pam_ctx *pctx,
         goto done;
     }
 
+    ret = sss_certmap_enable_cache(sss_certmap_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sss_certmap_enable_cache failed.\n");
+        goto done;
+    }
+
     DLIST_FOR_EACH(dom, domains) {
         certmap_list = dom->certmaps;
         if (certmap_list != NULL && *certmap_list != NULL) {
@@ -187,6 +187,12 @@ static errno_t ssh_cmd_refresh_certmap_ctx(struct ssh_ctx *ssh_ctx,
         goto done;
     }
 
+    ret = sss_certmap_enable_cache(sss_certmap_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "sss_certmap_enable_cache failed.\n");
+        goto done;
+    }
+
     rule_added = false;
     DLIST_FOR_EACH(dom, domains) {
         certmap_list = dom->certmaps;
@@ -222,20 +222,30 @@ def InitializeDataTypes():
     """Define which D-Bus types are supported by code generator."""
 
     # Standard types
-    DataType.Create("y", "uint8_t",      '" PRIu8 "')
+    DataType.Create("y", "uint8_t",      '" PRIu8 "',
+                    Borrow="DBUS_TYPE_BYTE")
     DataType.Create("b", "bool",         "d")
-    DataType.Create("n", "int16_t",      '" PRId16 "')
-    DataType.Create("q", "uint16_t",     '" PRIu16 "')
-    DataType.Create("i", "int32_t",      '" PRId32 "')
-    DataType.Create("u", "uint32_t",     '" PRIu32 "')
-    DataType.Create("x", "int64_t",      '" PRId64 "')
-    DataType.Create("t", "uint64_t",     '" PRIu64 "')
-    DataType.Create("d", "double",       "f")
-
-    # String types
-    DataType.Create("s", "const char *", "s", DBusType="s", RequireTalloc=True)
+    DataType.Create("n", "int16_t",      '" PRId16 "',
+                    Borrow="DBUS_TYPE_INT16")
+    DataType.Create("q", "uint16_t",     '" PRIu16 "',
+                    Borrow="DBUS_TYPE_UINT16")
+    DataType.Create("i", "int32_t",      '" PRId32 "',
+                    Borrow="DBUS_TYPE_INT32")
+    DataType.Create("u", "uint32_t",     '" PRIu32 "',
+                    Borrow="DBUS_TYPE_UINT32")
+    DataType.Create("x", "int64_t",      '" PRId64 "',
+                    Borrow="DBUS_TYPE_INT64")
+    DataType.Create("t", "uint64_t",     '" PRIu64 "',
+                    Borrow="DBUS_TYPE_UINT64")
+    DataType.Create("d", "double",       "f",
+                    Borrow="DBUS_TYPE_DOUBLE")
+
+    # String types, only const strings can point into the message
+    DataType.Create("s", "const char *", "s", DBusType="s", RequireTalloc=True,
+                    Borrow="DBUS_TYPE_STRING")
     DataType.Create("S", "char *",       "s", DBusType="s", RequireTalloc=True)
-    DataType.Create("o", "const char *", "s", DBusType="o", RequireTalloc=True)
+    DataType.Create("o", "const char *", "s", DBusType="o", RequireTalloc=True,
+                    Borrow="DBUS_TYPE_OBJECT_PATH")
     DataType.Create("O", "char *",       "s", DBusType="o", RequireTalloc=True)
 
     # Array types
@@ -30,11 +30,15 @@ class DataType:
     available = {}
 
     def __init__(self, sbus_type, dbus_type, c_type, key_format,
-                 require_talloc):
+                 require_talloc, borrow_type):
         self.sbus_type = sbus_type
         self.dbus_type = dbus_type
         self.RequireTalloc = require_talloc
 
+        # D-Bus type constant if the value can be read directly from the
+        # message without conversion or copy, None otherwise
+        self.borrowType = borrow_type
+
         # Printf formatter (without leading %) if the type supports keying
         self.keyFormat = key_format
 
@@ -64,14 +68,17 @@ class DataType:
 
     @staticmethod
     def Create(sbus_type, c_type, KeyFormat=None, DBusType=None,
-               RequireTalloc=False):
+               RequireTalloc=False, Borrow=None):
         """ Create a new SBus type. Specify DBusType if it differs from
             the SBus type. Specify printf formatter KeyFormat if this type
-            can be used as a key.
+            can be used as a key. Specify D-Bus type constant Borrow if
+            the C type has the same layout as the D-Bus type so the value
+            can be read directly from the message.
         """
         dbus_type = DBusType if DBusType is not None else sbus_type
 
-        type = DataType(sbus_type, dbus_type, c_type, KeyFormat, RequireTalloc)
+        type = DataType(sbus_type, dbus_type, c_type, KeyFormat, RequireTalloc,
+                        Borrow)
         DataType.available[sbus_type] = type
 
         return type
@@ -134,6 +134,16 @@ class Generator:
 
             return name.strip('.').replace('.', '_')
 
+        def canBorrow(self, arguments):
+            """
+                True if all arguments can be read directly from the message.
+            """
+            for arg in arguments.values():
+                if DataType.Find(arg.signature).borrowType is None:
+                    return False
+
+            return True
+
         def setInputArguments(self, tpl, sbus_signature):
             """
                 Set input arguments in template.
@@ -447,6 +457,9 @@ class Generator:
         def generateSource(self):
             tpl = self.source.get("arguments")
             for signature, args in self.invoker_arguments.items():
+                borrow = self.canBorrow(args)
+                tpl.show("if-borrow", borrow)
+
                 for idx, arg in enumerate(args.values()):
                     type = DataType.Find(arg.signature)
                     memctx = "mem_ctx, " if type.RequireTalloc else ""
@@ -456,12 +469,19 @@ class Generator:
                     tpl.add('read-argument', keys)
                     tpl.add('write-argument', keys)
 
+                    if borrow:
+                        tpl.add('borrow-argument',
+                                {"dbus-type": type.borrowType,
+                                 "index": idx})
+
                 keys = {"signature": signature}
                 tpl.set(keys)
 
         def generateHeader(self):
             tpl = self.header.get("arguments")
             for signature, args in self.invoker_arguments.items():
+                tpl.show("if-borrow", self.canBorrow(args))
+
                 for idx, arg in enumerate(args.values()):
                     keys = {"type": DataType.Find(arg.signature).inputCType,
                             "index": idx}
@@ -496,6 +516,10 @@ class Generator:
                          self.hasParsable(invoker.input))
                 tpl.show("if-output-arguments",
                          self.hasParsable(invoker.output))
+                parsable = self.hasParsable(invoker.input)
+                borrow = parsable and self.canBorrow(invoker.input.arguments)
+                tpl.show("if-borrow-input", borrow)
+                tpl.show("if-copy-input", parsable and not borrow)
 
                 self.setInputArguments(tpl, invoker.input)
                 self.setOutputArguments(tpl, invoker.output)
@@ -64,4 +64,21 @@
         return EOK;
     }
 
+    <toggle name="if-borrow">
+    errno_t _sbus_invoker_borrow_${signature}
+       (DBusMessageIter *iter,
+        struct _sbus_invoker_args_${signature} *args)
+    {
+        <loop name="borrow-argument">
+        if (dbus_message_iter_get_arg_type(iter) != ${dbus-type}) {
+            return ERR_SBUS_INVALID_TYPE;
+        }
+        dbus_message_iter_get_basic(iter, &args->arg${index});
+        dbus_message_iter_next(iter);
+
+        </loop>
+        return EOK;
+    }
+
+    </toggle>
 </template>
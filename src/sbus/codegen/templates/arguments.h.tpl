@@ -51,6 +51,15 @@
        (DBusMessageIter *iter,
         struct _sbus_invoker_args_${signature} *args);
 
+    <toggle name="if-borrow">
+    /* Read arguments without copying them. Strings point into the message
+     * and are valid only as long as the message exists. */
+    errno_t
+    _sbus_invoker_borrow_${signature}
+       (DBusMessageIter *iter,
+        struct _sbus_invoker_args_${signature} *args);
+
+    </toggle>
 </template>
 
 <template name="file-footer">
@@ -60,7 +60,7 @@
 <template name="invoker">
     struct _sbus_invoke_in_${input-signature}_out_${output-signature}_state {
         <toggle name="if-input-arguments">
-        struct _sbus_invoker_args_${input-signature} *in;
+        struct _sbus_invoker_args_${input-signature} in;
         </toggle>
         <toggle name="if-output-arguments">
         struct _sbus_invoker_args_${output-signature} out;
@@ -121,16 +121,17 @@
         state->read_iterator = read_iterator;
         state->write_iterator = write_iterator;
 
-        <toggle name="if-input-arguments">
-        state->in = talloc_zero(state, struct _sbus_invoker_args_${input-signature});
-        if (state->in == NULL) {
-            DEBUG(SSSDBG_CRIT_FAILURE,
-                  "Unable to allocate space for input parameters!\n");
-            ret = ENOMEM;
+        <toggle name="if-borrow-input">
+        /* The message is kept alive by the router until this request is
+         * finished so the arguments do not need to be copied. */
+        ret = _sbus_invoker_borrow_${input-signature}(read_iterator, &state->in);
+        if (ret != EOK) {
             goto done;
         }
 
-        ret = _sbus_invoker_read_${input-signature}(state, read_iterator, state->in);
+        </toggle>
+        <toggle name="if-copy-input">
+        ret = _sbus_invoker_read_${input-signature}(state, read_iterator, &state->in);
         if (ret != EOK) {
             goto done;
         }
@@ -141,7 +142,7 @@
             goto done;
         }
 
-        ret = sbus_request_key(state, keygen, sbus_req,<toggle name="if-input-arguments"> state->in<or> NULL</toggle>, &key);
+        ret = sbus_request_key(state, keygen, sbus_req,<toggle name="if-input-arguments"> &state->in<or> NULL</toggle>, &key);
         if (ret != EOK) {
             goto done;
         }
@@ -183,7 +184,7 @@
                 goto done;
             }
 
-            ret = state->handler.sync(state, state->sbus_req, state->handler.data<loop name="in">, state->in->arg${index}</loop><loop name="in-raw">, state->read_iterator</loop><loop name="out">, &state->out.arg${index}</loop><loop name="out-raw">, state->write_iterator</loop>);
+            ret = state->handler.sync(state, state->sbus_req, state->handler.data<loop name="in">, state->in.arg${index}</loop><loop name="in-raw">, state->read_iterator</loop><loop name="out">, &state->out.arg${index}</loop><loop name="out-raw">, state->write_iterator</loop>);
             if (ret != EOK) {
                 goto done;
             }
@@ -199,7 +200,7 @@
                 goto done;
             }
 
-            subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data<loop name="in">, state->in->arg${index}</loop><loop name="in-raw">, state->read_iterator</loop><loop name="out-raw">, state->write_iterator</loop>);
+            subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data<loop name="in">, state->in.arg${index}</loop><loop name="in-raw">, state->read_iterator</loop><loop name="out-raw">, state->write_iterator</loop>);
             if (subreq == NULL) {
                 DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
                 ret = ENOMEM;
@@ -114,6 +114,19 @@ errno_t _sbus_dbus_invoker_write_s
     return EOK;
 }
 
+errno_t _sbus_dbus_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_s *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_dbus_invoker_read_ss
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -153,6 +166,25 @@ errno_t _sbus_dbus_invoker_write_ss
     return EOK;
 }
 
+errno_t _sbus_dbus_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_ss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_dbus_invoker_read_sss
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -202,6 +234,31 @@ errno_t _sbus_dbus_invoker_write_sss
     return EOK;
 }
 
+errno_t _sbus_dbus_invoker_borrow_sss
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_sss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_dbus_invoker_read_su
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -241,6 +298,25 @@ errno_t _sbus_dbus_invoker_write_su
     return EOK;
 }
 
+errno_t _sbus_dbus_invoker_borrow_su
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_su *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_dbus_invoker_read_u
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -270,3 +346,16 @@ errno_t _sbus_dbus_invoker_write_u
     return EOK;
 }
 
+errno_t _sbus_dbus_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_u *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
@@ -72,6 +72,13 @@ _sbus_dbus_invoker_write_s
    (DBusMessageIter *iter,
     struct _sbus_dbus_invoker_args_s *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_dbus_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_s *args);
+
 struct _sbus_dbus_invoker_args_ss {
     const char * arg0;
     const char * arg1;
@@ -88,6 +95,13 @@ _sbus_dbus_invoker_write_ss
    (DBusMessageIter *iter,
     struct _sbus_dbus_invoker_args_ss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_dbus_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_ss *args);
+
 struct _sbus_dbus_invoker_args_sss {
     const char * arg0;
     const char * arg1;
@@ -105,6 +119,13 @@ _sbus_dbus_invoker_write_sss
    (DBusMessageIter *iter,
     struct _sbus_dbus_invoker_args_sss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_dbus_invoker_borrow_sss
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_sss *args);
+
 struct _sbus_dbus_invoker_args_su {
     const char * arg0;
     uint32_t arg1;
@@ -121,6 +142,13 @@ _sbus_dbus_invoker_write_su
    (DBusMessageIter *iter,
     struct _sbus_dbus_invoker_args_su *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_dbus_invoker_borrow_su
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_su *args);
+
 struct _sbus_dbus_invoker_args_u {
     uint32_t arg0;
 };
@@ -136,4 +164,11 @@ _sbus_dbus_invoker_write_u
    (DBusMessageIter *iter,
     struct _sbus_dbus_invoker_args_u *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_dbus_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_dbus_invoker_args_u *args);
+
 #endif /* _SBUS_DBUS_ARGUMENTS_H_ */
@@ -548,7 +548,7 @@ static void _sbus_dbus_invoke_in_raw_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out__state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -605,15 +605,9 @@ _sbus_dbus_invoke_in_s_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -623,7 +617,7 @@ _sbus_dbus_invoke_in_s_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -665,7 +659,7 @@ static void _sbus_dbus_invoke_in_s_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -678,7 +672,7 @@ static void _sbus_dbus_invoke_in_s_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -721,7 +715,7 @@ static void _sbus_dbus_invoke_in_s_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out_as_state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct _sbus_dbus_invoker_args_as out;
     struct {
         enum sbus_handler_type type;
@@ -779,15 +773,9 @@ _sbus_dbus_invoke_in_s_out_as_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -797,7 +785,7 @@ _sbus_dbus_invoke_in_s_out_as_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -839,7 +827,7 @@ static void _sbus_dbus_invoke_in_s_out_as_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -853,7 +841,7 @@ static void _sbus_dbus_invoke_in_s_out_as_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -902,7 +890,7 @@ static void _sbus_dbus_invoke_in_s_out_as_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out_b_state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct _sbus_dbus_invoker_args_b out;
     struct {
         enum sbus_handler_type type;
@@ -960,15 +948,9 @@ _sbus_dbus_invoke_in_s_out_b_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -978,7 +960,7 @@ _sbus_dbus_invoke_in_s_out_b_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1020,7 +1002,7 @@ static void _sbus_dbus_invoke_in_s_out_b_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1034,7 +1016,7 @@ static void _sbus_dbus_invoke_in_s_out_b_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1083,7 +1065,7 @@ static void _sbus_dbus_invoke_in_s_out_b_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out_raw_state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -1140,15 +1122,9 @@ _sbus_dbus_invoke_in_s_out_raw_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1158,7 +1134,7 @@ _sbus_dbus_invoke_in_s_out_raw_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1200,7 +1176,7 @@ static void _sbus_dbus_invoke_in_s_out_raw_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->write_iterator);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->write_iterator);
         if (ret != EOK) {
             goto done;
         }
@@ -1213,7 +1189,7 @@ static void _sbus_dbus_invoke_in_s_out_raw_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->write_iterator);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->write_iterator);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1256,7 +1232,7 @@ static void _sbus_dbus_invoke_in_s_out_raw_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out_s_state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct _sbus_dbus_invoker_args_s out;
     struct {
         enum sbus_handler_type type;
@@ -1314,15 +1290,9 @@ _sbus_dbus_invoke_in_s_out_s_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1332,7 +1302,7 @@ _sbus_dbus_invoke_in_s_out_s_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1374,7 +1344,7 @@ static void _sbus_dbus_invoke_in_s_out_s_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1388,7 +1358,7 @@ static void _sbus_dbus_invoke_in_s_out_s_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1437,7 +1407,7 @@ static void _sbus_dbus_invoke_in_s_out_s_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_s_out_u_state {
-    struct _sbus_dbus_invoker_args_s *in;
+    struct _sbus_dbus_invoker_args_s in;
     struct _sbus_dbus_invoker_args_u out;
     struct {
         enum sbus_handler_type type;
@@ -1495,15 +1465,9 @@ _sbus_dbus_invoke_in_s_out_u_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1513,7 +1477,7 @@ _sbus_dbus_invoke_in_s_out_u_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1555,7 +1519,7 @@ static void _sbus_dbus_invoke_in_s_out_u_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1569,7 +1533,7 @@ static void _sbus_dbus_invoke_in_s_out_u_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1618,7 +1582,7 @@ static void _sbus_dbus_invoke_in_s_out_u_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_ss_out_raw_state {
-    struct _sbus_dbus_invoker_args_ss *in;
+    struct _sbus_dbus_invoker_args_ss in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -1675,15 +1639,9 @@ _sbus_dbus_invoke_in_ss_out_raw_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_ss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_ss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_ss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1693,7 +1651,7 @@ _sbus_dbus_invoke_in_ss_out_raw_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1735,7 +1693,7 @@ static void _sbus_dbus_invoke_in_ss_out_raw_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->write_iterator);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
         if (ret != EOK) {
             goto done;
         }
@@ -1748,7 +1706,7 @@ static void _sbus_dbus_invoke_in_ss_out_raw_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->write_iterator);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->write_iterator);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1791,7 +1749,7 @@ static void _sbus_dbus_invoke_in_ss_out_raw_done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_sss_out__state {
-    struct _sbus_dbus_invoker_args_sss *in;
+    struct _sbus_dbus_invoker_args_sss in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -1848,15 +1806,9 @@ _sbus_dbus_invoke_in_sss_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_sss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_sss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_sss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1866,7 +1818,7 @@ _sbus_dbus_invoke_in_sss_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1908,7 +1860,7 @@ static void _sbus_dbus_invoke_in_sss_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -1921,7 +1873,7 @@ static void _sbus_dbus_invoke_in_sss_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1964,7 +1916,7 @@ static void _sbus_dbus_invoke_in_sss_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_dbus_invoke_in_su_out_u_state {
-    struct _sbus_dbus_invoker_args_su *in;
+    struct _sbus_dbus_invoker_args_su in;
     struct _sbus_dbus_invoker_args_u out;
     struct {
         enum sbus_handler_type type;
@@ -2022,15 +1974,9 @@ _sbus_dbus_invoke_in_su_out_u_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_dbus_invoker_args_su);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_dbus_invoker_read_su(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_dbus_invoker_borrow_su(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2040,7 +1986,7 @@ _sbus_dbus_invoke_in_su_out_u_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2082,7 +2028,7 @@ static void _sbus_dbus_invoke_in_su_out_u_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -2096,7 +2042,7 @@ static void _sbus_dbus_invoke_in_su_out_u_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
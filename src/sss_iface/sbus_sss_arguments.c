@@ -56,6 +56,45 @@ errno_t _sbus_sss_invoker_write_as
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_read_asau
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_au(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_sss_invoker_write_asau
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_as(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_au(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_b
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -114,6 +153,19 @@ errno_t _sbus_sss_invoker_write_o
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_o
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_o *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_OBJECT_PATH) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_pam_data
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -201,6 +253,19 @@ errno_t _sbus_sss_invoker_write_q
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_q
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_q *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT16) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_qus
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -250,6 +315,31 @@ errno_t _sbus_sss_invoker_write_qus
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_qus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_qus *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT16) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_s
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -279,6 +369,19 @@ errno_t _sbus_sss_invoker_write_s
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_s *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_sqq
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -328,6 +431,31 @@ errno_t _sbus_sss_invoker_write_sqq
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_sqq
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_sqq *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT16) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT16) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_ss
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -367,6 +495,25 @@ errno_t _sbus_sss_invoker_write_ss
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_ss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_ssau
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -445,6 +592,19 @@ errno_t _sbus_sss_invoker_write_u
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_u *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_us
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -484,6 +644,25 @@ errno_t _sbus_sss_invoker_write_us
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_us
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_us *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_usq
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -533,6 +712,31 @@ errno_t _sbus_sss_invoker_write_usq
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_usq
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_usq *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT16) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_uss
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -582,6 +786,31 @@ errno_t _sbus_sss_invoker_write_uss
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_uss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_uus
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -631,6 +860,31 @@ errno_t _sbus_sss_invoker_write_uus
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_uus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uus *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_uusss
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -700,6 +954,43 @@ errno_t _sbus_sss_invoker_write_uusss
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_uusss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uusss *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg3);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg4);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
 errno_t _sbus_sss_invoker_read_uuus
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -759,3 +1050,34 @@ errno_t _sbus_sss_invoker_write_uuus
     return EOK;
 }
 
+errno_t _sbus_sss_invoker_borrow_uuus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uuus *args)
+{
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg0);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg1);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_UINT32) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg2);
+    dbus_message_iter_next(iter);
+
+    if (dbus_message_iter_get_arg_type(iter) != DBUS_TYPE_STRING) {
+        return ERR_SBUS_INVALID_TYPE;
+    }
+    dbus_message_iter_get_basic(iter, &args->arg3);
+    dbus_message_iter_next(iter);
+
+    return EOK;
+}
+
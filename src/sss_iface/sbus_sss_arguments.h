@@ -43,6 +43,22 @@ _sbus_sss_invoker_write_as
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_as *args);
 
+struct _sbus_sss_invoker_args_asau {
+    const char ** arg0;
+    uint32_t * arg1;
+};
+
+errno_t
+_sbus_sss_invoker_read_asau
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args);
+
+errno_t
+_sbus_sss_invoker_write_asau
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args);
+
 struct _sbus_sss_invoker_args_b {
     bool arg0;
 };
@@ -73,6 +89,13 @@ _sbus_sss_invoker_write_o
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_o *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_o
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_o *args);
+
 struct _sbus_sss_invoker_args_pam_data {
     struct pam_data * arg0;
 };
@@ -118,6 +141,13 @@ _sbus_sss_invoker_write_q
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_q *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_q
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_q *args);
+
 struct _sbus_sss_invoker_args_qus {
     uint16_t arg0;
     uint32_t arg1;
@@ -135,6 +165,13 @@ _sbus_sss_invoker_write_qus
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_qus *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_qus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_qus *args);
+
 struct _sbus_sss_invoker_args_s {
     const char * arg0;
 };
@@ -150,6 +187,13 @@ _sbus_sss_invoker_write_s
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_s *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_s
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_s *args);
+
 struct _sbus_sss_invoker_args_sqq {
     const char * arg0;
     uint16_t arg1;
@@ -167,6 +211,13 @@ _sbus_sss_invoker_write_sqq
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_sqq *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_sqq
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_sqq *args);
+
 struct _sbus_sss_invoker_args_ss {
     const char * arg0;
     const char * arg1;
@@ -183,6 +234,13 @@ _sbus_sss_invoker_write_ss
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_ss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_ss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_ss *args);
+
 struct _sbus_sss_invoker_args_ssau {
     const char * arg0;
     const char * arg1;
@@ -215,6 +273,13 @@ _sbus_sss_invoker_write_u
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_u *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_u
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_u *args);
+
 struct _sbus_sss_invoker_args_us {
     uint32_t arg0;
     const char * arg1;
@@ -231,6 +296,13 @@ _sbus_sss_invoker_write_us
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_us *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_us
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_us *args);
+
 struct _sbus_sss_invoker_args_usq {
     uint32_t arg0;
     const char * arg1;
@@ -248,6 +320,13 @@ _sbus_sss_invoker_write_usq
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_usq *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_usq
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_usq *args);
+
 struct _sbus_sss_invoker_args_uss {
     uint32_t arg0;
     const char * arg1;
@@ -265,6 +344,13 @@ _sbus_sss_invoker_write_uss
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_uss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_uss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uss *args);
+
 struct _sbus_sss_invoker_args_uus {
     uint32_t arg0;
     uint32_t arg1;
@@ -282,6 +368,13 @@ _sbus_sss_invoker_write_uus
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_uus *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_uus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uus *args);
+
 struct _sbus_sss_invoker_args_uusss {
     uint32_t arg0;
     uint32_t arg1;
@@ -301,6 +394,13 @@ _sbus_sss_invoker_write_uusss
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_uusss *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_uusss
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uusss *args);
+
 struct _sbus_sss_invoker_args_uuus {
     uint32_t arg0;
     uint32_t arg1;
@@ -319,4 +419,11 @@ _sbus_sss_invoker_write_uuus
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_uuus *args);
 
+/* Read arguments without copying them. Strings point into the message
+ * and are valid only as long as the message exists. */
+errno_t
+_sbus_sss_invoker_borrow_uuus
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_uuus *args);
+
 #endif /* _SBUS_SSS_ARGUMENTS_H_ */
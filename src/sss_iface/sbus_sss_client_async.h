@@ -160,6 +160,34 @@ sbus_call_dp_failover_ListServices_recv
      struct tevent_req *req,
      const char *** _services);
 
+struct tevent_req *
+sbus_call_dp_failover_ServerLatency_send
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_service_name);
+
+errno_t
+sbus_call_dp_failover_ServerLatency_recv
+    (TALLOC_CTX *mem_ctx,
+     struct tevent_req *req,
+     const char *** _servers,
+     uint32_t ** _latency);
+
+struct tevent_req *
+sbus_call_metrics_Dump_send
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_connection *conn,
+     const char *busname,
+     const char *object_path);
+
+errno_t
+sbus_call_metrics_Dump_recv
+    (TALLOC_CTX *mem_ctx,
+     struct tevent_req *req,
+     const char ** _metrics);
+
 struct tevent_req *
 sbus_call_proxy_auth_PAM_send
     (TALLOC_CTX *mem_ctx,
@@ -411,6 +439,18 @@ errno_t
 sbus_call_nss_memcache_InvalidateGroupById_recv
     (struct tevent_req *req);
 
+struct tevent_req *
+sbus_call_nss_memcache_InvalidateUserById_send
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t arg_uid);
+
+errno_t
+sbus_call_nss_memcache_InvalidateUserById_recv
+    (struct tevent_req *req);
+
 struct tevent_req *
 sbus_call_nss_memcache_UpdateInitgroups_send
     (TALLOC_CTX *mem_ctx,
@@ -353,6 +353,56 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: sssd.DataProvider.Failover.ServerLatency */
+#define SBUS_METHOD_SYNC_sssd_DataProvider_Failover_ServerLatency(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char ***, uint32_t **); \
+    sbus_method_sync("ServerLatency", \
+        &_sbus_sss_args_sssd_DataProvider_Failover_ServerLatency, \
+        NULL, \
+        _sbus_sss_invoke_in_s_out_asau_send, \
+        _sbus_sss_key_s_0, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_sssd_DataProvider_Failover_ServerLatency(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, uint32_t **); \
+    sbus_method_async("ServerLatency", \
+        &_sbus_sss_args_sssd_DataProvider_Failover_ServerLatency, \
+        NULL, \
+        _sbus_sss_invoke_in_s_out_asau_send, \
+        _sbus_sss_key_s_0, \
+        (handler_send), (handler_recv), (data)); \
+})
+
+/* Interface: sssd.Metrics */
+#define SBUS_IFACE_sssd_Metrics(methods, signals, properties) ({ \
+    sbus_interface("sssd.Metrics", NULL, \
+        (methods), (signals), (properties)); \
+})
+
+/* Method: sssd.Metrics.Dump */
+#define SBUS_METHOD_SYNC_sssd_Metrics_Dump(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **); \
+    sbus_method_sync("Dump", \
+        &_sbus_sss_args_sssd_Metrics_Dump, \
+        NULL, \
+        _sbus_sss_invoke_in__out_s_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_sssd_Metrics_Dump(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data)); \
+    SBUS_CHECK_RECV((handler_recv), const char **); \
+    sbus_method_async("Dump", \
+        &_sbus_sss_args_sssd_Metrics_Dump, \
+        NULL, \
+        _sbus_sss_invoke_in__out_s_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Interface: sssd.ProxyChild.Auth */
 #define SBUS_IFACE_sssd_ProxyChild_Auth(methods, signals, properties) ({ \
     sbus_interface("sssd.ProxyChild.Auth", NULL, \
@@ -791,6 +841,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: sssd.nss.MemoryCache.InvalidateUserById */
+#define SBUS_METHOD_SYNC_sssd_nss_MemoryCache_InvalidateUserById(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), uint32_t); \
+    sbus_method_sync("InvalidateUserById", \
+        &_sbus_sss_args_sssd_nss_MemoryCache_InvalidateUserById, \
+        NULL, \
+        _sbus_sss_invoke_in_u_out__send, \
+        _sbus_sss_key_u_0, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_sssd_nss_MemoryCache_InvalidateUserById(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), uint32_t); \
+    SBUS_CHECK_RECV((handler_recv)); \
+    sbus_method_async("InvalidateUserById", \
+        &_sbus_sss_args_sssd_nss_MemoryCache_InvalidateUserById, \
+        NULL, \
+        _sbus_sss_invoke_in_u_out__send, \
+        _sbus_sss_key_u_0, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: sssd.nss.MemoryCache.UpdateInitgroups */
 #define SBUS_METHOD_SYNC_sssd_nss_MemoryCache_UpdateInitgroups(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char *, uint32_t *); \
@@ -213,8 +213,175 @@ static void _sbus_sss_invoke_in__out__done(struct tevent_req *subreq)
     return;
 }
 
+struct _sbus_sss_invoke_in__out_s_state {
+    struct _sbus_sss_invoker_args_s out;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char **);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char **);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_sss_invoke_in__out_s_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_sss_invoke_in__out_s_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_sss_invoke_in__out_s_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_sss_invoke_in__out_s_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_sss_invoke_in__out_s_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_sss_invoke_in__out_s_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, NULL, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_sss_invoke_in__out_s_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_sss_invoke_in__out_s_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_sss_invoke_in__out_s_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, &state->out.arg0);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = _sbus_sss_invoker_write_s(state->write_iterator, &state->out);
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_sss_invoke_in__out_s_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_sss_invoke_in__out_s_done(struct tevent_req *subreq)
+{
+    struct _sbus_sss_invoke_in__out_s_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_sss_invoke_in__out_s_state);
+
+    ret = state->handler.recv(state, subreq, &state->out.arg0);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = _sbus_sss_invoker_write_s(state->write_iterator, &state->out);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
 struct _sbus_sss_invoke_in_pam_data_out_pam_response_state {
-    struct _sbus_sss_invoker_args_pam_data *in;
+    struct _sbus_sss_invoker_args_pam_data in;
     struct _sbus_sss_invoker_args_pam_response out;
     struct {
         enum sbus_handler_type type;
@@ -272,15 +439,7 @@ _sbus_sss_invoke_in_pam_data_out_pam_response_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_pam_data);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_pam_data(state, read_iterator, state->in);
+    ret = _sbus_sss_invoker_read_pam_data(state, read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -290,7 +449,7 @@ _sbus_sss_invoke_in_pam_data_out_pam_response_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -332,7 +491,7 @@ static void _sbus_sss_invoke_in_pam_data_out_pam_response_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -346,7 +505,7 @@ static void _sbus_sss_invoke_in_pam_data_out_pam_response_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -562,7 +721,7 @@ static void _sbus_sss_invoke_in_raw_out_qus_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_s_out__state {
-    struct _sbus_sss_invoker_args_s *in;
+    struct _sbus_sss_invoker_args_s in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -619,15 +778,9 @@ _sbus_sss_invoke_in_s_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -637,7 +790,7 @@ _sbus_sss_invoke_in_s_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -679,7 +832,7 @@ static void _sbus_sss_invoke_in_s_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -692,7 +845,7 @@ static void _sbus_sss_invoke_in_s_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -735,7 +888,7 @@ static void _sbus_sss_invoke_in_s_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_s_out_as_state {
-    struct _sbus_sss_invoker_args_s *in;
+    struct _sbus_sss_invoker_args_s in;
     struct _sbus_sss_invoker_args_as out;
     struct {
         enum sbus_handler_type type;
@@ -793,15 +946,9 @@ _sbus_sss_invoke_in_s_out_as_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -811,7 +958,7 @@ _sbus_sss_invoke_in_s_out_as_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -853,7 +1000,7 @@ static void _sbus_sss_invoke_in_s_out_as_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -867,7 +1014,7 @@ static void _sbus_sss_invoke_in_s_out_as_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -915,8 +1062,183 @@ static void _sbus_sss_invoke_in_s_out_as_done(struct tevent_req *subreq)
     return;
 }
 
+struct _sbus_sss_invoke_in_s_out_asau_state {
+    struct _sbus_sss_invoker_args_s in;
+    struct _sbus_sss_invoker_args_asau out;
+    struct {
+        enum sbus_handler_type type;
+        void *data;
+        errno_t (*sync)(TALLOC_CTX *, struct sbus_request *, void *, const char *, const char ***, uint32_t **);
+        struct tevent_req * (*send)(TALLOC_CTX *, struct tevent_context *, struct sbus_request *, void *, const char *);
+        errno_t (*recv)(TALLOC_CTX *, struct tevent_req *, const char ***, uint32_t **);
+    } handler;
+
+    struct sbus_request *sbus_req;
+    DBusMessageIter *read_iterator;
+    DBusMessageIter *write_iterator;
+};
+
+static void
+_sbus_sss_invoke_in_s_out_asau_step
+    (struct tevent_context *ev,
+     struct tevent_timer *te,
+     struct timeval tv,
+     void *private_data);
+
+static void
+_sbus_sss_invoke_in_s_out_asau_done
+   (struct tevent_req *subreq);
+
+struct tevent_req *
+_sbus_sss_invoke_in_s_out_asau_send
+   (TALLOC_CTX *mem_ctx,
+    struct tevent_context *ev,
+    struct sbus_request *sbus_req,
+    sbus_invoker_keygen keygen,
+    const struct sbus_handler *handler,
+    DBusMessageIter *read_iterator,
+    DBusMessageIter *write_iterator,
+    const char **_key)
+{
+    struct _sbus_sss_invoke_in_s_out_asau_state *state;
+    struct tevent_req *req;
+    const char *key;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct _sbus_sss_invoke_in_s_out_asau_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->handler.type = handler->type;
+    state->handler.data = handler->data;
+    state->handler.sync = handler->sync;
+    state->handler.send = handler->async_send;
+    state->handler.recv = handler->async_recv;
+
+    state->sbus_req = sbus_req;
+    state->read_iterator = read_iterator;
+    state->write_iterator = write_iterator;
+
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_invoker_schedule(state, ev, _sbus_sss_invoke_in_s_out_asau_step, req);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (_key != NULL) {
+        *_key = talloc_steal(mem_ctx, key);
+    }
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void _sbus_sss_invoke_in_s_out_asau_step
+   (struct tevent_context *ev,
+    struct tevent_timer *te,
+    struct timeval tv,
+    void *private_data)
+{
+    struct _sbus_sss_invoke_in_s_out_asau_state *state;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_sss_invoke_in_s_out_asau_state);
+
+    switch (state->handler.type) {
+    case SBUS_HANDLER_SYNC:
+        if (state->handler.sync == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: sync handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0, &state->out.arg1);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        ret = _sbus_sss_invoker_write_asau(state->write_iterator, &state->out);
+        goto done;
+    case SBUS_HANDLER_ASYNC:
+        if (state->handler.send == NULL || state->handler.recv == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Bug: async handler is not specified!\n");
+            ret = ERR_INTERNAL;
+            goto done;
+        }
+
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, _sbus_sss_invoke_in_s_out_asau_done, req);
+        ret = EAGAIN;
+        goto done;
+    }
+
+    ret = ERR_INTERNAL;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void _sbus_sss_invoke_in_s_out_asau_done(struct tevent_req *subreq)
+{
+    struct _sbus_sss_invoke_in_s_out_asau_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct _sbus_sss_invoke_in_s_out_asau_state);
+
+    ret = state->handler.recv(state, subreq, &state->out.arg0, &state->out.arg1);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = _sbus_sss_invoker_write_asau(state->write_iterator, &state->out);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
 struct _sbus_sss_invoke_in_s_out_b_state {
-    struct _sbus_sss_invoker_args_s *in;
+    struct _sbus_sss_invoker_args_s in;
     struct _sbus_sss_invoker_args_b out;
     struct {
         enum sbus_handler_type type;
@@ -974,15 +1296,9 @@ _sbus_sss_invoke_in_s_out_b_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -992,7 +1308,7 @@ _sbus_sss_invoke_in_s_out_b_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1034,7 +1350,7 @@ static void _sbus_sss_invoke_in_s_out_b_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1048,7 +1364,7 @@ static void _sbus_sss_invoke_in_s_out_b_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1097,7 +1413,7 @@ static void _sbus_sss_invoke_in_s_out_b_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_s_out_qus_state {
-    struct _sbus_sss_invoker_args_s *in;
+    struct _sbus_sss_invoker_args_s in;
     struct _sbus_sss_invoker_args_qus out;
     struct {
         enum sbus_handler_type type;
@@ -1155,15 +1471,9 @@ _sbus_sss_invoke_in_s_out_qus_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1173,7 +1483,7 @@ _sbus_sss_invoke_in_s_out_qus_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1215,7 +1525,7 @@ static void _sbus_sss_invoke_in_s_out_qus_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0, &state->out.arg1, &state->out.arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0, &state->out.arg1, &state->out.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -1229,7 +1539,7 @@ static void _sbus_sss_invoke_in_s_out_qus_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1278,7 +1588,7 @@ static void _sbus_sss_invoke_in_s_out_qus_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_s_out_s_state {
-    struct _sbus_sss_invoker_args_s *in;
+    struct _sbus_sss_invoker_args_s in;
     struct _sbus_sss_invoker_args_s out;
     struct {
         enum sbus_handler_type type;
@@ -1336,15 +1646,9 @@ _sbus_sss_invoke_in_s_out_s_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_s);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_s(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_s(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1354,7 +1658,7 @@ _sbus_sss_invoke_in_s_out_s_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1396,7 +1700,7 @@ static void _sbus_sss_invoke_in_s_out_s_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1410,7 +1714,7 @@ static void _sbus_sss_invoke_in_s_out_s_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1459,7 +1763,7 @@ static void _sbus_sss_invoke_in_s_out_s_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_sqq_out_q_state {
-    struct _sbus_sss_invoker_args_sqq *in;
+    struct _sbus_sss_invoker_args_sqq in;
     struct _sbus_sss_invoker_args_q out;
     struct {
         enum sbus_handler_type type;
@@ -1517,15 +1821,9 @@ _sbus_sss_invoke_in_sqq_out_q_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_sqq);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_sqq(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_sqq(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1535,7 +1833,7 @@ _sbus_sss_invoke_in_sqq_out_q_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1577,7 +1875,7 @@ static void _sbus_sss_invoke_in_sqq_out_q_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1591,7 +1889,7 @@ static void _sbus_sss_invoke_in_sqq_out_q_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1640,7 +1938,7 @@ static void _sbus_sss_invoke_in_sqq_out_q_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_ss_out_o_state {
-    struct _sbus_sss_invoker_args_ss *in;
+    struct _sbus_sss_invoker_args_ss in;
     struct _sbus_sss_invoker_args_o out;
     struct {
         enum sbus_handler_type type;
@@ -1698,15 +1996,9 @@ _sbus_sss_invoke_in_ss_out_o_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_ss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_ss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_ss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1716,7 +2008,7 @@ _sbus_sss_invoke_in_ss_out_o_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1758,7 +2050,7 @@ static void _sbus_sss_invoke_in_ss_out_o_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, &state->out.arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, &state->out.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -1772,7 +2064,7 @@ static void _sbus_sss_invoke_in_ss_out_o_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1821,7 +2113,7 @@ static void _sbus_sss_invoke_in_ss_out_o_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_ssau_out__state {
-    struct _sbus_sss_invoker_args_ssau *in;
+    struct _sbus_sss_invoker_args_ssau in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -1878,15 +2170,7 @@ _sbus_sss_invoke_in_ssau_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_ssau);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_ssau(state, read_iterator, state->in);
+    ret = _sbus_sss_invoker_read_ssau(state, read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -1896,7 +2180,7 @@ _sbus_sss_invoke_in_ssau_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -1938,7 +2222,7 @@ static void _sbus_sss_invoke_in_ssau_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -1951,7 +2235,7 @@ static void _sbus_sss_invoke_in_ssau_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -1994,7 +2278,7 @@ static void _sbus_sss_invoke_in_ssau_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_u_out__state {
-    struct _sbus_sss_invoker_args_u *in;
+    struct _sbus_sss_invoker_args_u in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -2051,15 +2335,9 @@ _sbus_sss_invoke_in_u_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_u);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_u(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_u(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2069,7 +2347,7 @@ _sbus_sss_invoke_in_u_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2111,7 +2389,7 @@ static void _sbus_sss_invoke_in_u_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0);
         if (ret != EOK) {
             goto done;
         }
@@ -2124,7 +2402,7 @@ static void _sbus_sss_invoke_in_u_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2167,7 +2445,7 @@ static void _sbus_sss_invoke_in_u_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_us_out__state {
-    struct _sbus_sss_invoker_args_us *in;
+    struct _sbus_sss_invoker_args_us in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -2224,15 +2502,9 @@ _sbus_sss_invoke_in_us_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_us);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_us(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_us(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2242,7 +2514,7 @@ _sbus_sss_invoke_in_us_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2284,7 +2556,7 @@ static void _sbus_sss_invoke_in_us_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (ret != EOK) {
             goto done;
         }
@@ -2297,7 +2569,7 @@ static void _sbus_sss_invoke_in_us_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2340,7 +2612,7 @@ static void _sbus_sss_invoke_in_us_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_usq_out__state {
-    struct _sbus_sss_invoker_args_usq *in;
+    struct _sbus_sss_invoker_args_usq in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -2397,15 +2669,9 @@ _sbus_sss_invoke_in_usq_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_usq);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_usq(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_usq(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2415,7 +2681,7 @@ _sbus_sss_invoke_in_usq_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2457,7 +2723,7 @@ static void _sbus_sss_invoke_in_usq_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -2470,7 +2736,7 @@ static void _sbus_sss_invoke_in_usq_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2513,7 +2779,7 @@ static void _sbus_sss_invoke_in_usq_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_uss_out__state {
-    struct _sbus_sss_invoker_args_uss *in;
+    struct _sbus_sss_invoker_args_uss in;
     struct {
         enum sbus_handler_type type;
         void *data;
@@ -2570,15 +2836,9 @@ _sbus_sss_invoke_in_uss_out__send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_uss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_uss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_uss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2588,7 +2848,7 @@ _sbus_sss_invoke_in_uss_out__send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2630,7 +2890,7 @@ static void _sbus_sss_invoke_in_uss_out__step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -2643,7 +2903,7 @@ static void _sbus_sss_invoke_in_uss_out__step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2686,7 +2946,7 @@ static void _sbus_sss_invoke_in_uss_out__done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_uss_out_qus_state {
-    struct _sbus_sss_invoker_args_uss *in;
+    struct _sbus_sss_invoker_args_uss in;
     struct _sbus_sss_invoker_args_qus out;
     struct {
         enum sbus_handler_type type;
@@ -2744,15 +3004,9 @@ _sbus_sss_invoke_in_uss_out_qus_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_uss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_uss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_uss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2762,7 +3016,7 @@ _sbus_sss_invoke_in_uss_out_qus_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2804,7 +3058,7 @@ static void _sbus_sss_invoke_in_uss_out_qus_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, &state->out.arg0, &state->out.arg1, &state->out.arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, &state->out.arg0, &state->out.arg1, &state->out.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -2818,7 +3072,7 @@ static void _sbus_sss_invoke_in_uss_out_qus_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -2867,7 +3121,7 @@ static void _sbus_sss_invoke_in_uss_out_qus_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_uus_out_qus_state {
-    struct _sbus_sss_invoker_args_uus *in;
+    struct _sbus_sss_invoker_args_uus in;
     struct _sbus_sss_invoker_args_qus out;
     struct {
         enum sbus_handler_type type;
@@ -2925,15 +3179,9 @@ _sbus_sss_invoke_in_uus_out_qus_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_uus);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_uus(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_uus(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -2943,7 +3191,7 @@ _sbus_sss_invoke_in_uus_out_qus_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -2985,7 +3233,7 @@ static void _sbus_sss_invoke_in_uus_out_qus_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, &state->out.arg0, &state->out.arg1, &state->out.arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, &state->out.arg0, &state->out.arg1, &state->out.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -2999,7 +3247,7 @@ static void _sbus_sss_invoke_in_uus_out_qus_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -3048,7 +3296,7 @@ static void _sbus_sss_invoke_in_uus_out_qus_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_uusss_out_qus_state {
-    struct _sbus_sss_invoker_args_uusss *in;
+    struct _sbus_sss_invoker_args_uusss in;
     struct _sbus_sss_invoker_args_qus out;
     struct {
         enum sbus_handler_type type;
@@ -3106,15 +3354,9 @@ _sbus_sss_invoke_in_uusss_out_qus_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_uusss);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_uusss(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_uusss(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -3124,7 +3366,7 @@ _sbus_sss_invoke_in_uusss_out_qus_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -3166,7 +3408,7 @@ static void _sbus_sss_invoke_in_uusss_out_qus_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, state->in->arg3, state->in->arg4, &state->out.arg0, &state->out.arg1, &state->out.arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3, state->in.arg4, &state->out.arg0, &state->out.arg1, &state->out.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -3180,7 +3422,7 @@ static void _sbus_sss_invoke_in_uusss_out_qus_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, state->in->arg3, state->in->arg4);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3, state->in.arg4);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
@@ -3229,7 +3471,7 @@ static void _sbus_sss_invoke_in_uusss_out_qus_done(struct tevent_req *subreq)
 }
 
 struct _sbus_sss_invoke_in_uuus_out_qus_state {
-    struct _sbus_sss_invoker_args_uuus *in;
+    struct _sbus_sss_invoker_args_uuus in;
     struct _sbus_sss_invoker_args_qus out;
     struct {
         enum sbus_handler_type type;
@@ -3287,15 +3529,9 @@ _sbus_sss_invoke_in_uuus_out_qus_send
     state->read_iterator = read_iterator;
     state->write_iterator = write_iterator;
 
-    state->in = talloc_zero(state, struct _sbus_sss_invoker_args_uuus);
-    if (state->in == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE,
-              "Unable to allocate space for input parameters!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = _sbus_sss_invoker_read_uuus(state, read_iterator, state->in);
+    /* The message is kept alive by the router until this request is
+     * finished so the arguments do not need to be copied. */
+    ret = _sbus_sss_invoker_borrow_uuus(read_iterator, &state->in);
     if (ret != EOK) {
         goto done;
     }
@@ -3305,7 +3541,7 @@ _sbus_sss_invoke_in_uuus_out_qus_send
         goto done;
     }
 
-    ret = sbus_request_key(state, keygen, sbus_req, state->in, &key);
+    ret = sbus_request_key(state, keygen, sbus_req, &state->in, &key);
     if (ret != EOK) {
         goto done;
     }
@@ -3347,7 +3583,7 @@ static void _sbus_sss_invoke_in_uuus_out_qus_step
             goto done;
         }
 
-        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, state->in->arg3, &state->out.arg0, &state->out.arg1, &state->out.arg2);
+        ret = state->handler.sync(state, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3, &state->out.arg0, &state->out.arg1, &state->out.arg2);
         if (ret != EOK) {
             goto done;
         }
@@ -3361,7 +3597,7 @@ static void _sbus_sss_invoke_in_uuus_out_qus_step
             goto done;
         }
 
-        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in->arg0, state->in->arg1, state->in->arg2, state->in->arg3);
+        subreq = state->handler.send(state, ev, state->sbus_req, state->handler.data, state->in.arg0, state->in.arg1, state->in.arg2, state->in.arg3);
         if (subreq == NULL) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
             ret = ENOMEM;
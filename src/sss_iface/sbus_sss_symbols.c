@@ -178,6 +178,30 @@ _sbus_sss_args_sssd_DataProvider_Failover_ListServices = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_sss_args_sssd_DataProvider_Failover_ServerLatency = {
+    .input = (const struct sbus_argument[]){
+        {.type = "s", .name = "service_name"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "as", .name = "servers"},
+        {.type = "au", .name = "latency"},
+        {NULL}
+    }
+};
+
+const struct sbus_method_arguments
+_sbus_sss_args_sssd_Metrics_Dump = {
+    .input = (const struct sbus_argument[]){
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "s", .name = "metrics"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_sss_args_sssd_ProxyChild_Auth_PAM = {
     .input = (const struct sbus_argument[]){
@@ -404,6 +428,17 @@ _sbus_sss_args_sssd_nss_MemoryCache_InvalidateGroupById = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_sss_args_sssd_nss_MemoryCache_InvalidateUserById = {
+    .input = (const struct sbus_argument[]){
+        {.type = "u", .name = "uid"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_sss_args_sssd_nss_MemoryCache_UpdateInitgroups = {
     .input = (const struct sbus_argument[]){
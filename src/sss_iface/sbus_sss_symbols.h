@@ -61,6 +61,12 @@ _sbus_sss_args_sssd_DataProvider_Failover_ListServers;
 extern const struct sbus_method_arguments
 _sbus_sss_args_sssd_DataProvider_Failover_ListServices;
 
+extern const struct sbus_method_arguments
+_sbus_sss_args_sssd_DataProvider_Failover_ServerLatency;
+
+extern const struct sbus_method_arguments
+_sbus_sss_args_sssd_Metrics_Dump;
+
 extern const struct sbus_method_arguments
 _sbus_sss_args_sssd_ProxyChild_Auth_PAM;
 
@@ -115,6 +121,9 @@ _sbus_sss_args_sssd_nss_MemoryCache_InvalidateAllUsers;
 extern const struct sbus_method_arguments
 _sbus_sss_args_sssd_nss_MemoryCache_InvalidateGroupById;
 
+extern const struct sbus_method_arguments
+_sbus_sss_args_sssd_nss_MemoryCache_InvalidateUserById;
+
 extern const struct sbus_method_arguments
 _sbus_sss_args_sssd_nss_MemoryCache_UpdateInitgroups;
 
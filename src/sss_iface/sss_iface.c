@@ -23,6 +23,7 @@
 #include <resolv.h>
 
 #include "util/util.h"
+#include "util/sss_metrics.h"
 #include "sbus/sbus.h"
 #include "sbus/sbus_opath.h"
 #include "sss_iface/sss_iface_async.h"
@@ -39,6 +40,17 @@ sss_iface_domain_address(TALLOC_CTX *mem_ctx,
     return talloc_asprintf(mem_ctx, SSS_BACKEND_ADDRESS, head->name);
 }
 
+char *
+sss_iface_domain_ipc_path(TALLOC_CTX *mem_ctx,
+                          struct sss_domain_info *domain)
+{
+    struct sss_domain_info *head;
+
+    head = get_domains_head(domain);
+
+    return talloc_asprintf(mem_ctx, SSS_BACKEND_IPC_PATH, head->name);
+}
+
 char *
 sss_iface_domain_bus(TALLOC_CTX *mem_ctx,
                      struct sss_domain_info *domain)
@@ -125,6 +137,47 @@ sss_iface_connect_address(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+static errno_t
+sss_monitor_metrics_dump(TALLOC_CTX *mem_ctx,
+                         struct sbus_request *sbus_req,
+                         void *no_data,
+                         const char **_metrics)
+{
+    char *metrics;
+
+    metrics = sss_metrics_dump(mem_ctx);
+    if (metrics == NULL) {
+        return ENOMEM;
+    }
+
+    *_metrics = metrics;
+
+    return EOK;
+}
+
+static errno_t
+sss_monitor_register_metrics_iface(struct sbus_connection *conn)
+{
+    errno_t ret;
+
+    SBUS_INTERFACE(iface_metrics,
+        sssd_Metrics,
+        SBUS_METHODS(
+            SBUS_SYNC(METHOD, sssd_Metrics, Dump, sss_monitor_metrics_dump, NULL)
+        ),
+        SBUS_SIGNALS(SBUS_NO_SIGNALS),
+        SBUS_PROPERTIES(SBUS_NO_PROPERTIES)
+    );
+
+    ret = sbus_connection_add_path(conn, SSS_BUS_PATH, &iface_metrics);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to register metrics interface "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+    }
+
+    return ret;
+}
+
 static void
 sss_monitor_service_init_done(struct tevent_req *req);
 
@@ -151,6 +204,12 @@ sss_monitor_service_init(TALLOC_CTX *mem_ctx,
         return ret;
     }
 
+    /* Every service exports its metrics over the monitor connection. */
+    ret = sss_monitor_register_metrics_iface(conn);
+    if (ret != EOK) {
+        goto done;
+    }
+
     req = sbus_call_monitor_RegisterService_send(conn, conn, SSS_BUS_MONITOR,
                                                  SSS_BUS_PATH, svc_name,
                                                  svc_version, svc_type);
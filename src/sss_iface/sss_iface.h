@@ -32,6 +32,7 @@
 
 #define SSS_MONITOR_ADDRESS "unix:path=" PIPE_PATH "/private/sbus-monitor"
 #define SSS_BACKEND_ADDRESS "unix:path=" PIPE_PATH "/private/sbus-dp_%s"
+#define SSS_BACKEND_IPC_PATH PIPE_PATH "/private/dp_ipc_%s"
 
 #define SSS_BUS_MONITOR     "sssd.monitor"
 #define SSS_BUS_AUTOFS      "sssd.autofs"
@@ -67,6 +68,13 @@ char *
 sss_iface_domain_address(TALLOC_CTX *mem_ctx,
                          struct sss_domain_info *domain);
 
+/**
+ * Return path of the domain binary IPC socket, see sss_iface_ipc.h.
+ */
+char *
+sss_iface_domain_ipc_path(TALLOC_CTX *mem_ctx,
+                          struct sss_domain_info *domain);
+
 /**
  * Return domain bus name.
  */
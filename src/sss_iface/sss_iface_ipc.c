@@ -0,0 +1,521 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <talloc.h>
+#include <tevent.h>
+
+#include "util/util.h"
+#include "util/dlinklist.h"
+#include "sss_iface/sss_iface_ipc.h"
+
+/* Frame encoding and decoding */
+
+static size_t sss_ipc_string_size(const char *str)
+{
+    return sizeof(uint32_t) + (str == NULL ? 0 : strlen(str) + 1);
+}
+
+static void sss_ipc_set_string(uint8_t *buf, const char *str, size_t *_p)
+{
+    uint32_t len;
+
+    len = str == NULL ? 0 : strlen(str) + 1;
+    SAFEALIGN_SET_UINT32(&buf[*_p], len, _p);
+    if (len != 0) {
+        SAFEALIGN_SET_STRING(&buf[*_p], str, len, _p);
+    }
+}
+
+static errno_t sss_ipc_get_string(uint8_t *body,
+                                  size_t len,
+                                  size_t *_p,
+                                  const char **_str)
+{
+    uint32_t str_len;
+
+    SAFEALIGN_COPY_UINT32_CHECK(&str_len, &body[*_p], len, _p);
+    if (str_len == 0) {
+        *_str = NULL;
+        return EOK;
+    }
+
+    if (str_len > len - *_p) {
+        return EINVAL;
+    }
+
+    /* exactly one NUL at the end */
+    if (memchr(&body[*_p], '\0', str_len) != &body[*_p + str_len - 1]) {
+        return EINVAL;
+    }
+
+    *_str = (const char *)&body[*_p];
+    *_p += str_len;
+
+    return EOK;
+}
+
+static errno_t sss_ipc_frame_new(TALLOC_CTX *mem_ctx,
+                                 enum sss_ipc_msg_type type,
+                                 uint32_t serial,
+                                 size_t body_len,
+                                 uint8_t **_frame,
+                                 size_t *_p)
+{
+    uint8_t *frame;
+    size_t len;
+
+    if (body_len > SSS_IPC_MAX_FRAME - SSS_IPC_HEADER_LEN) {
+        DEBUG(SSSDBG_OP_FAILURE, "Message of %zu bytes is too long\n",
+              body_len);
+        return EMSGSIZE;
+    }
+
+    len = SSS_IPC_HEADER_LEN + body_len;
+    frame = talloc_size(mem_ctx, len);
+    if (frame == NULL) {
+        return ENOMEM;
+    }
+
+    *_p = 0;
+    SAFEALIGN_SET_UINT32(&frame[*_p], len, _p);
+    SAFEALIGN_SET_UINT32(&frame[*_p], type, _p);
+    SAFEALIGN_SET_UINT32(&frame[*_p], serial, _p);
+    SAFEALIGN_SET_UINT32(&frame[*_p], 0, _p);
+
+    *_frame = frame;
+
+    return EOK;
+}
+
+size_t sss_ipc_frame_len(const uint8_t *frame)
+{
+    uint32_t len;
+
+    SAFEALIGN_COPY_UINT32(&len, frame, NULL);
+
+    return len;
+}
+
+errno_t sss_ipc_account_req_encode(TALLOC_CTX *mem_ctx,
+                                   uint32_t serial,
+                                   const struct sss_ipc_account_req *msg,
+                                   uint8_t **_frame)
+{
+    uint8_t *frame;
+    size_t p;
+    errno_t ret;
+
+    ret = sss_ipc_frame_new(mem_ctx, SSS_IPC_GET_ACCOUNT_INFO, serial,
+                            2 * sizeof(uint32_t)
+                                + sss_ipc_string_size(msg->filter)
+                                + sss_ipc_string_size(msg->domain)
+                                + sss_ipc_string_size(msg->extra),
+                            &frame, &p);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    SAFEALIGN_SET_UINT32(&frame[p], msg->dp_flags, &p);
+    SAFEALIGN_SET_UINT32(&frame[p], msg->entry_type, &p);
+    sss_ipc_set_string(frame, msg->filter, &p);
+    sss_ipc_set_string(frame, msg->domain, &p);
+    sss_ipc_set_string(frame, msg->extra, &p);
+
+    *_frame = frame;
+
+    return EOK;
+}
+
+errno_t sss_ipc_account_req_decode(uint8_t *body,
+                                   size_t len,
+                                   struct sss_ipc_account_req *msg)
+{
+    size_t p = 0;
+    errno_t ret;
+
+    SAFEALIGN_COPY_UINT32_CHECK(&msg->dp_flags, &body[p], len, &p);
+    SAFEALIGN_COPY_UINT32_CHECK(&msg->entry_type, &body[p], len, &p);
+
+    ret = sss_ipc_get_string(body, len, &p, &msg->filter);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_ipc_get_string(body, len, &p, &msg->domain);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_ipc_get_string(body, len, &p, &msg->extra);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return p == len ? EOK : EINVAL;
+}
+
+errno_t sss_ipc_account_reply_encode(TALLOC_CTX *mem_ctx,
+                                     uint32_t serial,
+                                     const struct sss_ipc_account_reply *msg,
+                                     uint8_t **_frame)
+{
+    uint8_t *frame;
+    size_t p;
+    errno_t ret;
+
+    ret = sss_ipc_frame_new(mem_ctx, SSS_IPC_GET_ACCOUNT_INFO_REPLY, serial,
+                            2 * sizeof(uint32_t)
+                                + sss_ipc_string_size(msg->error_message),
+                            &frame, &p);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* dp_error is sent as uint32_t to keep the strings aligned */
+    SAFEALIGN_SET_UINT32(&frame[p], msg->dp_error, &p);
+    SAFEALIGN_SET_UINT32(&frame[p], msg->error, &p);
+    sss_ipc_set_string(frame, msg->error_message, &p);
+
+    *_frame = frame;
+
+    return EOK;
+}
+
+errno_t sss_ipc_account_reply_decode(uint8_t *body,
+                                     size_t len,
+                                     struct sss_ipc_account_reply *msg)
+{
+    uint32_t dp_error;
+    size_t p = 0;
+    errno_t ret;
+
+    SAFEALIGN_COPY_UINT32_CHECK(&dp_error, &body[p], len, &p);
+    SAFEALIGN_COPY_UINT32_CHECK(&msg->error, &body[p], len, &p);
+
+    if (dp_error > UINT16_MAX) {
+        return EINVAL;
+    }
+    msg->dp_error = dp_error;
+
+    ret = sss_ipc_get_string(body, len, &p, &msg->error_message);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return p == len ? EOK : EINVAL;
+}
+
+errno_t sss_ipc_error_reply_encode(TALLOC_CTX *mem_ctx,
+                                   uint32_t serial,
+                                   errno_t error,
+                                   uint8_t **_frame)
+{
+    uint8_t *frame;
+    size_t p;
+    errno_t ret;
+
+    ret = sss_ipc_frame_new(mem_ctx, SSS_IPC_ERROR_REPLY, serial,
+                            sizeof(uint32_t), &frame, &p);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    SAFEALIGN_SET_UINT32(&frame[p], error, &p);
+
+    *_frame = frame;
+
+    return EOK;
+}
+
+errno_t sss_ipc_error_reply_decode(uint8_t *body,
+                                   size_t len,
+                                   errno_t *_error)
+{
+    uint32_t error;
+    size_t p = 0;
+
+    SAFEALIGN_COPY_UINT32_CHECK(&error, &body[p], len, &p);
+    if (p != len) {
+        return EINVAL;
+    }
+
+    /* the request failed, make sure the caller sees it as failed */
+    *_error = error == EOK ? EIO : error;
+
+    return EOK;
+}
+
+/* Connection */
+
+struct sss_ipc_out {
+    struct sss_ipc_out *prev;
+    struct sss_ipc_out *next;
+
+    uint8_t *frame;
+    size_t len;
+    size_t written;
+};
+
+struct sss_ipc_conn {
+    struct tevent_context *ev;
+    struct tevent_fd *fde;
+    int fd;
+
+    sss_ipc_msg_fn msg_fn;
+    sss_ipc_close_fn close_fn;
+    void *pvt;
+
+    /* header of the frame being read */
+    uint8_t header[SSS_IPC_HEADER_LEN];
+    size_t header_read;
+
+    /* the frame being read, NULL while the header is incomplete */
+    uint8_t *in;
+    size_t in_len;
+    size_t in_read;
+
+    /* frames waiting to be written */
+    struct sss_ipc_out *out;
+};
+
+static errno_t sss_ipc_conn_write(struct sss_ipc_conn *conn)
+{
+    struct sss_ipc_out *out;
+    ssize_t len;
+
+    while (conn->out != NULL) {
+        out = conn->out;
+
+        errno = 0;
+        len = write(conn->fd, out->frame + out->written,
+                    out->len - out->written);
+        if (len == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return EAGAIN;
+            }
+            return errno;
+        }
+
+        out->written += len;
+        if (out->written < out->len) {
+            continue;
+        }
+
+        DLIST_REMOVE(conn->out, out);
+        talloc_free(out);
+    }
+
+    TEVENT_FD_NOT_WRITEABLE(conn->fde);
+
+    return EOK;
+}
+
+static errno_t sss_ipc_conn_read(struct sss_ipc_conn *conn,
+                                 uint8_t **_frame)
+{
+    uint32_t len;
+    uint32_t reserved;
+    ssize_t n;
+    size_t p;
+
+    while (conn->in == NULL) {
+        errno = 0;
+        n = read(conn->fd, conn->header + conn->header_read,
+                 SSS_IPC_HEADER_LEN - conn->header_read);
+        if (n == 0) {
+            return ENOTCONN;
+        } else if (n == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return EAGAIN;
+            }
+            return errno;
+        }
+
+        conn->header_read += n;
+        if (conn->header_read < SSS_IPC_HEADER_LEN) {
+            continue;
+        }
+
+        p = 0;
+        SAFEALIGN_COPY_UINT32(&len, &conn->header[p], &p);
+        p = 3 * sizeof(uint32_t);
+        SAFEALIGN_COPY_UINT32(&reserved, &conn->header[p], &p);
+        if (len < SSS_IPC_HEADER_LEN || len > SSS_IPC_MAX_FRAME
+                || reserved != 0) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Invalid frame header\n");
+            return EBADMSG;
+        }
+
+        conn->in = talloc_size(conn, len);
+        if (conn->in == NULL) {
+            return ENOMEM;
+        }
+
+        memcpy(conn->in, conn->header, SSS_IPC_HEADER_LEN);
+        conn->in_len = len;
+        conn->in_read = SSS_IPC_HEADER_LEN;
+    }
+
+    while (conn->in_read < conn->in_len) {
+        errno = 0;
+        n = read(conn->fd, conn->in + conn->in_read,
+                 conn->in_len - conn->in_read);
+        if (n == 0) {
+            return ENOTCONN;
+        } else if (n == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return EAGAIN;
+            }
+            return errno;
+        }
+
+        conn->in_read += n;
+    }
+
+    *_frame = conn->in;
+    conn->in = NULL;
+    conn->header_read = 0;
+
+    return EOK;
+}
+
+static void sss_ipc_conn_handler(struct tevent_context *ev,
+                                 struct tevent_fd *fde,
+                                 uint16_t flags,
+                                 void *pvt)
+{
+    struct sss_ipc_conn *conn;
+    uint8_t *frame;
+    uint32_t len;
+    uint32_t type;
+    uint32_t serial;
+    size_t p = 0;
+    errno_t ret;
+
+    conn = talloc_get_type(pvt, struct sss_ipc_conn);
+
+    if (flags & TEVENT_FD_WRITE) {
+        ret = sss_ipc_conn_write(conn);
+        if (ret != EOK && ret != EAGAIN) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to write frame [%d]: %s\n",
+                  ret, sss_strerror(ret));
+            goto fail;
+        }
+    }
+
+    if (!(flags & TEVENT_FD_READ)) {
+        return;
+    }
+
+    ret = sss_ipc_conn_read(conn, &frame);
+    if (ret == EAGAIN) {
+        return;
+    } else if (ret == ENOTCONN) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Peer closed the connection\n");
+        goto fail;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to read frame [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto fail;
+    }
+
+    SAFEALIGN_COPY_UINT32(&len, &frame[p], &p);
+    SAFEALIGN_COPY_UINT32(&type, &frame[p], &p);
+    SAFEALIGN_COPY_UINT32(&serial, &frame[p], &p);
+
+    /* The handler may free the connection. */
+    conn->msg_fn(conn, type, serial, frame, frame + SSS_IPC_HEADER_LEN,
+                 len - SSS_IPC_HEADER_LEN, conn->pvt);
+    return;
+
+fail:
+    conn->close_fn(conn, conn->pvt);
+}
+
+static int sss_ipc_conn_destructor(struct sss_ipc_conn *conn)
+{
+    /* remove the fd from the event loop before closing it */
+    talloc_zfree(conn->fde);
+
+    if (conn->fd != -1) {
+        close(conn->fd);
+    }
+
+    return 0;
+}
+
+struct sss_ipc_conn *sss_ipc_conn_create(TALLOC_CTX *mem_ctx,
+                                         struct tevent_context *ev,
+                                         int fd,
+                                         sss_ipc_msg_fn msg_fn,
+                                         sss_ipc_close_fn close_fn,
+                                         void *pvt)
+{
+    struct sss_ipc_conn *conn;
+    errno_t ret;
+
+    conn = talloc_zero(mem_ctx, struct sss_ipc_conn);
+    if (conn == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    conn->ev = ev;
+    conn->fd = fd;
+    conn->msg_fn = msg_fn;
+    conn->close_fn = close_fn;
+    conn->pvt = pvt;
+    talloc_set_destructor(conn, sss_ipc_conn_destructor);
+
+    ret = sss_fd_nonblocking(fd);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to set fd non-blocking "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        talloc_free(conn);
+        return NULL;
+    }
+
+    conn->fde = tevent_add_fd(ev, conn, fd, TEVENT_FD_READ,
+                              sss_ipc_conn_handler, conn);
+    if (conn->fde == NULL) {
+        talloc_free(conn);
+        return NULL;
+    }
+
+    return conn;
+}
+
+errno_t sss_ipc_conn_send(struct sss_ipc_conn *conn, uint8_t *frame)
+{
+    struct sss_ipc_out *out;
+
+    out = talloc_zero(conn, struct sss_ipc_out);
+    if (out == NULL) {
+        talloc_free(frame);
+        return ENOMEM;
+    }
+
+    out->frame = talloc_steal(out, frame);
+    out->len = sss_ipc_frame_len(frame);
+
+    DLIST_ADD_END(conn->out, out, struct sss_ipc_out *);
+    TEVENT_FD_WRITEABLE(conn->fde);
+
+    return EOK;
+}
@@ -0,0 +1,141 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SSS_IFACE_IPC_H_
+#define _SSS_IFACE_IPC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <talloc.h>
+#include <tevent.h>
+
+#include "util/util_errors.h"
+
+/*
+ * Binary responder to backend transport
+ *
+ * When dp_binary_ipc is enabled, the backend listens on an additional
+ * private socket next to its sbus socket and the responders send the
+ * account requests there instead of marshalling them as D-Bus messages.
+ * Everything else (registration, control plane, all other methods) still
+ * goes through sbus.
+ *
+ * Every message is a frame:
+ *
+ * frame  = header body
+ * header = uint32_t length   (of the whole frame, header included)
+ *          uint32_t type     (enum sss_ipc_msg_type)
+ *          uint32_t serial   (copied from the request to its reply)
+ *          uint32_t reserved (must be 0)
+ *
+ * Integers are in host byte order since both peers run on the same host.
+ * Strings are stored as uint32_t length (terminating NUL included, 0 for
+ * NULL) followed by the string. The decoded strings point into the frame,
+ * so the frame must outlive them.
+ */
+
+#define SSS_IPC_HEADER_LEN  (4 * sizeof(uint32_t))
+#define SSS_IPC_MAX_FRAME   (64 * 1024)
+
+enum sss_ipc_msg_type {
+    /* body: struct sss_ipc_account_req */
+    SSS_IPC_GET_ACCOUNT_INFO = 1,
+    /* body: struct sss_ipc_account_reply */
+    SSS_IPC_GET_ACCOUNT_INFO_REPLY = 2,
+    /* body: uint32_t error code, the request failed */
+    SSS_IPC_ERROR_REPLY = 3,
+};
+
+struct sss_ipc_account_req {
+    uint32_t dp_flags;
+    uint32_t entry_type;
+    const char *filter;
+    const char *domain;
+    const char *extra;
+};
+
+struct sss_ipc_account_reply {
+    uint16_t dp_error;
+    uint32_t error;
+    const char *error_message;
+};
+
+errno_t sss_ipc_account_req_encode(TALLOC_CTX *mem_ctx,
+                                   uint32_t serial,
+                                   const struct sss_ipc_account_req *msg,
+                                   uint8_t **_frame);
+
+errno_t sss_ipc_account_req_decode(uint8_t *body,
+                                   size_t len,
+                                   struct sss_ipc_account_req *msg);
+
+errno_t sss_ipc_account_reply_encode(TALLOC_CTX *mem_ctx,
+                                     uint32_t serial,
+                                     const struct sss_ipc_account_reply *msg,
+                                     uint8_t **_frame);
+
+errno_t sss_ipc_account_reply_decode(uint8_t *body,
+                                     size_t len,
+                                     struct sss_ipc_account_reply *msg);
+
+errno_t sss_ipc_error_reply_encode(TALLOC_CTX *mem_ctx,
+                                   uint32_t serial,
+                                   errno_t error,
+                                   uint8_t **_frame);
+
+errno_t sss_ipc_error_reply_decode(uint8_t *body,
+                                   size_t len,
+                                   errno_t *_error);
+
+/* Length of an encoded frame. */
+size_t sss_ipc_frame_len(const uint8_t *frame);
+
+/*
+ * Connection
+ *
+ * Frames are read and written on a non-blocking stream socket. Each
+ * complete frame is passed to the message handler which takes ownership
+ * of it (the frame is a talloc chunk). When the peer closes the
+ * connection or sends something that is not a valid frame, the close
+ * handler is called; it is expected to free the connection.
+ */
+
+struct sss_ipc_conn;
+
+typedef void (*sss_ipc_msg_fn)(struct sss_ipc_conn *conn,
+                               uint32_t type,
+                               uint32_t serial,
+                               uint8_t *frame,
+                               uint8_t *body,
+                               size_t body_len,
+                               void *pvt);
+
+typedef void (*sss_ipc_close_fn)(struct sss_ipc_conn *conn,
+                                 void *pvt);
+
+/* The connection takes ownership of @fd. */
+struct sss_ipc_conn *sss_ipc_conn_create(TALLOC_CTX *mem_ctx,
+                                         struct tevent_context *ev,
+                                         int fd,
+                                         sss_ipc_msg_fn msg_fn,
+                                         sss_ipc_close_fn close_fn,
+                                         void *pvt);
+
+/* Queue @frame for sending, the connection takes ownership of it. */
+errno_t sss_ipc_conn_send(struct sss_ipc_conn *conn, uint8_t *frame);
+
+#endif /* _SSS_IFACE_IPC_H_ */
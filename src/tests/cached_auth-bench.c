@@ -0,0 +1,273 @@
+/*
+   SSSD
+
+   Benchmark of password hashing for cached authentication
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <talloc.h>
+#include <tevent.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "util/crypto/sss_crypto.h"
+#include "util/sss_hash_pool.h"
+
+/* Verifies a burst of passwords the way sysdb_cache_auth_send() does it,
+ * once in the main loop and once in the worker threads. Besides the
+ * throughput it reports the longest time the event loop was not able to
+ * run a 1 ms timer, which is what every other request of the process would
+ * have to wait for. */
+
+#define DEFAULT_REQUESTS    200
+#define DEFAULT_ROUNDS      5000
+#define DEFAULT_PASSWORD    "bench.password.1234"
+
+struct bench_ctx {
+    struct tevent_context *ev;
+    const char *expected;
+    int finished;
+    errno_t error;
+
+    struct timespec last_tick;
+    double max_stall;
+};
+
+static double bench_elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+           + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void bench_tick(struct bench_ctx *bctx)
+{
+    double stall;
+
+    stall = bench_elapsed(&bctx->last_tick);
+    if (stall > bctx->max_stall) {
+        bctx->max_stall = stall;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &bctx->last_tick);
+}
+
+static void bench_timer(struct tevent_context *ev,
+                        struct tevent_timer *te,
+                        struct timeval tv,
+                        void *pvt)
+{
+    struct bench_ctx *bctx = talloc_get_type(pvt, struct bench_ctx);
+
+    bench_tick(bctx);
+
+    te = tevent_add_timer(ev, bctx, tevent_timeval_current_ofs(0, 1000),
+                          bench_timer, bctx);
+    if (te == NULL) {
+        bctx->error = ENOMEM;
+    }
+}
+
+static void bench_done(struct tevent_req *req)
+{
+    struct bench_ctx *bctx = tevent_req_callback_data(req, struct bench_ctx);
+    char *hash;
+    errno_t ret;
+
+    ret = sss_hash_pool_sha512_recv(bctx, req, &hash);
+    talloc_free(req);
+    if (ret != EOK) {
+        bctx->error = ret;
+    } else if (strcmp(hash, bctx->expected) != 0) {
+        bctx->error = EINVAL;
+    }
+
+    bctx->finished++;
+}
+
+static errno_t bench_run(TALLOC_CTX *mem_ctx,
+                         struct sss_hash_pool *pool,
+                         struct tevent_context *ev,
+                         const char *label,
+                         int requests,
+                         const char *password,
+                         const char *expected)
+{
+    struct bench_ctx *bctx;
+    struct tevent_timer *te;
+    struct tevent_req *req;
+    struct timespec start;
+    double elapsed;
+    errno_t ret;
+    int i;
+
+    bctx = talloc_zero(mem_ctx, struct bench_ctx);
+    if (bctx == NULL) {
+        return ENOMEM;
+    }
+
+    bctx->ev = ev;
+    bctx->expected = expected;
+
+    te = tevent_add_timer(ev, bctx, tevent_timeval_current_ofs(0, 1000),
+                          bench_timer, bctx);
+    if (te == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bctx->last_tick = start;
+
+    for (i = 0; i < requests; i++) {
+        req = sss_hash_pool_sha512_send(bctx, ev, pool, password,
+                                        strlen(password), expected);
+        if (req == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+        tevent_req_set_callback(req, bench_done, bctx);
+    }
+
+    while (bctx->finished < requests && bctx->error == EOK) {
+        if (tevent_loop_once(ev) != 0) {
+            ret = EIO;
+            goto done;
+        }
+    }
+
+    elapsed = bench_elapsed(&start);
+    bench_tick(bctx);
+
+    ret = bctx->error;
+    if (ret != EOK) {
+        goto done;
+    }
+
+    printf("%-8s %d hashes in %.3f s, %.1f per second, "
+           "event loop blocked for up to %.1f ms\n",
+           label, requests, elapsed, requests / elapsed,
+           bctx->max_stall * 1e3);
+
+done:
+    talloc_free(bctx);
+    return ret;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_requests = DEFAULT_REQUESTS;
+    int pc_threads = 0;
+    int pc_rounds = DEFAULT_ROUNDS;
+    const char *pc_password = DEFAULT_PASSWORD;
+    struct tevent_context *ev;
+    struct sss_hash_pool *pool;
+    TALLOC_CTX *ctx;
+    char *setting;
+    char *expected;
+    int ret;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "requests", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_requests, 0,
+                    "Number of concurrent authentications", NULL },
+        { "threads", 't', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_threads, 0,
+                    "Number of worker threads, 0 for the default", NULL },
+        { "rounds", 'R', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_rounds, 0,
+                    "Number of SHA512 rounds", NULL },
+        { "password", 'p', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_password, 0,
+                    "Password to hash", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_requests <= 0 || pc_threads < 0 || pc_rounds <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    ctx = talloc_new(NULL);
+    if (ctx == NULL) {
+        return 1;
+    }
+
+    ev = tevent_context_init(ctx);
+    if (ev == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* the cached hash the passwords are verified against */
+    ret = s3crypt_gen_setting(ctx, pc_rounds, &setting);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = s3crypt_sha512(ctx, pc_password, setting, &expected);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_hash_pool_init(ctx, ev, pc_threads, &pool);
+    if (ret != EOK) {
+        fprintf(stderr, "Unable to start the pool: %s\n", sss_strerror(ret));
+        goto done;
+    }
+
+    ret = bench_run(ctx, NULL, ev, "inline", pc_requests,
+                    pc_password, expected);
+    if (ret != EOK) {
+        fprintf(stderr, "Inline hashing failed: %s\n", sss_strerror(ret));
+        goto done;
+    }
+
+    ret = bench_run(ctx, pool, ev, "pool", pc_requests,
+                    pc_password, expected);
+    if (ret != EOK) {
+        fprintf(stderr, "Pool hashing failed: %s\n", sss_strerror(ret));
+        goto done;
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(ctx);
+    return ret == EOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
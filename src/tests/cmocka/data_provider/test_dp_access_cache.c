@@ -0,0 +1,382 @@
+/*
+    SSSD
+
+    Tests for the cache of access control decisions
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <talloc.h>
+#include <tevent.h>
+#include <errno.h>
+#include <popt.h>
+#include <security/pam_appl.h>
+#include <security/pam_modules.h>
+
+#include "providers/backend.h"
+#include "providers/data_provider/dp_private.h"
+#include "providers/data_provider/dp_iface.h"
+#include "providers/data_provider/dp.h"
+#include "util/sss_pam_data.h"
+#include "tests/cmocka/common_mock.h"
+#include "tests/common.h"
+#include "tests/cmocka/common_mock_be.h"
+#include "tests/cmocka/data_provider/mock_dp.h"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_dp_access_cache.ldb"
+#define TEST_DOM_NAME "dp_access_cache_test"
+#define TEST_ID_PROVIDER "ldap"
+
+#define TEST_USER "test_user"
+#define TEST_SERVICE "sshd"
+#define TEST_TIMEOUT 1
+
+struct test_ctx {
+    struct sss_test_ctx *tctx;
+    struct be_ctx *be_ctx;
+    struct data_provider *provider;
+
+    /* result of the access handler */
+    int access_status;
+    bool access_response;
+
+    size_t access_calls;
+    size_t selinux_calls;
+
+    /* status of the last PAM request */
+    int pam_status;
+};
+
+bool __wrap_be_is_offline(struct be_ctx *ctx)
+{
+    return false;
+}
+
+struct test_handler_state {
+    struct pam_data *pd;
+};
+
+static struct tevent_req *
+test_handler_send(TALLOC_CTX *mem_ctx,
+                  struct test_ctx *test_ctx,
+                  struct pam_data *pd,
+                  struct dp_req_params *params)
+{
+    struct test_handler_state *state;
+    struct tevent_req *req;
+    uint8_t data = 0;
+    int ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct test_handler_state);
+    if (req == NULL) {
+        return NULL;
+    }
+
+    state->pd = pd;
+
+    if (params->target == DPT_ACCESS) {
+        test_ctx->access_calls++;
+        pd->pam_status = test_ctx->access_status;
+        if (test_ctx->access_response) {
+            ret = pam_add_response(pd, SSS_PAM_USER_INFO, 1, &data);
+            assert_int_equal(ret, EOK);
+        }
+    } else {
+        /* SELinux handler, it always adds its own response. */
+        test_ctx->selinux_calls++;
+        ret = pam_add_response(pd, SSS_PAM_USER_INFO, 1, &data);
+        assert_int_equal(ret, EOK);
+    }
+
+    tevent_req_done(req);
+    tevent_req_post(req, params->ev);
+
+    return req;
+}
+
+static errno_t
+test_handler_recv(TALLOC_CTX *mem_ctx,
+                  struct tevent_req *req,
+                  struct pam_data **_data)
+{
+    struct test_handler_state *state;
+
+    state = tevent_req_data(req, struct test_handler_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_data = talloc_steal(mem_ctx, state->pd);
+
+    return EOK;
+}
+
+static void test_set_handler(struct test_ctx *test_ctx,
+                             enum dp_targets target,
+                             enum dp_methods method)
+{
+    struct dp_method *dp_methods;
+
+    dp_methods = mock_dp_get_methods(test_ctx->provider, target);
+
+    dp_set_method(dp_methods, method,
+                  test_handler_send, test_handler_recv, test_ctx,
+                  struct test_ctx, struct pam_data, struct pam_data *);
+}
+
+static void test_pam_done(struct tevent_req *req)
+{
+    struct test_ctx *test_ctx;
+    struct pam_data *pd;
+    errno_t ret;
+
+    test_ctx = tevent_req_callback_data(req, struct test_ctx);
+
+    ret = dp_pam_handler_recv(test_ctx, req, &pd);
+    talloc_zfree(req);
+    if (ret == EOK) {
+        test_ctx->pam_status = pd->pam_status;
+        talloc_free(pd);
+    }
+
+    test_ev_done(test_ctx->tctx, ret);
+}
+
+/* Runs a PAM request and returns its status. */
+static int test_pam_request(struct test_ctx *test_ctx, int cmd)
+{
+    struct tevent_req *req;
+    struct pam_data *pd;
+    errno_t ret;
+
+    pd = create_pam_data(test_ctx);
+    assert_non_null(pd);
+
+    pd->cmd = cmd;
+    pd->domain = talloc_strdup(pd, TEST_DOM_NAME);
+    pd->user = talloc_strdup(pd, TEST_USER);
+    pd->service = talloc_strdup(pd, TEST_SERVICE);
+    assert_non_null(pd->domain);
+    assert_non_null(pd->user);
+    assert_non_null(pd->service);
+
+    req = dp_pam_handler_send(test_ctx, test_ctx->tctx->ev, NULL,
+                              test_ctx->provider, pd);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_pam_done, test_ctx);
+
+    test_ctx->tctx->done = false;
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_int_equal(ret, EOK);
+
+    return test_ctx->pam_status;
+}
+
+static int test_setup(void **state)
+{
+    struct test_ctx *test_ctx;
+    errno_t ret;
+
+    test_ctx = talloc_zero(NULL, struct test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->tctx = create_dom_test_ctx(test_ctx, TESTS_PATH, TEST_CONF_DB,
+                                         TEST_DOM_NAME, TEST_ID_PROVIDER, NULL);
+    assert_non_null(test_ctx->tctx);
+
+    test_ctx->be_ctx = mock_be_ctx(test_ctx, test_ctx->tctx);
+    test_ctx->provider = mock_dp(test_ctx, test_ctx->be_ctx);
+
+    ret = sss_hash_create(test_ctx->provider, 0,
+                          &test_ctx->provider->access_cache.table);
+    assert_int_equal(ret, EOK);
+    test_ctx->provider->access_cache.timeout = TEST_TIMEOUT;
+
+    test_ctx->access_status = PAM_SUCCESS;
+    test_set_handler(test_ctx, DPT_ACCESS, DPM_ACCESS_HANDLER);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int test_teardown(void **state)
+{
+    talloc_zfree(*state);
+    return 0;
+}
+
+void test_dp_access_cache_hit(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+    assert_int_equal(test_ctx->selinux_calls, 0);
+}
+
+void test_dp_access_cache_hit_selinux(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+
+    test_set_handler(test_ctx, DPT_SELINUX, DPM_SELINUX_HANDLER);
+
+    /* The response of the SELinux handler must not prevent caching. */
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+    assert_int_equal(test_ctx->selinux_calls, 1);
+
+    /* Only the access check is skipped on a hit. */
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+    assert_int_equal(test_ctx->selinux_calls, 2);
+}
+
+void test_dp_access_cache_expire(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    hash_table_t *table = test_ctx->provider->access_cache.table;
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+    assert_int_equal(hash_count(table), 1);
+
+    while (hash_count(table) != 0) {
+        tevent_loop_once(test_ctx->tctx->ev);
+    }
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 2);
+}
+
+void test_dp_access_cache_invalidate(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 1);
+
+    dp_access_cache_invalidate(test_ctx->provider);
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 2);
+
+    /* The new decision is cached again. */
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 2);
+}
+
+void test_dp_access_cache_denied(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+
+    test_ctx->access_status = PAM_PERM_DENIED;
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_PERM_DENIED);
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_PERM_DENIED);
+    assert_int_equal(test_ctx->access_calls, 2);
+
+    /* The user is allowed as soon as the account is fixed. */
+    test_ctx->access_status = PAM_SUCCESS;
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 3);
+}
+
+void test_dp_access_cache_response(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+
+    /* e.g. a warning about an upcoming password expiration */
+    test_ctx->access_response = true;
+
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_pam_request(test_ctx, SSS_PAM_ACCT_MGMT),
+                     PAM_SUCCESS);
+    assert_int_equal(test_ctx->access_calls, 2);
+    assert_int_equal(hash_count(test_ctx->provider->access_cache.table), 0);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    int rv;
+    int no_cleanup = 0;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        {"no-cleanup", 'n', POPT_ARG_NONE, &no_cleanup, 0,
+         _("Do not delete the test database after a test run"), NULL },
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_hit,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_hit_selinux,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_expire,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_invalidate,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_denied,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_dp_access_cache_response,
+                                        test_setup, test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    /* Even though normally the tests should clean up after themselves
+     * they might not after a failed run. Remove the old DB to be sure */
+    tests_set_cwd();
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    test_dom_suite_setup(TESTS_PATH);
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+    if (rv == 0 && !no_cleanup) {
+        test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    }
+    return rv;
+}
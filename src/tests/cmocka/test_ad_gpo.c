@@ -401,6 +401,79 @@ void test_ad_gpo_parse_sd(void **state)
     talloc_free(sd);
 }
 
+/*
+ * Test the key of the cached DACL filtering results
+ */
+void test_ad_gpo_dacl_key(void **state)
+{
+    errno_t ret;
+    enum idmap_error_code err;
+    struct sss_idmap_ctx *idmap_ctx;
+    struct gp_gpo *gpos[2];
+    hash_table_t *trustees;
+    char *key1;
+    char *key2;
+
+    /* trustees of test_sid_data include the Domain Admins and the
+     * Authenticated Users SIDs */
+    const char *host_sid = "S-1-5-21-1898687337-2196588786-2775055786-2102";
+    const char *groups1[] = {"S-1-5-21-1622805210-1442095631-4165424053-512",
+                             "S-1-5-21-2-3-4",
+                             AD_AUTHENTICATED_USERS_SID};
+    const char *groups2[] = {AD_AUTHENTICATED_USERS_SID,
+                             "S-1-5-21-2-3-5",
+                             "S-1-5-21-1622805210-1442095631-4165424053-512"};
+    const char *groups3[] = {"S-1-5-21-2-3-5"};
+
+    err = sss_idmap_init(sss_idmap_talloc, test_ctx, sss_idmap_talloc_free,
+                         &idmap_ctx);
+    assert_int_equal(err, IDMAP_SUCCESS);
+
+    gpos[0] = talloc_zero(test_ctx, struct gp_gpo);
+    assert_non_null(gpos[0]);
+    gpos[1] = NULL;
+
+    ret = ad_gpo_parse_sd(gpos[0], test_sid_data, sizeof(test_sid_data),
+                          &gpos[0]->gpo_sd);
+    assert_int_equal(ret, EOK);
+
+    ret = ad_gpo_collect_trustees(test_ctx, idmap_ctx, gpos, 1, &trustees);
+    assert_int_equal(ret, EOK);
+
+    /* different users with the same matching SIDs share the key */
+    ret = ad_gpo_dacl_key(test_ctx, trustees, idmap_ctx,
+                          "S-1-5-21-1175337206-4250576914-2321192831-1103",
+                          host_sid, groups1, 3, &key1);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(key1, "S-1-5-11,"
+                        "S-1-5-21-1622805210-1442095631-4165424053-512");
+
+    ret = ad_gpo_dacl_key(test_ctx, trustees, idmap_ctx,
+                          "S-1-5-21-1175337206-4250576914-2321192831-1104",
+                          host_sid, groups2, 3, &key2);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(key1, key2);
+    talloc_free(key2);
+
+    /* no matching SIDs */
+    ret = ad_gpo_dacl_key(test_ctx, trustees, idmap_ctx,
+                          "S-1-5-21-1175337206-4250576914-2321192831-1105",
+                          host_sid, groups3, 1, &key2);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(key2, "");
+    talloc_free(key2);
+
+    /* invalid client SID */
+    ret = ad_gpo_dacl_key(test_ctx, trustees, idmap_ctx, "not-a-sid",
+                          host_sid, groups1, 3, &key2);
+    assert_int_equal(ret, EINVAL);
+
+    talloc_free(key1);
+    talloc_free(trustees);
+    talloc_free(gpos[0]);
+    talloc_free(idmap_ctx);
+}
+
 int main(int argc, const char *argv[])
 {
     poptContext pc;
@@ -442,6 +515,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_ad_gpo_parse_sd,
                                         ad_gpo_test_setup,
                                         ad_gpo_test_teardown),
+        cmocka_unit_test_setup_teardown(test_ad_gpo_dacl_key,
+                                        ad_gpo_test_setup,
+                                        ad_gpo_test_teardown),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
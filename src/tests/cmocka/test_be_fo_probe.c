@@ -0,0 +1,260 @@
+/*
+    SSSD
+
+    Tests for the registration of failover probe plugins
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <talloc.h>
+#include <tevent.h>
+#include <errno.h>
+#include <popt.h>
+
+#include "providers/backend.h"
+#include "tests/cmocka/common_mock.h"
+#include "tests/cmocka/common_mock_be.h"
+#include "tests/common.h"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_be_fo_probe_conf.ldb"
+#define TEST_DOM_NAME "be_fo_probe_test"
+#define TEST_ID_PROVIDER "ldap"
+#define TEST_SERVICE "LDAP"
+
+struct test_ctx {
+    struct sss_test_ctx *tctx;
+    struct be_ctx *be_ctx;
+    struct be_svc_data *svc;
+
+    int generic_pvt;
+    int specific_pvt;
+};
+
+static struct tevent_req *
+test_generic_probe_send(TALLOC_CTX *mem_ctx,
+                        struct tevent_context *ev,
+                        struct be_ctx *be_ctx,
+                        const char *service_name,
+                        struct fo_server *server,
+                        void *pvt)
+{
+    return NULL;
+}
+
+static errno_t test_generic_probe_recv(struct tevent_req *req)
+{
+    return EOK;
+}
+
+static struct tevent_req *
+test_specific_probe_send(TALLOC_CTX *mem_ctx,
+                         struct tevent_context *ev,
+                         struct be_ctx *be_ctx,
+                         const char *service_name,
+                         struct fo_server *server,
+                         void *pvt)
+{
+    return NULL;
+}
+
+static errno_t test_specific_probe_recv(struct tevent_req *req)
+{
+    return EOK;
+}
+
+static errno_t set_generic(struct test_ctx *test_ctx)
+{
+    return be_fo_set_probe_plugin(test_ctx->be_ctx, TEST_SERVICE,
+                                  test_generic_probe_send,
+                                  test_generic_probe_recv,
+                                  &test_ctx->generic_pvt,
+                                  BE_FO_PROBE_PRIORITY_GENERIC,
+                                  "generic");
+}
+
+static errno_t set_specific(struct test_ctx *test_ctx)
+{
+    return be_fo_set_probe_plugin(test_ctx->be_ctx, TEST_SERVICE,
+                                  test_specific_probe_send,
+                                  test_specific_probe_recv,
+                                  &test_ctx->specific_pvt,
+                                  BE_FO_PROBE_PRIORITY_SPECIFIC,
+                                  "specific");
+}
+
+static void assert_specific(struct test_ctx *test_ctx)
+{
+    assert_ptr_equal(test_ctx->svc->probe_send_fn, test_specific_probe_send);
+    assert_ptr_equal(test_ctx->svc->probe_recv_fn, test_specific_probe_recv);
+    assert_ptr_equal(test_ctx->svc->probe_pvt, &test_ctx->specific_pvt);
+}
+
+static int test_setup(void **state)
+{
+    struct test_ctx *test_ctx;
+    errno_t ret;
+
+    test_ctx = talloc_zero(NULL, struct test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->tctx = create_dom_test_ctx(test_ctx, TESTS_PATH, TEST_CONF_DB,
+                                         TEST_DOM_NAME, TEST_ID_PROVIDER,
+                                         NULL);
+    assert_non_null(test_ctx->tctx);
+
+    test_ctx->be_ctx = mock_be_ctx(test_ctx, test_ctx->tctx);
+    assert_non_null(test_ctx->be_ctx);
+
+    ret = be_init_failover(test_ctx->be_ctx);
+    assert_int_equal(ret, EOK);
+
+    ret = be_fo_add_service(test_ctx->be_ctx, TEST_SERVICE, NULL);
+    assert_int_equal(ret, EOK);
+
+    test_ctx->svc = test_ctx->be_ctx->be_fo->svcs;
+    assert_non_null(test_ctx->svc);
+    assert_string_equal(test_ctx->svc->name, TEST_SERVICE);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int test_teardown(void **state)
+{
+    talloc_zfree(*state);
+    return 0;
+}
+
+void test_be_fo_probe_unknown_service(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    errno_t ret;
+
+    ret = be_fo_set_probe_plugin(test_ctx->be_ctx, "unknown",
+                                 test_generic_probe_send,
+                                 test_generic_probe_recv,
+                                 &test_ctx->generic_pvt,
+                                 BE_FO_PROBE_PRIORITY_GENERIC,
+                                 "generic");
+    assert_int_equal(ret, ENOENT);
+    assert_null(test_ctx->svc->probe_send_fn);
+}
+
+void test_be_fo_probe_generic_then_specific(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    errno_t ret;
+
+    ret = set_generic(test_ctx);
+    assert_int_equal(ret, EOK);
+    assert_ptr_equal(test_ctx->svc->probe_send_fn, test_generic_probe_send);
+
+    ret = set_specific(test_ctx);
+    assert_int_equal(ret, EOK);
+    assert_specific(test_ctx);
+}
+
+void test_be_fo_probe_specific_then_generic(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    errno_t ret;
+
+    ret = set_specific(test_ctx);
+    assert_int_equal(ret, EOK);
+
+    /* The generic probe must not override the specific one. */
+    ret = set_generic(test_ctx);
+    assert_int_equal(ret, EEXIST);
+    assert_specific(test_ctx);
+
+    /* Removing the refused probe keeps the specific one. */
+    be_fo_unset_probe_plugin(test_ctx->be_ctx, TEST_SERVICE,
+                             &test_ctx->generic_pvt);
+    assert_specific(test_ctx);
+}
+
+void test_be_fo_probe_unset(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    errno_t ret;
+
+    ret = set_specific(test_ctx);
+    assert_int_equal(ret, EOK);
+
+    be_fo_unset_probe_plugin(test_ctx->be_ctx, TEST_SERVICE,
+                             &test_ctx->specific_pvt);
+    assert_null(test_ctx->svc->probe_send_fn);
+    assert_null(test_ctx->svc->probe_pvt);
+
+    /* Once the specific probe is gone the generic one can be used. */
+    ret = set_generic(test_ctx);
+    assert_int_equal(ret, EOK);
+    assert_ptr_equal(test_ctx->svc->probe_send_fn, test_generic_probe_send);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    int rv;
+    int no_cleanup = 0;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        {"no-cleanup", 'n', POPT_ARG_NONE, &no_cleanup, 0,
+         _("Do not delete the test database after a test run"), NULL },
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_be_fo_probe_unknown_service,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_be_fo_probe_generic_then_specific,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_be_fo_probe_specific_then_generic,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_be_fo_probe_unset,
+                                        test_setup, test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    /* Even though normally the tests should clean up after themselves
+     * they might not after a failed run. Remove the old DB to be sure */
+    tests_set_cwd();
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    test_dom_suite_setup(TESTS_PATH);
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+    if (rv == 0 && !no_cleanup) {
+        test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    }
+    return rv;
+}
@@ -1686,6 +1686,92 @@ static void test_sss_certmap_get_search_filter(void **state)
     sss_certmap_free_ctx(ctx);
 }
 
+static void test_sss_certmap_cache(void **state)
+{
+    int ret;
+    struct sss_certmap_ctx *ctx;
+    char *filter;
+    char **domains;
+
+    ret = sss_certmap_init(NULL, ext_debug, NULL, &ctx);
+    assert_int_equal(ret, EOK);
+    assert_non_null(ctx);
+
+    ret = sss_certmap_add_rule(ctx, 10, "KRB5:<ISSUER>xyz", NULL, NULL);
+    assert_int_equal(ret, EOK);
+
+    /* lookups do not change the context by default */
+    ret = sss_certmap_match_cert(ctx, discard_const(test_cert_der),
+                                 sizeof(test_cert_der));
+    assert_int_equal(ret, ENOENT);
+    assert_int_equal(ctx->cache_count, 0);
+    assert_null(ctx->cache);
+
+    ret = sss_certmap_enable_cache(ctx);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_certmap_match_cert(ctx, discard_const(test_cert_der),
+                                 sizeof(test_cert_der));
+    assert_int_equal(ret, ENOENT);
+    assert_int_equal(ctx->cache_count, 1);
+    assert_true(ctx->cache->matched);
+    assert_null(ctx->cache->rule);
+
+    /* cached negative result */
+    ret = sss_certmap_match_cert(ctx, discard_const(test_cert_der),
+                                 sizeof(test_cert_der));
+    assert_int_equal(ret, ENOENT);
+    assert_int_equal(ctx->cache_count, 1);
+
+    ret = sss_certmap_match_cert(ctx, discard_const(test_cert2_der),
+                                 sizeof(test_cert2_der));
+    assert_int_equal(ret, ENOENT);
+    assert_int_equal(ctx->cache_count, 2);
+    assert_int_equal(ctx->cache->content->cert_der_size,
+                     sizeof(test_cert2_der));
+
+    /* adding a rule resets the cached results but keeps the content */
+    ret = sss_certmap_add_rule(ctx, 20,
+                            "KRB5:<ISSUER>CN=Certificate Authority,O=IPA.DEVEL",
+                            "LDAP:rule20=<I>{issuer_dn}", NULL);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(ctx->cache_count, 2);
+    assert_false(ctx->cache->matched);
+
+    ret = sss_certmap_get_search_filter(ctx, discard_const(test_cert_der),
+                                        sizeof(test_cert_der),
+                                        &filter, &domains);
+    assert_int_equal(ret, 0);
+    assert_string_equal(filter,
+                        "rule20=<I>CN=Certificate\\20Authority,O=IPA.DEVEL");
+    assert_null(domains);
+    sss_certmap_free_filter_and_domains(filter, domains);
+
+    /* the most recently used certificate is first */
+    assert_int_equal(ctx->cache_count, 2);
+    assert_int_equal(ctx->cache->content->cert_der_size,
+                     sizeof(test_cert_der));
+    assert_true(ctx->cache->matched);
+    assert_non_null(ctx->cache->rule);
+
+    /* a higher priority rule wins over the cached result */
+    ret = sss_certmap_add_rule(ctx, 5,
+                            "KRB5:<ISSUER>CN=Certificate Authority,O=IPA.DEVEL",
+                            "LDAP:rule5=<I>{issuer_dn}", NULL);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_certmap_expand_mapping_rule(ctx, discard_const(test_cert_der),
+                                          sizeof(test_cert_der),
+                                          &filter, &domains);
+    assert_int_equal(ret, 0);
+    assert_string_equal(filter,
+                        "rule5=<I>CN=Certificate Authority,O=IPA.DEVEL");
+    assert_null(domains);
+    sss_certmap_free_filter_and_domains(filter, domains);
+
+    sss_certmap_free_ctx(ctx);
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -1711,6 +1797,7 @@ int main(int argc, const char *argv[])
         cmocka_unit_test(test_sss_certmap_match_cert),
         cmocka_unit_test(test_sss_certmap_add_mapping_rule),
         cmocka_unit_test(test_sss_certmap_get_search_filter),
+        cmocka_unit_test(test_sss_certmap_cache),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
@@ -0,0 +1,481 @@
+/*
+    SSSD
+
+    Tests for the binary trace log encoder and decoder
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <talloc.h>
+#include <errno.h>
+#include <popt.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <limits.h>
+
+/* In order to access the static encoder and decoder functions */
+#include "util/debug_trace.c"
+#include "tools/sssctl/sssctl_trace.c"
+
+#include "tests/cmocka/common_mock.h"
+
+#define TEST_FUNCTION "test_function"
+
+struct test_ctx {
+    struct trace_decoder *dec;
+};
+
+/* sssctl_trace.c is linked without the rest of the tool. */
+errno_t sss_tool_popt_ex(struct sss_cmdline *cmdline,
+                         struct poptOption *options,
+                         enum sss_tool_opt require_option,
+                         sss_popt_fn popt_fn,
+                         void *popt_fn_pvt,
+                         const char *fopt_name,
+                         const char *fopt_help,
+                         const char **_fopt,
+                         bool *_opt_set)
+{
+    return EINVAL;
+}
+
+int parse_debug_level(const char *strlevel)
+{
+    return SSSDBG_INVALID;
+}
+
+static void test_trace(const char *format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    sss_debug_trace_vrecord(TEST_FUNCTION, SSSDBG_TRACE_FUNC, format, ap);
+    va_end(ap);
+}
+
+/* Decodes records until the next message and returns its text. */
+static char *test_decode_next(TALLOC_CTX *mem_ctx,
+                              struct trace_decoder *dec,
+                              uint32_t *_type)
+{
+    struct sss_trace_rec rec;
+    struct sss_trace_msg msg;
+    struct trace_args args;
+    const char *format;
+    errno_t ret;
+
+    while (true) {
+        ret = trace_read(dec, &rec);
+        assert_int_equal(ret, EOK);
+
+        switch (rec.type) {
+        case SSS_TRACE_REC_START:
+            ret = trace_start(dec, rec.len);
+            assert_int_equal(ret, EOK);
+            assert_string_equal(dec->prg_name, debug_prg_name);
+            break;
+        case SSS_TRACE_REC_STRING:
+            ret = trace_string(dec, rec.len);
+            assert_int_equal(ret, EOK);
+            break;
+        case SSS_TRACE_REC_MESSAGE:
+        case SSS_TRACE_REC_TEXT:
+            assert_true(rec.len >= sizeof(msg));
+            memcpy(&msg, dec->payload, sizeof(msg));
+            assert_int_equal(msg.level, SSSDBG_TRACE_FUNC);
+            assert_string_equal(trace_get_string(dec, msg.function_id),
+                                TEST_FUNCTION);
+
+            args.data = dec->payload + sizeof(msg);
+            args.len = rec.len - sizeof(msg);
+
+            *_type = rec.type;
+            if (rec.type == SSS_TRACE_REC_TEXT) {
+                return talloc_strndup(mem_ctx, (const char *)args.data,
+                                      args.len);
+            }
+
+            format = trace_get_string(dec, msg.format_id);
+            assert_non_null(format);
+            return trace_format(mem_ctx, format, &args);
+        default:
+            fail();
+        }
+    }
+}
+
+static void test_decode_message(struct test_ctx *test_ctx,
+                                const char *expected)
+{
+    uint32_t type;
+    char *text;
+
+    text = test_decode_next(test_ctx, test_ctx->dec, &type);
+    assert_non_null(text);
+    assert_int_equal(type, SSS_TRACE_REC_MESSAGE);
+    assert_string_equal(text, expected);
+    talloc_free(text);
+}
+
+static void test_rewind(struct test_ctx *test_ctx)
+{
+    fflush(_trace.file);
+    rewind(_trace.file);
+    test_ctx->dec->file = _trace.file;
+}
+
+/* Creates a decoder reading the given bytes. */
+static void test_set_input(struct test_ctx *test_ctx,
+                           const void *data,
+                           size_t len)
+{
+    if (test_ctx->dec->file != NULL && test_ctx->dec->file != _trace.file) {
+        fclose(test_ctx->dec->file);
+    }
+
+    test_ctx->dec->file = fmemopen(discard_const(data), len, "r");
+    assert_non_null(test_ctx->dec->file);
+}
+
+static int test_setup(void **state)
+{
+    struct test_ctx *test_ctx;
+
+    assert_true(leak_check_setup());
+
+    test_ctx = talloc_zero(global_talloc_context, struct test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->dec = talloc_zero(test_ctx, struct trace_decoder);
+    assert_non_null(test_ctx->dec);
+    test_ctx->dec->path = "test";
+
+    debug_prg_name = "test_debug_trace";
+
+    /* The records are written directly, keep DEBUG() messages of the test
+     * itself out of the file. */
+    _trace.level = 0;
+    _trace.file = tmpfile();
+    assert_non_null(_trace.file);
+    _trace_table_reset();
+    _trace_write_start();
+
+    check_leaks_push(test_ctx);
+    *state = test_ctx;
+    return 0;
+}
+
+static int test_teardown(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+
+    if (test_ctx->dec->file != NULL && test_ctx->dec->file != _trace.file) {
+        fclose(test_ctx->dec->file);
+    }
+
+    _trace_close();
+
+    talloc_zfree(test_ctx->dec->payload);
+    talloc_zfree(test_ctx->dec->strings);
+    talloc_zfree(test_ctx->dec->prg_name);
+    assert_true(check_leaks_pop(test_ctx));
+    talloc_free(test_ctx);
+    assert_true(leak_check_teardown());
+    return 0;
+}
+
+void test_trace_strings(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+
+    test_trace("no arguments\n");
+    test_trace("string [%s]\n", "value");
+    test_trace("null [%s]\n", (const char *)NULL);
+    test_trace("width [%-8s] [%.3s]\n", "left", "truncated");
+    test_trace("percent %% [%s] 100%%\n", "value");
+
+    test_rewind(test_ctx);
+    test_decode_message(test_ctx, "no arguments\n");
+    test_decode_message(test_ctx, "string [value]\n");
+    test_decode_message(test_ctx, "null [(null)]\n");
+    test_decode_message(test_ctx, "width [left    ] [tru]\n");
+    test_decode_message(test_ctx, "percent % [value] 100%\n");
+}
+
+void test_trace_integers(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    char expected[64];
+
+    test_trace("d %d %d\n", -42, INT_MAX);
+    test_trace("u %u\n", 4000000000u);
+    test_trace("ld %ld\n", -1234567890L);
+    test_trace("zu %zu %zu\n", (size_t)7, SIZE_MAX);
+    test_trace("x %x %#08X\n", 0xdeadbeef, 0xabc);
+    test_trace("hhd %hhd hu %hu\n", (signed char)-1, (unsigned short)65535);
+    test_trace("star [%*d] [%.*s]\n", 5, 42, 2, "abcdef");
+
+    test_rewind(test_ctx);
+    test_decode_message(test_ctx, "d -42 2147483647\n");
+    test_decode_message(test_ctx, "u 4000000000\n");
+    test_decode_message(test_ctx, "ld -1234567890\n");
+    snprintf(expected, sizeof(expected), "zu 7 %zu\n", SIZE_MAX);
+    test_decode_message(test_ctx, expected);
+    test_decode_message(test_ctx, "x deadbeef 0X000ABC\n");
+    test_decode_message(test_ctx, "hhd -1 hu 65535\n");
+    test_decode_message(test_ctx, "star [   42] [ab]\n");
+}
+
+void test_trace_pointer(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    char expected[64];
+    void *ptr = test_ctx;
+
+    test_trace("ptr %p [%s]\n", ptr, "after");
+
+    snprintf(expected, sizeof(expected), "ptr %p [after]\n", ptr);
+
+    test_rewind(test_ctx);
+    test_decode_message(test_ctx, expected);
+}
+
+void test_trace_strings_interned_once(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    uint32_t id;
+
+    test_trace("repeated %d\n", 1);
+    id = _trace.next_id;
+    test_trace("repeated %d\n", 2);
+    assert_int_equal(_trace.next_id, id);
+
+    test_rewind(test_ctx);
+    test_decode_message(test_ctx, "repeated 1\n");
+    test_decode_message(test_ctx, "repeated 2\n");
+}
+
+void test_trace_unsupported_format(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    uint32_t type;
+    char *text;
+
+    /* positional arguments are stored as formatted text */
+    test_trace("%2$s %1$s\n", "world", "hello");
+
+    test_rewind(test_ctx);
+    text = test_decode_next(test_ctx, test_ctx->dec, &type);
+    assert_non_null(text);
+    assert_int_equal(type, SSS_TRACE_REC_TEXT);
+    assert_string_equal(text, "hello world\n");
+    talloc_free(text);
+}
+
+void test_trace_write_string_failure(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    const char *str = "interned string";
+    FILE *file;
+    uint32_t id;
+    uint32_t next_id;
+
+    file = _trace.file;
+    next_id = _trace.next_id;
+
+    /* writes to a read only stream fail */
+    _trace.file = fopen("/dev/null", "r");
+    assert_non_null(_trace.file);
+
+    id = _trace_intern(str);
+    assert_int_equal(id, 0);
+    assert_int_equal(_trace.count, 0);
+    assert_int_equal(_trace.next_id, next_id);
+
+    fclose(_trace.file);
+    _trace.file = file;
+
+    /* the string is written once the file is writable again */
+    id = _trace_intern(str);
+    assert_int_equal(id, next_id);
+    assert_int_equal(_trace_intern(str), id);
+    assert_int_equal(_trace.count, 1);
+
+    test_trace("after failure %s\n", "ok");
+
+    test_rewind(test_ctx);
+    test_decode_message(test_ctx, "after failure ok\n");
+    assert_string_equal(trace_get_string(test_ctx->dec, id), str);
+}
+
+void test_trace_corrupt_records(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    struct sss_trace_rec rec;
+    uint8_t data[sizeof(rec) + 16] = { 0 };
+    struct sss_trace_start start = { 0 };
+    uint32_t id;
+    errno_t ret;
+
+    /* record longer than the limit */
+    rec.type = SSS_TRACE_REC_STRING;
+    rec.len = SSS_TRACE_MAX_REC + 1;
+    memcpy(data, &rec, sizeof(rec));
+    test_set_input(test_ctx, data, sizeof(data));
+    ret = trace_read(test_ctx->dec, &rec);
+    assert_int_equal(ret, EBADMSG);
+
+    /* truncated payload is treated as the end of the file */
+    rec.type = SSS_TRACE_REC_STRING;
+    rec.len = 100;
+    memcpy(data, &rec, sizeof(rec));
+    test_set_input(test_ctx, data, sizeof(data));
+    ret = trace_read(test_ctx->dec, &rec);
+    assert_int_equal(ret, ENOENT);
+
+    /* truncated header */
+    test_set_input(test_ctx, data, sizeof(rec) - 1);
+    ret = trace_read(test_ctx->dec, &rec);
+    assert_int_equal(ret, ENOENT);
+
+    /* string record without identifier */
+    talloc_free(test_ctx->dec->payload);
+    test_ctx->dec->payload = talloc_zero_array(test_ctx->dec, uint8_t,
+                                               sizeof(start) + 1);
+    assert_non_null(test_ctx->dec->payload);
+    test_ctx->dec->payload_size = sizeof(start) + 1;
+
+    ret = trace_string(test_ctx->dec, sizeof(id) - 1);
+    assert_int_equal(ret, EBADMSG);
+
+    /* string identifier 0 is reserved */
+    id = 0;
+    memcpy(test_ctx->dec->payload, &id, sizeof(id));
+    ret = trace_string(test_ctx->dec, sizeof(id));
+    assert_int_equal(ret, EBADMSG);
+
+    /* start record too short and with the wrong byte order */
+    ret = trace_start(test_ctx->dec, sizeof(start) - 1);
+    assert_int_equal(ret, EBADMSG);
+
+    start.bom = 0x04030201;
+    memcpy(test_ctx->dec->payload, &start, sizeof(start));
+    ret = trace_start(test_ctx->dec, sizeof(start));
+    assert_int_equal(ret, EBADMSG);
+}
+
+void test_trace_corrupt_arguments(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                      struct test_ctx);
+    struct trace_args args;
+    uint8_t data[16];
+    uint32_t len;
+    char *text;
+
+    /* missing argument */
+    args.data = NULL;
+    args.len = 0;
+    text = trace_format(test_ctx, "value %d\n", &args);
+    assert_non_null(text);
+    assert_string_equal(text, "value <undecodable>%d\n");
+    talloc_free(text);
+
+    /* argument of a different type */
+    data[0] = SSS_TRACE_ARG_PTR;
+    args.data = data;
+    args.len = 1 + sizeof(uint64_t);
+    text = trace_format(test_ctx, "value %d\n", &args);
+    assert_non_null(text);
+    assert_string_equal(text, "value <undecodable>%d\n");
+    talloc_free(text);
+
+    /* string longer than the rest of the record */
+    len = 100;
+    data[0] = SSS_TRACE_ARG_STRING;
+    memcpy(data + 1, &len, sizeof(len));
+    memcpy(data + 1 + sizeof(len), "abc", 3);
+    args.data = data;
+    args.len = 1 + sizeof(len) + 3;
+    text = trace_format(test_ctx, "[%s]\n", &args);
+    assert_non_null(text);
+    assert_string_equal(text, "[<undecodable>%s]\n");
+    talloc_free(text);
+
+    /* truncated integer */
+    data[0] = SSS_TRACE_ARG_INT;
+    args.data = data;
+    args.len = 1 + sizeof(int64_t) - 1;
+    text = trace_format(test_ctx, "%u", &args);
+    assert_non_null(text);
+    assert_string_equal(text, "<undecodable>%u");
+    talloc_free(text);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_trace_strings,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_integers,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_pointer,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_strings_interned_once,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_unsupported_format,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_write_string_failure,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_corrupt_records,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_trace_corrupt_arguments,
+                                        test_setup, test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -26,7 +26,17 @@
 #include "db/sysdb.h"
 #include "tests/cmocka/common_mock.h"
 #include "tests/cmocka/common_mock_resp.h"
+#include "tests/common.h"
 #include "responder/ifp/ifp_private.h"
+#include "responder/ifp/ifp_users.h"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_ifp_conf.ldb"
+#define TEST_ID_PROVIDER "ldap"
+#define TEST_DOM_FIRST "ifp_paged_first"
+#define TEST_DOM_SECOND "ifp_paged_second"
+
+static const char *paged_domains[] = { TEST_DOM_FIRST, TEST_DOM_SECOND, NULL };
 
 /* dbus library checks for valid object paths when unit testing, we don't
  * want that */
@@ -264,6 +274,347 @@ void test_attr_allowed(void **state)
     assert_false(ifp_attr_allowed(NULL, "name"));
 }
 
+struct ifp_paged_test_ctx {
+    struct sss_test_ctx *tctx;
+    struct ifp_ctx *ifp_ctx;
+    struct sss_domain_info *first;
+    struct sss_domain_info *second;
+};
+
+static int ifp_paged_setup(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+
+    test_dom_suite_setup(TESTS_PATH);
+
+    test_ctx = talloc_zero(NULL, struct ifp_paged_test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->tctx = create_multidom_test_ctx(test_ctx, TESTS_PATH,
+                                              TEST_CONF_DB, paged_domains,
+                                              TEST_ID_PROVIDER, NULL);
+    assert_non_null(test_ctx->tctx);
+
+    test_ctx->ifp_ctx = talloc_zero(test_ctx, struct ifp_ctx);
+    assert_non_null(test_ctx->ifp_ctx);
+
+    test_ctx->ifp_ctx->rctx = mock_rctx(test_ctx, test_ctx->tctx->ev,
+                                        test_ctx->tctx->dom, NULL);
+    assert_non_null(test_ctx->ifp_ctx->rctx);
+
+    test_ctx->first = find_domain_by_name(test_ctx->tctx->dom,
+                                          TEST_DOM_FIRST, true);
+    assert_non_null(test_ctx->first);
+
+    test_ctx->second = find_domain_by_name(test_ctx->tctx->dom,
+                                           TEST_DOM_SECOND, true);
+    assert_non_null(test_ctx->second);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int ifp_paged_teardown(void **state)
+{
+    talloc_zfree(*state);
+    test_multidom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, paged_domains);
+    return 0;
+}
+
+static void ifp_paged_store_user(struct sss_domain_info *domain,
+                                 const char *shortname,
+                                 uid_t uid)
+{
+    char *fqname;
+    errno_t ret;
+
+    fqname = sss_create_internal_fqname(NULL, shortname, domain->name);
+    assert_non_null(fqname);
+
+    ret = sysdb_store_user(domain, fqname, NULL, uid, uid, NULL, NULL, NULL,
+                           NULL, NULL, NULL, 1000, time(NULL));
+    talloc_free(fqname);
+    assert_int_equal(ret, EOK);
+}
+
+/* Simulates the data provider refreshing the users of a domain, the first
+ * domain has two users, the second one three. */
+static int ifp_paged_refresh_cb(void *pvt)
+{
+    struct sss_domain_info *domain = pvt;
+
+    /* Stored in the reverse order, the pages are sorted by name. */
+    if (strcmp(domain->name, TEST_DOM_SECOND) == 0) {
+        ifp_paged_store_user(domain, "user3", 2003);
+        ifp_paged_store_user(domain, "user2", 2002);
+        ifp_paged_store_user(domain, "user1", 2001);
+    } else {
+        ifp_paged_store_user(domain, "user2", 1002);
+        ifp_paged_store_user(domain, "user1", 1001);
+    }
+
+    return EOK;
+}
+
+static void ifp_paged_expect_refresh(struct sss_domain_info *domain)
+{
+    mock_account_recv(0, 0, NULL, ifp_paged_refresh_cb, domain);
+}
+
+static char *ifp_paged_build_path(TALLOC_CTX *mem_ctx,
+                                  struct sss_domain_info *domain,
+                                  struct ldb_message *msg)
+{
+    return talloc_strdup(mem_ctx,
+                         ldb_msg_find_attr_as_string(msg, SYSDB_NAME, NULL));
+}
+
+static errno_t ifp_paged_list(struct ifp_paged_test_ctx *test_ctx,
+                              const char *domain,
+                              const char *cursor,
+                              uint32_t page_size,
+                              const char ***_paths,
+                              const char **_next_cursor)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = ifp_list_paged_send(test_ctx, test_ctx->tctx->ev,
+                              test_ctx->ifp_ctx, CACHE_REQ_USER_BY_FILTER,
+                              ifp_paged_build_path, domain, "user*",
+                              cursor, page_size);
+    assert_non_null(req);
+    assert_true(tevent_req_poll(req, test_ctx->tctx->ev));
+
+    ret = ifp_list_paged_recv(test_ctx, req, _paths, _next_cursor);
+    talloc_free(req);
+
+    return ret;
+}
+
+static void assert_paths(struct ifp_paged_test_ctx *test_ctx,
+                         const char **paths,
+                         const char *expected[])
+{
+    char *fqname;
+    size_t i;
+
+    for (i = 0; expected[i] != NULL; i += 2) {
+        assert_non_null(paths[i / 2]);
+        fqname = sss_create_internal_fqname(test_ctx, expected[i],
+                                            expected[i + 1]);
+        assert_non_null(fqname);
+        assert_string_equal(paths[i / 2], fqname);
+        talloc_free(fqname);
+    }
+    assert_null(paths[i / 2]);
+}
+
+void test_ifp_paged_first_page(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char *exp_paths[] = { "user1", TEST_DOM_FIRST, NULL };
+    const char **paths;
+    const char *next_cursor;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    ifp_paged_expect_refresh(test_ctx->first);
+    ret = ifp_paged_list(test_ctx, NULL, "", 1, &paths, &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_paths);
+    assert_non_null(strchr(next_cursor, ':'));
+    assert_string_equal(strchr(next_cursor, ':') + 1,
+                        "user1@" TEST_DOM_FIRST);
+}
+
+void test_ifp_paged_domain_end(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char *exp_first[] = { "user1", TEST_DOM_FIRST,
+                                "user2", TEST_DOM_FIRST, NULL };
+    const char *exp_second[] = { "user1", TEST_DOM_SECOND,
+                                 "user2", TEST_DOM_SECOND, NULL };
+    const char *exp_last[] = { "user3", TEST_DOM_SECOND, NULL };
+    const char **paths;
+    const char *next_cursor;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    /* The page ends exactly with the last user of the first domain. */
+    ifp_paged_expect_refresh(test_ctx->first);
+    ret = ifp_paged_list(test_ctx, NULL, "", 2, &paths, &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_first);
+    assert_string_not_equal(next_cursor, "");
+
+    /* The rest of the first domain is read from the cache, only the second
+     * domain is refreshed. */
+    ifp_paged_expect_refresh(test_ctx->second);
+    ret = ifp_paged_list(test_ctx, NULL, next_cursor, 2, &paths,
+                         &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_second);
+    assert_string_not_equal(next_cursor, "");
+
+    /* The last page does not contact the data provider at all. */
+    ret = ifp_paged_list(test_ctx, NULL, next_cursor, 2, &paths,
+                         &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_last);
+    assert_string_equal(next_cursor, "");
+}
+
+void test_ifp_paged_cross_domain(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char *exp_paths[] = { "user1", TEST_DOM_FIRST,
+                                "user2", TEST_DOM_FIRST,
+                                "user1", TEST_DOM_SECOND, NULL };
+    const char *exp_single[] = { "user2", TEST_DOM_FIRST, NULL };
+    const char **paths;
+    const char *next_cursor;
+    const char *cursor;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    ifp_paged_expect_refresh(test_ctx->first);
+    ifp_paged_expect_refresh(test_ctx->second);
+    ret = ifp_paged_list(test_ctx, NULL, "", 3, &paths, &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_paths);
+    assert_string_equal(strchr(next_cursor, ':') + 1,
+                        "user1@" TEST_DOM_SECOND);
+
+    /* A single domain listing ends with the domain. */
+    cursor = talloc_asprintf(test_ctx, "%lld:user1@" TEST_DOM_FIRST,
+                             (long long)time(NULL) - 10);
+    assert_non_null(cursor);
+    ret = ifp_paged_list(test_ctx, TEST_DOM_FIRST, cursor, 3, &paths,
+                         &next_cursor);
+    assert_int_equal(ret, EOK);
+    assert_paths(test_ctx, paths, exp_single);
+    assert_string_equal(next_cursor, "");
+}
+
+void test_ifp_paged_invalid_cursor(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char **paths;
+    const char *next_cursor;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    ret = ifp_paged_list(test_ctx, NULL, "user1@" TEST_DOM_FIRST, 2,
+                         &paths, &next_cursor);
+    assert_int_equal(ret, EINVAL);
+
+    ret = ifp_paged_list(test_ctx, NULL, "abc:user1@" TEST_DOM_FIRST, 2,
+                         &paths, &next_cursor);
+    assert_int_equal(ret, EINVAL);
+
+    ret = ifp_paged_list(test_ctx, NULL, "1:user1", 2,
+                         &paths, &next_cursor);
+    assert_int_equal(ret, EINVAL);
+
+    ret = ifp_paged_list(test_ctx, NULL, "1:user1@unknown", 2,
+                         &paths, &next_cursor);
+    assert_int_equal(ret, EINVAL);
+}
+
+void test_ifp_paged_other_domain_cursor(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char **paths;
+    const char *next_cursor;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    ret = ifp_paged_list(test_ctx, TEST_DOM_FIRST,
+                         "1:user1@" TEST_DOM_SECOND, 2,
+                         &paths, &next_cursor);
+    assert_int_equal(ret, EINVAL);
+}
+
+/* Returns the number of entries of the next dictionary in the array. */
+static int ifp_next_dict_size(DBusMessageIter *iter_array)
+{
+    DBusMessageIter iter_dict;
+    int count = 0;
+
+    assert_int_equal(dbus_message_iter_get_arg_type(iter_array),
+                     DBUS_TYPE_ARRAY);
+
+    dbus_message_iter_recurse(iter_array, &iter_dict);
+    while (dbus_message_iter_get_arg_type(&iter_dict) != DBUS_TYPE_INVALID) {
+        count++;
+        dbus_message_iter_next(&iter_dict);
+    }
+
+    dbus_message_iter_next(iter_array);
+
+    return count;
+}
+
+void test_ifp_users_get_attrs_by_name_list(void **state)
+{
+    struct ifp_paged_test_ctx *test_ctx;
+    const char *names[] = { "user1", "user1", "@", NULL };
+    const char *attrs[] = { "name", "uidNumber", NULL };
+    struct sbus_sender sender = { .uid = 0 };
+    struct sbus_request sbus_req = { .sender = &sender };
+    DBusMessageIter write_iter;
+    DBusMessageIter iter;
+    DBusMessageIter iter_array;
+    DBusMessage *msg;
+    struct tevent_req *req;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_paged_test_ctx);
+
+    test_ctx->ifp_ctx->user_whitelist = ifp_parse_user_attr_list(
+                                                    test_ctx->ifp_ctx, NULL);
+    assert_non_null(test_ctx->ifp_ctx->user_whitelist);
+
+    ifp_paged_store_user(test_ctx->first, "user1", 1001);
+
+    /* A known user, a user of an unknown domain and an unparsable name. */
+    mock_parse_inp("user1", TEST_DOM_FIRST, EOK);
+    mock_parse_inp("user1", "nodomain", EOK);
+    mock_parse_inp(NULL, NULL, ERR_INVALID_FQN);
+
+    msg = dbus_message_new(DBUS_MESSAGE_TYPE_METHOD_RETURN);
+    assert_non_null(msg);
+    dbus_message_iter_init_append(msg, &write_iter);
+
+    req = ifp_users_get_attrs_by_name_list_send(test_ctx, test_ctx->tctx->ev,
+                                                &sbus_req, test_ctx->ifp_ctx,
+                                                names, attrs, &write_iter);
+    assert_non_null(req);
+    assert_true(tevent_req_poll(req, test_ctx->tctx->ev));
+
+    ret = ifp_users_get_attrs_by_name_list_recv(test_ctx, req);
+    talloc_free(req);
+    assert_int_equal(ret, EOK);
+
+    /* The failed lookups do not fail the batch, they are empty. */
+    assert_true(dbus_message_iter_init(msg, &iter));
+    assert_int_equal(dbus_message_iter_get_arg_type(&iter), DBUS_TYPE_ARRAY);
+    dbus_message_iter_recurse(&iter, &iter_array);
+    assert_int_equal(ifp_next_dict_size(&iter_array), 2);
+    assert_int_equal(ifp_next_dict_size(&iter_array), 0);
+    assert_int_equal(ifp_next_dict_size(&iter_array), 0);
+    assert_int_equal(dbus_message_iter_get_arg_type(&iter_array),
+                     DBUS_TYPE_INVALID);
+
+    dbus_message_unref(msg);
+}
+
 int main(int argc, const char *argv[])
 {
     poptContext pc;
@@ -279,6 +630,24 @@ int main(int argc, const char *argv[])
         cmocka_unit_test(test_attr_acl),
         cmocka_unit_test(test_attr_acl_ex),
         cmocka_unit_test(test_attr_allowed),
+        cmocka_unit_test_setup_teardown(test_ifp_paged_first_page,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
+        cmocka_unit_test_setup_teardown(test_ifp_paged_domain_end,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
+        cmocka_unit_test_setup_teardown(test_ifp_paged_cross_domain,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
+        cmocka_unit_test_setup_teardown(test_ifp_paged_invalid_cursor,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
+        cmocka_unit_test_setup_teardown(test_ifp_paged_other_domain_cursor,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
+        cmocka_unit_test_setup_teardown(test_ifp_users_get_attrs_by_name_list,
+                                        ifp_paged_setup,
+                                        ifp_paged_teardown),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
@@ -301,6 +670,7 @@ int main(int argc, const char *argv[])
     /* Even though normally the tests should clean up after themselves
      * they might not after a failed run. Remove the old DB to be sure */
     tests_set_cwd();
+    test_multidom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, paged_domains);
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
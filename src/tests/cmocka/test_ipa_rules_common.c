@@ -0,0 +1,260 @@
+/*
+    SSSD
+
+    Tests for the fingerprint of the IPA access control rules
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <talloc.h>
+#include <errno.h>
+#include <popt.h>
+
+#include "tests/cmocka/common_mock.h"
+#include "providers/ipa/ipa_rules_common.h"
+
+struct test_ctx {
+    struct ipa_common_entries *hosts;
+    struct ipa_common_entries *services;
+    struct ipa_common_entries *rules;
+};
+
+/* Creates an entry from a NULL terminated list of name, value pairs. */
+static struct sysdb_attrs *test_entry(TALLOC_CTX *mem_ctx, ...)
+{
+    struct sysdb_attrs *attrs;
+    const char *name;
+    const char *value;
+    va_list ap;
+    errno_t ret;
+
+    attrs = sysdb_new_attrs(mem_ctx);
+    assert_non_null(attrs);
+
+    va_start(ap, mem_ctx);
+    while ((name = va_arg(ap, const char *)) != NULL) {
+        value = va_arg(ap, const char *);
+        ret = sysdb_attrs_add_string(attrs, name, value);
+        assert_int_equal(ret, EOK);
+    }
+    va_end(ap);
+
+    return attrs;
+}
+
+static void test_set_rules(struct test_ctx *test_ctx,
+                           struct sysdb_attrs *first,
+                           struct sysdb_attrs *second)
+{
+    talloc_zfree(test_ctx->rules->entries);
+
+    test_ctx->rules->entries = talloc_array(test_ctx->rules,
+                                            struct sysdb_attrs *, 2);
+    assert_non_null(test_ctx->rules->entries);
+
+    test_ctx->rules->entries[0] = talloc_steal(test_ctx->rules->entries,
+                                               first);
+    test_ctx->rules->entries[1] = talloc_steal(test_ctx->rules->entries,
+                                               second);
+    test_ctx->rules->entry_count = 2;
+}
+
+static uint32_t test_fingerprint(struct test_ctx *test_ctx)
+{
+    return ipa_common_rules_fingerprint(test_ctx->hosts,
+                                        test_ctx->services,
+                                        test_ctx->rules);
+}
+
+static int test_setup(void **state)
+{
+    struct test_ctx *test_ctx;
+
+    assert_true(leak_check_setup());
+
+    test_ctx = talloc_zero(global_talloc_context, struct test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->hosts = talloc_zero(test_ctx, struct ipa_common_entries);
+    assert_non_null(test_ctx->hosts);
+
+    test_ctx->services = talloc_zero(test_ctx, struct ipa_common_entries);
+    assert_non_null(test_ctx->services);
+
+    test_ctx->rules = talloc_zero(test_ctx, struct ipa_common_entries);
+    assert_non_null(test_ctx->rules);
+
+    check_leaks_push(test_ctx);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int test_teardown(void **state)
+{
+    struct test_ctx *test_ctx;
+
+    test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    talloc_zfree(test_ctx->rules->entries);
+    assert_true(check_leaks_pop(test_ctx));
+    talloc_zfree(test_ctx);
+
+    assert_true(leak_check_teardown());
+    return 0;
+}
+
+void test_ipa_rules_fingerprint_empty(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    uint32_t empty;
+
+    empty = test_fingerprint(test_ctx);
+    assert_int_equal(empty, 0);
+
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx, IPA_CN, "allow_all", NULL),
+                   test_entry(test_ctx, IPA_CN, "allow_admins", NULL));
+    assert_int_not_equal(test_fingerprint(test_ctx), empty);
+}
+
+void test_ipa_rules_fingerprint_order(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    uint32_t fingerprint;
+
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_admins",
+                              IPA_MEMBER_USER, "admins",
+                              IPA_MEMBER_USER, "operators",
+                              IPA_MEMBER_HOST, "servers",
+                              NULL),
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_users",
+                              IPA_MEMBER_USER, "users",
+                              IPA_HOST_CATEGORY, "all",
+                              NULL));
+    fingerprint = test_fingerprint(test_ctx);
+
+    /* The server returned the same rules in a different order. */
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_HOST_CATEGORY, "all",
+                              IPA_MEMBER_USER, "users",
+                              IPA_CN, "allow_users",
+                              NULL),
+                   test_entry(test_ctx,
+                              IPA_MEMBER_HOST, "servers",
+                              IPA_MEMBER_USER, "operators",
+                              IPA_MEMBER_USER, "admins",
+                              IPA_CN, "allow_admins",
+                              NULL));
+    assert_int_equal(test_fingerprint(test_ctx), fingerprint);
+}
+
+void test_ipa_rules_fingerprint_moved_value(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    uint32_t fingerprint;
+
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_admins",
+                              IPA_MEMBER_USER, "admins",
+                              IPA_MEMBER_USER, "operators",
+                              NULL),
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_users",
+                              IPA_MEMBER_USER, "users",
+                              NULL));
+    fingerprint = test_fingerprint(test_ctx);
+
+    /* The same values in total, but "operators" moved to another rule. */
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_admins",
+                              IPA_MEMBER_USER, "admins",
+                              NULL),
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_users",
+                              IPA_MEMBER_USER, "users",
+                              IPA_MEMBER_USER, "operators",
+                              NULL));
+    assert_int_not_equal(test_fingerprint(test_ctx), fingerprint);
+}
+
+void test_ipa_rules_fingerprint_moved_attribute(void **state)
+{
+    struct test_ctx *test_ctx = talloc_get_type_abort(*state, struct test_ctx);
+    uint32_t fingerprint;
+
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_admins",
+                              IPA_MEMBER_USER, "admins",
+                              NULL),
+                   test_entry(test_ctx, IPA_CN, "allow_users", NULL));
+    fingerprint = test_fingerprint(test_ctx);
+
+    /* The same value under another attribute must be a different rule. */
+    test_set_rules(test_ctx,
+                   test_entry(test_ctx,
+                              IPA_CN, "allow_admins",
+                              IPA_MEMBER_HOST, "admins",
+                              NULL),
+                   test_entry(test_ctx, IPA_CN, "allow_users", NULL));
+    assert_int_not_equal(test_fingerprint(test_ctx), fingerprint);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_ipa_rules_fingerprint_empty,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_ipa_rules_fingerprint_order,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_ipa_rules_fingerprint_moved_value,
+                                        test_setup, test_teardown),
+        cmocka_unit_test_setup_teardown(test_ipa_rules_fingerprint_moved_attribute,
+                                        test_setup, test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
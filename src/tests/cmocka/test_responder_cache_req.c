@@ -798,6 +798,55 @@ void test_user_by_name_multiple_domains_notfound(void **state)
     assert_true(test_ctx->dp_called);
 }
 
+void test_user_by_name_multiple_domains_parallel_found(void **state)
+{
+    struct cache_req_test_ctx *test_ctx = NULL;
+    struct sss_domain_info *domain_b = NULL;
+    struct sss_domain_info *domain_d = NULL;
+
+    test_ctx = talloc_get_type_abort(*state, struct cache_req_test_ctx);
+    test_ctx->rctx->parallel_domain_lookup = true;
+
+    /* Setup expired user in two domains so all of them are asked. */
+    domain_b = find_domain_by_name(test_ctx->tctx->dom,
+                                   "responder_cache_req_test_b", true);
+    assert_non_null(domain_b);
+
+    domain_d = find_domain_by_name(test_ctx->tctx->dom,
+                                   "responder_cache_req_test_d", true);
+    assert_non_null(domain_d);
+
+    prepare_user(domain_d, &users[0], -1000, time(NULL));
+    prepare_user(domain_b, &users[0], -1000, time(NULL));
+
+    /* Mock values. */
+    will_return_always(__wrap_sss_dp_get_account_send, test_ctx);
+    will_return_always(sss_dp_get_account_recv, 0);
+    mock_parse_inp(users[0].short_name, NULL, ERR_OK);
+
+    /* Test. The first domain in the resolution order wins. */
+    run_user_by_name(test_ctx, NULL, 0, ERR_OK);
+    assert_true(test_ctx->dp_called);
+    check_user(test_ctx, &users[0], domain_b);
+}
+
+void test_user_by_name_multiple_domains_parallel_notfound(void **state)
+{
+    struct cache_req_test_ctx *test_ctx = NULL;
+
+    test_ctx = talloc_get_type_abort(*state, struct cache_req_test_ctx);
+    test_ctx->rctx->parallel_domain_lookup = true;
+
+    /* Mock values. */
+    will_return_always(__wrap_sss_dp_get_account_send, test_ctx);
+    will_return_always(sss_dp_get_account_recv, 0);
+    mock_parse_inp(users[0].short_name, NULL, ERR_OK);
+
+    /* Test. */
+    run_user_by_name(test_ctx, NULL, 0, ENOENT);
+    assert_true(test_ctx->dp_called);
+}
+
 void test_user_by_name_multiple_domains_parse(void **state)
 {
     struct cache_req_test_ctx *test_ctx = NULL;
@@ -4221,6 +4270,8 @@ int main(int argc, const char *argv[])
         new_single_domain_test(user_by_name_missing_notfound),
         new_multi_domain_test(user_by_name_multiple_domains_found),
         new_multi_domain_test(user_by_name_multiple_domains_notfound),
+        new_multi_domain_test(user_by_name_multiple_domains_parallel_found),
+        new_multi_domain_test(user_by_name_multiple_domains_parallel_notfound),
         new_multi_domain_test(user_by_name_multiple_domains_parse),
         new_multi_domain_test(user_by_name_multiple_domains_requested_domains_found),
         new_multi_domain_test(user_by_name_multiple_domains_requested_domains_notfound),
@@ -734,6 +734,77 @@ static void test_group_space(void **state)
     run_simple_access_check(simple_test_ctx, "u3@simple_test", EOK, false);
 }
 
+/* The user is only a member of a non-POSIX group which is named by its SID,
+ * the way some providers save groups during initgroups. The configured group
+ * is in the cache with the same GID, so the group must be matched without
+ * resolving its name. */
+static void add_group_by_id_entries(struct simple_test_ctx *test_ctx)
+{
+    struct sss_domain_info *dom = test_ctx->be_ctx->domain;
+    char *u4;
+    char *admins;
+    char *sid_name;
+    errno_t ret;
+
+    u4 = sss_create_internal_fqname(test_ctx, "u4", dom->name);
+    admins = sss_create_internal_fqname(test_ctx, "admins", dom->name);
+    sid_name = sss_create_internal_fqname(test_ctx, "S-1-5-21-1-2-3-4000",
+                                          dom->name);
+    assert_non_null(u4);
+    assert_non_null(admins);
+    assert_non_null(sid_name);
+
+    ret = sysdb_store_user(dom, u4, NULL, 4001, 999, "u4", "/home/u4",
+                           "/bin/bash", NULL, NULL, NULL, -1, 0);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_add_group(dom, admins, 4000, NULL, 0, 0);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_add_incomplete_group(dom, sid_name, 4000, NULL, NULL, NULL,
+                                     false, 0);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_add_group_member(dom, sid_name, u4, SYSDB_MEMBER_USER, false);
+    assert_int_equal(ret, EOK);
+}
+
+static void test_group_allow_by_id(void **state)
+{
+    errno_t ret;
+    struct simple_test_ctx *simple_test_ctx = \
+                            talloc_get_type(*state, struct simple_test_ctx);
+    struct sss_test_conf_param params[] = {
+        { "simple_allow_groups", "admins" },
+        { NULL, NULL },
+    };
+
+    add_group_by_id_entries(simple_test_ctx);
+
+    ret = setup_with_params(simple_test_ctx, simple_test_ctx->tctx->dom, params);
+    assert_int_equal(ret, EOK);
+
+    run_simple_access_check(simple_test_ctx, "u4@simple_test", EOK, true);
+}
+
+static void test_group_deny_by_id(void **state)
+{
+    errno_t ret;
+    struct simple_test_ctx *simple_test_ctx = \
+                            talloc_get_type(*state, struct simple_test_ctx);
+    struct sss_test_conf_param params[] = {
+        { "simple_deny_groups", "admins" },
+        { NULL, NULL },
+    };
+
+    add_group_by_id_entries(simple_test_ctx);
+
+    ret = setup_with_params(simple_test_ctx, simple_test_ctx->tctx->dom, params);
+    assert_int_equal(ret, EOK);
+
+    run_simple_access_check(simple_test_ctx, "u4@simple_test", EOK, false);
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -791,6 +862,12 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_group_space,
                                         simple_group_test_setup,
                                         simple_group_test_teardown),
+        cmocka_unit_test_setup_teardown(test_group_allow_by_id,
+                                        simple_test_setup,
+                                        simple_test_teardown),
+        cmocka_unit_test_setup_teardown(test_group_deny_by_id,
+                                        simple_test_setup,
+                                        simple_test_teardown),
         cmocka_unit_test_setup_teardown(test_unparseable_allow_user,
                                         simple_test_setup,
                                         simple_test_teardown),
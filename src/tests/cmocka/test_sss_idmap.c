@@ -21,6 +21,7 @@
 */
 
 #include <popt.h>
+#include <time.h>
 
 #include "tests/cmocka/common_mock.h"
 
@@ -43,6 +44,9 @@
 #define TEST_OFFSET 1000000
 #define TEST_OFFSET_STR "1000000"
 
+#define TEST_MANY_DOMS 500
+#define TEST_MANY_ITERATIONS 100
+
 const int TEST_2922_MIN_ID = 1842600000;
 const int TEST_2922_MAX_ID = 1842799999;
 
@@ -478,6 +482,145 @@ void test_map_id_external(void **state)
     assert_int_equal(err, IDMAP_EXTERNAL);
 }
 
+void test_map_id_many_domains(void **state)
+{
+    struct test_ctx *test_ctx;
+    enum idmap_error_code err;
+    struct sss_idmap_range range;
+    struct timespec start;
+    struct timespec end;
+    char name[64];
+    char dom_sid[64];
+    char user_sid[64];
+    char *sid = NULL;
+    uint32_t id;
+    bool has_algorithmic;
+    size_t c;
+    size_t i;
+
+    test_ctx = talloc_get_type(*state, struct test_ctx);
+
+    assert_non_null(test_ctx);
+
+    for (c = 0; c < TEST_MANY_DOMS; c++) {
+        snprintf(name, sizeof(name), "dom%zu.test", c);
+        snprintf(dom_sid, sizeof(dom_sid), "S-1-5-21-%zu-%zu-%zu",
+                 c + 1, c * 2 + 1, c * 3 + 1);
+        range.min = TEST_RANGE_MIN + c * TEST_OFFSET;
+        range.max = range.min + TEST_OFFSET - 1;
+
+        err = sss_idmap_add_domain_ex(test_ctx->idmap_ctx, name, dom_sid,
+                                      &range, NULL, 0, c % 10 == 9);
+        assert_int_equal(err, IDMAP_SUCCESS);
+
+        /* Lookups in between must see all domains added so far */
+        err = sss_idmap_domain_has_algorithmic_mapping(test_ctx->idmap_ctx,
+                                                       dom_sid,
+                                                       &has_algorithmic);
+        assert_int_equal(err, IDMAP_SUCCESS);
+        assert_true(has_algorithmic == (c % 10 != 9));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < TEST_MANY_ITERATIONS; i++) {
+        for (c = 0; c < TEST_MANY_DOMS; c++) {
+            snprintf(user_sid, sizeof(user_sid), "S-1-5-21-%zu-%zu-%zu-%zu",
+                     c + 1, c * 2 + 1, c * 3 + 1, i + 1000);
+
+            err = sss_idmap_sid_to_unix(test_ctx->idmap_ctx, user_sid, &id);
+            if (c % 10 == 9) {
+                assert_int_equal(err, IDMAP_EXTERNAL);
+                continue;
+            }
+            assert_int_equal(err, IDMAP_SUCCESS);
+            assert_int_equal(id, TEST_RANGE_MIN + c * TEST_OFFSET + i + 1000);
+
+            err = sss_idmap_check_sid_unix(test_ctx->idmap_ctx, user_sid, id);
+            assert_int_equal(err, IDMAP_SUCCESS);
+
+            err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx, id, &sid);
+            assert_int_equal(err, IDMAP_SUCCESS);
+            assert_string_equal(sid, user_sid);
+            sss_idmap_free_sid(test_ctx->idmap_ctx, sid);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    print_message("%d domains, %d conversions in %.3f ms\n",
+                  TEST_MANY_DOMS, TEST_MANY_DOMS * TEST_MANY_ITERATIONS * 2,
+                  (end.tv_sec - start.tv_sec) * 1e3
+                      + (end.tv_nsec - start.tv_nsec) / 1e6);
+
+    /* SIDs must match whole sub-authorities of the domain SID */
+    err = sss_idmap_sid_to_unix(test_ctx->idmap_ctx, "S-1-5-21-1-1-11-1000",
+                                &id);
+    assert_int_equal(err, IDMAP_NO_DOMAIN);
+
+    err = sss_idmap_sid_to_unix(test_ctx->idmap_ctx, "S-1-5-21-1-1-1", &id);
+    assert_int_equal(err, IDMAP_NO_DOMAIN);
+
+    err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx,
+                                TEST_RANGE_MIN + TEST_MANY_DOMS * TEST_OFFSET,
+                                &sid);
+    assert_int_equal(err, IDMAP_NO_DOMAIN);
+
+    err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx, TEST_RANGE_MIN - 1, &sid);
+    assert_int_equal(err, IDMAP_NO_DOMAIN);
+}
+
+void test_map_id_multi_range(void **state)
+{
+    struct test_ctx *test_ctx;
+    enum idmap_error_code err;
+    struct sss_idmap_range range;
+    char user_sid[64];
+    char *sid = NULL;
+    uint32_t id;
+    size_t c;
+
+    test_ctx = talloc_get_type(*state, struct test_ctx);
+
+    assert_non_null(test_ctx);
+
+    /* The second domain sits between the ranges of the first one */
+    range.min = TEST_2_RANGE_MIN;
+    range.max = TEST_2_RANGE_MAX;
+    err = sss_idmap_add_domain_ex(test_ctx->idmap_ctx, TEST_2_DOM_NAME,
+                                  TEST_2_DOM_SID, &range, NULL, 0, false);
+    assert_int_equal(err, IDMAP_SUCCESS);
+
+    for (c = 0; c < 3; c++) {
+        range.min = TEST_RANGE_MIN + c * TEST_OFFSET;
+        range.max = TEST_RANGE_MAX + c * TEST_OFFSET;
+        err = sss_idmap_add_domain_ex(test_ctx->idmap_ctx, TEST_DOM_NAME,
+                                      TEST_DOM_SID, &range, NULL,
+                                      c * TEST_OFFSET, false);
+        assert_int_equal(err, IDMAP_SUCCESS);
+    }
+
+    /* Every range of the first domain must be found, not only the first */
+    for (c = 0; c < 3; c++) {
+        id = TEST_RANGE_MIN + c * TEST_OFFSET + 1000;
+        snprintf(user_sid, sizeof(user_sid), "%s-%zu",
+                 TEST_DOM_SID, c * TEST_OFFSET + 1000);
+
+        err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx, id, &sid);
+        assert_int_equal(err, IDMAP_SUCCESS);
+        assert_string_equal(sid, user_sid);
+        sss_idmap_free_sid(test_ctx->idmap_ctx, sid);
+    }
+
+    err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx, TEST_2_RANGE_MIN, &sid);
+    assert_int_equal(err, IDMAP_SUCCESS);
+    assert_string_equal(sid, TEST_2_DOM_SID"-0");
+    sss_idmap_free_sid(test_ctx->idmap_ctx, sid);
+
+    err = sss_idmap_unix_to_sid(test_ctx->idmap_ctx,
+                                TEST_RANGE_MAX + 2 * TEST_OFFSET + 1, &sid);
+    assert_int_equal(err, IDMAP_NO_DOMAIN);
+}
+
 void test_check_sid_id(void **state)
 {
     struct test_ctx *test_ctx;
@@ -739,6 +882,12 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_map_id_external,
                                         test_sss_idmap_setup_with_external_mappings,
                                         test_sss_idmap_teardown),
+        cmocka_unit_test_setup_teardown(test_map_id_many_domains,
+                                        test_sss_idmap_setup,
+                                        test_sss_idmap_teardown),
+        cmocka_unit_test_setup_teardown(test_map_id_multi_range,
+                                        test_sss_idmap_setup,
+                                        test_sss_idmap_teardown),
         cmocka_unit_test_setup_teardown(test_check_sid_id,
                                         test_sss_idmap_setup_with_domains,
                                         test_sss_idmap_teardown),
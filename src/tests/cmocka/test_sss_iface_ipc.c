@@ -0,0 +1,458 @@
+/*
+    SSSD
+
+    test_sss_iface_ipc - binary responder to backend IPC tests
+
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <popt.h>
+#include <cmocka.h>
+
+#include "util/util.h"
+#include "sss_iface/sss_iface_ipc.h"
+#include "tests/common.h"
+
+/* In order to access the responder side of the connection */
+#include "responder/common/responder_dp_ipc.c"
+
+static void test_sss_ipc_account_req(void **state)
+{
+    struct sss_ipc_account_req in = { 0 };
+    struct sss_ipc_account_req out = { 0 };
+    uint8_t *frame;
+    uint8_t *body;
+    size_t len;
+    size_t i;
+    errno_t ret;
+
+    in.dp_flags = 1;
+    in.entry_type = 0x1001;
+    in.filter = "name=user";
+    in.domain = "example.com";
+    in.extra = NULL;
+
+    ret = sss_ipc_account_req_encode(NULL, 42, &in, &frame);
+    assert_int_equal(ret, EOK);
+
+    len = sss_ipc_frame_len(frame) - SSS_IPC_HEADER_LEN;
+    body = frame + SSS_IPC_HEADER_LEN;
+
+    ret = sss_ipc_account_req_decode(body, len, &out);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(out.dp_flags, 1);
+    assert_int_equal(out.entry_type, 0x1001);
+    assert_string_equal(out.filter, "name=user");
+    assert_string_equal(out.domain, "example.com");
+    assert_null(out.extra);
+
+    /* truncated bodies are rejected */
+    for (i = 0; i < len; i++) {
+        ret = sss_ipc_account_req_decode(body, i, &out);
+        assert_int_equal(ret, EINVAL);
+    }
+
+    /* so is a string without the terminating NUL */
+    body[3 * sizeof(uint32_t) + strlen("name=user")] = 'x';
+    ret = sss_ipc_account_req_decode(body, len, &out);
+    assert_int_equal(ret, EINVAL);
+
+    talloc_free(frame);
+}
+
+static void test_sss_ipc_account_reply(void **state)
+{
+    struct sss_ipc_account_reply in = { 0 };
+    struct sss_ipc_account_reply out = { 0 };
+    uint8_t *frame;
+    errno_t error;
+    errno_t ret;
+
+    in.dp_error = 1;
+    in.error = ENOENT;
+    in.error_message = "Not found";
+
+    ret = sss_ipc_account_reply_encode(NULL, 43, &in, &frame);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_ipc_account_reply_decode(frame + SSS_IPC_HEADER_LEN,
+                                       sss_ipc_frame_len(frame)
+                                           - SSS_IPC_HEADER_LEN,
+                                       &out);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(out.dp_error, 1);
+    assert_int_equal(out.error, ENOENT);
+    assert_string_equal(out.error_message, "Not found");
+    talloc_free(frame);
+
+    ret = sss_ipc_error_reply_encode(NULL, 44, ETIMEDOUT, &frame);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_ipc_error_reply_decode(frame + SSS_IPC_HEADER_LEN,
+                                     sss_ipc_frame_len(frame)
+                                         - SSS_IPC_HEADER_LEN,
+                                     &error);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(error, ETIMEDOUT);
+    talloc_free(frame);
+}
+
+struct test_ipc_ctx {
+    struct sss_test_ctx *tctx;
+    uint32_t type;
+    uint32_t serial;
+    struct sss_ipc_account_req req;
+    uint8_t *frame;
+    bool closed;
+};
+
+static void test_ipc_msg(struct sss_ipc_conn *conn,
+                         uint32_t type,
+                         uint32_t serial,
+                         uint8_t *frame,
+                         uint8_t *body,
+                         size_t body_len,
+                         void *pvt)
+{
+    struct test_ipc_ctx *ctx = pvt;
+
+    ctx->type = type;
+    ctx->serial = serial;
+    ctx->frame = talloc_steal(ctx, frame);
+
+    test_ev_done(ctx->tctx, sss_ipc_account_req_decode(body, body_len,
+                                                       &ctx->req));
+}
+
+static void test_ipc_close(struct sss_ipc_conn *conn, void *pvt)
+{
+    struct test_ipc_ctx *ctx = pvt;
+
+    ctx->closed = true;
+    test_ev_done(ctx->tctx, ENOTCONN);
+}
+
+static void test_sss_ipc_conn(void **state)
+{
+    struct sss_ipc_account_req req = { 0 };
+    struct test_ipc_ctx *ctx;
+    struct sss_ipc_conn *client;
+    struct sss_ipc_conn *server;
+    uint8_t *frame;
+    int sv[2];
+    int ret;
+
+    ctx = talloc_zero(NULL, struct test_ipc_ctx);
+    assert_non_null(ctx);
+
+    ctx->tctx = create_ev_test_ctx(ctx);
+    assert_non_null(ctx->tctx);
+
+    ret = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    assert_int_equal(ret, 0);
+
+    client = sss_ipc_conn_create(ctx, ctx->tctx->ev, sv[0],
+                                 test_ipc_msg, test_ipc_close, ctx);
+    assert_non_null(client);
+
+    server = sss_ipc_conn_create(ctx, ctx->tctx->ev, sv[1],
+                                 test_ipc_msg, test_ipc_close, ctx);
+    assert_non_null(server);
+
+    req.entry_type = 0x0002;
+    req.filter = "idnumber=1000";
+    req.domain = "example.com";
+    req.extra = "V";
+
+    ret = sss_ipc_account_req_encode(ctx, 7, &req, &frame);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_ipc_conn_send(client, frame);
+    assert_int_equal(ret, EOK);
+
+    ret = test_ev_loop(ctx->tctx);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(ctx->type, SSS_IPC_GET_ACCOUNT_INFO);
+    assert_int_equal(ctx->serial, 7);
+    assert_string_equal(ctx->req.filter, "idnumber=1000");
+    assert_string_equal(ctx->req.extra, "V");
+
+    /* closing one side is reported on the other one */
+    ctx->tctx->done = false;
+    talloc_free(client);
+
+    ret = test_ev_loop(ctx->tctx);
+    assert_int_equal(ret, ENOTCONN);
+    assert_true(ctx->closed);
+
+    talloc_free(ctx);
+}
+
+struct test_dp_ipc_ctx {
+    struct sss_test_ctx *tctx;
+    struct be_conn *be_conn;
+    struct sss_ipc_conn *backend;
+
+    /* requests received by the backend */
+    int calls;
+    struct sss_ipc_account_req last;
+
+    int expected;
+    int finished;
+};
+
+struct test_dp_ipc_req {
+    struct test_dp_ipc_ctx *ctx;
+    errno_t ret;
+    uint16_t dp_error;
+    uint32_t error;
+    const char *error_message;
+};
+
+static void test_backend_msg(struct sss_ipc_conn *conn,
+                             uint32_t type,
+                             uint32_t serial,
+                             uint8_t *frame,
+                             uint8_t *body,
+                             size_t body_len,
+                             void *pvt)
+{
+    struct test_dp_ipc_ctx *ctx = pvt;
+    struct sss_ipc_account_reply reply = { 0 };
+    uint8_t *reply_frame;
+    errno_t ret;
+
+    assert_int_equal(type, SSS_IPC_GET_ACCOUNT_INFO);
+    ret = sss_ipc_account_req_decode(body, body_len, &ctx->last);
+    assert_int_equal(ret, EOK);
+    ctx->calls++;
+
+    reply.dp_error = 0;
+    reply.error = ctx->calls;
+    reply.error_message = ctx->last.filter;
+
+    ret = sss_ipc_account_reply_encode(ctx, serial, &reply, &reply_frame);
+    assert_int_equal(ret, EOK);
+    talloc_free(frame);
+
+    ret = sss_ipc_conn_send(conn, reply_frame);
+    assert_int_equal(ret, EOK);
+}
+
+static void test_backend_close(struct sss_ipc_conn *conn, void *pvt)
+{
+    struct test_dp_ipc_ctx *ctx = pvt;
+
+    test_ev_done(ctx->tctx, ENOTCONN);
+}
+
+static void test_dp_ipc_done(struct tevent_req *subreq)
+{
+    struct test_dp_ipc_req *r;
+
+    r = tevent_req_callback_data(subreq, struct test_dp_ipc_req);
+
+    r->ret = sss_dp_ipc_get_account_recv(r->ctx, subreq, &r->dp_error,
+                                         &r->error, &r->error_message);
+    talloc_zfree(subreq);
+
+    r->ctx->finished++;
+    if (r->ctx->finished == r->ctx->expected) {
+        test_ev_done(r->ctx->tctx, EOK);
+    }
+}
+
+static struct tevent_req *test_dp_ipc_send(struct test_dp_ipc_ctx *ctx,
+                                           struct test_dp_ipc_req *r,
+                                           const char *filter,
+                                           const char *extra)
+{
+    struct tevent_req *subreq;
+
+    r->ctx = ctx;
+    r->ret = EINVAL;
+
+    subreq = sss_dp_ipc_get_account_send(ctx, ctx->be_conn, 0, 0x0001,
+                                         filter, "example.com", extra);
+    assert_non_null(subreq);
+    tevent_req_set_callback(subreq, test_dp_ipc_done, r);
+
+    return subreq;
+}
+
+static struct test_dp_ipc_ctx *test_dp_ipc_setup(void)
+{
+    struct test_dp_ipc_ctx *ctx;
+    struct sss_dp_ipc *ipc;
+    int sv[2];
+    int ret;
+
+    ctx = talloc_zero(NULL, struct test_dp_ipc_ctx);
+    assert_non_null(ctx);
+
+    ctx->tctx = create_ev_test_ctx(ctx);
+    assert_non_null(ctx->tctx);
+
+    ret = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    assert_int_equal(ret, 0);
+
+    ctx->backend = sss_ipc_conn_create(ctx, ctx->tctx->ev, sv[1],
+                                       test_backend_msg, test_backend_close,
+                                       ctx);
+    assert_non_null(ctx->backend);
+
+    ctx->be_conn = talloc_zero(ctx, struct be_conn);
+    assert_non_null(ctx->be_conn);
+
+    ctx->be_conn->rctx = talloc_zero(ctx, struct resp_ctx);
+    assert_non_null(ctx->be_conn->rctx);
+    ctx->be_conn->rctx->ev = ctx->tctx->ev;
+
+    ctx->be_conn->domain = talloc_zero(ctx, struct sss_domain_info);
+    assert_non_null(ctx->be_conn->domain);
+    ctx->be_conn->domain->name = discard_const("example.com");
+
+    /* the same as sss_dp_ipc_connect() on a connected socket */
+    ipc = talloc_zero(ctx->be_conn, struct sss_dp_ipc);
+    assert_non_null(ipc);
+    ipc->be_conn = ctx->be_conn;
+    ipc->calls = sss_ptr_hash_create(ipc, NULL, NULL);
+    assert_non_null(ipc->calls);
+    ipc->conn = sss_ipc_conn_create(ipc, ctx->tctx->ev, sv[0],
+                                    sss_dp_ipc_message, sss_dp_ipc_close,
+                                    ipc);
+    assert_non_null(ipc->conn);
+    ctx->be_conn->ipc = ipc;
+
+    return ctx;
+}
+
+static void test_sss_dp_ipc_merge(void **state)
+{
+    struct test_dp_ipc_ctx *ctx;
+    struct test_dp_ipc_req r[4];
+    int ret;
+
+    ctx = test_dp_ipc_setup();
+
+    /* two identical requests and a different one */
+    test_dp_ipc_send(ctx, &r[0], "name=user", NULL);
+    test_dp_ipc_send(ctx, &r[1], "name=user", NULL);
+    test_dp_ipc_send(ctx, &r[2], "name=user", "V");
+
+    ctx->expected = 3;
+    ret = test_ev_loop(ctx->tctx);
+    assert_int_equal(ret, EOK);
+
+    /* the identical requests were sent to the backend only once */
+    assert_int_equal(ctx->calls, 2);
+
+    assert_int_equal(r[0].ret, EOK);
+    assert_int_equal(r[1].ret, EOK);
+    assert_int_equal(r[2].ret, EOK);
+    assert_int_equal(r[0].error, r[1].error);
+    assert_int_not_equal(r[0].error, r[2].error);
+    assert_string_equal(r[0].error_message, "name=user");
+    assert_string_equal(r[1].error_message, "name=user");
+    assert_ptr_not_equal(r[0].error_message, r[1].error_message);
+
+    /* a request sent after the reply is not merged with the finished one */
+    ctx->tctx->done = false;
+    ctx->finished = 0;
+    ctx->expected = 1;
+    test_dp_ipc_send(ctx, &r[3], "name=user", NULL);
+
+    ret = test_ev_loop(ctx->tctx);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(ctx->calls, 3);
+    assert_int_equal(r[3].ret, EOK);
+    assert_int_equal(r[3].error, 3);
+
+    talloc_free(ctx);
+}
+
+static void test_sss_dp_ipc_merge_cancel(void **state)
+{
+    struct test_dp_ipc_ctx *ctx;
+    struct test_dp_ipc_req r[2];
+    struct tevent_req *first;
+    int ret;
+
+    ctx = test_dp_ipc_setup();
+
+    first = test_dp_ipc_send(ctx, &r[0], "idnumber=1000", NULL);
+    test_dp_ipc_send(ctx, &r[1], "idnumber=1000", NULL);
+
+    /* cancelling the first request keeps the call for the second one */
+    talloc_free(first);
+
+    ctx->expected = 1;
+    ret = test_ev_loop(ctx->tctx);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(ctx->calls, 1);
+    assert_int_equal(r[1].ret, EOK);
+    assert_string_equal(r[1].error_message, "idnumber=1000");
+    assert_null(ctx->be_conn->ipc->pending);
+
+    talloc_free(ctx);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_sss_ipc_account_req),
+        cmocka_unit_test(test_sss_ipc_account_reply),
+        cmocka_unit_test(test_sss_ipc_conn),
+        cmocka_unit_test(test_sss_dp_ipc_merge),
+        cmocka_unit_test(test_sss_dp_ipc_merge_cancel),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
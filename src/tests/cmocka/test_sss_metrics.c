@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests/cmocka/common_mock.h"
+#include "util/sss_metrics.h"
+
+static int count_substr(const char *str, const char *substr)
+{
+    int count = 0;
+
+    while ((str = strstr(str, substr)) != NULL) {
+        count++;
+        str += strlen(substr);
+    }
+
+    return count;
+}
+
+void test_sss_metrics_dump(void **state)
+{
+    uint64_t now;
+    char *dump;
+    int i;
+
+    now = sss_metrics_now();
+    for (i = 0; i < 3; i++) {
+        sss_metrics_observe(SSS_METRICS_DP_REQ_DURATION,
+                            "test_target", "test_method", now);
+    }
+    sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS, "test_plugin", "cache");
+    sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS, "test_plugin", "cache");
+    sss_metrics_inc(SSS_METRICS_CACHE_REQ_LOOKUPS, "test\"plugin", "cache");
+
+    dump = sss_metrics_dump(global_talloc_context);
+    assert_non_null(dump);
+
+    assert_non_null(strstr(dump, "sssd_dp_req_duration_seconds_count{"));
+    assert_non_null(strstr(dump, "target=\"test_target\","
+                                 "method=\"test_method\"} 3\n"));
+    assert_non_null(strstr(dump, ",le=\"+Inf\"} 3\n"));
+    assert_non_null(strstr(dump, "quantile=\"0.99\""));
+    assert_non_null(strstr(dump, "plugin=\"test_plugin\","
+                                 "source=\"cache\"} 2\n"));
+    assert_non_null(strstr(dump, "plugin=\"test\\\"plugin\","
+                                 "source=\"cache\"} 1\n"));
+
+    talloc_free(dump);
+}
+
+void test_sss_metrics_format(void **state)
+{
+    const char *dumps[3];
+    char *dump;
+    char *out;
+
+    sss_metrics_inc(SSS_METRICS_LDAP_OP_TIMEOUTS, NULL, NULL);
+    sss_metrics_observe(SSS_METRICS_LDAP_OP_DURATION, "search", NULL,
+                        sss_metrics_now());
+
+    dump = sss_metrics_dump(global_talloc_context);
+    assert_non_null(dump);
+
+    dumps[0] = dump;
+    dumps[1] = dump;
+    dumps[2] = NULL;
+
+    out = sss_metrics_format(global_talloc_context, dumps);
+    assert_non_null(out);
+
+    assert_int_equal(count_substr(out,
+                         "# TYPE sssd_ldap_op_timeouts_total counter\n"), 1);
+    assert_int_equal(count_substr(out,
+                         "# TYPE sssd_ldap_op_duration_seconds histogram\n"),
+                     1);
+    assert_int_equal(count_substr(out, "sssd_ldap_op_timeouts_total{"), 2);
+    assert_int_equal(count_substr(out,
+                         "sssd_ldap_op_duration_seconds_count{"), 2);
+
+    talloc_free(out);
+    talloc_free(dump);
+}
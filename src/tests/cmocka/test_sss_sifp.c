@@ -1824,6 +1824,103 @@ void test_sss_sifp_fetch_object(void **state)
     assert_null(object);
 }
 
+void test_sss_sifp_fetch_users_attrs_by_name(void **state)
+{
+    sss_sifp_ctx *ctx = test_ctx.dbus_ctx;
+    DBusMessage *reply = test_ctx.reply;
+    DBusMessageIter iter;
+    DBusMessageIter array_iter;
+    DBusMessageIter user_iter;
+    DBusMessageIter dict_iter;
+    DBusMessageIter var_iter;
+    dbus_bool_t bret;
+    sss_sifp_error ret;
+    sss_sifp_attr ***users = NULL;
+    const char *names[] = {"user1", "missing", NULL};
+    const char *attrs[] = {"name", "uidNumber", NULL};
+    const char *attr_name = "uidNumber";
+    uint32_t uid = 1001;
+    uint32_t out;
+
+    /* prepare message, the second user was not found */
+    dbus_message_iter_init_append(reply, &iter);
+
+    bret = dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY,
+                                            DBUS_TYPE_ARRAY_AS_STRING
+                                            DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_TYPE_VARIANT_AS_STRING
+                                            DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                            &array_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_open_container(&array_iter, DBUS_TYPE_ARRAY,
+                                            DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_TYPE_VARIANT_AS_STRING
+                                            DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                            &user_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_open_container(&user_iter, DBUS_TYPE_DICT_ENTRY,
+                                            NULL, &dict_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_append_basic(&dict_iter, DBUS_TYPE_STRING,
+                                          &attr_name);
+    assert_true(bret);
+
+    bret = dbus_message_iter_open_container(&dict_iter, DBUS_TYPE_VARIANT,
+                                            DBUS_TYPE_UINT32_AS_STRING,
+                                            &var_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_append_basic(&var_iter, DBUS_TYPE_UINT32, &uid);
+    assert_true(bret);
+
+    bret = dbus_message_iter_close_container(&dict_iter, &var_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_close_container(&user_iter, &dict_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_close_container(&array_iter, &user_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_open_container(&array_iter, DBUS_TYPE_ARRAY,
+                                            DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_TYPE_VARIANT_AS_STRING
+                                            DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                            &user_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_close_container(&array_iter, &user_iter);
+    assert_true(bret);
+
+    bret = dbus_message_iter_close_container(&iter, &array_iter);
+    assert_true(bret);
+    will_return(__wrap_dbus_connection_send_with_reply_and_block, reply);
+
+    ret = sss_sifp_fetch_users_attrs_by_name(ctx, names, attrs, &users);
+    assert_int_equal(ret, SSS_SIFP_OK);
+    assert_non_null(users);
+
+    assert_non_null(users[0]);
+    ret = sss_sifp_find_attr_as_uint32(users[0], attr_name, &out);
+    assert_int_equal(ret, SSS_SIFP_OK);
+    assert_int_equal(out, uid);
+    assert_null(users[0][1]);
+
+    assert_non_null(users[1]);
+    assert_null(users[1][0]);
+
+    assert_null(users[2]);
+
+    sss_sifp_free_attrs_array(ctx, &users);
+    assert_null(users);
+}
+
 void test_sss_sifp_invoke_list_zeroargs(void **state)
 {
     sss_sifp_ctx *ctx = test_ctx.dbus_ctx;
@@ -2213,6 +2310,8 @@ int main(int argc, const char *argv[])
                                         test_setup, test_teardown_api),
         cmocka_unit_test_setup_teardown(test_sss_sifp_fetch_object,
                                         test_setup, test_teardown_api),
+        cmocka_unit_test_setup_teardown(test_sss_sifp_fetch_users_attrs_by_name,
+                                        test_setup, test_teardown_api),
         cmocka_unit_test_setup_teardown(test_sss_sifp_invoke_list_zeroargs,
                                         test_setup, test_teardown_api),
         cmocka_unit_test_setup_teardown(test_sss_sifp_invoke_list_withargs,
@@ -715,6 +715,39 @@ static void test_sysdb_enumpwent_views(void **state)
     check_enumpwent(ret, test_ctx->domain, res, true);
 }
 
+static void enum_names_to_entries(struct sss_domain_info *dom,
+                                  struct ldb_result *res,
+                                  bool group)
+{
+    struct ldb_message *msg;
+    size_t c;
+    int ret;
+
+    for (c = 0; c < res->count; c++) {
+        assert_null(ldb_msg_find_element(res->msgs[c],
+                                         group ? SYSDB_GIDNUM : SYSDB_UIDNUM));
+
+        ret = sysdb_enum_entry_with_views(res, dom, res->msgs[c]->dn, group,
+                                          &msg);
+        assert_int_equal(ret, EOK);
+        res->msgs[c] = msg;
+    }
+}
+
+static void test_sysdb_enumpwent_names_views(void **state)
+{
+    int ret;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                        struct sysdb_test_ctx);
+    struct ldb_result *res;
+
+    ret = sysdb_enumpwent_names_with_views(test_ctx, test_ctx->domain, &res);
+    assert_int_equal(ret, EOK);
+
+    enum_names_to_entries(test_ctx->domain, res, false);
+    check_enumpwent(ret, test_ctx->domain, res, true);
+}
+
 static void test_sysdb_enumpwent_filter(void **state)
 {
     int ret;
@@ -957,6 +990,20 @@ static void test_sysdb_enumgrent_views(void **state)
     check_enumgrent(ret, test_ctx->domain, res, true);
 }
 
+static void test_sysdb_enumgrent_names_views(void **state)
+{
+    int ret;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                        struct sysdb_test_ctx);
+    struct ldb_result *res;
+
+    ret = sysdb_enumgrent_names_with_views(test_ctx, test_ctx->domain, &res);
+    assert_int_equal(ret, EOK);
+
+    enum_names_to_entries(test_ctx->domain, res, true);
+    check_enumgrent(ret, test_ctx->domain, res, true);
+}
+
 static void test_sysdb_enumgrent_filter(void **state)
 {
     int ret;
@@ -1081,6 +1128,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_views,
                                         test_enum_users_setup,
                                         test_enum_users_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_names_views,
+                                        test_enum_users_setup,
+                                        test_enum_users_teardown),
         cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_filter,
                                         test_enum_users_setup,
                                         test_enum_users_teardown),
@@ -1093,6 +1143,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_views,
                                         test_enum_groups_setup,
                                         test_enum_groups_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_names_views,
+                                        test_enum_groups_setup,
+                                        test_enum_groups_teardown),
         cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_filter,
                                         test_enum_groups_setup,
                                         test_enum_groups_teardown),
@@ -2170,6 +2170,12 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sss_ptr_hash_without_cb,
                                         setup_leak_tests,
                                         teardown_leak_tests),
+        cmocka_unit_test_setup_teardown(test_sss_metrics_dump,
+                                        setup_leak_tests,
+                                        teardown_leak_tests),
+        cmocka_unit_test_setup_teardown(test_sss_metrics_format,
+                                        setup_leak_tests,
+                                        teardown_leak_tests),
         cmocka_unit_test_setup_teardown(test_sss_filter_sanitize_dn,
                                         setup_leak_tests,
                                         teardown_leak_tests),
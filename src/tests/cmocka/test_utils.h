@@ -39,5 +39,9 @@ void test_sss_ptr_hash_overwrite_with_free_cb(void **state);
 void test_sss_ptr_hash_with_lookup_cb(void **state);
 void test_sss_ptr_hash_without_cb(void **state);
 
+/* from src/tests/cmocka/test_sss_metrics.c */
+void test_sss_metrics_dump(void **state);
+void test_sss_metrics_format(void **state);
+
 
 #endif /* __TESTS__CMOCKA__TEST_UTILS_H__ */
@@ -27,6 +27,7 @@
 #include <talloc.h>
 #include <errno.h>
 #include <string.h>
+#include <inttypes.h>
 #include "util/util.h"
 #include "tests/common.h"
 
@@ -638,6 +639,69 @@ START_TEST(test_debug_is_set_false)
 }
 END_TEST
 
+START_TEST(test_debug_async)
+{
+    char filename[24] = {'\0'};
+    char line[256];
+    char expected[256];
+    FILE *file;
+    mode_t old_umask;
+    int count = 10000;
+    int fd;
+    int i;
+    errno_t ret;
+
+    strncpy(filename, "sssd_debug_tests.XXXXXX", 24);
+
+    old_umask = umask(SSS_DFL_UMASK);
+    fd = mkstemp(filename);
+    umask(old_umask);
+    fail_if(fd == -1, "mkstemp failed [%d]: %s", errno, strerror(errno));
+
+    ret = set_debug_file_from_fd(dup(fd));
+    fail_unless(ret == EOK, "set_debug_file_from_fd failed: %d", ret);
+
+    debug_timestamps = 0;
+    debug_microseconds = 0;
+    debug_prg_name = "sssd";
+    debug_level = SSSDBG_MASK_ALL;
+    sss_set_logger(sss_logger_str[FILES_LOGGER]);
+
+    ret = sss_debug_async_enable(true);
+    fail_unless(ret == EOK, "sss_debug_async_enable failed: %d", ret);
+
+    for (i = 0; i < count; i++) {
+        DEBUG(SSSDBG_TRACE_FUNC, "message %d\n", i);
+    }
+
+    /* drains the buffer */
+    ret = sss_debug_async_enable(false);
+    fail_unless(ret == EOK, "sss_debug_async_enable failed: %d", ret);
+    fail_unless(sss_debug_async_dropped() == 0,
+                "%"PRIu64" messages were dropped", sss_debug_async_dropped());
+
+    file = fdopen(fd, "r");
+    fail_if(file == NULL, "fdopen failed [%d]: %s", errno, strerror(errno));
+    /* the offset is shared with the debug file */
+    rewind(file);
+
+    for (i = 0; i < count; i++) {
+        fail_if(fgets(line, sizeof(line), file) == NULL,
+                "Only %d messages were written", i);
+
+        snprintf(expected, sizeof(expected),
+                 "[sssd] [%s] (%#.4x): message %d\n",
+                 __FUNCTION__, SSSDBG_TRACE_FUNC, i);
+        ck_assert_str_eq(line, expected);
+    }
+    fail_unless(fgets(line, sizeof(line), file) == NULL,
+                "Unexpected message: %s", line);
+
+    fclose(file);
+    unlink(filename);
+}
+END_TEST
+
 Suite *debug_suite(void)
 {
     Suite *s = suite_create("debug");
@@ -654,6 +718,7 @@ Suite *debug_suite(void)
     tcase_add_test(tc_debug, test_debug_is_notset_timestamp_microseconds);
     tcase_add_test(tc_debug, test_debug_is_set_true);
     tcase_add_test(tc_debug, test_debug_is_set_false);
+    tcase_add_test(tc_debug, test_debug_async);
     tcase_set_timeout(tc_debug, 60);
 
     suite_add_tcase(s, tc_debug);
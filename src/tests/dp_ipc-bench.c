@@ -0,0 +1,444 @@
+/*
+   SSSD
+
+   Benchmark of the responder to backend account request encoding
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <talloc.h>
+#include <popt.h>
+#include <dbus/dbus.h>
+
+#include "util/util.h"
+#include "sss_iface/sss_iface_ipc.h"
+
+/* Both variants send one getAccountInfo request and its reply over a
+ * socketpair and decode them on the other side, so the numbers include
+ * the message encoding, the copies and the syscalls. The sbus router,
+ * invokers and the event loop are not included, they only add to the
+ * D-Bus cost. */
+
+#define DEFAULT_ITERATIONS  100000
+#define DEFAULT_FILTER      "name=bench.user.with.a.longer.name@example.com"
+#define DEFAULT_DOMAIN      "example.com"
+
+#define BENCH_DBUS_HEADER   16
+
+static errno_t bench_write(int fd, const void *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        buf = (const uint8_t *)buf + n;
+        len -= n;
+    }
+
+    return EOK;
+}
+
+static errno_t bench_read(int fd, void *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = read(fd, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        } else if (n == 0) {
+            return ENOTCONN;
+        }
+        buf = (uint8_t *)buf + n;
+        len -= n;
+    }
+
+    return EOK;
+}
+
+static errno_t bench_ipc_recv(int fd, uint8_t *buf, uint8_t **_body,
+                              size_t *_len)
+{
+    size_t len;
+    errno_t ret;
+
+    ret = bench_read(fd, buf, SSS_IPC_HEADER_LEN);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    len = sss_ipc_frame_len(buf);
+    if (len < SSS_IPC_HEADER_LEN || len > SSS_IPC_MAX_FRAME) {
+        return EBADMSG;
+    }
+
+    ret = bench_read(fd, buf + SSS_IPC_HEADER_LEN, len - SSS_IPC_HEADER_LEN);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    *_body = buf + SSS_IPC_HEADER_LEN;
+    *_len = len - SSS_IPC_HEADER_LEN;
+
+    return EOK;
+}
+
+static errno_t bench_ipc_round_trip(TALLOC_CTX *mem_ctx, int *sv,
+                                    uint8_t *buf, const char *filter,
+                                    const char *domain, uint32_t serial)
+{
+    struct sss_ipc_account_req req = { 0 };
+    struct sss_ipc_account_reply reply = { 0 };
+    uint8_t *frame;
+    uint8_t *body;
+    size_t len;
+    errno_t ret;
+
+    req.dp_flags = 0;
+    req.entry_type = 1;
+    req.filter = filter;
+    req.domain = domain;
+    req.extra = NULL;
+
+    /* responder */
+    ret = sss_ipc_account_req_encode(mem_ctx, serial, &req, &frame);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = bench_write(sv[0], frame, sss_ipc_frame_len(frame));
+    talloc_free(frame);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* backend */
+    ret = bench_ipc_recv(sv[1], buf, &body, &len);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_ipc_account_req_decode(body, len, &req);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    reply.dp_error = 0;
+    reply.error = 0;
+    reply.error_message = "Success";
+
+    ret = sss_ipc_account_reply_encode(mem_ctx, serial, &reply, &frame);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = bench_write(sv[1], frame, sss_ipc_frame_len(frame));
+    talloc_free(frame);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* responder */
+    ret = bench_ipc_recv(sv[0], buf, &body, &len);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return sss_ipc_account_reply_decode(body, len, &reply);
+}
+
+static errno_t bench_dbus_send(int fd, DBusMessage *msg)
+{
+    char *data;
+    int len;
+    errno_t ret;
+
+    if (!dbus_message_marshal(msg, &data, &len)) {
+        return ENOMEM;
+    }
+
+    ret = bench_write(fd, data, len);
+    dbus_free(data);
+
+    return ret;
+}
+
+static errno_t bench_dbus_recv(int fd, char *buf, DBusMessage **_msg)
+{
+    DBusError error = DBUS_ERROR_INIT;
+    DBusMessage *msg;
+    int len;
+    errno_t ret;
+
+    ret = bench_read(fd, buf, BENCH_DBUS_HEADER);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    len = dbus_message_demarshal_bytes_needed(buf, BENCH_DBUS_HEADER);
+    if (len < BENCH_DBUS_HEADER || len > SSS_IPC_MAX_FRAME) {
+        return EBADMSG;
+    }
+
+    ret = bench_read(fd, buf + BENCH_DBUS_HEADER, len - BENCH_DBUS_HEADER);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    msg = dbus_message_demarshal(buf, len, &error);
+    if (msg == NULL) {
+        dbus_error_free(&error);
+        return EBADMSG;
+    }
+
+    *_msg = msg;
+
+    return EOK;
+}
+
+static errno_t bench_dbus_round_trip(int *sv, char *buf, const char *filter,
+                                     const char *domain, uint32_t serial)
+{
+    DBusError error = DBUS_ERROR_INIT;
+    DBusMessage *msg = NULL;
+    DBusMessage *reply = NULL;
+    dbus_uint32_t dp_flags = 0;
+    dbus_uint32_t entry_type = 1;
+    dbus_uint16_t dp_error = 0;
+    dbus_uint32_t err = 0;
+    const char *extra = "";
+    const char *error_message = "Success";
+    errno_t ret;
+
+    /* responder */
+    msg = dbus_message_new_method_call("sssd.domain_example_2ecom", "/sssd",
+                                       "sssd.dataprovider", "getAccountInfo");
+    if (msg == NULL) {
+        return ENOMEM;
+    }
+
+    dbus_message_set_serial(msg, serial);
+    if (!dbus_message_append_args(msg,
+                                  DBUS_TYPE_UINT32, &dp_flags,
+                                  DBUS_TYPE_UINT32, &entry_type,
+                                  DBUS_TYPE_STRING, &filter,
+                                  DBUS_TYPE_STRING, &domain,
+                                  DBUS_TYPE_STRING, &extra,
+                                  DBUS_TYPE_INVALID)) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = bench_dbus_send(sv[0], msg);
+    dbus_message_unref(msg);
+    msg = NULL;
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* backend */
+    ret = bench_dbus_recv(sv[1], buf, &msg);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (!dbus_message_get_args(msg, &error,
+                               DBUS_TYPE_UINT32, &dp_flags,
+                               DBUS_TYPE_UINT32, &entry_type,
+                               DBUS_TYPE_STRING, &filter,
+                               DBUS_TYPE_STRING, &domain,
+                               DBUS_TYPE_STRING, &extra,
+                               DBUS_TYPE_INVALID)) {
+        ret = EBADMSG;
+        goto done;
+    }
+
+    reply = dbus_message_new_method_return(msg);
+    if (reply == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    dbus_message_set_serial(reply, serial);
+    if (!dbus_message_append_args(reply,
+                                  DBUS_TYPE_UINT16, &dp_error,
+                                  DBUS_TYPE_UINT32, &err,
+                                  DBUS_TYPE_STRING, &error_message,
+                                  DBUS_TYPE_INVALID)) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = bench_dbus_send(sv[1], reply);
+    dbus_message_unref(reply);
+    reply = NULL;
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* responder */
+    ret = bench_dbus_recv(sv[0], buf, &reply);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (!dbus_message_get_args(reply, &error,
+                               DBUS_TYPE_UINT16, &dp_error,
+                               DBUS_TYPE_UINT32, &err,
+                               DBUS_TYPE_STRING, &error_message,
+                               DBUS_TYPE_INVALID)) {
+        ret = EBADMSG;
+        goto done;
+    }
+
+    ret = EOK;
+
+done:
+    dbus_error_free(&error);
+    if (msg != NULL) {
+        dbus_message_unref(msg);
+    }
+    if (reply != NULL) {
+        dbus_message_unref(reply);
+    }
+
+    return ret;
+}
+
+static double bench_elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+           + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void bench_report(const char *label, int iterations, double elapsed)
+{
+    printf("%-8s %d round trips in %.3f s, %.2f us per round trip\n",
+           label, iterations, elapsed, elapsed * 1e6 / iterations);
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_iterations = DEFAULT_ITERATIONS;
+    const char *pc_filter = DEFAULT_FILTER;
+    const char *pc_domain = DEFAULT_DOMAIN;
+    TALLOC_CTX *ctx;
+    struct timespec start;
+    uint8_t *buf;
+    int sv[2] = { -1, -1 };
+    int ret;
+    int i;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "iterations", 'i', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_iterations, 0,
+                    "Number of round trips", NULL },
+        { "filter", 'f', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_filter, 0,
+                    "Filter sent in the request", NULL },
+        { "domain", 'd', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_domain, 0,
+                    "Domain sent in the request", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_iterations <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    ctx = talloc_new(NULL);
+    if (ctx == NULL) {
+        return 1;
+    }
+
+    buf = talloc_size(ctx, SSS_IPC_MAX_FRAME);
+    if (buf == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    if (ret != 0) {
+        ret = errno;
+        fprintf(stderr, "socketpair failed: %s\n", strerror(ret));
+        goto done;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < pc_iterations; i++) {
+        ret = bench_dbus_round_trip(sv, (char *)buf, pc_filter, pc_domain,
+                                    i + 1);
+        if (ret != EOK) {
+            fprintf(stderr, "D-Bus round trip failed: %s\n", strerror(ret));
+            goto done;
+        }
+    }
+    bench_report("dbus", pc_iterations, bench_elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < pc_iterations; i++) {
+        ret = bench_ipc_round_trip(ctx, sv, buf, pc_filter, pc_domain,
+                                   i + 1);
+        if (ret != EOK) {
+            fprintf(stderr, "Binary round trip failed: %s\n", strerror(ret));
+            goto done;
+        }
+    }
+    bench_report("binary", pc_iterations, bench_elapsed(&start));
+
+    ret = EOK;
+
+done:
+    if (sv[0] != -1) {
+        close(sv[0]);
+        close(sv[1]);
+    }
+    talloc_free(ctx);
+    return ret == EOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
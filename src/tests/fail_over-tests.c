@@ -289,6 +289,305 @@ START_TEST(test_fo_resolve_service)
 }
 END_TEST
 
+START_TEST(test_fo_latency_selection)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    struct fo_server *first;
+    struct fo_server *second;
+    struct fo_options fopts;
+    const char **servers;
+    uint32_t *latency;
+    int ret;
+
+    ctx = setup_test();
+    fail_if(ctx == NULL, "Failed to allocate memory");
+
+    memset(&fopts, 0, sizeof(fopts));
+    fopts.retry_timeout = 30;
+    fopts.family_order = IPV4_FIRST;
+    fopts.latency_selection = true;
+    fopts.latency_tolerance = 20;
+
+    talloc_free(ctx->fo_ctx);
+    ctx->fo_ctx = fo_context_init(ctx, &fopts);
+    fail_if(ctx->fo_ctx == NULL, "Could not init fail over context");
+
+    ret = fo_new_service(ctx->fo_ctx, "ldap", NULL, &service);
+    fail_if(ret != EOK, "fo_new_service failed with error: %d", ret);
+
+    ret = fo_add_server(service, "localhost", 389, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 636, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 3268, NULL, false);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+
+    /* Servers without latency are tried in the configured order. */
+    get_request(ctx, service, EOK, 389, PORT_WORKING, -1);
+    first = fo_get_active_server(service);
+    fail_if(first == NULL, "Missing active server");
+
+    fo_set_server_latency(first, FO_LATENCY_CONNECT, 1000);
+    fail_if(fo_get_server_latency(first) != 1000,
+            "Unexpected latency %u", fo_get_server_latency(first));
+
+    /* Active server is kept while there is no faster peer. */
+    get_request(ctx, service, EOK, 389, -1, -1);
+
+    /* Measure the second primary server. */
+    fo_try_next_server(service);
+    get_request(ctx, service, EOK, 636, PORT_WORKING, -1);
+    second = fo_get_active_server(service);
+    fail_if(second == NULL, "Missing active server");
+    fo_set_server_latency(second, FO_LATENCY_CONNECT, 100);
+    fo_set_server_latency(second, FO_LATENCY_RESPONSE, 20000);
+
+    /* The first server is faster but it does not work. */
+    fail_if(fo_get_active_server(service) != second,
+            "Server was demoted in favor of a non-working server");
+
+    /* Once the first server works again the slow server is demoted. */
+    fo_set_port_status(first, PORT_NEUTRAL);
+    fo_set_server_latency(second, FO_LATENCY_RESPONSE, 20000);
+    fail_if(fo_get_active_server(service) != NULL,
+            "Slow server is still active");
+    get_request(ctx, service, EOK, 389, -1, -1);
+
+    /* The faster server is preferred over the next server in the list. */
+    fo_set_server_latency(first, FO_LATENCY_RESPONSE, 50000);
+    get_request(ctx, service, EOK, 636, -1, -1);
+
+    /* Backup servers are never measured nor preferred here. */
+    ret = fo_svc_server_latency_list(ctx, service, &servers, &latency);
+    fail_if(ret != EOK, "fo_svc_server_latency_list failed: %d", ret);
+    fail_if(talloc_array_length(latency) != 3, "Wrong number of servers");
+    fail_if(strcmp(servers[0], "localhost") != 0, "Wrong server name");
+    fail_if(latency[0] != 1000 + 50000, "Unexpected latency %u", latency[0]);
+    fail_if(latency[1] != 100 + 20000, "Unexpected latency %u", latency[1]);
+    fail_if(latency[2] != 0, "Unexpected latency %u", latency[2]);
+    fail_if(servers[3] != NULL, "Server list is not NULL terminated");
+
+    talloc_free(ctx);
+}
+END_TEST
+
+static void
+test_latency_probe(const char *service_name,
+                   struct fo_server *server,
+                   void *pvt)
+{
+    int *probed_port = talloc_get_type(pvt, int);
+
+    fail_if(strcmp(service_name, "ldap") != 0, "Wrong service name");
+    fail_if(*probed_port != 0, "Server probed more than once");
+    *probed_port = fo_get_server_port(server);
+
+    fo_set_server_latency(server, FO_LATENCY_CONNECT, 100);
+}
+
+START_TEST(test_fo_latency_probe)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    struct fo_server *first;
+    struct fo_options fopts;
+    int *probed_port;
+    int ret;
+
+    ctx = setup_test();
+    fail_if(ctx == NULL, "Failed to allocate memory");
+
+    memset(&fopts, 0, sizeof(fopts));
+    fopts.retry_timeout = 30;
+    fopts.family_order = IPV4_FIRST;
+    fopts.latency_selection = true;
+    fopts.latency_tolerance = 20;
+
+    talloc_free(ctx->fo_ctx);
+    ctx->fo_ctx = fo_context_init(ctx, &fopts);
+    fail_if(ctx->fo_ctx == NULL, "Could not init fail over context");
+
+    probed_port = talloc_zero(ctx, int);
+    fail_if(probed_port == NULL, "Failed to allocate memory");
+    fo_set_latency_probe_plugin(ctx->fo_ctx, test_latency_probe, probed_port);
+
+    ret = fo_new_service(ctx->fo_ctx, "ldap", NULL, &service);
+    fail_if(ret != EOK, "fo_new_service failed with error: %d", ret);
+
+    ret = fo_add_server(service, "localhost", 389, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 636, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 3268, NULL, false);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+
+    /* The unmeasured peer of the same class is probed, the backup is not. */
+    get_request(ctx, service, EOK, 389, PORT_WORKING, -1);
+    fail_if(*probed_port != 636, "Unexpected probed port %d", *probed_port);
+
+    first = fo_get_active_server(service);
+    fail_if(first == NULL, "Missing active server");
+
+    /* The probed peer is faster, so the active server is demoted... */
+    fo_set_server_latency(first, FO_LATENCY_CONNECT, 1000);
+    fail_if(fo_get_active_server(service) != NULL,
+            "Slow server is still active");
+
+    /* ...and the probed peer is used even though it never had a
+     * connection. */
+    get_request(ctx, service, EOK, 636, PORT_WORKING, -1);
+
+    talloc_free(ctx);
+}
+END_TEST
+
+START_TEST(test_fo_latency_overflow)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    struct fo_server *server;
+    struct fo_options fopts;
+    int ret;
+
+    ctx = setup_test();
+    fail_if(ctx == NULL, "Failed to allocate memory");
+
+    memset(&fopts, 0, sizeof(fopts));
+    fopts.retry_timeout = 30;
+    fopts.family_order = IPV4_FIRST;
+
+    talloc_free(ctx->fo_ctx);
+    ctx->fo_ctx = fo_context_init(ctx, &fopts);
+    fail_if(ctx->fo_ctx == NULL, "Could not init fail over context");
+
+    ret = fo_new_service(ctx->fo_ctx, "ldap", NULL, &service);
+    fail_if(ret != EOK, "fo_new_service failed with error: %d", ret);
+
+    ret = fo_add_server(service, "localhost", 389, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+
+    get_request(ctx, service, EOK, 389, PORT_WORKING, -1);
+    server = fo_get_active_server(service);
+    fail_if(server == NULL, "Missing active server");
+
+    /* The sum must not wrap around. */
+    fo_set_server_latency(server, FO_LATENCY_CONNECT, UINT32_MAX - 10);
+    fo_set_server_latency(server, FO_LATENCY_RESPONSE, 100);
+    fail_if(fo_get_server_latency(server) != UINT32_MAX,
+            "Unexpected latency %u", fo_get_server_latency(server));
+
+    talloc_free(ctx);
+}
+END_TEST
+
+START_TEST(test_fo_probe)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    struct fo_server **servers;
+    struct fo_server *first;
+    int ret;
+
+    ctx = setup_test();
+    fail_if(ctx == NULL, "Failed to allocate memory");
+
+    ret = fo_new_service(ctx->fo_ctx, "ldap", NULL, &service);
+    fail_if(ret != EOK, "fo_new_service failed with error: %d", ret);
+
+    ret = fo_add_server(service, "127.0.0.1", 3268, NULL, false);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "localhost", 389, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 636, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+
+    get_request(ctx, service, EOK, 389, PORT_WORKING, -1);
+    first = fo_get_active_server(service);
+    fail_if(first == NULL, "Missing active server");
+
+    /* Active server first, then primary servers before backup servers. */
+    ret = fo_svc_probe_candidates(ctx, service, 2, &servers);
+    fail_if(ret != EOK, "fo_svc_probe_candidates failed: %d", ret);
+    fail_if(servers[0] != first, "Active server is not probed first");
+    fail_if(fo_get_server_port(servers[1]) != 636, "Wrong second candidate");
+    fail_if(servers[2] != NULL, "Candidate list is too long");
+    talloc_free(servers);
+
+    ret = fo_svc_probe_candidates(ctx, service, 5, &servers);
+    fail_if(ret != EOK, "fo_svc_probe_candidates failed: %d", ret);
+    fail_if(fo_get_server_port(servers[2]) != 3268, "Wrong third candidate");
+    fail_if(servers[3] != NULL, "Candidate list is not NULL terminated");
+    talloc_free(servers);
+
+    /* Failed probe of the active server switches to the next one. */
+    fo_set_server_probe_result(first, false);
+    fail_if(fo_get_active_server(service) != NULL,
+            "Unreachable server is still active");
+    get_request(ctx, service, EOK, 636, PORT_WORKING, -1);
+
+    /* Successful probe makes the server usable again right away. */
+    fo_set_server_probe_result(first, true);
+    fo_set_server_probe_result(fo_get_active_server(service), false);
+    get_request(ctx, service, EOK, 389, -1, -1);
+
+    talloc_free(ctx);
+}
+END_TEST
+
+START_TEST(test_fo_probe_failures)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    struct fo_server *first;
+    struct fo_options fopts;
+    int ret;
+
+    ctx = setup_test();
+    fail_if(ctx == NULL, "Failed to allocate memory");
+
+    memset(&fopts, 0, sizeof(fopts));
+    fopts.retry_timeout = 30;
+    fopts.family_order = IPV4_FIRST;
+    fopts.probe_failures = 3;
+
+    talloc_free(ctx->fo_ctx);
+    ctx->fo_ctx = fo_context_init(ctx, &fopts);
+    fail_if(ctx->fo_ctx == NULL, "Could not init fail over context");
+
+    ret = fo_new_service(ctx->fo_ctx, "ldap", NULL, &service);
+    fail_if(ret != EOK, "fo_new_service failed with error: %d", ret);
+
+    ret = fo_add_server(service, "localhost", 389, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+    ret = fo_add_server(service, "127.0.0.1", 636, NULL, true);
+    fail_if(ret != EOK, "fo_add_server failed with error: %d", ret);
+
+    get_request(ctx, service, EOK, 389, PORT_WORKING, -1);
+    first = fo_get_active_server(service);
+    fail_if(first == NULL, "Missing active server");
+
+    /* A successful probe resets the count of failures. */
+    fail_if(fo_set_server_probe_result(first, false), "Demoted too early");
+    fail_if(fo_set_server_probe_result(first, false), "Demoted too early");
+    fail_if(fo_set_server_probe_result(first, true), "Demoted on success");
+    fail_if(fo_set_server_probe_result(first, false), "Demoted too early");
+    fail_if(fo_set_server_probe_result(first, false), "Demoted too early");
+    fail_if(fo_get_active_server(service) != first,
+            "Server was demoted before reaching the threshold");
+
+    fail_if(!fo_set_server_probe_result(first, false),
+            "Server was not demoted after reaching the threshold");
+    fail_if(fo_get_active_server(service) != NULL,
+            "Unreachable server is still active");
+    fail_if(fo_set_server_probe_result(first, false),
+            "Server was demoted twice");
+    get_request(ctx, service, EOK, 636, PORT_WORKING, -1);
+
+    talloc_free(ctx);
+}
+END_TEST
+
 Suite *
 create_suite(void)
 {
@@ -300,6 +599,11 @@ create_suite(void)
     /* Do some testing */
     tcase_add_test(tc, test_fo_new_service);
     tcase_add_test(tc, test_fo_resolve_service);
+    tcase_add_test(tc, test_fo_latency_selection);
+    tcase_add_test(tc, test_fo_latency_overflow);
+    tcase_add_test(tc, test_fo_latency_probe);
+    tcase_add_test(tc, test_fo_probe);
+    tcase_add_test(tc, test_fo_probe_failures);
     if (use_net_test) {
     }
     /* Add all test cases to the test suite */
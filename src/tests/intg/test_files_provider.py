@@ -996,6 +996,34 @@ def test_getgrnam_user_member_and_ghost(setup_pw_with_canary,
                           True)
 
 
+def test_getgrnam_remove_readd_member(setup_pw_with_canary,
+                                     setup_gr_with_canary,
+                                     files_domain_only):
+    """
+    Test that a group member which is removed from and added to passwd
+    again is linked with the unchanged group again
+    """
+    user_and_group_setup(setup_pw_with_canary,
+                         setup_gr_with_canary,
+                         [USER1, USER2],
+                         [GROUP12],
+                         False)
+    members_check([GROUP12])
+
+    setup_pw_with_canary.userdel(USER2["name"])
+    time.sleep(1)
+    res, _ = call_sssd_getpwnam(USER2["name"])
+    assert res == NssReturnCode.NOTFOUND
+
+    # user2 is a ghost member now
+    res, group = call_sssd_getgrnam(GROUP12["name"])
+    assert res == NssReturnCode.NOTFOUND
+
+    setup_pw_with_canary.useradd(**USER2)
+    check_user(USER2)
+    members_check([GROUP12])
+
+
 def test_getgrnam_add_remove_members(setup_pw_with_canary,
                                      add_group_nomem_with_canary,
                                      files_domain_only):
@@ -0,0 +1,280 @@
+/*
+   SSSD
+
+   Benchmark of the HBAC evaluator
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <talloc.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "lib/ipa_hbac/ipa_hbac.h"
+
+#define DEFAULT_RULES       1000
+#define DEFAULT_GROUPS      50
+#define DEFAULT_ITERATIONS  1000
+
+/* Every rule allows one user and one user group to use one service on
+ * all hosts. The group of rule i is "group<i>", so a user that is
+ * member of groups 0..num_groups-1 matches the rules with these indexes
+ * as long as the service matches. */
+static struct hbac_rule_element *bench_element(TALLOC_CTX *mem_ctx,
+                                               const char *name,
+                                               const char *group)
+{
+    struct hbac_rule_element *el;
+
+    el = talloc_zero(mem_ctx, struct hbac_rule_element);
+    if (el == NULL) {
+        return NULL;
+    }
+
+    if (name == NULL && group == NULL) {
+        el->category = HBAC_CATEGORY_ALL;
+        return el;
+    }
+
+    el->category = HBAC_CATEGORY_NULL;
+    el->names = talloc_zero_array(el, const char *, 2);
+    el->groups = talloc_zero_array(el, const char *, 2);
+    if (el->names == NULL || el->groups == NULL) {
+        return NULL;
+    }
+
+    el->names[0] = name;
+    el->groups[0] = group;
+
+    return el;
+}
+
+static struct hbac_rule **bench_rules(TALLOC_CTX *mem_ctx, int num_rules)
+{
+    struct hbac_rule **rules;
+    struct hbac_rule *rule;
+    int i;
+
+    rules = talloc_zero_array(mem_ctx, struct hbac_rule *, num_rules + 1);
+    if (rules == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < num_rules; i++) {
+        rule = talloc_zero(rules, struct hbac_rule);
+        if (rule == NULL) {
+            return NULL;
+        }
+
+        rule->enabled = true;
+        rule->name = talloc_asprintf(rule, "rule%d", i);
+        rule->users = bench_element(rule,
+                                    talloc_asprintf(rule, "user%d", i),
+                                    talloc_asprintf(rule, "group%d", i));
+        rule->services = bench_element(rule,
+                                       talloc_asprintf(rule, "service%d", i),
+                                       NULL);
+        rule->targethosts = bench_element(rule, NULL, NULL);
+        rule->srchosts = bench_element(rule, NULL, NULL);
+        if (rule->name == NULL || rule->users == NULL
+                || rule->services == NULL || rule->targethosts == NULL
+                || rule->srchosts == NULL) {
+            return NULL;
+        }
+
+        rules[i] = rule;
+    }
+
+    return rules;
+}
+
+static struct hbac_request_element *bench_req_element(TALLOC_CTX *mem_ctx,
+                                                      const char *name,
+                                                      int num_groups)
+{
+    struct hbac_request_element *el;
+    int i;
+
+    el = talloc_zero(mem_ctx, struct hbac_request_element);
+    if (el == NULL) {
+        return NULL;
+    }
+
+    el->name = name;
+    el->groups = talloc_zero_array(el, const char *, num_groups + 1);
+    if (el->groups == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < num_groups; i++) {
+        el->groups[i] = talloc_asprintf(el->groups, "group%d", i);
+        if (el->groups[i] == NULL) {
+            return NULL;
+        }
+    }
+
+    return el;
+}
+
+static double bench_elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+           + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static errno_t bench_run(struct hbac_rule **rules,
+                         struct hbac_compiled_rules *compiled,
+                         struct hbac_eval_req *req,
+                         int iterations,
+                         const char *label)
+{
+    enum hbac_eval_result result = HBAC_EVAL_ERROR;
+    struct hbac_info *info;
+    struct timespec start;
+    double elapsed;
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < iterations; i++) {
+        info = NULL;
+        if (compiled != NULL) {
+            result = hbac_evaluate_compiled(compiled, req, &info);
+        } else {
+            result = hbac_evaluate(rules, req, &info);
+        }
+        hbac_free_info(info);
+
+        if (result != HBAC_EVAL_ALLOW && result != HBAC_EVAL_DENY) {
+            fprintf(stderr, "Evaluation failed: %s\n",
+                    hbac_result_string(result));
+            return EIO;
+        }
+    }
+
+    elapsed = bench_elapsed(&start);
+    printf("%-10s %s, %d evaluations in %.3f s, %.2f us per evaluation\n",
+           label, hbac_result_string(result), iterations, elapsed,
+           elapsed * 1e6 / iterations);
+
+    return EOK;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_rules = DEFAULT_RULES;
+    int pc_groups = DEFAULT_GROUPS;
+    int pc_iterations = DEFAULT_ITERATIONS;
+    TALLOC_CTX *ctx;
+    struct hbac_rule **rules;
+    struct hbac_eval_req *req;
+    struct hbac_compiled_rules *compiled = NULL;
+    struct timespec start;
+    enum hbac_error_code code;
+    char *service;
+    int ret;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "rules", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_rules, 0,
+                    "Number of HBAC rules", NULL },
+        { "groups", 'g', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_groups, 0,
+                    "Number of groups the user is member of", NULL },
+        { "iterations", 'i', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_iterations, 0,
+                    "Number of evaluations", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_rules <= 0 || pc_groups < 0 || pc_iterations <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    ctx = talloc_new(NULL);
+    if (ctx == NULL) {
+        return 1;
+    }
+
+    rules = bench_rules(ctx, pc_rules);
+    req = talloc_zero(ctx, struct hbac_eval_req);
+    if (rules == NULL || req == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* The service of the last rule makes sure that all rules have to be
+     * looked at by the plain evaluator */
+    service = talloc_asprintf(ctx, "service%d", pc_rules - 1);
+    req->user = bench_req_element(req, "nosuchuser", pc_groups);
+    req->service = bench_req_element(req, service, 0);
+    req->targethost = bench_req_element(req, "host.example.com", 0);
+    req->srchost = bench_req_element(req, "client.example.com", 0);
+    if (service == NULL || req->user == NULL || req->service == NULL
+            || req->targethost == NULL || req->srchost == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    printf("%d rules, user in %d groups\n", pc_rules, pc_groups);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    code = hbac_rules_compile(rules, &compiled);
+    if (code != HBAC_SUCCESS) {
+        fprintf(stderr, "Cannot compile rules: %s\n",
+                hbac_error_string(code));
+        ret = EIO;
+        goto done;
+    }
+    printf("compiled in %.3f ms\n", bench_elapsed(&start) * 1e3);
+
+    ret = bench_run(rules, NULL, req, pc_iterations, "plain");
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = bench_run(rules, compiled, req, pc_iterations, "compiled");
+    if (ret != EOK) {
+        goto done;
+    }
+
+done:
+    hbac_free_compiled_rules(compiled);
+    talloc_free(ctx);
+    return ret == EOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -835,6 +835,136 @@ START_TEST(ipa_hbac_test_allow_srchostgroup)
 }
 END_TEST
 
+static void check_compiled_result(struct hbac_rule **rules,
+                                  struct hbac_eval_req *eval_req,
+                                  enum hbac_eval_result expected,
+                                  const char *expected_rule)
+{
+    struct hbac_compiled_rules *compiled = NULL;
+    struct hbac_info *info = NULL;
+    struct hbac_info *compiled_info = NULL;
+    enum hbac_error_code code;
+    enum hbac_eval_result result;
+    enum hbac_eval_result compiled_result;
+
+    code = hbac_rules_compile(rules, &compiled);
+    fail_unless(code == HBAC_SUCCESS,
+                "hbac_rules_compile failed: [%s]", hbac_error_string(code));
+
+    result = hbac_evaluate(rules, eval_req, &info);
+    compiled_result = hbac_evaluate_compiled(compiled, eval_req,
+                                             &compiled_info);
+
+    fail_unless(result == expected,
+                "Expected [%s], got [%s]",
+                hbac_result_string(expected),
+                hbac_result_string(result));
+    fail_unless(compiled_result == result,
+                "Compiled result [%s] differs from [%s]",
+                hbac_result_string(compiled_result),
+                hbac_result_string(result));
+    fail_unless(compiled_info->code == info->code,
+                "Compiled error [%s] differs from [%s]",
+                hbac_error_string(compiled_info->code),
+                hbac_error_string(info->code));
+
+    if (expected_rule == NULL) {
+        fail_unless(compiled_info->rule_name == NULL,
+                    "Unexpected rule [%s]", compiled_info->rule_name);
+    } else {
+        fail_if(compiled_info->rule_name == NULL, "Missing rule name");
+        fail_unless(strcmp(compiled_info->rule_name, expected_rule) == 0,
+                    "Expected rule [%s], got [%s]",
+                    expected_rule, compiled_info->rule_name);
+    }
+
+    hbac_free_info(info);
+    hbac_free_info(compiled_info);
+    hbac_free_compiled_rules(compiled);
+}
+
+START_TEST(ipa_hbac_test_compiled)
+{
+    TALLOC_CTX *test_ctx;
+    struct hbac_rule **rules;
+    struct hbac_eval_req *eval_req;
+    struct hbac_rule_element *services;
+
+    test_ctx = talloc_new(global_talloc_context);
+
+    /* Create a request */
+    eval_req = talloc_zero(test_ctx, struct hbac_eval_req);
+    fail_if (eval_req == NULL, "Failed to allocate memory");
+
+    get_test_user(eval_req, &eval_req->user);
+    get_test_service(eval_req, &eval_req->service);
+    get_test_srchost(eval_req, &eval_req->srchost);
+
+    /* Create the rules to evaluate against */
+    rules = talloc_array(test_ctx, struct hbac_rule *, 4);
+    fail_if (rules == NULL, "Failed to allocate memory");
+
+    /* A disabled rule that would allow everything */
+    get_allow_all_rule(rules, &rules[0]);
+    rules[0]->name = "Disabled";
+    rules[0]->enabled = false;
+
+    /* A rule for a different user */
+    get_allow_all_rule(rules, &rules[1]);
+    rules[1]->name = "Other user";
+    rules[1]->users->category = HBAC_CATEGORY_NULL;
+    rules[1]->users->names = talloc_array(rules[1], const char *, 2);
+    fail_if(rules[1]->users->names == NULL, "Failed to allocate memory");
+    rules[1]->users->names[0] = HBAC_TEST_INVALID_USER;
+    rules[1]->users->names[1] = NULL;
+
+    /* A rule for a group of the user and a service group, the names
+     * differ in case only */
+    get_allow_all_rule(rules, &rules[2]);
+    rules[2]->name = "Allow group";
+    rules[2]->users->category = HBAC_CATEGORY_NULL;
+    rules[2]->users->groups = talloc_array(rules[2], const char *, 3);
+    fail_if(rules[2]->users->groups == NULL, "Failed to allocate memory");
+    rules[2]->users->groups[0] = HBAC_TEST_INVALID_GROUP;
+    rules[2]->users->groups[1] = "TestGroup2";
+    rules[2]->users->groups[2] = NULL;
+    rules[2]->services->category = HBAC_CATEGORY_NULL;
+    rules[2]->services->groups = talloc_array(rules[2], const char *, 2);
+    fail_if(rules[2]->services->groups == NULL, "Failed to allocate memory");
+    rules[2]->services->groups[0] = HBAC_TEST_SERVICEGROUP1;
+    rules[2]->services->groups[1] = NULL;
+
+    rules[3] = NULL;
+
+    check_compiled_result(rules, eval_req, HBAC_EVAL_ALLOW, "Allow group");
+
+    /* Negative test - the service is not in the group */
+    rules[2]->services->groups[0] = HBAC_TEST_INVALID_SERVICEGROUP;
+    check_compiled_result(rules, eval_req, HBAC_EVAL_DENY, NULL);
+
+    /* An earlier rule with a missing element yields an error even though
+     * it would not match */
+    rules[2]->services->groups[0] = HBAC_TEST_SERVICEGROUP1;
+    services = rules[1]->services;
+    rules[1]->services = NULL;
+    check_compiled_result(rules, eval_req, HBAC_EVAL_ERROR, "Other user");
+    rules[1]->services = services;
+
+    /* UTF-8 names are compared case-insensitively as well */
+    eval_req->user->name = (const char *) &user_utf8_lowcase;
+    rules[1]->users->names[0] = (const char *) &user_utf8_upcase;
+    check_compiled_result(rules, eval_req, HBAC_EVAL_ALLOW, "Other user");
+
+    /* Negative test - Turkish dotless i */
+    eval_req->user->name = (const char *) &user_lowcase_tr;
+    rules[1]->users->names[0] = (const char *) &user_upcase_tr;
+    rules[2]->users->groups[1] = HBAC_TEST_INVALID_GROUP;
+    check_compiled_result(rules, eval_req, HBAC_EVAL_DENY, NULL);
+
+    talloc_free(test_ctx);
+}
+END_TEST
+
 START_TEST(ipa_hbac_test_incomplete)
 {
     TALLOC_CTX *test_ctx;
@@ -880,6 +1010,7 @@ Suite *hbac_test_suite (void)
     tcase_add_test(tc_hbac, ipa_hbac_test_allow_srchostgroup);
     tcase_add_test(tc_hbac, ipa_hbac_test_allow_utf8);
     tcase_add_test(tc_hbac, ipa_hbac_test_incomplete);
+    tcase_add_test(tc_hbac, ipa_hbac_test_compiled);
 
     suite_add_tcase(s, tc_hbac);
     return s;
@@ -431,6 +431,52 @@ class PyHbacRequestTest(unittest.TestCase):
         res = req.evaluate((allow_rule, ))
         self.assertEqual(res, pyhbac.HBAC_EVAL_ALLOW)
 
+    def testEvaluateRuleSet(self):
+        name = "someuser"
+        service = "ssh"
+        srchost = "host1"
+        targethost = "host2"
+
+        deny_rule = pyhbac.HbacRule("otherRule", enabled=True)
+        deny_rule.users.names = ["someotheruser"]
+        deny_rule.services.names = [service]
+        deny_rule.srchosts.names = [srchost]
+        deny_rule.targethosts.names = [targethost]
+
+        allow_rule = pyhbac.HbacRule("allowRule", enabled=True)
+        allow_rule.users.groups = ["SomeGroup"]
+        allow_rule.services.names = [service]
+        allow_rule.srchosts.category.add(pyhbac.HBAC_CATEGORY_ALL)
+        allow_rule.targethosts.names = [targethost]
+
+        rules = pyhbac.HbacRuleSet((deny_rule, allow_rule))
+
+        req = pyhbac.HbacRequest()
+        req.user.name = name
+        req.user.groups = ["somegroup"]
+        req.service.name = service
+        req.srchost.name = srchost
+        req.targethost.name = targethost
+
+        res = req.evaluate(rules)
+        self.assertEqual(res, pyhbac.HBAC_EVAL_ALLOW)
+        self.assertEqual(req.rule_name, "allowRule")
+
+        # The rule set is a snapshot of the rules
+        allow_rule.enabled = False
+        res = req.evaluate(rules)
+        self.assertEqual(res, pyhbac.HBAC_EVAL_ALLOW)
+        res = req.evaluate((deny_rule, allow_rule))
+        self.assertEqual(res, pyhbac.HBAC_EVAL_DENY)
+
+        req.user.groups = []
+        res = req.evaluate(rules)
+        self.assertEqual(res, pyhbac.HBAC_EVAL_DENY)
+        self.assertEqual(req.rule_name, None)
+
+        self.assertRaises(TypeError, pyhbac.HbacRuleSet, (allow_rule, None))
+        self.assertRaises(TypeError, pyhbac.HbacRuleSet, None)
+
     def testRepr(self):
         name = "someuser"
         service = "ssh"
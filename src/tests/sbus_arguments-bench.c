@@ -0,0 +1,213 @@
+/*
+   SSSD
+
+   Benchmark of the generated sbus argument readers
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <talloc.h>
+#include <popt.h>
+#include <dbus/dbus.h>
+
+#include "util/util.h"
+#include "sss_iface/sbus_sss_arguments.h"
+
+/* Reads the arguments of one getAccountInfo call the way the invoker does
+ * it, once with the copying reader and once with the borrowing one. The
+ * message is built only once, so only the argument parsing is measured. */
+
+#define DEFAULT_ITERATIONS  1000000
+#define DEFAULT_FILTER      "name=bench.user.with.a.longer.name@example.com"
+#define DEFAULT_DOMAIN      "example.com"
+
+static errno_t bench_read_copy(TALLOC_CTX *mem_ctx, DBusMessage *msg)
+{
+    struct _sbus_sss_invoker_args_uusss *args;
+    DBusMessageIter iter;
+    errno_t ret;
+
+    dbus_message_iter_init(msg, &iter);
+
+    args = talloc_zero(mem_ctx, struct _sbus_sss_invoker_args_uusss);
+    if (args == NULL) {
+        return ENOMEM;
+    }
+
+    ret = _sbus_sss_invoker_read_uusss(args, &iter, args);
+    talloc_free(args);
+
+    return ret;
+}
+
+static errno_t bench_read_borrow(DBusMessage *msg)
+{
+    struct _sbus_sss_invoker_args_uusss args;
+    DBusMessageIter iter;
+
+    dbus_message_iter_init(msg, &iter);
+
+    return _sbus_sss_invoker_borrow_uusss(&iter, &args);
+}
+
+static errno_t bench_check(DBusMessage *msg, const char *filter,
+                           const char *domain)
+{
+    struct _sbus_sss_invoker_args_uusss args;
+    DBusMessageIter iter;
+    errno_t ret;
+
+    dbus_message_iter_init(msg, &iter);
+
+    ret = _sbus_sss_invoker_borrow_uusss(&iter, &args);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    if (args.arg0 != 0 || args.arg1 != 1
+            || strcmp(args.arg2, filter) != 0
+            || strcmp(args.arg3, domain) != 0
+            || strcmp(args.arg4, "") != 0) {
+        return EINVAL;
+    }
+
+    return EOK;
+}
+
+static double bench_elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+           + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void bench_report(const char *label, int iterations, double elapsed)
+{
+    printf("%-8s %d reads in %.3f s, %.3f us per read\n",
+           label, iterations, elapsed, elapsed * 1e6 / iterations);
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_iterations = DEFAULT_ITERATIONS;
+    const char *pc_filter = DEFAULT_FILTER;
+    const char *pc_domain = DEFAULT_DOMAIN;
+    dbus_uint32_t dp_flags = 0;
+    dbus_uint32_t entry_type = 1;
+    const char *extra = "";
+    DBusMessage *msg = NULL;
+    TALLOC_CTX *ctx;
+    struct timespec start;
+    int ret;
+    int i;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "iterations", 'i', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_iterations, 0,
+                    "Number of reads", NULL },
+        { "filter", 'f', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_filter, 0,
+                    "Filter sent in the request", NULL },
+        { "domain", 'd', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_domain, 0,
+                    "Domain sent in the request", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_iterations <= 0) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    ctx = talloc_new(NULL);
+    if (ctx == NULL) {
+        return 1;
+    }
+
+    msg = dbus_message_new_method_call("sssd.domain_example_2ecom", "/sssd",
+                                       "sssd.dataprovider", "getAccountInfo");
+    if (msg == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (!dbus_message_append_args(msg,
+                                  DBUS_TYPE_UINT32, &dp_flags,
+                                  DBUS_TYPE_UINT32, &entry_type,
+                                  DBUS_TYPE_STRING, &pc_filter,
+                                  DBUS_TYPE_STRING, &pc_domain,
+                                  DBUS_TYPE_STRING, &extra,
+                                  DBUS_TYPE_INVALID)) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = bench_check(msg, pc_filter, pc_domain);
+    if (ret != EOK) {
+        fprintf(stderr, "Borrowed arguments do not match\n");
+        goto done;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < pc_iterations; i++) {
+        ret = bench_read_copy(ctx, msg);
+        if (ret != EOK) {
+            fprintf(stderr, "Copying read failed: %s\n", sss_strerror(ret));
+            goto done;
+        }
+    }
+    bench_report("copy", pc_iterations, bench_elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < pc_iterations; i++) {
+        ret = bench_read_borrow(msg);
+        if (ret != EOK) {
+            fprintf(stderr, "Borrowing read failed: %s\n", sss_strerror(ret));
+            goto done;
+        }
+    }
+    bench_report("borrow", pc_iterations, bench_elapsed(&start));
+
+    ret = EOK;
+
+done:
+    if (msg != NULL) {
+        dbus_message_unref(msg);
+    }
+    talloc_free(ctx);
+    return ret == EOK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
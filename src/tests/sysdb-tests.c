@@ -30,6 +30,7 @@
 #include <arpa/inet.h>
 #include "util/util.h"
 #include "util/crypto/sss_crypto.h"
+#include "util/sss_hash_pool.h"
 #include "db/sysdb_private.h"
 #include "db/sysdb_services.h"
 #include "db/sysdb_autofs.h"
@@ -2322,6 +2323,180 @@ START_TEST (test_sysdb_cached_authentication)
 }
 END_TEST
 
+START_TEST (test_sysdb_cached_authentication_hash_pool)
+{
+    struct sysdb_test_ctx *test_ctx;
+    struct sss_hash_pool *pool;
+    struct test_data *data;
+    struct tevent_req *req;
+    struct ldb_result *res;
+    const char *attrs[] = { SYSDB_CACHEDPWD, NULL };
+    const char *hash;
+    const char *val[2] = { "0", NULL };
+    time_t expire_date = -1;
+    time_t delayed_until = -1;
+    int ret;
+
+    /* Setup */
+    ret = setup_sysdb_tests(&test_ctx);
+    fail_unless(ret == EOK, "Could not set up the test");
+
+    ret = confdb_add_param(test_ctx->confdb, true, CONFDB_PAM_CONF_ENTRY,
+                           CONFDB_PAM_CRED_TIMEOUT, val);
+    fail_unless(ret == EOK, "Could not initialize provider");
+
+    ret = sss_hash_pool_init(test_ctx, test_ctx->ev, 2, &pool);
+    fail_unless(ret == EOK, "sss_hash_pool_init failed [%d].", ret);
+
+    data = test_data_new_user(test_ctx, _i);
+    fail_if(data == NULL, "OOM\n");
+
+    test_ctx->domain->cache_credentials_hash_rounds = 2000;
+
+    req = sysdb_cache_password_ex_send(test_ctx, test_ctx->ev, pool,
+                                       test_ctx->domain, data->username,
+                                       data->username,
+                                       SSS_AUTHTOK_TYPE_PASSWORD, 0);
+    fail_if(req == NULL, "OOM\n");
+    fail_unless(tevent_req_poll(req, test_ctx->ev), "tevent_req_poll failed");
+    ret = sysdb_cache_password_ex_recv(req);
+    talloc_free(req);
+    fail_unless(ret == EOK, "sysdb_cache_password_ex_send failed [%d].", ret);
+
+    ret = sysdb_get_user_attr(test_ctx, test_ctx->domain, data->username,
+                              attrs, &res);
+    fail_unless(ret == EOK, "sysdb_get_user_attr request failed [%d].", ret);
+    hash = ldb_msg_find_attr_as_string(res->msgs[0], SYSDB_CACHEDPWD, NULL);
+    fail_unless(hash != NULL && strncmp(hash, "$6$rounds=2000$", 15) == 0,
+                "Unexpected hash [%s].", hash);
+
+    req = sysdb_cache_auth_send(test_ctx, test_ctx->ev, pool,
+                                test_ctx->domain, data->username, "abc",
+                                test_ctx->confdb, false);
+    fail_if(req == NULL, "OOM\n");
+    fail_unless(tevent_req_poll(req, test_ctx->ev), "tevent_req_poll failed");
+    ret = sysdb_cache_auth_recv(req, &expire_date, &delayed_until);
+    talloc_free(req);
+    fail_unless(ret == ERR_AUTH_FAILED,
+                "Expected [%d], got [%d].", ERR_AUTH_FAILED, ret);
+
+    req = sysdb_cache_auth_send(test_ctx, test_ctx->ev, pool,
+                                test_ctx->domain, data->username,
+                                data->username, test_ctx->confdb, false);
+    fail_if(req == NULL, "OOM\n");
+    fail_unless(tevent_req_poll(req, test_ctx->ev), "tevent_req_poll failed");
+    ret = sysdb_cache_auth_recv(req, &expire_date, &delayed_until);
+    talloc_free(req);
+    fail_unless(ret == EOK, "Expected [%d], got [%d].", EOK, ret);
+    fail_unless(expire_date == 0, "Wrong expire date, expected [%d], got [%ld]",
+                                  0, expire_date);
+    fail_unless(delayed_until == -1, "Wrong delay, expected [%d], got [%ld]",
+                                     -1, delayed_until);
+
+    /* the synchronous version reads the rounds from the hash as well */
+    ret = sysdb_cache_auth(test_ctx->domain, data->username, data->username,
+                           test_ctx->confdb, false, NULL, NULL);
+    fail_unless(ret == EOK, "Expected [%d], got [%d].", EOK, ret);
+
+    talloc_free(test_ctx);
+}
+END_TEST
+
+START_TEST (test_sysdb_cached_authentication_parallel_lockout)
+{
+    struct sysdb_test_ctx *test_ctx;
+    struct sss_hash_pool *pool;
+    struct test_data *data;
+    struct tevent_req *req[5];
+    const char *val[2] = { "0", NULL };
+    const char *attempts[2] = { "3", NULL };
+    time_t expire_date = -1;
+    time_t delayed_until = -1;
+    size_t i;
+    int ret;
+
+    /* Setup */
+    ret = setup_sysdb_tests(&test_ctx);
+    fail_unless(ret == EOK, "Could not set up the test");
+
+    ret = confdb_add_param(test_ctx->confdb, true, CONFDB_PAM_CONF_ENTRY,
+                           CONFDB_PAM_CRED_TIMEOUT, val);
+    fail_unless(ret == EOK, "Could not initialize provider");
+
+    ret = confdb_add_param(test_ctx->confdb, true, CONFDB_PAM_CONF_ENTRY,
+                           CONFDB_PAM_FAILED_LOGIN_ATTEMPTS, attempts);
+    fail_unless(ret == EOK, "Could not initialize provider");
+
+    /* A single worker finishes the hashes in the order they were queued. */
+    ret = sss_hash_pool_init(test_ctx, test_ctx->ev, 1, &pool);
+    fail_unless(ret == EOK, "sss_hash_pool_init failed [%d].", ret);
+
+    data = test_data_new_user(test_ctx, _i);
+    fail_if(data == NULL, "OOM\n");
+
+    ret = sysdb_attrs_add_uint32(data->attrs, SYSDB_FAILED_LOGIN_ATTEMPTS, 0U);
+    fail_unless(ret == EOK, "sysdb_attrs_add_uint32 failed [%d].", ret);
+
+    ret = sysdb_set_user_attr(test_ctx->domain, data->username, data->attrs,
+                              SYSDB_MOD_REP);
+    fail_unless(ret == EOK, "Could not modify user %s", data->username);
+
+    ret = sysdb_cache_password(test_ctx->domain, data->username,
+                               data->username);
+    fail_unless(ret == EOK, "sysdb_cache_password failed [%d].", ret);
+
+    /* All attempts pass the initial lockout check before any of them is
+     * recorded, the wrong ones are one more than allowed. */
+    for (i = 0; i < 4; i++) {
+        req[i] = sysdb_cache_auth_send(test_ctx, test_ctx->ev, pool,
+                                       test_ctx->domain, data->username,
+                                       "abc", test_ctx->confdb, false);
+        fail_if(req[i] == NULL, "OOM\n");
+    }
+
+    req[4] = sysdb_cache_auth_send(test_ctx, test_ctx->ev, pool,
+                                   test_ctx->domain, data->username,
+                                   data->username, test_ctx->confdb, false);
+    fail_if(req[4] == NULL, "OOM\n");
+    fail_unless(tevent_req_poll(req[4], test_ctx->ev),
+                "tevent_req_poll failed");
+
+    for (i = 0; i < 3; i++) {
+        fail_if(tevent_req_is_in_progress(req[i]), "Request is not done");
+        ret = sysdb_cache_auth_recv(req[i], NULL, NULL);
+        fail_unless(ret == ERR_AUTH_FAILED,
+                    "Expected [%d], got [%d].", ERR_AUTH_FAILED, ret);
+    }
+
+    fail_if(tevent_req_is_in_progress(req[3]), "Request is not done");
+    ret = sysdb_cache_auth_recv(req[3], NULL, NULL);
+    fail_unless(ret == ERR_AUTH_DENIED,
+                "Expected [%d], got [%d].", ERR_AUTH_DENIED, ret);
+
+    /* The right password must not get past the lockout either. */
+    ret = sysdb_cache_auth_recv(req[4], &expire_date, &delayed_until);
+    fail_unless(ret == ERR_AUTH_DENIED,
+                "Expected [%d], got [%d].", ERR_AUTH_DENIED, ret);
+    fail_unless(delayed_until > time(NULL),
+                "Wrong delay, got [%ld]", delayed_until);
+
+    for (i = 0; i < 5; i++) {
+        talloc_free(req[i]);
+    }
+
+    /* The confdb and the user are shared with the following tests. */
+    ret = sysdb_set_user_attr(test_ctx->domain, data->username, data->attrs,
+                              SYSDB_MOD_REP);
+    fail_unless(ret == EOK, "Could not modify user %s", data->username);
+
+    ret = confdb_add_param(test_ctx->confdb, true, CONFDB_PAM_CONF_ENTRY,
+                           CONFDB_PAM_FAILED_LOGIN_ATTEMPTS, val);
+    fail_unless(ret == EOK, "Could not reset the failed login attempts");
+
+    talloc_free(test_ctx);
+}
+END_TEST
+
 START_TEST (test_sysdb_prepare_asq_test_user)
 {
     struct sysdb_test_ctx *test_ctx;
@@ -7913,6 +8088,11 @@ Suite *create_sysdb_suite(void)
     tcase_add_loop_test(tc_sysdb, test_sysdb_cached_authentication_wrong_password,
                         27010, 27011);
     tcase_add_loop_test(tc_sysdb, test_sysdb_cached_authentication, 27010, 27011);
+    tcase_add_loop_test(tc_sysdb, test_sysdb_cached_authentication_hash_pool,
+                        27010, 27011);
+    tcase_add_loop_test(tc_sysdb,
+                        test_sysdb_cached_authentication_parallel_lockout,
+                        27010, 27011);
 
     tcase_add_loop_test(tc_sysdb, test_sysdb_cache_password_ex, 27010, 27011);
 
@@ -0,0 +1,544 @@
+/*
+    Decoder of the binary trace log
+
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <popt.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <talloc.h>
+
+#include "util/util.h"
+#include "util/debug_trace.h"
+#include "tools/common/sss_tools.h"
+#include "tools/sssctl/sssctl.h"
+
+struct trace_filter {
+    const char *prefix;     /* message must start with it */
+    int level;
+};
+
+struct trace_decoder {
+    FILE *file;
+    const char *path;
+
+    char *prg_name;
+    char **strings;
+    uint32_t num_strings;
+
+    uint8_t *payload;
+    size_t payload_size;
+};
+
+struct trace_args {
+    const uint8_t *data;
+    size_t len;
+};
+
+static bool trace_arg_get(struct trace_args *args,
+                          uint8_t type,
+                          void *_value,
+                          size_t size)
+{
+    if (args->len < 1 + size || args->data[0] != type) {
+        return false;
+    }
+
+    memcpy(_value, args->data + 1, size);
+    args->data += 1 + size;
+    args->len -= 1 + size;
+
+    return true;
+}
+
+static bool trace_arg_get_string(TALLOC_CTX *mem_ctx,
+                                 struct trace_args *args,
+                                 char **_str)
+{
+    uint32_t len;
+
+    if (!trace_arg_get(args, SSS_TRACE_ARG_STRING, &len, sizeof(len))
+            || args->len < len) {
+        return false;
+    }
+
+    *_str = talloc_strndup(mem_ctx, (const char *)args->data, len);
+    if (*_str == NULL) {
+        return false;
+    }
+
+    args->data += len;
+    args->len -= len;
+
+    return true;
+}
+
+#define trace_append(out, spec, nstars, stars, value) \
+    ((nstars) == 0 ? talloc_asprintf_append_buffer(out, spec, value) : \
+     (nstars) == 1 ? talloc_asprintf_append_buffer(out, spec, \
+                                                   (int)stars[0], value) : \
+                     talloc_asprintf_append_buffer(out, spec, \
+                                                   (int)stars[0], \
+                                                   (int)stars[1], value))
+
+/* Replays the format string with the stored arguments. This mirrors
+ * _trace_put_args() in util/debug_trace.c. */
+static char *trace_format(TALLOC_CTX *mem_ctx,
+                          const char *format,
+                          struct trace_args *args)
+{
+    char spec[64];
+    size_t spec_len;
+    const char *start = format;
+    const char *p;
+    int64_t stars[2];
+    int nstars;
+    int64_t ival;
+    uint64_t pval;
+    double dval;
+    char *sval;
+    char *out;
+
+    out = talloc_strdup(mem_ctx, "");
+
+    for (p = format; out != NULL && *p != '\0'; p++) {
+        if (*p != '%') {
+            start = p;
+            while (p[1] != '\0' && p[1] != '%') {
+                p++;
+            }
+            out = talloc_strndup_append_buffer(out, start, p - start + 1);
+            continue;
+        }
+
+        if (p[1] == '%') {
+            out = talloc_strdup_append_buffer(out, "%");
+            p++;
+            continue;
+        }
+
+        start = p++;
+        nstars = 0;
+
+        while (*p != '\0' && strchr("-+ #0'I", *p) != NULL) {
+            p++;
+        }
+
+        if (*p == '*') {
+            if (!trace_arg_get(args, SSS_TRACE_ARG_INT, &stars[nstars++],
+                               sizeof(int64_t))) {
+                goto broken;
+            }
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                if (!trace_arg_get(args, SSS_TRACE_ARG_INT, &stars[nstars++],
+                                   sizeof(int64_t))) {
+                    goto broken;
+                }
+                p++;
+            } else {
+                while (*p >= '0' && *p <= '9') {
+                    p++;
+                }
+            }
+        }
+
+        /* flags, width and precision are used as they are */
+        spec_len = p - start;
+        if (spec_len > sizeof(spec) - 4) {
+            goto broken;
+        }
+        memcpy(spec, start, spec_len);
+
+        /* the length modifier is replaced by the stored type */
+        while (*p != '\0' && strchr("hlLqjzZt", *p) != NULL) {
+            p++;
+        }
+
+        switch (*p) {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            if (!trace_arg_get(args, SSS_TRACE_ARG_INT, &ival, sizeof(ival))) {
+                goto broken;
+            }
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = *p;
+            spec[spec_len] = '\0';
+            out = trace_append(out, spec, nstars, stars, (long long)ival);
+            break;
+        case 'c':
+            if (!trace_arg_get(args, SSS_TRACE_ARG_INT, &ival, sizeof(ival))) {
+                goto broken;
+            }
+            spec[spec_len++] = 'c';
+            spec[spec_len] = '\0';
+            out = trace_append(out, spec, nstars, stars, (int)ival);
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (!trace_arg_get(args, SSS_TRACE_ARG_DOUBLE, &dval,
+                               sizeof(dval))) {
+                goto broken;
+            }
+            spec[spec_len++] = *p;
+            spec[spec_len] = '\0';
+            out = trace_append(out, spec, nstars, stars, dval);
+            break;
+        case 's':
+        case 'm':
+            if (!trace_arg_get_string(out, args, &sval)) {
+                goto broken;
+            }
+            spec[spec_len++] = 's';
+            spec[spec_len] = '\0';
+            out = trace_append(out, spec, nstars, stars, sval);
+            break;
+        case 'p':
+            if (!trace_arg_get(args, SSS_TRACE_ARG_PTR, &pval, sizeof(pval))) {
+                goto broken;
+            }
+            spec[spec_len++] = 'p';
+            spec[spec_len] = '\0';
+            out = trace_append(out, spec, nstars, stars,
+                               (void *)(uintptr_t)pval);
+            break;
+        case 'n':
+            break;
+        default:
+            goto broken;
+        }
+    }
+
+    return out;
+
+broken:
+    /* should not happen unless the file is damaged, show what is left */
+    return talloc_asprintf_append_buffer(out, "<undecodable>%s", start);
+}
+
+static errno_t trace_read(struct trace_decoder *dec,
+                          struct sss_trace_rec *rec)
+{
+    size_t size;
+
+    if (fread(rec, sizeof(*rec), 1, dec->file) != 1) {
+        return feof(dec->file) ? ENOENT : EIO;
+    }
+
+    if (rec->len > SSS_TRACE_MAX_REC) {
+        return EBADMSG;
+    }
+
+    if (rec->len + 1 > dec->payload_size) {
+        size = rec->len + 1;
+        dec->payload = talloc_realloc(dec, dec->payload, uint8_t, size);
+        if (dec->payload == NULL) {
+            return ENOMEM;
+        }
+        dec->payload_size = size;
+    }
+
+    if (rec->len > 0 && fread(dec->payload, rec->len, 1, dec->file) != 1) {
+        /* the last record may be incomplete if the file is being written */
+        return feof(dec->file) ? ENOENT : EIO;
+    }
+    dec->payload[rec->len] = '\0';
+
+    return EOK;
+}
+
+static errno_t trace_start(struct trace_decoder *dec, uint32_t len)
+{
+    struct sss_trace_start start;
+
+    if (len < sizeof(start)) {
+        return EBADMSG;
+    }
+
+    memcpy(&start, dec->payload, sizeof(start));
+    if (start.bom != SSS_TRACE_BOM) {
+        ERROR("The trace file was written on a machine with different "
+              "byte order\n");
+        return EBADMSG;
+    }
+
+    /* string identifiers are only valid within one session */
+    talloc_zfree(dec->strings);
+    dec->num_strings = 0;
+
+    talloc_free(dec->prg_name);
+    dec->prg_name = talloc_strndup(dec,
+                                   (const char *)dec->payload + sizeof(start),
+                                   len - sizeof(start));
+    if (dec->prg_name == NULL) {
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+static errno_t trace_string(struct trace_decoder *dec, uint32_t len)
+{
+    uint32_t id;
+    char **strings;
+
+    if (len < sizeof(id)) {
+        return EBADMSG;
+    }
+
+    memcpy(&id, dec->payload, sizeof(id));
+    if (id == 0 || id > UINT16_MAX * 16) {
+        return EBADMSG;
+    }
+
+    if (id >= dec->num_strings) {
+        strings = talloc_realloc(dec, dec->strings, char *, id + 1);
+        if (strings == NULL) {
+            return ENOMEM;
+        }
+        memset(strings + dec->num_strings, 0,
+               (id + 1 - dec->num_strings) * sizeof(char *));
+        dec->strings = strings;
+        dec->num_strings = id + 1;
+    }
+
+    talloc_free(dec->strings[id]);
+    dec->strings[id] = talloc_strndup(dec->strings,
+                                      (const char *)dec->payload + sizeof(id),
+                                      len - sizeof(id));
+    if (dec->strings[id] == NULL) {
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+static const char *trace_get_string(struct trace_decoder *dec, uint32_t id)
+{
+    if (id >= dec->num_strings || dec->strings[id] == NULL) {
+        return NULL;
+    }
+
+    return dec->strings[id];
+}
+
+static errno_t trace_message(struct trace_decoder *dec,
+                             struct sss_trace_rec *rec,
+                             struct trace_filter *filter)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_trace_msg msg;
+    struct trace_args args;
+    const char *function;
+    const char *format;
+    char *text;
+    time_t t;
+    struct tm tm;
+    size_t len;
+
+    if (rec->len < sizeof(msg)) {
+        return EBADMSG;
+    }
+
+    memcpy(&msg, dec->payload, sizeof(msg));
+    if (filter->level != 0 && (msg.level & filter->level) == 0) {
+        return EOK;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    args.data = dec->payload + sizeof(msg);
+    args.len = rec->len - sizeof(msg);
+
+    if (rec->type == SSS_TRACE_REC_TEXT) {
+        text = talloc_strndup(tmp_ctx, (const char *)args.data, args.len);
+    } else {
+        format = trace_get_string(dec, msg.format_id);
+        text = format == NULL
+                   ? talloc_strdup(tmp_ctx, "<unknown format>\n")
+                   : trace_format(tmp_ctx, format, &args);
+    }
+    if (text == NULL) {
+        talloc_free(tmp_ctx);
+        return ENOMEM;
+    }
+
+    if (filter->prefix != NULL
+            && strncmp(text, filter->prefix, strlen(filter->prefix)) != 0) {
+        talloc_free(tmp_ctx);
+        return EOK;
+    }
+
+    function = trace_get_string(dec, msg.function_id);
+
+    t = msg.sec;
+    localtime_r(&t, &tm);
+    len = strlen(text);
+    printf("(%d-%02d-%02d %2d:%02d:%02d:%.6u): [%s] [%s] (%#.4x): %s%s",
+           tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+           tm.tm_hour, tm.tm_min, tm.tm_sec, msg.usec,
+           dec->prg_name ? dec->prg_name : "sssd",
+           function ? function : "?", msg.level, text,
+           (len == 0 || text[len - 1] != '\n') ? "\n" : "");
+
+    talloc_free(tmp_ctx);
+    return EOK;
+}
+
+static errno_t trace_decode(struct trace_decoder *dec,
+                            struct trace_filter *filter)
+{
+    char magic[SSS_TRACE_MAGIC_LEN];
+    struct sss_trace_rec rec;
+    errno_t ret;
+
+    if (fread(magic, sizeof(magic), 1, dec->file) != 1
+            || memcmp(magic, SSS_TRACE_MAGIC, sizeof(magic)) != 0) {
+        ERROR("%s is not an SSSD trace file\n", dec->path);
+        return EINVAL;
+    }
+
+    while ((ret = trace_read(dec, &rec)) == EOK) {
+        switch (rec.type) {
+        case SSS_TRACE_REC_START:
+            ret = trace_start(dec, rec.len);
+            break;
+        case SSS_TRACE_REC_STRING:
+            ret = trace_string(dec, rec.len);
+            break;
+        case SSS_TRACE_REC_MESSAGE:
+        case SSS_TRACE_REC_TEXT:
+            ret = trace_message(dec, &rec, filter);
+            break;
+        default:
+            /* unknown records are skipped */
+            ret = EOK;
+            break;
+        }
+
+        if (ret != EOK) {
+            break;
+        }
+    }
+
+    if (ret == ENOENT) {
+        return EOK;
+    }
+
+    ERROR("Unable to decode %s [%d]: %s\n", dec->path, ret, sss_strerror(ret));
+    return ret;
+}
+
+errno_t sssctl_logs_trace(struct sss_cmdline *cmdline,
+                          struct sss_tool_ctx *tool_ctx,
+                          void *pvt)
+{
+    struct trace_decoder *dec;
+    struct trace_filter filter = { 0 };
+    const char *file = NULL;
+    const char *dp_req = NULL;
+    const char *level = NULL;
+    int cr_id = -1;
+    errno_t ret;
+
+    /* Parse command line. */
+    struct poptOption options[] = {
+        {"cache-req", 'r', POPT_ARG_INT, &cr_id, 0, _("Show only messages of the given cache request"), "ID" },
+        {"dp-req", 'd', POPT_ARG_STRING, &dp_req, 0, _("Show only messages of the given data provider request"), "NAME" },
+        {"level", 'l', POPT_ARG_STRING, &level, 0, _("Show only messages of the given debug level"), "LEVEL" },
+        POPT_TABLEEND
+    };
+
+    ret = sss_tool_popt_ex(cmdline, options, SSS_TOOL_OPT_OPTIONAL,
+                           NULL, NULL, "FILE", _("Trace file to decode"),
+                           &file, NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to parse command arguments\n");
+        return ret;
+    }
+
+    dec = talloc_zero(tool_ctx, struct trace_decoder);
+    if (dec == NULL) {
+        return ENOMEM;
+    }
+
+    if (cr_id >= 0 && dp_req != NULL) {
+        ERROR("Options --cache-req and --dp-req are mutually exclusive\n");
+        ret = EINVAL;
+        goto done;
+    } else if (cr_id >= 0) {
+        /* see CACHE_REQ_DEBUG() */
+        filter.prefix = talloc_asprintf(dec, "CR #%d: ", cr_id);
+    } else if (dp_req != NULL) {
+        /* see DP_REQ_DEBUG() */
+        filter.prefix = talloc_asprintf(dec, "DP Request [%s]: ", dp_req);
+    }
+
+    if ((cr_id >= 0 || dp_req != NULL) && filter.prefix == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (level != NULL) {
+        filter.level = parse_debug_level(level);
+        if (filter.level == SSSDBG_INVALID) {
+            ERROR("Invalid debug level.\n");
+            ret = EINVAL;
+            goto done;
+        }
+    }
+
+    dec->path = file;
+    dec->file = fopen(file, "r");
+    if (dec->file == NULL) {
+        ret = errno;
+        ERROR("Unable to open %s [%d]: %s\n", file, ret, sss_strerror(ret));
+        goto done;
+    }
+
+    ret = trace_decode(dec, &filter);
+
+done:
+    if (dec->file != NULL) {
+        fclose(dec->file);
+    }
+    talloc_free(dec);
+    return ret;
+}
@@ -13,6 +13,7 @@
 #include "config.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -329,6 +330,12 @@ done:
     return ret;
 }
 
+int s3crypt_sha512_r(const char *key, const char *salt,
+                     char *buffer, size_t buflen)
+{
+    return sha512_crypt_r(key, salt, buffer, buflen);
+}
+
 int s3crypt_sha512(TALLOC_CTX *memctx,
                    const char *key, const char *salt, char **_hash)
 {
@@ -379,3 +386,36 @@ int s3crypt_gen_salt(TALLOC_CTX *memctx, char **_salt)
 
     return EOK;
 }
+
+int s3crypt_gen_setting(TALLOC_CTX *memctx, uint32_t rounds, char **_setting)
+{
+    char *salt;
+    char *setting;
+    int ret;
+
+    ret = s3crypt_gen_salt(memctx, &salt);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* keep the short form for the default so the stored hashes look the
+     * same as before the number of rounds was configurable */
+    if (rounds == 0 || rounds == ROUNDS_DEFAULT) {
+        *_setting = salt;
+        return EOK;
+    }
+
+    if (rounds < ROUNDS_MIN) rounds = ROUNDS_MIN;
+    if (rounds > ROUNDS_MAX) rounds = ROUNDS_MAX;
+
+    setting = talloc_asprintf(memctx, "%s%"PRIu32"$%s",
+                              sha512_rounds_prefix, rounds, salt);
+    talloc_free(salt);
+    if (setting == NULL) {
+        return ENOMEM;
+    }
+
+    *_setting = setting;
+
+    return EOK;
+}
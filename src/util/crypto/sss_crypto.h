@@ -32,6 +32,22 @@ int s3crypt_sha512(TALLOC_CTX *mmectx,
                    const char *key, const char *salt, char **_hash);
 int s3crypt_gen_salt(TALLOC_CTX *memctx, char **_salt);
 
+/* Big enough for any hash produced by s3crypt_sha512(), including the
+ * rounds specification and the terminating NUL. */
+#define S3CRYPT_SHA512_HASH_SIZE 128
+
+/* Same as s3crypt_sha512() but writes the hash into the provided buffer.
+ * It uses no talloc or other shared state, so it can be called from threads
+ * other than the main one.
+ */
+int s3crypt_sha512_r(const char *key, const char *salt,
+                     char *buffer, size_t buflen);
+
+/* Generates a random salt prefixed with the number of rounds unless it is
+ * the default, the result can be passed as salt to s3crypt_sha512().
+ */
+int s3crypt_gen_setting(TALLOC_CTX *memctx, uint32_t rounds, char **_setting);
+
 /* Methods of obfuscation. */
 enum obfmethod {
     AES_256,
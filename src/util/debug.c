@@ -35,6 +35,7 @@
 #endif
 
 #include "util/util.h"
+#include "util/debug_trace.h"
 
 /* from debug_backtrace.h */
 void sss_debug_backtrace_init(void);
@@ -42,6 +43,25 @@ void sss_debug_backtrace_vprintf(int level, const char *format, va_list ap);
 void sss_debug_backtrace_printf(int level, const char *format, ...);
 void sss_debug_backtrace_endmsg(int level);
 
+/* from debug_async.c */
+errno_t sss_debug_async_journal(const char *file,
+                                long line,
+                                const char *function,
+                                int level,
+                                const char *format,
+                                va_list ap);
+void sss_debug_async_flush(void);
+void sss_debug_async_lock(void);
+void sss_debug_async_unlock(void);
+
+/* from debug_trace.c */
+bool sss_debug_trace_is_set(int level);
+void sss_debug_trace_vrecord(const char *function,
+                             int level,
+                             const char *format,
+                             va_list ap);
+errno_t sss_debug_trace_rotate(void);
+
 const char *debug_prg_name = "sssd";
 
 int debug_level = SSSDBG_UNRESOLVED;
@@ -204,27 +224,19 @@ int debug_convert_old_level(int old_level)
 
 
 #ifdef WITH_JOURNALD
-static errno_t journal_send(const char *file,
-        long line,
-        const char *function,
-        int level,
-        const char *format,
-        va_list ap)
+/* also used by the writer thread of debug_async.c */
+errno_t sss_debug_journal_write(const char *file,
+                                long line,
+                                const char *function,
+                                int level,
+                                const char *message)
 {
     errno_t ret;
     int res;
-    char *message = NULL;
     char *code_file = NULL;
     char *code_line = NULL;
     const char *domain;
 
-    /* First, evaluate the message to be sent */
-    ret = vasprintf(&message, format, ap);
-    if (ret == -1) {
-        /* ENOMEM, just return */
-        return ENOMEM;
-    }
-
     res = asprintf(&code_file, "CODE_FILE=%s", file);
     if (res == -1) {
         ret = ENOMEM;
@@ -261,6 +273,27 @@ static errno_t journal_send(const char *file,
 journal_done:
     free(code_line);
     free(code_file);
+    return ret;
+}
+
+static errno_t journal_send(const char *file,
+        long line,
+        const char *function,
+        int level,
+        const char *format,
+        va_list ap)
+{
+    errno_t ret;
+    char *message = NULL;
+
+    /* First, evaluate the message to be sent */
+    ret = vasprintf(&message, format, ap);
+    if (ret == -1) {
+        /* ENOMEM, just return */
+        return ENOMEM;
+    }
+
+    ret = sss_debug_journal_write(file, line, function, level, message);
     free(message);
     return ret;
 }
@@ -279,6 +312,13 @@ void sss_vdebug_fn(const char *file,
     struct timeval tv;
     struct tm tm;
     time_t t;
+    va_list ap_trace;
+
+    if (sss_debug_trace_is_set(level)) {
+        va_copy(ap_trace, ap);
+        sss_debug_trace_vrecord(function, level, format, ap_trace);
+        va_end(ap_trace);
+    }
 
 #ifdef WITH_JOURNALD
     errno_t ret;
@@ -293,6 +333,14 @@ void sss_vdebug_fn(const char *file,
          * can also provide extra structuring data to make it more easily
          * searchable.
          */
+        if (sss_debug_async_journal(file, line, function, level,
+                                    format, ap) == EOK) {
+            if (level <= SSSDBG_CRIT_FAILURE) {
+                sss_debug_async_flush();
+            }
+            return;
+        }
+
         va_copy(ap_fallback, ap);
         ret = journal_send(file, line, function, level, format, ap);
         if (ret != EOK) {
@@ -336,6 +384,11 @@ void sss_vdebug_fn(const char *file,
         sss_debug_backtrace_printf(level, "\n");
     }
     sss_debug_backtrace_endmsg(level);
+
+    /* don't let a message announcing a crash or exit sit in the buffer */
+    if (level <= SSSDBG_CRIT_FAILURE) {
+        sss_debug_async_flush();
+    }
 }
 
 void sss_debug_fn(const char *file,
@@ -351,23 +404,13 @@ void sss_debug_fn(const char *file,
     va_end(ap);
 }
 
-/* In cases SSSD used to run as the root user, but runs as the SSSD user now,
- * we need to chown the log files
- */
-int chown_debug_file(const char *filename,
-                     uid_t uid, gid_t gid)
+static int chown_log_file(const char *log_file, const char *suffix,
+                          uid_t uid, gid_t gid)
 {
     char *logpath;
-    const char *log_file;
     errno_t ret;
 
-    if (filename == NULL) {
-        log_file = debug_log_file;
-    } else {
-        log_file = filename;
-    }
-
-    ret = asprintf(&logpath, "%s/%s.log", LOG_PATH, log_file);
+    ret = asprintf(&logpath, "%s/%s%s", LOG_PATH, log_file, suffix);
     if (ret == -1) {
         return ENOMEM;
     }
@@ -383,14 +426,37 @@ int chown_debug_file(const char *filename,
             return EOK;
         }
 
-        DEBUG(SSSDBG_FATAL_FAILURE, "chown failed for [%s]: [%d]\n",
-              log_file, ret);
+        DEBUG(SSSDBG_FATAL_FAILURE, "chown failed for [%s%s]: [%d]\n",
+              log_file, suffix, ret);
         return ret;
     }
 
     return EOK;
 }
 
+/* In cases SSSD used to run as the root user, but runs as the SSSD user now,
+ * we need to chown the log files
+ */
+int chown_debug_file(const char *filename,
+                     uid_t uid, gid_t gid)
+{
+    const char *log_file;
+    errno_t ret;
+
+    if (filename == NULL) {
+        log_file = debug_log_file;
+    } else {
+        log_file = filename;
+    }
+
+    ret = chown_log_file(log_file, ".log", uid, gid);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return chown_log_file(log_file, SSS_TRACE_FILE_SUFFIX, uid, gid);
+}
+
 int open_debug_file_ex(const char *filename, FILE **filep, bool want_cloexec)
 {
     FILE *f = NULL;
@@ -451,8 +517,18 @@ int rotate_debug_files(void)
     int ret;
     errno_t error;
 
+    ret = sss_debug_trace_rotate();
+    if (ret != EOK) {
+        sss_log(SSS_LOG_ALERT, "Could not reopen trace file [%s]. [%d][%s]\n",
+                               debug_log_file, ret, strerror(ret));
+    }
+
     if (sss_logger != FILES_LOGGER) return EOK;
 
+    /* write out buffered messages to the old file first */
+    sss_debug_async_flush();
+    sss_debug_async_lock();
+
     if (_sss_debug_file != NULL) {
         do {
             error = 0;
@@ -484,7 +560,10 @@ int rotate_debug_files(void)
 
     _sss_debug_file = NULL;
 
-    return _sss_open_debug_file();
+    ret = _sss_open_debug_file();
+    sss_debug_async_unlock();
+
+    return ret;
 }
 
 void _sss_talloc_log_fn(const char *message)
@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "util/util_errors.h"
 
@@ -65,6 +66,19 @@ extern const char *debug_log_file;   /* only file name, excluding path */
 
 void sss_debug_backtrace_enable(bool enable);
 
+/* sss_debug_async_enable() hands debug messages over to a writer thread
+ * instead of writing them out synchronously. Messages that don't fit into
+ * the buffer are dropped, sss_debug_async_dropped() returns their number.
+ */
+errno_t sss_debug_async_enable(bool enable);
+uint64_t sss_debug_async_dropped(void);
+
+/* sss_debug_trace_init() starts writing messages of the given levels to a
+ * binary trace file next to the log file, 0 disables it. The file is
+ * decoded by 'sssctl logs-trace'.
+ */
+errno_t sss_debug_trace_init(int level);
+
 /* debug_convert_old_level() converts "old" style decimal notation
  * to bitmask composed of SSSDBG_*
  * Used explicitly, for example, while processing user input
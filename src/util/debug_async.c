@@ -0,0 +1,682 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#include "util/debug.h"
+
+extern FILE *_sss_debug_file;
+
+#ifdef WITH_JOURNALD
+/* from debug.c */
+errno_t sss_debug_journal_write(const char *file,
+                                long line,
+                                const char *function,
+                                int level,
+                                const char *message);
+#endif
+
+
+static const size_t SSS_DEBUG_ASYNC_RING_SIZE = 4*1024*1024; /* bytes */
+/* must be able to hold a complete backtrace dump */
+static const size_t SSS_DEBUG_ASYNC_MAX_MSG   = 256*1024;    /* bytes */
+#define SSS_DEBUG_ASYNC_BATCH 64                   /* records per writev() */
+
+#define ASYNC_REC_PAD     0x1 /* skip to the start of the ring */
+#define ASYNC_REC_JOURNAL 0x2 /* carries code location for journald */
+
+/* Every record in the ring starts with this header and is followed by
+ * the file name, function name (both only for journald records, NUL
+ * terminated) and the message itself. Records never wrap, the end of the
+ * ring is skipped with a padding record instead. If there is not enough
+ * space left for a header, the consumer skips to the start implicitly.
+ */
+struct async_rec {
+    uint32_t size;      /* whole record including header, 8 bytes aligned */
+    uint32_t flags;
+    uint32_t msg_len;
+    int32_t  level;
+    int32_t  line;
+    uint16_t file_len;
+    uint16_t func_len;
+};
+
+/*
+ * ring = [....cccccccrrrr...........]
+ * where:
+ *    "c" - committed, can be written out by the writer thread
+ *    "r" - reserved by a producer which is still copying its message
+ *
+ * Positions are monotonic byte counters, position % size is the offset
+ * in the ring. Producers reserve space with compare-and-swap and commit
+ * in reservation order, so the writer thread only ever sees complete
+ * records. No locks are taken on the producer side.
+ */
+static struct {
+    bool      active;
+    bool      running;
+    bool      stop;
+    size_t    size;
+    char     *ring;
+
+    uint64_t  reserved;
+    uint64_t  committed;
+    uint64_t  consumed;
+    uint64_t  dropped;
+    uint64_t  dropped_reported;
+    int       sleeping;
+
+    int       event_fd;
+    pthread_t thread;
+
+    /* held by the writer thread while it writes to _sss_debug_file */
+    pthread_mutex_t file_lock;
+    /* signalled each time the writer thread advanced 'consumed' */
+    pthread_mutex_t drain_lock;
+    pthread_cond_t  drained;
+} _async = {
+    .event_fd   = -1,
+    .file_lock  = PTHREAD_MUTEX_INITIALIZER,
+    .drain_lock = PTHREAD_MUTEX_INITIALIZER,
+    .drained    = PTHREAD_COND_INITIALIZER,
+};
+
+/* message being assembled by the current thread */
+static __thread struct {
+    char   *buffer;
+    size_t  len;
+    size_t  size;
+    bool    truncated;
+} _msg;
+
+
+static void _async_stop(void);
+
+
+/* ********** Producer side ********** */
+
+
+bool sss_debug_async_active(void)
+{
+    return __atomic_load_n(&_async.active, __ATOMIC_ACQUIRE);
+}
+
+
+static bool _msg_reserve(size_t len)
+{
+    size_t size;
+    char *buffer;
+
+    if (_msg.truncated) {
+        return false;
+    }
+
+    if (_msg.len + len <= _msg.size) {
+        return true;
+    }
+
+    if (_msg.len + len > SSS_DEBUG_ASYNC_MAX_MSG) {
+        _msg.truncated = true;
+        return false;
+    }
+
+    size = _msg.size ? _msg.size : 1024;
+    while (size < _msg.len + len) {
+        size *= 2;
+    }
+
+    buffer = realloc(_msg.buffer, size);
+    if (buffer == NULL) {
+        _msg.truncated = true;
+        return false;
+    }
+
+    _msg.buffer = buffer;
+    _msg.size = size;
+
+    return true;
+}
+
+
+void sss_debug_async_vprintf(const char *format, va_list ap)
+{
+    va_list ap_copy;
+    int written;
+
+    if (!_msg_reserve(1)) {
+        return;
+    }
+
+    va_copy(ap_copy, ap);
+    written = vsnprintf(_msg.buffer + _msg.len, _msg.size - _msg.len,
+                        format, ap_copy);
+    va_end(ap_copy);
+    if (written < 0) {
+        return;
+    }
+
+    if (_msg.len + written >= _msg.size) {
+        if (!_msg_reserve(written + 1)) {
+            return;
+        }
+
+        written = vsnprintf(_msg.buffer + _msg.len, _msg.size - _msg.len,
+                            format, ap);
+        if (written < 0) {
+            return;
+        }
+    }
+
+    _msg.len += written;
+}
+
+
+void sss_debug_async_write(const char *begin, size_t size)
+{
+    if (size == 0 || !_msg_reserve(size)) {
+        return;
+    }
+
+    memcpy(_msg.buffer + _msg.len, begin, size);
+    _msg.len += size;
+}
+
+
+static inline size_t _rec_size(size_t payload)
+{
+    return (sizeof(struct async_rec) + payload + 7) & ~((size_t)7);
+}
+
+
+static void _async_wakeup(void)
+{
+    uint64_t one = 1;
+    ssize_t ret;
+
+    if (__atomic_exchange_n(&_async.sleeping, 0, __ATOMIC_SEQ_CST) == 0) {
+        return;
+    }
+
+    do {
+        ret = write(_async.event_fd, &one, sizeof(one));
+    } while (ret == -1 && errno == EINTR);
+}
+
+
+static void _async_push(uint32_t flags, int level,
+                        const char *file, long line, const char *function,
+                        const char *msg, size_t msg_len)
+{
+    struct async_rec *rec;
+    struct async_rec *pad_rec;
+    size_t file_len = 0;
+    size_t func_len = 0;
+    size_t len;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t pad;
+    uint64_t off;
+    char *p;
+
+    if (flags & ASYNC_REC_JOURNAL) {
+        file_len = strlen(file) + 1;
+        func_len = strlen(function) + 1;
+        if (file_len > UINT16_MAX || func_len > UINT16_MAX) {
+            __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    len = _rec_size(file_len + func_len + msg_len);
+    if (len > _async.size / 2) {
+        __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    head = __atomic_load_n(&_async.reserved, __ATOMIC_RELAXED);
+    do {
+        off = head % _async.size;
+        pad = (off + len > _async.size) ? _async.size - off : 0;
+
+        tail = __atomic_load_n(&_async.consumed, __ATOMIC_ACQUIRE);
+        if (head + pad + len - tail > _async.size) {
+            /* the writer thread can't keep up, rather drop the message
+             * than block the caller */
+            __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+            _async_wakeup();
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&_async.reserved, &head,
+                                          head + pad + len, true,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_RELAXED));
+
+    if (pad >= sizeof(struct async_rec)) {
+        pad_rec = (struct async_rec *)(_async.ring + off);
+        pad_rec->size = pad;
+        pad_rec->flags = ASYNC_REC_PAD;
+    }
+
+    rec = (struct async_rec *)(_async.ring + (head + pad) % _async.size);
+    rec->size = len;
+    rec->flags = flags;
+    rec->msg_len = msg_len;
+    rec->level = level;
+    rec->line = line;
+    rec->file_len = file_len;
+    rec->func_len = func_len;
+
+    p = (char *)(rec + 1);
+    if (flags & ASYNC_REC_JOURNAL) {
+        memcpy(p, file, file_len);
+        p += file_len;
+        memcpy(p, function, func_len);
+        p += func_len;
+    }
+    memcpy(p, msg, msg_len);
+
+    /* publish in reservation order */
+    while (__atomic_load_n(&_async.committed, __ATOMIC_ACQUIRE) != head) {
+        sched_yield();
+    }
+    __atomic_store_n(&_async.committed, head + pad + len, __ATOMIC_SEQ_CST);
+
+    _async_wakeup();
+}
+
+
+void sss_debug_async_endmsg(int level)
+{
+    if (_msg.truncated) {
+        __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+    } else if (_msg.len > 0) {
+        _async_push(0, level, NULL, 0, NULL, _msg.buffer, _msg.len);
+    }
+
+    _msg.len = 0;
+    _msg.truncated = false;
+}
+
+
+errno_t sss_debug_async_journal(const char *file,
+                                long line,
+                                const char *function,
+                                int level,
+                                const char *format,
+                                va_list ap)
+{
+    if (!sss_debug_async_active()) {
+        return EAGAIN;
+    }
+
+    sss_debug_async_vprintf(format, ap);
+    if (_msg.truncated) {
+        __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        /* journald wants a NUL terminated string */
+        sss_debug_async_write("", 1);
+        _async_push(ASYNC_REC_JOURNAL, level, file, line, function,
+                    _msg.buffer, _msg.len);
+    }
+
+    _msg.len = 0;
+    _msg.truncated = false;
+
+    return EOK;
+}
+
+
+void sss_debug_async_flush(void)
+{
+    uint64_t target;
+
+    if (!sss_debug_async_active()) {
+        return;
+    }
+
+    target = __atomic_load_n(&_async.committed, __ATOMIC_ACQUIRE);
+
+    pthread_mutex_lock(&_async.drain_lock);
+    while (__atomic_load_n(&_async.consumed, __ATOMIC_ACQUIRE) < target) {
+        __atomic_store_n(&_async.sleeping, 1, __ATOMIC_SEQ_CST);
+        _async_wakeup();
+        pthread_cond_wait(&_async.drained, &_async.drain_lock);
+    }
+    pthread_mutex_unlock(&_async.drain_lock);
+}
+
+
+/* keeps the writer thread away from _sss_debug_file while it is replaced */
+void sss_debug_async_lock(void)
+{
+    pthread_mutex_lock(&_async.file_lock);
+}
+
+
+void sss_debug_async_unlock(void)
+{
+    pthread_mutex_unlock(&_async.file_lock);
+}
+
+
+uint64_t sss_debug_async_dropped(void)
+{
+    return __atomic_load_n(&_async.dropped, __ATOMIC_RELAXED);
+}
+
+
+/* ********** Writer thread ********** */
+
+
+static void _async_writev(struct iovec *iov, int count)
+{
+    ssize_t written;
+    int fd;
+
+    if (count == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&_async.file_lock);
+    fd = _sss_debug_file ? fileno(_sss_debug_file) : STDERR_FILENO;
+
+    while (count > 0) {
+        written = writev(fd, iov, count);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            /* nowhere to report this, the messages are lost */
+            break;
+        }
+
+        while (count > 0 && (size_t)written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+
+    pthread_mutex_unlock(&_async.file_lock);
+}
+
+
+static void _async_report_dropped(void)
+{
+    char notice[128];
+    struct iovec iov;
+    uint64_t dropped;
+    int len;
+
+    dropped = __atomic_load_n(&_async.dropped, __ATOMIC_RELAXED);
+    if (dropped == _async.dropped_reported) {
+        return;
+    }
+
+    len = snprintf(notice, sizeof(notice),
+                   "[%s] [%s] (%#.4x): %"PRIu64" debug messages were "
+                   "dropped, the debug buffer was full\n",
+                   debug_prg_name, __FUNCTION__, SSSDBG_MINOR_FAILURE,
+                   dropped - _async.dropped_reported);
+    _async.dropped_reported = dropped;
+    if (len <= 0 || (size_t)len >= sizeof(notice)) {
+        return;
+    }
+
+#ifdef WITH_JOURNALD
+    if (sss_logger == JOURNALD_LOGGER) {
+        sss_debug_journal_write(__FILE__, __LINE__, __FUNCTION__,
+                                SSSDBG_MINOR_FAILURE, notice);
+        return;
+    }
+#endif
+
+    iov.iov_base = notice;
+    iov.iov_len = len;
+    _async_writev(&iov, 1);
+}
+
+
+/* Writes out committed records, returns the number of records processed */
+static int _async_drain(void)
+{
+    struct iovec iov[SSS_DEBUG_ASYNC_BATCH];
+    struct async_rec *rec;
+    uint64_t pos;
+    uint64_t end;
+    uint64_t off;
+    int count = 0;
+    int records = 0;
+    char *p;
+
+    pos = __atomic_load_n(&_async.consumed, __ATOMIC_RELAXED);
+    end = __atomic_load_n(&_async.committed, __ATOMIC_ACQUIRE);
+
+    while (pos < end && count < SSS_DEBUG_ASYNC_BATCH) {
+        off = pos % _async.size;
+        if (_async.size - off < sizeof(struct async_rec)) {
+            pos += _async.size - off;
+            continue;
+        }
+
+        rec = (struct async_rec *)(_async.ring + off);
+        pos += rec->size;
+        if (rec->flags & ASYNC_REC_PAD) {
+            continue;
+        }
+
+        records++;
+        p = (char *)(rec + 1);
+
+#ifdef WITH_JOURNALD
+        if (rec->flags & ASYNC_REC_JOURNAL) {
+            sss_debug_journal_write(p, rec->line, p + rec->file_len,
+                                    rec->level,
+                                    p + rec->file_len + rec->func_len);
+            continue;
+        }
+#endif
+
+        iov[count].iov_base = p + rec->file_len + rec->func_len;
+        iov[count].iov_len = rec->msg_len;
+        count++;
+    }
+
+    _async_writev(iov, count);
+    _async_report_dropped();
+
+    pthread_mutex_lock(&_async.drain_lock);
+    __atomic_store_n(&_async.consumed, pos, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&_async.drained);
+    pthread_mutex_unlock(&_async.drain_lock);
+
+    return records;
+}
+
+
+static void *_async_writer(void *data)
+{
+    uint64_t events;
+    ssize_t ret;
+
+    while (true) {
+        if (_async_drain() > 0) {
+            continue;
+        }
+
+        __atomic_store_n(&_async.sleeping, 1, __ATOMIC_SEQ_CST);
+
+        /* re-check after announcing we are going to sleep, producers only
+         * wake us up if they see the flag set */
+        if (__atomic_load_n(&_async.committed, __ATOMIC_SEQ_CST)
+                != __atomic_load_n(&_async.consumed, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&_async.sleeping, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+
+        if (__atomic_load_n(&_async.stop, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        ret = read(_async.event_fd, &events, sizeof(events));
+        if (ret == -1 && errno != EINTR && errno != EAGAIN) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+/* ********** Setup ********** */
+
+
+static void _async_atexit(void)
+{
+    _async_stop();
+}
+
+
+/* The writer thread doesn't exist in a forked child, the child writes
+ * synchronously. Messages pending in the ring belong to the parent. */
+static void _async_atfork_child(void)
+{
+    _async.active = false;
+    _async.running = false;
+    _async.stop = false;
+    _async.reserved = 0;
+    _async.committed = 0;
+    _async.consumed = 0;
+    _async.sleeping = 0;
+
+    pthread_mutex_init(&_async.file_lock, NULL);
+    pthread_mutex_init(&_async.drain_lock, NULL);
+    pthread_cond_init(&_async.drained, NULL);
+
+    _msg.len = 0;
+    _msg.truncated = false;
+}
+
+
+static errno_t _async_start(void)
+{
+    static bool registered;
+    sigset_t all;
+    sigset_t old;
+    errno_t ret;
+
+    if (_async.ring == NULL) {
+        _async.size = SSS_DEBUG_ASYNC_RING_SIZE;
+        _async.ring = malloc(_async.size);
+        if (_async.ring == NULL) {
+            return ENOMEM;
+        }
+    }
+
+    if (_async.event_fd == -1) {
+        _async.event_fd = eventfd(0, EFD_CLOEXEC);
+        if (_async.event_fd == -1) {
+            return errno;
+        }
+    }
+
+    if (!registered) {
+        ret = pthread_atfork(NULL, NULL, _async_atfork_child);
+        if (ret != 0) {
+            return ret;
+        }
+        if (atexit(_async_atexit) != 0) {
+            return EINVAL;
+        }
+        registered = true;
+    }
+
+    /* anything written so far has to precede the asynchronous messages */
+    fflush(_sss_debug_file ? _sss_debug_file : stderr);
+
+    _async.stop = false;
+    _async.reserved = 0;
+    _async.committed = 0;
+    _async.consumed = 0;
+    _async.sleeping = 0;
+
+    /* signals are handled by the main thread only */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    ret = pthread_create(&_async.thread, NULL, _async_writer, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (ret != 0) {
+        return ret;
+    }
+
+    _async.running = true;
+    __atomic_store_n(&_async.active, true, __ATOMIC_RELEASE);
+
+    return EOK;
+}
+
+
+static void _async_stop(void)
+{
+    if (!_async.running) {
+        return;
+    }
+
+    /* new messages are written synchronously from now on, the writer
+     * thread drains what is already in the ring before it exits */
+    __atomic_store_n(&_async.active, false, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&_async.stop, true, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&_async.sleeping, 1, __ATOMIC_SEQ_CST);
+    _async_wakeup();
+
+    pthread_join(_async.thread, NULL);
+    _async.running = false;
+}
+
+
+errno_t sss_debug_async_enable(bool enable)
+{
+    if (!enable) {
+        _async_stop();
+        return EOK;
+    }
+
+    if (_async.running) {
+        return EOK;
+    }
+
+    return _async_start();
+}
@@ -26,6 +26,12 @@
 
 extern FILE *_sss_debug_file;
 
+/* from debug_async.c */
+bool sss_debug_async_active(void);
+void sss_debug_async_vprintf(const char *format, va_list ap);
+void sss_debug_async_write(const char *begin, size_t size);
+void sss_debug_async_endmsg(int level);
+
 
 static const unsigned SSS_DEBUG_BACKTRACE_DEFAULT_SIZE = 100*1024; /* bytes */
 static const unsigned SSS_DEBUG_BACKTRACE_LEVEL        = SSSDBG_BE_FO;
@@ -54,10 +60,11 @@ static inline bool _backtrace_is_enabled(int level);
 static inline bool _is_trigger_level(int level);
 static void _backtrace_vprintf(const char *format, va_list ap);
 static void _backtrace_printf(const char *format, ...);
-static void _backtrace_dump(void);
+static void _backtrace_dump(int level);
 static inline void _debug_vprintf(const char *format, va_list ap);
+static void _debug_printf(const char *format, ...);
 static inline void _debug_fwrite(const char *ptr, const char *end);
-static inline void _debug_fflush(void);
+static inline void _debug_fflush(int level);
 
 
 void sss_debug_backtrace_init(void)
@@ -119,12 +126,12 @@ void sss_debug_backtrace_printf(int level, const char *format, ...)
 void sss_debug_backtrace_endmsg(int level)
 {
     if (DEBUG_IS_SET(level)) {
-        _debug_fflush();
+        _debug_fflush(level);
     }
 
     if (_backtrace_is_enabled(level)) {
         if (_is_trigger_level(level)) {
-            _backtrace_dump();
+            _backtrace_dump(level);
         }
         _backtrace_printf("   *  ");
     }
@@ -138,22 +145,46 @@ void sss_debug_backtrace_endmsg(int level)
 
 static inline void _debug_vprintf(const char *format, va_list ap)
 {
+    if (sss_debug_async_active()) {
+        sss_debug_async_vprintf(format, ap);
+        return;
+    }
+
     vfprintf(_sss_debug_file ? _sss_debug_file : stderr, format, ap);
 }
 
 
+static void _debug_printf(const char *format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    _debug_vprintf(format, ap);
+    va_end(ap);
+}
+
+
 static inline void _debug_fwrite(const char *begin, const char *end)
 {
     if (end <= begin) {
         return;
     }
     size_t size = (end - begin);
+    if (sss_debug_async_active()) {
+        sss_debug_async_write(begin, size);
+        return;
+    }
     fwrite_unlocked(begin, size, 1, _sss_debug_file ? _sss_debug_file : stderr);
 }
 
 
-static inline void _debug_fflush(void)
+/* in asynchronous mode the message is handed over to the writer thread */
+static inline void _debug_fflush(int level)
 {
+    if (sss_debug_async_active()) {
+        sss_debug_async_endmsg(level);
+        return;
+    }
+
     fflush(_sss_debug_file ? _sss_debug_file : stderr);
 }
 
@@ -249,7 +280,7 @@ static bool _bt_empty(const char *begin, const char *end)
 }
 
 
-static void _backtrace_dump(void)
+static void _backtrace_dump(int level)
 {
     const char *start = NULL;
     static const char *start_marker =
@@ -271,15 +302,15 @@ static void _backtrace_dump(void)
         }
     }
 
-    fprintf(_sss_debug_file ? _sss_debug_file : stderr, "%s", start_marker);
+    _debug_printf("%s", start_marker);
 
     if (start) {
         _debug_fwrite(start + 1, _bt.end); /* dump "old" part of buffer */
     }
     _debug_fwrite(_bt.buffer, _bt.tail); /* dump "new" part of buffer */
 
-    fprintf(_sss_debug_file ? _sss_debug_file : stderr, "%s", end_marker);
-    _debug_fflush();
+    _debug_printf("%s", end_marker);
+    _debug_fflush(level);
 
     _bt.end  = _bt.buffer;
     _bt.tail = _bt.buffer;
@@ -0,0 +1,604 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "util/util.h"
+#include "util/debug_trace.h"
+
+#define TRACE_TABLE_MIN_SIZE 1024
+
+/* format strings and function names already written to the current
+ * session, keyed by their address */
+struct trace_str {
+    const char *ptr;
+    char *copy;
+    uint32_t id;
+};
+
+static struct {
+    FILE *file;
+    int level;
+    uint32_t next_id;
+
+    struct trace_str *table;
+    size_t size;
+    size_t count;
+} _trace;
+
+struct trace_buf {
+    char data[SSS_TRACE_MAX_REC];
+    size_t len;
+    bool full;
+};
+
+static struct trace_buf _buf;
+
+
+/* ********** String table ********** */
+
+
+static void _trace_table_reset(void)
+{
+    size_t i;
+
+    for (i = 0; i < _trace.size; i++) {
+        free(_trace.table[i].copy);
+    }
+
+    free(_trace.table);
+    _trace.table = NULL;
+    _trace.size = 0;
+    _trace.count = 0;
+    _trace.next_id = 1;
+}
+
+
+static inline size_t _trace_slot(const char *ptr, size_t size)
+{
+    return ((uintptr_t)ptr >> 3) * 0x9E3779B97F4A7C15ULL & (size - 1);
+}
+
+
+static bool _trace_table_grow(void)
+{
+    struct trace_str *table;
+    size_t size;
+    size_t slot;
+    size_t i;
+
+    size = _trace.size ? _trace.size * 2 : TRACE_TABLE_MIN_SIZE;
+    table = calloc(size, sizeof(struct trace_str));
+    if (table == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < _trace.size; i++) {
+        if (_trace.table[i].ptr == NULL) {
+            continue;
+        }
+
+        slot = _trace_slot(_trace.table[i].ptr, size);
+        while (table[slot].ptr != NULL) {
+            slot = (slot + 1) & (size - 1);
+        }
+        table[slot] = _trace.table[i];
+    }
+
+    free(_trace.table);
+    _trace.table = table;
+    _trace.size = size;
+
+    return true;
+}
+
+
+static bool _trace_write_string(uint32_t id, const char *str, size_t len)
+{
+    struct sss_trace_rec rec;
+
+    rec.type = SSS_TRACE_REC_STRING;
+    rec.len = sizeof(id) + len;
+
+    return fwrite(&rec, sizeof(rec), 1, _trace.file) == 1
+           && fwrite(&id, sizeof(id), 1, _trace.file) == 1
+           && fwrite(str, len, 1, _trace.file) == 1;
+}
+
+
+/* Returns the identifier of the string, writes it to the file first if it
+ * is not known yet. Returns 0 on error. */
+static uint32_t _trace_intern(const char *str)
+{
+    struct trace_str *entry;
+    size_t len;
+    size_t slot;
+    char *copy;
+
+    if (_trace.count * 2 >= _trace.size && !_trace_table_grow()) {
+        return 0;
+    }
+
+    /* Format strings are literals in almost all cases so the address
+     * identifies them. The copy protects against a buffer that is reused
+     * for a different string. */
+    slot = _trace_slot(str, _trace.size);
+    while (_trace.table[slot].ptr != NULL) {
+        entry = &_trace.table[slot];
+        if (entry->ptr == str) {
+            if (strcmp(entry->copy, str) == 0) {
+                return entry->id;
+            }
+            break;
+        }
+        slot = (slot + 1) & (_trace.size - 1);
+    }
+
+    len = strlen(str);
+    if (len > SSS_TRACE_MAX_REC / 2) {
+        return 0;
+    }
+
+    /* The identifier is assigned only once the string record is written,
+     * otherwise messages would reference a string the decoder never saw. */
+    if (!_trace_write_string(_trace.next_id, str, len)) {
+        return 0;
+    }
+
+    copy = strdup(str);
+    if (copy == NULL) {
+        /* the record is harmless, the identifier is not used again */
+        _trace.next_id++;
+        return 0;
+    }
+
+    entry = &_trace.table[slot];
+    if (entry->ptr == NULL) {
+        _trace.count++;
+    } else {
+        free(entry->copy);
+    }
+
+    entry->ptr = str;
+    entry->copy = copy;
+    entry->id = _trace.next_id++;
+
+    return entry->id;
+}
+
+
+/* ********** Arguments ********** */
+
+
+static inline void _buf_put(struct trace_buf *buf, const void *data, size_t len)
+{
+    if (buf->len + len > sizeof(buf->data)) {
+        buf->full = true;
+        return;
+    }
+
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+
+static inline void _buf_put_int(struct trace_buf *buf, int64_t value)
+{
+    uint8_t type = SSS_TRACE_ARG_INT;
+
+    _buf_put(buf, &type, sizeof(type));
+    _buf_put(buf, &value, sizeof(value));
+}
+
+
+static inline void _buf_put_string(struct trace_buf *buf, const char *str)
+{
+    uint8_t type = SSS_TRACE_ARG_STRING;
+    size_t max = sizeof(buf->data) / 4;
+    uint32_t len;
+
+    if (str == NULL) {
+        str = "(null)";
+    }
+
+    len = strnlen(str, max);
+
+    _buf_put(buf, &type, sizeof(type));
+    _buf_put(buf, &len, sizeof(len));
+    _buf_put(buf, str, len);
+}
+
+
+enum trace_length {
+    LEN_NONE,
+    LEN_HH,
+    LEN_H,
+    LEN_L,
+    LEN_LL,
+    LEN_J,
+    LEN_Z,
+    LEN_T,
+};
+
+
+/* Walks the format string the same way printf() does and stores the
+ * arguments. Returns false for formats which are not supported, the
+ * message is stored as text then. */
+static bool _trace_put_args(struct trace_buf *buf,
+                            const char *format,
+                            va_list ap,
+                            int saved_errno)
+{
+    enum trace_length length;
+    const char *p;
+    uint8_t type;
+    uint64_t ptr;
+    double dbl;
+
+    for (p = format; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        p++;
+        if (*p == '%') {
+            continue;
+        }
+
+        while (*p != '\0' && strchr("-+ #0'I", *p) != NULL) {
+            p++;
+        }
+
+        if (*p == '*') {
+            _buf_put_int(buf, va_arg(ap, int));
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+            if (*p == '$') {
+                /* positional arguments */
+                return false;
+            }
+        }
+
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                _buf_put_int(buf, va_arg(ap, int));
+                p++;
+            } else {
+                while (*p >= '0' && *p <= '9') {
+                    p++;
+                }
+            }
+        }
+
+        length = LEN_NONE;
+        switch (*p) {
+        case 'h':
+            length = (p[1] == 'h') ? LEN_HH : LEN_H;
+            p += (p[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            length = (p[1] == 'l') ? LEN_LL : LEN_L;
+            p += (p[1] == 'l') ? 2 : 1;
+            break;
+        case 'L':
+        case 'q':
+            length = LEN_LL;
+            p++;
+            break;
+        case 'j':
+            length = LEN_J;
+            p++;
+            break;
+        case 'z':
+        case 'Z':
+            length = LEN_Z;
+            p++;
+            break;
+        case 't':
+            length = LEN_T;
+            p++;
+            break;
+        }
+
+        switch (*p) {
+        case 'd':
+        case 'i':
+            switch (length) {
+            case LEN_HH: _buf_put_int(buf, (signed char)va_arg(ap, int)); break;
+            case LEN_H: _buf_put_int(buf, (short)va_arg(ap, int)); break;
+            case LEN_L: _buf_put_int(buf, va_arg(ap, long)); break;
+            case LEN_LL: _buf_put_int(buf, va_arg(ap, long long)); break;
+            case LEN_J: _buf_put_int(buf, va_arg(ap, intmax_t)); break;
+            case LEN_Z: _buf_put_int(buf, va_arg(ap, ssize_t)); break;
+            case LEN_T: _buf_put_int(buf, va_arg(ap, ptrdiff_t)); break;
+            default: _buf_put_int(buf, va_arg(ap, int)); break;
+            }
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (length) {
+            case LEN_HH:
+                _buf_put_int(buf, (unsigned char)va_arg(ap, unsigned int));
+                break;
+            case LEN_H:
+                _buf_put_int(buf, (unsigned short)va_arg(ap, unsigned int));
+                break;
+            case LEN_L:
+                _buf_put_int(buf, va_arg(ap, unsigned long));
+                break;
+            case LEN_LL:
+                _buf_put_int(buf, va_arg(ap, unsigned long long));
+                break;
+            case LEN_J:
+                _buf_put_int(buf, va_arg(ap, uintmax_t));
+                break;
+            case LEN_Z:
+                _buf_put_int(buf, va_arg(ap, size_t));
+                break;
+            case LEN_T:
+                _buf_put_int(buf, va_arg(ap, ptrdiff_t));
+                break;
+            default:
+                _buf_put_int(buf, va_arg(ap, unsigned int));
+                break;
+            }
+            break;
+        case 'c':
+            if (length != LEN_NONE) {
+                return false;
+            }
+            _buf_put_int(buf, va_arg(ap, int));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (length == LEN_LL) {
+                dbl = va_arg(ap, long double);
+            } else {
+                dbl = va_arg(ap, double);
+            }
+            type = SSS_TRACE_ARG_DOUBLE;
+            _buf_put(buf, &type, sizeof(type));
+            _buf_put(buf, &dbl, sizeof(dbl));
+            break;
+        case 's':
+            if (length != LEN_NONE) {
+                return false;
+            }
+            _buf_put_string(buf, va_arg(ap, const char *));
+            break;
+        case 'p':
+            ptr = (uintptr_t)va_arg(ap, void *);
+            type = SSS_TRACE_ARG_PTR;
+            _buf_put(buf, &type, sizeof(type));
+            _buf_put(buf, &ptr, sizeof(ptr));
+            break;
+        case 'm':
+            _buf_put_string(buf, strerror(saved_errno));
+            break;
+        case 'n':
+            (void)va_arg(ap, void *);
+            break;
+        default:
+            return false;
+        }
+    }
+
+    return !buf->full;
+}
+
+
+/* ********** Records ********** */
+
+
+static void _trace_write_start(void)
+{
+    struct sss_trace_rec rec;
+    struct sss_trace_start start;
+    size_t len;
+
+    len = strlen(debug_prg_name);
+
+    rec.type = SSS_TRACE_REC_START;
+    rec.len = sizeof(start) + len;
+
+    start.bom = SSS_TRACE_BOM;
+    start.pid = getpid();
+    start.sec = time(NULL);
+
+    fwrite(&rec, sizeof(rec), 1, _trace.file);
+    fwrite(&start, sizeof(start), 1, _trace.file);
+    fwrite(debug_prg_name, len, 1, _trace.file);
+}
+
+
+bool sss_debug_trace_is_set(int level)
+{
+    return _trace.file != NULL && (_trace.level & level);
+}
+
+
+void sss_debug_trace_vrecord(const char *function,
+                             int level,
+                             const char *format,
+                             va_list ap)
+{
+    struct sss_trace_rec *rec;
+    struct sss_trace_msg *msg;
+    struct timeval tv;
+    int saved_errno;
+    va_list ap_copy;
+    int written;
+
+    saved_errno = errno;
+
+    if (_trace.file == NULL) {
+        return;
+    }
+
+    gettimeofday(&tv, NULL);
+
+    flockfile(_trace.file);
+
+    _buf.len = sizeof(*rec) + sizeof(*msg);
+    _buf.full = false;
+
+    rec = (struct sss_trace_rec *)_buf.data;
+    msg = (struct sss_trace_msg *)(_buf.data + sizeof(*rec));
+
+    msg->sec = tv.tv_sec;
+    msg->usec = tv.tv_usec;
+    msg->level = level;
+    msg->function_id = _trace_intern(function);
+    msg->format_id = _trace_intern(format);
+
+    va_copy(ap_copy, ap);
+    if (msg->format_id != 0 && msg->function_id != 0
+            && _trace_put_args(&_buf, format, ap_copy, saved_errno)) {
+        rec->type = SSS_TRACE_REC_MESSAGE;
+    } else {
+        rec->type = SSS_TRACE_REC_TEXT;
+        msg->format_id = 0;
+        _buf.len = sizeof(*rec) + sizeof(*msg);
+
+        /* keep %m working */
+        errno = saved_errno;
+        written = vsnprintf(_buf.data + _buf.len,
+                            sizeof(_buf.data) - _buf.len, format, ap);
+        if (written < 0) {
+            written = 0;
+        } else if ((size_t)written >= sizeof(_buf.data) - _buf.len) {
+            written = sizeof(_buf.data) - _buf.len - 1;
+        }
+        _buf.len += written;
+    }
+    va_end(ap_copy);
+
+    rec->len = _buf.len - sizeof(*rec);
+    fwrite_unlocked(_buf.data, _buf.len, 1, _trace.file);
+
+    /* make sure the events leading to a failure are on the disk */
+    if (level <= SSSDBG_OP_FAILURE) {
+        fflush_unlocked(_trace.file);
+    }
+
+    funlockfile(_trace.file);
+
+    errno = saved_errno;
+}
+
+
+/* ********** Setup ********** */
+
+
+static errno_t _trace_open(void)
+{
+    char *path;
+    mode_t old_umask;
+    int flags;
+    int fd;
+    int ret;
+
+    ret = asprintf(&path, "%s/%s%s", LOG_PATH, debug_log_file,
+                   SSS_TRACE_FILE_SUFFIX);
+    if (ret == -1) {
+        return ENOMEM;
+    }
+
+    old_umask = umask(SSS_DFL_UMASK);
+    _trace.file = fopen(path, "a");
+    ret = errno;
+    umask(old_umask);
+    free(path);
+    if (_trace.file == NULL) {
+        return ret;
+    }
+
+    fd = fileno(_trace.file);
+    flags = fcntl(fd, F_GETFD, 0);
+    (void) fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+
+    if (lseek(fd, 0, SEEK_END) == 0) {
+        fwrite(SSS_TRACE_MAGIC, SSS_TRACE_MAGIC_LEN, 1, _trace.file);
+    }
+
+    _trace_table_reset();
+    _trace_write_start();
+
+    return EOK;
+}
+
+
+static void _trace_close(void)
+{
+    if (_trace.file == NULL) {
+        return;
+    }
+
+    fclose(_trace.file);
+    _trace.file = NULL;
+    _trace_table_reset();
+}
+
+
+errno_t sss_debug_trace_init(int level)
+{
+    _trace_close();
+
+    _trace.level = level;
+    if (level == 0) {
+        return EOK;
+    }
+
+    return _trace_open();
+}
+
+
+errno_t sss_debug_trace_rotate(void)
+{
+    if (_trace.file == NULL) {
+        return EOK;
+    }
+
+    _trace_close();
+
+    return _trace_open();
+}
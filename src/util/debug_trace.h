@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _DEBUG_TRACE_H_
+#define _DEBUG_TRACE_H_
+
+#include <stdint.h>
+
+/*
+ * Binary trace log
+ *
+ * Instead of formatting each debug message, only the format string
+ * identifier and the raw arguments are stored. Format strings and function
+ * names are written to the file once per session as string records and
+ * referenced by their identifier afterwards. The file is decoded by
+ * 'sssctl logs-trace'.
+ *
+ * file    = magic session*
+ * session = start (string | message | text)*
+ *
+ * All integers are stored in host byte order, the byte order marker in the
+ * start record tells the decoder which one it was.
+ */
+
+#define SSS_TRACE_MAGIC     "SSSDTRC1"
+#define SSS_TRACE_MAGIC_LEN 8
+#define SSS_TRACE_BOM       0x01020304
+
+#define SSS_TRACE_FILE_SUFFIX ".trace"
+
+enum sss_trace_rec_type {
+    /* new process, resets string identifiers; payload is
+     * struct sss_trace_start followed by the program name */
+    SSS_TRACE_REC_START = 1,
+    /* payload is uint32_t identifier followed by the string */
+    SSS_TRACE_REC_STRING = 2,
+    /* payload is struct sss_trace_msg followed by the arguments */
+    SSS_TRACE_REC_MESSAGE = 3,
+    /* message that could not be stored as arguments, payload is
+     * struct sss_trace_msg followed by the formatted message */
+    SSS_TRACE_REC_TEXT = 4,
+};
+
+/* argument types, each argument is a type byte followed by its value */
+enum sss_trace_arg_type {
+    SSS_TRACE_ARG_INT = 1,      /* int64_t */
+    SSS_TRACE_ARG_DOUBLE = 2,   /* double */
+    SSS_TRACE_ARG_PTR = 3,      /* uint64_t */
+    SSS_TRACE_ARG_STRING = 4,   /* uint32_t length followed by the string */
+};
+
+struct sss_trace_rec {
+    uint32_t type;
+    uint32_t len;               /* length of the payload */
+};
+
+struct sss_trace_start {
+    uint32_t bom;
+    uint32_t pid;
+    int64_t sec;
+};
+
+struct sss_trace_msg {
+    uint32_t format_id;         /* 0 for SSS_TRACE_REC_TEXT */
+    uint32_t function_id;
+    uint32_t level;
+    uint32_t usec;
+    int64_t sec;
+};
+
+/* upper limit of a single record, longer string arguments are truncated */
+#define SSS_TRACE_MAX_REC (64 * 1024)
+
+#endif /* _DEBUG_TRACE_H_ */
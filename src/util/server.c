@@ -456,6 +456,8 @@ int server_setup(const char *name, int flags,
     bool dt;
     bool dm;
     bool backtrace_enabled;
+    bool debug_async;
+    int trace_level;
     struct tevent_signal *tes;
     struct logrotate_ctx *lctx;
     char *locale;
@@ -654,6 +656,42 @@ int server_setup(const char *name, int flags,
     }
     sss_debug_backtrace_enable(backtrace_enabled);
 
+    ret = confdb_get_bool(ctx->confdb_ctx, conf_entry,
+                          CONFDB_SERVICE_DEBUG_ASYNC,
+                          false,
+                          &debug_async);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Error reading %s from confdb (%d) [%s]\n",
+              CONFDB_SERVICE_DEBUG_ASYNC, ret, strerror(ret));
+        return ret;
+    }
+
+    ret = sss_debug_async_enable(debug_async);
+    if (ret != EOK) {
+        /* not fatal, messages are written synchronously */
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to enable asynchronous debug "
+              "logging (%d) [%s]\n", ret, sss_strerror(ret));
+    }
+
+    ret = confdb_get_int(ctx->confdb_ctx, conf_entry,
+                         CONFDB_SERVICE_DEBUG_TRACE_LEVEL,
+                         0,
+                         &trace_level);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Error reading %s from confdb (%d) [%s]\n",
+              CONFDB_SERVICE_DEBUG_TRACE_LEVEL, ret, strerror(ret));
+        return ret;
+    }
+
+    if (trace_level != 0) {
+        ret = sss_debug_trace_init(debug_convert_old_level(trace_level));
+        if (ret != EOK) {
+            /* not fatal, the text log is still written */
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to open the trace file "
+                  "(%d) [%s]\n", ret, sss_strerror(ret));
+        }
+    }
+
     /* before opening the log file set up log rotation */
     lctx = talloc_zero(ctx, struct logrotate_ctx);
     if (!lctx) return ENOMEM;
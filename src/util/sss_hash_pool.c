@@ -0,0 +1,483 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <talloc.h>
+#include <tevent.h>
+
+#include "util/util.h"
+#include "util/dlinklist.h"
+#include "util/crypto/sss_crypto.h"
+#include "util/sss_hash_pool.h"
+
+#define SSS_HASH_POOL_MAX_THREADS 4
+
+enum sss_hash_job_status {
+    SSS_HASH_JOB_QUEUED,
+    SSS_HASH_JOB_RUNNING,
+    SSS_HASH_JOB_FINISHED,
+};
+
+/* Jobs are owned by the pool, not by the request, so a request that is
+ * freed while a worker computes its hash doesn't pull the memory from under
+ * the worker. Such orphaned job is freed once it is finished. Talloc is only
+ * ever used from the main thread.
+ */
+struct sss_hash_job {
+    struct sss_hash_job *prev;
+    struct sss_hash_job *next;
+
+    /* main thread only */
+    struct sss_hash_pool *pool;
+    struct tevent_req *req;
+
+    /* protected by pool->lock */
+    enum sss_hash_job_status status;
+
+    /* used by the worker thread while the job is running */
+    char *key;
+    char *setting;
+    char hash[S3CRYPT_SHA512_HASH_SIZE];
+    int ret;
+};
+
+/*
+ * queued -> running (not on any list) -> finished
+ *
+ * Each finished job increments the semaphore event fd, the main thread
+ * completes exactly one job per read so that it never touches the pool
+ * again after finishing a request, whose callback may free the pool.
+ */
+struct sss_hash_pool {
+    struct tevent_context *ev;
+    int event_fd;
+    pid_t owner;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool stop;
+    struct sss_hash_job *queued;
+    struct sss_hash_job *finished;
+
+    unsigned int num_threads;
+    pthread_t *threads;
+};
+
+struct sss_hash_pool_sha512_state {
+    struct sss_hash_job *job;
+    char *hash;
+};
+
+
+/* ********** Worker threads ********** */
+
+
+static void sss_hash_pool_notify(struct sss_hash_pool *pool)
+{
+    uint64_t one = 1;
+    ssize_t ret;
+
+    do {
+        ret = write(pool->event_fd, &one, sizeof(one));
+    } while (ret == -1 && errno == EINTR);
+}
+
+static void *sss_hash_pool_worker(void *data)
+{
+    struct sss_hash_pool *pool = data;
+    struct sss_hash_job *job;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->stop && pool->queued == NULL) {
+            pthread_cond_wait(&pool->cond, &pool->lock);
+        }
+
+        if (pool->stop) {
+            break;
+        }
+
+        job = pool->queued;
+        DLIST_REMOVE(pool->queued, job);
+        job->status = SSS_HASH_JOB_RUNNING;
+        pthread_mutex_unlock(&pool->lock);
+
+        job->ret = s3crypt_sha512_r(job->key, job->setting,
+                                    job->hash, sizeof(job->hash));
+
+        pthread_mutex_lock(&pool->lock);
+        job->status = SSS_HASH_JOB_FINISHED;
+        DLIST_ADD_END(pool->finished, job, struct sss_hash_job *);
+        pthread_mutex_unlock(&pool->lock);
+
+        sss_hash_pool_notify(pool);
+
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+
+/* ********** Main thread ********** */
+
+
+static int sss_hash_job_destructor(struct sss_hash_job *job)
+{
+    struct sss_hash_pool_sha512_state *state;
+
+    if (job->req != NULL) {
+        state = tevent_req_data(job->req, struct sss_hash_pool_sha512_state);
+        state->job = NULL;
+    }
+
+    sss_erase_mem_securely(job->hash, sizeof(job->hash));
+
+    return 0;
+}
+
+static void sss_hash_pool_handler(struct tevent_context *ev,
+                                  struct tevent_fd *fde,
+                                  uint16_t flags,
+                                  void *pvt)
+{
+    struct sss_hash_pool *pool;
+    struct sss_hash_pool_sha512_state *state;
+    struct sss_hash_job *job;
+    struct tevent_req *req;
+    uint64_t value;
+    ssize_t len;
+    errno_t ret;
+
+    pool = talloc_get_type(pvt, struct sss_hash_pool);
+
+    len = read(pool->event_fd, &value, sizeof(value));
+    if (len != sizeof(value)) {
+        if (len == -1 && errno != EINTR && errno != EAGAIN) {
+            ret = errno;
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to read event fd [%d]: %s\n",
+                  ret, sss_strerror(ret));
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    job = pool->finished;
+    if (job != NULL) {
+        DLIST_REMOVE(pool->finished, job);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (job == NULL) {
+        return;
+    }
+
+    req = job->req;
+    if (req == NULL) {
+        /* the request was freed while the job was running */
+        talloc_free(job);
+        return;
+    }
+
+    state = tevent_req_data(req, struct sss_hash_pool_sha512_state);
+    state->job = NULL;
+    job->req = NULL;
+
+    ret = job->ret;
+    if (ret == EOK) {
+        state->hash = talloc_strdup(state, job->hash);
+        if (state->hash == NULL) {
+            ret = ENOMEM;
+        }
+    }
+
+    talloc_free(job);
+
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to compute password hash [%d]: %s\n",
+              ret, sss_strerror(ret));
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static int sss_hash_pool_destructor(struct sss_hash_pool *pool)
+{
+    unsigned int i;
+
+    /* threads are not inherited by forked children */
+    if (pool->owner == getpid()) {
+        pthread_mutex_lock(&pool->lock);
+        pool->stop = true;
+        pthread_cond_broadcast(&pool->cond);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (i = 0; i < pool->num_threads; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+    }
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+
+    return 0;
+}
+
+static unsigned int sss_hash_pool_default_threads(void)
+{
+    long cpus;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) {
+        return 1;
+    }
+
+    return MIN(cpus, SSS_HASH_POOL_MAX_THREADS);
+}
+
+errno_t sss_hash_pool_init(TALLOC_CTX *mem_ctx,
+                           struct tevent_context *ev,
+                           unsigned int num_threads,
+                           struct sss_hash_pool **_pool)
+{
+    struct sss_hash_pool *pool;
+    struct tevent_fd *fde;
+    sigset_t all;
+    sigset_t old;
+    unsigned int i;
+    errno_t ret;
+
+    if (num_threads == 0) {
+        num_threads = sss_hash_pool_default_threads();
+    }
+
+    pool = talloc_zero(mem_ctx, struct sss_hash_pool);
+    if (pool == NULL) {
+        return ENOMEM;
+    }
+
+    pool->ev = ev;
+    pool->owner = getpid();
+    pool->event_fd = -1;
+
+    pool->threads = talloc_zero_array(pool, pthread_t, num_threads);
+    if (pool->threads == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    pool->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (pool->event_fd == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create event fd [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    fde = tevent_add_fd(ev, pool, pool->event_fd, TEVENT_FD_READ,
+                        sss_hash_pool_handler, pool);
+    if (fde == NULL) {
+        close(pool->event_fd);
+        ret = ENOMEM;
+        goto done;
+    }
+    tevent_fd_set_auto_close(fde);
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    talloc_set_destructor(pool, sss_hash_pool_destructor);
+
+    /* signals are handled by the main thread only */
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    for (i = 0; i < num_threads; i++) {
+        ret = pthread_create(&pool->threads[i], NULL,
+                             sss_hash_pool_worker, pool);
+        if (ret != 0) {
+            break;
+        }
+        pool->num_threads++;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (pool->num_threads != num_threads) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to start worker thread [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Started %u password hashing threads\n",
+          pool->num_threads);
+
+    *_pool = pool;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(pool);
+    }
+
+    return ret;
+}
+
+static int
+sss_hash_pool_sha512_state_destructor(struct sss_hash_pool_sha512_state *state)
+{
+    struct sss_hash_job *job = state->job;
+    bool queued;
+
+    if (job == NULL) {
+        return 0;
+    }
+
+    job->req = NULL;
+
+    pthread_mutex_lock(&job->pool->lock);
+    queued = job->status == SSS_HASH_JOB_QUEUED;
+    if (queued) {
+        DLIST_REMOVE(job->pool->queued, job);
+    }
+    pthread_mutex_unlock(&job->pool->lock);
+
+    /* otherwise a worker is using it, it is freed when it is finished */
+    if (queued) {
+        talloc_free(job);
+    }
+
+    return 0;
+}
+
+static errno_t sss_hash_pool_sha512_sync(TALLOC_CTX *mem_ctx,
+                                         const char *key,
+                                         size_t key_len,
+                                         const char *setting,
+                                         char **_hash)
+{
+    char *key_copy;
+    errno_t ret;
+
+    key_copy = talloc_strndup(mem_ctx, key, key_len);
+    if (key_copy == NULL) {
+        return ENOMEM;
+    }
+    talloc_set_destructor((TALLOC_CTX *)key_copy,
+                          sss_erase_talloc_mem_securely);
+
+    ret = s3crypt_sha512(mem_ctx, key_copy, setting, _hash);
+    talloc_free(key_copy);
+
+    return ret;
+}
+
+struct tevent_req *sss_hash_pool_sha512_send(TALLOC_CTX *mem_ctx,
+                                             struct tevent_context *ev,
+                                             struct sss_hash_pool *pool,
+                                             const char *key,
+                                             size_t key_len,
+                                             const char *setting)
+{
+    struct sss_hash_pool_sha512_state *state;
+    struct sss_hash_job *job;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct sss_hash_pool_sha512_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    if (pool == NULL) {
+        ret = sss_hash_pool_sha512_sync(state, key, key_len, setting,
+                                        &state->hash);
+        goto done;
+    }
+
+    job = talloc_zero(pool, struct sss_hash_job);
+    if (job == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    job->key = talloc_strndup(job, key, key_len);
+    if (job->key == NULL) {
+        talloc_free(job);
+        ret = ENOMEM;
+        goto done;
+    }
+    talloc_set_destructor((TALLOC_CTX *)job->key,
+                          sss_erase_talloc_mem_securely);
+
+    job->setting = talloc_strdup(job, setting);
+    if (job->setting == NULL) {
+        talloc_free(job);
+        ret = ENOMEM;
+        goto done;
+    }
+
+    job->pool = pool;
+    job->req = req;
+    job->status = SSS_HASH_JOB_QUEUED;
+    talloc_set_destructor(job, sss_hash_job_destructor);
+
+    state->job = job;
+    talloc_set_destructor(state, sss_hash_pool_sha512_state_destructor);
+
+    pthread_mutex_lock(&pool->lock);
+    DLIST_ADD_END(pool->queued, job, struct sss_hash_job *);
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    return req;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else {
+        tevent_req_error(req, ret);
+    }
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+errno_t sss_hash_pool_sha512_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  char **_hash)
+{
+    struct sss_hash_pool_sha512_state *state;
+
+    state = tevent_req_data(req, struct sss_hash_pool_sha512_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_hash = talloc_steal(mem_ctx, state->hash);
+
+    return EOK;
+}
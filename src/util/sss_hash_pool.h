@@ -0,0 +1,78 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SSS_HASH_POOL_H_
+#define _SSS_HASH_POOL_H_
+
+#include <talloc.h>
+#include <tevent.h>
+
+#include "util/util.h"
+
+/* Pool of worker threads computing password hashes outside of the tevent
+ * loop. Hashing a cached password takes thousands of SHA-512 rounds, which
+ * would otherwise block every other request served by the process.
+ */
+struct sss_hash_pool;
+
+/**
+ * @brief Start a new pool.
+ *
+ * @param[in] mem_ctx     Memory context, the threads are stopped when it is
+ *                        freed.
+ * @param[in] ev          Event context the results are delivered to.
+ * @param[in] num_threads Number of worker threads, 0 selects a default based
+ *                        on the number of online CPUs.
+ * @param[out] _pool      The new pool.
+ *
+ * @return EOK on success, other error code on failure.
+ */
+errno_t sss_hash_pool_init(TALLOC_CTX *mem_ctx,
+                           struct tevent_context *ev,
+                           unsigned int num_threads,
+                           struct sss_hash_pool **_pool);
+
+/**
+ * @brief Compute s3crypt_sha512() of the first @key_len bytes of @key.
+ *
+ * The key and the setting are copied, the caller does not have to keep them
+ * around. If @pool is NULL the hash is computed synchronously and the request
+ * finishes in the next loop iteration, so the same code path can be used
+ * where no pool is available.
+ *
+ * @param[in] mem_ctx  Memory context.
+ * @param[in] ev       Event context.
+ * @param[in] pool     Pool to use or NULL.
+ * @param[in] key      Password.
+ * @param[in] key_len  Number of bytes of @key to hash.
+ * @param[in] setting  Salt, optionally with the number of rounds, or an
+ *                     existing hash to verify @key against.
+ *
+ * @return Tevent request or NULL on error.
+ */
+struct tevent_req *sss_hash_pool_sha512_send(TALLOC_CTX *mem_ctx,
+                                             struct tevent_context *ev,
+                                             struct sss_hash_pool *pool,
+                                             const char *key,
+                                             size_t key_len,
+                                             const char *setting);
+
+errno_t sss_hash_pool_sha512_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  char **_hash);
+
+#endif /* _SSS_HASH_POOL_H_ */
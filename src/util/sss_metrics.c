@@ -0,0 +1,601 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <talloc.h>
+
+#include "util/util.h"
+#include "util/dlinklist.h"
+#include "util/sss_metrics.h"
+
+enum sss_metrics_type {
+    SSS_METRICS_COUNTER,
+    SSS_METRICS_HISTOGRAM
+};
+
+struct sss_metrics_def {
+    const char *name;
+    enum sss_metrics_type type;
+    const char *help;
+    const char *label1;
+    const char *label2;
+};
+
+static const struct sss_metrics_def sss_metrics_defs[] = {
+    [SSS_METRICS_CACHE_REQ_DURATION] = {
+        "sssd_cache_req_duration", SSS_METRICS_HISTOGRAM,
+        "Duration of cache requests from start to reply",
+        "plugin", "result"
+    },
+    [SSS_METRICS_CACHE_REQ_LOOKUPS] = {
+        "sssd_cache_req_lookups_total", SSS_METRICS_COUNTER,
+        "Cache request lookups in a domain by the source of the answer "
+        "(negcache, cache, midpoint or provider)",
+        "plugin", "source"
+    },
+    [SSS_METRICS_DP_REQ_DURATION] = {
+        "sssd_dp_req_duration", SSS_METRICS_HISTOGRAM,
+        "Duration of data provider requests",
+        "target", "method"
+    },
+    [SSS_METRICS_LDAP_OP_DURATION] = {
+        "sssd_ldap_op_duration", SSS_METRICS_HISTOGRAM,
+        "Duration of LDAP operations until the last reply",
+        "operation", NULL
+    },
+    [SSS_METRICS_LDAP_OP_TIMEOUTS] = {
+        "sssd_ldap_op_timeouts_total", SSS_METRICS_COUNTER,
+        "LDAP operations that timed out",
+        NULL, NULL
+    },
+    [SSS_METRICS_MEMCACHE_UPDATES] = {
+        "sssd_memcache_updates_total", SSS_METRICS_COUNTER,
+        "Records stored in or invalidated from the memory cache",
+        "cache", "operation"
+    },
+};
+
+/* Log-linear histogram: values below 16 have their own bucket, every
+ * following power of two is split into 16 buckets. Values are clamped to
+ * 2^36 us (about 19 hours). */
+#define HDR_SUB_BITS    4
+#define HDR_SUB_COUNT   (1 << HDR_SUB_BITS)
+#define HDR_MAX_EXP     35
+#define HDR_MAX_VALUE   ((UINT64_C(1) << (HDR_MAX_EXP + 1)) - 1)
+#define HDR_BUCKETS     ((HDR_MAX_EXP - HDR_SUB_BITS + 2) * HDR_SUB_COUNT)
+
+/* Fixed buckets of the exported histogram, in microseconds */
+static const struct {
+    uint64_t usec;
+    const char *le;
+} sss_metrics_le[] = {
+    {100, "0.0001"}, {250, "0.00025"}, {500, "0.0005"},
+    {1000, "0.001"}, {2500, "0.0025"}, {5000, "0.005"},
+    {10000, "0.01"}, {25000, "0.025"}, {50000, "0.05"},
+    {100000, "0.1"}, {250000, "0.25"}, {500000, "0.5"},
+    {1000000, "1"}, {2500000, "2.5"}, {5000000, "5"},
+    {10000000, "10"},
+};
+
+#define LE_COUNT (sizeof(sss_metrics_le) / sizeof(sss_metrics_le[0]))
+
+static const struct {
+    double q;
+    const char *label;
+} sss_metrics_quantiles[] = {
+    {0.5, "0.5"}, {0.9, "0.9"}, {0.99, "0.99"}, {0.999, "0.999"},
+};
+
+#define QUANTILE_COUNT \
+    (sizeof(sss_metrics_quantiles) / sizeof(sss_metrics_quantiles[0]))
+
+struct sss_metrics_series {
+    struct sss_metrics_series *prev;
+    struct sss_metrics_series *next;
+
+    char *label1;
+    char *label2;
+
+    uint64_t count;
+
+    /* histograms only */
+    uint64_t sum;
+    uint64_t le[LE_COUNT];
+    uint64_t *hdr;
+};
+
+static TALLOC_CTX *sss_metrics_ctx;
+static struct sss_metrics_series *sss_metrics_series[SSS_METRICS_SENTINEL];
+
+uint64_t sss_metrics_now(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static bool label_equal(const char *a, const char *b)
+{
+    if (a == NULL || b == NULL) {
+        return a == b;
+    }
+
+    return strcmp(a, b) == 0;
+}
+
+static struct sss_metrics_series *
+sss_metrics_get(enum sss_metrics_family family,
+                const char *label1,
+                const char *label2)
+{
+    struct sss_metrics_series *series;
+
+    if (family >= SSS_METRICS_SENTINEL) {
+        return NULL;
+    }
+
+    for (series = sss_metrics_series[family];
+         series != NULL;
+         series = series->next) {
+        if (label_equal(series->label1, label1)
+                && label_equal(series->label2, label2)) {
+            return series;
+        }
+    }
+
+    if (sss_metrics_ctx == NULL) {
+        sss_metrics_ctx = talloc_named_const(NULL, 0, "sss_metrics");
+        if (sss_metrics_ctx == NULL) {
+            return NULL;
+        }
+    }
+
+    series = talloc_zero(sss_metrics_ctx, struct sss_metrics_series);
+    if (series == NULL) {
+        return NULL;
+    }
+
+    if (label1 != NULL) {
+        series->label1 = talloc_strdup(series, label1);
+        if (series->label1 == NULL) {
+            goto fail;
+        }
+    }
+
+    if (label2 != NULL) {
+        series->label2 = talloc_strdup(series, label2);
+        if (series->label2 == NULL) {
+            goto fail;
+        }
+    }
+
+    if (sss_metrics_defs[family].type == SSS_METRICS_HISTOGRAM) {
+        series->hdr = talloc_zero_array(series, uint64_t, HDR_BUCKETS);
+        if (series->hdr == NULL) {
+            goto fail;
+        }
+    }
+
+    DLIST_ADD_END(sss_metrics_series[family], series,
+                  struct sss_metrics_series *);
+
+    return series;
+
+fail:
+    talloc_free(series);
+    return NULL;
+}
+
+void sss_metrics_inc(enum sss_metrics_family family,
+                     const char *label1,
+                     const char *label2)
+{
+    struct sss_metrics_series *series;
+
+    series = sss_metrics_get(family, label1, label2);
+    if (series == NULL) {
+        return;
+    }
+
+    series->count++;
+}
+
+static size_t hdr_index(uint64_t value)
+{
+    unsigned int exp;
+    uint64_t sub;
+
+    if (value < HDR_SUB_COUNT) {
+        return value;
+    }
+
+    if (value > HDR_MAX_VALUE) {
+        value = HDR_MAX_VALUE;
+    }
+
+    exp = 63 - __builtin_clzll(value);
+    sub = (value >> (exp - HDR_SUB_BITS)) & (HDR_SUB_COUNT - 1);
+
+    return (exp - HDR_SUB_BITS + 1) * HDR_SUB_COUNT + sub;
+}
+
+/* Highest value that falls into the bucket */
+static uint64_t hdr_value(size_t idx)
+{
+    unsigned int exp;
+    uint64_t sub;
+
+    if (idx < HDR_SUB_COUNT) {
+        return idx;
+    }
+
+    exp = idx / HDR_SUB_COUNT + HDR_SUB_BITS - 1;
+    sub = idx % HDR_SUB_COUNT;
+
+    return ((HDR_SUB_COUNT + sub + 1) << (exp - HDR_SUB_BITS)) - 1;
+}
+
+void sss_metrics_observe(enum sss_metrics_family family,
+                         const char *label1,
+                         const char *label2,
+                         uint64_t start)
+{
+    struct sss_metrics_series *series;
+    uint64_t now;
+    uint64_t value;
+    size_t i;
+
+    series = sss_metrics_get(family, label1, label2);
+    if (series == NULL || series->hdr == NULL) {
+        return;
+    }
+
+    now = sss_metrics_now();
+    value = now > start ? now - start : 0;
+
+    series->count++;
+    series->sum += value;
+    series->hdr[hdr_index(value)]++;
+
+    for (i = 0; i < LE_COUNT; i++) {
+        if (value <= sss_metrics_le[i].usec) {
+            series->le[i]++;
+            break;
+        }
+    }
+}
+
+static uint64_t hdr_quantile(struct sss_metrics_series *series, double q)
+{
+    uint64_t rank;
+    uint64_t seen = 0;
+    size_t i;
+
+    if (series->count == 0) {
+        return 0;
+    }
+
+    rank = (uint64_t)(q * series->count);
+    if (rank < q * series->count || rank == 0) {
+        rank++;
+    }
+
+    for (i = 0; i < HDR_BUCKETS; i++) {
+        seen += series->hdr[i];
+        if (seen >= rank) {
+            return hdr_value(i);
+        }
+    }
+
+    return hdr_value(HDR_BUCKETS - 1);
+}
+
+static char *escape_label(TALLOC_CTX *mem_ctx, const char *value)
+{
+    char *out;
+    size_t i;
+    size_t j;
+
+    if (value == NULL) {
+        return talloc_strdup(mem_ctx, "");
+    }
+
+    out = talloc_array(mem_ctx, char, strlen(value) * 2 + 1);
+    if (out == NULL) {
+        return NULL;
+    }
+
+    for (i = 0, j = 0; value[i] != '\0'; i++) {
+        switch (value[i]) {
+        case '\\':
+        case '"':
+            out[j++] = '\\';
+            out[j++] = value[i];
+            break;
+        case '\n':
+            out[j++] = '\\';
+            out[j++] = 'n';
+            break;
+        default:
+            out[j++] = value[i];
+            break;
+        }
+    }
+    out[j] = '\0';
+
+    return out;
+}
+
+static char *series_labels(TALLOC_CTX *mem_ctx,
+                           const struct sss_metrics_def *def,
+                           struct sss_metrics_series *series)
+{
+    char *labels;
+
+    labels = talloc_asprintf(mem_ctx, "process=\"%s\"",
+                             escape_label(mem_ctx, debug_prg_name));
+    if (labels != NULL && def->label1 != NULL) {
+        labels = talloc_asprintf_append(labels, ",%s=\"%s\"", def->label1,
+                                        escape_label(mem_ctx, series->label1));
+    }
+
+    if (labels != NULL && def->label2 != NULL) {
+        labels = talloc_asprintf_append(labels, ",%s=\"%s\"", def->label2,
+                                        escape_label(mem_ctx, series->label2));
+    }
+
+    return labels;
+}
+
+static char *dump_histogram(char *out,
+                            const struct sss_metrics_def *def,
+                            const char *labels,
+                            struct sss_metrics_series *series)
+{
+    uint64_t cumulative = 0;
+    size_t i;
+
+    for (i = 0; i < LE_COUNT && out != NULL; i++) {
+        cumulative += series->le[i];
+        out = talloc_asprintf_append_buffer(out,
+                  "%s_seconds_bucket{%s,le=\"%s\"} %"PRIu64"\n",
+                  def->name, labels, sss_metrics_le[i].le, cumulative);
+    }
+
+    if (out != NULL) {
+        out = talloc_asprintf_append_buffer(out,
+                  "%s_seconds_bucket{%s,le=\"+Inf\"} %"PRIu64"\n"
+                  "%s_seconds_sum{%s} %.6f\n"
+                  "%s_seconds_count{%s} %"PRIu64"\n",
+                  def->name, labels, series->count,
+                  def->name, labels, series->sum / 1e6,
+                  def->name, labels, series->count);
+    }
+
+    for (i = 0; i < QUANTILE_COUNT && out != NULL; i++) {
+        out = talloc_asprintf_append_buffer(out,
+                  "%s_quantile_seconds{%s,quantile=\"%s\"} %.6f\n",
+                  def->name, labels, sss_metrics_quantiles[i].label,
+                  hdr_quantile(series, sss_metrics_quantiles[i].q) / 1e6);
+    }
+
+    return out;
+}
+
+char *sss_metrics_dump(TALLOC_CTX *mem_ctx)
+{
+    const struct sss_metrics_def *def;
+    struct sss_metrics_series *series;
+    TALLOC_CTX *tmp_ctx;
+    char *labels;
+    char *out;
+    int family;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return NULL;
+    }
+
+    out = talloc_strdup(tmp_ctx, "");
+
+    for (family = 0; family < SSS_METRICS_SENTINEL && out != NULL; family++) {
+        def = &sss_metrics_defs[family];
+
+        for (series = sss_metrics_series[family];
+             series != NULL && out != NULL;
+             series = series->next) {
+            labels = series_labels(tmp_ctx, def, series);
+            if (labels == NULL) {
+                out = NULL;
+                break;
+            }
+
+            if (def->type == SSS_METRICS_HISTOGRAM) {
+                out = dump_histogram(out, def, labels, series);
+            } else {
+                out = talloc_asprintf_append_buffer(out,
+                          "%s{%s} %"PRIu64"\n",
+                          def->name, labels, series->count);
+            }
+        }
+    }
+
+    out = talloc_steal(mem_ctx, out);
+    talloc_free(tmp_ctx);
+
+    return out;
+}
+
+/* Names of the exported metrics, histograms export two of them. */
+struct sss_metrics_name {
+    char *name;
+    const char *type;
+    const char *help;
+    bool histogram;
+    char *lines;
+};
+
+static bool line_has_name(const char *line,
+                          struct sss_metrics_name *name)
+{
+    const char *suffixes[] = {"_bucket{", "_sum{", "_count{", NULL};
+    size_t len;
+    int i;
+
+    len = strlen(name->name);
+    if (strncmp(line, name->name, len) != 0) {
+        return false;
+    }
+
+    if (line[len] == '{' || line[len] == ' ') {
+        return true;
+    }
+
+    if (name->histogram) {
+        for (i = 0; suffixes[i] != NULL; i++) {
+            if (strncmp(line + len, suffixes[i], strlen(suffixes[i])) == 0) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+char *sss_metrics_format(TALLOC_CTX *mem_ctx, const char **dumps)
+{
+    struct sss_metrics_name names[SSS_METRICS_SENTINEL * 2];
+    const struct sss_metrics_def *def;
+    TALLOC_CTX *tmp_ctx;
+    const char *line;
+    const char *end;
+    const char *next;
+    char *unknown;
+    char **buf;
+    char *out = NULL;
+    size_t num = 0;
+    size_t i;
+    size_t d;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < SSS_METRICS_SENTINEL; i++) {
+        def = &sss_metrics_defs[i];
+
+        if (def->type == SSS_METRICS_HISTOGRAM) {
+            names[num].name = talloc_asprintf(tmp_ctx, "%s_seconds",
+                                              def->name);
+            names[num].type = "histogram";
+            names[num].help = def->help;
+            names[num].histogram = true;
+            num++;
+
+            names[num].name = talloc_asprintf(tmp_ctx, "%s_quantile_seconds",
+                                              def->name);
+            names[num].type = "gauge";
+            names[num].help = def->help;
+            names[num].histogram = false;
+            num++;
+        } else {
+            names[num].name = talloc_strdup(tmp_ctx, def->name);
+            names[num].type = "counter";
+            names[num].help = def->help;
+            names[num].histogram = false;
+            num++;
+        }
+
+        if (names[num - 1].name == NULL
+                || (def->type == SSS_METRICS_HISTOGRAM
+                        && names[num - 2].name == NULL)) {
+            goto done;
+        }
+    }
+
+    for (i = 0; i < num; i++) {
+        names[i].lines = talloc_strdup(tmp_ctx, "");
+        if (names[i].lines == NULL) {
+            goto done;
+        }
+    }
+
+    unknown = talloc_strdup(tmp_ctx, "");
+    if (unknown == NULL) {
+        goto done;
+    }
+
+    /* Group the samples of all processes by metric name. */
+    for (d = 0; dumps != NULL && dumps[d] != NULL; d++) {
+        for (line = dumps[d]; *line != '\0'; line = next) {
+            end = strchrnul(line, '\n');
+            next = *end == '\n' ? end + 1 : end;
+
+            if (end == line || *line == '#') {
+                continue;
+            }
+
+            for (i = 0; i < num; i++) {
+                if (line_has_name(line, &names[i])) {
+                    break;
+                }
+            }
+
+            /* unknown lines come from a process with a different set of
+             * metrics, they are appended without the TYPE line */
+            buf = i < num ? &names[i].lines : &unknown;
+            *buf = talloc_asprintf_append_buffer(*buf, "%.*s\n",
+                                                 (int)(end - line), line);
+            if (*buf == NULL) {
+                goto done;
+            }
+        }
+    }
+
+    out = talloc_strdup(tmp_ctx, "");
+    for (i = 0; i < num && out != NULL; i++) {
+        if (names[i].lines[0] == '\0') {
+            continue;
+        }
+
+        out = talloc_asprintf_append_buffer(out,
+                  "# HELP %s %s\n# TYPE %s %s\n%s",
+                  names[i].name, names[i].help,
+                  names[i].name, names[i].type,
+                  names[i].lines);
+    }
+
+    if (out != NULL) {
+        out = talloc_strdup_append_buffer(out, unknown);
+    }
+
+done:
+    out = talloc_steal(mem_ctx, out);
+    talloc_free(tmp_ctx);
+
+    return out;
+}
@@ -0,0 +1,77 @@
+/*
+    Copyright (C) 2021 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SSS_METRICS_H_
+#define _SSS_METRICS_H_
+
+#include <stdint.h>
+#include <talloc.h>
+
+/*
+ * In-process metrics
+ *
+ * Every process keeps a set of counters and latency histograms in memory.
+ * Each metric family has up to two labels, the individual series are
+ * created on first use. The histograms are log-linear (16 sub-buckets per
+ * power of two, about 6% relative error) so that quantiles can be computed
+ * for any latency between one microsecond and several hours.
+ *
+ * sss_metrics_dump() returns the samples of this process in the Prometheus
+ * text format, all of them labeled with the name of the process.
+ * sss_metrics_format() merges dumps of several processes and adds the
+ * HELP and TYPE lines.
+ *
+ * The registry is not thread safe, it must only be used from the main
+ * event loop.
+ */
+
+enum sss_metrics_family {
+    /* histogram, labels: plugin, result */
+    SSS_METRICS_CACHE_REQ_DURATION,
+    /* counter, labels: plugin, source */
+    SSS_METRICS_CACHE_REQ_LOOKUPS,
+    /* histogram, labels: target, method */
+    SSS_METRICS_DP_REQ_DURATION,
+    /* histogram, labels: operation */
+    SSS_METRICS_LDAP_OP_DURATION,
+    /* counter, no labels */
+    SSS_METRICS_LDAP_OP_TIMEOUTS,
+    /* counter, labels: cache, operation */
+    SSS_METRICS_MEMCACHE_UPDATES,
+
+    SSS_METRICS_SENTINEL
+};
+
+/* Monotonic time in microseconds, use as the start of an observation. */
+uint64_t sss_metrics_now(void);
+
+void sss_metrics_inc(enum sss_metrics_family family,
+                     const char *label1,
+                     const char *label2);
+
+/* Record the time elapsed since @start (from sss_metrics_now()). */
+void sss_metrics_observe(enum sss_metrics_family family,
+                         const char *label1,
+                         const char *label2,
+                         uint64_t start);
+
+char *sss_metrics_dump(TALLOC_CTX *mem_ctx);
+
+/* @dumps is a NULL terminated list of sss_metrics_dump() outputs */
+char *sss_metrics_format(TALLOC_CTX *mem_ctx, const char **dumps);
+
+#endif /* _SSS_METRICS_H_ */
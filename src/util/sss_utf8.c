@@ -87,6 +87,32 @@ errno_t sss_utf8_case_eq(const uint8_t *s1, const uint8_t *s2)
     return ENOMATCH;
 }
 
+errno_t sss_utf8_case_key(const uint8_t *s, uint8_t **_key)
+{
+    uint8_t *folded;
+    uint8_t *key;
+    size_t len;
+
+    errno = 0;
+
+    /* u8_casecmp() compares the case-folded strings without
+     * normalization, so do the same here */
+    folded = u8_casefold(s, u8_strlen(s), NULL, NULL, NULL, &len);
+    if (folded == NULL) {
+        return errno != 0 ? errno : ENOMEM;
+    }
+
+    key = realloc(folded, len + 1);
+    if (key == NULL) {
+        free(folded);
+        return ENOMEM;
+    }
+    key[len] = '\0';
+
+    *_key = key;
+    return EOK;
+}
+
 #elif defined(HAVE_GLIB2)
 errno_t sss_utf8_case_eq(const uint8_t *s1, const uint8_t *s2)
 {
@@ -122,6 +148,38 @@ errno_t sss_utf8_case_eq(const uint8_t *s1, const uint8_t *s2)
     return ret;
 }
 
+errno_t sss_utf8_case_key(const uint8_t *s, uint8_t **_key)
+{
+    gchar *gs;
+    gchar *gkey;
+    uint8_t *key;
+    gssize n;
+
+    /* Use the same length and collation as sss_utf8_case_eq() so
+     * that both agree */
+    n = g_utf8_strlen((const gchar *)s, -1);
+
+    gs = g_utf8_casefold((const gchar *)s, n);
+    if (gs == NULL) {
+        return ENOMEM;
+    }
+
+    gkey = g_utf8_collate_key(gs, -1);
+    g_free(gs);
+    if (gkey == NULL) {
+        return ENOMEM;
+    }
+
+    key = (uint8_t *) strdup(gkey);
+    g_free(gkey);
+    if (key == NULL) {
+        return ENOMEM;
+    }
+
+    *_key = key;
+    return EOK;
+}
+
 #else
 #error No unicode library
 #endif
@@ -40,5 +40,12 @@ bool sss_utf8_check(const uint8_t *s, size_t n);
  */
 errno_t sss_utf8_case_eq(const uint8_t *s1, const uint8_t *s2);
 
+/* Returns a newly allocated key of s in _key. Two strings are equal
+ * according to sss_utf8_case_eq() if and only if their keys are
+ * equal according to strcmp(). The key must be freed with free().
+ * May return errno error codes on failure
+ */
+errno_t sss_utf8_case_key(const uint8_t *s, uint8_t **_key);
+
 
 #endif /* SSS_UTF8_H_ */